@@ -10,24 +10,59 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <string>
+
+#include "errors.h"
 #include "recovery/log_manager.h"
 #include "transaction/concurrency/lock_manager.h"
 #include "transaction/transaction.h"
 
 // class TransactionManager;
+class RmArena;
 
 // used for data_send
 static int const_offset = -1;
 
+/**
+ * @description: 一个客户端连接的会话设置，通过SET name = value修改，在连接断开前一直有效
+ */
+struct SessionSettings {
+    static constexpr int MAX_INDEX_BUILD_WORKERS = 64;
+    static constexpr int MAX_INDEX_BLOOM_BITS = 32;
+    static constexpr int MAX_BITMAP_HEAP_SCAN_PCT = 100;
+
+    int index_build_workers = 1;  // CREATE INDEX扫描表和排序时使用的工作线程数
+    int index_bloom_bits = 10;    // CREATE INDEX生成的布隆过滤器每个键的位数，0表示不生成
+    int bitmap_heap_scan_pct = 2;  // 索引范围估计命中表中至少这个百分比的记录时按页面顺序读表，0表示总是
+
+    void set(const std::string &name, int value) {
+        if (name == "index_build_workers" && value >= 1 &&
+            value <= MAX_INDEX_BUILD_WORKERS) {
+            index_build_workers = value;
+        } else if (name == "index_bloom_bits" && value >= 0 &&
+                   value <= MAX_INDEX_BLOOM_BITS) {
+            index_bloom_bits = value;
+        } else if (name == "bitmap_heap_scan_pct" && value >= 0 &&
+                   value <= MAX_BITMAP_HEAP_SCAN_PCT) {
+            bitmap_heap_scan_pct = value;
+        } else {
+            throw InvalidSessionSettingError(name, value);
+        }
+    }
+};
+
 class Context {
    public:
     Context(LockManager *lock_mgr, LogManager *log_mgr, Transaction *txn,
-            char *data_send = nullptr, int *offset = &const_offset)
+            char *data_send = nullptr, int *offset = &const_offset,
+            SessionSettings *session = nullptr, RmArena *arena = nullptr)
         : lock_mgr_(lock_mgr),
           log_mgr_(log_mgr),
           txn_(txn),
           data_send_(data_send),
-          offset_(offset) {
+          offset_(offset),
+          session_(session),
+          arena_(arena) {
         ellipsis_ = false;
     }
 
@@ -37,5 +72,7 @@ class Context {
     Transaction *txn_;
     char *data_send_;
     int *offset_;
+    SessionSettings *session_;  // 当前连接的会话设置，不在会话中执行时为nullptr
+    RmArena *arena_;            // 当前连接的查询内存区，执行器的输出元组从这里分配；为nullptr时单独分配
     bool ellipsis_;
 };
\ No newline at end of file
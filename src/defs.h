@@ -58,4 +58,7 @@ class RecScan {
     virtual bool is_end() const = 0;
 
     virtual Rid rid() const = 0;
+
+    // 扫描时已经读出的当前记录，没有时为nullptr，调用者再按rid()读取；指针在next()之前有效
+    virtual const char *record() const { return nullptr; }
 };
@@ -89,6 +89,19 @@ class IndexEntryNotFoundError : public RMDBError {
     IndexEntryNotFoundError() : RMDBError("Index entry not found") {}
 };
 
+class DuplicateKeyError : public RMDBError {
+   public:
+    DuplicateKeyError(const std::string &tab_name)
+        : RMDBError("Duplicate key in table " + tab_name) {}
+};
+
+class HashDirectoryFullError : public RMDBError {
+   public:
+    HashDirectoryFullError(int global_depth)
+        : RMDBError("Hash index directory is full, global depth: " +
+                    std::to_string(global_depth)) {}
+};
+
 // SM errors
 class DatabaseNotFoundError : public RMDBError {
    public:
@@ -114,6 +127,25 @@ class TableExistsError : public RMDBError {
         : RMDBError("Table already exists: " + tab_name) {}
 };
 
+class InvalidTableOptionError : public RMDBError {
+   public:
+    InvalidTableOptionError(const std::string &name, const std::string &value)
+        : RMDBError("Invalid table option: " + name + " = " + value) {}
+};
+
+class InvalidIndexOptionError : public RMDBError {
+   public:
+    InvalidIndexOptionError(const std::string &msg)
+        : RMDBError("Invalid index option: " + msg) {}
+};
+
+class InvalidSessionSettingError : public RMDBError {
+   public:
+    InvalidSessionSettingError(const std::string &name, int value)
+        : RMDBError("Invalid session setting: " + name + " = " +
+                    std::to_string(value)) {}
+};
+
 class ColumnNotFoundError : public RMDBError {
    public:
     ColumnNotFoundError(const std::string &col_name)
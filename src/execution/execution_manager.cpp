@@ -24,15 +24,19 @@ const char *help_info =
     "Supported SQL syntax:\n"
     "  command ;\n"
     "command:\n"
-    "  CREATE TABLE table_name (column_name type [, column_name type ...])\n"
+    "  CREATE TABLE table_name (column_name type [, column_name type ...]) "
+    "[option_name = option_value ...]\n"
     "  DROP TABLE table_name\n"
+    "  VACUUM table_name\n"
     "  CREATE INDEX table_name (column_name)\n"
     "  DROP INDEX table_name (column_name)\n"
     "  INSERT INTO table_name VALUES (value [, value ...])\n"
     "  DELETE FROM table_name [WHERE where_clause]\n"
     "  UPDATE table_name SET column_name = value [, column_name = value ...] "
     "[WHERE where_clause]\n"
-    "  SELECT selector FROM table_name [WHERE where_clause]\n"
+    "  SELECT selector FROM table_name [WHERE where_clause] "
+    "[ORDER BY column [ASC | DESC]] [LIMIT integer]\n"
+    "  SET setting_name = integer\n"
     "type:\n"
     "  {INT | FLOAT | CHAR(n)}\n"
     "where_clause:\n"
@@ -44,23 +48,34 @@ const char *help_info =
     "op:\n"
     "  {= | <> | < | > | <= | >=}\n"
     "selector:\n"
-    "  {* | column [, column ...]}\n";
+    "  {* | column [, column ...]}\n"
+    "setting_name:\n"
+    "  index_build_workers    worker threads used by CREATE INDEX (1-64)\n"
+    "  index_bloom_bits       bloom filter bits per key built by CREATE INDEX (0-32, 0 = none)\n"
+    "  bitmap_heap_scan_pct   estimated % of rows above which an index range scan reads the\n"
+    "                         table in page order (0-100, 0 = always)\n";
 
 // 主要负责执行DDL语句
 void QlManager::run_mutli_query(std::shared_ptr<Plan> plan, Context *context) {
     if (auto x = std::dynamic_pointer_cast<DDLPlan>(plan)) {
         switch (x->tag) {
             case T_CreateTable: {
-                sm_manager_->create_table(x->tab_name_, x->cols_, context);
+                sm_manager_->create_table(x->tab_name_, x->cols_, context,
+                                          x->options_);
                 break;
             }
             case T_DropTable: {
                 sm_manager_->drop_table(x->tab_name_, context);
                 break;
             }
+            case T_VacuumTable: {
+                sm_manager_->vacuum_table(x->tab_name_, context);
+                break;
+            }
             case T_CreateIndex: {
                 sm_manager_->create_index(x->tab_name_, x->tab_col_names_,
-                                          context);
+                                          context, x->index_type_,
+                                          x->include_col_names_);
                 break;
             }
             case T_DropIndex: {
@@ -90,6 +105,15 @@ void QlManager::run_cmd_utility(std::shared_ptr<Plan> plan, txn_id_t *txn_id,
                 sm_manager_->show_tables(context);
                 break;
             }
+            case T_SetKnob: {
+                auto set_plan = std::dynamic_pointer_cast<SetKnobPlan>(x);
+                if (context->session_ == nullptr) {
+                    throw InternalError("No session to set " +
+                                        set_plan->name_);
+                }
+                context->session_->set(set_plan->name_, set_plan->value_);
+                break;
+            }
             case T_DescTable: {
                 sm_manager_->desc_table(x->tab_name_, context);
                 break;
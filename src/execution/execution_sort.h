@@ -15,31 +15,75 @@ See the Mulan PSL v2 for more details. */
 #include "index/ix.h"
 #include "system/sm.h"
 
+/**
+ * @description: 按一个字段排序：beginTuple()时取出子算子的全部元组，在内存中稳定排序后依次输出。
+ * 排序字段上有可用的B+树索引时，规划器改用按索引顺序的扫描，不会生成本算子(见Planner::use_index_order)
+ */
 class SortExecutor : public AbstractExecutor {
    private:
     std::unique_ptr<AbstractExecutor> prev_;
-    ColMeta
-        cols_;  // 框架中只支持一个键排序，需要自行修改数据结构支持多个键排序
-    size_t tuple_num;
+    TabCol sel_col_;
+    ColMeta cols_;  // 框架中只支持一个键排序，需要自行修改数据结构支持多个键排序
     bool is_desc_;
-    std::vector<size_t> used_tuple;
-    std::unique_ptr<RmRecord> current_tuple;
+    std::vector<std::unique_ptr<RmRecord>> tuples_;  // 排好序的元组
+    size_t pos_ = 0;                                 // 当前输出的元组
+    RmArena *arena_;                                 // 输出元组从这里分配
 
    public:
     SortExecutor(std::unique_ptr<AbstractExecutor> prev, TabCol sel_cols,
-                 bool is_desc) {
+                 bool is_desc, RmArena *arena = nullptr) {
+        arena_ = arena;
         prev_ = std::move(prev);
-        cols_ = prev_->get_col_offset(sel_cols);
+        sel_col_ = sel_cols;
+        cols_ = *get_col(prev_->cols(), sel_cols);
         is_desc_ = is_desc;
-        tuple_num = 0;
-        used_tuple.clear();
     }
 
-    void beginTuple() override {}
+    void set_required_cols(const std::vector<TabCol> &cols) override {
+        std::vector<TabCol> required = cols;
+        required.push_back(sel_col_);
+        prev_->set_required_cols(required);
+    }
 
-    void nextTuple() override {}
+    void beginTuple() override {
+        tuples_.clear();
+        pos_ = 0;
+        for (prev_->beginTuple(); !prev_->is_end(); prev_->nextTuple()) {
+            tuples_.push_back(prev_->Next());
+        }
+        std::stable_sort(tuples_.begin(), tuples_.end(),
+                         [&](const std::unique_ptr<RmRecord> &a,
+                             const std::unique_ptr<RmRecord> &b) {
+                             int cmp = ix_compare(a->data + cols_.offset,
+                                                  b->data + cols_.offset,
+                                                  cols_.type, cols_.len);
+                             return is_desc_ ? cmp > 0 : cmp < 0;
+                         });
+    }
 
-    std::unique_ptr<RmRecord> Next() override { return nullptr; }
+    void nextTuple() override {
+        if (pos_ < tuples_.size()) {
+            pos_++;
+        }
+    }
+
+    std::unique_ptr<RmRecord> Next() override {
+        if (is_end()) {
+            return nullptr;
+        }
+        auto &tuple = tuples_[pos_];
+        auto rec = RmRecord::make(tuple->size, arena_);
+        memcpy(rec->data, tuple->data, tuple->size);
+        return rec;
+    }
 
     Rid &rid() override { return _abstract_rid; }
-};
\ No newline at end of file
+
+    bool is_end() const override { return pos_ == tuples_.size(); }
+
+    std::string getType() override { return "SortExecutor"; }
+
+    size_t tupleLen() const override { return prev_->tupleLen(); }
+
+    const std::vector<ColMeta> &cols() const override { return prev_->cols(); }
+};
@@ -44,6 +44,13 @@ class AbstractExecutor {
 
     virtual ColMeta get_col_offset(const TabCol &target) { return ColMeta(); };
 
+    /**
+     * @description: 告知算子上层只会用到cols中的字段，PAX布局的表扫描据此只读取需要的列，
+     * 其余字段的内容未定义；默认不做处理，始终产生完整的记录
+     * @param {vector<TabCol>&} cols 上层需要的字段
+     */
+    virtual void set_required_cols(const std::vector<TabCol> &cols) {}
+
     std::vector<ColMeta>::const_iterator get_col(
         const std::vector<ColMeta> &rec_cols, const TabCol &target) {
         auto pos = std::find_if(rec_cols.begin(), rec_cols.end(),
@@ -0,0 +1,308 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "execution_defs.h"
+#include "execution_manager.h"
+#include "executor_abstract.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+/**
+ * @description: 位图扫描，用表上的位图索引回答"字段 op 常量"形式的谓词
+ * 单字段位图索引上同一字段的所有谓词合并为一个键的范围，取范围内所有键的位图的并集(等值时只有一个键)；
+ * 多字段位图索引要求所有字段都有等值条件。各个位图求交集后，只按升序读取交集中的记录，
+ * 位图索引回答不了的谓词在读出记录后再求值
+ */
+class BitmapScanExecutor : public AbstractExecutor {
+   private:
+    std::string tab_name_;                  // 表的名称
+    TabMeta tab_;                           // 表的元数据
+    std::vector<Condition> conds_;          // scan的条件
+    std::vector<Condition> residual_conds_;  // 位图索引回答不了、需要读出记录求值的条件
+    RmTableHandle *fh_;                     // 表的记录存取接口
+    std::vector<ColMeta> cols_;             // scan后生成的记录的字段
+    size_t len_;                            // scan后生成的每条记录的长度
+    std::vector<Condition> fed_conds_;      // 同conds_，两个字段相同
+    bool prune_cols_ = false;               // 是否只读取需要的字段
+    std::vector<int> cond_fields_;          // residual_conds_用到的字段下标
+    std::vector<int> out_fields_;           // 上层需要的字段下标(包括谓词用到的字段)
+
+    // 一次位图查找：键的范围[lower, upper]，lower和upper为空表示该方向没有界
+    struct BitmapProbe {
+        IxBitmapIndexHandle *handle;
+        std::vector<char> lower;
+        std::vector<char> upper;
+        bool lower_inclusive = true;
+        bool upper_inclusive = true;
+        bool point = false;  // 等值查找，键就是lower
+    };
+    std::vector<BitmapProbe> probes_;
+
+    std::vector<Rid> rids_;  // 各位图的交集，按(页面号, 槽位号)升序
+    size_t rid_pos_ = 0;
+    Rid rid_;
+
+    SmManager *sm_manager_;
+
+   public:
+    BitmapScanExecutor(SmManager *sm_manager, std::string tab_name,
+                       std::vector<Condition> conds, Context *context) {
+        sm_manager_ = sm_manager;
+        context_ = context;
+        tab_name_ = std::move(tab_name);
+        tab_ = sm_manager_->db_.get_table(tab_name_);
+        conds_ = std::move(conds);
+        fh_ = sm_manager_->get_table_handle(tab_name_);
+        cols_ = tab_.cols;
+        len_ = cols_.back().offset + cols_.back().len;
+        fed_conds_ = conds_;
+
+        init_probes();
+        for (auto &cond : residual_conds_) {
+            add_field(cond_fields_, cond.lhs_col);
+            if (!cond.is_rhs_val) {
+                add_field(cond_fields_, cond.rhs_col);
+            }
+        }
+    }
+
+    void set_required_cols(const std::vector<TabCol> &cols) override {
+        out_fields_ = cond_fields_;
+        for (auto &col : cols) {
+            add_field(out_fields_, col);
+        }
+        prune_cols_ = true;
+    }
+
+    /**
+     * @brief 依次查找各个位图并求交集，从元素最少的位图开始，交集为空后不再查找
+     */
+    void beginTuple() override {
+        rids_.clear();
+        rid_pos_ = 0;
+        std::vector<IxBitmap> bitmaps;
+        for (auto &probe : probes_) {
+            bitmaps.push_back(lookup(probe));
+            if (bitmaps.back().empty()) {
+                break;
+            }
+        }
+        std::sort(bitmaps.begin(), bitmaps.end(), [](const IxBitmap &a, const IxBitmap &b) {
+            return a.cardinality() < b.cardinality();
+        });
+        if (!bitmaps.empty()) {
+            IxBitmap &result = bitmaps[0];
+            for (size_t i = 1; i < bitmaps.size() && !result.empty(); i++) {
+                result &= bitmaps[i];
+            }
+            result.to_rids(&rids_);
+        }
+        find_next();
+    }
+
+    void nextTuple() override {
+        if (is_end()) {
+            return;
+        }
+        rid_pos_++;
+        find_next();
+    }
+
+    std::unique_ptr<RmRecord> Next() override { return fetch_record(out_fields_); }
+
+    Rid &rid() override { return rid_; }
+
+    bool is_end() const override { return rid_pos_ >= rids_.size(); }
+
+    std::string getType() override { return "BitmapScanExecutor"; }
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return cols_; }
+
+   private:
+    /**
+     * @brief 把条件分配给位图索引，生成位图查找，剩下的条件放入residual_conds_
+     */
+    void init_probes() {
+        std::vector<bool> used(conds_.size(), false);
+        auto usable = [&](const Condition &cond, const ColMeta &col) {
+            return cond.is_rhs_val && cond.op != OP_NE && cond.lhs_col.tab_name == tab_name_ &&
+                   cond.lhs_col.col_name == col.name && cond.rhs_val.type == col.type;
+        };
+        for (auto &index : tab_.indexes) {
+            if (index.type != INDEX_BITMAP) {
+                continue;
+            }
+            BitmapProbe probe;
+            probe.handle = sm_manager_->bhs_
+                               .at(sm_manager_->get_ix_manager()->get_index_name(
+                                   tab_name_, index.cols))
+                               .get();
+            if (index.cols.size() > 1) {
+                // 多字段的位图索引只做等值查找，键由各字段的等值条件拼接而成
+                std::vector<size_t> matched;
+                for (auto &col : index.cols) {
+                    for (size_t i = 0; i < conds_.size(); i++) {
+                        if (usable(conds_[i], col) && conds_[i].op == OP_EQ) {
+                            matched.push_back(i);
+                            break;
+                        }
+                    }
+                }
+                if (matched.size() < index.cols.size()) {
+                    continue;
+                }
+                for (size_t k = 0; k < matched.size(); k++) {
+                    const char *value = conds_[matched[k]].rhs_val.raw->data;
+                    probe.lower.insert(probe.lower.end(), value, value + index.cols[k].len);
+                    used[matched[k]] = true;
+                }
+                probe.point = true;
+                probes_.push_back(std::move(probe));
+                continue;
+            }
+            // 单字段的位图索引：同一字段上的所有条件合并为一个范围，取最紧的上下界
+            const ColMeta &col = index.cols[0];
+            const char *lower = nullptr;
+            const char *upper = nullptr;
+            auto tighten = [&](const char *value, bool inclusive, bool is_lower) {
+                const char *&bound = is_lower ? lower : upper;
+                bool &bound_inclusive = is_lower ? probe.lower_inclusive : probe.upper_inclusive;
+                int cmp = bound == nullptr ? 0 : ix_compare(value, bound, col.type, col.len);
+                if (bound == nullptr || (is_lower ? cmp > 0 : cmp < 0) || (cmp == 0 && !inclusive)) {
+                    bound = value;
+                    bound_inclusive = inclusive;
+                }
+            };
+            for (size_t i = 0; i < conds_.size(); i++) {
+                if (!usable(conds_[i], col)) {
+                    continue;
+                }
+                const char *value = conds_[i].rhs_val.raw->data;
+                CompOp op = conds_[i].op;
+                if (op == OP_EQ || op == OP_GT || op == OP_GE) {
+                    tighten(value, op != OP_GT, true);
+                }
+                if (op == OP_EQ || op == OP_LT || op == OP_LE) {
+                    tighten(value, op != OP_LT, false);
+                }
+                used[i] = true;
+            }
+            if (lower == nullptr && upper == nullptr) {
+                continue;
+            }
+            if (lower != nullptr) {
+                probe.lower.assign(lower, lower + col.len);
+            }
+            if (upper != nullptr) {
+                probe.upper.assign(upper, upper + col.len);
+            }
+            probe.point = lower != nullptr && upper != nullptr && probe.lower_inclusive &&
+                          probe.upper_inclusive && ix_compare(lower, upper, col.type, col.len) == 0;
+            probes_.push_back(std::move(probe));
+        }
+        for (size_t i = 0; i < conds_.size(); i++) {
+            if (!used[i]) {
+                residual_conds_.push_back(conds_[i]);
+            }
+        }
+    }
+
+    static IxBitmap lookup(BitmapProbe &probe) {
+        if (probe.point) {
+            return probe.handle->get_bitmap(probe.lower.data());
+        }
+        return probe.handle->get_range_bitmap(
+            probe.lower.empty() ? nullptr : probe.lower.data(), probe.lower_inclusive,
+            probe.upper.empty() ? nullptr : probe.upper.data(), probe.upper_inclusive);
+    }
+
+    /**
+     * @brief 从rid_pos_开始找到第一个满足剩余谓词的元组
+     */
+    void find_next() {
+        for (; rid_pos_ < rids_.size(); rid_pos_++) {
+            rid_ = rids_[rid_pos_];
+            if (residual_conds_.empty()) {
+                return;
+            }
+            auto record = fetch_record(cond_fields_);
+            if (record && eval_conds(record.get(), residual_conds_, cols_)) {
+                return;
+            }
+        }
+        rid_ = Rid{-1, -1};
+    }
+
+    // 将本表的字段col加入字段下标集合fields，其他表的字段忽略
+    void add_field(std::vector<int> &fields, const TabCol &col) {
+        if (col.tab_name != tab_name_) {
+            return;
+        }
+        auto pos = get_col(cols_, col);
+        int idx = pos - cols_.begin();
+        if (std::find(fields.begin(), fields.end(), idx) == fields.end()) {
+            fields.push_back(idx);
+        }
+    }
+
+    std::unique_ptr<RmRecord> fetch_record(const std::vector<int> &fields) {
+        if (!prune_cols_) {
+            return fh_->get_record(rid_, context_);
+        }
+        return fh_->get_record(rid_, fields, context_);
+    }
+
+    bool eval_cond(const RmRecord *rec, const Condition &cond,
+                   const std::vector<ColMeta> &rec_cols) {
+        auto left_col = get_col(cols_, cond.lhs_col);
+        char *left_val = rec->data + left_col->offset;
+
+        char *right_val = nullptr;
+        ColType col_type;
+        int len = left_col->len;
+
+        if (cond.is_rhs_val) {
+            right_val = cond.rhs_val.raw->data;
+            col_type = cond.rhs_val.type;
+        } else {
+            auto right_col = get_col(cols_, cond.rhs_col);
+            right_val = rec->data + right_col->offset;
+            col_type = right_col->type;
+        }
+
+        int cmp_result = ix_compare(left_val, right_val, col_type, len);
+        switch (cond.op) {
+            case OP_EQ:
+                return cmp_result == 0;
+            case OP_NE:
+                return cmp_result != 0;
+            case OP_LT:
+                return cmp_result < 0;
+            case OP_GT:
+                return cmp_result > 0;
+            case OP_LE:
+                return cmp_result <= 0;
+            case OP_GE:
+                return cmp_result >= 0;
+            default:
+                return false;
+        }
+    }
+
+    bool eval_conds(const RmRecord *rec, const std::vector<Condition> &conds,
+                    const std::vector<ColMeta> &rec_cols) {
+        return std::all_of(conds.begin(), conds.end(),
+                           [&](const Condition &cond) { return eval_cond(rec, cond, rec_cols); });
+    }
+};
@@ -19,7 +19,7 @@ class DeleteExecutor : public AbstractExecutor {
    private:
     TabMeta tab_;                   // 表的元数据
     std::vector<Condition> conds_;  // delete的条件
-    RmFileHandle *fh_;              // 表的数据文件句柄
+    RmTableHandle *fh_;             // 表的记录存取接口
     std::vector<Rid> rids_;         // 需要删除的记录的位置
     std::string tab_name_;          // 表名称
     SmManager *sm_manager_;
@@ -31,7 +31,7 @@ class DeleteExecutor : public AbstractExecutor {
         sm_manager_ = sm_manager;
         tab_name_ = tab_name;
         tab_ = sm_manager_->db_.get_table(tab_name);
-        fh_ = sm_manager_->fhs_.at(tab_name).get();
+        fh_ = sm_manager_->get_table_handle(tab_name);
         conds_ = conds;
         rids_ = rids;
         context_ = context;
@@ -48,26 +48,13 @@ class DeleteExecutor : public AbstractExecutor {
             // 删除索引项:数据库需要维护数据一致性，删除记录前必须先删除其关联的索引项。
             for (size_t i = 0; i < tab_.indexes.size(); ++i) {
                 auto &index = tab_.indexes[i];
-                auto ih = sm_manager_->ihs_
-                              .at(sm_manager_->get_ix_manager()->get_index_name(
-                                  tab_name_, index.cols))
-                              .get();
 
-                // 键缓冲区
-                char *key = new char[index.col_tot_len];
-                int offset = 0;
-
-                // 记录中提取索引键
-                for (size_t j = 0; j < index.col_num; ++j) {
-                    memcpy(key + offset, rec->data + index.cols[j].offset,
-                           index.cols[j].len);
-                    offset += index.cols[j].len;
-                }
+                // 记录中提取索引键(包括INCLUDE字段)
+                std::vector<char> key(index.col_tot_len);
+                index.extract_key(rec->data, key.data());
 
                 // 调用索引管理器删除索引项
-                ih->delete_entry(key, context_->txn_);
-
-                delete[] key;
+                sm_manager_->delete_index_entry(index, key.data(), rid, context_->txn_);
             }
 
             // 删除记录本身:核心功能是标记记录槽位为空（slot为空），并更新文件头信息
@@ -0,0 +1,157 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+#include "execution_defs.h"
+#include "execution_manager.h"
+#include "executor_abstract.h"
+#include "executor_index_scan.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+/**
+ * @description: 索引嵌套循环连接，左儿子为外层，右儿子是内表上的索引扫描。
+ * 每个外层元组把连接条件中的外层字段的值作为参数绑定到内表的索引扫描，
+ * 内层只扫描索引上满足条件的范围，而不是每次都从头扫描整张内表。
+ * 连接条件的形式为"外层字段 op 内表字段"(见Planner::make_index_joins)
+ */
+class IndexNestedLoopJoinExecutor : public AbstractExecutor {
+   private:
+    std::unique_ptr<AbstractExecutor> left_;    // 外层
+    std::unique_ptr<IndexScanExecutor> right_;  // 内表上的索引扫描
+    size_t len_;                                // join后获得的每条记录的长度
+    std::vector<ColMeta> cols_;                 // join后获得的记录的字段
+
+    std::vector<Condition> fed_conds_;  // join条件
+    std::vector<Condition> params_;     // 绑定到内表扫描的参数条件，与fed_conds_一一对应
+    std::vector<ColMeta> outer_cols_;   // 参数取值的外层字段
+    bool isend;
+    std::unique_ptr<RmRecord> left_rec_;   // 当前的外层元组
+    std::unique_ptr<RmRecord> right_rec_;  // 当前的内表元组
+    RmArena *arena_;                       // 输出元组从这里分配
+
+   public:
+    IndexNestedLoopJoinExecutor(std::unique_ptr<AbstractExecutor> left,
+                                std::unique_ptr<IndexScanExecutor> right,
+                                std::vector<Condition> conds, RmArena *arena = nullptr) {
+        arena_ = arena;
+        left_ = std::move(left);
+        right_ = std::move(right);
+        len_ = left_->tupleLen() + right_->tupleLen();
+        cols_ = left_->cols();
+        auto right_cols = right_->cols();
+        for (auto &col : right_cols) {
+            col.offset += left_->tupleLen();
+        }
+        cols_.insert(cols_.end(), right_cols.begin(), right_cols.end());
+        isend = false;
+        fed_conds_ = std::move(conds);
+
+        std::map<CompOp, CompOp> swap_op = {
+            {OP_EQ, OP_EQ}, {OP_NE, OP_NE}, {OP_LT, OP_GT},
+            {OP_GT, OP_LT}, {OP_LE, OP_GE}, {OP_GE, OP_LE},
+        };
+        for (auto &cond : fed_conds_) {
+            auto outer_col = left_->get_col(left_->cols(), cond.lhs_col);
+            auto inner_col = right_->get_col(right_->cols(), cond.rhs_col);
+            Condition param;
+            param.lhs_col = cond.rhs_col;
+            param.op = swap_op.at(cond.op);
+            param.is_rhs_val = true;
+            param.rhs_val.type = inner_col->type;
+            param.rhs_val.raw = std::make_shared<RmRecord>(inner_col->len);
+            params_.push_back(std::move(param));
+            outer_cols_.push_back(*outer_col);
+        }
+    }
+
+    // 上层需要的字段加上join条件中的字段，一并下推给左右子执行器
+    void set_required_cols(const std::vector<TabCol> &cols) override {
+        std::vector<TabCol> required = cols;
+        for (auto &cond : fed_conds_) {
+            required.push_back(cond.lhs_col);
+            required.push_back(cond.rhs_col);
+        }
+        left_->set_required_cols(required);
+        right_->set_required_cols(required);
+    }
+
+    void beginTuple() override {
+        left_->beginTuple();
+        isend = left_->is_end();
+        if (!isend) {
+            left_rec_ = left_->Next();
+            probe();
+            seek();
+        }
+    }
+
+    void nextTuple() override {
+        if (isend) {
+            return;
+        }
+        right_->nextTuple();
+        seek();
+    }
+
+    std::unique_ptr<RmRecord> Next() override {
+        if (isend) {
+            return nullptr;
+        }
+        std::unique_ptr<RmRecord> join_rec = RmRecord::make(len_, arena_);
+        memcpy(join_rec->data, left_rec_->data, left_->tupleLen());
+        memcpy(join_rec->data + left_->tupleLen(), right_rec_->data,
+               right_->tupleLen());
+        return join_rec;
+    }
+
+    Rid &rid() override { return _abstract_rid; }
+
+    bool is_end() const override { return isend; }
+
+    std::string getType() override { return "IndexNestedLoopJoinExecutor"; }
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return cols_; }
+
+   private:
+    /**
+     * @description: 用当前外层元组的字段值绑定内表扫描的参数，并把内表扫描定位到起点
+     * 内表扫描会对参数条件求值，因此内表输出的元组都已满足join条件
+     */
+    void probe() {
+        for (size_t i = 0; i < params_.size(); i++) {
+            memcpy(params_[i].rhs_val.raw->data,
+                   left_rec_->data + outer_cols_[i].offset, outer_cols_[i].len);
+        }
+        right_->set_params(params_);
+        right_->beginTuple();
+    }
+
+    /**
+     * @description: 从当前位置开始找到下一对连接的元组，当前外层元组的匹配取完后探测下一个外层元组
+     */
+    void seek() {
+        while (true) {
+            if (!right_->is_end()) {
+                right_rec_ = right_->Next();
+                return;
+            }
+            left_->nextTuple();
+            if (left_->is_end()) {
+                isend = true;
+                return;
+            }
+            left_rec_ = left_->Next();
+            probe();
+        }
+    }
+};
@@ -10,6 +10,9 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <climits>
+#include <limits>
+
 #include "execution_defs.h"
 #include "execution_manager.h"
 #include "executor_abstract.h"
@@ -20,18 +23,50 @@ class IndexScanExecutor : public AbstractExecutor {
    private:
     std::string tab_name_;              // 表名称
     TabMeta tab_;                       // 表的元数据
-    std::vector<Condition> conds_;      // 扫描条件
-    RmFileHandle *fh_;                  // 表的数据文件句柄
+    std::vector<Condition> conds_;      // 扫描条件，包括set_params()绑定的参数条件
+    std::vector<Condition> base_conds_;  // 计划中给定的扫描条件
+    RmTableHandle *fh_;                 // 表的数据文件句柄
+    RmFileHandle *heap_fh_ = nullptr;   // 位图堆扫描时按页面读取的堆文件句柄
+    // 聚簇表的B+树索引：索引项中带有主键，记录按主键到聚簇索引中查找，不经过Rid
+    IxClusteredTableHandle *clustered_ = nullptr;
+    std::vector<int> pk_offsets_;  // 主键各字段在索引项中的偏移
+    std::vector<int> pk_lens_;     // 主键各字段的长度
+    std::vector<ColType> pk_types_;
     std::vector<ColMeta> cols_;         // 需要读取的字段
     size_t len_;                        // 选取出来的一条记录的长度
     std::vector<Condition> fed_conds_;  // 扫描条件，和conds_字段相同
+    bool prune_cols_ = false;           // 是否只读取需要的字段
+    std::vector<int> cond_fields_;      // 谓词用到的字段下标
+    std::vector<int> out_fields_;       // 上层需要的字段下标(包括谓词用到的字段)
 
     std::vector<std::string>
         index_col_names_;   // index scan涉及到的索引包含的字段
     IndexMeta index_meta_;  // index scan涉及到的索引元数据
+    IxIndexHandle *ih_ = nullptr;      // B+树索引句柄
+    IxHashIndexHandle *hh_ = nullptr;  // 哈希索引句柄，哈希索引只做等值查找
+    std::vector<char> lower_key_;  // 扫描范围的下界，包含
+    std::vector<char> upper_key_;  // 扫描范围的上界，包含
+    bool point_key_ = false;  // 索引字段(不含INCLUDE字段)都有等值条件，可以先查布隆过滤器
+    bool point_lookup_ = false;  // 本次扫描是单个键的查找，rids_共用同一个键
+    bool reverse_ = false;       // 按索引键的降序扫描
+    // 位图堆扫描：先从索引取出范围内的全部rid，按(页面号, 槽位号)排序后按页面顺序读表，
+    // 每个页面只固定一次，并预读之后的页面；输出不再按索引键有序。
+    // 聚簇表按主键排序后依次查找，访问聚簇索引的叶结点也是顺序的
+    bool bitmap_heap_ = false;
+    std::vector<size_t> page_starts_;  // rids_中每个页面的第一个rid的下标，最后一项为rids_.size()
+    size_t page_idx_ = 0;              // page_records_对应的页面在page_starts_中的下标
+    bool page_loaded_ = false;         // page_records_是否已经读入
+    size_t prefetched_idx_ = 0;        // 已经预读到的页面在page_starts_中的下标
+    std::vector<std::unique_ptr<RmRecord>> page_records_;  // 当前页面中各个rid的记录
 
     Rid rid_;
-    std::unique_ptr<RecScan> scan_;
+    std::unique_ptr<IxScan> scan_;
+    std::vector<Rid> rids_;  // 从索引批量取出、尚未处理的rid，每次取一个叶结点
+    size_t rid_pos_ = 0;
+    // 仅索引扫描：记录的字段全部取自索引项的键，不访问表的数据文件
+    bool index_only_ = false;
+    std::vector<char> keys_;           // 与rids_一一对应的索引项(键和INCLUDE字段)，仅索引扫描和聚簇表时取出
+    std::vector<ColMeta> entry_cols_;  // 索引项中依次存放的字段
 
     SmManager *sm_manager_;
 
@@ -39,7 +74,8 @@ class IndexScanExecutor : public AbstractExecutor {
     IndexScanExecutor(SmManager *sm_manager, std::string tab_name,
                       std::vector<Condition> conds,
                       std::vector<std::string> index_col_names,
-                      Context *context) {
+                      Context *context, bool index_only = false,
+                      bool reverse = false, bool bitmap_heap = false) {
         sm_manager_ = sm_manager;
         context_ = context;
         tab_name_ = std::move(tab_name);
@@ -48,7 +84,35 @@ class IndexScanExecutor : public AbstractExecutor {
         // index_no_ = index_no;
         index_col_names_ = index_col_names;
         index_meta_ = *(tab_.get_index_meta(index_col_names_));
-        fh_ = sm_manager_->fhs_.at(tab_name_).get();
+        entry_cols_ = index_meta_.entry_cols();
+        index_only_ = index_only;
+        reverse_ = reverse;
+        bitmap_heap_ = bitmap_heap;
+        fh_ = sm_manager_->get_table_handle(tab_name_);
+        std::string index_name = sm_manager_->get_ix_manager()->get_index_name(
+            tab_name_, index_meta_.cols);
+        if (index_meta_.type == INDEX_HASH) {
+            hh_ = sm_manager_->hhs_.at(index_name).get();
+        } else {
+            ih_ = sm_manager_->ihs_.at(index_name).get();
+        }
+        if (tab_.engine == ENGINE_CLUSTERED && ih_ != nullptr) {
+            clustered_ = sm_manager_->chs_.at(tab_name_).get();
+            for (auto &col : tab_.clustered_index()->cols) {
+                int offset = 0;
+                for (auto &entry_col : entry_cols_) {
+                    if (entry_col.name == col.name) {
+                        break;
+                    }
+                    offset += entry_col.len;
+                }
+                pk_offsets_.push_back(offset);
+                pk_lens_.push_back(col.len);
+                pk_types_.push_back(col.type);
+            }
+        } else if (bitmap_heap_) {
+            heap_fh_ = sm_manager_->fhs_.at(tab_name_).get();
+        }
         cols_ = tab_.cols;
         len_ = cols_.back().offset + cols_.back().len;
         std::map<CompOp, CompOp> swap_op = {
@@ -66,13 +130,381 @@ class IndexScanExecutor : public AbstractExecutor {
             }
         }
         fed_conds_ = conds_;
+        base_conds_ = conds_;
+
+        for (auto &cond : conds_) {
+            add_field(cond_fields_, cond.lhs_col);
+            if (!cond.is_rhs_val) {
+                add_field(cond_fields_, cond.rhs_col);
+            }
+        }
+        init_key_range();
+    }
+
+    void set_required_cols(const std::vector<TabCol> &cols) override {
+        out_fields_ = cond_fields_;
+        for (auto &col : cols) {
+            add_field(out_fields_, col);
+        }
+        prune_cols_ = true;
     }
 
-    void beginTuple() override {}
+    /**
+     * @brief 绑定参数条件并重新计算索引键的范围，下一次beginTuple()按新的范围扫描
+     * 参数条件的形式为"本表字段 op 值"，供索引嵌套循环连接对每个外层元组探测本表
+     */
+    void set_params(const std::vector<Condition> &params) {
+        conds_ = base_conds_;
+        for (auto &param : params) {
+            conds_.push_back(param);
+            add_field(cond_fields_, param.lhs_col);
+            if (prune_cols_) {
+                add_field(out_fields_, param.lhs_col);
+            }
+        }
+        init_key_range();
+    }
 
-    void nextTuple() override {}
+    /**
+     * @brief 在索引上定位扫描范围[lower_key_, upper_key_]，并找到第一个满足全部谓词的元组
+     * 索引只用于缩小范围，范围内的记录仍要对全部谓词求值；
+     * 哈希索引的所有字段都是等值条件(见Planner::get_index_cols)，lower_key_就是要查找的键
+     */
+    void beginTuple() override {
+        rids_.clear();
+        keys_.clear();
+        rid_pos_ = 0;
+        // 哈希索引的所有字段都是等值条件；B+树上整个键都是等值条件时同样只需查一个键，
+        // 由get_value()先查布隆过滤器和自适应哈希索引。get_value()不返回INCLUDE字段，
+        // 带INCLUDE字段的仅索引扫描和聚簇表仍走范围扫描
+        point_lookup_ = hh_ != nullptr ||
+                        (point_key_ && (!with_entries() || index_meta_.include_cols.empty()));
+        if (point_lookup_) {
+            scan_.reset();
+            if (hh_ != nullptr) {
+                hh_->get_value(lower_key_.data(), &rids_, context_->txn_);
+            } else {
+                ih_->get_value(lower_key_.data(), &rids_, context_->txn_);
+            }
+            if (with_entries() && !rids_.empty()) {
+                keys_ = lower_key_;  // 键就是要查找的键
+            }
+        } else if (point_key_ && !ih_->may_contain(lower_key_.data())) {
+            scan_.reset();  // 布隆过滤器判定键不存在，不访问索引页面
+        } else if (bitmap_heap_) {
+            scan_.reset();
+            collect_heap_rids();
+        } else {
+            scan_ = std::make_unique<IxScan>(ih_, lower_key_.data(), upper_key_.data(),
+                                             sm_manager_->get_bpm(), with_entries(), reverse_);
+        }
+        find_next();
+    }
 
-    std::unique_ptr<RmRecord> Next() override { return nullptr; }
+    void nextTuple() override {
+        if (is_end()) {
+            return;
+        }
+        rid_pos_++;
+        find_next();
+    }
+
+    std::unique_ptr<RmRecord> Next() override { return fetch_record(out_fields_); }
 
     Rid &rid() override { return rid_; }
-};
\ No newline at end of file
+
+    bool is_end() const override { return rid_pos_ == rids_.size() && scan_end(); }
+
+    std::string getType() override { return "IndexScanExecutor"; }
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return cols_; }
+
+    /**
+     * @brief 根据谓词计算索引键的范围：从第一个字段开始，连续的等值字段取该值，
+     * 之后第一个有范围谓词的字段取范围的上下界，其余字段取类型的最小值和最大值
+     * 谓词的左边必须是本表的字段；优化器也用它估计范围扫描的选择率
+     * @return 从第一个字段开始连续的等值字段个数
+     */
+    static size_t make_key_range(const std::string &tab_name, const IndexMeta &index_meta,
+                                 const std::vector<Condition> &conds, std::vector<char> *lower_key,
+                                 std::vector<char> *upper_key) {
+        lower_key->assign(index_meta.key_len(), 0);
+        upper_key->assign(index_meta.key_len(), 0);
+        bool ranged = false;  // 之前的字段已经是范围，之后的字段不再限制
+        int offset = 0;       // 字段在索引键中的偏移
+        size_t num_equal = 0;  // 从第一个字段开始连续的等值字段个数
+        for (auto &col : index_meta.cols) {
+            char *lo = lower_key->data() + offset;
+            char *hi = upper_key->data() + offset;
+            offset += col.len;
+            set_min(lo, col);
+            set_max(hi, col);
+            if (ranged) {
+                continue;
+            }
+            bool equal = false;
+            for (auto &cond : conds) {
+                if (!cond.is_rhs_val || cond.lhs_col.tab_name != tab_name ||
+                    cond.lhs_col.col_name != col.name || cond.rhs_val.type != col.type) {
+                    continue;
+                }
+                const char *value = cond.rhs_val.raw->data;
+                if (cond.op == OP_EQ) {
+                    memcpy(lo, value, col.len);
+                    memcpy(hi, value, col.len);
+                    equal = true;
+                    break;
+                }
+                if ((cond.op == OP_GT || cond.op == OP_GE) &&
+                    ix_compare(value, lo, col.type, col.len) > 0) {
+                    memcpy(lo, value, col.len);
+                } else if ((cond.op == OP_LT || cond.op == OP_LE) &&
+                           ix_compare(value, hi, col.type, col.len) < 0) {
+                    memcpy(hi, value, col.len);
+                }
+            }
+            ranged = !equal;
+            num_equal += equal;
+        }
+        return num_equal;
+    }
+
+   private:
+    bool scan_end() const { return scan_ == nullptr || scan_->is_end(); }
+
+    // 是否需要从索引取出索引项：仅索引扫描由索引项构造记录，聚簇表从索引项中取主键
+    bool with_entries() const { return index_only_ || clustered_ != nullptr; }
+
+    /**
+     * @brief 从rid_pos_开始找到第一个满足谓词的元组，当前一批rid处理完后从索引取下一个叶结点的rid
+     */
+    void find_next() {
+        while (true) {
+            if (rid_pos_ == rids_.size()) {
+                rids_.clear();
+                keys_.clear();
+                rid_pos_ = 0;
+                if (scan_end()) {
+                    rid_ = Rid{-1, -1};
+                    return;
+                }
+                scan_->next_batch(&rids_, with_entries() ? &keys_ : nullptr);
+                continue;
+            }
+            rid_ = rids_[rid_pos_];
+            if (conds_.empty() && !bitmap_heap_) {
+                return;
+            }
+            auto record = fetch_record(cond_fields_);
+            if (record && eval_conds(record.get(), conds_, cols_)) {
+                return;
+            }
+            rid_pos_++;
+        }
+    }
+
+    void init_key_range() {
+        size_t num_equal = make_key_range(tab_name_, index_meta_, conds_, &lower_key_, &upper_key_);
+        point_key_ = num_equal >= index_meta_.cols.size();
+    }
+
+    static void set_min(char *dest, const ColMeta &col) { ix_set_min(dest, col.type, col.len); }
+
+    static void set_max(char *dest, const ColMeta &col) { ix_set_max(dest, col.type, col.len); }
+
+    // 将本表的字段col加入字段下标集合fields，其他表的字段忽略
+    void add_field(std::vector<int> &fields, const TabCol &col) {
+        if (col.tab_name != tab_name_) {
+            return;
+        }
+        auto pos = get_col(cols_, col);
+        int idx = pos - cols_.begin();
+        if (std::find(fields.begin(), fields.end(), idx) == fields.end()) {
+            fields.push_back(idx);
+        }
+    }
+
+    std::unique_ptr<RmRecord> fetch_record(const std::vector<int> &fields) {
+        if (index_only_) {
+            return record_from_key();
+        }
+        if (clustered_ != nullptr) {
+            return clustered_record();
+        }
+        if (bitmap_heap_) {
+            return heap_record();
+        }
+        if (!prune_cols_) {
+            return fh_->get_record(rid_, context_);
+        }
+        return fh_->get_record(rid_, fields, context_);
+    }
+
+    /**
+     * @brief 位图堆扫描：取出范围内的全部rid，用IxBitmap按(页面号, 槽位号)排序去重，并按页面分段
+     */
+    void collect_heap_rids() {
+        if (clustered_ != nullptr) {
+            collect_clustered_entries();
+            return;
+        }
+        IxScan scan(ih_, lower_key_.data(), upper_key_.data(), sm_manager_->get_bpm());
+        IxBitmap bitmap;
+        std::vector<Rid> batch;
+        while (!scan.is_end()) {
+            batch.clear();
+            scan.next_batch(&batch);
+            for (auto &rid : batch) {
+                bitmap.add(rid);
+            }
+        }
+        bitmap.to_rids(&rids_);
+        page_starts_.clear();
+        for (size_t i = 0; i < rids_.size(); i++) {
+            if (i == 0 || rids_[i].page_no != rids_[i - 1].page_no) {
+                page_starts_.push_back(i);
+            }
+        }
+        page_starts_.push_back(rids_.size());
+        page_idx_ = 0;
+        page_loaded_ = false;
+        prefetched_idx_ = 0;
+    }
+
+    /**
+     * @brief 聚簇表的位图堆扫描：取出范围内的全部索引项，按主键的规范化形式排序，
+     * 之后由clustered_record()依次按主键查找
+     */
+    void collect_clustered_entries() {
+        IxScan scan(ih_, lower_key_.data(), upper_key_.data(), sm_manager_->get_bpm(), true);
+        std::vector<Rid> rids;
+        std::vector<char> entries;
+        while (!scan.is_end()) {
+            scan.next_batch(&rids, &entries);
+        }
+        size_t entry_len = index_meta_.col_tot_len;
+        size_t pk_len = 0;
+        for (int len : pk_lens_) {
+            pk_len += len;
+        }
+        std::vector<std::pair<std::string, size_t>> order;  // (规范化的主键, 索引项的下标)
+        std::vector<char> pk(pk_len);
+        for (size_t i = 0; i < rids.size(); i++) {
+            primary_key(entries.data() + i * entry_len, pk.data());
+            std::string encoded(pk_len, 0);
+            ix_encode_key(pk.data(), &encoded[0], pk_types_, pk_lens_);
+            order.emplace_back(std::move(encoded), i);
+        }
+        std::sort(order.begin(), order.end());
+        keys_.resize(entries.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            rids_.push_back(rids[order[i].second]);
+            memcpy(keys_.data() + i * entry_len, entries.data() + order[i].second * entry_len, entry_len);
+        }
+    }
+
+    // 从索引项中取出主键，各字段依次存放到pk
+    void primary_key(const char *entry, char *pk) const {
+        for (size_t i = 0; i < pk_offsets_.size(); i++) {
+            memcpy(pk, entry + pk_offsets_[i], pk_lens_[i]);
+            pk += pk_lens_[i];
+        }
+    }
+
+    /**
+     * @brief 聚簇表按当前索引项中的主键查找记录，记录已被删除时返回nullptr
+     */
+    std::unique_ptr<RmRecord> clustered_record() {
+        size_t key_pos = point_lookup_ ? 0 : rid_pos_ * index_meta_.col_tot_len;
+        std::vector<char> pk(index_meta_.col_tot_len);
+        primary_key(keys_.data() + key_pos, pk.data());
+        return clustered_->get_record_by_key(pk.data());
+    }
+
+    /**
+     * @brief 位图堆扫描时返回rid_pos_处的记录，槽位上已经没有记录时返回nullptr
+     * 进入一个新页面时一次读出该页面中所有rid的记录(上层需要的字段，包括谓词用到的字段)，
+     * 并预读之后的RM_HEAP_PREFETCH_PAGES个页面
+     */
+    std::unique_ptr<RmRecord> heap_record() {
+        if (!page_loaded_ || rid_pos_ >= page_starts_[page_idx_ + 1]) {
+            while (page_loaded_ && rid_pos_ >= page_starts_[page_idx_ + 1]) {
+                page_idx_++;
+            }
+            page_loaded_ = true;
+            size_t num_pages = page_starts_.size() - 1;
+            for (prefetched_idx_ = std::max(prefetched_idx_, page_idx_ + 1);
+                 prefetched_idx_ < num_pages && prefetched_idx_ <= page_idx_ + RM_HEAP_PREFETCH_PAGES;
+                 prefetched_idx_++) {
+                sm_manager_->get_bpm()->prefetch_page(
+                    PageId{heap_fh_->GetFd(), rids_[page_starts_[prefetched_idx_]].page_no});
+            }
+            size_t begin = page_starts_[page_idx_];
+            heap_fh_->get_records(rids_.data() + begin, page_starts_[page_idx_ + 1] - begin,
+                             prune_cols_ ? &out_fields_ : nullptr, &page_records_, context_);
+        }
+        auto &record = page_records_[rid_pos_ - page_starts_[page_idx_]];
+        return record == nullptr ? nullptr : std::make_unique<RmRecord>(*record);
+    }
+
+    /**
+     * @brief 仅索引扫描时由当前索引项构造记录，只有索引项中的字段有效
+     */
+    std::unique_ptr<RmRecord> record_from_key() {
+        auto record = std::make_unique<RmRecord>(len_);
+        size_t key_pos = point_lookup_ ? 0 : rid_pos_ * index_meta_.col_tot_len;
+        const char *key = keys_.data() + key_pos;
+        for (auto &col : entry_cols_) {
+            memcpy(record->data + col.offset, key, col.len);
+            key += col.len;
+        }
+        return record;
+    }
+
+    bool eval_cond(const RmRecord *rec, const Condition &cond,
+                   const std::vector<ColMeta> &rec_cols) {
+        auto left_col = get_col(cols_, cond.lhs_col);
+        char *left_val = rec->data + left_col->offset;
+
+        char *right_val = nullptr;
+        ColType col_type;
+        int len = left_col->len;
+
+        if (cond.is_rhs_val) {
+            right_val = cond.rhs_val.raw->data;
+            col_type = cond.rhs_val.type;
+        } else {
+            auto right_col = get_col(cols_, cond.rhs_col);
+            right_val = rec->data + right_col->offset;
+            col_type = right_col->type;
+        }
+
+        int cmp_result = ix_compare(left_val, right_val, col_type, len);
+        switch (cond.op) {
+            case OP_EQ:
+                return cmp_result == 0;
+            case OP_NE:
+                return cmp_result != 0;
+            case OP_LT:
+                return cmp_result < 0;
+            case OP_GT:
+                return cmp_result > 0;
+            case OP_LE:
+                return cmp_result <= 0;
+            case OP_GE:
+                return cmp_result >= 0;
+            default:
+                return false;
+        }
+    }
+
+    bool eval_conds(const RmRecord *rec, const std::vector<Condition> &conds,
+                    const std::vector<ColMeta> &rec_cols) {
+        return std::all_of(conds.begin(), conds.end(),
+                           [&](const Condition &cond) {
+                               return eval_cond(rec, cond, rec_cols);
+                           });
+    }
+};
@@ -19,7 +19,7 @@ class InsertExecutor : public AbstractExecutor {
    private:
     TabMeta tab_;                // 表的元数据
     std::vector<Value> values_;  // 需要插入的数据
-    RmFileHandle *fh_;           // 表的数据文件句柄
+    RmTableHandle *fh_;          // 表的记录存取接口
     std::string tab_name_;       // 表名称
     Rid rid_;  // 插入的位置，由于系统默认插入时不指定位置，因此当前rid_在插入后才赋值
     SmManager *sm_manager_;
@@ -34,13 +34,13 @@ class InsertExecutor : public AbstractExecutor {
         if (values.size() != tab_.cols.size()) {
             throw InvalidValueCountError();
         }
-        fh_ = sm_manager_->fhs_.at(tab_name).get();
+        fh_ = sm_manager_->get_table_handle(tab_name);
         context_ = context;
     };
 
     std::unique_ptr<RmRecord> Next() override {
         // Make record buffer
-        RmRecord rec(fh_->get_file_hdr().record_size);
+        RmRecord rec(fh_->record_size());
         for (size_t i = 0; i < values_.size(); i++) {
             auto &col = tab_.cols[i];
             auto &val = values_[i];
@@ -51,24 +51,21 @@ class InsertExecutor : public AbstractExecutor {
             val.init_raw(col.len);
             memcpy(rec.data + col.offset, val.raw->data, col.len);
         }
+        // 唯一索引中已有相同的键时插入失败，记录和索引都还没有改动
+        std::vector<std::vector<char>> keys(tab_.indexes.size());
+        for (size_t i = 0; i < tab_.indexes.size(); ++i) {
+            auto &index = tab_.indexes[i];
+            keys[i].resize(index.col_tot_len);
+            index.extract_key(rec.data, keys[i].data());
+            sm_manager_->check_unique(index, keys[i].data(), context_->txn_);
+        }
+
         // Insert into record file
         rid_ = fh_->insert_record(rec.data, context_);
 
         // Insert into index
         for (size_t i = 0; i < tab_.indexes.size(); ++i) {
-            auto &index = tab_.indexes[i];
-            auto ih = sm_manager_->ihs_
-                          .at(sm_manager_->get_ix_manager()->get_index_name(
-                              tab_name_, index.cols))
-                          .get();
-            char *key = new char[index.col_tot_len];
-            int offset = 0;
-            for (size_t i = 0; i < index.col_num; ++i) {
-                memcpy(key + offset, rec.data + index.cols[i].offset,
-                       index.cols[i].len);
-                offset += index.cols[i].len;
-            }
-            ih->insert_entry(key, rid_, context_->txn_);
+            sm_manager_->insert_index_entry(tab_.indexes[i], keys[i].data(), rid_, context_->txn_);
         }
         return nullptr;
     }
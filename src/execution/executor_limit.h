@@ -0,0 +1,66 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+#include "execution_defs.h"
+#include "execution_manager.h"
+#include "executor_abstract.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+/**
+ * @description: LIMIT n，输出子算子的前n个元组后结束，不再向子算子要后面的元组。
+ * 子算子是按索引顺序的扫描时，只读取索引中前n个满足条件的项
+ */
+class LimitExecutor : public AbstractExecutor {
+   private:
+    std::unique_ptr<AbstractExecutor> prev_;
+    size_t limit_;
+    size_t count_ = 0;  // 已经越过的元组数
+
+   public:
+    LimitExecutor(std::unique_ptr<AbstractExecutor> prev, size_t limit) {
+        prev_ = std::move(prev);
+        limit_ = limit;
+    }
+
+    void set_required_cols(const std::vector<TabCol> &cols) override {
+        prev_->set_required_cols(cols);
+    }
+
+    void beginTuple() override {
+        count_ = 0;
+        if (limit_ > 0) {
+            prev_->beginTuple();
+        }
+    }
+
+    void nextTuple() override {
+        if (is_end()) {
+            return;
+        }
+        count_++;
+        if (count_ < limit_) {
+            prev_->nextTuple();
+        }
+    }
+
+    std::unique_ptr<RmRecord> Next() override { return prev_->Next(); }
+
+    Rid &rid() override { return prev_->rid(); }
+
+    bool is_end() const override { return count_ >= limit_ || prev_->is_end(); }
+
+    std::string getType() override { return "LimitExecutor"; }
+
+    size_t tupleLen() const override { return prev_->tupleLen(); }
+
+    const std::vector<ColMeta> &cols() const override { return prev_->cols(); }
+};
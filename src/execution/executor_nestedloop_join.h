@@ -24,11 +24,15 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
 
     std::vector<Condition> fed_conds_;  // join条件
     bool isend;
+    std::unique_ptr<RmRecord> left_rec_;   // 外层循环当前的左元组，内层循环期间保持不变
+    std::unique_ptr<RmRecord> right_rec_;  // 内层循环当前的右元组
+    RmArena *arena_;                       // 输出元组从这里分配
 
    public:
     NestedLoopJoinExecutor(std::unique_ptr<AbstractExecutor> left,
                            std::unique_ptr<AbstractExecutor> right,
-                           std::vector<Condition> conds) {
+                           std::vector<Condition> conds, RmArena *arena = nullptr) {
+        arena_ = arena;
         left_ = std::move(left);
         right_ = std::move(right);
         len_ = left_->tupleLen() + right_->tupleLen();
@@ -43,66 +47,52 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
         fed_conds_ = std::move(conds);
     }
 
-    void beginTuple() override {  // 左右子执行器到起点
+    // 上层需要的字段加上join条件中的字段，一并下推给左右子执行器
+    void set_required_cols(const std::vector<TabCol> &cols) override {
+        std::vector<TabCol> required = cols;
+        for (auto &cond : fed_conds_) {
+            required.push_back(cond.lhs_col);
+            if (!cond.is_rhs_val) {
+                required.push_back(cond.rhs_col);
+            }
+        }
+        left_->set_required_cols(required);
+        right_->set_required_cols(required);
+    }
+
+    void beginTuple() override {  // 左右子执行器到起点，并定位到第一对满足条件的元组
         left_->beginTuple();
         right_->beginTuple();
+        isend = left_->is_end();
+        if (!isend) {
+            left_rec_ = left_->Next();
+            seek();
+        }
     }
 
     void nextTuple() override {
-        // 右表未结束：仅移动右表指针（内层循环）。
-        // 右表结束：
-        //  移动左表指针（外层循环）。
-        //  若左表结束，标记 isend = true。
-        //  否则重置右表到起始位置（开始新一轮内层循环）。
-        // 通过模拟嵌套循环（左表为外层，右表为内层）实现连接。
-        if (!right_->is_end()) {
-            right_->nextTuple();
-        }
-
-        while (!left_->is_end()) {
-            auto left_rec = left_->Next();
-            while (!right_->is_end()) {
-                auto right_rec = right_->Next();
-                if (eval_conds(left_rec.get(), right_rec.get(), fed_conds_,
-                               cols_)) {
-                    return;
-                }
-                right_->nextTuple();
-            }
-
-            left_->nextTuple();
-            if (left_->is_end()) break;
-
-            right_->beginTuple();
+        if (isend) {
+            return;
         }
-        isend = true;
+        right_->nextTuple();
+        seek();
     }
 
     std::unique_ptr<RmRecord> Next() override {
-        // 若满足条件，将左右元组拼接成新记录返回。
-        while (!isend) {
-            std::unique_ptr<RmRecord> left_rec = left_->Next();
-            std::unique_ptr<RmRecord> right_rec = right_->Next();
-
-            if (eval_conds(left_rec.get(), right_rec.get(), fed_conds_,
-                           cols_)) {
-                std::unique_ptr<RmRecord> join_rec =
-                    std::make_unique<RmRecord>(len_);
-                memcpy(join_rec->data, left_rec->data, left_->tupleLen());
-                memcpy(join_rec->data + left_->tupleLen(), right_rec->data,
-                       right_->tupleLen());
-                return join_rec;
-            }
-
-            nextTuple();
+        // 左右元组在seek时已经取出并缓存，这里直接拼接，不再重复向子执行器取元组
+        if (isend) {
+            return nullptr;
         }
-
-        return nullptr;
+        std::unique_ptr<RmRecord> join_rec = RmRecord::make(len_, arena_);
+        memcpy(join_rec->data, left_rec_->data, left_->tupleLen());
+        memcpy(join_rec->data + left_->tupleLen(), right_rec_->data,
+               right_->tupleLen());
+        return join_rec;
     }
 
     Rid &rid() override { return _abstract_rid; }
 
-    bool is_end() const override { return left_->is_end(); }  // return true;
+    bool is_end() const override { return isend; }
 
     std::string getType() override { return "NestedLoopJoinExecutor"; }
 
@@ -111,6 +101,30 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
     const std::vector<ColMeta> &cols() const override { return cols_; }
 
    private:
+    /**
+     * @description: 从当前位置开始模拟嵌套循环(左表为外层，右表为内层)，
+     * 直到找到下一对满足join条件的元组，或者左表结束时标记isend
+     */
+    void seek() {
+        while (true) {
+            while (!right_->is_end()) {
+                right_rec_ = right_->Next();
+                if (eval_conds(left_rec_.get(), right_rec_.get(), fed_conds_,
+                               cols_)) {
+                    return;
+                }
+                right_->nextTuple();
+            }
+            left_->nextTuple();
+            if (left_->is_end()) {
+                isend = true;
+                return;
+            }
+            left_rec_ = left_->Next();
+            right_->beginTuple();
+        }
+    }
+
     bool eval_cond(const RmRecord *lhs_rec, const RmRecord *rhs_rec,
                    const Condition &cond,
                    const std::vector<ColMeta> &rec_cols) {
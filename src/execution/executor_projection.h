@@ -21,10 +21,12 @@ class ProjectionExecutor : public AbstractExecutor {
     std::vector<ColMeta> cols_;               // 需要投影的字段
     size_t len_;                              // 字段总长度
     std::vector<size_t> sel_idxs_;
+    RmArena *arena_;                          // 输出元组从这里分配
 
    public:
     ProjectionExecutor(std::unique_ptr<AbstractExecutor> prev,
-                       const std::vector<TabCol> &sel_cols) {
+                       const std::vector<TabCol> &sel_cols, RmArena *arena = nullptr) {
+        arena_ = arena;
         prev_ = std::move(prev);
 
         size_t curr_offset = 0;
@@ -38,6 +40,7 @@ class ProjectionExecutor : public AbstractExecutor {
             cols_.push_back(col);
         }
         len_ = curr_offset;
+        prev_->set_required_cols(sel_cols);
     }
 
     void beginTuple() override { prev_->beginTuple(); }
@@ -51,8 +54,7 @@ class ProjectionExecutor : public AbstractExecutor {
             return nullptr;
         }
 
-        std::unique_ptr<RmRecord> proj_rec =
-            std::make_unique<RmRecord>(len_);  // 创建空输出元组
+        std::unique_ptr<RmRecord> proj_rec = RmRecord::make(len_, arena_);  // 创建空输出元组
             
         // 复制投影列数据
         for (size_t i = 0; i < sel_idxs_.size(); i++) {
@@ -10,6 +10,9 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <functional>
+#include <limits>
+
 #include "execution_defs.h"
 #include "execution_manager.h"
 #include "executor_abstract.h"
@@ -20,10 +23,21 @@ class SeqScanExecutor : public AbstractExecutor {
    private:
     std::string tab_name_;              // 表的名称
     std::vector<Condition> conds_;      // scan的条件
-    RmFileHandle *fh_;                  // 表的数据文件句柄
+    RmTableHandle *fh_;                 // 表的记录存取接口
     std::vector<ColMeta> cols_;         // scan后生成的记录的字段
     size_t len_;                        // scan后生成的每条记录的长度
     std::vector<Condition> fed_conds_;  // 同conds_，两个字段相同
+    bool prune_cols_ = false;           // 是否只读取需要的字段
+    std::vector<int> cond_fields_;      // 谓词用到的字段下标
+    std::vector<int> out_fields_;       // 上层需要的字段下标(包括谓词用到的字段)
+
+    // 可以用zone map剪枝的谓词，每项为(zone map中的列号, 取值区间[lo, hi])
+    struct ZoneRange {
+        int zone_col;
+        double lo;
+        double hi;
+    };
+    std::vector<ZoneRange> zone_ranges_;
 
     Rid rid_;
     std::unique_ptr<RecScan> scan_;  // table_iterator
@@ -37,13 +51,29 @@ class SeqScanExecutor : public AbstractExecutor {
         tab_name_ = std::move(tab_name);
         conds_ = std::move(conds);
         TabMeta &tab = sm_manager_->db_.get_table(tab_name_);
-        fh_ = sm_manager_->fhs_.at(tab_name_).get();
+        fh_ = sm_manager_->get_table_handle(tab_name_);
         cols_ = tab.cols;
         len_ = cols_.back().offset + cols_.back().len;
 
         context_ = context;
 
         fed_conds_ = conds_;
+
+        for (auto &cond : conds_) {
+            add_field(cond_fields_, cond.lhs_col);
+            if (!cond.is_rhs_val) {
+                add_field(cond_fields_, cond.rhs_col);
+            }
+        }
+        init_zone_ranges();
+    }
+
+    void set_required_cols(const std::vector<TabCol> &cols) override {
+        out_fields_ = cond_fields_;
+        for (auto &col : cols) {
+            add_field(out_fields_, col);
+        }
+        prune_cols_ = true;
     }
 
     /**
@@ -52,17 +82,32 @@ class SeqScanExecutor : public AbstractExecutor {
      *
      */
     void beginTuple() override {
-        scan_ = std::make_unique<RmScan>(fh_);
+        std::function<bool(int)> page_filter = nullptr;
+        if (!zone_ranges_.empty()) {
+            RmZoneMap *zone_map = fh_->get_zone_map();
+            page_filter = [this, zone_map](int page_no) {
+                return std::all_of(zone_ranges_.begin(), zone_ranges_.end(),
+                                   [&](const ZoneRange &range) {
+                                       return zone_map->may_contain(page_no, range.zone_col,
+                                                                    range.lo, range.hi);
+                                   });
+            };
+        }
+        scan_ = fh_->scan(page_filter);
         while (!scan_->is_end()) {  // 循环扫描直到满足条件或文件结束
             rid_ =
                 scan_->rid();  // 存储当前满足条件的元组在表中的物理位置（页号
                                // + 槽号）
-            auto record = fh_->get_record(rid_, context_);
+            if (conds_.empty()) {
+                break;
+            }
+            // 谓词求值只需要读取谓词用到的字段
+            auto record = fetch_record(cond_fields_);
             if (!record) {
                 scan_->next();
                 continue;
             }
-            if (conds_.empty() || eval_conds(record.get(), conds_, cols_)) {
+            if (eval_conds(record.get(), conds_, cols_)) {
                 break;
             }
             scan_->next();
@@ -86,12 +131,16 @@ class SeqScanExecutor : public AbstractExecutor {
         scan_->next();              // 移动到下一条记录
         while (!scan_->is_end()) {  // 从当前 scan_ 位置继续扫描
             rid_ = scan_->rid();
-            auto record = fh_->get_record(rid_, context_);
+            if (conds_.empty()) {
+                break;
+            }
+            // 谓词求值只需要读取谓词用到的字段
+            auto record = fetch_record(cond_fields_);
             if (!record) {
                 scan_->next();
                 continue;
             }
-            if (conds_.empty() || eval_conds(record.get(), conds_, cols_)) {
+            if (eval_conds(record.get(), conds_, cols_)) {
                 break;
             }
             scan_->next();
@@ -104,8 +153,7 @@ class SeqScanExecutor : public AbstractExecutor {
      * @return std::unique_ptr<RmRecord>
      */
     std::unique_ptr<RmRecord> Next() override {  // 获取当前元组？
-        return fh_->get_record(rid_, context_);
-        // return nullptr;
+        return fetch_record(out_fields_);
     }
 
     Rid &rid() override { return rid_; }
@@ -119,6 +167,63 @@ class SeqScanExecutor : public AbstractExecutor {
     const std::vector<ColMeta> &cols() const override { return cols_; }
 
    private:
+    /**
+     * @description: 把"数值字段 op 常量"形式的谓词转换为zone map上的取值区间
+     * 不等于谓词无法剪枝，字符串字段不在zone map中
+     */
+    void init_zone_ranges() {
+        RmZoneMap *zone_map = fh_->get_zone_map();
+        if (zone_map == nullptr) {
+            return;
+        }
+        constexpr double inf = std::numeric_limits<double>::infinity();
+        for (auto &cond : conds_) {
+            if (!cond.is_rhs_val || cond.lhs_col.tab_name != tab_name_ || cond.op == OP_NE) {
+                continue;
+            }
+            auto col = get_col(cols_, cond.lhs_col);
+            if (col->type != cond.rhs_val.type) {
+                continue;
+            }
+            int zone_col = zone_map->find_col(col->offset);
+            if (zone_col < 0) {
+                continue;
+            }
+            double value = col->type == TYPE_INT ? cond.rhs_val.int_val : cond.rhs_val.float_val;
+            ZoneRange range{zone_col, -inf, inf};
+            if (cond.op == OP_EQ || cond.op == OP_GT || cond.op == OP_GE) {
+                range.lo = value;
+            }
+            if (cond.op == OP_EQ || cond.op == OP_LT || cond.op == OP_LE) {
+                range.hi = value;
+            }
+            zone_ranges_.push_back(range);
+        }
+    }
+
+    // 将本表的字段col加入字段下标集合fields，其他表的字段忽略
+    void add_field(std::vector<int> &fields, const TabCol &col) {
+        if (col.tab_name != tab_name_) {
+            return;
+        }
+        auto pos = get_col(cols_, col);
+        int idx = pos - cols_.begin();
+        if (std::find(fields.begin(), fields.end(), idx) == fields.end()) {
+            fields.push_back(idx);
+        }
+    }
+
+    std::unique_ptr<RmRecord> fetch_record(const std::vector<int> &fields) {
+        // 扫描时已经读出了当前记录(如LSM表)，直接拷贝，不再按rid查找
+        if (const char *data = scan_->record()) {
+            return std::make_unique<RmRecord>(fh_->record_size(), const_cast<char *>(data));
+        }
+        if (!prune_cols_) {
+            return fh_->get_record(rid_, context_);
+        }
+        return fh_->get_record(rid_, fields, context_);
+    }
+
     bool eval_cond(const RmRecord *rec, const Condition &cond,
                    const std::vector<ColMeta> &rec_cols) {
         auto left_col = get_col(cols_, cond.lhs_col);
@@ -19,7 +19,7 @@ class UpdateExecutor : public AbstractExecutor {
    private:
     TabMeta tab_;
     std::vector<Condition> conds_;
-    RmFileHandle* fh_;
+    RmTableHandle* fh_;
     std::vector<Rid>
         rids_;  // rids_ 是通过 UpdateExecutor
                 // 的构造函数参数传入的，这些记录ID是前置执行器（如
@@ -37,64 +37,58 @@ class UpdateExecutor : public AbstractExecutor {
         tab_name_ = tab_name;
         set_clauses_ = set_clauses;
         tab_ = sm_manager_->db_.get_table(tab_name);
-        fh_ = sm_manager_->fhs_.at(tab_name).get();
+        fh_ = sm_manager_->get_table_handle(tab_name);
         conds_ = conds;
         rids_ = rids;
         context_ = context;
     }
 
     std::unique_ptr<RmRecord> Next() override {
-        // 预加载,获取当前表的所有索引元数据 (IndexMeta) 和索引句柄
-        // (IxIndexHandle)。
-        std::vector<std::pair<IndexMeta*, IxIndexHandle*>> index_handles;
-        for (auto& index : tab_.indexes) {
-            std::string index_name =
-                sm_manager_->get_ix_manager()->get_index_name(
-                    tab_name_,
-                    index.cols);  // 获取索引名
-            auto it = sm_manager_->ihs_.find(index_name);
-            if (it != sm_manager_->ihs_.end()) {
-                index_handles.emplace_back(&index, it->second.get());
-            }
-        }
-
         // 键缓冲区,为每个索引分配内存缓冲区，用于临时存储索引键值。
+        // 索引项通过SmManager按索引的组织方式(B+树、哈希或位图)维护
         std::unordered_map<IndexMeta*, std::vector<char>> key_buffers;
-        for (const auto& [index_meta, _] : index_handles) {
-            key_buffers[index_meta].resize(index_meta->col_tot_len);
+        for (auto& index : tab_.indexes) {
+            key_buffers[&index].resize(index.col_tot_len);
         }
 
         for (auto& rid : rids_) {  // 遍历所有需要更新的记录
             auto rec = fh_->get_record(rid, context_);
 
             // 更新
+            RmRecord new_rec(*rec);
             for (auto& set_clause : set_clauses_) {
                 auto lhs_col = tab_.get_col(set_clause.lhs.col_name);
-                memcpy(rec->data + lhs_col->offset, set_clause.rhs.raw->data,
+                memcpy(new_rec.data + lhs_col->offset, set_clause.rhs.raw->data,
                        lhs_col->len);
             }
-
-            // 删除旧索引
-            for (auto& [index_meta, ih] : index_handles) {
-                auto& key_buf = key_buffers[index_meta];  // 读取记录数据
-                int offset = 0;
-                // 更新记录字段
-                for (size_t j = 0; j < index_meta->col_num; ++j) {
-                    memcpy(key_buf.data() + offset,
-                           rec->data + index_meta->cols[j].offset,
-                           index_meta->cols[j].len);
-                    offset += index_meta->cols[j].len;
+            // 唯一索引的键改变时，新键不能已经存在
+            for (auto& [index_meta, key_buf] : key_buffers) {
+                if (!index_meta->unique()) {
+                    continue;
+                }
+                std::vector<char> old_key(index_meta->col_tot_len);
+                index_meta->extract_key(rec->data, old_key.data());
+                index_meta->extract_key(new_rec.data, key_buf.data());
+                if (memcmp(old_key.data(), key_buf.data(), index_meta->key_len()) != 0) {
+                    sm_manager_->check_unique(*index_meta, key_buf.data(), context_->txn_);
                 }
-                // 删除旧索引
-                ih->delete_entry(key_buf.data(), context_->txn_);
             }
-            // 更新记录
-            fh_->update_record(rid, rec->data, context_);
+            // 先更新记录：聚簇表的主键冲突时在这里失败，索引还没有改动；
+            // 聚簇表修改主键时Rid不变，二级索引键末尾的主键随下面的重新插入更新
+            Rid new_rid = fh_->update_record(rid, new_rec.data, context_);
+
+            // 删除旧索引，键取自更新前的记录
+            for (auto& [index_meta, key_buf] : key_buffers) {
+                index_meta->extract_key(rec->data, key_buf.data());
+                sm_manager_->delete_index_entry(*index_meta, key_buf.data(),
+                                                rid, context_->txn_);
+            }
 
             // 插入新索引
-            for (auto& [index_meta, ih] : index_handles) {
-                auto& key_buf = key_buffers[index_meta];
-                ih->insert_entry(key_buf.data(), rid, context_->txn_);
+            for (auto& [index_meta, key_buf] : key_buffers) {
+                index_meta->extract_key(new_rec.data, key_buf.data());
+                sm_manager_->insert_index_entry(*index_meta, key_buf.data(),
+                                                new_rid, context_->txn_);
             }
         }
         return nullptr;
@@ -10,5 +10,7 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "ix_clustered_table.h"
+#include "ix_external_sort.h"
 #include "ix_manager.h"
 #include "ix_scan.h"
@@ -0,0 +1,91 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "ix_adaptive_hash.h"
+
+// 本线程映射到已占用槽位的查找次数，用于抽样衰减占用者的计数
+static thread_local uint32_t conflict_lookups = 0;
+
+/**
+ * @description: 查找键的哈希项，同时记一次等值查找
+ * @param entry 已记录位置时返回位置
+ * @param hot 没有记录位置时返回该键是否已经是热点键，调用者下降找到键后应调用record()
+ * @return {bool} 是否已记录位置
+ */
+bool IxAdaptiveHash::lookup(uint64_t hash, Entry *entry, bool *hot) {
+    Slot &slot = slot_of(hash);
+    *hot = false;
+    uint64_t tag = slot.tag.load(std::memory_order_acquire);
+    if (tag == hash) {
+        uint32_t count = slot.count.load(std::memory_order_relaxed);
+        if (count < IX_AHI_MAX_COUNT) {
+            // 并发的计数可能丢失几次，只影响键变热的快慢
+            slot.count.store(++count, std::memory_order_relaxed);
+        }
+        uint64_t location = slot.location.load(std::memory_order_acquire);
+        if (location != NO_LOCATION) {
+            entry->page_no = static_cast<page_id_t>(location >> 32);
+            entry->slot_no = static_cast<int>(location & 0xffffffff);
+            entry->epoch = slot.epoch.load(std::memory_order_acquire);
+            return true;
+        }
+        *hot = count >= IX_AHI_HOT_THRESHOLD;
+        return false;
+    }
+    // 槽位被其他键占用：抽样地使占用者的计数减一，减到0后由这个键接管
+    if (tag != 0 && ++conflict_lookups % IX_AHI_DECAY_INTERVAL != 0) {
+        return false;
+    }
+    uint32_t count = slot.count.load(std::memory_order_relaxed);
+    if (tag != 0 && count > 0) {
+        slot.count.store(count - 1, std::memory_order_relaxed);
+        return false;
+    }
+    if (slot.tag.compare_exchange_strong(tag, hash, std::memory_order_acq_rel)) {
+        slot.location.store(NO_LOCATION, std::memory_order_release);
+        slot.count.store(1, std::memory_order_relaxed);
+    }
+    return false;
+}
+
+/**
+ * @description: 记录热点键的位置，entry.epoch须在持有叶结点锁时读取
+ */
+void IxAdaptiveHash::record(uint64_t hash, const Entry &entry) {
+    Slot &slot = slot_of(hash);
+    if (slot.tag.load(std::memory_order_acquire) != hash) {
+        return;
+    }
+    slot.epoch.store(entry.epoch, std::memory_order_release);
+    slot.location.store((static_cast<uint64_t>(static_cast<uint32_t>(entry.page_no)) << 32) |
+                            static_cast<uint32_t>(entry.slot_no),
+                        std::memory_order_release);
+}
+
+/**
+ * @description: 删除键的哈希项，键被删除或哈希项失效时调用
+ */
+void IxAdaptiveHash::erase(uint64_t hash) {
+    Slot &slot = slot_of(hash);
+    if (slot.tag.load(std::memory_order_acquire) == hash) {
+        slot.location.store(NO_LOCATION, std::memory_order_release);
+    }
+}
+
+/**
+ * @description: 清空所有哈希项，叶结点的纪元号保留，不会与已有的哈希项混淆
+ */
+void IxAdaptiveHash::clear() {
+    for (auto &slot : slots_) {
+        slot.location.store(NO_LOCATION, std::memory_order_release);
+        slot.count.store(0, std::memory_order_relaxed);
+        slot.tag.store(0, std::memory_order_release);
+    }
+}
@@ -0,0 +1,94 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+#include "ix_defs.h"
+
+constexpr int IX_AHI_NUM_SLOTS = 4096;   // 计数表的槽位数，键按哈希值直接映射到一个槽位
+constexpr int IX_AHI_NUM_EPOCHS = 1024;  // 纪元号表的大小，叶结点按页面号映射，多个叶结点可能共用一个纪元号
+constexpr uint32_t IX_AHI_HOT_THRESHOLD = 4;  // 同一个键的等值查找达到该次数后记录它的位置
+constexpr uint32_t IX_AHI_MAX_COUNT = 16;     // 查找次数的上限，达到后不再写槽位
+constexpr uint32_t IX_AHI_DECAY_INTERVAL = 8;  // 其他键映射到已占用的槽位时，每这么多次使占用者的计数减一
+
+/**
+ * @description: B+树之上的自适应哈希索引，只在内存中，不写入文件
+ * 固定大小的计数表，每个槽位记录一个键的哈希值、等值查找次数和位置，查找不加锁、不分配内存。
+ * 热点键在一次正常下降后记下它所在的叶结点和槽位，之后的查找直接读这个叶结点，不再从根结点下降。
+ * 其他键映射到已占用的槽位时抽样地使占用者的计数减一，减到0后由新键接管槽位，
+ * 偶尔查找一次的键不会挤掉热点键。
+ * 每个叶结点有一个纪元号，叶结点之间移动键(分裂、重分配、合并)或删除叶结点时在持有该叶结点写锁的情况下加一，
+ * 哈希项记录建立时的纪元号；使用时给叶结点加读锁，纪元号不变且槽位上仍是该键才算命中，否则删除哈希项并正常下降。
+ * 叶结点内的插入和删除会移动槽位，由槽位上的键检查发现；槽位的各字段分别读写，
+ * 读到不一致的组合时同样由这一检查排除。
+ */
+class IxAdaptiveHash {
+   public:
+    struct Entry {
+        page_id_t page_no = IX_NO_PAGE;  // 键所在的叶结点，IX_NO_PAGE表示还没有记录位置
+        int slot_no = -1;
+        uint64_t epoch = 0;  // 记录位置时叶结点的纪元号
+    };
+
+   private:
+    static constexpr uint64_t NO_LOCATION = ~0ULL;
+
+    struct Slot {
+        std::atomic<uint64_t> tag{0};  // 占用槽位的键的哈希值，0表示空槽位
+        std::atomic<uint32_t> count{0};  // 等值查找次数
+        std::atomic<uint64_t> location{NO_LOCATION};  // 叶结点页面号和槽位号
+        std::atomic<uint64_t> epoch{0};
+    };
+
+    Slot slots_[IX_AHI_NUM_SLOTS];
+    std::atomic<uint64_t> epochs_[IX_AHI_NUM_EPOCHS] = {};
+    std::atomic<uint64_t> hits_{0};  // 跳过下降的查找次数
+
+   public:
+    // 键的哈希值，不为0
+    static uint64_t hash(const char *key, int len) {
+        uint64_t h = std::hash<std::string_view>()(std::string_view(key, len));
+        return h == 0 ? 1 : h;
+    }
+
+    bool lookup(uint64_t hash, Entry *entry, bool *hot);
+
+    void record(uint64_t hash, const Entry &entry);
+
+    void erase(uint64_t hash);
+
+    uint64_t page_epoch(page_id_t page_no) const {
+        return epoch_of(page_no).load(std::memory_order_acquire);
+    }
+
+    // 叶结点的纪元号加一，指向它的哈希项全部失效；调用者须持有该叶结点的写锁
+    void invalidate_page(page_id_t page_no) { epoch_of(page_no).fetch_add(1, std::memory_order_acq_rel); }
+
+    void clear();
+
+    void add_hit() { hits_.fetch_add(1, std::memory_order_relaxed); }
+
+    uint64_t hits() const { return hits_; }
+
+   private:
+    Slot &slot_of(uint64_t hash) { return slots_[hash % IX_AHI_NUM_SLOTS]; }
+
+    std::atomic<uint64_t> &epoch_of(page_id_t page_no) {
+        return epochs_[static_cast<uint32_t>(page_no) % IX_AHI_NUM_EPOCHS];
+    }
+
+    const std::atomic<uint64_t> &epoch_of(page_id_t page_no) const {
+        return epochs_[static_cast<uint32_t>(page_no) % IX_AHI_NUM_EPOCHS];
+    }
+};
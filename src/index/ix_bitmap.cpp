@@ -0,0 +1,431 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "ix_bitmap.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+
+static size_t words_for(int max_slot) { return static_cast<size_t>(max_slot) / 64 + 1; }
+
+bool IxBitmapContainer::contains(int slot) const {
+    if (!is_bitmap()) {
+        return std::binary_search(array_.begin(), array_.end(), static_cast<uint16_t>(slot));
+    }
+    size_t i = slot / 64;
+    return i < words_.size() && (words_[i] >> (slot % 64) & 1) != 0;
+}
+
+bool IxBitmapContainer::add(int slot) {
+    assert(slot >= 0 && slot <= UINT16_MAX);
+    if (!is_bitmap()) {
+        auto pos = std::lower_bound(array_.begin(), array_.end(), static_cast<uint16_t>(slot));
+        if (pos != array_.end() && *pos == slot) {
+            return false;
+        }
+        array_.insert(pos, static_cast<uint16_t>(slot));
+        card_++;
+        optimize();
+        return true;
+    }
+    size_t i = slot / 64;
+    if (i >= words_.size()) {
+        words_.resize(i + 1, 0);
+    }
+    uint64_t bit = 1ull << (slot % 64);
+    if ((words_[i] & bit) != 0) {
+        return false;
+    }
+    words_[i] |= bit;
+    card_++;
+    return true;
+}
+
+bool IxBitmapContainer::remove(int slot) {
+    if (!is_bitmap()) {
+        auto pos = std::lower_bound(array_.begin(), array_.end(), static_cast<uint16_t>(slot));
+        if (pos == array_.end() || *pos != slot) {
+            return false;
+        }
+        array_.erase(pos);
+        card_--;
+        return true;
+    }
+    size_t i = slot / 64;
+    uint64_t bit = 1ull << (slot % 64);
+    if (i >= words_.size() || (words_[i] & bit) == 0) {
+        return false;
+    }
+    words_[i] &= ~bit;
+    card_--;
+    optimize();
+    return true;
+}
+
+IxBitmapContainer IxBitmapContainer::intersect(const IxBitmapContainer &a,
+                                               const IxBitmapContainer &b) {
+    IxBitmapContainer result;
+    if (!a.is_bitmap() && !b.is_bitmap()) {
+        std::set_intersection(a.array_.begin(), a.array_.end(), b.array_.begin(),
+                              b.array_.end(), std::back_inserter(result.array_));
+        result.card_ = result.array_.size();
+        return result;
+    }
+    if (!a.is_bitmap() || !b.is_bitmap()) {
+        // 数组与位图：逐个检查数组中的槽位，结果不会比数组大
+        const IxBitmapContainer &array = a.is_bitmap() ? b : a;
+        const IxBitmapContainer &bitmap = a.is_bitmap() ? a : b;
+        for (uint16_t slot : array.array_) {
+            if (bitmap.contains(slot)) {
+                result.array_.push_back(slot);
+            }
+        }
+        result.card_ = result.array_.size();
+        return result;
+    }
+    size_t n = std::min(a.words_.size(), b.words_.size());
+    result.words_.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        result.words_[i] = a.words_[i] & b.words_[i];
+        result.card_ += __builtin_popcountll(result.words_[i]);
+    }
+    result.optimize();
+    return result;
+}
+
+IxBitmapContainer IxBitmapContainer::unite(const IxBitmapContainer &a,
+                                           const IxBitmapContainer &b) {
+    IxBitmapContainer result;
+    if (!a.is_bitmap() && !b.is_bitmap()) {
+        std::set_union(a.array_.begin(), a.array_.end(), b.array_.begin(), b.array_.end(),
+                       std::back_inserter(result.array_));
+        result.card_ = result.array_.size();
+        result.optimize();
+        return result;
+    }
+    // 有一个是位图时结果直接用位图表示，数组中的槽位逐个置位
+    size_t n = std::max(a.words_.size(), b.words_.size());
+    for (auto *c : {&a, &b}) {
+        if (!c->is_bitmap() && !c->array_.empty()) {
+            n = std::max(n, words_for(c->array_.back()));
+        }
+    }
+    result.words_.assign(n, 0);
+    for (auto *c : {&a, &b}) {
+        if (c->is_bitmap()) {
+            for (size_t i = 0; i < c->words_.size(); i++) {
+                result.words_[i] |= c->words_[i];
+            }
+        } else {
+            for (uint16_t slot : c->array_) {
+                result.words_[slot / 64] |= 1ull << (slot % 64);
+            }
+        }
+    }
+    for (uint64_t word : result.words_) {
+        result.card_ += __builtin_popcountll(word);
+    }
+    result.optimize();
+    return result;
+}
+
+size_t IxBitmapContainer::serialized_size() const {
+    return sizeof(int) * 2 +
+           (is_bitmap() ? words_.size() * sizeof(uint64_t) : array_.size() * sizeof(uint16_t));
+}
+
+/**
+ * @description: 容器的序列化格式为|是否位图(int)|元素或字的个数(int)|槽位号数组或位图的字|
+ * @return {char*} 写入的末尾
+ */
+char *IxBitmapContainer::serialize(char *dest) const {
+    int kind = is_bitmap();
+    int n = is_bitmap() ? words_.size() : array_.size();
+    memcpy(dest, &kind, sizeof(int));
+    memcpy(dest + sizeof(int), &n, sizeof(int));
+    dest += sizeof(int) * 2;
+    size_t len = is_bitmap() ? n * sizeof(uint64_t) : n * sizeof(uint16_t);
+    memcpy(dest, is_bitmap() ? static_cast<const void *>(words_.data()) : array_.data(), len);
+    return dest + len;
+}
+
+const char *IxBitmapContainer::deserialize(const char *src) {
+    int kind, n;
+    memcpy(&kind, src, sizeof(int));
+    memcpy(&n, src + sizeof(int), sizeof(int));
+    src += sizeof(int) * 2;
+    array_.clear();
+    words_.clear();
+    if (kind) {
+        words_.resize(n);
+        memcpy(words_.data(), src, n * sizeof(uint64_t));
+        card_ = 0;
+        for (uint64_t word : words_) {
+            card_ += __builtin_popcountll(word);
+        }
+        return src + n * sizeof(uint64_t);
+    }
+    array_.resize(n);
+    memcpy(array_.data(), src, n * sizeof(uint16_t));
+    card_ = n;
+    return src + n * sizeof(uint16_t);
+}
+
+size_t IxBitmapContainer::serialized_size(const char *src) {
+    int kind, n;
+    memcpy(&kind, src, sizeof(int));
+    memcpy(&n, src + sizeof(int), sizeof(int));
+    return sizeof(int) * 2 + n * (kind ? sizeof(uint64_t) : sizeof(uint16_t));
+}
+
+void IxBitmapContainer::to_bitmap(size_t num_words) {
+    words_.assign(num_words, 0);
+    for (uint16_t slot : array_) {
+        words_[slot / 64] |= 1ull << (slot % 64);
+    }
+    array_.clear();
+    array_.shrink_to_fit();
+}
+
+void IxBitmapContainer::to_array() {
+    std::vector<uint16_t> array;
+    array.reserve(card_);
+    for_each([&](int slot) { array.push_back(static_cast<uint16_t>(slot)); });
+    words_.clear();
+    words_.shrink_to_fit();
+    array_ = std::move(array);
+}
+
+void IxBitmapContainer::optimize() {
+    if (!is_bitmap()) {
+        if (!array_.empty() && array_.size() * sizeof(uint16_t) >
+                                   words_for(array_.back()) * sizeof(uint64_t)) {
+            to_bitmap(words_for(array_.back()));
+        }
+        return;
+    }
+    while (!words_.empty() && words_.back() == 0) {
+        words_.pop_back();
+    }
+    if (static_cast<size_t>(card_) * sizeof(uint16_t) * 2 < words_.size() * sizeof(uint64_t)) {
+        to_array();
+    }
+}
+
+bool IxBitmap::contains(const Rid &rid) const {
+    auto it = containers_.find(rid.page_no);
+    return it != containers_.end() && it->second.contains(rid.slot_no);
+}
+
+bool IxBitmap::add(const Rid &rid) {
+    if (!containers_[rid.page_no].add(rid.slot_no)) {
+        return false;
+    }
+    card_++;
+    return true;
+}
+
+bool IxBitmap::remove(const Rid &rid) {
+    auto it = containers_.find(rid.page_no);
+    if (it == containers_.end() || !it->second.remove(rid.slot_no)) {
+        return false;
+    }
+    if (it->second.empty()) {
+        containers_.erase(it);
+    }
+    card_--;
+    return true;
+}
+
+/**
+ * @description: 两边的容器按页面号归并，只有两边都有的页面才求容器的交集
+ */
+IxBitmap &IxBitmap::operator&=(const IxBitmap &other) {
+    auto jt = other.containers_.begin();
+    card_ = 0;
+    for (auto it = containers_.begin(); it != containers_.end();) {
+        while (jt != other.containers_.end() && jt->first < it->first) {
+            ++jt;
+        }
+        if (jt == other.containers_.end() || jt->first != it->first) {
+            it = containers_.erase(it);
+            continue;
+        }
+        it->second = IxBitmapContainer::intersect(it->second, jt->second);
+        if (it->second.empty()) {
+            it = containers_.erase(it);
+            continue;
+        }
+        card_ += it->second.cardinality();
+        ++it;
+    }
+    return *this;
+}
+
+IxBitmap &IxBitmap::operator|=(const IxBitmap &other) {
+    auto hint = containers_.begin();
+    for (auto &[page_no, container] : other.containers_) {
+        hint = containers_.lower_bound(page_no);
+        if (hint == containers_.end() || hint->first != page_no) {
+            hint = containers_.emplace_hint(hint, page_no, container);
+            card_ += container.cardinality();
+        } else {
+            card_ -= hint->second.cardinality();
+            hint->second = IxBitmapContainer::unite(hint->second, container);
+            card_ += hint->second.cardinality();
+        }
+    }
+    return *this;
+}
+
+void IxBitmap::to_rids(std::vector<Rid> *rids) const {
+    rids->reserve(rids->size() + card_);
+    for (auto &[page_no, container] : containers_) {
+        container.for_each([&](int slot) { rids->push_back(Rid{page_no, slot}); });
+    }
+}
+
+IxBitmap IxBitmap::split_half() {
+    IxBitmap upper;
+    auto mid = std::next(containers_.begin(), containers_.size() / 2);
+    for (auto it = mid; it != containers_.end(); ++it) {
+        upper.card_ += it->second.cardinality();
+        upper.containers_.emplace_hint(upper.containers_.end(), it->first, std::move(it->second));
+    }
+    containers_.erase(mid, containers_.end());
+    card_ -= upper.card_;
+    return upper;
+}
+
+size_t IxBitmap::serialized_size() const {
+    size_t size = sizeof(int);
+    for (auto &entry : containers_) {
+        size += sizeof(int) + entry.second.serialized_size();
+    }
+    return size;
+}
+
+/**
+ * @description: 序列化格式为|容器个数(int)|页面号(int)|容器|页面号(int)|容器|...
+ * @return {char*} 写入的末尾
+ */
+char *IxBitmap::serialize(char *dest) const {
+    int num = containers_.size();
+    memcpy(dest, &num, sizeof(int));
+    dest += sizeof(int);
+    for (auto &[page_no, container] : containers_) {
+        memcpy(dest, &page_no, sizeof(int));
+        dest = container.serialize(dest + sizeof(int));
+    }
+    return dest;
+}
+
+const char *IxBitmap::deserialize(const char *src) {
+    int num;
+    memcpy(&num, src, sizeof(int));
+    src += sizeof(int);
+    containers_.clear();
+    card_ = 0;
+    for (int i = 0; i < num; i++) {
+        int page_no;
+        memcpy(&page_no, src, sizeof(int));
+        IxBitmapContainer container;
+        src = container.deserialize(src + sizeof(int));
+        card_ += container.cardinality();
+        containers_.emplace_hint(containers_.end(), page_no, std::move(container));
+    }
+    return src;
+}
+
+/**
+ * @description: 在序列化的位图中找页面号为page_no的容器
+ * @return {char*} 容器(含页面号)的位置，没有时为应插入的位置；*end为序列化的位图的末尾
+ */
+char *IxBitmap::find_serialized(char *buf, int page_no, bool *found, char **end) {
+    int num;
+    memcpy(&num, buf, sizeof(int));
+    char *src = buf + sizeof(int);
+    char *pos = nullptr;
+    *found = false;
+    for (int i = 0; i < num; i++) {
+        int container_page_no;
+        memcpy(&container_page_no, src, sizeof(int));
+        if (pos == nullptr && container_page_no >= page_no) {
+            pos = src;
+            *found = container_page_no == page_no;
+        }
+        src += sizeof(int) + IxBitmapContainer::serialized_size(src + sizeof(int));
+    }
+    *end = src;
+    return pos == nullptr ? src : pos;
+}
+
+int IxBitmap::add_serialized(char *buf, size_t capacity, const Rid &rid) {
+    bool found;
+    char *end;
+    char *pos = find_serialized(buf, rid.page_no, &found, &end);
+    IxBitmapContainer container;
+    size_t old_len = 0;
+    if (found) {
+        container.deserialize(pos + sizeof(int));
+        old_len = sizeof(int) + IxBitmapContainer::serialized_size(pos + sizeof(int));
+    }
+    if (!container.add(rid.slot_no)) {
+        return 0;
+    }
+    size_t new_len = sizeof(int) + container.serialized_size();
+    if (static_cast<size_t>(end - buf) - old_len + new_len > capacity) {
+        return -1;
+    }
+    memmove(pos + new_len, pos + old_len, end - pos - old_len);
+    memcpy(pos, &rid.page_no, sizeof(int));
+    container.serialize(pos + sizeof(int));
+    if (!found) {
+        int num;
+        memcpy(&num, buf, sizeof(int));
+        num++;
+        memcpy(buf, &num, sizeof(int));
+    }
+    return 1;
+}
+
+bool IxBitmap::remove_serialized(char *buf, const Rid &rid) {
+    bool found;
+    char *end;
+    char *pos = find_serialized(buf, rid.page_no, &found, &end);
+    if (!found) {
+        return false;
+    }
+    IxBitmapContainer container;
+    container.deserialize(pos + sizeof(int));
+    if (!container.remove(rid.slot_no)) {
+        return false;
+    }
+    size_t old_len = sizeof(int) + IxBitmapContainer::serialized_size(pos + sizeof(int));
+    size_t new_len = container.empty() ? 0 : sizeof(int) + container.serialized_size();
+    memmove(pos + new_len, pos + old_len, end - pos - old_len);
+    if (container.empty()) {
+        int num;
+        memcpy(&num, buf, sizeof(int));
+        num--;
+        memcpy(buf, &num, sizeof(int));
+    } else {
+        container.serialize(pos + sizeof(int));
+    }
+    return true;
+}
+
+bool IxBitmap::serialized_empty(const char *buf) {
+    int num;
+    memcpy(&num, buf, sizeof(int));
+    return num == 0;
+}
@@ -0,0 +1,139 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "defs.h"
+
+/**
+ * @description: 一个堆页面内的槽位集合，是位图索引中的一个容器
+ * 稀疏时是有序的槽位号数组，稠密时是按槽位号的位图，位图的长度只到容器内最大的槽位号。
+ * 与roaring bitmap一样按两种表示所占的字节数选择：数组比位图大时转为位图，
+ * 位图容器中的元素少于位图字节数的四分之一(数组只占位图的一半)时转回数组，两个阈值之间不来回转换
+ */
+class IxBitmapContainer {
+   private:
+    std::vector<uint16_t> array_;  // 数组容器：有序的槽位号
+    std::vector<uint64_t> words_;  // 位图容器：words_非空表示当前是位图容器
+    int card_ = 0;                 // 元素个数
+
+   public:
+    bool is_bitmap() const { return !words_.empty(); }
+
+    int cardinality() const { return card_; }
+
+    bool empty() const { return card_ == 0; }
+
+    bool contains(int slot) const;
+
+    bool add(int slot);
+
+    bool remove(int slot);
+
+    static IxBitmapContainer intersect(const IxBitmapContainer &a, const IxBitmapContainer &b);
+
+    static IxBitmapContainer unite(const IxBitmapContainer &a, const IxBitmapContainer &b);
+
+    // 按槽位号升序依次调用f(slot)
+    template <typename F>
+    void for_each(F f) const {
+        if (!is_bitmap()) {
+            for (uint16_t slot : array_) {
+                f(static_cast<int>(slot));
+            }
+            return;
+        }
+        for (size_t i = 0; i < words_.size(); i++) {
+            for (uint64_t word = words_[i]; word != 0; word &= word - 1) {
+                f(static_cast<int>(i * 64 + __builtin_ctzll(word)));
+            }
+        }
+    }
+
+    size_t serialized_size() const;
+
+    char *serialize(char *dest) const;
+
+    const char *deserialize(const char *src);
+
+    // 序列化的容器的字节数，不反序列化
+    static size_t serialized_size(const char *src);
+
+   private:
+    void to_bitmap(size_t num_words);
+
+    void to_array();
+
+    // 根据元素个数调整表示方式
+    void optimize();
+};
+
+/**
+ * @description: 压缩的rid集合，按rid的页面号分成容器，每个容器存放同一个堆页面中的槽位号
+ * 相当于把rid看作(页面号, 槽位号)两级的roaring bitmap：页面号对应高位的容器键，槽位号对应低16位。
+ * 容器按页面号有序，交集和并集逐个容器归并，取出的rid按(页面号, 槽位号)升序，按页面顺序访问堆文件。
+ * 不加锁，由使用者保证并发安全
+ */
+class IxBitmap {
+   private:
+    std::map<int, IxBitmapContainer> containers_;  // 页面号 -> 该页面中的槽位
+    size_t card_ = 0;
+
+   public:
+    bool contains(const Rid &rid) const;
+
+    bool add(const Rid &rid);
+
+    bool remove(const Rid &rid);
+
+    size_t cardinality() const { return card_; }
+
+    bool empty() const { return card_ == 0; }
+
+    int num_containers() const { return static_cast<int>(containers_.size()); }
+
+    // 就地求交集/并集
+    IxBitmap &operator&=(const IxBitmap &other);
+
+    IxBitmap &operator|=(const IxBitmap &other);
+
+    // 按(页面号, 槽位号)升序追加到rids末尾
+    void to_rids(std::vector<Rid> *rids) const;
+
+    // 最小的页面号，位图不能为空
+    int first_page_no() const { return containers_.begin()->first; }
+
+    // 把后一半容器移到返回的位图中，位图至少有两个容器
+    IxBitmap split_half();
+
+    /**
+     * @description: 在serialize()写出的位图上就地加入rid，只反序列化rid所在的容器
+     * @return {int} 1表示加入，0表示rid已存在，-1表示加入后超过capacity字节，此时buf不变
+     */
+    static int add_serialized(char *buf, size_t capacity, const Rid &rid);
+
+    // 在serialize()写出的位图上就地去掉rid，返回rid是否在位图中
+    static bool remove_serialized(char *buf, const Rid &rid);
+
+    static bool serialized_empty(const char *buf);
+
+    size_t serialized_size() const;
+
+    char *serialize(char *dest) const;
+
+    const char *deserialize(const char *src);
+
+   private:
+    static char *find_serialized(char *buf, int page_no, bool *found, char **end);
+};
@@ -0,0 +1,366 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "ix_bitmap_index_handle.h"
+
+#include <algorithm>
+#include <mutex>
+
+void IxBitmapFileHdr::serialize(char *dest) const {
+    int offset = 0;
+    auto put = [&](const void *src, size_t len) {
+        memcpy(dest + offset, src, len);
+        offset += len;
+    };
+    int tot = tot_len();
+    put(&tot, sizeof(int));
+    put(&num_pages_, sizeof(int));
+    put(&col_num_, sizeof(int));
+    for (int i = 0; i < col_num_; ++i) {
+        put(&col_types_[i], sizeof(ColType));
+    }
+    for (int i = 0; i < col_num_; ++i) {
+        put(&col_lens_[i], sizeof(int));
+    }
+    put(&col_tot_len_, sizeof(int));
+    put(&dir_len_, sizeof(int64_t));
+    int num_dir_pages = dir_pages_.size();
+    put(&num_dir_pages, sizeof(int));
+    put(dir_pages_.data(), sizeof(page_id_t) * num_dir_pages);
+    assert(offset == tot);
+}
+
+void IxBitmapFileHdr::deserialize(const char *src) {
+    int offset = 0;
+    auto get = [&](void *dest, size_t len) {
+        memcpy(dest, src + offset, len);
+        offset += len;
+    };
+    int tot;
+    get(&tot, sizeof(int));
+    get(&num_pages_, sizeof(int));
+    get(&col_num_, sizeof(int));
+    col_types_.resize(col_num_);
+    col_lens_.resize(col_num_);
+    for (int i = 0; i < col_num_; ++i) {
+        get(&col_types_[i], sizeof(ColType));
+    }
+    for (int i = 0; i < col_num_; ++i) {
+        get(&col_lens_[i], sizeof(int));
+    }
+    get(&col_tot_len_, sizeof(int));
+    get(&dir_len_, sizeof(int64_t));
+    int num_dir_pages;
+    get(&num_dir_pages, sizeof(int));
+    dir_pages_.resize(num_dir_pages);
+    get(dir_pages_.data(), sizeof(page_id_t) * num_dir_pages);
+    assert(offset == tot);
+}
+
+/**
+ * @description: 读入文件头，再从目录页面读入目录，段页面在访问时才通过缓冲池读入
+ */
+IxBitmapIndexHandle::IxBitmapIndexHandle(DiskManager *disk_manager,
+                                         BufferPoolManager *buffer_pool_manager, int fd)
+    : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), fd_(fd) {
+    char buf[PAGE_SIZE];
+    memset(buf, 0, PAGE_SIZE);
+    disk_manager_->read_page(fd, IX_FILE_HDR_PAGE, buf, PAGE_SIZE);
+    file_hdr_ = new IxBitmapFileHdr();
+    file_hdr_->deserialize(buf);
+
+    // 关闭索引时所有页面都已刷盘，从文件末尾开始分配新的page_no
+    int num_pages =
+        disk_manager_->get_file_size(disk_manager_->get_file_name(fd)) / PAGE_SIZE;
+    disk_manager_->set_fd2pageno(fd, std::max(num_pages, IX_BITMAP_INIT_NUM_PAGES));
+
+    std::vector<char> data(file_hdr_->dir_len_);
+    for (size_t i = 0; i < file_hdr_->dir_pages_.size(); i++) {
+        Page *page = buffer_pool_manager_->fetch_page({fd_, file_hdr_->dir_pages_[i]});
+        size_t offset = i * PAGE_SIZE;
+        memcpy(data.data() + offset, page->get_data(),
+               std::min<size_t>(PAGE_SIZE, data.size() - offset));
+        buffer_pool_manager_->unpin_page(page->get_page_id(), false);
+    }
+    deserialize_directory(data);
+}
+
+std::string IxBitmapIndexHandle::encode_key(const char *key) const {
+    std::string buf(file_hdr_->col_tot_len_, '\0');
+    ix_encode_key(key, buf.data(), file_hdr_->col_types_, file_hdr_->col_lens_);
+    return buf;
+}
+
+/**
+ * @description: 把rid加入key的位图中覆盖rid.page_no的段，通常就地修改段页面中的一个容器；
+ * 段超过一个页面时整段读出，把后一半容器分裂到新的段
+ */
+bool IxBitmapIndexHandle::insert_entry(const char *key, const Rid &value,
+                                       Transaction *transaction) {
+    std::string buf = encode_key(key);
+    std::unique_lock<std::shared_mutex> lock(latch_);
+    auto &segments = segments_[buf];
+    if (segments.empty()) {
+        segments.emplace(INT32_MIN, allocate_segment());
+        dirty_ = true;
+    }
+    auto seg = std::prev(segments.upper_bound(value.page_no));
+    Page *page = buffer_pool_manager_->fetch_page({fd_, seg->second});
+    int added = IxBitmap::add_serialized(page->get_data(), PAGE_SIZE, value);
+    buffer_pool_manager_->unpin_page(page->get_page_id(), added > 0);
+    if (added >= 0) {
+        return added > 0;
+    }
+    IxBitmap bitmap = read_segment(seg->second);
+    bitmap.add(value);
+    if (bitmap.num_containers() < 2) {
+        throw InternalError("IxBitmapIndexHandle::insert_entry: container exceeds a page");
+    }
+    IxBitmap upper = bitmap.split_half();
+    page_id_t page_no = allocate_segment();
+    write_segment(page_no, upper);
+    segments.emplace(upper.first_page_no(), page_no);
+    dirty_ = true;
+    write_segment(seg->second, bitmap);
+    return true;
+}
+
+/**
+ * @description: 从key的位图中去掉rid，段删空了就回收它的页面，键的所有段都删空了就删除这个键
+ * @return {bool} (key, rid)是否在索引中
+ */
+bool IxBitmapIndexHandle::delete_entry(const char *key, const Rid &value,
+                                       Transaction *transaction) {
+    std::string buf = encode_key(key);
+    std::unique_lock<std::shared_mutex> lock(latch_);
+    auto it = segments_.find(buf);
+    if (it == segments_.end()) {
+        return false;
+    }
+    auto &segments = it->second;
+    auto seg = std::prev(segments.upper_bound(value.page_no));
+    Page *page = buffer_pool_manager_->fetch_page({fd_, seg->second});
+    bool removed = IxBitmap::remove_serialized(page->get_data(), value);
+    bool empty = IxBitmap::serialized_empty(page->get_data());
+    buffer_pool_manager_->unpin_page(page->get_page_id(), removed);
+    if (!removed) {
+        return false;
+    }
+    if (!empty) {
+        return true;
+    }
+    free_pages_.push_back(seg->second);
+    bool first = seg == segments.begin();
+    seg = segments.erase(seg);
+    if (segments.empty()) {
+        segments_.erase(it);
+    } else if (first) {
+        // 第一段总是从INT32_MIN开始
+        page_id_t page_no = seg->second;
+        segments.erase(seg);
+        segments.emplace(INT32_MIN, page_no);
+    }
+    dirty_ = true;
+    return true;
+}
+
+/**
+ * @description: 返回key的位图的副本，key不存在时返回空集合
+ */
+IxBitmap IxBitmapIndexHandle::get_bitmap(const char *key) {
+    std::string buf = encode_key(key);
+    std::shared_lock<std::shared_mutex> lock(latch_);
+    IxBitmap result;
+    auto it = segments_.find(buf);
+    if (it != segments_.end()) {
+        read_segments(it->second, &result);
+    }
+    return result;
+}
+
+/**
+ * @description: 返回范围内所有键的位图的并集
+ * @param lower 范围的下界，nullptr表示没有下界
+ * @param upper 范围的上界，nullptr表示没有上界
+ */
+IxBitmap IxBitmapIndexHandle::get_range_bitmap(const char *lower, bool lower_inclusive,
+                                               const char *upper, bool upper_inclusive) {
+    std::string lower_buf = lower == nullptr ? std::string() : encode_key(lower);
+    std::string upper_buf = upper == nullptr ? std::string() : encode_key(upper);
+    std::shared_lock<std::shared_mutex> lock(latch_);
+    auto begin = lower == nullptr          ? segments_.begin()
+                 : lower_inclusive        ? segments_.lower_bound(lower_buf)
+                                          : segments_.upper_bound(lower_buf);
+    auto end = upper == nullptr            ? segments_.end()
+               : upper_inclusive          ? segments_.upper_bound(upper_buf)
+                                          : segments_.lower_bound(upper_buf);
+    IxBitmap result;
+    for (auto it = begin; it != segments_.end() && it != end; ++it) {
+        if (upper != nullptr && it->first > upper_buf) {
+            break;  // 下界大于上界
+        }
+        read_segments(it->second, &result);
+    }
+    return result;
+}
+
+size_t IxBitmapIndexHandle::num_keys() {
+    std::shared_lock<std::shared_mutex> lock(latch_);
+    return segments_.size();
+}
+
+size_t IxBitmapIndexHandle::num_segments() {
+    std::shared_lock<std::shared_mutex> lock(latch_);
+    size_t num = 0;
+    for (auto &entry : segments_) {
+        num += entry.second.size();
+    }
+    return num;
+}
+
+/**
+ * @description: 修改过的目录写回目录页面，再写回文件头，最后把所有脏页刷盘
+ */
+void IxBitmapIndexHandle::flush() {
+    std::unique_lock<std::shared_mutex> lock(latch_);
+    if (dirty_) {
+        std::vector<char> data = serialize_directory();
+        size_t num_dir_pages = (data.size() + PAGE_SIZE - 1) / PAGE_SIZE;
+        while (file_hdr_->dir_pages_.size() < num_dir_pages) {
+            PageId page_id = {.fd = fd_, .page_no = INVALID_PAGE_ID};
+            if (buffer_pool_manager_->new_page(&page_id) == nullptr) {
+                throw InternalError("IxBitmapIndexHandle::flush: no free pages available");
+            }
+            file_hdr_->num_pages_++;
+            file_hdr_->dir_pages_.push_back(page_id.page_no);
+            buffer_pool_manager_->unpin_page(page_id, false);
+        }
+        if (file_hdr_->tot_len() > PAGE_SIZE) {
+            throw InternalError("IxBitmapIndexHandle::flush: directory too large");
+        }
+        for (size_t i = 0; i < num_dir_pages; i++) {
+            Page *page = buffer_pool_manager_->fetch_page({fd_, file_hdr_->dir_pages_[i]});
+            size_t offset = i * PAGE_SIZE;
+            memset(page->get_data(), 0, PAGE_SIZE);
+            memcpy(page->get_data(), data.data() + offset,
+                   std::min<size_t>(PAGE_SIZE, data.size() - offset));
+            buffer_pool_manager_->unpin_page(page->get_page_id(), true);
+        }
+        file_hdr_->dir_len_ = data.size();
+
+        char page_buf[PAGE_SIZE];
+        memset(page_buf, 0, PAGE_SIZE);
+        file_hdr_->serialize(page_buf);
+        disk_manager_->write_page(fd_, IX_FILE_HDR_PAGE, page_buf, PAGE_SIZE);
+        dirty_ = false;
+    }
+    buffer_pool_manager_->flush_all_pages(fd_);
+}
+
+void IxBitmapIndexHandle::read_segments(const std::map<int, page_id_t> &segments,
+                                        IxBitmap *result) {
+    for (auto &entry : segments) {
+        *result |= read_segment(entry.second);
+    }
+}
+
+IxBitmap IxBitmapIndexHandle::read_segment(page_id_t page_no) {
+    Page *page = buffer_pool_manager_->fetch_page({fd_, page_no});
+    IxBitmap bitmap;
+    bitmap.deserialize(page->get_data());
+    buffer_pool_manager_->unpin_page(page->get_page_id(), false);
+    return bitmap;
+}
+
+void IxBitmapIndexHandle::write_segment(page_id_t page_no, const IxBitmap &bitmap) {
+    assert(bitmap.serialized_size() <= PAGE_SIZE);
+    Page *page = buffer_pool_manager_->fetch_page({fd_, page_no});
+    bitmap.serialize(page->get_data());
+    buffer_pool_manager_->unpin_page(page->get_page_id(), true);
+}
+
+/**
+ * @description: 分配一个存放空位图的段页面，先重用删空的段页面，调用者独占持有latch_
+ */
+page_id_t IxBitmapIndexHandle::allocate_segment() {
+    page_id_t page_no;
+    if (!free_pages_.empty()) {
+        page_no = free_pages_.back();
+        free_pages_.pop_back();
+    } else {
+        PageId page_id = {.fd = fd_, .page_no = INVALID_PAGE_ID};
+        if (buffer_pool_manager_->new_page(&page_id) == nullptr) {
+            throw InternalError("IxBitmapIndexHandle::allocate_segment: no free pages available");
+        }
+        buffer_pool_manager_->unpin_page(page_id, false);
+        file_hdr_->num_pages_++;
+        page_no = page_id.page_no;
+    }
+    write_segment(page_no, IxBitmap());
+    return page_no;
+}
+
+/**
+ * @description: 目录的格式为|键的个数(int)|规范化的键|段数(int)|(起始堆页面号, 页面号)...|...|
+ * 空闲页面数(int)|空闲页面...|
+ */
+std::vector<char> IxBitmapIndexHandle::serialize_directory() const {
+    std::vector<char> data;
+    auto put = [&](const void *src, size_t len) {
+        data.insert(data.end(), static_cast<const char *>(src), static_cast<const char *>(src) + len);
+    };
+    int num_keys = segments_.size();
+    put(&num_keys, sizeof(int));
+    for (auto &[key, segments] : segments_) {
+        put(key.data(), key.size());
+        int num = segments.size();
+        put(&num, sizeof(int));
+        for (auto &[first_page_no, page_no] : segments) {
+            put(&first_page_no, sizeof(int));
+            put(&page_no, sizeof(page_id_t));
+        }
+    }
+    int num_free = free_pages_.size();
+    put(&num_free, sizeof(int));
+    put(free_pages_.data(), sizeof(page_id_t) * num_free);
+    return data;
+}
+
+void IxBitmapIndexHandle::deserialize_directory(const std::vector<char> &data) {
+    if (data.empty()) {
+        return;
+    }
+    const char *src = data.data();
+    auto get = [&](void *dest, size_t len) {
+        memcpy(dest, src, len);
+        src += len;
+    };
+    int num_keys;
+    get(&num_keys, sizeof(int));
+    for (int i = 0; i < num_keys; i++) {
+        std::string key(src, file_hdr_->col_tot_len_);
+        src += file_hdr_->col_tot_len_;
+        auto &segments = segments_[key];
+        int num;
+        get(&num, sizeof(int));
+        for (int j = 0; j < num; j++) {
+            int first_page_no;
+            page_id_t page_no;
+            get(&first_page_no, sizeof(int));
+            get(&page_no, sizeof(page_id_t));
+            segments.emplace_hint(segments.end(), first_page_no, page_no);
+        }
+    }
+    int num_free;
+    get(&num_free, sizeof(int));
+    free_pages_.resize(num_free);
+    get(free_pages_.data(), sizeof(page_id_t) * num_free);
+    assert(src == data.data() + data.size());
+}
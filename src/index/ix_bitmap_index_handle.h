@@ -0,0 +1,110 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <map>
+#include <shared_mutex>
+#include <string>
+
+#include "ix_bitmap.h"
+#include "ix_defs.h"
+#include "ix_key_search.h"
+#include "transaction/transaction.h"
+
+constexpr int IX_BITMAP_INIT_NUM_PAGES = 1;  // 新建的索引只有第0页的文件头
+
+/* 位图索引的文件头，存放在第0页，打开索引时读入内存，关闭索引时写回 */
+class IxBitmapFileHdr {
+   public:
+    int num_pages_;                   // 磁盘文件中页面的数量
+    int col_num_;                     // 索引包含的字段数量
+    std::vector<ColType> col_types_;  // 字段的类型
+    std::vector<int> col_lens_;       // 字段的长度
+    int col_tot_len_;                 // 索引包含的字段的总长度
+    int64_t dir_len_;                 // 目录的字节数
+    std::vector<page_id_t> dir_pages_;  // 依次存放目录的页面
+
+    IxBitmapFileHdr() : num_pages_(0), col_num_(0), col_tot_len_(0), dir_len_(0) {}
+
+    int tot_len() const {
+        return sizeof(int) * 5 + sizeof(int64_t) + (sizeof(ColType) + sizeof(int)) * col_num_ +
+               sizeof(page_id_t) * dir_pages_.size();
+    }
+
+    void serialize(char *dest) const;
+
+    void deserialize(const char *src);
+};
+
+/**
+ * @description: 位图索引，适合取值种类很少的字段，每个不同的键对应一个压缩的rid集合(IxBitmap)
+ * 键可以重复，同一个键的所有记录都在它的位图中。键按ix_encode_key()规范化后有序存放，
+ * 范围条件取范围内所有键的位图的并集，多个条件的结果再求交集，最后按页面顺序访问堆文件。
+ * 一个键的位图按堆页面号切成若干段，每段序列化后存放在一个通过缓冲池读写的页面中，段满了就对半分裂，
+ * 删空了就回收页面；内存中只有目录(键 -> 各段的起始堆页面号和页面号)，关闭索引时写回目录页面。
+ * 并发控制：latch_保护目录和段页面的内容，查找共享加锁并复制出结果位图，插入删除独占加锁
+ */
+class IxBitmapIndexHandle {
+    friend class IxManager;
+
+   private:
+    DiskManager *disk_manager_;
+    BufferPoolManager *buffer_pool_manager_;
+    int fd_;
+    IxBitmapFileHdr *file_hdr_;
+    std::shared_mutex latch_;
+    // 规范化的键 -> (段覆盖的最小堆页面号 -> 段所在的页面)，每个键的第一段从堆页面号0开始，没有空键
+    std::map<std::string, std::map<int, page_id_t>> segments_;
+    std::vector<page_id_t> free_pages_;  // 删空的段页面，分配新段时先重用
+    bool dirty_ = false;                 // 目录是否在打开后被修改过
+
+   public:
+    IxBitmapIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, int fd);
+
+    ~IxBitmapIndexHandle() { delete file_hdr_; }
+
+    // 以下公有接口中的key都是调用者的原始键
+    /**
+     * @description: 把rid加入key的位图
+     * @return {bool} (key, rid)原来不在索引中
+     */
+    bool insert_entry(const char *key, const Rid &value, Transaction *transaction);
+
+    bool delete_entry(const char *key, const Rid &value, Transaction *transaction);
+
+    IxBitmap get_bitmap(const char *key);
+
+    IxBitmap get_range_bitmap(const char *lower, bool lower_inclusive, const char *upper,
+                              bool upper_inclusive);
+
+    size_t num_keys();
+
+    size_t num_segments();
+
+    void flush();
+
+    const IxBitmapFileHdr *get_file_hdr() const { return file_hdr_; }
+
+   private:
+    std::string encode_key(const char *key) const;
+
+    void read_segments(const std::map<int, page_id_t> &segments, IxBitmap *result);
+
+    IxBitmap read_segment(page_id_t page_no);
+
+    void write_segment(page_id_t page_no, const IxBitmap &bitmap);
+
+    page_id_t allocate_segment();
+
+    std::vector<char> serialize_directory() const;
+
+    void deserialize_directory(const std::vector<char> &data);
+};
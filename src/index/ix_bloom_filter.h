@@ -0,0 +1,125 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+constexpr int IX_BLOOM_BLOCK_SIZE = 64;  // 一个块正好占一个缓存行
+constexpr int IX_BLOOM_BLOCK_WORDS = IX_BLOOM_BLOCK_SIZE / sizeof(uint64_t);
+constexpr size_t IX_BLOOM_MIN_KEYS = 1024;  // 建过滤器时至少按这么多键分配空间
+constexpr int IX_BLOOM_GROWTH = 2;          // 为建索引之后插入的键预留的倍数
+
+struct alignas(IX_BLOOM_BLOCK_SIZE) IxBloomBlock {
+    uint64_t words[IX_BLOOM_BLOCK_WORDS];
+};
+
+/**
+ * @description: 分块布隆过滤器(split block bloom filter)
+ * 每个键只落在一个64字节的块中，在块的8个64位字中各置1位，查找只访问一个缓存行，
+ * 8个字的位掩码用SSE2一次比较。过滤器不支持删除，删除的键只会造成误判，不会漏判。
+ * 并发：置位用原子或，查找不加锁，最坏情况下把正在插入的键判为不存在，相当于查找排在插入之前
+ */
+class IxBloomFilter {
+   private:
+    std::vector<IxBloomBlock> blocks_;
+
+   public:
+    explicit IxBloomFilter(int num_blocks) : blocks_(std::max(num_blocks, 1)) {
+        std::fill(reinterpret_cast<char *>(blocks_.data()),
+                  reinterpret_cast<char *>(blocks_.data() + blocks_.size()), 0);
+    }
+
+    // 为num_keys个键、每个键bits_per_key位分配的块数
+    static int num_blocks_for(size_t num_keys, int bits_per_key) {
+        size_t bits = std::max(num_keys, IX_BLOOM_MIN_KEYS) * IX_BLOOM_GROWTH * bits_per_key;
+        return static_cast<int>((bits + IX_BLOOM_BLOCK_SIZE * 8 - 1) / (IX_BLOOM_BLOCK_SIZE * 8));
+    }
+
+    // 键的64位哈希值，与哈希索引一样先做FNV-1a再混合
+    static uint64_t hash(const char *key, int len) {
+        uint64_t h = 14695981039346656037ull;
+        for (int i = 0; i < len; i++) {
+            h ^= static_cast<unsigned char>(key[i]);
+            h *= 1099511628211ull;
+        }
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    void insert(uint64_t hash) {
+        IxBloomBlock &block = blocks_[block_index(hash)];
+        alignas(16) uint64_t mask[IX_BLOOM_BLOCK_WORDS];
+        make_mask(static_cast<uint32_t>(hash), mask);
+        for (int i = 0; i < IX_BLOOM_BLOCK_WORDS; i++) {
+            __atomic_fetch_or(&block.words[i], mask[i], __ATOMIC_RELAXED);
+        }
+    }
+
+    bool may_contain(uint64_t hash) const {
+        const IxBloomBlock &block = blocks_[block_index(hash)];
+        alignas(16) uint64_t mask[IX_BLOOM_BLOCK_WORDS];
+        make_mask(static_cast<uint32_t>(hash), mask);
+#ifdef __SSE2__
+        // 掩码中有而块中没有的位
+        __m128i missing = _mm_setzero_si128();
+        for (int i = 0; i < IX_BLOOM_BLOCK_WORDS / 2; i++) {
+            __m128i bv = _mm_load_si128(reinterpret_cast<const __m128i *>(block.words) + i);
+            __m128i mv = _mm_load_si128(reinterpret_cast<const __m128i *>(mask) + i);
+            missing = _mm_or_si128(missing, _mm_andnot_si128(bv, mv));
+        }
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(missing, _mm_setzero_si128())) == 0xffff;
+#else
+        for (int i = 0; i < IX_BLOOM_BLOCK_WORDS; i++) {
+            if ((__atomic_load_n(&block.words[i], __ATOMIC_RELAXED) & mask[i]) != mask[i]) {
+                return false;
+            }
+        }
+        return true;
+#endif
+    }
+
+    int num_blocks() const { return static_cast<int>(blocks_.size()); }
+
+    // 每个键bits_per_key位时过滤器能容纳的键数，超过后误判率高于预期
+    size_t capacity(int bits_per_key) const { return size_bytes() * 8 / bits_per_key; }
+
+    size_t size_bytes() const { return blocks_.size() * sizeof(IxBloomBlock); }
+
+    char *data() { return reinterpret_cast<char *>(blocks_.data()); }
+
+    const char *data() const { return reinterpret_cast<const char *>(blocks_.data()); }
+
+   private:
+    // 用哈希值的高32位选块
+    size_t block_index(uint64_t hash) const {
+        return static_cast<size_t>(((hash >> 32) * blocks_.size()) >> 32);
+    }
+
+    // 用哈希值的低32位乘以8个不同的奇数，各取高6位作为每个字中置1的位
+    static void make_mask(uint32_t hash, uint64_t *mask) {
+        static constexpr uint32_t SALT[IX_BLOOM_BLOCK_WORDS] = {
+            0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+            0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u};
+        for (int i = 0; i < IX_BLOOM_BLOCK_WORDS; i++) {
+            mask[i] = 1ull << ((hash * SALT[i]) >> 26);
+        }
+    }
+};
@@ -0,0 +1,202 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "ix_change_buffer.h"
+
+#include <algorithm>
+
+#include "ix_index_handle.h"
+#include "ix_key_search.h"
+
+std::string IxChangeBuffer::encode(const char *key) const {
+    std::string buf(key_len_, '\0');
+    ix_encode_key(key, buf.data(), col_types_, col_lens_);
+    return buf;
+}
+
+/**
+ * @description: 找到key上缓存的修改；没有时，叶结点不在缓冲池中且缓冲没满才新建一项
+ * @return 找不到也不新建时返回changes_.end()，调用者直接修改B+树
+ */
+std::map<std::string, IxBufferedChange>::iterator IxChangeBuffer::find_or_add(
+    const char *key, bool leaf_resident) {
+    std::string buf = encode(key);
+    auto it = changes_.lower_bound(buf);
+    if (it != changes_.end() && it->first == buf) {
+        return it;
+    }
+    if (leaf_resident || changes_.size() >= IX_CHANGE_BUFFER_CAPACITY) {
+        return changes_.end();
+    }
+    it = changes_.emplace_hint(it, std::move(buf), IxBufferedChange());
+    it->second.key.assign(key, key_len_);
+    size_++;
+    return it;
+}
+
+/**
+ * @description: 缓存一次插入。key上已经有缓存的修改时必须继续缓存，保证同一个键上的修改按顺序合并
+ * @param leaf_resident key所在的叶结点是否在缓冲池中，在的话直接修改B+树更便宜
+ * @return {bool} 是否已缓存，false表示调用者应直接插入B+树
+ */
+bool IxChangeBuffer::add_insert(const char *key, const Rid &rid, bool leaf_resident) {
+    std::lock_guard<std::mutex> guard(latch_);
+    auto it = find_or_add(key, leaf_resident);
+    if (it == changes_.end()) {
+        return false;
+    }
+    if (!it->second.insert) {
+        it->second.insert = true;
+        it->second.rid = rid;
+        it->second.key.assign(key, key_len_ + payload_len_);
+    }
+    buffered_++;
+    return true;
+}
+
+/**
+ * @description: 缓存一次删除，之前缓存的插入随之作废
+ * @return {bool} 是否已缓存，false表示调用者应直接从B+树删除
+ */
+bool IxChangeBuffer::add_delete(const char *key, bool leaf_resident) {
+    std::lock_guard<std::mutex> guard(latch_);
+    auto it = find_or_add(key, leaf_resident);
+    if (it == changes_.end()) {
+        return false;
+    }
+    it->second.delete_first = true;
+    it->second.insert = false;
+    buffered_++;
+    return true;
+}
+
+/**
+ * @description: 规范化后在[lower, upper]中的修改，lower和upper为nullptr表示该方向没有界
+ */
+std::pair<std::map<std::string, IxBufferedChange>::iterator,
+          std::map<std::string, IxBufferedChange>::iterator>
+IxChangeBuffer::range(const char *lower, const char *upper) {
+    auto begin = lower == nullptr ? changes_.begin() : changes_.lower_bound(encode(lower));
+    auto end = upper == nullptr ? changes_.end() : changes_.upper_bound(encode(upper));
+    if (begin != changes_.end() && end != changes_.end() && end->first < begin->first) {
+        end = begin;  // 下界大于上界
+    }
+    return {begin, end};
+}
+
+bool IxChangeBuffer::has_range(const char *lower, const char *upper) {
+    if (empty()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(latch_);
+    auto [begin, end] = range(lower, upper);
+    return begin != end;
+}
+
+/**
+ * @description: 取出[lower, upper]中的全部修改，按键序追加到changes
+ */
+void IxChangeBuffer::take_range(const char *lower, const char *upper,
+                                std::vector<IxBufferedChange> *changes) {
+    std::lock_guard<std::mutex> guard(latch_);
+    auto [begin, end] = range(lower, upper);
+    for (auto it = begin; it != end; ++it) {
+        changes->push_back(std::move(it->second));
+    }
+    size_t num = changes_.size();
+    changes_.erase(begin, end);
+    size_ -= num - changes_.size();
+    merged_ += num - changes_.size();
+}
+
+/**
+ * @description: 从上一批的末尾起按键序取出至多max_keys个修改，到末尾后从头开始，
+ * 多次调用依次扫过整个键空间
+ */
+void IxChangeBuffer::take_batch(size_t max_keys, std::vector<IxBufferedChange> *changes) {
+    std::lock_guard<std::mutex> guard(latch_);
+    auto it = changes_.lower_bound(cursor_);
+    if (it == changes_.end()) {
+        it = changes_.begin();
+    }
+    for (size_t i = 0; i < max_keys && it != changes_.end(); i++) {
+        changes->push_back(std::move(it->second));
+        it = changes_.erase(it);
+        size_--;
+        merged_++;
+    }
+    cursor_ = it == changes_.end() ? std::string() : it->first;
+}
+
+IxChangeBufferMerger &IxChangeBufferMerger::instance() {
+    static IxChangeBufferMerger merger;
+    return merger;
+}
+
+IxChangeBufferMerger::~IxChangeBufferMerger() {
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void IxChangeBufferMerger::add(IxIndexHandle *ih) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    handles_.push_back(ih);
+    if (!thread_.joinable()) {
+        thread_ = std::thread(&IxChangeBufferMerger::run, this);
+    }
+}
+
+void IxChangeBufferMerger::remove(IxIndexHandle *ih) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [&] { return merging_ != ih; });
+    handles_.erase(std::remove(handles_.begin(), handles_.end(), ih), handles_.end());
+}
+
+void IxChangeBufferMerger::notify() {
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        pending_ = true;
+    }
+    work_cv_.notify_one();
+}
+
+/**
+ * @description: 合并时不持有mutex_，只用merging_标记正在合并的索引，注销这个索引的线程等它合并完这一批
+ */
+void IxChangeBufferMerger::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        work_cv_.wait(lock, [&] { return pending_ || stop_; });
+        if (stop_) {
+            break;
+        }
+        pending_ = false;
+        bool more = true;
+        while (more && !stop_) {
+            more = false;
+            // 注销会修改handles_，按下标遍历并在每次重新加锁后检查边界
+            for (size_t i = 0; i < handles_.size() && !stop_; i++) {
+                merging_ = handles_[i];
+                lock.unlock();
+                bool half_full = merging_->merge_change_buffer_batch();
+                lock.lock();
+                merging_ = nullptr;
+                idle_cv_.notify_all();
+                more = more || half_full;
+            }
+        }
+    }
+}
@@ -0,0 +1,127 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ix_defs.h"
+
+constexpr size_t IX_CHANGE_BUFFER_CAPACITY = 8192;    // 每个索引最多缓存的键数，满了之后直接修改B+树
+constexpr size_t IX_CHANGE_BUFFER_MERGE_BATCH = 512;  // 后台合并一次取出的键数
+
+/**
+ * @description: 一个键上缓存的修改。B+树中的键不重复：插入已有的键什么也不做，删除不存在的键也什么也不做，
+ * 所以同一个键上任意一串插入和删除，都等价于"先删除(可选)，再插入最后一次删除之后的第一个rid(可选)"
+ */
+struct IxBufferedChange {
+    std::string key;             // 调用者的原始键，insert时后面紧跟要插入的payload
+    bool delete_first = false;   // 是否先删除这个键
+    bool insert = false;         // 是否再插入(key, rid)
+    Rid rid{};
+};
+
+/**
+ * @description: B+树的修改缓冲(change buffer)，只在内存中
+ * 目标叶结点不在缓冲池中时，插入和删除先记在这里，不为它们随机读入叶结点；
+ * 读这些键之前(IxIndexHandle::merge_range)、缓冲过半后由后台合并线程按键的顺序分批、关闭索引时再合并到B+树中。
+ * 键按ix_encode_key()规范化后有序存放，范围合并和按顺序合并都直接在std::map上进行，
+ * 按键序合并时相邻的键多半落在同一个叶结点，一个叶结点只读一次。
+ * latch_只保护内部的数据结构，修改与合并的先后顺序由IxIndexHandle::merge_latch_保证
+ */
+class IxChangeBuffer {
+    std::vector<ColType> col_types_;
+    std::vector<int> col_lens_;
+    int key_len_;
+    int payload_len_;  // INCLUDE字段的长度，只随插入缓存，不参与排序
+    std::mutex latch_;
+    std::map<std::string, IxBufferedChange> changes_;  // 规范化的键 -> 该键上缓存的修改
+    std::string cursor_;                               // 后台合并下一批的起点(规范化的键)
+    std::atomic<size_t> size_{0};
+    std::atomic<uint64_t> buffered_{0};  // 累计缓存的修改次数
+    std::atomic<uint64_t> merged_{0};    // 累计合并到B+树的键数
+
+   public:
+    IxChangeBuffer(std::vector<ColType> col_types, std::vector<int> col_lens, int key_len,
+                   int payload_len = 0)
+        : col_types_(std::move(col_types)),
+          col_lens_(std::move(col_lens)),
+          key_len_(key_len),
+          payload_len_(payload_len) {}
+
+    bool add_insert(const char *key, const Rid &rid, bool leaf_resident);
+
+    bool add_delete(const char *key, bool leaf_resident);
+
+    bool has_range(const char *lower, const char *upper);
+
+    void take_range(const char *lower, const char *upper, std::vector<IxBufferedChange> *changes);
+
+    void take_batch(size_t max_keys, std::vector<IxBufferedChange> *changes);
+
+    size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+    uint64_t buffered() const { return buffered_; }
+
+    uint64_t merged() const { return merged_; }
+
+   private:
+    std::string encode(const char *key) const;
+
+    std::map<std::string, IxBufferedChange>::iterator find_or_add(const char *key,
+                                                                  bool leaf_resident);
+
+    std::pair<std::map<std::string, IxBufferedChange>::iterator,
+              std::map<std::string, IxBufferedChange>::iterator>
+    range(const char *lower, const char *upper);
+};
+
+class IxIndexHandle;
+
+/**
+ * @description: 所有启用了修改缓冲的索引共用的后台合并线程，第一个索引注册时启动
+ * 线程平时睡眠，某个索引的缓冲过半或布隆过滤器满了时被唤醒，先重建满了的过滤器，
+ * 再轮流从缓冲仍然过半的索引各合并一批，直到所有缓冲都不到一半
+ */
+class IxChangeBufferMerger {
+    std::mutex mutex_;  // 保护以下所有成员
+    std::condition_variable work_cv_;  // 有缓冲过半或需要退出时通知合并线程
+    std::condition_variable idle_cv_;  // 合并完一批时通知等待注销的线程
+    std::vector<IxIndexHandle *> handles_;
+    IxIndexHandle *merging_ = nullptr;  // 合并线程正在合并的索引
+    bool pending_ = false;
+    bool stop_ = false;
+    std::thread thread_;
+
+   public:
+    static IxChangeBufferMerger &instance();
+
+    ~IxChangeBufferMerger();
+
+    void add(IxIndexHandle *ih);
+
+    // 返回后合并线程不再访问ih
+    void remove(IxIndexHandle *ih);
+
+    void notify();
+
+   private:
+    IxChangeBufferMerger() = default;
+
+    void run();
+};
@@ -0,0 +1,234 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "ix_clustered_table.h"
+
+#include "ix_scan.h"
+
+namespace {
+
+/**
+ * @description: 按主键顺序扫描聚簇表，每次从聚簇索引取出一个叶结点中的全部索引项，
+ * 跳过页面号不在[begin_page_no, end_page_no)中或被page_filter排除的叶结点
+ */
+class IxClusteredScan : public RecScan {
+    const IxClusteredTableHandle *table_;
+    IxScan scan_;
+    std::function<bool(int)> page_filter_;
+    int begin_page_no_;
+    int end_page_no_;
+    std::vector<Rid> rids_;      // 当前叶结点中各项的Rid(由行号映射而成)
+    std::vector<char> entries_;  // 与rids_一一对应的索引项
+    size_t pos_ = 0;
+    std::vector<char> record_;  // 由当前索引项恢复出的记录
+
+   public:
+    IxClusteredScan(const IxClusteredTableHandle *table, IxIndexHandle *ih, BufferPoolManager *bpm,
+                    std::function<bool(int)> page_filter, int begin_page_no, int end_page_no)
+        : table_(table),
+          scan_(ih, nullptr, nullptr, bpm, true),
+          page_filter_(std::move(page_filter)),
+          begin_page_no_(begin_page_no),
+          end_page_no_(end_page_no),
+          record_(table->record_size()) {
+        next_leaf();
+    }
+
+    void next() override {
+        pos_++;
+        if (pos_ < rids_.size()) {
+            load_record();
+        } else {
+            next_leaf();
+        }
+    }
+
+    bool is_end() const override { return pos_ >= rids_.size(); }
+
+    Rid rid() const override { return rids_[pos_]; }
+
+    const char *record() const override { return record_.data(); }
+
+   private:
+    void next_leaf() {
+        rids_.clear();
+        entries_.clear();
+        pos_ = 0;
+        while (rids_.empty() && !scan_.is_end()) {
+            int page_no = scan_.iid().page_no;
+            if (page_no >= begin_page_no_ && page_no < end_page_no_ &&
+                (page_filter_ == nullptr || page_filter_(page_no))) {
+                scan_.next_batch(&rids_, &entries_);
+            } else {
+                std::vector<Rid> skipped;
+                scan_.next_batch(&skipped);
+            }
+        }
+        if (!rids_.empty()) {
+            load_record();
+        }
+    }
+
+    void load_record() {
+        table_->entry_to_record(entries_.data() + pos_ * table_->record_size(), record_.data());
+    }
+};
+
+}  // namespace
+
+IxClusteredTableHandle::IxClusteredTableHandle(IxIndexHandle *ih, IxIndexHandle *row_ih,
+                                               BufferPoolManager *buffer_pool_manager, IndexMeta index)
+    : ih_(ih), row_ih_(row_ih), buffer_pool_manager_(buffer_pool_manager), index_(std::move(index)), key_len_(0) {
+    for (auto &col : index_.cols) {
+        key_len_ += col.len;
+    }
+    // 行号递增分配，反向扫描行号索引取最大的行号
+    IxScan scan(row_ih_, nullptr, nullptr, buffer_pool_manager_, false, true);
+    if (!scan.is_end()) {
+        next_row_ = rid_to_row(scan.rid()) + 1;
+    }
+}
+
+void IxClusteredTableHandle::entry_to_record(const char *entry, char *record) const {
+    int offset = 0;
+    for (auto *group : {&index_.cols, &index_.include_cols}) {
+        for (auto &col : *group) {
+            memcpy(record + col.offset, entry + offset, col.len);
+            offset += col.len;
+        }
+    }
+}
+
+/**
+ * @description: 两棵B+树的键都不重复，键之后是叶结点中的payload；扫描[key, key]取出整个索引项
+ */
+bool IxClusteredTableHandle::find_entry(IxIndexHandle *ih, const char *key, char *entry, Rid *rid) const {
+    IxScan scan(ih, key, key, buffer_pool_manager_, true);
+    std::vector<Rid> rids;
+    std::vector<char> entries;
+    while (rids.empty() && !scan.is_end()) {
+        scan.next_batch(&rids, &entries);
+    }
+    if (rids.empty()) {
+        return false;
+    }
+    memcpy(entry, entries.data(), entries.size() / rids.size());
+    if (rid != nullptr) {
+        *rid = rids[0];
+    }
+    return true;
+}
+
+bool IxClusteredTableHandle::find_key(const Rid &rid, char *key) const {
+    int row = rid_to_row(rid);
+    std::vector<char> entry(sizeof(int) + key_len_);
+    if (!find_entry(row_ih_, reinterpret_cast<const char *>(&row), entry.data())) {
+        return false;
+    }
+    memcpy(key, entry.data() + sizeof(int), key_len_);
+    return true;
+}
+
+std::unique_ptr<RmRecord> IxClusteredTableHandle::get_record_by_key(const char *key, Rid *rid) const {
+    std::vector<char> entry(index_.col_tot_len);
+    if (!find_entry(ih_, key, entry.data(), rid)) {
+        return nullptr;
+    }
+    auto record = std::make_unique<RmRecord>(record_size());
+    entry_to_record(entry.data(), record->data);
+    return record;
+}
+
+std::unique_ptr<RmRecord> IxClusteredTableHandle::get_record(const Rid &rid, Context *context) const {
+    std::vector<char> key(key_len_);
+    std::unique_ptr<RmRecord> record;
+    if (find_key(rid, key.data())) {
+        record = get_record_by_key(key.data());
+    }
+    if (record == nullptr) {
+        throw RecordNotFoundError(rid.page_no, rid.slot_no);
+    }
+    return record;
+}
+
+Rid IxClusteredTableHandle::insert_record(char *buf, Context *context) {
+    std::vector<char> entry(index_.col_tot_len);
+    index_.extract_key(buf, entry.data());
+    std::lock_guard<std::mutex> guard(write_latch_);
+    std::vector<char> existing(index_.col_tot_len);
+    if (find_entry(ih_, entry.data(), existing.data())) {
+        throw DuplicateKeyError(index_.tab_name);
+    }
+    int row = next_row_++;
+    Rid rid = row_to_rid(row);
+    std::vector<char> row_entry(sizeof(int) + key_len_);
+    memcpy(row_entry.data(), &row, sizeof(int));
+    memcpy(row_entry.data() + sizeof(int), entry.data(), key_len_);
+    ih_->insert_entry(entry.data(), rid, txn_of(context));
+    row_ih_->insert_entry(row_entry.data(), rid, txn_of(context));
+    return rid;
+}
+
+void IxClusteredTableHandle::delete_record(const Rid &rid, Context *context) {
+    std::lock_guard<std::mutex> guard(write_latch_);
+    std::vector<char> key(key_len_);
+    if (!find_key(rid, key.data())) {
+        throw RecordNotFoundError(rid.page_no, rid.slot_no);
+    }
+    int row = rid_to_row(rid);
+    ih_->delete_entry(key.data(), txn_of(context));
+    row_ih_->delete_entry(reinterpret_cast<const char *>(&row), txn_of(context));
+}
+
+/**
+ * @description: 更新即删除旧的索引项、插入新的索引项，payload中的其余字段随之更新；
+ * 主键改变时记录移到新主键的位置并修改行号索引中的主键，Rid不变
+ */
+Rid IxClusteredTableHandle::update_record(const Rid &rid, char *buf, Context *context) {
+    std::lock_guard<std::mutex> guard(write_latch_);
+    std::vector<char> key(key_len_);
+    std::vector<char> old_entry(index_.col_tot_len);
+    if (!find_key(rid, key.data()) || !find_entry(ih_, key.data(), old_entry.data())) {
+        throw RecordNotFoundError(rid.page_no, rid.slot_no);
+    }
+    std::vector<char> entry(index_.col_tot_len);
+    index_.extract_key(buf, entry.data());
+    bool key_changed = false;
+    int offset = 0;
+    for (auto &col : index_.cols) {
+        key_changed |= ix_compare(entry.data() + offset, old_entry.data() + offset, col.type, col.len) != 0;
+        offset += col.len;
+    }
+    if (key_changed) {
+        std::vector<char> existing(index_.col_tot_len);
+        if (find_entry(ih_, entry.data(), existing.data())) {
+            throw DuplicateKeyError(index_.tab_name);
+        }
+    }
+    if (old_entry != entry) {
+        ih_->delete_entry(old_entry.data(), txn_of(context));
+        ih_->insert_entry(entry.data(), rid, txn_of(context));
+    }
+    if (key_changed) {
+        int row = rid_to_row(rid);
+        std::vector<char> row_entry(sizeof(int) + key_len_);
+        memcpy(row_entry.data(), &row, sizeof(int));
+        memcpy(row_entry.data() + sizeof(int), entry.data(), key_len_);
+        row_ih_->delete_entry(row_entry.data(), txn_of(context));
+        row_ih_->insert_entry(row_entry.data(), rid, txn_of(context));
+    }
+    return rid;
+}
+
+std::unique_ptr<RecScan> IxClusteredTableHandle::scan(std::function<bool(int)> page_filter, int begin_page_no,
+                                                      int end_page_no) const {
+    return std::make_unique<IxClusteredScan>(this, ih_, buffer_pool_manager_, std::move(page_filter),
+                                             begin_page_no, end_page_no);
+}
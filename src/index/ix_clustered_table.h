@@ -0,0 +1,101 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ix_index_handle.h"
+#include "record/rm_table_handle.h"
+#include "system/sm_meta.h"
+
+constexpr int IX_CLUSTERED_ROWS_PER_PAGE = 4096;  // 行号映射为Rid时每个虚拟页面的行数，槽位号不超过16位
+
+/**
+ * @description: 聚簇表行号索引的键字段：记录的行号(INT)。字段名带'.'，不会与表中的字段重名，
+ * 行号索引的文件名由IxManager::get_index_name(表名, 这个字段)得到
+ */
+inline std::vector<ColMeta> ix_clustered_row_cols(const std::string &tab_name) {
+    return {ColMeta{.tab_name = tab_name, .name = "row.no", .type = TYPE_INT, .len = sizeof(int),
+                    .offset = 0, .index = false}};
+}
+
+/**
+ * @description: 聚簇表(按主键组织的表)，没有单独的堆文件，完整的记录就存放在聚簇索引的叶结点中。
+ * 聚簇索引是索引字段为主键、INCLUDE其余全部字段的B+树，按主键范围扫描直接顺序读取叶结点，
+ * 不需要再按Rid回表。主键的长度只受索引键长度的限制。
+ * 每条记录插入时分配一个递增、不重用的行号，与LSM表一样映射为Rid，存放在聚簇索引项的rid中；
+ * 行号索引(键为行号，payload为主键)由Rid找到主键。更新主键时记录移到新主键的位置，Rid不变，
+ * 位图索引按Rid给记录编号。二级B+树索引的INCLUDE字段中带有主键(见SmManager::create_index)，
+ * 按二级索引找到的记录直接按主键到聚簇索引中查找(get_record_by_key)，不经过行号索引。
+ * 扫描的页面号是聚簇索引叶结点的页面号
+ */
+class IxClusteredTableHandle : public RmTableHandle {
+    IxIndexHandle *ih_;
+    IxIndexHandle *row_ih_;  // 行号索引，行号 -> 主键
+    BufferPoolManager *buffer_pool_manager_;
+    IndexMeta index_;  // 聚簇索引，键为主键字段，其余字段是payload，索引项的长度等于记录长度
+    int key_len_;      // 主键的长度
+    // 串行化修改：检查主键是否已经存在和插入之间，不会有别的写者插入同一个主键；同时保护next_row_
+    std::mutex write_latch_;
+    int next_row_ = 0;  // 下一个行号，打开时取行号索引中最大的行号加1
+
+   public:
+    IxClusteredTableHandle(IxIndexHandle *ih, IxIndexHandle *row_ih, BufferPoolManager *buffer_pool_manager,
+                           IndexMeta index);
+
+    int record_size() const override { return index_.col_tot_len; }
+
+    int num_pages() const override { return ih_->num_pages(); }
+
+    std::unique_ptr<RmRecord> get_record(const Rid &rid, Context *context) const override;
+
+    // 记录整条存放在索引项中，fields不减少读取的数据量
+    std::unique_ptr<RmRecord> get_record(const Rid &rid, const std::vector<int> &fields,
+                                         Context *context) const override {
+        return get_record(rid, context);
+    }
+
+    // 主键已经存在时抛出DuplicateKeyError
+    Rid insert_record(char *buf, Context *context) override;
+
+    void delete_record(const Rid &rid, Context *context) override;
+
+    Rid update_record(const Rid &rid, char *buf, Context *context) override;
+
+    std::unique_ptr<RecScan> scan(std::function<bool(int)> page_filter = nullptr,
+                                  int begin_page_no = RM_FIRST_RECORD_PAGE,
+                                  int end_page_no = INT32_MAX) const override;
+
+    // 按主键查找记录，key为主键字段依次存放的字节；主键不存在时返回nullptr，rid不为空时同时返回记录的Rid
+    std::unique_ptr<RmRecord> get_record_by_key(const char *key, Rid *rid = nullptr) const;
+
+    // 由聚簇索引的索引项恢复出记录
+    void entry_to_record(const char *entry, char *record) const;
+
+    static Rid row_to_rid(int row) {
+        return Rid{RM_FIRST_RECORD_PAGE + row / IX_CLUSTERED_ROWS_PER_PAGE, row % IX_CLUSTERED_ROWS_PER_PAGE};
+    }
+
+    static int rid_to_row(const Rid &rid) {
+        return (rid.page_no - RM_FIRST_RECORD_PAGE) * IX_CLUSTERED_ROWS_PER_PAGE + rid.slot_no;
+    }
+
+   private:
+    // 在B+树ih中查找键为key的索引项，找到时把整个索引项拷贝到entry，rid不为空时同时返回它的rid
+    bool find_entry(IxIndexHandle *ih, const char *key, char *entry, Rid *rid = nullptr) const;
+
+    // 由Rid经行号索引找到主键，拷贝到key
+    bool find_key(const Rid &rid, char *key) const;
+
+    static Transaction *txn_of(Context *context) { return context == nullptr ? nullptr : context->txn_; }
+};
@@ -10,6 +10,9 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <climits>
+#include <cstring>
+#include <limits>
 #include <vector>
 
 #include "defs.h"
@@ -21,16 +24,51 @@ constexpr int IX_LEAF_HEADER_PAGE = 1;
 constexpr int IX_INIT_ROOT_PAGE = 2;
 constexpr int IX_INIT_NUM_PAGES = 3;
 constexpr int IX_MAX_COL_LEN = 512;
+constexpr double IX_BULK_LOAD_FILL_FACTOR = 0.9;        // 批量建索引时结点的填充因子
+constexpr size_t IX_SORT_MEMORY_SIZE = 64 * 1024 * 1024;  // 建索引外部排序的内存预算(字节)
+constexpr int IX_PIN_MAX_LEVELS = 3;    // 最多常驻在缓冲池中的B+树上层(从根结点起)层数
+constexpr size_t IX_PIN_MAX_PAGES = 256;  // 每个索引最多常驻的页面数，超过时少驻留几层
+constexpr int IX_PACKED_MAX_KEY_LEN = 256;  // 不超过该长度的字节序键(字符串键、联合索引键)采用前缀压缩的变长结点
+
+// 把dest处的一个字段设为该类型的最小值，用于构造只限定前面若干字段的键范围的下界
+inline void ix_set_min(char *dest, ColType type, int len) {
+    if (type == TYPE_INT) {
+        *(int *)dest = INT_MIN;
+    } else if (type == TYPE_FLOAT) {
+        *(float *)dest = -std::numeric_limits<float>::infinity();
+    } else {
+        memset(dest, 0, len);
+    }
+}
+
+// 把dest处的一个字段设为该类型的最大值，用于构造键范围的上界
+inline void ix_set_max(char *dest, ColType type, int len) {
+    if (type == TYPE_INT) {
+        *(int *)dest = INT_MAX;
+    } else if (type == TYPE_FLOAT) {
+        *(float *)dest = std::numeric_limits<float>::infinity();
+    } else {
+        memset(dest, 0xff, len);
+    }
+}
+
+/* 结点内查找键的方式，打开索引时根据键的类型确定一次，不写入文件 */
+enum IxKeyKind {
+    IX_KEY_INT,     // 单个INT字段，分支无关二分 + SIMD线性查找
+    IX_KEY_FLOAT,   // 单个FLOAT字段，分支无关二分 + SIMD线性查找
+    IX_KEY_STRING,  // 单个字符串字段，直接memcmp
+    IX_KEY_MULTI    // 多字段联合索引，键以规范化的字节序形式存储(ix_encode_key)，直接memcmp
+};
 
 class IxFileHdr {
    public:
     page_id_t first_free_page_no_;    // 文件中第一个空闲的磁盘页面的页面号
     int num_pages_;                   // 磁盘文件中页面的数量
     page_id_t root_page_;             // B+树根节点对应的页面号
-    int col_num_;                     // 索引包含的字段数量
+    int col_num_;                     // 索引键包含的字段数量(不含INCLUDE字段)
     std::vector<ColType> col_types_;  // 字段的类型
     std::vector<int> col_lens_;       // 字段的长度
-    int col_tot_len_;                 // 索引包含的字段的总长度
+    int col_tot_len_;                 // 索引键的总长度
     int btree_order_;  // # children per page 每个结点最多可插入的键值对数量
     int keys_size_;    // keys_size = (btree_order + 1) * col_tot_len
     // first_leaf初始化之后没有进行修改，只不过是在测试文件中遍历叶子结点的时候用了
@@ -38,7 +76,19 @@ class IxFileHdr {
         first_leaf_;  // 首叶节点对应的页号，在上层IxManager的open函数进行初始化，初始化为root
                       // page_no
     page_id_t last_leaf_;  // 尾叶节点对应的页号
+    // 布隆过滤器(IxBloomFilter)，存放在从bloom_first_page_开始的连续页面中，建索引时生成，
+    // 加入的键数超过建立时的预留后重建(IxIndexHandle::rebuild_bloom_filter)
+    int bloom_key_len_ = 0;     // 过滤器所用的键前缀长度(只含索引字段，不含INCLUDE字段)，0表示没有过滤器
+    int bloom_num_blocks_ = 0;  // 过滤器的块数
+    page_id_t bloom_first_page_ = IX_NO_PAGE;
+    int bloom_bits_per_key_ = 0;  // 每个键占用的位数，0表示不重建过滤器
+    int bloom_num_keys_ = 0;      // 加入过滤器的键数
     int tot_len_;          // 记录结构体的整体长度
+    IxKeyKind key_kind_ = IX_KEY_MULTI;  // 结点内查找键的方式，由update_key_kind()计算
+    bool packed_ = false;  // 结点是否采用前缀压缩的变长格式，由update_key_kind()计算
+    // INCLUDE字段依次存放成的payload，只存放在叶结点中，不参与比较；旧版本的索引文件没有这两个字段
+    int payload_len_ = 0;  // payload的长度，0表示没有INCLUDE字段
+    int leaf_order_ = 0;   // payload_len_ > 0时叶结点最多可插入的键值对数量，内部结点仍为btree_order_
 
     IxFileHdr() { tot_len_ = col_num_ = 0; }
 
@@ -59,10 +109,36 @@ class IxFileHdr {
 
     void update_tot_len() {
         tot_len_ = 0;
-        tot_len_ += sizeof(page_id_t) * 4 + sizeof(int) * 6;
+        tot_len_ += sizeof(page_id_t) * 5 + sizeof(int) * 12;
         tot_len_ += sizeof(ColType) * col_num_ + sizeof(int) * col_num_;
     }
 
+    // 变长格式的数据区只存放键和rid，带payload的索引使用定长格式
+    void update_key_kind() {
+        key_kind_ = IX_KEY_MULTI;
+        packed_ = false;
+        if (col_num_ != 1) {
+            // 联合索引的键规范化后按字节比较，与字符串键一样可以前缀压缩
+            packed_ = col_tot_len_ <= IX_PACKED_MAX_KEY_LEN && payload_len_ == 0;
+            return;
+        }
+        if (col_types_[0] == TYPE_INT && col_lens_[0] == sizeof(int)) {
+            key_kind_ = IX_KEY_INT;
+        } else if (col_types_[0] == TYPE_FLOAT && col_lens_[0] == sizeof(float)) {
+            key_kind_ = IX_KEY_FLOAT;
+        } else if (col_types_[0] == TYPE_STRING) {
+            key_kind_ = IX_KEY_STRING;
+            // 字符串键按字节序比较，结点内可以只存一次公共前缀，并截掉末尾补齐的0
+            packed_ = col_tot_len_ <= IX_PACKED_MAX_KEY_LEN && payload_len_ == 0;
+        }
+    }
+
+    // 联合索引的键在索引中以规范化形式存储，调用者传入的原始键需要先经过ix_encode_key()
+    bool normalized() const { return key_kind_ == IX_KEY_MULTI; }
+
+    // 调用者插入的索引项是键之后紧跟payload，查找和删除只用前col_tot_len_个字节
+    int entry_len() const { return col_tot_len_ + payload_len_; }
+
     void serialize(char *dest) {
         int offset = 0;
         memcpy(dest + offset, &tot_len_, sizeof(int));
@@ -93,6 +169,20 @@ class IxFileHdr {
         offset += sizeof(page_id_t);
         memcpy(dest + offset, &last_leaf_, sizeof(page_id_t));
         offset += sizeof(page_id_t);
+        memcpy(dest + offset, &bloom_key_len_, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, &bloom_num_blocks_, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, &bloom_first_page_, sizeof(page_id_t));
+        offset += sizeof(page_id_t);
+        memcpy(dest + offset, &bloom_bits_per_key_, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, &bloom_num_keys_, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, &payload_len_, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, &leaf_order_, sizeof(int));
+        offset += sizeof(int);
         assert(offset == tot_len_);
     }
 
@@ -109,7 +199,6 @@ class IxFileHdr {
         offset += sizeof(page_id_t);
         col_num_ = *reinterpret_cast<const int *>(src + offset);
         offset += sizeof(int);
-        std::cout << col_num_ << "\n";
         for (int i = 0; i < col_num_; ++i) {
             // col_types_[i] = *reinterpret_cast<const ColType*>(src + offset);
             ColType type = *reinterpret_cast<const ColType *>(src + offset);
@@ -132,7 +221,31 @@ class IxFileHdr {
         offset += sizeof(page_id_t);
         last_leaf_ = *reinterpret_cast<const page_id_t *>(src + offset);
         offset += sizeof(page_id_t);
+        // 旧版本的索引文件没有布隆过滤器的字段
+        if (offset < tot_len_) {
+            bloom_key_len_ = *reinterpret_cast<const int *>(src + offset);
+            offset += sizeof(int);
+            bloom_num_blocks_ = *reinterpret_cast<const int *>(src + offset);
+            offset += sizeof(int);
+            bloom_first_page_ = *reinterpret_cast<const page_id_t *>(src + offset);
+            offset += sizeof(page_id_t);
+        }
+        // 没有键数字段的索引文件不知道过滤器按多少位分配，不重建过滤器
+        if (offset < tot_len_) {
+            bloom_bits_per_key_ = *reinterpret_cast<const int *>(src + offset);
+            offset += sizeof(int);
+            bloom_num_keys_ = *reinterpret_cast<const int *>(src + offset);
+            offset += sizeof(int);
+        }
+        if (offset < tot_len_) {
+            payload_len_ = *reinterpret_cast<const int *>(src + offset);
+            offset += sizeof(int);
+            leaf_order_ = *reinterpret_cast<const int *>(src + offset);
+            offset += sizeof(int);
+        }
         assert(offset == tot_len_);
+        update_tot_len();  // 再次写回时使用当前的格式
+        update_key_kind();
     }
 };
 
@@ -147,6 +260,12 @@ class IxPageHdr {
                           // is_leaf is true
     page_id_t next_leaf;  // next leaf node's page_no, effective only when
                           // is_leaf is true
+    // 以下字段只用于前缀压缩的变长格式结点(IxFileHdr::packed_)
+    int prefix_len;   // 结点内所有key的公共前缀长度，前缀由结点的上下界决定
+    int low_len;      // 下界去掉前缀后的长度，-1表示负无穷
+    int high_len;     // 上界去掉前缀后的长度，-1表示正无穷
+    int heap_offset;  // 键值对数据区的起始偏移，数据区从页尾向前增长
+    int data_bytes;   // 数据区中有效键值对占用的字节数
 };
 
 class Iid {
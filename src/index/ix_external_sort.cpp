@@ -0,0 +1,312 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "ix_external_sort.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "ix_key_search.h"
+
+static constexpr int RUN_BLOCK_SIZE = 16 * PAGE_SIZE;  // 段文件每次读写的字节数
+
+IxExternalSorter::IxExternalSorter(DiskManager *disk_manager,
+                                   std::string run_prefix,
+                                   std::vector<ColType> col_types,
+                                   std::vector<int> col_lens,
+                                   size_t memory_budget)
+    : disk_manager_(disk_manager),
+      run_prefix_(std::move(run_prefix)),
+      col_types_(std::move(col_types)),
+      col_lens_(std::move(col_lens)),
+      memory_budget_(memory_budget) {
+    key_len_ = 0;
+    for (int col_len : col_lens_) {
+        key_len_ += col_len;
+    }
+    entry_len_ = key_len_ + sizeof(Rid);
+}
+
+IxExternalSorter::~IxExternalSorter() {
+    for (auto &reader : readers_) {
+        disk_manager_->close_file(reader->fd);
+    }
+    for (auto &run : runs_) {
+        disk_manager_->destroy_file(run);
+    }
+}
+
+/**
+ * @description: 先比较key，key相同时比较rid
+ */
+bool IxExternalSorter::less(const char *a, const char *b) const {
+    int cmp = col_types_.size() == 1 ? ix_compare(a, b, col_types_[0], key_len_)
+                                     : ix_compare(a, b, col_types_, col_lens_);
+    if (cmp != 0) {
+        return cmp < 0;
+    }
+    Rid rid_a, rid_b;
+    memcpy(&rid_a, a + key_len_, sizeof(Rid));
+    memcpy(&rid_b, b + key_len_, sizeof(Rid));
+    return rid_a.page_no != rid_b.page_no ? rid_a.page_no < rid_b.page_no
+                                          : rid_a.slot_no < rid_b.slot_no;
+}
+
+/**
+ * @description: 归并时用于维护最小堆：段a的当前项是否大于段b的当前项
+ */
+bool IxExternalSorter::run_greater(int a, int b) const {
+    return less(readers_[b]->entry.data(), readers_[a]->entry.data());
+}
+
+void IxExternalSorter::add(const char *key, const Rid &rid) {
+    assert(!finished_);
+    buffer_.insert(buffer_.end(), key, key + key_len_);
+    buffer_.insert(buffer_.end(), reinterpret_cast<const char *>(&rid),
+                   reinterpret_cast<const char *>(&rid) + sizeof(Rid));
+    num_entries_++;
+    // 排序时每项还需要一个偏移量
+    size_t num_buffered = buffer_.size() / entry_len_;
+    if (buffer_.size() + num_buffered * sizeof(size_t) >= memory_budget_) {
+        spill_run();
+    }
+}
+
+/**
+ * @description: 只排序各项的偏移量，避免移动定长的项
+ */
+void IxExternalSorter::sort_buffer() {
+    size_t num_buffered = buffer_.size() / entry_len_;
+    order_.resize(num_buffered);
+    for (size_t i = 0; i < num_buffered; i++) {
+        order_[i] = i * entry_len_;
+    }
+    const char *base = buffer_.data();
+    std::sort(order_.begin(), order_.end(), [&](size_t a, size_t b) {
+        return less(base + a, base + b);
+    });
+}
+
+/**
+ * @description: 把内存中的项排好序写成一个段文件，并清空内存
+ */
+void IxExternalSorter::spill_run() {
+    sort_buffer();
+    std::string run_name = run_prefix_ + "." + std::to_string(runs_.size());
+    if (disk_manager_->is_file(run_name)) {
+        disk_manager_->destroy_file(run_name);
+    }
+    disk_manager_->create_file(run_name);
+    runs_.push_back(run_name);
+
+    int fd = disk_manager_->open_file(run_name);
+    std::vector<char> block;
+    block.reserve(RUN_BLOCK_SIZE);
+    page_id_t page_no = 0;
+    for (size_t offset : order_) {
+        const char *entry = buffer_.data() + offset;
+        // 一项可能跨越两个块
+        for (int copied = 0; copied < entry_len_;) {
+            int n = std::min(entry_len_ - copied,
+                             RUN_BLOCK_SIZE - (int)block.size());
+            block.insert(block.end(), entry + copied, entry + copied + n);
+            copied += n;
+            if ((int)block.size() == RUN_BLOCK_SIZE) {
+                disk_manager_->write_page(fd, page_no, block.data(),
+                                          block.size());
+                page_no += RUN_BLOCK_SIZE / PAGE_SIZE;
+                block.clear();
+            }
+        }
+    }
+    if (!block.empty()) {
+        disk_manager_->write_page(fd, page_no, block.data(), block.size());
+    }
+    disk_manager_->close_file(fd);
+
+    buffer_.clear();
+    order_.clear();
+}
+
+/**
+ * @description: 从段文件中读出下一项到reader.entry
+ * @return {bool} 段文件已读完时返回false
+ */
+bool IxExternalSorter::read_entry(RunReader &reader) {
+    for (int copied = 0; copied < entry_len_;) {
+        if (reader.block_pos == reader.block_len) {
+            if (reader.file_offset == reader.file_size) {
+                return false;
+            }
+            reader.block_len = std::min((size_t)RUN_BLOCK_SIZE,
+                                        reader.file_size - reader.file_offset);
+            disk_manager_->read_page(reader.fd, reader.file_offset / PAGE_SIZE,
+                                     reader.block.data(), reader.block_len);
+            reader.file_offset += reader.block_len;
+            reader.block_pos = 0;
+        }
+        int n = std::min((size_t)(entry_len_ - copied),
+                         reader.block_len - reader.block_pos);
+        memcpy(reader.entry.data() + copied,
+               reader.block.data() + reader.block_pos, n);
+        reader.block_pos += n;
+        copied += n;
+    }
+    return true;
+}
+
+void IxExternalSorter::finish() {
+    assert(!finished_);
+    finished_ = true;
+    if (runs_.empty()) {
+        sort_buffer();
+        return;
+    }
+    if (!buffer_.empty()) {
+        spill_run();
+    }
+    buffer_.shrink_to_fit();
+
+    auto heap_greater = [&](int a, int b) { return run_greater(a, b); };
+    for (auto &run : runs_) {
+        auto reader = std::make_unique<RunReader>();
+        reader->fd = disk_manager_->open_file(run);
+        reader->file_size = disk_manager_->get_file_size(run);
+        reader->block.resize(RUN_BLOCK_SIZE);
+        reader->entry.resize(entry_len_);
+        readers_.push_back(std::move(reader));
+        if (read_entry(*readers_.back())) {
+            heap_.push_back(readers_.size() - 1);
+            std::push_heap(heap_.begin(), heap_.end(), heap_greater);
+        }
+    }
+}
+
+bool IxExternalSorter::next(char *key, Rid *rid) {
+    assert(finished_);
+    if (readers_.empty()) {
+        if (buffer_pos_ == order_.size()) {
+            return false;
+        }
+        const char *entry = buffer_.data() + order_[buffer_pos_++];
+        memcpy(key, entry, key_len_);
+        memcpy(rid, entry + key_len_, sizeof(Rid));
+        return true;
+    }
+
+    // 多路归并：取出当前项最小的段，输出后读入该段的下一项
+    if (heap_.empty()) {
+        return false;
+    }
+    auto heap_greater = [&](int a, int b) { return run_greater(a, b); };
+    std::pop_heap(heap_.begin(), heap_.end(), heap_greater);
+    RunReader &reader = *readers_[heap_.back()];
+    memcpy(key, reader.entry.data(), key_len_);
+    memcpy(rid, reader.entry.data() + key_len_, sizeof(Rid));
+    if (read_entry(reader)) {
+        std::push_heap(heap_.begin(), heap_.end(), heap_greater);
+    } else {
+        heap_.pop_back();
+    }
+    return true;
+}
+
+IxParallelMerger::IxParallelMerger(std::vector<IxExternalSorter *> sorters)
+    : sorters_(std::move(sorters)) {
+    key_len_ = sorters_.front()->key_len();
+    entry_len_ = key_len_ + sizeof(Rid);
+    thread_ = std::thread(&IxParallelMerger::merge, this);
+}
+
+IxParallelMerger::~IxParallelMerger() {
+    {
+        std::lock_guard<std::mutex> lock(latch_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+/**
+ * @description: 后台线程：对各排序器的输出做多路归并，每满一批放入队列，队列满时等待调用者取走
+ */
+void IxParallelMerger::merge() {
+    try {
+        int num_sorters = sorters_.size();
+        std::vector<std::vector<char>> heads(num_sorters, std::vector<char>(entry_len_));
+        auto next_head = [&](int i) {
+            Rid rid;
+            bool has_next = sorters_[i]->next(heads[i].data(), &rid);
+            memcpy(heads[i].data() + key_len_, &rid, sizeof(Rid));
+            return has_next;
+        };
+        auto heap_greater = [&](int a, int b) { return sorters_[0]->less(heads[b].data(), heads[a].data()); };
+        std::vector<int> heap;
+        for (int i = 0; i < num_sorters; i++) {
+            if (next_head(i)) {
+                heap.push_back(i);
+                std::push_heap(heap.begin(), heap.end(), heap_greater);
+            }
+        }
+
+        std::vector<char> batch;
+        batch.reserve(BATCH_SIZE * entry_len_);
+        while (!heap.empty() || !batch.empty()) {
+            if (!heap.empty()) {
+                std::pop_heap(heap.begin(), heap.end(), heap_greater);
+                int i = heap.back();
+                batch.insert(batch.end(), heads[i].begin(), heads[i].end());
+                if (next_head(i)) {
+                    std::push_heap(heap.begin(), heap.end(), heap_greater);
+                } else {
+                    heap.pop_back();
+                }
+            }
+            if (batch.size() == (size_t)BATCH_SIZE * entry_len_ || (heap.empty() && !batch.empty())) {
+                std::unique_lock<std::mutex> lock(latch_);
+                cv_.wait(lock, [&] { return stop_ || (int)batches_.size() < MAX_BATCHES; });
+                if (stop_) {
+                    return;
+                }
+                batches_.push_back(std::move(batch));
+                batch = std::vector<char>();
+                batch.reserve(BATCH_SIZE * entry_len_);
+                cv_.notify_all();
+            }
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(latch_);
+        error_ = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(latch_);
+    done_ = true;
+    cv_.notify_all();
+}
+
+bool IxParallelMerger::next(char *key, Rid *rid) {
+    if (batch_pos_ == batch_.size()) {
+        std::unique_lock<std::mutex> lock(latch_);
+        cv_.wait(lock, [&] { return !batches_.empty() || done_; });
+        if (batches_.empty()) {
+            if (error_ != nullptr) {
+                std::rethrow_exception(error_);
+            }
+            return false;
+        }
+        batch_ = std::move(batches_.front());
+        batches_.pop_front();
+        batch_pos_ = 0;
+        cv_.notify_all();
+    }
+    memcpy(key, batch_.data() + batch_pos_, key_len_);
+    memcpy(rid, batch_.data() + batch_pos_ + key_len_, sizeof(Rid));
+    batch_pos_ += entry_len_;
+    return true;
+}
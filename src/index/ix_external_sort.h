@@ -0,0 +1,144 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ix_defs.h"
+#include "storage/disk_manager.h"
+
+/**
+ * @description: 建索引时对(key, rid)项排序的外部排序器
+ * 项在内存中积累，超过内存预算时排好序写成一个有序段(run)文件；
+ * 全部输入后，如果没有写出过段文件就直接在内存中输出，否则对所有段做多路归并。
+ * 输出按key升序，key相同时按rid升序，即与顺序扫描表时的先后顺序一致。
+ */
+class IxExternalSorter {
+   public:
+    IxExternalSorter(DiskManager *disk_manager, std::string run_prefix,
+                     std::vector<ColType> col_types, std::vector<int> col_lens,
+                     size_t memory_budget = IX_SORT_MEMORY_SIZE);
+
+    ~IxExternalSorter();
+
+    /**
+     * @description: 添加一项，只能在finish()之前调用
+     */
+    void add(const char *key, const Rid &rid);
+
+    /**
+     * @description: 结束输入，排序内存中剩余的项并准备按序输出
+     */
+    void finish();
+
+    /**
+     * @description: 按序取出下一项
+     * @return {bool} 已经没有更多的项时返回false
+     */
+    bool next(char *key, Rid *rid);
+
+    size_t size() const { return num_entries_; }
+
+    int num_runs() const { return runs_.size(); }
+
+    int key_len() const { return key_len_; }
+
+    /**
+     * @description: 比较两个项(key紧跟rid)，先比较key，key相同时比较rid
+     */
+    bool less(const char *a, const char *b) const;
+
+   private:
+    // 段文件的顺序读取器，按块缓冲
+    struct RunReader {
+        int fd;
+        size_t file_size;
+        size_t file_offset = 0;
+        std::vector<char> block;
+        size_t block_pos = 0;
+        size_t block_len = 0;
+        std::vector<char> entry;  // 当前项
+    };
+
+    bool run_greater(int a, int b) const;
+
+    void sort_buffer();
+
+    void spill_run();
+
+    bool read_entry(RunReader &reader);
+
+    DiskManager *disk_manager_;
+    std::string run_prefix_;
+    std::vector<ColType> col_types_;
+    std::vector<int> col_lens_;
+    int key_len_;
+    int entry_len_;  // key_len_ + sizeof(Rid)
+    size_t memory_budget_;
+    size_t num_entries_ = 0;
+
+    std::vector<char> buffer_;    // 内存中积累的项
+    std::vector<size_t> order_;   // buffer_中各项排序后的偏移
+    size_t buffer_pos_ = 0;       // 内存输出时的位置
+
+    std::vector<std::string> runs_;                   // 段文件名
+    std::vector<std::unique_ptr<RunReader>> readers_;  // 归并时各段的读取器
+    std::vector<int> heap_;                            // 按当前项排序的读取器下标
+    bool finished_ = false;
+};
+
+/**
+ * @description: 并行建索引时归并各工作线程的排序结果
+ * 归并在后台线程中进行，结果按批放入有界队列交给调用者，使归并与自底向上建树流水线并行
+ */
+class IxParallelMerger {
+   public:
+    static constexpr int BATCH_SIZE = 4096;  // 每批的项数
+    static constexpr int MAX_BATCHES = 4;    // 队列中最多缓存的批数
+
+    /**
+     * @param sorters 已经调用过finish()的排序器，生命周期须长于本对象
+     */
+    explicit IxParallelMerger(std::vector<IxExternalSorter *> sorters);
+
+    ~IxParallelMerger();
+
+    /**
+     * @description: 按序取出下一项，后台归并出错时在这里重新抛出异常
+     * @return {bool} 已经没有更多的项时返回false
+     */
+    bool next(char *key, Rid *rid);
+
+   private:
+    void merge();
+
+    std::vector<IxExternalSorter *> sorters_;
+    int key_len_;
+    int entry_len_;
+
+    std::mutex latch_;
+    std::condition_variable cv_;
+    std::deque<std::vector<char>> batches_;  // 已归并好的批
+    bool done_ = false;                       // 后台线程已归并完所有项
+    bool stop_ = false;                       // 调用者提前结束，后台线程应尽快退出
+    std::exception_ptr error_;
+
+    std::vector<char> batch_;  // 调用者正在读取的批
+    size_t batch_pos_ = 0;
+    std::thread thread_;
+};
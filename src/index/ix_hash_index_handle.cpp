@@ -0,0 +1,327 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "ix_hash_index_handle.h"
+
+#include <algorithm>
+
+static uint32_t depth_mask(int depth) { return (1u << depth) - 1; }
+
+void IxHashFileHdr::serialize(char *dest) const {
+    int offset = 0;
+    auto put = [&](const void *src, size_t len) {
+        memcpy(dest + offset, src, len);
+        offset += len;
+    };
+    int tot = tot_len();
+    int num_dir_pages = dir_pages_.size();
+    put(&tot, sizeof(int));
+    put(&num_pages_, sizeof(int));
+    put(&col_num_, sizeof(int));
+    for (int i = 0; i < col_num_; ++i) {
+        put(&col_types_[i], sizeof(ColType));
+    }
+    for (int i = 0; i < col_num_; ++i) {
+        put(&col_lens_[i], sizeof(int));
+    }
+    put(&col_tot_len_, sizeof(int));
+    put(&bucket_capacity_, sizeof(int));
+    put(&global_depth_, sizeof(int));
+    put(&num_dir_pages, sizeof(int));
+    put(dir_pages_.data(), sizeof(page_id_t) * num_dir_pages);
+    assert(offset == tot);
+}
+
+void IxHashFileHdr::deserialize(const char *src) {
+    int offset = 0;
+    auto get = [&](void *dest, size_t len) {
+        memcpy(dest, src + offset, len);
+        offset += len;
+    };
+    int tot;
+    int num_dir_pages;
+    get(&tot, sizeof(int));
+    get(&num_pages_, sizeof(int));
+    get(&col_num_, sizeof(int));
+    col_types_.resize(col_num_);
+    col_lens_.resize(col_num_);
+    for (int i = 0; i < col_num_; ++i) {
+        get(&col_types_[i], sizeof(ColType));
+    }
+    for (int i = 0; i < col_num_; ++i) {
+        get(&col_lens_[i], sizeof(int));
+    }
+    get(&col_tot_len_, sizeof(int));
+    get(&bucket_capacity_, sizeof(int));
+    get(&global_depth_, sizeof(int));
+    get(&num_dir_pages, sizeof(int));
+    dir_pages_.resize(num_dir_pages);
+    get(dir_pages_.data(), sizeof(page_id_t) * num_dir_pages);
+    assert(offset == tot);
+}
+
+IxHashIndexHandle::IxHashIndexHandle(DiskManager *disk_manager,
+                                     BufferPoolManager *buffer_pool_manager,
+                                     int fd)
+    : disk_manager_(disk_manager),
+      buffer_pool_manager_(buffer_pool_manager),
+      fd_(fd) {
+    char buf[PAGE_SIZE];
+    memset(buf, 0, PAGE_SIZE);
+    disk_manager_->read_page(fd, IX_FILE_HDR_PAGE, buf, PAGE_SIZE);
+    file_hdr_ = new IxHashFileHdr();
+    file_hdr_->deserialize(buf);
+
+    // 关闭索引时所有页面都已刷盘，从文件末尾开始分配新的page_no
+    int num_pages =
+        disk_manager_->get_file_size(disk_manager_->get_file_name(fd)) /
+        PAGE_SIZE;
+    disk_manager_->set_fd2pageno(fd,
+                                 std::max(num_pages, IX_HASH_INIT_NUM_PAGES));
+}
+
+/**
+ * @description: 把原始键规范化到buf中，返回规范化键的哈希值
+ */
+uint32_t IxHashIndexHandle::hash_key(const char *key, char *buf) const {
+    ix_encode_key(key, buf, file_hdr_->col_types_, file_hdr_->col_lens_);
+    return hash_normalized(buf);
+}
+
+/**
+ * @description: 规范化键的哈希值，先做FNV-1a，再用64位的混合函数打散，目录用哈希值的低位定位桶
+ */
+uint32_t IxHashIndexHandle::hash_normalized(const char *key) const {
+    uint64_t h = 14695981039346656037ull;
+    for (int i = 0; i < file_hdr_->col_tot_len_; i++) {
+        h ^= static_cast<unsigned char>(key[i]);
+        h *= 1099511628211ull;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return static_cast<uint32_t>(h);
+}
+
+/**
+ * @description: 查找给定key对应的rid
+ * @return {bool} key是否存在
+ */
+bool IxHashIndexHandle::get_value(const char *key, std::vector<Rid> *result,
+                                  Transaction *transaction) {
+    char buf[IX_MAX_COL_LEN];
+    uint32_t hash = hash_key(key, buf);
+    Page *page = fetch_bucket(hash, false);
+    int pos = bucket_find(page, buf);
+    if (pos >= 0) {
+        result->push_back(*bucket_rid(page, pos));
+    }
+    release_bucket(page, false, false);
+    return pos >= 0;
+}
+
+bool IxHashIndexHandle::insert_entry(const char *key, const Rid &value,
+                                     Transaction *transaction) {
+    char buf[IX_MAX_COL_LEN];
+    uint32_t hash = hash_key(key, buf);
+    while (true) {
+        Page *page = fetch_bucket(hash, true);
+        if (bucket_find(page, buf) >= 0) {
+            release_bucket(page, true, false);
+            return false;
+        }
+        auto hdr = bucket_hdr(page);
+        if (hdr->num_key < file_hdr_->bucket_capacity_) {
+            memcpy(bucket_key(page, hdr->num_key), buf, file_hdr_->col_tot_len_);
+            *bucket_rid(page, hdr->num_key) = value;
+            hdr->num_key++;
+            release_bucket(page, true, true);
+            return true;
+        }
+        // 桶满了，先放开桶锁再去独占目录分裂，分裂后重新定位
+        release_bucket(page, true, false);
+        split_bucket(hash);
+    }
+}
+
+/**
+ * @description: 删除key对应的键值对，用桶内最后一项填补空位；桶不合并，目录不收缩
+ * @return {bool} key是否存在
+ */
+bool IxHashIndexHandle::delete_entry(const char *key, Transaction *transaction) {
+    char buf[IX_MAX_COL_LEN];
+    uint32_t hash = hash_key(key, buf);
+    Page *page = fetch_bucket(hash, true);
+    int pos = bucket_find(page, buf);
+    if (pos < 0) {
+        release_bucket(page, true, false);
+        return false;
+    }
+    auto hdr = bucket_hdr(page);
+    int last = hdr->num_key - 1;
+    if (pos != last) {
+        memcpy(bucket_key(page, pos), bucket_key(page, last), file_hdr_->col_tot_len_);
+        *bucket_rid(page, pos) = *bucket_rid(page, last);
+    }
+    hdr->num_key--;
+    release_bucket(page, true, true);
+    return true;
+}
+
+/**
+ * @description: 找到哈希值所在的桶，pin并加锁后返回
+ * 目录只在读取目录项时共享加锁；锁住桶后确认桶仍负责该哈希值，否则说明期间桶被分裂了，重新查目录
+ */
+Page *IxHashIndexHandle::fetch_bucket(uint32_t hash, bool exclusive) {
+    while (true) {
+        page_id_t page_no;
+        {
+            std::shared_lock<std::shared_mutex> lock(dir_latch_);
+            page_no = dir_lookup(hash & depth_mask(file_hdr_->global_depth_));
+        }
+        Page *page = buffer_pool_manager_->fetch_page({fd_, page_no});
+        exclusive ? page->wlatch() : page->rlatch();
+        auto hdr = bucket_hdr(page);
+        if ((hash & depth_mask(hdr->local_depth)) == hdr->pattern) {
+            return page;
+        }
+        release_bucket(page, exclusive, false);
+    }
+}
+
+void IxHashIndexHandle::release_bucket(Page *page, bool exclusive,
+                                       bool is_dirty) {
+    exclusive ? page->wunlatch() : page->runlatch();
+    buffer_pool_manager_->unpin_page(page->get_page_id(), is_dirty);
+}
+
+/**
+ * @description: 分裂哈希值所在的桶，必要时先把目录加倍
+ * 独占目录期间重新检查桶是否仍然是满的，其他线程可能已经分裂过了。
+ * 分裂只按下一位哈希值拆分一次，如果所有键都落在同一边，由调用者重试时再次分裂。
+ */
+void IxHashIndexHandle::split_bucket(uint32_t hash) {
+    std::unique_lock<std::shared_mutex> lock(dir_latch_);
+    page_id_t page_no = dir_lookup(hash & depth_mask(file_hdr_->global_depth_));
+    Page *page = buffer_pool_manager_->fetch_page({fd_, page_no});
+    page->wlatch();
+    auto hdr = bucket_hdr(page);
+    if (hdr->num_key < file_hdr_->bucket_capacity_) {
+        release_bucket(page, true, false);
+        return;
+    }
+    if (hdr->local_depth == file_hdr_->global_depth_) {
+        if (file_hdr_->global_depth_ == IX_HASH_MAX_GLOBAL_DEPTH) {
+            release_bucket(page, true, false);
+            throw HashDirectoryFullError(file_hdr_->global_depth_);
+        }
+        double_directory();
+    }
+
+    // 新桶负责第local_depth位为1的哈希值，新页面加锁前其他线程无法通过目录访问它
+    Page *new_bucket = new_page();
+    new_bucket->wlatch();
+    auto new_hdr = bucket_hdr(new_bucket);
+    uint32_t bit = 1u << hdr->local_depth;
+    hdr->local_depth++;
+    *new_hdr = {.local_depth = hdr->local_depth,
+                .pattern = hdr->pattern | bit,
+                .num_key = 0};
+
+    int kept = 0;
+    for (int i = 0; i < hdr->num_key; i++) {
+        char *key = bucket_key(page, i);
+        if (hash_normalized(key) & bit) {
+            memcpy(bucket_key(new_bucket, new_hdr->num_key), key, file_hdr_->col_tot_len_);
+            *bucket_rid(new_bucket, new_hdr->num_key) = *bucket_rid(page, i);
+            new_hdr->num_key++;
+        } else {
+            if (kept != i) {
+                memcpy(bucket_key(page, kept), key, file_hdr_->col_tot_len_);
+                *bucket_rid(page, kept) = *bucket_rid(page, i);
+            }
+            kept++;
+        }
+    }
+    hdr->num_key = kept;
+
+    // 原来指向旧桶、且第local_depth位为1的目录项改为指向新桶
+    page_id_t new_page_no = new_bucket->get_page_id().page_no;
+    uint32_t dir_size = 1u << file_hdr_->global_depth_;
+    for (uint32_t i = new_hdr->pattern; i < dir_size; i += 1u << new_hdr->local_depth) {
+        dir_update(i, new_page_no);
+    }
+    release_bucket(new_bucket, true, true);
+    release_bucket(page, true, true);
+}
+
+/**
+ * @description: 目录加倍，新的一半复制旧的一半；调用者持有dir_latch_的独占锁
+ */
+void IxHashIndexHandle::double_directory() {
+    uint32_t old_size = 1u << file_hdr_->global_depth_;
+    if (old_size < static_cast<uint32_t>(IX_HASH_DIR_ENTRIES_PER_PAGE)) {
+        // 目录还在第一个目录页内
+        Page *page = buffer_pool_manager_->fetch_page({fd_, file_hdr_->dir_pages_[0]});
+        auto entries = reinterpret_cast<page_id_t *>(page->get_data());
+        memcpy(entries + old_size, entries, old_size * sizeof(page_id_t));
+        buffer_pool_manager_->unpin_page(page->get_page_id(), true);
+    } else {
+        size_t num_dir_pages = file_hdr_->dir_pages_.size();
+        for (size_t i = 0; i < num_dir_pages; i++) {
+            Page *src = buffer_pool_manager_->fetch_page({fd_, file_hdr_->dir_pages_[i]});
+            Page *dest = new_page();
+            memcpy(dest->get_data(), src->get_data(), PAGE_SIZE);
+            file_hdr_->dir_pages_.push_back(dest->get_page_id().page_no);
+            buffer_pool_manager_->unpin_page(src->get_page_id(), false);
+            buffer_pool_manager_->unpin_page(dest->get_page_id(), true);
+        }
+    }
+    file_hdr_->global_depth_++;
+}
+
+page_id_t IxHashIndexHandle::dir_lookup(uint32_t dir_idx) const {
+    page_id_t dir_page = file_hdr_->dir_pages_[dir_idx / IX_HASH_DIR_ENTRIES_PER_PAGE];
+    Page *page = buffer_pool_manager_->fetch_page({fd_, dir_page});
+    page_id_t page_no =
+        reinterpret_cast<page_id_t *>(page->get_data())[dir_idx % IX_HASH_DIR_ENTRIES_PER_PAGE];
+    buffer_pool_manager_->unpin_page(page->get_page_id(), false);
+    return page_no;
+}
+
+void IxHashIndexHandle::dir_update(uint32_t dir_idx, page_id_t page_no) {
+    page_id_t dir_page = file_hdr_->dir_pages_[dir_idx / IX_HASH_DIR_ENTRIES_PER_PAGE];
+    Page *page = buffer_pool_manager_->fetch_page({fd_, dir_page});
+    reinterpret_cast<page_id_t *>(page->get_data())[dir_idx % IX_HASH_DIR_ENTRIES_PER_PAGE] = page_no;
+    buffer_pool_manager_->unpin_page(page->get_page_id(), true);
+}
+
+/**
+ * @description: 分配一个新页面(pin住)，调用者持有dir_latch_的独占锁
+ */
+Page *IxHashIndexHandle::new_page() {
+    file_hdr_->num_pages_++;
+    PageId new_page_id = {.fd = fd_, .page_no = INVALID_PAGE_ID};
+    Page *page = buffer_pool_manager_->new_page(&new_page_id);
+    memset(page->get_data(), 0, PAGE_SIZE);
+    return page;
+}
+
+int IxHashIndexHandle::bucket_find(Page *page, const char *key) const {
+    int n = bucket_hdr(page)->num_key;
+    for (int i = 0; i < n; i++) {
+        if (memcmp(bucket_key(page, i), key, file_hdr_->col_tot_len_) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
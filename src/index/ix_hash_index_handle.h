@@ -0,0 +1,141 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <shared_mutex>
+
+#include "ix_defs.h"
+#include "ix_key_search.h"
+#include "transaction/transaction.h"
+
+constexpr int IX_HASH_DIR_PAGE = 1;           // 第一个目录页
+constexpr int IX_HASH_INIT_BUCKET_PAGE = 2;   // 初始时唯一的桶
+constexpr int IX_HASH_INIT_NUM_PAGES = 3;
+constexpr int IX_HASH_DIR_ENTRIES_PER_PAGE = PAGE_SIZE / sizeof(page_id_t);
+constexpr int IX_HASH_MAX_GLOBAL_DEPTH = 18;  // 目录最多2^18项，即256个目录页
+
+/* 哈希索引的文件头，存放在第0页，打开索引时读入内存，关闭索引时写回 */
+class IxHashFileHdr {
+   public:
+    int num_pages_;                   // 磁盘文件中页面的数量
+    int col_num_;                     // 索引包含的字段数量
+    std::vector<ColType> col_types_;  // 字段的类型
+    std::vector<int> col_lens_;       // 字段的长度
+    int col_tot_len_;                 // 索引包含的字段的总长度
+    int bucket_capacity_;             // 每个桶最多存放的键值对数量
+    int global_depth_;                // 目录共有2^global_depth_项
+    // 目录页，目录的第i项存放在dir_pages_[i / IX_HASH_DIR_ENTRIES_PER_PAGE]中
+    std::vector<page_id_t> dir_pages_;
+
+    IxHashFileHdr()
+        : num_pages_(0),
+          col_num_(0),
+          col_tot_len_(0),
+          bucket_capacity_(0),
+          global_depth_(0) {}
+
+    int tot_len() const {
+        return sizeof(int) * 7 + (sizeof(ColType) + sizeof(int)) * col_num_ +
+               sizeof(page_id_t) * dir_pages_.size();
+    }
+
+    void serialize(char *dest) const;
+
+    void deserialize(const char *src);
+};
+
+/* 桶页面的头部，page->data = |IxHashBucketHdr|keys[bucket_capacity]|rids[bucket_capacity]| */
+struct IxHashBucketHdr {
+    int local_depth;   // 桶内所有key的哈希值的低local_depth位都等于pattern
+    uint32_t pattern;
+    int num_key;       // 已插入的键值对数量，键值对无序存放
+};
+
+/**
+ * @description: 磁盘上的可扩展哈希索引，只支持等值查找，目录和桶都通过缓冲池读写
+ * 键先按ix_encode_key()规范化再计算哈希，桶内直接按字节比较，因此-0.0与0.0是同一个键。
+ * 并发控制：
+ *     dir_latch_保护目录和文件头，查找目录项时共享加锁，读到桶的页面号后立即释放；
+ *     只有桶分裂(以及目录加倍)时独占加锁。桶的内容由桶页面的读写锁保护。
+ *     读目录到锁住桶之间桶可能被分裂，所以锁住桶后检查哈希值的低local_depth位是否仍等于桶的pattern，
+ *     不等就重新查目录。桶只分裂不合并，目录只加倍不收缩，这一检查总是充分的。
+ */
+class IxHashIndexHandle {
+    friend class IxManager;
+
+   private:
+    DiskManager *disk_manager_;
+    BufferPoolManager *buffer_pool_manager_;
+    int fd_;
+    IxHashFileHdr *file_hdr_;
+    std::shared_mutex dir_latch_;
+
+   public:
+    IxHashIndexHandle(DiskManager *disk_manager,
+                      BufferPoolManager *buffer_pool_manager, int fd);
+
+    ~IxHashIndexHandle() { delete file_hdr_; }
+
+    // 以下公有接口中的key都是调用者的原始键
+    bool get_value(const char *key, std::vector<Rid> *result,
+                   Transaction *transaction);
+
+    /**
+     * @description: 插入键值对，key已存在时不插入
+     * @return {bool} 是否插入
+     */
+    bool insert_entry(const char *key, const Rid &value,
+                      Transaction *transaction);
+
+    bool delete_entry(const char *key, Transaction *transaction);
+
+    int get_global_depth() const { return file_hdr_->global_depth_; }
+
+    int get_num_pages() const { return file_hdr_->num_pages_; }
+
+    const IxHashFileHdr *get_file_hdr() const { return file_hdr_; }
+
+   private:
+    uint32_t hash_key(const char *key, char *buf) const;
+
+    uint32_t hash_normalized(const char *key) const;
+
+    Page *fetch_bucket(uint32_t hash, bool exclusive);
+
+    void release_bucket(Page *page, bool exclusive, bool is_dirty);
+
+    void split_bucket(uint32_t hash);
+
+    void double_directory();
+
+    page_id_t dir_lookup(uint32_t dir_idx) const;
+
+    void dir_update(uint32_t dir_idx, page_id_t page_no);
+
+    Page *new_page();
+
+    // 桶页面内的各部分
+    IxHashBucketHdr *bucket_hdr(Page *page) const {
+        return reinterpret_cast<IxHashBucketHdr *>(page->get_data());
+    }
+
+    char *bucket_key(Page *page, int i) const {
+        return page->get_data() + sizeof(IxHashBucketHdr) + i * file_hdr_->col_tot_len_;
+    }
+
+    Rid *bucket_rid(Page *page, int i) const {
+        return reinterpret_cast<Rid *>(page->get_data() + sizeof(IxHashBucketHdr) +
+                                       file_hdr_->bucket_capacity_ * file_hdr_->col_tot_len_) +
+               i;
+    }
+
+    int bucket_find(Page *page, const char *key) const;
+};
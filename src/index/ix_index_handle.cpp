@@ -10,8 +10,60 @@ See the Mulan PSL v2 for more details. */
 
 #include "ix_index_handle.h"
 
+#include <algorithm>
+
 #include "ix_scan.h"
 
+static int align4(int n) { return (n + 3) & ~3; }
+
+/* 变长格式中一个键值对在数据区占用的字节数，不含slot */
+static int packed_entry_bytes(int suffix_len) {
+    return align4(sizeof(Rid) + sizeof(uint16_t) + suffix_len);
+}
+
+/* 变长格式中页头、前缀和上下界占用的字节数，即slot数组的起始偏移 */
+static int packed_header_bytes(int prefix_len, int low_len, int high_len) {
+    return align4(sizeof(IxPageHdr) + prefix_len + std::max(low_len, 0) +
+                  std::max(high_len, 0));
+}
+
+/* 范围[low, high)内的key的公共前缀长度，nullptr表示无穷 */
+static int packed_prefix_len(const IxFileHdr *file_hdr, const char *low,
+                             const char *high) {
+    if (low == nullptr || high == nullptr) {
+        return 0;
+    }
+    return ix_common_prefix(low, high, file_hdr->col_tot_len_);
+}
+
+/* key去掉长度为prefix_len的前缀后，需要保存的后缀长度 */
+static int packed_suffix_len(const IxFileHdr *file_hdr, const char *key,
+                             int prefix_len) {
+    return std::max(ix_key_sig_len(key, file_hdr->col_tot_len_) - prefix_len, 0);
+}
+
+/**
+ * @brief 在keys[0, n)中查找排在target之前的键的个数，按索引的键类型选择专用的查找函数
+ * 键类型在打开索引时确定(IxFileHdr::key_kind_)，这里每次结点查找只分派一次，比较过程中不再判断类型
+ */
+template <bool UPPER>
+static int search_keys(const IxFileHdr *file_hdr, const char *keys, int n,
+                       const char *target) {
+    switch (file_hdr->key_kind_) {
+        case IX_KEY_INT:
+            return ix_search_int<UPPER>(keys, n, target);
+        case IX_KEY_FLOAT:
+            return ix_search_float<UPPER>(keys, n, target);
+        case IX_KEY_STRING:
+            return ix_search_string<UPPER>(keys, n, target,
+                                           file_hdr->col_tot_len_);
+        default:
+            // 联合索引的键已规范化为字节序，与字符串键一样用memcmp查找
+            return ix_search_string<UPPER>(keys, n, target,
+                                           file_hdr->col_tot_len_);
+    }
+}
+
 /**
  * @brief 在当前node中查找第一个>=target的key_idx
  *
@@ -20,28 +72,24 @@ See the Mulan PSL v2 for more details. */
  * @note 返回key index（同时也是rid index），作为slot no
  */
 int IxNodeHandle::lower_bound(const char *target) const {
-    // Todo:
-    // 查找当前节点中第一个大于等于target的key，并返回key的位置给上层
-    // 提示:
-    // 可以采用多种查找方式，如顺序遍历、二分查找等；使用ix_compare()函数进行比较
-
-    return -1;
+    if (is_packed()) {
+        return packed_search<false>(target);
+    }
+    return search_keys<false>(file_hdr, keys, page_hdr->num_key, target);
 }
 
 /**
  * @brief 在当前node中查找第一个>target的key_idx
  *
  * @return
- * key_idx，范围为[1,num_key)，如果返回的key_idx=num_key，则表示target大于等于最后一个key
- * @note 注意此处的范围从1开始
+ * key_idx，范围为[0,num_key]，如果返回的key_idx=num_key，则表示target大于等于最后一个key
+ * @note 内部结点的第0个key是子树的最小key，internal_lookup()据此把小于它的key也定位到第0个孩子
  */
 int IxNodeHandle::upper_bound(const char *target) const {
-    // Todo:
-    // 查找当前节点中第一个大于target的key，并返回key的位置给上层
-    // 提示:
-    // 可以采用多种查找方式：顺序遍历、二分查找等；使用ix_compare()函数进行比较
-
-    return -1;
+    if (is_packed()) {
+        return packed_search<true>(target);
+    }
+    return search_keys<true>(file_hdr, keys, page_hdr->num_key, target);
 }
 
 /**
@@ -53,13 +101,12 @@ int IxNodeHandle::upper_bound(const char *target) const {
  * @return 目标key是否存在
  */
 bool IxNodeHandle::leaf_lookup(const char *key, Rid **value) {
-    // Todo:
-    // 1. 在叶子节点中获取目标key所在位置
-    // 2. 判断目标key是否存在
-    // 3. 如果存在，获取key对应的Rid，并赋值给传出参数value
-    // 提示：可以调用lower_bound()和get_rid()函数。
-
-    return false;
+    int pos = lower_bound(key);
+    if (pos == get_size() || !key_equals(pos, key)) {
+        return false;
+    }
+    *value = get_rid(pos);
+    return true;
 }
 
 /**
@@ -68,12 +115,9 @@ bool IxNodeHandle::leaf_lookup(const char *key, Rid **value) {
  * @return page_id_t 目标key所在的孩子节点（子树）的存储页面编号
  */
 page_id_t IxNodeHandle::internal_lookup(const char *key) {
-    // Todo:
-    // 1. 查找当前非叶子节点中目标key所在孩子节点（子树）的位置
-    // 2. 获取该孩子节点（子树）所在页面的编号
-    // 3. 返回页面编号
-
-    return -1;
+    // 第一个大于key的位置的前一个孩子就是key所在的子树
+    int pos = upper_bound(key);
+    return value_at(std::max(pos - 1, 0));
 }
 
 /**
@@ -84,6 +128,7 @@ page_id_t IxNodeHandle::internal_lookup(const char *key) {
  * @param (key, rid) 连续键值对的起始地址，也就是第一个键值对，可以通过(key,
  * rid)来获取n个键值对
  * @param n 键值对数量
+ * @param payload 叶结点中n个键值对连续存放的payload，结点没有payload时忽略，为nullptr时清零
  * @note [0,pos)           [pos,num_key)
  *                            key_slot
  *                            /      \
@@ -92,12 +137,30 @@ page_id_t IxNodeHandle::internal_lookup(const char *key) {
  *                      key           key_slot
  */
 void IxNodeHandle::insert_pairs(int pos, const char *key, const Rid *rid,
-                                int n) {
-    // Todo:
-    // 1. 判断pos的合法性
-    // 2. 通过key获取n个连续键值对的key值，并把n个key值插入到pos位置
-    // 3. 通过rid获取n个连续键值对的rid值，并把n个rid值插入到pos位置
-    // 4. 更新当前节点的键数量
+                                int n, const char *payload) {
+    int size = get_size();
+    assert(pos >= 0 && pos <= size && n >= 0);
+    int key_len = file_hdr->col_tot_len_;
+    if (is_packed()) {
+        for (int i = 0; i < n; i++) {
+            packed_insert(pos + i, key + i * key_len, rid[i]);
+        }
+        return;
+    }
+    memmove(get_key(pos + n), get_key(pos), (size - pos) * key_len);
+    memcpy(get_key(pos), key, n * key_len);
+    memmove(get_rid(pos + n), get_rid(pos), (size - pos) * sizeof(Rid));
+    memcpy(get_rid(pos), rid, n * sizeof(Rid));
+    if (has_payload()) {
+        int payload_len = file_hdr->payload_len_;
+        memmove(get_payload(pos + n), get_payload(pos), (size - pos) * payload_len);
+        if (payload != nullptr) {
+            memcpy(get_payload(pos), payload, n * payload_len);
+        } else {
+            memset(get_payload(pos), 0, n * payload_len);
+        }
+    }
+    set_size(size + n);
 }
 
 /**
@@ -108,13 +171,11 @@ void IxNodeHandle::insert_pairs(int pos, const char *key, const Rid *rid,
  * @return int 键值对数量
  */
 int IxNodeHandle::insert(const char *key, const Rid &value) {
-    // Todo:
-    // 1. 查找要插入的键值对应该插入到当前节点的哪个位置
-    // 2. 如果key重复则不插入
-    // 3. 如果key不重复则插入键值对
-    // 4. 返回完成插入操作之后的键值对数量
-
-    return -1;
+    int pos = lower_bound(key);
+    if (pos == get_size() || !key_equals(pos, key)) {
+        insert_pair(pos, key, value);
+    }
+    return get_size();
 }
 
 /**
@@ -123,10 +184,23 @@ int IxNodeHandle::insert(const char *key, const Rid &value) {
  * @param pos 要删除键值对的位置
  */
 void IxNodeHandle::erase_pair(int pos) {
-    // Todo:
-    // 1. 删除该位置的key
-    // 2. 删除该位置的rid
-    // 3. 更新结点的键值对数量
+    int size = get_size();
+    assert(pos >= 0 && pos < size);
+    if (is_packed()) {
+        uint16_t *slots = slot_array();
+        page_hdr->data_bytes -= packed_entry_bytes(suffix_len(pos));
+        memmove(slots + pos, slots + pos + 1, (size - pos - 1) * sizeof(uint16_t));
+        set_size(size - 1);
+        return;
+    }
+    int key_len = file_hdr->col_tot_len_;
+    memmove(get_key(pos), get_key(pos + 1), (size - pos - 1) * key_len);
+    memmove(get_rid(pos), get_rid(pos + 1), (size - pos - 1) * sizeof(Rid));
+    if (has_payload()) {
+        memmove(get_payload(pos), get_payload(pos + 1),
+                (size - pos - 1) * file_hdr->payload_len_);
+    }
+    set_size(size - 1);
 }
 
 /**
@@ -136,12 +210,290 @@ void IxNodeHandle::erase_pair(int pos) {
  * @return 完成删除操作后的键值对数量
  */
 int IxNodeHandle::remove(const char *key) {
-    // Todo:
-    // 1. 查找要删除键值对的位置
-    // 2. 如果要删除的键值对存在，删除键值对
-    // 3. 返回完成删除操作后的键值对数量
+    int pos = lower_bound(key);
+    if (pos < get_size() && key_equals(pos, key)) {
+        erase_pair(pos);
+    }
+    return get_size();
+}
+
+/**
+ * @brief 把第key_idx个key复制到key中，变长格式下还原出定长的key
+ */
+void IxNodeHandle::copy_key(int key_idx, char *key) const {
+    int key_len = file_hdr->col_tot_len_;
+    if (!is_packed()) {
+        memcpy(key, get_key(key_idx), key_len);
+        return;
+    }
+    int prefix_len = page_hdr->prefix_len;
+    int len = suffix_len(key_idx);
+    memcpy(key, page->get_data() + sizeof(IxPageHdr), prefix_len);
+    memcpy(key + prefix_len, suffix(key_idx), len);
+    memset(key + prefix_len + len, 0, key_len - prefix_len - len);
+}
+
+/**
+ * @brief 结点在父结点中对应的key：定长格式下是第一个key，变长格式下是下界
+ * 下界为负无穷时没有约束，取第一个key
+ */
+void IxNodeHandle::get_separator(char *key) const {
+    if (is_packed() && get_low_key(key)) {
+        return;
+    }
+    if (get_size() > 0) {
+        copy_key(0, key);
+    } else {
+        memset(key, 0, file_hdr->col_tot_len_);
+    }
+}
 
-    return -1;
+/**
+ * @brief 取出结点中所有的键值对，key还原为定长
+ */
+void IxNodeHandle::get_pairs(std::vector<char> *keys,
+                             std::vector<Rid> *rids) const {
+    int key_len = file_hdr->col_tot_len_;
+    keys->resize(get_size() * key_len);
+    rids->resize(get_size());
+    for (int i = 0; i < get_size(); i++) {
+        copy_key(i, keys->data() + i * key_len);
+        (*rids)[i] = *get_rid(i);
+    }
+}
+
+/**
+ * @brief 结点已满，需要分裂
+ * 定长格式下插入后达到get_max_size()个键；变长格式下剩余空间放不下一个最长的键值对
+ */
+bool IxNodeHandle::is_full() const {
+    if (is_packed()) {
+        return free_bytes() < max_entry_bytes();
+    }
+    return page_hdr->num_key >= get_max_size();
+}
+
+/**
+ * @brief 结点中的键值对过少，需要与兄弟结点合并或重分配
+ */
+bool IxNodeHandle::is_underflow() const {
+    if (is_packed()) {
+        return entry_bytes() < min_entry_bytes();
+    }
+    return page_hdr->num_key < get_min_size();
+}
+
+/**
+ * @brief 清空变长格式的结点，并把它的范围设置为[low, high)，nullptr表示无穷
+ * 前缀取上下界的公共前缀，之后插入的key都必须在这个范围内
+ */
+void IxNodeHandle::reset(const char *low, const char *high) {
+    set_size(0);
+    if (!is_packed()) {
+        return;
+    }
+    int prefix_len = packed_prefix_len(file_hdr, low, high);
+    char *fence = page->get_data() + sizeof(IxPageHdr);
+    if (prefix_len > 0) {
+        memcpy(fence, low, prefix_len);
+        fence += prefix_len;
+    }
+    page_hdr->prefix_len = prefix_len;
+    page_hdr->low_len = -1;
+    if (low != nullptr) {
+        page_hdr->low_len = packed_suffix_len(file_hdr, low, prefix_len);
+        memcpy(fence, low + prefix_len, page_hdr->low_len);
+        fence += page_hdr->low_len;
+    }
+    page_hdr->high_len = -1;
+    if (high != nullptr) {
+        page_hdr->high_len = packed_suffix_len(file_hdr, high, prefix_len);
+        memcpy(fence, high + prefix_len, page_hdr->high_len);
+    }
+    page_hdr->heap_offset = PAGE_SIZE;
+    page_hdr->data_bytes = 0;
+}
+
+/**
+ * @brief 取出结点的下界，负无穷时返回false
+ */
+bool IxNodeHandle::get_low_key(char *key) const {
+    if (page_hdr->low_len < 0) {
+        return false;
+    }
+    const char *fence = page->get_data() + sizeof(IxPageHdr);
+    int prefix_len = page_hdr->prefix_len;
+    memcpy(key, fence, prefix_len);
+    memcpy(key + prefix_len, fence + prefix_len, page_hdr->low_len);
+    memset(key + prefix_len + page_hdr->low_len, 0,
+           file_hdr->col_tot_len_ - prefix_len - page_hdr->low_len);
+    return true;
+}
+
+/**
+ * @brief 取出结点的上界，正无穷时返回false
+ */
+bool IxNodeHandle::get_high_key(char *key) const {
+    if (page_hdr->high_len < 0) {
+        return false;
+    }
+    const char *fence = page->get_data() + sizeof(IxPageHdr);
+    int prefix_len = page_hdr->prefix_len;
+    memcpy(key, fence, prefix_len);
+    memcpy(key + prefix_len, fence + prefix_len + std::max(page_hdr->low_len, 0),
+           page_hdr->high_len);
+    memset(key + prefix_len + page_hdr->high_len, 0,
+           file_hdr->col_tot_len_ - prefix_len - page_hdr->high_len);
+    return true;
+}
+
+int IxNodeHandle::free_bytes() const {
+    return PAGE_SIZE -
+           packed_header_bytes(page_hdr->prefix_len, page_hdr->low_len,
+                               page_hdr->high_len) -
+           entry_bytes();
+}
+
+/* 一个最长的键值对(连同slot)占用的字节数 */
+int IxNodeHandle::max_entry_bytes() const {
+    return packed_entry_bytes(file_hdr->col_tot_len_ - page_hdr->prefix_len) +
+           sizeof(uint16_t);
+}
+
+/* 非根结点的键值对至少占用的字节数，少于它时需要合并或重分配 */
+int IxNodeHandle::min_entry_bytes() const {
+    return (PAGE_SIZE - sizeof(IxPageHdr)) / 4;
+}
+
+/**
+ * @brief 按范围[low, high)存放keys中的n个键值对时，结点加上还要预留的一个最长键值对共占用的字节数
+ */
+int IxNodeHandle::packed_bytes(const IxFileHdr *file_hdr, const char *low,
+                               const char *high, const char *keys, int n) {
+    int key_len = file_hdr->col_tot_len_;
+    int prefix_len = packed_prefix_len(file_hdr, low, high);
+    int low_len = low == nullptr ? -1 : packed_suffix_len(file_hdr, low, prefix_len);
+    int high_len =
+        high == nullptr ? -1 : packed_suffix_len(file_hdr, high, prefix_len);
+    int bytes = packed_header_bytes(prefix_len, low_len, high_len);
+    for (int i = 0; i < n; i++) {
+        bytes += packed_entry_bytes(
+                     packed_suffix_len(file_hdr, keys + i * key_len, prefix_len)) +
+                 sizeof(uint16_t);
+    }
+    return bytes + packed_entry_bytes(key_len - prefix_len) + sizeof(uint16_t);
+}
+
+/**
+ * @brief 按范围[low, high)存放keys中的n个键值对后，结点是否还没有满
+ */
+bool IxNodeHandle::packed_fits(const IxFileHdr *file_hdr, const char *low,
+                               const char *high, const char *keys, int n) {
+    return packed_bytes(file_hdr, low, high, keys, n) <= PAGE_SIZE;
+}
+
+uint16_t *IxNodeHandle::slot_array() const {
+    return reinterpret_cast<uint16_t *>(
+        page->get_data() + packed_header_bytes(page_hdr->prefix_len,
+                                               page_hdr->low_len,
+                                               page_hdr->high_len));
+}
+
+const char *IxNodeHandle::suffix(int key_idx) const {
+    return page->get_data() + slot_array()[key_idx] + sizeof(Rid) +
+           sizeof(uint16_t);
+}
+
+int IxNodeHandle::suffix_len(int key_idx) const {
+    uint16_t len;
+    memcpy(&len, page->get_data() + slot_array()[key_idx] + sizeof(Rid),
+           sizeof(uint16_t));
+    return len;
+}
+
+/**
+ * @brief 变长格式下比较第key_idx个key与定长的key
+ */
+int IxNodeHandle::packed_compare(int key_idx, const char *key) const {
+    int prefix_len = page_hdr->prefix_len;
+    int res = memcmp(page->get_data() + sizeof(IxPageHdr), key, prefix_len);
+    if (res != 0) {
+        return res;
+    }
+    return ix_compare_sig(suffix(key_idx), suffix_len(key_idx),
+                          key + prefix_len,
+                          packed_suffix_len(file_hdr, key, prefix_len));
+}
+
+/**
+ * @brief 变长格式下的结点内查找，先与前缀比较一次，再在后缀上二分
+ * 内部结点的第0个key不参与比较：第0个孩子负责下界以上、第1个key以下的所有key，
+ * 最左边的内部结点的第0个key在更小的key插入后不会更新
+ */
+template <bool UPPER>
+int IxNodeHandle::packed_search(const char *target) const {
+    int first = is_leaf_page() ? 0 : std::min(get_size(), 1);
+    int n = get_size() - first;
+    int prefix_len = page_hdr->prefix_len;
+    int res = memcmp(target, page->get_data() + sizeof(IxPageHdr), prefix_len);
+    if (n == 0 || res != 0) {
+        return res < 0 ? first : first + n;
+    }
+    const char *target_suffix = target + prefix_len;
+    int target_len = packed_suffix_len(file_hdr, target, prefix_len);
+    auto before = [&](int i) {
+        int cmp = ix_compare_sig(suffix(first + i), suffix_len(first + i),
+                                 target_suffix, target_len);
+        return UPPER ? cmp <= 0 : cmp < 0;
+    };
+    int base = ix_narrow(n, 1, before);
+    return first + base + before(base);
+}
+
+/**
+ * @brief 变长格式下在pos位置插入一个键值对，数据区空间不连续时先整理
+ * @note 调用者保证结点未满，且key在结点的范围内
+ */
+void IxNodeHandle::packed_insert(int pos, const char *key, const Rid &rid) {
+    int size = get_size();
+    int prefix_len = page_hdr->prefix_len;
+    assert(memcmp(key, page->get_data() + sizeof(IxPageHdr), prefix_len) == 0);
+    uint16_t len = packed_suffix_len(file_hdr, key, prefix_len);
+    int bytes = packed_entry_bytes(len);
+    int slot_end = packed_header_bytes(prefix_len, page_hdr->low_len,
+                                       page_hdr->high_len) +
+                   (size + 1) * sizeof(uint16_t);
+    if (page_hdr->heap_offset - bytes < slot_end) {
+        compact();
+    }
+    assert(page_hdr->heap_offset - bytes >= slot_end);
+    page_hdr->heap_offset -= bytes;
+    char *entry = page->get_data() + page_hdr->heap_offset;
+    memcpy(entry, &rid, sizeof(Rid));
+    memcpy(entry + sizeof(Rid), &len, sizeof(uint16_t));
+    memcpy(entry + sizeof(Rid) + sizeof(uint16_t), key + prefix_len, len);
+    uint16_t *slots = slot_array();
+    memmove(slots + pos + 1, slots + pos, (size - pos) * sizeof(uint16_t));
+    slots[pos] = page_hdr->heap_offset;
+    page_hdr->data_bytes += bytes;
+    set_size(size + 1);
+}
+
+/**
+ * @brief 整理变长格式的数据区，去掉删除键值对后留下的空洞
+ */
+void IxNodeHandle::compact() {
+    char buf[PAGE_SIZE];
+    uint16_t *slots = slot_array();
+    int offset = PAGE_SIZE;
+    for (int i = 0; i < get_size(); i++) {
+        int bytes = packed_entry_bytes(suffix_len(i));
+        offset -= bytes;
+        memcpy(buf + offset, page->get_data() + slots[i], bytes);
+        slots[i] = offset;
+    }
+    memcpy(page->get_data() + offset, buf + offset, PAGE_SIZE - offset);
+    page_hdr->heap_offset = offset;
 }
 
 IxIndexHandle::IxIndexHandle(DiskManager *disk_manager,
@@ -150,17 +502,38 @@ IxIndexHandle::IxIndexHandle(DiskManager *disk_manager,
       buffer_pool_manager_(buffer_pool_manager),
       fd_(fd) {
     // init file_hdr_
-    disk_manager_->read_page(fd, IX_FILE_HDR_PAGE, (char *)&file_hdr_,
-                             sizeof(file_hdr_));
-    char *buf = new char[PAGE_SIZE];
+    char buf[PAGE_SIZE];
     memset(buf, 0, PAGE_SIZE);
     disk_manager_->read_page(fd, IX_FILE_HDR_PAGE, buf, PAGE_SIZE);
     file_hdr_ = new IxFileHdr();
     file_hdr_->deserialize(buf);
 
-    // disk_manager管理的fd对应的文件中，设置从file_hdr_->num_pages开始分配page_no
-    int now_page_no = disk_manager_->get_fd2pageno(fd);
-    disk_manager_->set_fd2pageno(fd, now_page_no + 1);
+    // disk_manager管理的fd对应的文件中，从文件末尾开始分配page_no
+    // 关闭索引时所有页面都已刷盘，文件长度覆盖了所有在用的页面
+    int num_pages =
+        disk_manager_->get_file_size(disk_manager_->get_file_name(fd)) /
+        PAGE_SIZE;
+    disk_manager_->set_fd2pageno(fd, std::max(num_pages, IX_INIT_NUM_PAGES));
+
+    if (file_hdr_->bloom_num_blocks_ > 0) {
+        blooms_.push_back(std::make_unique<IxBloomFilter>(file_hdr_->bloom_num_blocks_));
+        IxBloomFilter *bloom = blooms_.back().get();
+        char *data = bloom->data();
+        for (size_t offset = 0; offset < bloom->size_bytes(); offset += PAGE_SIZE) {
+            int len = std::min<size_t>(PAGE_SIZE, bloom->size_bytes() - offset);
+            disk_manager_->read_page(fd, file_hdr_->bloom_first_page_ + offset / PAGE_SIZE,
+                                     data + offset, len);
+        }
+        bloom_ = bloom;
+        bloom_num_keys_ = file_hdr_->bloom_num_keys_;
+    }
+    pin_upper_levels();
+}
+
+IxIndexHandle::~IxIndexHandle() {
+    if (change_buffer_ != nullptr) {
+        IxChangeBufferMerger::instance().remove(this);
+    }
 }
 
 /**
@@ -168,19 +541,216 @@ IxIndexHandle::IxIndexHandle(DiskManager *disk_manager,
  * @param key 要查找的目标key值
  * @param operation 查找到目标键值对后要进行的操作类型
  * @param transaction 事务参数，如果不需要则默认传入nullptr
+ * @param find_first/find_last 只用于FIND，忽略key，找第一个/最后一个叶结点
  * @return [leaf node] and [root_is_latched] 返回目标叶子结点以及根结点是否加锁
  * @note need to Unlatch and unpin the leaf node outside!
  * 注意：用了FindLeafPage之后一定要unlatch叶结点，否则下次latch该结点会堵塞！
  */
 std::pair<IxNodeHandle *, bool> IxIndexHandle::find_leaf_page(
     const char *key, Operation operation, Transaction *transaction,
-    bool find_first) {
-    // Todo:
-    // 1. 获取根节点
-    // 2. 从根节点开始不断向下查找目标key
-    // 3. 找到包含该key值的叶子结点停止查找，并返回叶子节点
+    bool find_first, bool find_last) {
+    if (operation == Operation::FIND) {
+        // 读锁蟹行：先给孩子加读锁再释放父结点，根结点加锁后即可释放根锁
+        // 常驻的上层结点只能在持有根锁时使用，离开常驻的层之后再释放根锁
+        std::shared_lock root_lock{root_latch_};
+        if (resident_stale()) {
+            root_lock.unlock();
+            try_refresh_upper_levels();
+            root_lock.lock();
+        }
+        IxNodeHandle *node = fetch_upper_node(file_hdr_->root_page_);
+        node->page->rlatch();
+        if (!node->resident) {
+            root_lock.unlock();
+        }
+        while (!node->is_leaf_page()) {
+            page_id_t child_page_no;
+            if (find_first || find_last) {
+                child_page_no = node->value_at(find_first ? 0 : node->get_size() - 1);
+            } else {
+                child_page_no = node->internal_lookup(key);
+            }
+            IxNodeHandle *child = root_lock.owns_lock()
+                                      ? fetch_upper_node(child_page_no)
+                                      : fetch_node(child_page_no);
+            child->page->rlatch();
+            node->page->runlatch();
+            unpin_node(node, false);
+            if (!child->resident && root_lock.owns_lock()) {
+                root_lock.unlock();
+            }
+            node = child;
+        }
+        return std::make_pair(node, false);
+    }
+
+    // 悲观写：独占根锁，自顶向下给经过的结点加写锁并记入事务的latch集合，
+    // 一旦某个结点是安全的(不会分裂或下溢，也不会改变第一个key)，就释放它的所有祖先
+    root_latch_.lock();
+    bool root_is_latched = true;
+    if (resident_stale()) {
+        pin_upper_levels();
+    }
+    IxNodeHandle *node = fetch_latched_node(file_hdr_->root_page_, transaction);
+    if (is_safe(node, key, operation)) {
+        release_latched_pages(transaction, &root_is_latched, true);
+    }
+    while (!node->is_leaf_page()) {
+        int child_idx = std::max(node->upper_bound(key) - 1, 0);
+        // 删除可能引起合并或重分配，在持有父结点时按从左到右的顺序锁住会用到的兄弟结点，
+        // 之后不再需要向左等待，从而避免与向右修改叶结点链表的线程死锁
+        if (operation == Operation::DELETE && child_idx > 0) {
+            unpin_node(fetch_latched_node(node->value_at(child_idx - 1), transaction),
+                       false);
+        }
+        IxNodeHandle *child =
+            fetch_latched_node(node->value_at(child_idx), transaction);
+        if (is_safe(child, key, operation)) {
+            release_latched_pages(transaction, &root_is_latched, true);
+        } else if (operation == Operation::DELETE && child_idx == 0 &&
+                   node->get_size() > 1) {
+            unpin_node(fetch_latched_node(node->value_at(1), transaction), false);
+        }
+        unpin_node(node, false);
+        node = child;
+    }
+    return std::make_pair(node, root_is_latched);
+}
 
-    return std::make_pair(nullptr, false);
+/**
+ * @brief 乐观写时查找叶结点：内部结点只加读锁蟹行，最后给叶结点加写锁
+ * 调用者确认叶结点安全后可以直接修改，否则释放叶结点改用find_leaf_page()悲观重试
+ * @note need to wunlatch and unpin the leaf node outside!
+ */
+IxNodeHandle *IxIndexHandle::find_leaf_page_optimistic(const char *key, bool resident_only) {
+    std::shared_lock root_lock{root_latch_};
+    if (resident_stale()) {
+        root_lock.unlock();
+        try_refresh_upper_levels();
+        root_lock.lock();
+    }
+    IxNodeHandle *node = fetch_upper_node(file_hdr_->root_page_);
+    if (node->is_leaf_page()) {
+        node->page->wlatch();
+        return node;
+    }
+    node->page->rlatch();
+    if (!node->resident) {
+        root_lock.unlock();
+    }
+    while (true) {
+        page_id_t child_page_no = node->internal_lookup(key);
+        if (resident_only &&
+            !(root_lock.owns_lock() && resident_pages_.count(child_page_no) > 0) &&
+            !buffer_pool_manager_->is_resident(PageId{fd_, child_page_no})) {
+            // 常驻的上层结点一定在缓冲池中，其余结点在路径上第一个不在缓冲池中的结点处停止，不为此读盘
+            node->page->runlatch();
+            unpin_node(node, false);
+            return nullptr;
+        }
+        IxNodeHandle *child = root_lock.owns_lock()
+                                  ? fetch_upper_node(child_page_no)
+                                  : fetch_node(child_page_no);
+        // 持有父结点的读锁时孩子不会被删除，结点是否为叶结点在页面的生命周期内不变
+        bool is_leaf = child->is_leaf_page();
+        if (is_leaf) {
+            child->page->wlatch();
+        } else {
+            child->page->rlatch();
+        }
+        node->page->runlatch();
+        unpin_node(node, false);
+        if (!child->resident && root_lock.owns_lock()) {
+            root_lock.unlock();
+        }
+        if (is_leaf) {
+            return child;
+        }
+        node = child;
+    }
+}
+
+/**
+ * @brief 判断结点对于一次插入/删除key是否安全
+ * 安全结点不会分裂或下溢，其第一个key也不会改变，因此修改不会传播到祖先结点
+ */
+bool IxIndexHandle::is_safe(IxNodeHandle *node, const char *key,
+                            Operation operation) {
+    if (operation == Operation::INSERT) {
+        if (file_hdr_->packed_) {
+            // 变长格式中父结点的key是孩子的下界，在结点开头插入也不需要修改祖先
+            return node->free_bytes() >= 2 * node->max_entry_bytes();
+        }
+        if (node->get_size() + 1 >= node->get_max_size()) {
+            return false;
+        }
+        return node->is_root_page() || node->upper_bound(key) > 0;
+    }
+    if (file_hdr_->packed_ && !node->is_leaf_page() &&
+        node->free_bytes() < 2 * node->max_entry_bytes()) {
+        // 变长格式下孩子重分配后父结点中的分隔键可能变长，放不下时要分裂父结点，需要保留它的祖先
+        return false;
+    }
+    if (node->is_root_page()) {
+        // 根叶结点允许为空；内部根结点只剩一个孩子时会被adjust_root()替换
+        return node->is_leaf_page() || node->get_size() > 2;
+    }
+    if (file_hdr_->packed_) {
+        return node->entry_bytes() - node->max_entry_bytes() >=
+               node->min_entry_bytes();
+    }
+    return node->get_size() > node->get_min_size() && !node->key_equals(0, key);
+}
+
+/**
+ * @brief 获取一个加了写锁的结点，页面记入事务的latch集合并由集合持有一次pin
+ * 已经在集合中的页面不会重复加锁
+ * @note 返回的结点句柄还需要在函数外面unpin
+ */
+IxNodeHandle *IxIndexHandle::fetch_latched_node(int page_no,
+                                                Transaction *transaction) {
+    IxNodeHandle *node = fetch_node(page_no);
+    auto page_set = transaction->get_index_latch_page_set();
+    if (std::find(page_set->begin(), page_set->end(), node->page) ==
+        page_set->end()) {
+        node->page->wlatch();
+        buffer_pool_manager_->fetch_page(node->get_page_id());
+        transaction->append_index_latch_page_set(node->page);
+    }
+    return node;
+}
+
+/**
+ * @brief 释放事务latch集合中的页面：解写锁并unpin，根锁仍被持有时一并释放
+ * @param keep_last 为true时保留集合中最后一个页面(当前结点)，只释放它的祖先
+ * 全部释放时再真正删除本次操作中被删除的页面，保证删除时其他线程已不可能持有或等待这些页面
+ */
+void IxIndexHandle::release_latched_pages(Transaction *transaction,
+                                          bool *root_is_latched,
+                                          bool keep_last) {
+    auto page_set = transaction->get_index_latch_page_set();
+    std::vector<PageId> deleted_page_ids;
+    if (!keep_last) {
+        auto deleted_page_set = transaction->get_index_deleted_page_set();
+        for (Page *page : *deleted_page_set) {
+            deleted_page_ids.push_back(page->get_page_id());
+        }
+        deleted_page_set->clear();
+    }
+    size_t num_kept = keep_last ? 1 : 0;
+    while (page_set->size() > num_kept) {
+        Page *page = page_set->front();
+        page_set->pop_front();
+        page->wunlatch();
+        buffer_pool_manager_->unpin_page(page->get_page_id(), false);
+    }
+    if (*root_is_latched) {
+        root_latch_.unlock();
+        *root_is_latched = false;
+    }
+    for (auto &page_id : deleted_page_ids) {
+        buffer_pool_manager_->delete_page(page_id);
+    }
 }
 
 /**
@@ -193,13 +763,35 @@ std::pair<IxNodeHandle *, bool> IxIndexHandle::find_leaf_page(
  */
 bool IxIndexHandle::get_value(const char *key, std::vector<Rid> *result,
                               Transaction *transaction) {
-    // Todo:
-    // 1. 获取目标key值所在的叶子结点
-    // 2. 在叶子节点中查找目标key值的位置，并读取key对应的rid
-    // 3. 把rid存入result参数中
-    // 提示：使用完buffer_pool提供的page之后，记得unpin page；记得处理并发的上锁
-
-    return false;
+    merge_range(key, key);
+    // 过滤器判定不存在时不访问任何页面
+    if (!may_contain(key)) {
+        return false;
+    }
+    char buf[IX_MAX_COL_LEN];
+    key = index_key(key, buf);
+    uint64_t ahi_hash = IxAdaptiveHash::hash(key, file_hdr_->col_tot_len_);
+    bool hot = false;
+    Rid ahi_rid;
+    if (adaptive_lookup(key, ahi_hash, &ahi_rid, &hot)) {
+        result->push_back(ahi_rid);
+        return true;
+    }
+    auto [leaf, root_is_latched] =
+        find_leaf_page(key, Operation::FIND, transaction);
+    Rid *rid;
+    bool found = leaf->leaf_lookup(key, &rid);
+    if (found) {
+        result->push_back(*rid);
+        if (hot) {
+            // 持有叶结点读锁时读取纪元号，之后的分裂等操作都会使这一项失效
+            ahi_.record(ahi_hash, {leaf->get_page_no(), leaf->lower_bound(key),
+                                   ahi_.page_epoch(leaf->get_page_no())});
+        }
+    }
+    leaf->page->runlatch();
+    unpin_node(leaf, false);
+    return found;
 }
 
 /**
@@ -211,15 +803,127 @@ bool IxIndexHandle::get_value(const char *key, std::vector<Rid> *result,
  * 注意：本函数执行完毕后，原node和new node都需要在函数外面进行unpin
  */
 IxNodeHandle *IxIndexHandle::split(IxNodeHandle *node) {
-    // Todo:
-    // 1. 将原结点的键值对平均分配，右半部分分裂为新的右兄弟结点
-    //    需要初始化新节点的page_hdr内容
-    // 2. 如果新的右兄弟结点是叶子结点，更新新旧节点的prev_leaf和next_leaf指针
-    //    为新节点分配键值对，更新旧节点的键值对数记录
-    // 3.
-    // 如果新的右兄弟结点不是叶子结点，更新该结点的所有孩子结点的父节点信息(使用IxIndexHandle::maintain_child())
+    if (node->is_leaf_page()) {
+        leaf_smo_count_++;
+        invalidate_leaf(node);
+    } else {
+        upper_smo_count_++;
+    }
+    IxNodeHandle *new_node = create_node();
+    new_node->page_hdr->next_free_page_no = IX_NO_PAGE;
+    new_node->page_hdr->is_leaf = node->is_leaf_page();
+    new_node->set_parent_page_no(node->get_parent_page_no());
+    new_node->set_size(0);
+
+    if (file_hdr_->packed_) {
+        split_packed(node, new_node);
+    } else {
+        // 左半部分保留min_size个键值对，其余移动到新结点
+        int pos = node->get_min_size();
+        new_node->insert_pairs(0, node->get_key(pos), node->get_rid(pos),
+                               node->get_size() - pos, node->get_payload(pos));
+        node->set_size(pos);
+    }
 
-    return nullptr;
+    if (new_node->is_leaf_page()) {
+        new_node->set_prev_leaf(node->get_page_no());
+        new_node->set_next_leaf(node->get_next_leaf());
+        // 后继叶结点只短暂加锁修改prev指针，持有期间不再等待其他锁
+        IxNodeHandle *next = fetch_node(node->get_next_leaf());
+        next->page->wlatch();
+        next->set_prev_leaf(new_node->get_page_no());
+        next->page->wunlatch();
+        unpin_node(next, true);
+        node->set_next_leaf(new_node->get_page_no());
+        if (file_hdr_->last_leaf_ == node->get_page_no()) {
+            file_hdr_->last_leaf_ = new_node->get_page_no();
+        }
+    } else {
+        for (int i = 0; i < new_node->get_size(); i++) {
+            maintain_child(new_node, i);
+        }
+    }
+    return new_node;
+}
+
+/**
+ * @brief 变长格式下在位置pos处分成[0, pos)和[pos, n)时的分隔键，返回分隔键的有效长度
+ * 叶结点的分隔键取能区分左右两边的最短前缀，内部结点的分隔键就是右边第一个key
+ */
+static int packed_separator(const IxFileHdr *file_hdr, bool is_leaf,
+                            const char *keys, int pos, char *sep) {
+    int key_len = file_hdr->col_tot_len_;
+    if (is_leaf) {
+        return ix_shortest_separator(keys + (pos - 1) * key_len,
+                                     keys + pos * key_len, key_len, sep);
+    }
+    memcpy(sep, keys + pos * key_len, key_len);
+    return ix_key_sig_len(sep, key_len);
+}
+
+/**
+ * @brief 变长格式下选择分裂位置，左边为[0, pos)，右边为[pos, n)
+ * 先找到使两边字节数大致相等的位置，再在它附近选取分隔键最短的位置；
+ * 叶结点的分隔键取能区分左右两边的最短前缀，内部结点的分隔键就是右边第一个key
+ *
+ * @param sep 传出参数，右边的下界，也就是要插入父结点的key
+ */
+static int packed_split_pos(const IxFileHdr *file_hdr, bool is_leaf,
+                            const char *keys, int n, int prefix_len,
+                            char *sep) {
+    assert(n >= 2);
+    int key_len = file_hdr->col_tot_len_;
+    std::vector<int> bytes(n + 1, 0);
+    for (int i = 0; i < n; i++) {
+        bytes[i + 1] = bytes[i] + sizeof(uint16_t) +
+                       packed_entry_bytes(packed_suffix_len(
+                           file_hdr, keys + i * key_len, prefix_len));
+    }
+    int mid = 1;
+    while (mid < n - 1 && bytes[mid] * 2 < bytes[n]) {
+        mid++;
+    }
+    auto separator = [&](int pos) {
+        return packed_separator(file_hdr, is_leaf, keys, pos, sep);
+    };
+    int window = n / 16;
+    int best = mid;
+    int best_len = separator(mid);
+    for (int pos = std::max(1, mid - window);
+         pos <= std::min(n - 1, mid + window); pos++) {
+        int len = separator(pos);
+        if (len < best_len ||
+            (len == best_len && std::abs(pos - mid) < std::abs(best - mid))) {
+            best = pos;
+            best_len = len;
+        }
+    }
+    separator(best);
+    return best;
+}
+
+/**
+ * @brief 变长格式下分裂结点：node的范围[low, high)在分隔键sep处分成[low, sep)和[sep, high)，
+ * 两个结点的范围都变小，前缀只会变长，键值对占用的空间不会增加
+ */
+void IxIndexHandle::split_packed(IxNodeHandle *node, IxNodeHandle *new_node) {
+    int key_len = file_hdr_->col_tot_len_;
+    std::vector<char> keys;
+    std::vector<Rid> rids;
+    node->get_pairs(&keys, &rids);
+    std::vector<char> low(key_len), high(key_len), sep(key_len);
+    bool has_low = node->get_low_key(low.data());
+    bool has_high = node->get_high_key(high.data());
+    int n = rids.size();
+    int pos = packed_split_pos(file_hdr_, node->is_leaf_page(), keys.data(), n,
+                               node->page_hdr->prefix_len, sep.data());
+
+    node->reset(has_low ? low.data() : nullptr, sep.data());
+    node->insert_pairs(0, keys.data(), rids.data(), pos);
+    new_node->reset(sep.data(), has_high ? high.data() : nullptr);
+    new_node->insert_pairs(0, keys.data() + pos * key_len, rids.data() + pos,
+                           n - pos);
+    assert(!node->is_full() && !new_node->is_full());
 }
 
 /**
@@ -240,48 +944,223 @@ IxNodeHandle *IxIndexHandle::split(IxNodeHandle *node) {
 void IxIndexHandle::insert_into_parent(IxNodeHandle *old_node, const char *key,
                                        IxNodeHandle *new_node,
                                        Transaction *transaction) {
-    // Todo:
-    // 1. 分裂前的结点（原结点,
-    // old_node）是否为根结点，如果为根结点需要分配新的root
-    // 2. 获取原结点（old_node）的父亲结点
-    // 3. 获取key对应的rid，并将(key, rid)插入到父亲结点
-    // 4. 如果父亲结点仍需要继续分裂，则进行递归插入
-    // 提示：记得unpin page
+    if (old_node->is_root_page()) {
+        IxNodeHandle *new_root = create_node();
+        new_root->page_hdr->next_free_page_no = IX_NO_PAGE;
+        new_root->page_hdr->is_leaf = false;
+        new_root->set_parent_page_no(IX_NO_PAGE);
+        new_root->set_prev_leaf(IX_NO_PAGE);
+        new_root->set_next_leaf(IX_NO_PAGE);
+        new_root->reset(nullptr, nullptr);
+        std::vector<char> first_key(file_hdr_->col_tot_len_);
+        old_node->get_separator(first_key.data());
+        new_root->insert_pair(0, first_key.data(),
+                              Rid{old_node->get_page_no(), -1});
+        new_root->insert_pair(1, key, Rid{new_node->get_page_no(), -1});
+        old_node->set_parent_page_no(new_root->get_page_no());
+        new_node->set_parent_page_no(new_root->get_page_no());
+        update_root_page_no(new_root->get_page_no());
+        unpin_node(new_root, true);
+        return;
+    }
+
+    IxNodeHandle *parent =
+        fetch_latched_node(old_node->get_parent_page_no(), transaction);
+    int rank = parent->find_child(old_node);
+    parent->insert_pair(rank + 1, key, Rid{new_node->get_page_no(), -1});
+    new_node->set_parent_page_no(parent->get_page_no());
+    if (parent->is_full()) {
+        IxNodeHandle *new_parent = split(parent);
+        std::vector<char> separator(file_hdr_->col_tot_len_);
+        new_parent->get_separator(separator.data());
+        insert_into_parent(parent, separator.data(), new_parent, transaction);
+        unpin_node(new_parent, true);
+    }
+    unpin_node(parent, true);
 }
 
 /**
- * @brief 将指定键值对插入到B+树中
+ * @brief 将指定键值对插入到B+树中；启用了修改缓冲且key所在的叶结点不在缓冲池中时只缓存这次插入
  * @param (key, value) 要插入的键值对
  * @param transaction 事务指针
- * @return page_id_t 插入到的叶结点的page_no
+ * @return page_id_t 插入到的叶结点的page_no，键已存在或插入被缓存时为IX_NO_PAGE
  */
 page_id_t IxIndexHandle::insert_entry(const char *key, const Rid &value,
                                       Transaction *transaction) {
-    // Todo:
-    // 1. 查找key值应该插入到哪个叶子节点
-    // 2. 在该叶子节点中插入键值对
-    // 3. 如果结点已满，分裂结点，并把新结点的相关信息插入父节点
-    // 提示：记得unpin
-    // page；若当前叶子节点是最右叶子节点，则需要更新file_hdr_.last_leaf；记得处理并发的上锁
+    // 直接修改B+树也共享加锁，重建布隆过滤器时独占加锁，期间B+树不变
+    std::shared_lock merge_lock{merge_latch_};
+    if (change_buffer_ == nullptr) {
+        return insert_into_tree(key, value, transaction);
+    }
+    // 先加入过滤器再缓存，合并之前就能查到缓存的键
+    IxBloomFilter *bloom = bloom_;
+    if (bloom != nullptr) {
+        bloom->insert(bloom_hash(key, false));
+    }
+    // key上已有缓存的修改时继续缓存；否则沿缓冲池中的结点下降，叶结点在缓冲池中就在这次下降中直接插入
+    if (!change_buffer_->add_insert(key, value, true)) {
+        bool resident = true;
+        page_id_t page_no = insert_into_tree(key, value, transaction, &resident);
+        if (resident || !change_buffer_->add_insert(key, value, false)) {
+            return resident ? page_no : insert_into_tree(key, value, transaction);
+        }
+    }
+    if (change_buffer_->size() >= IX_CHANGE_BUFFER_CAPACITY / 2) {
+        IxChangeBufferMerger::instance().notify();
+    }
+    return IX_NO_PAGE;
+}
+
+page_id_t IxIndexHandle::insert_into_tree(const char *key, const Rid &value,
+                                          Transaction *transaction, bool *resident) {
+    // 先加入过滤器再插入，键在树中可见时一定已在过滤器中
+    IxBloomFilter *bloom = bloom_;
+    if (bloom != nullptr) {
+        bloom->insert(bloom_hash(key, false));
+    }
+    const char *payload = key + file_hdr_->col_tot_len_;
+    char buf[IX_MAX_COL_LEN];
+    key = index_key(key, buf);
+    // 乐观插入：只给叶结点加写锁，插入后不分裂且不改变第一个key时直接完成
+    IxNodeHandle *leaf = find_leaf_page_optimistic(key, resident != nullptr);
+    if (leaf == nullptr) {
+        *resident = false;
+        return IX_NO_PAGE;
+    }
+    int pos = leaf->lower_bound(key);
+    bool exists = pos < leaf->get_size() && leaf->key_equals(pos, key);
+    if (exists || is_safe(leaf, key, Operation::INSERT)) {
+        page_id_t page_no = IX_NO_PAGE;
+        if (!exists) {
+            leaf->insert_pair(pos, key, value, payload);
+            page_no = leaf->get_page_no();
+        }
+        leaf->page->wunlatch();
+        unpin_node(leaf, !exists);
+        if (!exists) {
+            count_bloom_key();
+        }
+        return page_no;
+    }
+    leaf->page->wunlatch();
+    unpin_node(leaf, false);
 
-    return -1;
+    // 悲观插入：重新自顶向下加写锁查找，期间树可能已被其他线程修改
+    std::unique_ptr<Transaction> local_txn;
+    if (transaction == nullptr) {
+        local_txn = std::make_unique<Transaction>(INVALID_TXN_ID);
+        transaction = local_txn.get();
+    }
+    bool root_is_latched;
+    std::tie(leaf, root_is_latched) =
+        find_leaf_page(key, Operation::INSERT, transaction);
+    pos = leaf->lower_bound(key);
+    if (pos < leaf->get_size() && leaf->key_equals(pos, key)) {
+        unpin_node(leaf, false);
+        release_latched_pages(transaction, &root_is_latched);
+        return IX_NO_PAGE;
+    }
+    leaf->insert_pair(pos, key, value, payload);
+    if (pos == 0 && !file_hdr_->packed_) {
+        maintain_parent(leaf);
+    }
+
+    page_id_t page_no = leaf->get_page_no();
+    if (leaf->is_full()) {
+        IxNodeHandle *new_leaf = split(leaf);
+        if (pos >= leaf->get_size()) {
+            page_no = new_leaf->get_page_no();
+        }
+        std::vector<char> separator(file_hdr_->col_tot_len_);
+        new_leaf->get_separator(separator.data());
+        insert_into_parent(leaf, separator.data(), new_leaf, transaction);
+        unpin_node(new_leaf, true);
+    }
+    unpin_node(leaf, true);
+    release_latched_pages(transaction, &root_is_latched);
+    count_bloom_key();
+    return page_no;
 }
 
 /**
- * @brief 用于删除B+树中含有指定key的键值对
+ * @brief 用于删除B+树中含有指定key的键值对；启用了修改缓冲且key所在的叶结点不在缓冲池中时只缓存这次删除
  * @param key 要删除的key值
  * @param transaction 事务指针
+ * @return 是否删除了键，删除被缓存时返回true
  */
 bool IxIndexHandle::delete_entry(const char *key, Transaction *transaction) {
-    // Todo:
-    // 1. 获取该键值对所在的叶子结点
-    // 2. 在该叶子结点中删除键值对
-    // 3.
-    // 如果删除成功需要调用CoalesceOrRedistribute来进行合并或重分配操作，并根据函数返回结果判断是否有结点需要删除
-    // 4.
-    // 如果需要并发，并且需要删除叶子结点，则需要在事务的delete_page_set中添加删除结点的对应页面；记得处理并发的上锁
+    if (!may_contain(key)) {
+        return false;
+    }
+    std::shared_lock merge_lock{merge_latch_};
+    if (change_buffer_ == nullptr) {
+        return delete_from_tree(key, transaction);
+    }
+    if (!change_buffer_->add_delete(key, true)) {
+        bool resident = true;
+        bool found = delete_from_tree(key, transaction, &resident);
+        if (resident || !change_buffer_->add_delete(key, false)) {
+            return resident ? found : delete_from_tree(key, transaction);
+        }
+    }
+    if (change_buffer_->size() >= IX_CHANGE_BUFFER_CAPACITY / 2) {
+        IxChangeBufferMerger::instance().notify();
+    }
+    return true;
+}
 
-    return false;
+bool IxIndexHandle::delete_from_tree(const char *key, Transaction *transaction, bool *resident) {
+    if (!may_contain(key)) {
+        return false;
+    }
+    char buf[IX_MAX_COL_LEN];
+    key = index_key(key, buf);
+    ahi_.erase(IxAdaptiveHash::hash(key, file_hdr_->col_tot_len_));
+    // 乐观删除：只给叶结点加写锁，删除后不下溢且删除的不是第一个key时直接完成
+    IxNodeHandle *leaf = find_leaf_page_optimistic(key, resident != nullptr);
+    if (leaf == nullptr) {
+        *resident = false;
+        return false;
+    }
+    int pos = leaf->lower_bound(key);
+    bool found = pos < leaf->get_size() && leaf->key_equals(pos, key);
+    if (!found || is_safe(leaf, key, Operation::DELETE)) {
+        if (found) {
+            leaf->erase_pair(pos);
+        }
+        leaf->page->wunlatch();
+        unpin_node(leaf, found);
+        return found;
+    }
+    leaf->page->wunlatch();
+    unpin_node(leaf, false);
+
+    // 悲观删除
+    std::unique_ptr<Transaction> local_txn;
+    if (transaction == nullptr) {
+        local_txn = std::make_unique<Transaction>(INVALID_TXN_ID);
+        transaction = local_txn.get();
+    }
+    bool root_is_latched;
+    std::tie(leaf, root_is_latched) =
+        find_leaf_page(key, Operation::DELETE, transaction);
+    pos = leaf->lower_bound(key);
+    if (pos == leaf->get_size() || !leaf->key_equals(pos, key)) {
+        unpin_node(leaf, false);
+        release_latched_pages(transaction, &root_is_latched);
+        return false;
+    }
+    leaf->erase_pair(pos);
+    if (pos == 0 && leaf->get_size() > 0 && !file_hdr_->packed_) {
+        maintain_parent(leaf);
+    }
+    if (coalesce_or_redistribute(leaf, transaction, &root_is_latched)) {
+        delete_node(leaf, transaction);
+    } else {
+        unpin_node(leaf, true);
+    }
+    release_latched_pages(transaction, &root_is_latched);
+    return true;
 }
 
 /**
@@ -298,20 +1177,61 @@ bool IxIndexHandle::delete_entry(const char *key, Transaction *transaction) {
 bool IxIndexHandle::coalesce_or_redistribute(IxNodeHandle *node,
                                              Transaction *transaction,
                                              bool *root_is_latched) {
-    // Todo:
-    // 1. 判断node结点是否为根节点
-    //    1.1 如果是根节点，需要调用AdjustRoot()
-    //    函数来进行处理，返回根节点是否需要被删除 1.2
-    //    如果不是根节点，并且不需要执行合并或重分配操作，则直接返回false，否则执行2
-    // 2. 获取node结点的父亲结点
-    // 3. 寻找node结点的兄弟结点（优先选取前驱结点）
-    // 4.
-    // 如果node结点和兄弟结点的键值对数量之和，能够支撑两个B+树结点（即node.size+neighbor.size
-    // >= NodeMinSize*2)，则只需要重新分配键值对（调用Redistribute函数）
-    // 5.
-    // 如果不满足上述条件，则需要合并两个结点，将右边的结点合并到左边的结点（调用Coalesce函数）
+    if (node->is_root_page()) {
+        return adjust_root(node, transaction);
+    }
+    if (!node->is_underflow()) {
+        return false;
+    }
 
-    return false;
+    // 优先选取前驱结点作为兄弟，node是第0个孩子时选取后继结点
+    // 父结点和兄弟结点在悲观查找时都已加写锁
+    IxNodeHandle *parent =
+        fetch_latched_node(node->get_parent_page_no(), transaction);
+    if (parent->get_size() == 1) {
+        // 旧版本变长格式的树中父结点可能因无法合并而只剩一个孩子，此时没有兄弟结点
+        unpin_node(parent, false);
+        return false;
+    }
+    int index = parent->find_child(node);
+    IxNodeHandle *neighbor = fetch_latched_node(
+        parent->value_at(index == 0 ? 1 : index - 1), transaction);
+
+    bool can_coalesce =
+        file_hdr_->packed_
+            ? can_coalesce_packed(index == 0 ? node : neighbor,
+                                  index == 0 ? neighbor : node)
+            : node->get_size() + neighbor->get_size() < node->get_min_size() * 2;
+    if (!can_coalesce) {
+        redistribute(neighbor, node, parent, index);
+        unpin_node(neighbor, true);
+        if (parent->is_full()) {
+            // 变长格式下新的分隔键可能更长，父结点满了就分裂；这时父结点不安全，祖先仍被锁住
+            IxNodeHandle *new_parent = split(parent);
+            std::vector<char> separator(file_hdr_->col_tot_len_);
+            new_parent->get_separator(separator.data());
+            insert_into_parent(parent, separator.data(), new_parent, transaction);
+            unpin_node(new_parent, true);
+        }
+        unpin_node(parent, true);
+        return false;
+    }
+
+    // coalesce()交换指针，保证返回后neighbor为左结点，node为被合并掉的右结点
+    bool parent_should_delete =
+        coalesce(&neighbor, &node, &parent, index, transaction, root_is_latched);
+    if (parent_should_delete) {
+        delete_node(parent, transaction);
+    } else {
+        unpin_node(parent, true);
+    }
+    if (index == 0) {
+        // 原node在左边被保留，由调用者unpin；被合并掉的是原来的后继结点
+        delete_node(node, transaction);
+        return false;
+    }
+    unpin_node(neighbor, true);
+    return true;
 }
 
 /**
@@ -321,13 +1241,17 @@ bool IxIndexHandle::coalesce_or_redistribute(IxNodeHandle *node,
  * @note size of root page can be less than min size and this method is only
  * called within coalesce_or_redistribute()
  */
-bool IxIndexHandle::adjust_root(IxNodeHandle *old_root_node) {
-    // Todo:
-    // 1.
-    // 如果old_root_node是内部结点，并且大小为1，则直接把它的孩子更新成新的根结点
-    // 2. 如果old_root_node是叶结点，且大小为0，则直接更新root page
-    // 3. 除了上述两种情况，不需要进行操作
-
+bool IxIndexHandle::adjust_root(IxNodeHandle *old_root_node,
+                                Transaction *transaction) {
+    if (!old_root_node->is_leaf_page() && old_root_node->get_size() == 1) {
+        page_id_t child_page_no = old_root_node->remove_and_return_only_child();
+        IxNodeHandle *child = fetch_latched_node(child_page_no, transaction);
+        child->set_parent_page_no(IX_NO_PAGE);
+        unpin_node(child, true);
+        update_root_page_no(child_page_no);
+        return true;
+    }
+    // 根结点是叶结点时即使为空也保留，空树由一个空的根叶结点表示
     return false;
 }
 
@@ -350,12 +1274,138 @@ bool IxIndexHandle::adjust_root(IxNodeHandle *old_root_node) {
 void IxIndexHandle::redistribute(IxNodeHandle *neighbor_node,
                                  IxNodeHandle *node, IxNodeHandle *parent,
                                  int index) {
-    // Todo:
-    // 1. 通过index判断neighbor_node是否为node的前驱结点
-    // 2. 从neighbor_node中移动一个键值对到node结点中
-    // 3.
-    // 更新父节点中的相关信息，并且修改移动键值对对应孩字结点的父结点信息（maintain_child函数）
-    // 注意：neighbor_node的位置不同，需要移动的键值对不同，需要分类讨论
+    if (node->is_leaf_page()) {
+        leaf_smo_count_++;
+        invalidate_leaf(node);
+        invalidate_leaf(neighbor_node);
+    }
+    if (file_hdr_->packed_) {
+        if (index == 0) {
+            redistribute_packed(node, neighbor_node, parent);
+        } else {
+            redistribute_packed(neighbor_node, node, parent);
+        }
+        return;
+    }
+    if (index == 0) {
+        // neighbor在右边，把它的第一个键值对移到node末尾
+        node->insert_pair(node->get_size(), neighbor_node->get_key(0),
+                          *neighbor_node->get_rid(0), neighbor_node->get_payload(0));
+        neighbor_node->erase_pair(0);
+        maintain_child(node, node->get_size() - 1);
+        maintain_parent(neighbor_node);
+        // node删除前可能已为空，此时它的第一个key也变了
+        maintain_parent(node);
+    } else {
+        // neighbor在左边，把它的最后一个键值对移到node开头
+        int last = neighbor_node->get_size() - 1;
+        node->insert_pair(0, neighbor_node->get_key(last), *neighbor_node->get_rid(last),
+                          neighbor_node->get_payload(last));
+        neighbor_node->erase_pair(last);
+        maintain_child(node, 0);
+        maintain_parent(node);
+    }
+}
+
+/**
+ * @brief 变长格式下判断两个相邻结点能否合并：合并后范围变大、前缀可能变短，按合并后的范围计算是否放得下
+ */
+bool IxIndexHandle::can_coalesce_packed(IxNodeHandle *left,
+                                        IxNodeHandle *right) {
+    int key_len = file_hdr_->col_tot_len_;
+    std::vector<char> keys, right_keys;
+    std::vector<Rid> rids, right_rids;
+    left->get_pairs(&keys, &rids);
+    right->get_pairs(&right_keys, &right_rids);
+    keys.insert(keys.end(), right_keys.begin(), right_keys.end());
+    std::vector<char> low(key_len), high(key_len);
+    bool has_low = left->get_low_key(low.data());
+    bool has_high = right->get_high_key(high.data());
+    return IxNodeHandle::packed_fits(file_hdr_, has_low ? low.data() : nullptr,
+                                     has_high ? high.data() : nullptr,
+                                     keys.data(), rids.size() + right_rids.size());
+}
+
+/**
+ * @brief 变长格式下重新分配两个相邻结点的键值对：把两边的键值对按字节数平分，
+ * 并用新的分隔键替换父结点中右结点对应的key
+ * 新的分隔键可能比原来的长，父结点不满时总放得下，替换后变满由调用者分裂父结点
+ */
+void IxIndexHandle::redistribute_packed(IxNodeHandle *left, IxNodeHandle *right,
+                                        IxNodeHandle *parent) {
+    int key_len = file_hdr_->col_tot_len_;
+    std::vector<char> keys, right_keys;
+    std::vector<Rid> rids, right_rids;
+    left->get_pairs(&keys, &rids);
+    right->get_pairs(&right_keys, &right_rids);
+    keys.insert(keys.end(), right_keys.begin(), right_keys.end());
+    rids.insert(rids.end(), right_rids.begin(), right_rids.end());
+    int n = rids.size();
+    if (n < 2) {
+        return;
+    }
+    std::vector<char> low(key_len), high(key_len), sep(key_len);
+    bool has_low = left->get_low_key(low.data());
+    bool has_high = right->get_high_key(high.data());
+    const char *low_key = has_low ? low.data() : nullptr;
+    const char *high_key = has_high ? high.data() : nullptr;
+    int prefix_len = 0;
+    if (has_low && has_high) {
+        prefix_len = ix_common_prefix(low_key, high_key, key_len);
+    }
+    int pos = packed_split_pos(file_hdr_, left->is_leaf_page(), keys.data(), n,
+                               prefix_len, sep.data());
+    auto half_bytes = [&](int pos, bool left_half) {
+        return left_half ? IxNodeHandle::packed_bytes(file_hdr_, low_key, sep.data(),
+                                                      keys.data(), pos)
+                         : IxNodeHandle::packed_bytes(file_hdr_, sep.data(), high_key,
+                                                      keys.data() + pos * key_len, n - pos);
+    };
+    if (half_bytes(pos, true) > PAGE_SIZE || half_bytes(pos, false) > PAGE_SIZE) {
+        // 两个结点的公共前缀很短时按它平分字节数并不准确，两半的前缀可能长短悬殊。
+        // 分隔键随pos增大，左半的前缀只会变短、右半的只会变长，因此左半的字节数随pos单调增加，
+        // 右半的单调减少：二分查找两者交叉的位置，取其中较大一半更小的一侧
+        int lo = 1, hi = n - 1;
+        while (lo < hi) {
+            int m = (lo + hi) / 2;
+            packed_separator(file_hdr_, left->is_leaf_page(), keys.data(), m, sep.data());
+            if (half_bytes(m, true) >= half_bytes(m, false)) {
+                hi = m;
+            } else {
+                lo = m + 1;
+            }
+        }
+        pos = lo;
+        int worst = PAGE_SIZE + 1;
+        for (int i = std::max(lo - 1, 1); i <= lo; i++) {
+            packed_separator(file_hdr_, left->is_leaf_page(), keys.data(), i, sep.data());
+            int bytes = std::max(half_bytes(i, true), half_bytes(i, false));
+            if (bytes < worst) {
+                worst = bytes;
+                pos = i;
+            }
+        }
+        if (worst > PAGE_SIZE) {
+            // 两个结点原来的分界处本来就放得下，正常不会走到这里
+            return;
+        }
+        packed_separator(file_hdr_, left->is_leaf_page(), keys.data(), pos, sep.data());
+    }
+    int rank = parent->find_child(right);
+
+    left->reset(low_key, sep.data());
+    left->insert_pairs(0, keys.data(), rids.data(), pos);
+    right->reset(sep.data(), high_key);
+    right->insert_pairs(0, keys.data() + pos * key_len, rids.data() + pos,
+                        n - pos);
+    for (int i = 0; i < left->get_size(); i++) {
+        maintain_child(left, i);
+    }
+    for (int i = 0; i < right->get_size(); i++) {
+        maintain_child(right, i);
+    }
+    parent->erase_pair(rank);
+    parent->insert_pair(rank, sep.data(), Rid{right->get_page_no(), -1});
 }
 
 /**
@@ -381,16 +1431,619 @@ void IxIndexHandle::redistribute(IxNodeHandle *neighbor_node,
 bool IxIndexHandle::coalesce(IxNodeHandle **neighbor_node, IxNodeHandle **node,
                              IxNodeHandle **parent, int index,
                              Transaction *transaction, bool *root_is_latched) {
-    // Todo:
-    // 1.
-    // 用index判断neighbor_node是否为node的前驱结点，若不是则交换两个结点，让neighbor_node作为左结点，node作为右结点
-    // 2.
-    // 把node结点的键值对移动到neighbor_node中，并更新node结点孩子结点的父节点信息（调用maintain_child函数）
-    // 3.
-    // 释放和删除node结点，并删除parent中node结点的信息，返回parent是否需要被删除
-    // 提示：如果是叶子结点且为最右叶子结点，需要更新file_hdr_.last_leaf
+    if ((*node)->is_leaf_page()) {
+        leaf_smo_count_++;
+        invalidate_leaf(*node);
+        invalidate_leaf(*neighbor_node);
+    } else {
+        upper_smo_count_++;
+    }
+    if (index == 0) {
+        std::swap(*neighbor_node, *node);
+    }
+    IxNodeHandle *left = *neighbor_node;
+    IxNodeHandle *right = *node;
 
-    return false;
+    int old_size = left->get_size();
+    if (file_hdr_->packed_) {
+        // 合并后的范围是[左结点的下界, 右结点的上界)，前缀可能变短，按新的范围重建左结点
+        std::vector<char> keys, right_keys;
+        std::vector<Rid> rids, right_rids;
+        left->get_pairs(&keys, &rids);
+        right->get_pairs(&right_keys, &right_rids);
+        keys.insert(keys.end(), right_keys.begin(), right_keys.end());
+        rids.insert(rids.end(), right_rids.begin(), right_rids.end());
+        std::vector<char> low(file_hdr_->col_tot_len_), high(file_hdr_->col_tot_len_);
+        bool has_low = left->get_low_key(low.data());
+        bool has_high = right->get_high_key(high.data());
+        left->reset(has_low ? low.data() : nullptr,
+                    has_high ? high.data() : nullptr);
+        left->insert_pairs(0, keys.data(), rids.data(), rids.size());
+    } else {
+        left->insert_pairs(old_size, right->get_key(0), right->get_rid(0),
+                           right->get_size(), right->get_payload(0));
+    }
+    for (int i = old_size; i < left->get_size(); i++) {
+        maintain_child(left, i);
+    }
+    if (old_size == 0 && !file_hdr_->packed_) {
+        // 保持父结点中的key与孩子的第一个key一致，并发删除判断结点是否安全依赖这一点
+        maintain_parent(left);
+    }
+    if (right->is_leaf_page()) {
+        if (file_hdr_->last_leaf_ == right->get_page_no()) {
+            file_hdr_->last_leaf_ = left->get_page_no();
+        }
+        erase_leaf(right, left);
+    }
+    (*parent)->erase_pair((*parent)->find_child(right));
+    return coalesce_or_redistribute(*parent, transaction, root_is_latched);
+}
+
+/**
+ * @brief 把n个项按每组capacity个依次分组，返回各组的大小
+ * 最后一组不足min_size时与前一组合并(合并后不超过max_size)或从前一组匀出一部分，
+ * 保证除唯一的一组(将成为根结点)外每组都不少于min_size
+ */
+static std::vector<int> bulk_group_sizes(int n, int capacity, int min_size,
+                                         int max_size) {
+    std::vector<int> sizes(n / capacity, capacity);
+    int rest = n % capacity;
+    if (rest == 0) {
+        return sizes;
+    }
+    if (sizes.empty() || rest >= min_size) {
+        sizes.push_back(rest);
+    } else if (capacity + rest <= max_size) {
+        sizes.back() += rest;
+    } else {
+        sizes.back() = capacity + rest - min_size;
+        sizes.push_back(min_size);
+    }
+    return sizes;
+}
+
+/**
+ * @brief 自底向上批量构建B+树，要求索引为空且next_entry按key升序给出(key, rid)
+ * 叶结点按填充因子依次装满并串成叶结点链表，然后逐层把下一层结点的第一个key和页面号装入内部结点，
+ * 每个key只访问一次，不需要从根结点查找叶结点，也没有结点分裂
+ *
+ * @param next_entry 取出下一项，没有更多的项时返回false
+ * @param fill_factor 结点的填充因子，实际装入的键数不少于min_size
+ * @return key不重复时返回true；遇到重复的key时停止装入并返回false，此时索引不完整，调用者应删除该索引
+ */
+bool IxIndexHandle::bulk_load(
+    const std::function<bool(char *, Rid *)> &raw_entry, double fill_factor) {
+    std::unique_lock root_lock{root_latch_};
+    ahi_.clear();
+    int key_len = file_hdr_->col_tot_len_;
+    std::vector<char> buf(file_hdr_->entry_len());
+    auto next_entry = [&](char *key, Rid *rid) {
+        if (!file_hdr_->normalized()) {
+            return raw_entry(key, rid);
+        }
+        if (!raw_entry(buf.data(), rid)) {
+            return false;
+        }
+        // 只规范化键，payload原样保留
+        index_key(buf.data(), key);
+        memcpy(key + key_len, buf.data() + key_len, file_hdr_->payload_len_);
+        return true;
+    };
+    if (file_hdr_->packed_) {
+        return bulk_load_packed(next_entry, fill_factor);
+    }
+    int max_keys = file_hdr_->btree_order_;  // 结点达到btree_order_+1个键时才分裂
+    int min_keys = (max_keys + 1) / 2;
+    int capacity =
+        std::clamp(static_cast<int>(fill_factor * max_keys), min_keys, max_keys);
+    // 带payload的叶结点容量更小，按leaf_order_装填；没有payload时与内部结点相同
+    int leaf_max_keys = file_hdr_->payload_len_ > 0 ? file_hdr_->leaf_order_ : max_keys;
+    int leaf_min_keys = (leaf_max_keys + 1) / 2;
+    int leaf_capacity = std::clamp(static_cast<int>(fill_factor * leaf_max_keys),
+                                   leaf_min_keys, leaf_max_keys);
+
+    // 1. 叶结点层，第一个叶结点复用初始的空根结点；同时只保留最后两个叶结点，最后再调整它们的大小
+    std::vector<char> level_keys;  // 本层每个结点的第一个key
+    std::vector<Rid> level_rids;   // 本层每个结点的页面号，作为上层内部结点的rid
+    auto append_child = [&](IxNodeHandle *node) {
+        level_keys.insert(level_keys.end(), node->get_key(0),
+                          node->get_key(0) + key_len);
+        level_rids.push_back(Rid{node->get_page_no(), -1});
+    };
+
+    IxNodeHandle *leaf = fetch_node(file_hdr_->root_page_);
+    assert(leaf->is_leaf_page() && leaf->get_size() == 0);
+    IxNodeHandle *prev = nullptr;
+    std::vector<char> key(file_hdr_->entry_len());
+    Rid rid;
+    while (next_entry(key.data(), &rid)) {
+        int size = leaf->get_size();
+        if (size > 0 && leaf->key_equals(size - 1, key.data())) {
+            if (prev != nullptr) {
+                unpin_node(prev, true);
+            }
+            unpin_node(leaf, true);
+            return false;
+        }
+        if (size == leaf_capacity) {
+            IxNodeHandle *next = create_node();
+            next->page_hdr->next_free_page_no = IX_NO_PAGE;
+            next->page_hdr->is_leaf = true;
+            next->set_parent_page_no(IX_NO_PAGE);
+            next->set_size(0);
+            next->set_prev_leaf(leaf->get_page_no());
+            next->set_next_leaf(IX_LEAF_HEADER_PAGE);
+            leaf->set_next_leaf(next->get_page_no());
+            if (prev != nullptr) {
+                append_child(prev);
+                unpin_node(prev, true);
+            }
+            prev = leaf;
+            leaf = next;
+        }
+        leaf->insert_pairs(leaf->get_size(), key.data(), &rid, 1, key.data() + key_len);
+    }
+    if (prev != nullptr && leaf->get_size() < leaf_min_keys) {
+        int total = prev->get_size() + leaf->get_size();
+        if (total <= leaf_max_keys) {
+            // 最后一个叶结点并入前一个叶结点
+            prev->insert_pairs(prev->get_size(), leaf->get_key(0),
+                               leaf->get_rid(0), leaf->get_size(), leaf->get_payload(0));
+            prev->set_next_leaf(IX_LEAF_HEADER_PAGE);
+            PageId page_id = leaf->get_page_id();
+            release_node_handle(*leaf);
+            unpin_node(leaf, false);
+            buffer_pool_manager_->delete_page(page_id);
+            leaf = prev;
+            prev = nullptr;
+        } else {
+            // 从前一个叶结点移过来一部分，使两者都不少于min_size
+            int pos = total - leaf_min_keys;
+            leaf->insert_pairs(0, prev->get_key(pos), prev->get_rid(pos),
+                               prev->get_size() - pos, prev->get_payload(pos));
+            prev->set_size(pos);
+        }
+    }
+    if (prev != nullptr) {
+        append_child(prev);
+        unpin_node(prev, true);
+    }
+    file_hdr_->last_leaf_ = leaf->get_page_no();
+    IxNodeHandle *leaf_header = fetch_node(IX_LEAF_HEADER_PAGE);
+    leaf_header->set_prev_leaf(leaf->get_page_no());
+    unpin_node(leaf_header, true);
+    if (leaf->get_size() == 0) {
+        unpin_node(leaf, false);
+        return true;
+    }
+    append_child(leaf);
+    unpin_node(leaf, true);
+
+    // 2. 逐层构建内部结点，直到只剩一个结点作为根结点
+    while (level_rids.size() > 1) {
+        std::vector<char> child_keys = std::move(level_keys);
+        std::vector<Rid> child_rids = std::move(level_rids);
+        level_keys.clear();
+        level_rids.clear();
+        int pos = 0;
+        for (int group_size : bulk_group_sizes(child_rids.size(), capacity,
+                                               min_keys, max_keys)) {
+            IxNodeHandle *node = create_node();
+            node->page_hdr->next_free_page_no = IX_NO_PAGE;
+            node->page_hdr->is_leaf = false;
+            node->set_parent_page_no(IX_NO_PAGE);
+            node->set_prev_leaf(IX_NO_PAGE);
+            node->set_next_leaf(IX_NO_PAGE);
+            node->set_size(0);
+            node->insert_pairs(0, child_keys.data() + pos * key_len,
+                               child_rids.data() + pos, group_size);
+            for (int i = 0; i < group_size; i++) {
+                maintain_child(node, i);
+            }
+            append_child(node);
+            unpin_node(node, true);
+            pos += group_size;
+        }
+    }
+    update_root_page_no(level_rids[0].page_no);
+    pin_upper_levels();
+    return true;
+}
+
+/**
+ * @brief 变长格式的批量构建：结点按字节数装到填充因子为止，相邻叶结点之间取最短的分隔键作为上下界
+ * 装入时按前缀为空估算字节数，结点的实际前缀由上下界决定，只会更省空间；返回值同bulk_load()
+ */
+bool IxIndexHandle::bulk_load_packed(
+    const std::function<bool(char *, Rid *)> &next_entry, double fill_factor) {
+    int key_len = file_hdr_->col_tot_len_;
+    int max_entry = packed_entry_bytes(key_len) + sizeof(uint16_t);
+    int limit = std::min(
+        static_cast<int>(fill_factor * (PAGE_SIZE - sizeof(IxPageHdr))),
+        PAGE_SIZE - packed_header_bytes(0, key_len, key_len) - max_entry);
+    auto entry_size = [&](const char *key) {
+        return static_cast<int>(sizeof(uint16_t)) +
+               packed_entry_bytes(ix_key_sig_len(key, key_len));
+    };
+
+    // 1. 叶结点层，凑够一个结点的键值对后再写入，此时已知道它的上下界；第一个叶结点复用初始的空根结点
+    std::vector<char> level_keys;  // 本层每个结点的下界，第一个结点取它的第一个key
+    std::vector<Rid> level_rids;   // 本层每个结点的页面号，作为上层内部结点的rid
+    std::vector<char> keys, low(key_len), sep(key_len), key(key_len);
+    std::vector<Rid> rids;
+    bool has_low = false;
+    int bytes = 0;
+    IxNodeHandle *prev = nullptr;
+    auto flush_leaf = [&](const char *high) {
+        IxNodeHandle *leaf;
+        if (prev == nullptr) {
+            leaf = fetch_node(file_hdr_->root_page_);
+            assert(leaf->is_leaf_page() && leaf->get_size() == 0);
+        } else {
+            leaf = create_node();
+            leaf->page_hdr->next_free_page_no = IX_NO_PAGE;
+            leaf->page_hdr->is_leaf = true;
+            leaf->set_parent_page_no(IX_NO_PAGE);
+            leaf->set_prev_leaf(prev->get_page_no());
+            prev->set_next_leaf(leaf->get_page_no());
+            unpin_node(prev, true);
+        }
+        leaf->set_next_leaf(IX_LEAF_HEADER_PAGE);
+        leaf->reset(has_low ? low.data() : nullptr, high);
+        leaf->insert_pairs(0, keys.data(), rids.data(), rids.size());
+        level_keys.insert(level_keys.end(), has_low ? low.begin() : keys.begin(),
+                          has_low ? low.end() : keys.begin() + key_len);
+        level_rids.push_back(Rid{leaf->get_page_no(), -1});
+        prev = leaf;
+    };
+
+    Rid rid;
+    while (next_entry(key.data(), &rid)) {
+        if (!rids.empty() &&
+            memcmp(key.data(), keys.data() + keys.size() - key_len, key_len) == 0) {
+            if (prev != nullptr) {
+                unpin_node(prev, true);
+            }
+            return false;
+        }
+        int size = entry_size(key.data());
+        if (!rids.empty() && bytes + size > limit) {
+            ix_shortest_separator(keys.data() + keys.size() - key_len, key.data(),
+                                  key_len, sep.data());
+            flush_leaf(sep.data());
+            low = sep;
+            has_low = true;
+            keys.clear();
+            rids.clear();
+            bytes = 0;
+        }
+        keys.insert(keys.end(), key.begin(), key.end());
+        rids.push_back(rid);
+        bytes += size;
+    }
+    if (rids.empty()) {
+        return true;
+    }
+    flush_leaf(nullptr);
+    file_hdr_->last_leaf_ = prev->get_page_no();
+    IxNodeHandle *leaf_header = fetch_node(IX_LEAF_HEADER_PAGE);
+    leaf_header->set_prev_leaf(prev->get_page_no());
+    unpin_node(leaf_header, true);
+    unpin_node(prev, true);
+
+    // 2. 逐层构建内部结点，每个结点的范围从它第一个孩子的下界到下一个结点第一个孩子的下界
+    while (level_rids.size() > 1) {
+        std::vector<char> child_keys = std::move(level_keys);
+        std::vector<Rid> child_rids = std::move(level_rids);
+        level_keys.clear();
+        level_rids.clear();
+        int n = child_rids.size();
+        std::vector<int> starts = {0};
+        bytes = 0;
+        for (int i = 0; i < n; i++) {
+            int size = entry_size(child_keys.data() + i * key_len);
+            if (i > starts.back() && bytes + size > limit) {
+                starts.push_back(i);
+                bytes = 0;
+            }
+            bytes += size;
+        }
+        if (starts.size() > 1 && starts.back() == n - 1) {
+            starts.back()--;  // 避免最后一个结点只有一个孩子
+        }
+        starts.push_back(n);
+        for (size_t g = 0; g + 1 < starts.size(); g++) {
+            int begin = starts[g];
+            int end = starts[g + 1];
+            IxNodeHandle *node = create_node();
+            node->page_hdr->next_free_page_no = IX_NO_PAGE;
+            node->page_hdr->is_leaf = false;
+            node->set_parent_page_no(IX_NO_PAGE);
+            node->set_prev_leaf(IX_NO_PAGE);
+            node->set_next_leaf(IX_NO_PAGE);
+            node->reset(g == 0 ? nullptr : child_keys.data() + begin * key_len,
+                        end == n ? nullptr : child_keys.data() + end * key_len);
+            node->insert_pairs(0, child_keys.data() + begin * key_len,
+                               child_rids.data() + begin, end - begin);
+            for (int i = 0; i < node->get_size(); i++) {
+                maintain_child(node, i);
+            }
+            level_keys.insert(level_keys.end(),
+                              child_keys.begin() + begin * key_len,
+                              child_keys.begin() + (begin + 1) * key_len);
+            level_rids.push_back(Rid{node->get_page_no(), -1});
+            unpin_node(node, true);
+        }
+    }
+    update_root_page_no(level_rids[0].page_no);
+    pin_upper_levels();
+    return true;
+}
+
+/**
+ * @brief 把调用者传入的原始键转换为索引中存储的形式
+ * 联合索引的键规范化后写入buf并返回buf，其他索引直接使用原始键
+ *
+ * @param buf 长度至少为file_hdr_->col_tot_len_
+ */
+const char *IxIndexHandle::index_key(const char *key, char *buf) const {
+    if (!file_hdr_->normalized()) {
+        return key;
+    }
+    ix_encode_key(key, buf, file_hdr_->col_types_, file_hdr_->col_lens_);
+    return buf;
+}
+
+/**
+ * @brief 用自适应哈希索引查找规范化后的键，命中时直接读记录的叶结点，不从根结点下降
+ * @param hash 键的IxAdaptiveHash::hash()
+ * @param hot 未命中时返回该键是否是热点键，调用者下降找到键后记录它的位置
+ * @return 是否命中；哈希项已失效时删除它并返回false
+ */
+bool IxIndexHandle::adaptive_lookup(const char *key, uint64_t hash, Rid *rid, bool *hot) {
+    IxAdaptiveHash::Entry entry;
+    if (!ahi_.lookup(hash, &entry, hot)) {
+        return false;
+    }
+    // 先检查纪元号，已删除的叶结点不再读取
+    if (ahi_.page_epoch(entry.page_no) != entry.epoch) {
+        ahi_.erase(hash);
+        *hot = true;
+        return false;
+    }
+    IxNodeHandle *leaf = fetch_node(entry.page_no);
+    leaf->page->rlatch();
+    // 加锁后再检查一次纪元号：检查之后、加锁之前叶结点可能被分裂或删除
+    bool valid = ahi_.page_epoch(entry.page_no) == entry.epoch &&
+                 leaf->is_leaf_page() && entry.slot_no < leaf->get_size() &&
+                 entry.slot_no >= 0 && leaf->key_equals(entry.slot_no, key);
+    if (valid) {
+        *rid = *leaf->get_rid(entry.slot_no);
+    }
+    leaf->page->runlatch();
+    unpin_node(leaf, false);
+    if (valid) {
+        ahi_.add_hit();
+    } else {
+        ahi_.erase(hash);
+        *hot = true;
+    }
+    return valid;
+}
+
+/**
+ * @brief 叶结点的键将移到其他结点或叶结点将被删除，使指向它的自适应哈希项失效
+ * @note 调用者须持有该叶结点的写锁
+ */
+void IxIndexHandle::invalidate_leaf(IxNodeHandle *node) {
+    ahi_.invalidate_page(node->get_page_no());
+}
+
+/**
+ * @brief 布隆过滤器使用的哈希值：对键的前bloom_key_len_字节(索引字段)的规范化形式做哈希，
+ * 与键在树中是否规范化存储无关，-0.0与0.0的哈希值相同
+ * @param encoded key是否已经是ix_encode_key()的规范化形式
+ */
+uint64_t IxIndexHandle::bloom_hash(const char *key, bool encoded) const {
+    char buf[IX_MAX_COL_LEN];
+    if (!encoded) {
+        ix_encode_key(key, buf, file_hdr_->col_types_, file_hdr_->col_lens_);
+        key = buf;
+    }
+    return IxBloomFilter::hash(key, file_hdr_->bloom_key_len_);
+}
+
+/**
+ * @brief 键是否可能在索引中，没有过滤器时总是返回true；只看键中的索引字段
+ */
+bool IxIndexHandle::may_contain(const char *key) const {
+    IxBloomFilter *bloom = bloom_;
+    return bloom == nullptr || bloom->may_contain(bloom_hash(key, false));
+}
+
+/**
+ * @brief 建索引之后遍历所有叶结点生成布隆过滤器，过滤器的页面追加在文件末尾并立即写盘
+ * @param key_len 参与过滤的键前缀长度，即索引字段(不含INCLUDE字段)的总长度
+ * @param bits_per_key 每个键占用的位数，按当前键数的IX_BLOOM_GROWTH倍分配空间
+ */
+void IxIndexHandle::build_bloom_filter(int key_len, int bits_per_key) {
+    file_hdr_->bloom_key_len_ = key_len;
+    file_hdr_->bloom_bits_per_key_ = bits_per_key;
+    rebuild_bloom_filter();
+}
+
+/**
+ * @brief 按B+树中现有的键重新生成布隆过滤器，加入的键数超过过滤器的容量后由后台合并线程或VACUUM调用
+ * 独占merge_latch_，期间没有插入和删除；先合并缓存的修改，缓存的键也进入新的过滤器。
+ * 新过滤器放得下时写回原来的页面，否则在文件末尾分配新的页面，旧的页面与B+树删除的页面一样不再回收；
+ * 过滤器每次按倍数增长，这样浪费的页面不超过最终过滤器的大小
+ */
+void IxIndexHandle::rebuild_bloom_filter() {
+    std::unique_lock merge_lock{merge_latch_};
+    if (change_buffer_ != nullptr) {
+        std::vector<IxBufferedChange> changes;
+        change_buffer_->take_range(nullptr, nullptr, &changes);
+        apply_changes(changes);
+    }
+    std::unique_lock root_lock{root_latch_};
+    int key_len = file_hdr_->bloom_key_len_;
+    std::vector<char> keys;
+    char key[IX_MAX_COL_LEN];
+    size_t num_keys = 0;
+    if (!is_empty()) {
+        for (page_id_t page_no = file_hdr_->first_leaf_; page_no != IX_LEAF_HEADER_PAGE;) {
+            IxNodeHandle *leaf = fetch_node(page_no);
+            for (int i = 0; i < leaf->get_size(); i++) {
+                leaf->copy_key(i, key);
+                keys.insert(keys.end(), key, key + key_len);
+                num_keys++;
+            }
+            page_no = leaf->get_next_leaf();
+            unpin_node(leaf, false);
+        }
+    }
+
+    auto bloom = std::make_unique<IxBloomFilter>(
+        IxBloomFilter::num_blocks_for(num_keys, file_hdr_->bloom_bits_per_key_));
+    // 叶结点中的键是否已规范化；只取前key_len字节时，规范化形式逐字段对应，前缀仍然有效
+    bool encoded = file_hdr_->normalized();
+    for (size_t i = 0; i < num_keys; i++) {
+        const char *stored = keys.data() + i * key_len;
+        if (encoded) {
+            bloom->insert(IxBloomFilter::hash(stored, key_len));
+        } else {
+            memcpy(key, stored, key_len);
+            bloom->insert(bloom_hash(key, false));
+        }
+    }
+
+    auto pages_for = [](const IxBloomFilter *filter) {
+        return static_cast<int>((filter->size_bytes() + PAGE_SIZE - 1) / PAGE_SIZE);
+    };
+    int num_pages = pages_for(bloom.get());
+    if (bloom_ == nullptr || num_pages > pages_for(bloom_)) {
+        std::lock_guard<std::mutex> lock(num_pages_latch_);
+        file_hdr_->bloom_first_page_ = disk_manager_->allocate_page(fd_);
+        for (int i = 1; i < num_pages; i++) {
+            disk_manager_->allocate_page(fd_);
+        }
+        file_hdr_->num_pages_ += num_pages;
+    }
+    file_hdr_->bloom_num_blocks_ = bloom->num_blocks();
+    bloom_num_keys_ = static_cast<int>(num_keys);
+    blooms_.push_back(std::move(bloom));
+    bloom_ = blooms_.back().get();
+    flush_bloom_filter();
+}
+
+/**
+ * @brief 加入过滤器的键数是否超过了过滤器的容量
+ */
+bool IxIndexHandle::bloom_filter_full() const {
+    IxBloomFilter *bloom = bloom_;
+    return bloom != nullptr && file_hdr_->bloom_bits_per_key_ > 0 &&
+           static_cast<size_t>(bloom_num_keys_) > bloom->capacity(file_hdr_->bloom_bits_per_key_);
+}
+
+/**
+ * @brief 新键插入B+树后计数，过滤器刚满时通知后台合并线程重建
+ */
+void IxIndexHandle::count_bloom_key() {
+    if (bloom_ == nullptr) {
+        return;
+    }
+    bloom_num_keys_++;
+    if (change_buffer_ != nullptr && bloom_filter_full()) {
+        IxChangeBufferMerger::instance().notify();
+    }
+}
+
+/**
+ * @brief 把布隆过滤器写回它的页面，这些页面不经过缓冲池；键数记入文件头
+ */
+void IxIndexHandle::flush_bloom_filter() const {
+    IxBloomFilter *bloom = bloom_;
+    if (bloom == nullptr) {
+        return;
+    }
+    file_hdr_->bloom_num_keys_ = bloom_num_keys_;
+    char page_buf[PAGE_SIZE];
+    for (size_t offset = 0; offset < bloom->size_bytes(); offset += PAGE_SIZE) {
+        int len = std::min<size_t>(PAGE_SIZE, bloom->size_bytes() - offset);
+        memset(page_buf, 0, PAGE_SIZE);
+        memcpy(page_buf, bloom->data() + offset, len);
+        disk_manager_->write_page(fd_, file_hdr_->bloom_first_page_ + offset / PAGE_SIZE,
+                                  page_buf, PAGE_SIZE);
+    }
+}
+
+/**
+ * @brief 重建常驻集合：从根结点起逐层pin住内部结点，不含叶结点
+ * 一层的页面要么全部常驻要么都不常驻，达到IX_PIN_MAX_LEVELS层、IX_PIN_MAX_PAGES个页面
+ * 或缓冲池的常驻预留不足时停止。内部结点分裂或合并、根结点改变后由下一次查找或写操作重建，
+ * 在此之前新的内部结点不常驻，被删除的结点仍被pin住但已不会被访问
+ * @note 调用者须独占根锁(打开索引时除外)
+ */
+void IxIndexHandle::pin_upper_levels() {
+    unpin_upper_levels();
+    resident_root_ = file_hdr_->root_page_;
+    resident_smo_count_ = upper_smo_count_;
+    if (is_empty()) {
+        return;
+    }
+    std::vector<page_id_t> level = {file_hdr_->root_page_};
+    for (int depth = 0; depth < IX_PIN_MAX_LEVELS && !level.empty(); depth++) {
+        // 同一层的结点高度相同，看第一个结点即可；结点是否为叶结点在页面的生命周期内不变
+        IxNodeHandle *first = fetch_node(level[0]);
+        bool is_leaf = first->is_leaf_page();
+        unpin_node(first, false);
+        if (is_leaf || resident_pages_.size() + level.size() > IX_PIN_MAX_PAGES ||
+            !buffer_pool_manager_->reserve_resident(level.size())) {
+            break;
+        }
+        // 不持有根锁的写线程可能正在分裂下层结点，同一个孩子可能先后出现在两个结点中
+        std::vector<page_id_t> next_level;
+        size_t num_pinned = 0;
+        for (page_id_t page_no : level) {
+            IxNodeHandle *node = fetch_node(page_no);
+            node->page->rlatch();
+            for (int i = 0; i < node->get_size(); i++) {
+                next_level.push_back(node->value_at(i));
+            }
+            node->page->runlatch();
+            if (resident_pages_.emplace(page_no, node->page).second) {
+                num_pinned++;
+                delete node;  // 保持fetch_node()的pin
+            } else {
+                unpin_node(node, false);
+            }
+        }
+        buffer_pool_manager_->release_resident(level.size() - num_pinned);
+        level = std::move(next_level);
+    }
+}
+
+/**
+ * @brief 常驻集合过期时由查找和乐观写尝试重建，根锁被其他线程持有时放弃，留给之后的操作
+ * @note 调用者不能持有根锁和任何页面锁
+ */
+void IxIndexHandle::try_refresh_upper_levels() {
+    std::unique_lock root_lock{root_latch_, std::try_to_lock};
+    if (root_lock.owns_lock() && resident_stale()) {
+        pin_upper_levels();
+    }
+}
+
+/**
+ * @brief 释放所有常驻页面的pin，关闭索引或重建常驻集合时调用
+ */
+void IxIndexHandle::unpin_upper_levels() {
+    for (auto &[page_no, page] : resident_pages_) {
+        buffer_pool_manager_->unpin_page(page->get_page_id(), false);
+    }
+    buffer_pool_manager_->release_resident(resident_pages_.size());
+    resident_pages_.clear();
 }
 
 /**
@@ -406,10 +2059,12 @@ bool IxIndexHandle::coalesce(IxNodeHandle **neighbor_node, IxNodeHandle **node,
 Rid IxIndexHandle::get_rid(const Iid &iid) const {
     IxNodeHandle *node = fetch_node(iid.page_no);
     if (iid.slot_no >= node->get_size()) {
+        unpin_node(node, false);
         throw IndexEntryNotFoundError();
     }
-    buffer_pool_manager_->unpin_page(node->get_page_id(), false);  // unpin it!
-    return *node->get_rid(iid.slot_no);
+    Rid rid = *node->get_rid(iid.slot_no);
+    unpin_node(node, false);  // unpin it!
+    return rid;
 }
 
 /**
@@ -420,7 +2075,143 @@ Rid IxIndexHandle::get_rid(const Iid &iid) const {
  * @note 上层传入的key本来是int类型，通过(const char *)&key进行了转换
  * 可用*(int *)key转换回去
  */
-Iid IxIndexHandle::lower_bound(const char *key) { return Iid{-1, -1}; }
+Iid IxIndexHandle::lower_bound(const char *key) {
+    merge_change_buffer();  // 返回的位置之后可能用于任意范围的扫描
+    char buf[IX_MAX_COL_LEN];
+    key = index_key(key, buf);
+    auto [leaf, root_is_latched] = find_leaf_page(key, Operation::FIND, nullptr);
+    Iid iid = leaf_iid(leaf, leaf->lower_bound(key));
+    leaf->page->runlatch();
+    unpin_node(leaf, false);
+    return iid;
+}
+
+/**
+ * @brief 启用修改缓冲并注册到共用的后台合并线程，之后插入和删除的目标叶结点不在缓冲池中时先缓存起来
+ * B+树的键不重复，重复插入和删除不存在的键都静默忽略，调用者不依赖修改的结果，所以修改可以推迟
+ */
+void IxIndexHandle::enable_change_buffer() {
+    if (change_buffer_ != nullptr) {
+        return;
+    }
+    change_buffer_ = std::make_unique<IxChangeBuffer>(file_hdr_->col_types_, file_hdr_->col_lens_,
+                                                      file_hdr_->col_tot_len_,
+                                                      file_hdr_->payload_len_);
+    IxChangeBufferMerger::instance().add(this);
+}
+
+/**
+ * @brief 从后台合并线程注销，合并全部缓存的修改后关闭修改缓冲，关闭索引前调用
+ */
+void IxIndexHandle::disable_change_buffer() {
+    if (change_buffer_ == nullptr) {
+        return;
+    }
+    IxChangeBufferMerger::instance().remove(this);
+    merge_change_buffer();
+    change_buffer_.reset();
+}
+
+void IxIndexHandle::merge_change_buffer() { merge_range(nullptr, nullptr); }
+
+/**
+ * @brief 读[lower, upper]中的键之前，把缓存在这个范围内的修改合并到B+树中
+ * 先共享加锁检查：持有共享锁时没有正在进行的合并，范围内没有缓存的修改就可以直接读B+树
+ * @param lower/upper 调用者的原始键，nullptr表示该方向没有界
+ */
+void IxIndexHandle::merge_range(const char *lower, const char *upper) {
+    if (change_buffer_ == nullptr) {
+        return;
+    }
+    {
+        std::shared_lock merge_lock{merge_latch_};
+        if (!change_buffer_->has_range(lower, upper)) {
+            return;
+        }
+    }
+    std::unique_lock merge_lock{merge_latch_};
+    std::vector<IxBufferedChange> changes;
+    change_buffer_->take_range(lower, upper, &changes);
+    apply_changes(changes);
+}
+
+/**
+ * @brief 按键序把取出的修改应用到B+树，调用者独占持有merge_latch_
+ */
+void IxIndexHandle::apply_changes(const std::vector<IxBufferedChange> &changes) {
+    for (auto &change : changes) {
+        if (change.delete_first) {
+            delete_from_tree(change.key.data(), nullptr);
+        }
+        if (change.insert) {
+            insert_into_tree(change.key.data(), change.rid, nullptr);
+        }
+    }
+}
+
+/**
+ * @brief 供后台合并线程调用：布隆过滤器满了时重建，缓冲过半时按键序合并一批修改
+ * @return 合并后缓冲是否仍然过半
+ */
+bool IxIndexHandle::merge_change_buffer_batch() {
+    if (bloom_filter_full()) {
+        rebuild_bloom_filter();
+    }
+    if (change_buffer_->size() < IX_CHANGE_BUFFER_CAPACITY / 2) {
+        return false;
+    }
+    std::unique_lock merge_lock{merge_latch_};
+    std::vector<IxBufferedChange> changes;
+    change_buffer_->take_batch(IX_CHANGE_BUFFER_MERGE_BATCH, &changes);
+    apply_changes(changes);
+    return change_buffer_->size() >= IX_CHANGE_BUFFER_CAPACITY / 2;
+}
+
+/**
+ * @brief 估计键在[lower, upper]范围内的索引项占全部索引项的比例，供优化器估计范围扫描的选择率
+ * 只访问两条从根结点到叶结点的路径，不扫描叶结点
+ */
+double IxIndexHandle::estimate_range(const char *lower, const char *upper) {
+    char lower_buf[IX_MAX_COL_LEN];
+    char upper_buf[IX_MAX_COL_LEN];
+    lower = index_key(lower, lower_buf);
+    upper = index_key(upper, upper_buf);
+    return std::max(estimate_rank(upper) - estimate_rank(lower), 0.0);
+}
+
+/**
+ * @brief 估计小于key的索引项所占的比例
+ * 按读锁蟹行从根结点下降，假设同一结点的各个子树大小相同：
+ * 结点覆盖的比例为width、有n个孩子、key落在第c个孩子中时，比例增加width * c / n，孩子覆盖width / n
+ */
+double IxIndexHandle::estimate_rank(const char *key) {
+    std::shared_lock root_lock{root_latch_};
+    if (is_empty()) {
+        return 0;
+    }
+    IxNodeHandle *node = fetch_node(file_hdr_->root_page_);
+    node->page->rlatch();
+    root_lock.unlock();
+    double rank = 0;
+    double width = 1;
+    while (!node->is_leaf_page()) {
+        int n = node->get_size();
+        int child_idx = std::max(node->upper_bound(key) - 1, 0);
+        rank += width * child_idx / n;
+        width /= n;
+        IxNodeHandle *child = fetch_node(node->value_at(child_idx));
+        child->page->rlatch();
+        node->page->runlatch();
+        unpin_node(node, false);
+        node = child;
+    }
+    if (node->get_size() > 0) {
+        rank += width * node->lower_bound(key) / node->get_size();
+    }
+    node->page->runlatch();
+    unpin_node(node, false);
+    return rank;
+}
 
 /**
  * @brief FindLeafPage + upper_bound
@@ -428,7 +2219,42 @@ Iid IxIndexHandle::lower_bound(const char *key) { return Iid{-1, -1}; }
  * @param key
  * @return Iid
  */
-Iid IxIndexHandle::upper_bound(const char *key) { return Iid{-1, -1}; }
+Iid IxIndexHandle::upper_bound(const char *key) {
+    merge_change_buffer();
+    char buf[IX_MAX_COL_LEN];
+    key = index_key(key, buf);
+    auto [leaf, root_is_latched] = find_leaf_page(key, Operation::FIND, nullptr);
+    Iid iid = leaf_iid(leaf, leaf->upper_bound(key));
+    leaf->page->runlatch();
+    unpin_node(leaf, false);
+    return iid;
+}
+
+/**
+ * @brief 把叶结点中的位置转换为Iid，位置越过结点末尾时指向下一个叶结点的开头
+ * 最后一个叶结点的末尾就是leaf_end()
+ */
+Iid IxIndexHandle::leaf_iid(IxNodeHandle *leaf, int key_idx) const {
+    if (key_idx < leaf->get_size() ||
+        leaf->get_page_no() == file_hdr_->last_leaf_) {
+        return Iid{.page_no = leaf->get_page_no(), .slot_no = key_idx};
+    }
+    // 变长格式下可能留有无法合并的空叶结点，一并跳过；向右加锁不会与其他线程形成等待环
+    page_id_t page_no = leaf->get_next_leaf();
+    while (page_no != file_hdr_->last_leaf_) {
+        IxNodeHandle *next = fetch_node(page_no);
+        next->page->rlatch();
+        int size = next->get_size();
+        page_id_t next_page_no = next->get_next_leaf();
+        next->page->runlatch();
+        unpin_node(next, false);
+        if (size > 0) {
+            break;
+        }
+        page_no = next_page_no;
+    }
+    return Iid{.page_no = page_no, .slot_no = 0};
+}
 
 /**
  * @brief 指向最后一个叶子的最后一个结点的后一个
@@ -436,10 +2262,11 @@ Iid IxIndexHandle::upper_bound(const char *key) { return Iid{-1, -1}; }
  *
  * @return Iid
  */
-Iid IxIndexHandle::leaf_end() const {
+Iid IxIndexHandle::leaf_end() {
+    merge_change_buffer();
     IxNodeHandle *node = fetch_node(file_hdr_->last_leaf_);
     Iid iid = {.page_no = file_hdr_->last_leaf_, .slot_no = node->get_size()};
-    buffer_pool_manager_->unpin_page(node->get_page_id(), false);  // unpin it!
+    unpin_node(node, false);  // unpin it!
     return iid;
 }
 
@@ -449,8 +2276,11 @@ Iid IxIndexHandle::leaf_end() const {
  *
  * @return Iid
  */
-Iid IxIndexHandle::leaf_begin() const {
-    Iid iid = {.page_no = file_hdr_->first_leaf_, .slot_no = 0};
+Iid IxIndexHandle::leaf_begin() {
+    merge_change_buffer();
+    IxNodeHandle *node = fetch_node(file_hdr_->first_leaf_);
+    Iid iid = leaf_iid(node, 0);
+    unpin_node(node, false);
     return iid;
 }
 
@@ -468,6 +2298,20 @@ IxNodeHandle *IxIndexHandle::fetch_node(int page_no) const {
     return node;
 }
 
+/**
+ * @brief 获取结点，常驻的上层结点直接使用缓存的页面指针，不访问缓冲池的页表和替换器
+ * @note 调用者须持有根锁，并在释放根锁之前释放返回的常驻结点；返回的结点只能读
+ */
+IxNodeHandle *IxIndexHandle::fetch_upper_node(page_id_t page_no) const {
+    auto it = resident_pages_.find(page_no);
+    if (it == resident_pages_.end()) {
+        return fetch_node(page_no);
+    }
+    IxNodeHandle *node = new IxNodeHandle(file_hdr_, it->second);
+    node->resident = true;
+    return node;
+}
+
 /**
  * @brief 创建一个新结点
  *
@@ -481,7 +2325,10 @@ IxNodeHandle *IxIndexHandle::fetch_node(int page_no) const {
  */
 IxNodeHandle *IxIndexHandle::create_node() {
     IxNodeHandle *node;
-    file_hdr_->num_pages_++;
+    {
+        std::lock_guard<std::mutex> lock(num_pages_latch_);
+        file_hdr_->num_pages_++;
+    }
 
     PageId new_page_id = {.fd = fd_, .page_no = INVALID_PAGE_ID};
     // 从3开始分配page_no，第一次分配之后，new_page_id.page_no=3，file_hdr_.num_pages=4
@@ -491,7 +2338,31 @@ IxNodeHandle *IxIndexHandle::create_node() {
 }
 
 /**
- * @brief 从node开始更新其父节点的第一个key，一直向上更新直到根节点
+ * @brief unpin结点所在的页面，并释放结点句柄
+ */
+void IxIndexHandle::unpin_node(IxNodeHandle *node, bool is_dirty) const {
+    if (node->resident) {
+        // 常驻结点只用于只读的下降，常驻的pin由unpin_upper_levels()释放
+        assert(!is_dirty);
+    } else {
+        buffer_pool_manager_->unpin_page(node->get_page_id(), is_dirty);
+    }
+    delete node;
+}
+
+/**
+ * @brief 删除结点：页面记入事务的删除集合，并unpin释放结点句柄
+ * @note 被删除的页面必须在事务的latch集合中，等release_latched_pages()解锁后才从缓冲池中删除
+ */
+void IxIndexHandle::delete_node(IxNodeHandle *node, Transaction *transaction) {
+    release_node_handle(*node);
+    transaction->append_index_deleted_page(node->page);
+    unpin_node(node, true);
+}
+
+/**
+ * @brief 从node开始更新其父节点中对应的key，父结点的第一个key变化时继续向上更新
+ * 需要更新的祖先结点在悲观查找时都已加写锁
  *
  * @param node
  */
@@ -504,15 +2375,21 @@ void IxIndexHandle::maintain_parent(IxNodeHandle *node) {
         char *parent_key = parent->get_key(rank);
         char *child_first_key = curr->get_key(0);
         if (memcmp(parent_key, child_first_key, file_hdr_->col_tot_len_) == 0) {
-            assert(
-                buffer_pool_manager_->unpin_page(parent->get_page_id(), true));
+            unpin_node(parent, true);
             break;
         }
         memcpy(parent_key, child_first_key,
                file_hdr_->col_tot_len_);  // 修改了parent node
+        if (curr != node) {
+            unpin_node(curr, true);
+        }
         curr = parent;
-
-        assert(buffer_pool_manager_->unpin_page(parent->get_page_id(), true));
+        if (rank != 0) {
+            break;
+        }
+    }
+    if (curr != node) {
+        unpin_node(curr, true);
     }
 }
 
@@ -521,17 +2398,20 @@ void IxIndexHandle::maintain_parent(IxNodeHandle *node) {
  * 要删除leaf之前调用此函数，更新leaf前驱结点的next指针和后继结点的prev指针
  *
  * @param leaf 要删除的leaf
+ * @param prev leaf的前驱结点，即合并后保留的左兄弟，已由调用者加锁
  */
-void IxIndexHandle::erase_leaf(IxNodeHandle *leaf) {
+void IxIndexHandle::erase_leaf(IxNodeHandle *leaf, IxNodeHandle *prev) {
     assert(leaf->is_leaf_page());
+    assert(leaf->get_prev_leaf() == prev->get_page_no());
 
-    IxNodeHandle *prev = fetch_node(leaf->get_prev_leaf());
     prev->set_next_leaf(leaf->get_next_leaf());
-    buffer_pool_manager_->unpin_page(prev->get_page_id(), true);
 
+    // 后继叶结点只短暂加锁修改prev指针，持有期间不再等待其他锁
     IxNodeHandle *next = fetch_node(leaf->get_next_leaf());
+    next->page->wlatch();
     next->set_prev_leaf(leaf->get_prev_leaf());  // 注意此处是SetPrevLeaf()
-    buffer_pool_manager_->unpin_page(next->get_page_id(), true);
+    next->page->wunlatch();
+    unpin_node(next, true);
 }
 
 /**
@@ -540,11 +2420,13 @@ void IxIndexHandle::erase_leaf(IxNodeHandle *leaf) {
  * @param node
  */
 void IxIndexHandle::release_node_handle(IxNodeHandle &node) {
+    std::lock_guard<std::mutex> lock(num_pages_latch_);
     file_hdr_->num_pages_--;
 }
 
 /**
  * @brief 将node的第child_idx个孩子结点的父节点置为node
+ * @note 孩子结点不加锁：持有它的其他线程对它的修改不会传播到父结点，不会读取parent字段
  */
 void IxIndexHandle::maintain_child(IxNodeHandle *node, int child_idx) {
     if (!node->is_leaf_page()) {
@@ -553,6 +2435,6 @@ void IxIndexHandle::maintain_child(IxNodeHandle *node, int child_idx) {
         int child_page_no = node->value_at(child_idx);
         IxNodeHandle *child = fetch_node(child_page_no);
         child->set_parent_page_no(node->get_page_no());
-        buffer_pool_manager_->unpin_page(child->get_page_id(), true);
+        unpin_node(child, true);
     }
 }
\ No newline at end of file
@@ -10,7 +10,16 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "ix_adaptive_hash.h"
+#include "ix_bloom_filter.h"
+#include "ix_change_buffer.h"
 #include "ix_defs.h"
+#include "ix_key_search.h"
 #include "transaction/transaction.h"
 
 enum class Operation {
@@ -19,40 +28,20 @@ enum class Operation {
     DELETE
 };  // 三种操作：查找、插入、删除
 
-static const bool binary_search = false;
-
-inline int ix_compare(const char *a, const char *b, ColType type, int col_len) {
-    switch (type) {
-        case TYPE_INT: {
-            int ia = *(int *)a;
-            int ib = *(int *)b;
-            return (ia < ib) ? -1 : ((ia > ib) ? 1 : 0);
-        }
-        case TYPE_FLOAT: {
-            float fa = *(float *)a;
-            float fb = *(float *)b;
-            return (fa < fb) ? -1 : ((fa > fb) ? 1 : 0);
-        }
-        case TYPE_STRING:
-            return memcmp(a, b, col_len);
-        default:
-            throw InternalError("Unexpected data type");
-    }
-}
-
-inline int ix_compare(const char *a, const char *b,
-                      const std::vector<ColType> &col_types,
-                      const std::vector<int> &col_lens) {
-    int offset = 0;
-    for (size_t i = 0; i < col_types.size(); ++i) {
-        int res = ix_compare(a + offset, b + offset, col_types[i], col_lens[i]);
-        if (res != 0) return res;
-        offset += col_lens[i];
-    }
-    return 0;
-}
-
-/* 管理B+树中的每个节点 */
+/* 管理B+树中的每个节点
+ * 结点有两种格式：
+ * 定长格式：page->data = |IxPageHdr|keys[btree_order_ + 1]|rids[btree_order_ + 1]|，
+ *     父结点中的key等于孩子的第一个key；
+ *     有INCLUDE字段(file_hdr->payload_len_ > 0)时叶结点为
+ *     |IxPageHdr|keys[leaf_order_ + 1]|rids[leaf_order_ + 1]|payloads[leaf_order_ + 1]|，
+ *     payload随键值对一起移动，但不参与比较，内部结点不存放payload；
+ * 前缀压缩的变长格式(file_hdr->packed_)：
+ *     page->data = |IxPageHdr|前缀|下界后缀|上界后缀|slot数组| 空闲 |键值对数据区|，
+ *     结点保存自己的范围[下界, 上界)，范围内的key都以上下界的公共前缀开头，前缀只存一次；
+ *     数据区的每项为|Rid|uint16后缀长度|后缀|，后缀去掉了末尾补齐的0，slot数组按key的顺序保存各项的偏移；
+ *     父结点中的key是孩子的下界，它不大于孩子的第一个key，叶结点分裂时取能区分左右两边的最短前缀；
+ *     内部结点的第0个key在下界有限时等于下界，否则不参与查找。结点的容量由已用字节数决定。
+ */
 class IxNodeHandle {
     friend class IxIndexHandle;
     friend class IxScan;
@@ -63,8 +52,9 @@ class IxNodeHandle {
     IxPageHdr *
         page_hdr;  // page->data的第一部分，指针指向首地址，长度为sizeof(IxPageHdr)
     char *
-        keys;  // page->data的第二部分，指针指向首地址，长度为file_hdr->keys_size，每个key的长度为file_hdr->col_len
-    Rid *rids;  // page->data的第三部分，指针指向首地址
+        keys;  // page->data的第二部分，指针指向首地址，每个key的长度为file_hdr->col_tot_len_
+    // 以上keys只用于定长格式，rid和payload的位置与结点是否为叶结点有关，见rid_array()
+    bool resident = false;  // 页面是否为常驻的上层结点，常驻结点的句柄释放时不unpin
 
    public:
     IxNodeHandle() = default;
@@ -73,16 +63,22 @@ class IxNodeHandle {
         : file_hdr(file_hdr_), page(page_) {
         page_hdr = reinterpret_cast<IxPageHdr *>(page->get_data());
         keys = page->get_data() + sizeof(IxPageHdr);
-        rids = reinterpret_cast<Rid *>(keys + file_hdr->keys_size_);
     }
 
-    int get_size() { return page_hdr->num_key; }
+    int get_size() const { return page_hdr->num_key; }
 
     void set_size(int size) { page_hdr->num_key = size; }
 
-    int get_max_size() { return file_hdr->btree_order_ + 1; }
+    int get_max_size() const {
+        return (has_payload() ? file_hdr->leaf_order_ : file_hdr->btree_order_) + 1;
+    }
+
+    int get_min_size() const { return get_max_size() / 2; }
+
+    // 叶结点是否为每个键值对存放INCLUDE字段的payload
+    bool has_payload() const { return file_hdr->payload_len_ > 0 && is_leaf_page(); }
 
-    int get_min_size() { return get_max_size() / 2; }
+    bool is_packed() const { return file_hdr->packed_; }
 
     int key_at(int i) { return *(int *)get_key(i); }
 
@@ -99,7 +95,7 @@ class IxNodeHandle {
 
     page_id_t get_parent_page_no() { return page_hdr->parent; }
 
-    bool is_leaf_page() { return page_hdr->is_leaf; }
+    bool is_leaf_page() const { return page_hdr->is_leaf; }
 
     bool is_root_page() { return get_parent_page_no() == INVALID_PAGE_ID; }
 
@@ -109,24 +105,61 @@ class IxNodeHandle {
 
     void set_parent_page_no(page_id_t parent) { page_hdr->parent = parent; }
 
+    // 只用于定长格式，变长格式用copy_key()
     char *get_key(int key_idx) const {
         return keys + key_idx * file_hdr->col_tot_len_;
     }
 
-    Rid *get_rid(int rid_idx) const { return &rids[rid_idx]; }
+    Rid *get_rid(int rid_idx) const {
+        if (is_packed()) {
+            return reinterpret_cast<Rid *>(page->get_data() + slot_array()[rid_idx]);
+        }
+        return rid_array() + rid_idx;
+    }
+
+    // 第i个键值对的payload，没有payload的结点返回nullptr
+    char *get_payload(int i) const {
+        if (!has_payload()) {
+            return nullptr;
+        }
+        return reinterpret_cast<char *>(rid_array() + file_hdr->leaf_order_ + 1) +
+               i * file_hdr->payload_len_;
+    }
 
     void set_key(int key_idx, const char *key) {
         memcpy(keys + key_idx * file_hdr->col_tot_len_, key,
                file_hdr->col_tot_len_);
     }
 
-    void set_rid(int rid_idx, const Rid &rid) { rids[rid_idx] = rid; }
+    void set_rid(int rid_idx, const Rid &rid) { *get_rid(rid_idx) = rid; }
+
+    bool key_equals(int key_idx, const char *key) const {
+        if (is_packed()) {
+            return packed_compare(key_idx, key) == 0;
+        }
+        if (file_hdr->normalized()) {
+            return memcmp(get_key(key_idx), key, file_hdr->col_tot_len_) == 0;
+        }
+        return ix_compare(get_key(key_idx), key, file_hdr->col_types_,
+                          file_hdr->col_lens_) == 0;
+    }
+
+    void copy_key(int key_idx, char *key) const;
+
+    void get_separator(char *key) const;
+
+    void get_pairs(std::vector<char> *keys, std::vector<Rid> *rids) const;
+
+    bool is_full() const;
+
+    bool is_underflow() const;
 
     int lower_bound(const char *target) const;
 
     int upper_bound(const char *target) const;
 
-    void insert_pairs(int pos, const char *key, const Rid *rid, int n);
+    void insert_pairs(int pos, const char *key, const Rid *rid, int n,
+                      const char *payload = nullptr);
 
     page_id_t internal_lookup(const char *key);
 
@@ -135,8 +168,9 @@ class IxNodeHandle {
     int insert(const char *key, const Rid &value);
 
     // 用于在结点中的指定位置插入单个键值对
-    void insert_pair(int pos, const char *key, const Rid &rid) {
-        insert_pairs(pos, key, &rid, 1);
+    void insert_pair(int pos, const char *key, const Rid &rid,
+                     const char *payload = nullptr) {
+        insert_pairs(pos, key, &rid, 1, payload);
     }
 
     void erase_pair(int pos);
@@ -173,6 +207,52 @@ class IxNodeHandle {
         assert(rid_idx < page_hdr->num_key);
         return rid_idx;
     }
+
+    // 以下只用于前缀压缩的变长格式
+    void reset(const char *low, const char *high);
+
+    bool get_low_key(char *key) const;
+
+    bool get_high_key(char *key) const;
+
+    int free_bytes() const;
+
+    int max_entry_bytes() const;
+
+    int min_entry_bytes() const;
+
+    int entry_bytes() const { return get_size() * sizeof(uint16_t) + page_hdr->data_bytes; }
+
+    static int packed_bytes(const IxFileHdr *file_hdr, const char *low,
+                            const char *high, const char *keys, int n);
+
+    static bool packed_fits(const IxFileHdr *file_hdr, const char *low,
+                            const char *high, const char *keys, int n);
+
+   private:
+    // 定长格式的rid数组，紧跟在keys之后；带payload的叶结点的keys按leaf_order_分配
+    Rid *rid_array() const {
+        if (has_payload()) {
+            return reinterpret_cast<Rid *>(keys + (file_hdr->leaf_order_ + 1) *
+                                                      file_hdr->col_tot_len_);
+        }
+        return reinterpret_cast<Rid *>(keys + file_hdr->keys_size_);
+    }
+
+    uint16_t *slot_array() const;
+
+    const char *suffix(int key_idx) const;
+
+    int suffix_len(int key_idx) const;
+
+    int packed_compare(int key_idx, const char *key) const;
+
+    template <bool UPPER>
+    int packed_search(const char *target) const;
+
+    void packed_insert(int pos, const char *key, const Rid &rid);
+
+    void compact();
 };
 
 /* B+树 */
@@ -186,12 +266,39 @@ class IxIndexHandle {
     int fd_;  // 存储B+树的文件
     IxFileHdr *
         file_hdr_;  // 存了root_page，但其初始化为2（第0页存FILE_HDR_PAGE，第1页存LEAF_HEADER_PAGE）
-    std::mutex root_latch_;
+    // 保护根结点页面号：查找和乐观写共享加锁，可能修改根结点的悲观写独占加锁
+    std::shared_mutex root_latch_;
+    std::mutex num_pages_latch_;  // 保护file_hdr_->num_pages_
+    // 叶结点之间移动键的次数(分裂、重分配、合并)，在持有相关叶结点写锁时增加；
+    // IxScan据此判断离开一个叶结点后键是否可能移到了别的叶结点
+    std::atomic<uint64_t> leaf_smo_count_{0};
+    // 索引键(不含INCLUDE字段)的布隆过滤器，没有过滤器时为空。查找不加锁，重建时换成新的过滤器，
+    // 旧的过滤器留在blooms_中直到关闭索引
+    std::atomic<IxBloomFilter *> bloom_{nullptr};
+    std::vector<std::unique_ptr<IxBloomFilter>> blooms_;
+    std::atomic<int> bloom_num_keys_{0};  // 插入B+树的新键数，关闭索引时写回file_hdr_
+    // 热点键的自适应哈希索引，等值查找命中时跳过从根结点的下降
+    IxAdaptiveHash ahi_;
+    // 常驻的上层内部结点：根结点及其下若干层一直pin在缓冲池中，下降时直接使用页面指针，
+    // 不经过缓冲池的页表和替换器。只在独占根锁时修改，持有根锁(共享即可)时读取
+    std::unordered_map<page_id_t, Page *> resident_pages_;
+    page_id_t resident_root_ = IX_NO_PAGE;  // 建立常驻集合时的根结点
+    uint64_t resident_smo_count_ = 0;       // 建立常驻集合时的upper_smo_count_
+    // 内部结点分裂和合并的次数，与resident_smo_count_不同时常驻集合需要重建
+    std::atomic<uint64_t> upper_smo_count_{0};
+    // 修改缓冲，没有启用时为空。merge_latch_保证同一个键上的修改按顺序生效：
+    // 直接修改B+树和缓存修改共享加锁，合并缓存的修改独占加锁
+    std::unique_ptr<IxChangeBuffer> change_buffer_;
+    std::shared_mutex merge_latch_;
 
    public:
     IxIndexHandle(DiskManager *disk_manager,
                   BufferPoolManager *buffer_pool_manager, int fd);
 
+    ~IxIndexHandle();
+
+    // 以下公有接口中的key都是调用者的原始键，索引内部按IxFileHdr::normalized()转换后使用
+    // 有INCLUDE字段时插入和批量构建的key是键之后紧跟payload的索引项，其余接口只读前面的键
     // for search
     bool get_value(const char *key, std::vector<Rid> *result,
                    Transaction *transaction);
@@ -199,7 +306,8 @@ class IxIndexHandle {
     std::pair<IxNodeHandle *, bool> find_leaf_page(const char *key,
                                                    Operation operation,
                                                    Transaction *transaction,
-                                                   bool find_first = false);
+                                                   bool find_first = false,
+                                                   bool find_last = false);
 
     // for insert
     page_id_t insert_entry(const char *key, const Rid &value,
@@ -216,7 +324,7 @@ class IxIndexHandle {
     bool coalesce_or_redistribute(IxNodeHandle *node,
                                   Transaction *transaction = nullptr,
                                   bool *root_is_latched = nullptr);
-    bool adjust_root(IxNodeHandle *old_root_node);
+    bool adjust_root(IxNodeHandle *old_root_node, Transaction *transaction);
 
     void redistribute(IxNodeHandle *neighbor_node, IxNodeHandle *node,
                       IxNodeHandle *parent, int index);
@@ -225,34 +333,133 @@ class IxIndexHandle {
                   IxNodeHandle **parent, int index, Transaction *transaction,
                   bool *root_is_latched);
 
+    // for bulk load
+    bool bulk_load(const std::function<bool(char *, Rid *)> &next_entry,
+                   double fill_factor = IX_BULK_LOAD_FILL_FACTOR);
+
+    // for bloom filter
+    bool may_contain(const char *key) const;
+
+    void build_bloom_filter(int key_len, int bits_per_key);
+
+    void rebuild_bloom_filter();
+
+    bool bloom_filter_full() const;
+
+    void flush_bloom_filter() const;
+
+    const IxBloomFilter *get_bloom_filter() const { return bloom_; }
+
+    uint64_t adaptive_hash_hits() const { return ahi_.hits(); }
+
+    // for resident upper levels
+    void pin_upper_levels();
+
+    void unpin_upper_levels();
+
+    size_t num_resident_pages() const { return resident_pages_.size(); }
+
+    // for change buffer
+    void enable_change_buffer();
+
+    void disable_change_buffer();
+
+    void merge_change_buffer();
+
+    bool merge_change_buffer_batch();
+
+    const IxChangeBuffer *get_change_buffer() const { return change_buffer_.get(); }
+
     Iid lower_bound(const char *key);
 
     Iid upper_bound(const char *key);
 
-    Iid leaf_end() const;
+    Iid leaf_end();
+
+    Iid leaf_begin();
 
-    Iid leaf_begin() const;
+    double estimate_range(const char *lower, const char *upper);
+
+    // 索引文件中的页面数，只用于估计大小
+    int num_pages() const { return file_hdr_->num_pages_; }
 
    private:
     // 辅助函数
     void update_root_page_no(page_id_t root) { file_hdr_->root_page_ = root; }
 
+    const char *index_key(const char *key, char *buf) const;
+
+    uint64_t bloom_hash(const char *key, bool encoded) const;
+
+    bool adaptive_lookup(const char *key, uint64_t hash, Rid *rid, bool *hot);
+
+    void invalidate_leaf(IxNodeHandle *node);
+
     bool is_empty() const { return file_hdr_->root_page_ == IX_NO_PAGE; }
 
+    double estimate_rank(const char *key);
+
+    page_id_t insert_into_tree(const char *key, const Rid &value, Transaction *transaction,
+                               bool *resident = nullptr);
+
+    bool delete_from_tree(const char *key, Transaction *transaction, bool *resident = nullptr);
+
+    void merge_range(const char *lower, const char *upper);
+
+    void count_bloom_key();
+
+    void apply_changes(const std::vector<IxBufferedChange> &changes);
+
+    // for latch crabbing
+    IxNodeHandle *find_leaf_page_optimistic(const char *key, bool resident_only = false);
+
+    bool is_safe(IxNodeHandle *node, const char *key, Operation operation);
+
+    IxNodeHandle *fetch_latched_node(int page_no, Transaction *transaction);
+
+    void release_latched_pages(Transaction *transaction, bool *root_is_latched,
+                               bool keep_last = false);
+
     // for get/create node
     IxNodeHandle *fetch_node(int page_no) const;
 
+    IxNodeHandle *fetch_upper_node(page_id_t page_no) const;
+
+    void try_refresh_upper_levels();
+
+    bool resident_stale() const {
+        return resident_root_ != file_hdr_->root_page_ ||
+               resident_smo_count_ != upper_smo_count_;
+    }
+
     IxNodeHandle *create_node();
 
+    void unpin_node(IxNodeHandle *node, bool is_dirty) const;
+
+    void delete_node(IxNodeHandle *node, Transaction *transaction);
+
+    Iid leaf_iid(IxNodeHandle *leaf, int key_idx) const;
+
     // for maintain data structure
     void maintain_parent(IxNodeHandle *node);
 
-    void erase_leaf(IxNodeHandle *leaf);
+    void erase_leaf(IxNodeHandle *leaf, IxNodeHandle *prev);
 
     void release_node_handle(IxNodeHandle &node);
 
     void maintain_child(IxNodeHandle *node, int child_idx);
 
+    // for packed nodes
+    void split_packed(IxNodeHandle *node, IxNodeHandle *new_node);
+
+    bool can_coalesce_packed(IxNodeHandle *left, IxNodeHandle *right);
+
+    void redistribute_packed(IxNodeHandle *left, IxNodeHandle *right,
+                             IxNodeHandle *parent);
+
+    bool bulk_load_packed(const std::function<bool(char *, Rid *)> &next_entry,
+                          double fill_factor);
+
     // for index test
     Rid get_rid(const Iid &iid) const;
 };
\ No newline at end of file
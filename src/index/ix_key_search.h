@@ -0,0 +1,273 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "defs.h"
+#include "errors.h"
+
+inline int ix_compare(const char *a, const char *b, ColType type, int col_len) {
+    switch (type) {
+        case TYPE_INT: {
+            int ia = *(int *)a;
+            int ib = *(int *)b;
+            return (ia < ib) ? -1 : ((ia > ib) ? 1 : 0);
+        }
+        case TYPE_FLOAT: {
+            float fa = *(float *)a;
+            float fb = *(float *)b;
+            return (fa < fb) ? -1 : ((fa > fb) ? 1 : 0);
+        }
+        case TYPE_STRING:
+            return memcmp(a, b, col_len);
+        default:
+            throw InternalError("Unexpected data type");
+    }
+}
+
+inline int ix_compare(const char *a, const char *b,
+                      const std::vector<ColType> &col_types,
+                      const std::vector<int> &col_lens) {
+    int offset = 0;
+    for (size_t i = 0; i < col_types.size(); ++i) {
+        int res = ix_compare(a + offset, b + offset, col_types[i], col_lens[i]);
+        if (res != 0) return res;
+        offset += col_lens[i];
+    }
+    return 0;
+}
+
+/*
+ * 联合索引的规范化键：各字段转换为按字节比较(memcmp)即得到正确顺序的形式后依次拼接，
+ * 每个字段的长度不变，因此规范化键与原始键等长，整个键的比较只需一次memcmp。
+ * INT：翻转符号位后按大端序存储；
+ * FLOAT：正数翻转符号位、负数翻转所有位后按大端序存储，-0.0先统一为0.0，与ix_compare()认为二者相等一致；
+ * STRING：定长、末尾补0，本身就按字节比较，原样保存。
+ */
+
+inline void ix_encode_key(const char *key, char *out,
+                          const std::vector<ColType> &col_types,
+                          const std::vector<int> &col_lens) {
+    int offset = 0;
+    for (size_t i = 0; i < col_types.size(); i++) {
+        uint32_t bits;
+        switch (col_types[i]) {
+            case TYPE_INT:
+                memcpy(&bits, key + offset, sizeof(bits));
+                bits ^= 0x80000000u;
+                break;
+            case TYPE_FLOAT: {
+                float f;
+                memcpy(&f, key + offset, sizeof(f));
+                if (f == 0) {
+                    f = 0;
+                }
+                memcpy(&bits, &f, sizeof(bits));
+                bits = (bits & 0x80000000u) ? ~bits : bits ^ 0x80000000u;
+                break;
+            }
+            case TYPE_STRING:
+                memcpy(out + offset, key + offset, col_lens[i]);
+                offset += col_lens[i];
+                continue;
+            default:
+                throw InternalError("Unexpected data type");
+        }
+        bits = __builtin_bswap32(bits);
+        memcpy(out + offset, &bits, sizeof(bits));
+        offset += col_lens[i];
+    }
+}
+
+inline void ix_decode_key(const char *key, char *out,
+                          const std::vector<ColType> &col_types,
+                          const std::vector<int> &col_lens) {
+    int offset = 0;
+    for (size_t i = 0; i < col_types.size(); i++) {
+        if (col_types[i] == TYPE_STRING) {
+            memcpy(out + offset, key + offset, col_lens[i]);
+            offset += col_lens[i];
+            continue;
+        }
+        uint32_t bits;
+        memcpy(&bits, key + offset, sizeof(bits));
+        bits = __builtin_bswap32(bits);
+        if (col_types[i] == TYPE_INT) {
+            bits ^= 0x80000000u;
+        } else {
+            bits = (bits & 0x80000000u) ? bits ^ 0x80000000u : ~bits;
+        }
+        memcpy(out + offset, &bits, sizeof(bits));
+        offset += col_lens[i];
+    }
+}
+
+/*
+ * 结点内的键查找。所有查找函数都返回keys[0, n)中排在target之前的键的个数：
+ * UPPER为false时统计 key < target(即lower_bound)，为true时统计 key <= target(即upper_bound)。
+ *
+ * 查找分两段：先用分支无关的二分查找把范围缩小到IX_SEARCH_WINDOW个键以内，
+ * 每一步只用条件传送更新下界，不会因为比较结果难以预测而清空流水线；
+ * 对于4字节的INT/FLOAT键，剩下的窗口恰好落在一两个cache line内，再用SIMD一次比较4个键并计数。
+ */
+constexpr int IX_SEARCH_WINDOW = 16;
+
+/**
+ * @description: 分支无关的二分查找，把答案所在范围缩小到不超过window个键
+ * @return {int} 窗口起点base，答案 = base + 窗口[base, base + n)内排在target之前的键数
+ * @param {int&} n 传入键的总数，传出窗口大小
+ * @param {Before} before before(i)表示第i个键排在target之前
+ */
+template <typename Before>
+inline int ix_narrow(int &n, int window, Before before) {
+    int base = 0;
+    while (n > window) {
+        int half = n / 2;
+        base = before(base + half) ? base + half : base;
+        n -= half;
+    }
+    return base;
+}
+
+template <bool UPPER>
+inline int ix_search_int(const char *keys, int n, const char *target) {
+    int t;
+    memcpy(&t, target, sizeof(int));
+    auto key_at = [keys](int i) {
+        int k;
+        memcpy(&k, keys + i * sizeof(int), sizeof(int));
+        return k;
+    };
+    int base = ix_narrow(n, IX_SEARCH_WINDOW, [&](int i) { return UPPER ? key_at(i) <= t : key_at(i) < t; });
+    const char *window = keys + base * sizeof(int);
+    int cnt = 0;
+    int i = 0;
+#ifdef __SSE2__
+    __m128i tv = _mm_set1_epi32(t);
+    for (; i + 4 <= n; i += 4) {
+        __m128i kv = _mm_loadu_si128(reinterpret_cast<const __m128i *>(window + i * sizeof(int)));
+        // SSE2没有小于等于比较，upper时统计大于target的键再取补
+        __m128i mask = UPPER ? _mm_cmpgt_epi32(kv, tv) : _mm_cmplt_epi32(kv, tv);
+        int bits = __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+        cnt += UPPER ? 4 - bits : bits;
+    }
+#endif
+    for (; i < n; i++) {
+        int k = key_at(base + i);
+        cnt += UPPER ? k <= t : k < t;
+    }
+    return base + cnt;
+}
+
+template <bool UPPER>
+inline int ix_search_float(const char *keys, int n, const char *target) {
+    float t;
+    memcpy(&t, target, sizeof(float));
+    auto key_at = [keys](int i) {
+        float k;
+        memcpy(&k, keys + i * sizeof(float), sizeof(float));
+        return k;
+    };
+    int base = ix_narrow(n, IX_SEARCH_WINDOW, [&](int i) { return UPPER ? key_at(i) <= t : key_at(i) < t; });
+    const char *window = keys + base * sizeof(float);
+    int cnt = 0;
+    int i = 0;
+#ifdef __SSE2__
+    __m128 tv = _mm_set1_ps(t);
+    for (; i + 4 <= n; i += 4) {
+        __m128 kv = _mm_loadu_ps(reinterpret_cast<const float *>(window + i * sizeof(float)));
+        __m128 mask = UPPER ? _mm_cmple_ps(kv, tv) : _mm_cmplt_ps(kv, tv);
+        cnt += __builtin_popcount(_mm_movemask_ps(mask));
+    }
+#endif
+    for (; i < n; i++) {
+        float k = key_at(base + i);
+        cnt += UPPER ? k <= t : k < t;
+    }
+    return base + cnt;
+}
+
+template <bool UPPER>
+inline int ix_search_string(const char *keys, int n, const char *target, int key_len) {
+    if (n == 0) {
+        return 0;
+    }
+    auto before = [&](int i) {
+        int cmp = memcmp(keys + i * key_len, target, key_len);
+        return UPPER ? cmp <= 0 : cmp < 0;
+    };
+    int base = ix_narrow(n, 1, before);
+    return base + before(base);
+}
+
+template <bool UPPER>
+inline int ix_search_multi(const char *keys, int n, const char *target, int key_len,
+                           const std::vector<ColType> &col_types, const std::vector<int> &col_lens) {
+    if (n == 0) {
+        return 0;
+    }
+    auto before = [&](int i) {
+        int cmp = ix_compare(keys + i * key_len, target, col_types, col_lens);
+        return UPPER ? cmp <= 0 : cmp < 0;
+    };
+    int base = ix_narrow(n, 1, before);
+    return base + before(base);
+}
+
+/*
+ * 前缀压缩结点使用的字节序键工具。字符串键定长存储、末尾补0，
+ * 有效长度是去掉末尾的0之后的长度；按字节比较时，有效部分较短的键相当于在后面补0。
+ */
+
+inline int ix_key_sig_len(const char *key, int key_len) {
+    while (key_len > 0 && key[key_len - 1] == 0) {
+        key_len--;
+    }
+    return key_len;
+}
+
+inline int ix_common_prefix(const char *a, const char *b, int key_len) {
+    int i = 0;
+    while (i < key_len && a[i] == b[i]) {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * @description: 比较两个键的有效部分，a_len和b_len是各自的有效长度
+ */
+inline int ix_compare_sig(const char *a, int a_len, const char *b, int b_len) {
+    int res = memcmp(a, b, std::min(a_len, b_len));
+    if (res != 0) {
+        return res;
+    }
+    return (a_len > b_len) - (a_len < b_len);
+}
+
+/**
+ * @description: 为a < b取最短的分隔键sep，满足a < sep <= b：取b的前(公共前缀长度 + 1)个字节，其余补0
+ * @return {int} sep的有效长度
+ */
+inline int ix_shortest_separator(const char *a, const char *b, int key_len, char *sep) {
+    int len = std::min(ix_common_prefix(a, b, key_len) + 1, key_len);
+    memcpy(sep, b, len);
+    memset(sep + len, 0, key_len - len);
+    return ix_key_sig_len(sep, len);
+}
@@ -13,7 +13,9 @@ See the Mulan PSL v2 for more details. */
 #include <memory>
 #include <string>
 
+#include "ix_bitmap_index_handle.h"
 #include "ix_defs.h"
+#include "ix_hash_index_handle.h"
 #include "ix_index_handle.h"
 #include "system/sm_meta.h"
 
@@ -59,9 +61,29 @@ class IxManager {
         return disk_manager_->is_file(ix_name);
     }
 
+    // 索引文件以index_cols命名，键由index_cols组成；include_cols依次存放成叶结点中的payload，不参与比较
     void create_index(const std::string &filename,
-                      const std::vector<ColMeta> &index_cols) {
+                      const std::vector<ColMeta> &index_cols,
+                      const std::vector<ColMeta> &include_cols = {}) {
         std::string ix_name = get_index_name(filename, index_cols);
+        int col_tot_len = 0;
+        int col_num = index_cols.size();
+        for (auto &col : index_cols) {
+            col_tot_len += col.len;
+        }
+        if (col_tot_len > IX_MAX_COL_LEN) {
+            throw InvalidColLengthError(col_tot_len);
+        }
+        int payload_len = 0;
+        for (auto &col : include_cols) {
+            payload_len += col.len;
+        }
+        // 带payload的叶结点每项多占payload_len字节，同样预留一个空位
+        int leaf_order = static_cast<int>(
+            (PAGE_SIZE - sizeof(IxPageHdr)) / (col_tot_len + sizeof(Rid) + payload_len) - 1);
+        if (payload_len > 0 && leaf_order <= 2) {
+            throw InvalidColLengthError(col_tot_len + payload_len);
+        }
         // Create index file
         disk_manager_->create_file(ix_name);
         // Open index file
@@ -71,14 +93,6 @@ class IxManager {
         // Theoretically we have: |page_hdr| + (|attr| + |rid|) * n <= PAGE_SIZE
         // but we reserve one slot for convenient inserting and deleting, i.e.
         // |page_hdr| + (|attr| + |rid|) * (n + 1) <= PAGE_SIZE
-        int col_tot_len = 0;
-        int col_num = index_cols.size();
-        for (auto &col : index_cols) {
-            col_tot_len += col.len;
-        }
-        if (col_tot_len > IX_MAX_COL_LEN) {
-            throw InvalidColLengthError(col_tot_len);
-        }
         // 根据 |page_hdr| + (|attr| + |rid|) * (n + 1) <= PAGE_SIZE
         // 求得n的最大值btree_order 即 n <=
         // btree_order，那么btree_order就是每个结点最多可插入的键值对数量（实际还多留了一个空位，但其不可插入）
@@ -95,6 +109,10 @@ class IxManager {
             fhdr->col_types_.push_back(index_cols[i].type);
             fhdr->col_lens_.push_back(index_cols[i].len);
         }
+        if (payload_len > 0) {
+            fhdr->payload_len_ = payload_len;
+            fhdr->leaf_order_ = leaf_order;
+        }
         fhdr->update_tot_len();
 
         char *data = new char[fhdr->tot_len_];
@@ -134,6 +152,11 @@ class IxManager {
                 .is_leaf = true,
                 .prev_leaf = IX_LEAF_HEADER_PAGE,
                 .next_leaf = IX_LEAF_HEADER_PAGE,
+                .prefix_len = 0,
+                .low_len = -1,  // 根结点的范围是(负无穷, 正无穷)
+                .high_len = -1,
+                .heap_offset = PAGE_SIZE,
+                .data_bytes = 0,
             };
             // Must write PAGE_SIZE here in case of future fetch_node()
             disk_manager_->write_page(fd, IX_INIT_ROOT_PAGE, page_buf,
@@ -146,6 +169,80 @@ class IxManager {
         disk_manager_->close_file(fd);
     }
 
+    /**
+     * @description: 创建可扩展哈希索引文件
+     * 第0页是文件头，第1页是目录页，第2页是初始时唯一的桶，全局深度和局部深度都为0
+     */
+    void create_hash_index(const std::string &filename,
+                           const std::vector<ColMeta> &index_cols) {
+        std::string ix_name = get_index_name(filename, index_cols);
+        disk_manager_->create_file(ix_name);
+        int fd = disk_manager_->open_file(ix_name);
+
+        IxHashFileHdr fhdr;
+        fhdr.num_pages_ = IX_HASH_INIT_NUM_PAGES;
+        fhdr.col_num_ = index_cols.size();
+        for (auto &col : index_cols) {
+            fhdr.col_types_.push_back(col.type);
+            fhdr.col_lens_.push_back(col.len);
+            fhdr.col_tot_len_ += col.len;
+        }
+        if (fhdr.col_tot_len_ > IX_MAX_COL_LEN) {
+            throw InvalidColLengthError(fhdr.col_tot_len_);
+        }
+        int page_capacity = static_cast<int>(
+            (PAGE_SIZE - sizeof(IxHashBucketHdr)) / (fhdr.col_tot_len_ + sizeof(Rid)));
+        fhdr.bucket_capacity_ = std::min(BUCKET_SIZE, page_capacity);
+        fhdr.global_depth_ = 0;
+        fhdr.dir_pages_.push_back(IX_HASH_DIR_PAGE);
+
+        char page_buf[PAGE_SIZE];
+        memset(page_buf, 0, PAGE_SIZE);
+        fhdr.serialize(page_buf);
+        disk_manager_->write_page(fd, IX_FILE_HDR_PAGE, page_buf, PAGE_SIZE);
+
+        memset(page_buf, 0, PAGE_SIZE);
+        *reinterpret_cast<page_id_t *>(page_buf) = IX_HASH_INIT_BUCKET_PAGE;
+        disk_manager_->write_page(fd, IX_HASH_DIR_PAGE, page_buf, PAGE_SIZE);
+
+        memset(page_buf, 0, PAGE_SIZE);
+        *reinterpret_cast<IxHashBucketHdr *>(page_buf) = {
+            .local_depth = 0, .pattern = 0, .num_key = 0};
+        disk_manager_->write_page(fd, IX_HASH_INIT_BUCKET_PAGE, page_buf,
+                                  PAGE_SIZE);
+
+        disk_manager_->close_file(fd);
+    }
+
+    /**
+     * @description: 创建位图索引文件，只有第0页的文件头，还没有任何键
+     */
+    void create_bitmap_index(const std::string &filename,
+                             const std::vector<ColMeta> &index_cols) {
+        std::string ix_name = get_index_name(filename, index_cols);
+        disk_manager_->create_file(ix_name);
+        int fd = disk_manager_->open_file(ix_name);
+
+        IxBitmapFileHdr fhdr;
+        fhdr.num_pages_ = IX_BITMAP_INIT_NUM_PAGES;
+        fhdr.col_num_ = index_cols.size();
+        for (auto &col : index_cols) {
+            fhdr.col_types_.push_back(col.type);
+            fhdr.col_lens_.push_back(col.len);
+            fhdr.col_tot_len_ += col.len;
+        }
+        if (fhdr.col_tot_len_ > IX_MAX_COL_LEN) {
+            throw InvalidColLengthError(fhdr.col_tot_len_);
+        }
+
+        char page_buf[PAGE_SIZE];
+        memset(page_buf, 0, PAGE_SIZE);
+        fhdr.serialize(page_buf);
+        disk_manager_->write_page(fd, IX_FILE_HDR_PAGE, page_buf, PAGE_SIZE);
+
+        disk_manager_->close_file(fd);
+    }
+
     void destroy_index(const std::string &filename,
                        const std::vector<ColMeta> &index_cols) {
         std::string ix_name = get_index_name(filename, index_cols);
@@ -176,13 +273,46 @@ class IxManager {
                                                buffer_pool_manager_, fd);
     }
 
-    void close_index(const IxIndexHandle *ih) {
+    std::unique_ptr<IxHashIndexHandle> open_hash_index(
+        const std::string &filename, const std::vector<ColMeta> &index_cols) {
+        std::string ix_name = get_index_name(filename, index_cols);
+        int fd = disk_manager_->open_file(ix_name);
+        return std::make_unique<IxHashIndexHandle>(disk_manager_,
+                                                   buffer_pool_manager_, fd);
+    }
+
+    std::unique_ptr<IxBitmapIndexHandle> open_bitmap_index(
+        const std::string &filename, const std::vector<ColMeta> &index_cols) {
+        std::string ix_name = get_index_name(filename, index_cols);
+        int fd = disk_manager_->open_file(ix_name);
+        return std::make_unique<IxBitmapIndexHandle>(disk_manager_, buffer_pool_manager_, fd);
+    }
+
+    void close_index(IxBitmapIndexHandle *ih) {
+        ih->flush();
+        buffer_pool_manager_->discard_all_pages(ih->fd_);
+        disk_manager_->close_file(ih->fd_);
+    }
+
+    void close_index(const IxHashIndexHandle *ih) {
+        char data[PAGE_SIZE];
+        memset(data, 0, PAGE_SIZE);
+        ih->file_hdr_->serialize(data);
+        disk_manager_->write_page(ih->fd_, IX_FILE_HDR_PAGE, data, PAGE_SIZE);
+        buffer_pool_manager_->discard_all_pages(ih->fd_);
+        disk_manager_->close_file(ih->fd_);
+    }
+
+    void close_index(IxIndexHandle *ih) {
+        ih->disable_change_buffer();
+        ih->unpin_upper_levels();
+        ih->flush_bloom_filter();  // 同时把过滤器的键数记入文件头
         char *data = new char[ih->file_hdr_->tot_len_];
         ih->file_hdr_->serialize(data);
         disk_manager_->write_page(ih->fd_, IX_FILE_HDR_PAGE, data,
                                   ih->file_hdr_->tot_len_);
         // 缓冲区的所有页刷到磁盘，注意这句话必须写在close_file前面
-        buffer_pool_manager_->flush_all_pages(ih->fd_);
+        buffer_pool_manager_->discard_all_pages(ih->fd_);
         disk_manager_->close_file(ih->fd_);
     }
 };
\ No newline at end of file
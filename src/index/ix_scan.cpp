@@ -10,23 +10,199 @@ See the Mulan PSL v2 for more details. */
 
 #include "ix_scan.h"
 
+IxScan::IxScan(IxIndexHandle *ih, const Iid &lower, const Iid &upper,
+               BufferPoolManager *bpm)
+    : ih_(ih), iid_(lower), end_(upper), bpm_(bpm) {
+    if (is_end()) {
+        return;
+    }
+    int key_len = ih_->file_hdr_->col_tot_len_;
+    // 记下范围两端的key，之后按key而不是按位置判断范围
+    IxNodeHandle *node = ih_->fetch_node(end_.page_no);
+    node->page->rlatch();
+    if (end_.slot_no < node->get_size()) {
+        end_key_.resize(key_len);
+        node->copy_key(end_.slot_no, end_key_.data());
+    }
+    node->page->runlatch();
+    ih_->unpin_node(node, false);
+
+    node = ih_->fetch_node(iid_.page_no);
+    node->page->rlatch();
+    if (iid_.slot_no < node->get_size()) {
+        resume_key_.resize(key_len);
+        node->copy_key(iid_.slot_no, resume_key_.data());
+    }
+    read_leaf(node);
+    if (batch_.empty()) {
+        next_leaf();
+    }
+}
+
+IxScan::IxScan(IxIndexHandle *ih, const char *lower_key, const char *upper_key,
+               BufferPoolManager *bpm, bool with_keys, bool reverse)
+    : ih_(ih),
+      iid_{.page_no = IX_NO_PAGE, .slot_no = -1},
+      end_{.page_no = IX_NO_PAGE, .slot_no = -1},
+      bpm_(bpm),
+      with_keys_(with_keys),
+      reverse_(reverse) {
+    ih_->merge_range(lower_key, upper_key);
+    int key_len = ih_->file_hdr_->col_tot_len_;
+    char buf[IX_MAX_COL_LEN];
+    // 反向扫描时上界是起点，下界是终点
+    const char *begin_key = reverse_ ? upper_key : lower_key;
+    const char *end_key = reverse_ ? lower_key : upper_key;
+    if (end_key != nullptr) {
+        end_key = ih_->index_key(end_key, buf);
+        end_key_.assign(end_key, end_key + key_len);
+        end_inclusive_ = true;
+    }
+    if (begin_key != nullptr) {
+        begin_key = ih_->index_key(begin_key, buf);
+        resume_key_.assign(begin_key, begin_key + key_len);
+    }
+    IxNodeHandle *node =
+        ih_->find_leaf_page(resume_key_.data(), Operation::FIND, nullptr,
+                            begin_key == nullptr && !reverse_,
+                            begin_key == nullptr && reverse_)
+            .first;
+    int slot;
+    if (!reverse_) {
+        slot = begin_key == nullptr ? 0 : node->lower_bound(resume_key_.data());
+    } else {
+        slot = (begin_key == nullptr ? node->get_size()
+                                     : node->upper_bound(resume_key_.data())) - 1;
+    }
+    iid_ = Iid{.page_no = node->get_page_no(), .slot_no = slot};
+    read_leaf(node);
+    if (batch_.empty()) {
+        next_leaf();
+    }
+}
+
 /**
- * @brief
- * @todo 加上读锁（需要使用缓冲池得到page）
+ * @brief 从已加读锁的叶结点node中按扫描方向复制iid_开始、在范围内的rid(with_keys_时还有键)，然后释放node
  */
+void IxScan::read_leaf(IxNodeHandle *node) {
+    assert(node->is_leaf_page());
+    smo_count_ = ih_->leaf_smo_count_;
+    batch_.clear();
+    batch_keys_.clear();
+    batch_pos_ = 0;
+    // 本叶结点中在范围内的槽位是[begin_slot, end_slot)，正向从begin_slot输出，反向从end_slot - 1输出
+    int size = node->get_size();
+    int begin_slot, end_slot;
+    bool last;
+    if (!reverse_) {
+        begin_slot = iid_.slot_no;
+        end_slot = size;
+        if (!end_key_.empty()) {
+            end_slot = end_inclusive_ ? node->upper_bound(end_key_.data())
+                                      : node->lower_bound(end_key_.data());
+        }
+        last = end_slot < size || node->get_page_no() == ih_->file_hdr_->last_leaf_;
+    } else {
+        begin_slot = end_key_.empty() ? 0 : node->lower_bound(end_key_.data());
+        end_slot = iid_.slot_no + 1;
+        last = begin_slot > 0 || node->get_page_no() == ih_->file_hdr_->first_leaf_;
+    }
+    int num = std::max(end_slot - begin_slot, 0);
+    auto slot_at = [&](int i) { return reverse_ ? end_slot - 1 - i : begin_slot + i; };
+    for (int i = 0; i < num; i++) {
+        batch_.push_back(*node->get_rid(slot_at(i)));
+    }
+    if (with_keys_) {
+        const IxFileHdr *file_hdr = ih_->file_hdr_;
+        int key_len = file_hdr->col_tot_len_;
+        int entry_len = file_hdr->entry_len();
+        char buf[IX_MAX_COL_LEN];
+        batch_keys_.resize(num * entry_len);
+        for (int i = 0; i < num; i++) {
+            char *out = batch_keys_.data() + i * entry_len;
+            if (file_hdr->normalized()) {
+                node->copy_key(slot_at(i), buf);
+                ix_decode_key(buf, out, file_hdr->col_types_, file_hdr->col_lens_);
+            } else {
+                node->copy_key(slot_at(i), out);
+            }
+            if (node->has_payload()) {
+                memcpy(out + key_len, node->get_payload(slot_at(i)), file_hdr->payload_len_);
+            }
+        }
+    }
+    if (num > 0) {
+        resume_key_.resize(ih_->file_hdr_->col_tot_len_);
+        node->copy_key(slot_at(num - 1), resume_key_.data());
+        resume_after_ = true;
+    }
+    if (last) {
+        next_leaf_ = IX_NO_PAGE;
+    } else {
+        next_leaf_ = reverse_ ? node->get_prev_leaf() : node->get_next_leaf();
+    }
+    if (next_leaf_ != IX_NO_PAGE) {
+        // 在处理当前叶结点的同时读入下一个叶结点
+        bpm_->prefetch_page(PageId{ih_->fd_, next_leaf_});
+    }
+    node->page->runlatch();
+    ih_->unpin_node(node, false);
+}
+
+/**
+ * @brief 当前叶结点已经读完，移动到下一个范围内有键的叶结点，没有时到达末尾
+ */
+void IxScan::next_leaf() {
+    while (next_leaf_ != IX_NO_PAGE) {
+        IxNodeHandle *node = ih_->fetch_node(next_leaf_);
+        node->page->rlatch();
+        // 持有下一个叶结点的读锁后再检查：之后涉及它的结构修改都要等待这把锁
+        if (ih_->leaf_smo_count_ == smo_count_ || resume_key_.empty()) {
+            int slot = reverse_ ? node->get_size() - 1 : 0;
+            iid_ = Iid{.page_no = next_leaf_, .slot_no = slot};
+        } else {
+            node->page->runlatch();
+            ih_->unpin_node(node, false);
+            node = ih_->find_leaf_page(resume_key_.data(), Operation::FIND, nullptr).first;
+            int slot;
+            if (!reverse_) {
+                slot = resume_after_ ? node->upper_bound(resume_key_.data())
+                                     : node->lower_bound(resume_key_.data());
+            } else {
+                // 反向时从比resume_key_小(未输出过时不大于它)的最大的key继续
+                slot = (resume_after_ ? node->lower_bound(resume_key_.data())
+                                      : node->upper_bound(resume_key_.data())) - 1;
+            }
+            iid_ = Iid{.page_no = node->get_page_no(), .slot_no = slot};
+        }
+        read_leaf(node);
+        if (!batch_.empty()) {
+            return;
+        }
+    }
+    batch_.clear();
+    batch_keys_.clear();
+    batch_pos_ = 0;
+    iid_ = end_;
+}
+
 void IxScan::next() {
     assert(!is_end());
-    IxNodeHandle *node = ih_->fetch_node(iid_.page_no);
-    assert(node->is_leaf_page());
-    assert(iid_.slot_no < node->get_size());
-    // increment slot no
-    iid_.slot_no++;
-    if (iid_.page_no != ih_->file_hdr_->last_leaf_ &&
-        iid_.slot_no == node->get_size()) {
-        // go to next leaf
-        iid_.slot_no = 0;
-        iid_.page_no = node->get_next_leaf();
+    iid_.slot_no += reverse_ ? -1 : 1;
+    batch_pos_++;
+    if (batch_pos_ == batch_.size()) {
+        next_leaf();
     }
 }
 
-Rid IxScan::rid() const { return ih_->get_rid(iid_); }
\ No newline at end of file
+void IxScan::next_batch(std::vector<Rid> *rids, std::vector<char> *keys) {
+    assert(!is_end());
+    rids->insert(rids->end(), batch_.begin() + batch_pos_, batch_.end());
+    if (keys != nullptr) {
+        assert(with_keys_);
+        size_t entry_len = ih_->file_hdr_->entry_len();
+        keys->insert(keys->end(), batch_keys_.begin() + batch_pos_ * entry_len,
+                     batch_keys_.end());
+    }
+    next_leaf();
+}
@@ -15,25 +15,59 @@ See the Mulan PSL v2 for more details. */
 
 // class IxIndexHandle;
 
-// 用于遍历叶子结点
 // 用于直接遍历叶子结点，而不用findleafpage来得到叶子结点
-// TODO：对page遍历时，要加上读锁
+// 按叶结点批量读取：每到一个叶结点，在读锁下把范围内的rid一次复制到batch_中，
+// 并在释放该叶结点之前预读下一个叶结点，之后的next()和rid()只访问batch_，不再访问页面。
+// 任何时候最多持有一个叶结点的读锁，不会在持锁时等待下一个叶结点。
+// 离开叶结点后如果有叶结点分裂、合并或重分配，键可能已经移到左边的叶结点，
+// 这时用最后读到的key从根结点重新定位，而不是沿next_leaf继续。
+// 反向扫描从上界开始沿prev_leaf按键的降序输出，加锁方式相同，重新定位时找比最后输出的key小的位置
 class IxScan : public RecScan {
-    const IxIndexHandle *ih_;
+    IxIndexHandle *ih_;
     Iid iid_;  // 初始为lower（用于遍历的指针）
     Iid end_;  // 初始为upper
     BufferPoolManager *bpm_;
 
+    std::vector<Rid> batch_;  // 当前叶结点中从iid_开始、在范围内的rid
+    bool with_keys_ = false;        // 是否同时输出键，供仅索引扫描使用
+    std::vector<char> batch_keys_;  // with_keys_时batch_中每个rid对应的索引项(键和payload)，键已转换为调用者的原始格式
+    size_t batch_pos_ = 0;    // iid_对应batch_中的位置
+    page_id_t next_leaf_ = IX_NO_PAGE;  // 当前叶结点之后要读取的叶结点，已到范围末尾时为IX_NO_PAGE
+    uint64_t smo_count_ = 0;            // 读取当前叶结点时的IxIndexHandle::leaf_smo_count_
+    bool reverse_ = false;              // 是否反向扫描，以下的"之后"、"末尾"都按扫描方向
+    std::vector<char> end_key_;         // 范围末尾的key(反向扫描时是下界)，范围到索引末尾时为空
+    bool end_inclusive_ = false;        // end_key_本身是否在范围内
+    std::vector<char> resume_key_;      // 重新定位用的key：还没有输出时是第一个key，之后是最后输出的key
+    bool resume_after_ = false;         // 重新定位时是否跳过等于resume_key_的key
+
    public:
-    IxScan(const IxIndexHandle *ih, const Iid &lower, const Iid &upper,
-           BufferPoolManager *bpm)
-        : ih_(ih), iid_(lower), end_(upper), bpm_(bpm) {}
+    // 扫描[lower, upper)之间的位置，位置由调用者事先用lower_bound()/upper_bound()求得
+    IxScan(IxIndexHandle *ih, const Iid &lower, const Iid &upper,
+           BufferPoolManager *bpm);
+
+    // 扫描key在[lower_key, upper_key]之间的项，key为调用者的原始键，nullptr表示这一端不限；
+    // 定位和读取第一个叶结点在同一把读锁下完成，不受并发修改影响。
+    // with_keys为true时next_batch()可以同时取出各项的键；reverse为true时从upper_key开始按降序输出
+    IxScan(IxIndexHandle *ih, const char *lower_key, const char *upper_key,
+           BufferPoolManager *bpm, bool with_keys = false, bool reverse = false);
 
     void next() override;
 
+    /**
+     * @description: 批量输出，取出当前叶结点中剩余的所有rid追加到rids，并移动到下一个叶结点
+     * @param keys 不为空时把对应的索引项(键之后紧跟payload，每项长为entry_len())追加到keys，
+     * 只能用于with_keys的扫描
+     */
+    void next_batch(std::vector<Rid> *rids, std::vector<char> *keys = nullptr);
+
     bool is_end() const override { return iid_ == end_; }
 
-    Rid rid() const override;
+    Rid rid() const override { return batch_[batch_pos_]; }
 
     const Iid &iid() const { return iid_; }
-};
\ No newline at end of file
+
+   private:
+    void read_leaf(IxNodeHandle *node);
+
+    void next_leaf();
+};
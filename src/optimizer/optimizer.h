@@ -39,6 +39,10 @@ class Optimizer {
                        query->parse)) {
             // show tables;
             return std::make_shared<OtherPlan>(T_ShowTable, std::string());
+        } else if (auto x =
+                       std::dynamic_pointer_cast<ast::SetKnob>(query->parse)) {
+            // set name = value;
+            return std::make_shared<SetKnobPlan>(x->name, x->value);
         } else if (auto x = std::dynamic_pointer_cast<ast::DescTable>(
                        query->parse)) {
             // desc table;
@@ -23,11 +23,13 @@ typedef enum PlanTag {
     T_Invalid = 1,
     T_Help,
     T_ShowTable,
+    T_SetKnob,
     T_DescTable,
     T_CreateTable,
     T_DropTable,
     T_CreateIndex,
     T_DropIndex,
+    T_VacuumTable,
     T_Insert,
     T_Update,
     T_Delete,
@@ -38,8 +40,11 @@ typedef enum PlanTag {
     T_Transaction_rollback,
     T_SeqScan,
     T_IndexScan,
+    T_BitmapScan,  // 用位图索引求出满足谓词的rid集合，再按页面顺序读取记录
     T_NestLoop,
+    T_IndexNestLoop,  // 右儿子为内表上的索引扫描，对每个外层元组探测一次索引
     T_Sort,
+    T_Limit,
     T_Projection
 } PlanTag;
 
@@ -72,6 +77,10 @@ class ScanPlan : public Plan {
     size_t len_;
     std::vector<Condition> fed_conds_;
     std::vector<std::string> index_col_names_;
+    bool index_only_ = false;  // 查询用到的本表字段都在索引项中，不需要访问表的数据文件
+    bool reverse_ = false;     // 按索引键的降序扫描，用于ORDER BY ... DESC
+    bool ordered_ = false;     // 上层依赖按索引键有序的输出，代替了排序
+    bool bitmap_heap_ = false;  // 先取出范围内的全部rid，按页面顺序读表，输出不再按索引键有序
 };
 
 class JoinPlan : public Plan {
@@ -123,6 +132,18 @@ class SortPlan : public Plan {
     bool is_desc_;
 };
 
+class LimitPlan : public Plan {
+   public:
+    LimitPlan(PlanTag tag, std::shared_ptr<Plan> subplan, int limit) {
+        Plan::tag = tag;
+        subplan_ = std::move(subplan);
+        limit_ = limit;
+    }
+    ~LimitPlan() {}
+    std::shared_ptr<Plan> subplan_;
+    int limit_;  // 最多输出的元组数
+};
+
 // dml语句，包括insert; delete; update; select语句　
 class DMLPlan : public Plan {
    public:
@@ -148,16 +169,21 @@ class DMLPlan : public Plan {
 class DDLPlan : public Plan {
    public:
     DDLPlan(PlanTag tag, std::string tab_name,
-            std::vector<std::string> col_names, std::vector<ColDef> cols) {
+            std::vector<std::string> col_names, std::vector<ColDef> cols,
+            TabOptions options = TabOptions()) {
         Plan::tag = tag;
         tab_name_ = std::move(tab_name);
         cols_ = std::move(cols);
         tab_col_names_ = std::move(col_names);
+        options_ = options;
     }
     ~DDLPlan() {}
     std::string tab_name_;
     std::vector<std::string> tab_col_names_;
     std::vector<ColDef> cols_;
+    TabOptions options_;
+    IndexType index_type_ = INDEX_BTREE;  // CREATE INDEX的索引组织方式
+    std::vector<std::string> include_col_names_;  // CREATE INDEX的INCLUDE字段
 };
 
 // help; show tables; desc tables; begin; abort; commit; rollback语句对应的plan
@@ -171,6 +197,17 @@ class OtherPlan : public Plan {
     std::string tab_name_;
 };
 
+// set name = value语句对应的plan
+class SetKnobPlan : public OtherPlan {
+   public:
+    SetKnobPlan(std::string name, int value)
+        : OtherPlan(T_SetKnob, std::string()),
+          name_(std::move(name)),
+          value_(value) {}
+    std::string name_;
+    int value_;
+};
+
 class plannerInfo {
    public:
     std::shared_ptr<ast::SelectStmt> parse;
@@ -10,9 +10,12 @@ See the Mulan PSL v2 for more details. */
 
 #include "planner.h"
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 
 #include "execution/executor_delete.h"
+#include "execution/executor_index_nestedloop_join.h"
 #include "execution/executor_index_scan.h"
 #include "execution/executor_insert.h"
 #include "execution/executor_nestedloop_join.h"
@@ -22,19 +25,106 @@ See the Mulan PSL v2 for more details. */
 #include "index/ix.h"
 #include "record_printer.h"
 
-// 目前的索引匹配规则为：完全匹配索引字段，且全部为单点查询，不会自动调整where条件的顺序
+// 目前的索引匹配规则为：
+// 1. 优先选择所有字段都有等值条件的哈希索引，与条件的顺序无关，等值查找只需访问一个桶；
+// 2. 否则完全匹配B+树索引的字段，且全部为单点查询，不会自动调整where条件的顺序；
+// 3. 否则选择开头若干字段有等值条件、下一个字段有范围条件的B+树索引，匹配字段最多的优先，
+//    按范围扫描索引，命中的记录多时由mark_bitmap_heap_scans()改为按页面顺序读表；
+// 位图索引不在这里选择，见has_bitmap_index()
 bool Planner::get_index_cols(std::string tab_name,
                              std::vector<Condition> curr_conds,
                              std::vector<std::string> &index_col_names) {
     index_col_names.clear();
+    TabMeta &tab = sm_manager_->db_.get_table(tab_name);
+    for (auto &index : tab.indexes) {
+        if (index.type != INDEX_HASH) {
+            continue;
+        }
+        bool all_equal = true;
+        for (auto &col : index.cols) {
+            all_equal = std::any_of(
+                curr_conds.begin(), curr_conds.end(), [&](const Condition &cond) {
+                    return cond.is_rhs_val && cond.op == OP_EQ &&
+                           cond.lhs_col.tab_name == tab_name &&
+                           cond.lhs_col.col_name == col.name &&
+                           cond.rhs_val.type == col.type;
+                });
+            if (!all_equal) {
+                break;
+            }
+        }
+        if (all_equal) {
+            for (auto &col : index.cols) {
+                index_col_names.push_back(col.name);
+            }
+            return true;
+        }
+    }
     for (auto &cond : curr_conds) {
         if (cond.is_rhs_val && cond.op == OP_EQ &&
             cond.lhs_col.tab_name.compare(tab_name) == 0)
             index_col_names.push_back(cond.lhs_col.col_name);
     }
+    if (tab.is_index(index_col_names) &&
+        tab.get_index_meta(index_col_names)->type == INDEX_BTREE)
+        return true;
+    index_col_names.clear();
+    size_t best_matched = 0;
+    for (auto &index : tab.indexes) {
+        if (index.type != INDEX_BTREE) {
+            continue;
+        }
+        size_t matched = 0;
+        for (auto &col : index.cols) {
+            bool equal = false, ranged = false;
+            for (auto &cond : curr_conds) {
+                if (cond.is_rhs_val && cond.op != OP_NE && cond.lhs_col.tab_name == tab_name &&
+                    cond.lhs_col.col_name == col.name && cond.rhs_val.type == col.type) {
+                    equal |= cond.op == OP_EQ;
+                    ranged = true;
+                }
+            }
+            matched += ranged;
+            if (!equal) {
+                break;
+            }
+        }
+        if (matched > best_matched) {
+            best_matched = matched;
+            index_col_names.clear();
+            for (auto &col : index.cols) {
+                index_col_names.push_back(col.name);
+            }
+        }
+    }
+    return best_matched > 0;
+}
+
+/**
+ * @brief 没有可用的B+树索引和哈希索引时，表上是否有位图索引能回答某个"字段 op 常量"谓词；
+ * 单字段位图索引可以回答除不等于以外的谓词，多字段位图索引要求所有字段都有等值条件。
+ * 有就改用位图扫描，能回答的谓词都由位图求交集完成，只读取交集中的记录
+ */
+bool Planner::has_bitmap_index(const std::string &tab_name,
+                               const std::vector<Condition> &curr_conds) {
     TabMeta &tab = sm_manager_->db_.get_table(tab_name);
-    if (tab.is_index(index_col_names)) return true;
-    return false;
+    auto has_cond = [&](const ColMeta &col, bool equal) {
+        return std::any_of(curr_conds.begin(), curr_conds.end(), [&](const Condition &cond) {
+            return cond.is_rhs_val && cond.op != OP_NE && (!equal || cond.op == OP_EQ) &&
+                   cond.lhs_col.tab_name == tab_name && cond.lhs_col.col_name == col.name &&
+                   cond.rhs_val.type == col.type;
+        });
+    };
+    return std::any_of(tab.indexes.begin(), tab.indexes.end(), [&](const IndexMeta &index) {
+        if (index.type != INDEX_BITMAP) {
+            return false;
+        }
+        if (index.cols.size() == 1) {
+            return has_cond(index.cols[0], false);
+        }
+        return std::all_of(index.cols.begin(), index.cols.end(),
+                           [&](const ColMeta &col) { return has_cond(col, true); });
+    });
 }
 
 /**
@@ -130,10 +220,18 @@ std::shared_ptr<Plan> Planner::physical_optimization(
     std::shared_ptr<Plan> plan = make_one_rel(query);
 
     // 其他物理优化
+    // 内表有可用索引时改为索引嵌套循环连接
+    plan = make_index_joins(std::move(plan));
 
     // 处理orderby
     plan = generate_sort_plan(query, std::move(plan));
 
+    // 处理limit
+    auto x = std::dynamic_pointer_cast<ast::SelectStmt>(query->parse);
+    if (x->limit >= 0) {
+        plan = std::make_shared<LimitPlan>(T_Limit, std::move(plan), x->limit);
+    }
+
     return plan;
 }
 
@@ -150,8 +248,9 @@ std::shared_ptr<Plan> Planner::make_one_rel(std::shared_ptr<Query> query) {
             get_index_cols(tables[i], curr_conds, index_col_names);
         if (index_exist == false) {  // 该表没有索引
             index_col_names.clear();
+            PlanTag tag = has_bitmap_index(tables[i], curr_conds) ? T_BitmapScan : T_SeqScan;
             table_scan_executors[i] = std::make_shared<ScanPlan>(
-                T_SeqScan, sm_manager_, tables[i], curr_conds, index_col_names);
+                tag, sm_manager_, tables[i], curr_conds, index_col_names);
         } else {  // 存在索引
             table_scan_executors[i] =
                 std::make_shared<ScanPlan>(T_IndexScan, sm_manager_, tables[i],
@@ -258,6 +357,138 @@ std::shared_ptr<Plan> Planner::make_one_rel(std::shared_ptr<Query> query) {
     return table_join_executors;
 }
 
+/**
+ * @brief 为连接选择内表上的索引：索引的前缀字段依次有等值条件，之后可以有一个范围条件，
+ * 且其中至少一个条件来自连接条件；哈希索引要求所有字段都有等值条件。
+ * 等值条件计2分、范围条件计1分，哈希索引额外加1分，选得分最高的索引
+ * @param scan_conds 内表自身的条件
+ * @param join_conds 连接条件，形式为"外层字段 op 内表字段"
+ */
+bool Planner::get_join_index_cols(const std::string &tab_name,
+                                  const std::vector<Condition> &scan_conds,
+                                  const std::vector<Condition> &join_conds,
+                                  std::vector<std::string> &index_col_names) {
+    index_col_names.clear();
+    TabMeta &tab = sm_manager_->db_.get_table(tab_name);
+    // 字段col上是否有等值(equal)或范围(!equal)条件，from_join记录条件是否来自连接条件
+    auto find_cond = [&](const ColMeta &col, bool equal, bool *from_join) {
+        for (auto &cond : join_conds) {
+            if (cond.rhs_col.tab_name == tab_name && cond.rhs_col.col_name == col.name &&
+                cond.op != OP_NE && (cond.op == OP_EQ) == equal) {
+                *from_join = true;
+                return true;
+            }
+        }
+        return std::any_of(scan_conds.begin(), scan_conds.end(), [&](const Condition &cond) {
+            return cond.is_rhs_val && cond.lhs_col.tab_name == tab_name &&
+                   cond.lhs_col.col_name == col.name && cond.rhs_val.type == col.type &&
+                   cond.op != OP_NE && (cond.op == OP_EQ) == equal;
+        });
+    };
+    int best = 0;
+    for (auto &index : tab.indexes) {
+        if (index.type == INDEX_BITMAP) {
+            continue;  // 位图扫描要先求出整个交集，不适合每个外层元组探测一次
+        }
+        if (!index.entry_per_row()) {
+            continue;  // 每个外层元组要找到全部匹配的记录
+        }
+        int score = 0;
+        bool uses_join = false;
+        for (auto &col : index.cols) {
+            if (find_cond(col, true, &uses_join)) {
+                score += 2;
+                continue;
+            }
+            if (index.type == INDEX_HASH) {
+                score = 0;
+            } else if (find_cond(col, false, &uses_join)) {
+                score += 1;
+            }
+            break;
+        }
+        if (index.type == INDEX_HASH && score > 0) {
+            score++;
+        }
+        if (uses_join && score > best) {
+            best = score;
+            index_col_names.clear();
+            for (auto &col : index.cols) {
+                index_col_names.push_back(col.name);
+            }
+        }
+    }
+    return best > 0;
+}
+
+/**
+ * @brief 把内层是单表扫描、且该表有可用索引的嵌套循环连接改为索引嵌套循环连接
+ * 两边都是单表扫描时，可以交换左右儿子；两边都有可用索引时，以数据页较少的表作为外层
+ */
+std::shared_ptr<Plan> Planner::make_index_joins(std::shared_ptr<Plan> plan) {
+    auto x = std::dynamic_pointer_cast<JoinPlan>(plan);
+    if (x == nullptr) {
+        return plan;
+    }
+    x->left_ = make_index_joins(x->left_);
+    x->right_ = make_index_joins(x->right_);
+    if (x->conds_.empty()) {
+        return plan;
+    }
+    // 外层字段的值直接作为内表字段的值绑定到索引扫描，两边的类型和长度必须相同
+    auto col_meta = [&](const TabCol &col) {
+        return *sm_manager_->db_.get_table(col.tab_name).get_col(col.col_name);
+    };
+    std::map<CompOp, CompOp> swap_op = {
+        {OP_EQ, OP_EQ}, {OP_NE, OP_NE}, {OP_LT, OP_GT},
+        {OP_GT, OP_LT}, {OP_LE, OP_GE}, {OP_GE, OP_LE},
+    };
+    std::vector<Condition> swapped_conds;
+    for (auto &cond : x->conds_) {
+        if (cond.is_rhs_val) {
+            return plan;
+        }
+        ColMeta lhs = col_meta(cond.lhs_col);
+        ColMeta rhs = col_meta(cond.rhs_col);
+        if (lhs.type != rhs.type || lhs.len != rhs.len) {
+            return plan;
+        }
+        Condition swapped = cond;
+        std::swap(swapped.lhs_col, swapped.rhs_col);
+        swapped.op = swap_op.at(cond.op);
+        swapped_conds.push_back(std::move(swapped));
+    }
+
+    auto right_scan = std::dynamic_pointer_cast<ScanPlan>(x->right_);
+    auto left_scan = std::dynamic_pointer_cast<ScanPlan>(x->left_);
+    std::vector<std::string> right_index, left_index;
+    bool right_ok = right_scan != nullptr &&
+                    get_join_index_cols(right_scan->tab_name_, right_scan->conds_,
+                                        x->conds_, right_index);
+    bool left_ok = left_scan != nullptr &&
+                   get_join_index_cols(left_scan->tab_name_, left_scan->conds_,
+                                       swapped_conds, left_index);
+    if (left_ok && right_ok) {
+        auto num_pages = [&](const std::string &tab_name) {
+            return sm_manager_->get_table_handle(tab_name)->num_pages();
+        };
+        left_ok = num_pages(left_scan->tab_name_) > num_pages(right_scan->tab_name_);
+        right_ok = !left_ok;
+    }
+    if (left_ok) {
+        std::swap(x->left_, x->right_);
+        x->conds_ = std::move(swapped_conds);
+        right_scan = left_scan;
+        right_index = std::move(left_index);
+    } else if (!right_ok) {
+        return plan;
+    }
+    right_scan->tag = T_IndexScan;
+    right_scan->index_col_names_ = std::move(right_index);
+    x->tag = T_IndexNestLoop;
+    return plan;
+}
+
 std::shared_ptr<Plan> Planner::generate_sort_plan(std::shared_ptr<Query> query,
                                                   std::shared_ptr<Plan> plan) {
     auto x = std::dynamic_pointer_cast<ast::SelectStmt>(query->parse);
@@ -278,11 +509,162 @@ std::shared_ptr<Plan> Planner::generate_sort_plan(std::shared_ptr<Query> query,
         if (col.name.compare(x->order->cols->col_name) == 0)
             sel_col = {.tab_name = col.tab_name, .col_name = col.name};
     }
+    if (use_index_order(plan, sel_col, x->order->orderby_dir == ast::OrderBy_DESC)) {
+        return plan;
+    }
     return std::make_shared<SortPlan>(
         T_Sort, std::move(plan), sel_col,
         x->order->orderby_dir == ast::OrderBy_DESC);
 }
 
+/**
+ * @brief 单表查询的排序字段在某个B+树索引中、且索引里排在它前面的字段都有等值条件时，
+ * 按这个索引的顺序扫描就得到有序的输出(降序时反向扫描)，不再需要排序；配合LIMIT只读取索引的开头一段
+ * 已经选用的索引不能提供这个顺序时保留它，仍然排序；索引必须为每条记录都存有索引项，否则输出会漏掉记录
+ * @return 是否改用了按索引顺序的扫描
+ */
+bool Planner::use_index_order(std::shared_ptr<Plan> plan, const TabCol &order_col,
+                              bool desc) {
+    auto scan = std::dynamic_pointer_cast<ScanPlan>(plan);
+    if (scan == nullptr || scan->tab_name_ != order_col.tab_name) {
+        return false;
+    }
+    TabMeta &tab = sm_manager_->db_.get_table(scan->tab_name_);
+    auto equal_bound = [&](const ColMeta &col) {
+        return std::any_of(scan->conds_.begin(), scan->conds_.end(),
+                           [&](const Condition &cond) {
+                               return cond.is_rhs_val && cond.op == OP_EQ &&
+                                      cond.lhs_col.tab_name == scan->tab_name_ &&
+                                      cond.lhs_col.col_name == col.name &&
+                                      cond.rhs_val.type == col.type;
+                           });
+    };
+    auto provides_order = [&](const IndexMeta &index) {
+        if (index.type != INDEX_BTREE || !index.entry_per_row()) {
+            return false;
+        }
+        for (auto &col : index.cols) {
+            if (col.name == order_col.col_name) {
+                return true;
+            }
+            if (!equal_bound(col)) {
+                return false;
+            }
+        }
+        return false;
+    };
+    if (scan->tag == T_IndexScan) {
+        if (!provides_order(*tab.get_index_meta(scan->index_col_names_))) {
+            return false;
+        }
+    } else {
+        auto index = std::find_if(tab.indexes.begin(), tab.indexes.end(), provides_order);
+        if (index == tab.indexes.end()) {
+            return false;
+        }
+        scan->tag = T_IndexScan;
+        scan->index_col_names_.clear();
+        for (auto &col : index->cols) {
+            scan->index_col_names_.push_back(col.name);
+        }
+    }
+    scan->reverse_ = desc;
+    scan->ordered_ = true;
+    return true;
+}
+
+/**
+ * @brief 查询用到的某张表的字段(投影、谓词、连接条件、排序)都在所用索引的索引项中时，
+ * 把这张表的索引扫描改为仅索引扫描，不再访问表的数据文件；索引必须为每条记录都存有索引项
+ */
+void Planner::mark_index_only_scans(std::shared_ptr<Plan> plan,
+                                    const std::vector<TabCol> &sel_cols) {
+    std::vector<TabCol> used_cols = sel_cols;
+    std::vector<std::shared_ptr<ScanPlan>> index_scans;
+    auto add_conds = [&](const std::vector<Condition> &conds) {
+        for (auto &cond : conds) {
+            used_cols.push_back(cond.lhs_col);
+            if (!cond.is_rhs_val) {
+                used_cols.push_back(cond.rhs_col);
+            }
+        }
+    };
+    std::function<void(const std::shared_ptr<Plan> &)> collect =
+        [&](const std::shared_ptr<Plan> &node) {
+            if (auto x = std::dynamic_pointer_cast<ScanPlan>(node)) {
+                add_conds(x->conds_);
+                if (x->tag == T_IndexScan) {
+                    index_scans.push_back(x);
+                }
+            } else if (auto x = std::dynamic_pointer_cast<JoinPlan>(node)) {
+                add_conds(x->conds_);
+                collect(x->left_);
+                collect(x->right_);
+            } else if (auto x = std::dynamic_pointer_cast<SortPlan>(node)) {
+                used_cols.push_back(x->sel_col_);
+                collect(x->subplan_);
+            } else if (auto x = std::dynamic_pointer_cast<LimitPlan>(node)) {
+                collect(x->subplan_);
+            } else if (auto x = std::dynamic_pointer_cast<ProjectionPlan>(node)) {
+                collect(x->subplan_);
+            }
+        };
+    collect(plan);
+
+    for (auto &scan : index_scans) {
+        TabMeta &tab = sm_manager_->db_.get_table(scan->tab_name_);
+        auto index = tab.get_index_meta(scan->index_col_names_);
+        scan->index_only_ = index->entry_per_row() && std::all_of(
+            used_cols.begin(), used_cols.end(), [&](const TabCol &col) {
+                return col.tab_name != scan->tab_name_ ||
+                       index->covers(col.col_name);
+            });
+    }
+}
+
+/**
+ * @brief 估计B+树索引范围扫描命中的记录比例，达到bitmap_heap_scan_pct时改为位图堆扫描：
+ * 先取出范围内的全部rid，按页面顺序每个页面只读一次，避免按键序回表时反复随机访问同一批页面；
+ * 聚簇表按主键顺序回表，依次访问聚簇索引的叶结点
+ * 仅索引扫描、等值查找整个键、上层依赖键序的扫描和索引嵌套循环连接的内表不改
+ */
+void Planner::mark_bitmap_heap_scans(std::shared_ptr<Plan> plan, Context *context) {
+    int pct = context != nullptr && context->session_ != nullptr
+                  ? context->session_->bitmap_heap_scan_pct
+                  : SessionSettings().bitmap_heap_scan_pct;
+    if (auto x = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+        if (x->tag != T_IndexScan || x->index_only_ || x->ordered_) {
+            return;
+        }
+        TabMeta &tab = sm_manager_->db_.get_table(x->tab_name_);
+        IndexMeta &index = *tab.get_index_meta(x->index_col_names_);
+        if (index.type != INDEX_BTREE || (tab.engine != ENGINE_HEAP && tab.engine != ENGINE_CLUSTERED)) {
+            return;  // LSM表和内存表按行号查找记录，没有可以按页面顺序读的文件
+        }
+        std::vector<char> lower, upper;
+        size_t num_equal =
+            IndexScanExecutor::make_key_range(x->tab_name_, index, x->conds_, &lower, &upper);
+        if (num_equal >= index.cols.size()) {
+            return;  // 整个键都是等值条件，是单个键的查找
+        }
+        auto ih = sm_manager_->ihs_
+                      .at(sm_manager_->get_ix_manager()->get_index_name(x->tab_name_, index.cols))
+                      .get();
+        x->bitmap_heap_ = ih->estimate_range(lower.data(), upper.data()) * 100 >= pct;
+    } else if (auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+        mark_bitmap_heap_scans(x->left_, context);
+        if (x->tag != T_IndexNestLoop) {
+            mark_bitmap_heap_scans(x->right_, context);
+        }
+    } else if (auto x = std::dynamic_pointer_cast<SortPlan>(plan)) {
+        mark_bitmap_heap_scans(x->subplan_, context);
+    } else if (auto x = std::dynamic_pointer_cast<LimitPlan>(plan)) {
+        mark_bitmap_heap_scans(x->subplan_, context);
+    } else if (auto x = std::dynamic_pointer_cast<ProjectionPlan>(plan)) {
+        mark_bitmap_heap_scans(x->subplan_, context);
+    }
+}
+
 /**
  * @brief select plan 生成
  *
@@ -298,12 +680,65 @@ std::shared_ptr<Plan> Planner::generate_select_plan(
     // 物理优化
     auto sel_cols = query->cols;
     std::shared_ptr<Plan> plannerRoot = physical_optimization(query, context);
+    mark_index_only_scans(plannerRoot, sel_cols);
+    mark_bitmap_heap_scans(plannerRoot, context);
     plannerRoot = std::make_shared<ProjectionPlan>(
         T_Projection, std::move(plannerRoot), std::move(sel_cols));
 
     return plannerRoot;
 }
 
+/**
+ * @description: 将建表语句中的 name = value 选项转换为TabOptions，名称和取值均不区分大小写
+ * 目前支持 storage = row | pax、engine = heap | lsm | memory、durability = wal | none 和 CLUSTERED BY (cols)，
+ * 聚簇表不能再指定engine，durability只用于内存表
+ */
+TabOptions Planner::interp_table_options(
+    const std::vector<std::shared_ptr<ast::TableOption>> &options) {
+    auto lower = [](std::string str) {
+        std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+        return str;
+    };
+    TabOptions tab_options;
+    std::string engine_name = "heap";
+    std::string durability;
+    for (auto &option : options) {
+        std::string name = lower(option->name);
+        std::string value = lower(option->value);
+        if (name == "storage" && value == "row") {
+            tab_options.layout = RM_LAYOUT_ROW;
+        } else if (name == "storage" && value == "pax") {
+            tab_options.layout = RM_LAYOUT_PAX;
+        } else if (name == "engine" && value == "heap") {
+            tab_options.engine = ENGINE_HEAP;
+            engine_name = value;
+        } else if (name == "engine" && value == "lsm") {
+            tab_options.engine = ENGINE_LSM;
+            engine_name = value;
+        } else if (name == "engine" && value == "memory") {
+            tab_options.engine = ENGINE_MEMORY;
+            engine_name = value;
+        } else if (name == "durability" && (value == "wal" || value == "none")) {
+            tab_options.durable = value == "wal";
+            durability = value;
+        } else if (name == "clustered") {
+            tab_options.cluster_cols = option->cols;
+        } else {
+            throw InvalidTableOptionError(option->name, option->value);
+        }
+    }
+    if (!durability.empty() && tab_options.engine != ENGINE_MEMORY) {
+        throw InvalidTableOptionError("durability", durability + " without engine = memory");
+    }
+    if (!tab_options.cluster_cols.empty()) {
+        if (tab_options.engine != ENGINE_HEAP) {
+            throw InvalidTableOptionError("engine", engine_name + " with CLUSTERED BY");
+        }
+        tab_options.engine = ENGINE_CLUSTERED;
+    }
+    return tab_options;
+}
+
 // 生成DDL语句和DML语句的查询执行计划
 std::shared_ptr<Plan> Planner::do_planner(std::shared_ptr<Query> query,
                                           Context *context) {
@@ -324,18 +759,32 @@ std::shared_ptr<Plan> Planner::do_planner(std::shared_ptr<Query> query,
             }
         }
         plannerRoot = std::make_shared<DDLPlan>(
-            T_CreateTable, x->tab_name, std::vector<std::string>(), col_defs);
+            T_CreateTable, x->tab_name, std::vector<std::string>(), col_defs,
+            interp_table_options(x->options));
     } else if (auto x =
                    std::dynamic_pointer_cast<ast::DropTable>(query->parse)) {
         // drop table;
         plannerRoot = std::make_shared<DDLPlan>(T_DropTable, x->tab_name,
                                                 std::vector<std::string>(),
                                                 std::vector<ColDef>());
+    } else if (auto x =
+                   std::dynamic_pointer_cast<ast::VacuumTable>(query->parse)) {
+        // vacuum table;
+        plannerRoot = std::make_shared<DDLPlan>(T_VacuumTable, x->tab_name,
+                                                std::vector<std::string>(),
+                                                std::vector<ColDef>());
     } else if (auto x =
                    std::dynamic_pointer_cast<ast::CreateIndex>(query->parse)) {
         // create index;
-        plannerRoot = std::make_shared<DDLPlan>(
+        auto plan = std::make_shared<DDLPlan>(
             T_CreateIndex, x->tab_name, x->col_names, std::vector<ColDef>());
+        std::map<ast::IndexMethod, IndexType> index_types = {
+            {ast::IX_METHOD_BTREE, INDEX_BTREE},
+            {ast::IX_METHOD_HASH, INDEX_HASH},
+            {ast::IX_METHOD_BITMAP, INDEX_BITMAP}};
+        plan->index_type_ = index_types.at(x->method);
+        plan->include_col_names_ = x->include_cols;
+        plannerRoot = plan;
     } else if (auto x =
                    std::dynamic_pointer_cast<ast::DropIndex>(query->parse)) {
         // drop index
@@ -360,8 +809,9 @@ std::shared_ptr<Plan> Planner::do_planner(std::shared_ptr<Query> query,
 
         if (index_exist == false) {  // 该表没有索引
             index_col_names.clear();
+            PlanTag tag = has_bitmap_index(x->tab_name, query->conds) ? T_BitmapScan : T_SeqScan;
             table_scan_executors =
-                std::make_shared<ScanPlan>(T_SeqScan, sm_manager_, x->tab_name,
+                std::make_shared<ScanPlan>(tag, sm_manager_, x->tab_name,
                                            query->conds, index_col_names);
         } else {  // 存在索引
             table_scan_executors = std::make_shared<ScanPlan>(
@@ -369,6 +819,7 @@ std::shared_ptr<Plan> Planner::do_planner(std::shared_ptr<Query> query,
                 index_col_names);
         }
 
+        mark_bitmap_heap_scans(table_scan_executors, context);
         plannerRoot = std::make_shared<DMLPlan>(
             T_Delete, table_scan_executors, x->tab_name, std::vector<Value>(),
             query->conds, std::vector<SetClause>());
@@ -385,14 +836,16 @@ std::shared_ptr<Plan> Planner::do_planner(std::shared_ptr<Query> query,
 
         if (index_exist == false) {  // 该表没有索引
             index_col_names.clear();
+            PlanTag tag = has_bitmap_index(x->tab_name, query->conds) ? T_BitmapScan : T_SeqScan;
             table_scan_executors =
-                std::make_shared<ScanPlan>(T_SeqScan, sm_manager_, x->tab_name,
+                std::make_shared<ScanPlan>(tag, sm_manager_, x->tab_name,
                                            query->conds, index_col_names);
         } else {  // 存在索引
             table_scan_executors = std::make_shared<ScanPlan>(
                 T_IndexScan, sm_manager_, x->tab_name, query->conds,
                 index_col_names);
         }
+        mark_bitmap_heap_scans(table_scan_executors, context);
         plannerRoot = std::make_shared<DMLPlan>(
             T_Update, table_scan_executors, x->tab_name, std::vector<Value>(),
             query->conds, query->set_clauses);
@@ -44,16 +44,37 @@ class Planner {
 
     std::shared_ptr<Plan> make_one_rel(std::shared_ptr<Query> query);
 
+    std::shared_ptr<Plan> make_index_joins(std::shared_ptr<Plan> plan);
+
     std::shared_ptr<Plan> generate_sort_plan(std::shared_ptr<Query> query,
                                              std::shared_ptr<Plan> plan);
 
+    bool use_index_order(std::shared_ptr<Plan> plan, const TabCol &order_col,
+                         bool desc);
+
     std::shared_ptr<Plan> generate_select_plan(std::shared_ptr<Query> query,
                                                Context *context);
 
+    void mark_index_only_scans(std::shared_ptr<Plan> plan,
+                               const std::vector<TabCol> &sel_cols);
+
+    void mark_bitmap_heap_scans(std::shared_ptr<Plan> plan, Context *context);
+
     // int get_indexNo(std::string tab_name, std::vector<Condition> curr_conds);
     bool get_index_cols(std::string tab_name, std::vector<Condition> curr_conds,
                         std::vector<std::string> &index_col_names);
 
+    bool has_bitmap_index(const std::string &tab_name,
+                          const std::vector<Condition> &curr_conds);
+
+    bool get_join_index_cols(const std::string &tab_name,
+                             const std::vector<Condition> &scan_conds,
+                             const std::vector<Condition> &join_conds,
+                             std::vector<std::string> &index_col_names);
+
+    TabOptions interp_table_options(
+        const std::vector<std::shared_ptr<ast::TableOption>> &options);
+
     ColType interp_sv_type(ast::SvType sv_type) {
         std::map<ast::SvType, ColType> m = {{ast::SV_TYPE_INT, TYPE_INT},
                                             {ast::SV_TYPE_FLOAT, TYPE_FLOAT},
@@ -22,6 +22,8 @@ enum SvCompOp { SV_OP_EQ, SV_OP_NE, SV_OP_LT, SV_OP_GT, SV_OP_LE, SV_OP_GE };
 
 enum OrderByDir { OrderBy_DEFAULT, OrderBy_ASC, OrderBy_DESC };
 
+enum IndexMethod { IX_METHOD_BTREE, IX_METHOD_HASH, IX_METHOD_BITMAP };  // CREATE INDEX ... USING BTREE | HASH | BITMAP
+
 // Base class for tree nodes
 struct TreeNode {
     virtual ~TreeNode() = default;  // enable polymorphism
@@ -31,6 +33,15 @@ struct Help : public TreeNode {};
 
 struct ShowTables : public TreeNode {};
 
+// SET name = value，修改当前会话的设置
+struct SetKnob : public TreeNode {
+    std::string name;
+    int value;
+
+    SetKnob(std::string name_, int value_)
+        : name(std::move(name_)), value(value_) {}
+};
+
 struct TxnBegin : public TreeNode {};
 
 struct TxnCommit : public TreeNode {};
@@ -56,13 +67,36 @@ struct ColDef : public Field {
         : col_name(std::move(col_name_)), type_len(std::move(type_len_)) {}
 };
 
+// 建表语句中的表选项，形如 name = value
+struct TableOption : public TreeNode {
+    std::string name;
+    std::string value;
+    std::vector<std::string> cols;  // CLUSTERED BY (cols)的字段
+
+    TableOption(std::string name_, std::string value_,
+                std::vector<std::string> cols_ = {})
+        : name(std::move(name_)),
+          value(std::move(value_)),
+          cols(std::move(cols_)) {}
+};
+
 struct CreateTable : public TreeNode {
     std::string tab_name;
     std::vector<std::shared_ptr<Field>> fields;
+    std::vector<std::shared_ptr<TableOption>> options;
 
     CreateTable(std::string tab_name_,
-                std::vector<std::shared_ptr<Field>> fields_)
-        : tab_name(std::move(tab_name_)), fields(std::move(fields_)) {}
+                std::vector<std::shared_ptr<Field>> fields_,
+                std::vector<std::shared_ptr<TableOption>> options_ = {})
+        : tab_name(std::move(tab_name_)),
+          fields(std::move(fields_)),
+          options(std::move(options_)) {}
+};
+
+struct VacuumTable : public TreeNode {
+    std::string tab_name;
+
+    VacuumTable(std::string tab_name_) : tab_name(std::move(tab_name_)) {}
 };
 
 struct DropTable : public TreeNode {
@@ -80,9 +114,16 @@ struct DescTable : public TreeNode {
 struct CreateIndex : public TreeNode {
     std::string tab_name;
     std::vector<std::string> col_names;
+    std::vector<std::string> include_cols;  // INCLUDE (cols)，只存放在叶结点中的字段
+    IndexMethod method;
 
-    CreateIndex(std::string tab_name_, std::vector<std::string> col_names_)
-        : tab_name(std::move(tab_name_)), col_names(std::move(col_names_)) {}
+    CreateIndex(std::string tab_name_, std::vector<std::string> col_names_,
+                std::vector<std::string> include_cols_ = {},
+                IndexMethod method_ = IX_METHOD_BTREE)
+        : tab_name(std::move(tab_name_)),
+          col_names(std::move(col_names_)),
+          include_cols(std::move(include_cols_)),
+          method(method_) {}
 };
 
 struct DropIndex : public TreeNode {
@@ -200,15 +241,17 @@ struct SelectStmt : public TreeNode {
 
     bool has_sort;
     std::shared_ptr<OrderBy> order;
+    int limit;  // LIMIT给出的最多输出行数，-1表示没有LIMIT
 
     SelectStmt(std::vector<std::shared_ptr<Col>> cols_,
                std::vector<std::string> tabs_,
                std::vector<std::shared_ptr<BinaryExpr>> conds_,
-               std::shared_ptr<OrderBy> order_)
+               std::shared_ptr<OrderBy> order_, int limit_ = -1)
         : cols(std::move(cols_)),
           tabs(std::move(tabs_)),
           conds(std::move(conds_)),
-          order(std::move(order_)) {
+          order(std::move(order_)),
+          limit(limit_) {
         has_sort = (bool)order;
     }
 };
@@ -219,6 +262,7 @@ struct SemValue {
     float sv_float;
     std::string sv_str;
     OrderByDir sv_orderby_dir;
+    IndexMethod sv_index_method;
     std::vector<std::string> sv_strs;
 
     std::shared_ptr<TreeNode> sv_node;
@@ -230,6 +274,9 @@ struct SemValue {
     std::shared_ptr<Field> sv_field;
     std::vector<std::shared_ptr<Field>> sv_fields;
 
+    std::shared_ptr<TableOption> sv_table_option;
+    std::vector<std::shared_ptr<TableOption>> sv_table_options;
+
     std::shared_ptr<Expr> sv_expr;
 
     std::shared_ptr<Value> sv_val;
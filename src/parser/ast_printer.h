@@ -80,6 +80,14 @@ class TreePrinter {
             std::cout << "CREATE_TABLE\n";
             print_val(x->tab_name, offset);
             print_node_list(x->fields, offset);
+            print_node_list(x->options, offset);
+        } else if (auto x = std::dynamic_pointer_cast<TableOption>(node)) {
+            std::cout << "TABLE_OPTION\n";
+            print_val(x->name, offset);
+            print_val(x->value, offset);
+        } else if (auto x = std::dynamic_pointer_cast<VacuumTable>(node)) {
+            std::cout << "VACUUM_TABLE\n";
+            print_val(x->tab_name, offset);
         } else if (auto x = std::dynamic_pointer_cast<DropTable>(node)) {
             std::cout << "DROP_TABLE\n";
             print_val(x->tab_name, offset);
@@ -373,25 +373,28 @@ static void yynoreturn yy_fatal_error(const char *msg);
     (yy_hold_char) = *yy_cp;       \
     *yy_cp = '\0';                 \
     (yy_c_buf_p) = yy_cp;
-#define YY_NUM_RULES 47
-#define YY_END_OF_BUFFER 48
+#define YY_NUM_RULES 55
+#define YY_END_OF_BUFFER 56
 /* This struct is not used in this scanner,
    but its presence is necessary. */
 struct yy_trans_info {
     flex_int32_t yy_verify;
     flex_int32_t yy_nxt;
 };
-static const flex_int16_t yy_accept[154] = {
-    0,  0,  0,  0,  0,  48, 46, 6,  7,  7,  46, 41, 46, 46, 46, 43, 41, 41,
-    42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 3,
-    4,  6,  7,  0,  45, 43, 5,  1,  44, 39, 40, 38, 42, 42, 42, 42, 42, 36,
-    42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42,
-    42, 2,  5,  44, 42, 31, 37, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42,
-    42, 42, 27, 42, 42, 42, 42, 25, 42, 42, 42,
-
-    42, 42, 42, 42, 28, 42, 42, 42, 17, 16, 33, 42, 22, 34, 42, 42, 19, 32,
-    42, 42, 42, 8,  42, 42, 42, 42, 11, 9,  42, 42, 42, 29, 30, 42, 35, 42,
-    42, 15, 42, 42, 23, 10, 14, 21, 18, 42, 26, 13, 24, 20, 42, 12, 0};
+static const flex_int16_t yy_accept[200] = {
+    0,  0,  0,  0,  0,  56, 54, 6,  7,  7,  54, 49, 49, 49, 54, 49, 54, 49, 54,
+    51, 49, 49, 49, 49, 50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 50,
+    50, 50, 50, 50, 3,  4,  6,  7,  0,  53, 51, 5,  1,  52, 47, 48, 46, 50, 50,
+    50, 50, 50, 50, 50, 50, 50, 36, 50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 50,
+    50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 2,  5,  52, 50, 31, 37, 50,
+    50, 50, 50, 50, 50,
+
+    50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 27, 50, 50, 50, 50, 50, 25,
+    50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 28, 50, 50, 50, 50, 17, 16, 33,
+    50, 22, 40, 34, 50, 50, 50, 19, 32, 50, 50, 50, 50, 8,  50, 50, 50, 50, 50,
+    50, 11, 9,  50, 41, 50, 50, 50, 50, 29, 50, 30, 50, 44, 35, 50, 50, 15, 50,
+    39, 50, 50, 23, 42, 50, 10, 14, 21, 50, 18, 50, 26, 13, 24, 38, 20, 50, 43,
+    50, 50, 12, 45, 0};
 
 static const YY_CHAR yy_ec[256] = {
     0,  1,  1,  1,  1,  1,  1,  1,  1,  2,  3,  1,  1,  4,  1,  1,  1,  1,  1,
@@ -399,10 +402,10 @@ static const YY_CHAR yy_ec[256] = {
     1,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 14, 14, 14, 14, 14, 14, 14, 14,
     14, 1,  15, 16, 17, 18, 1,  1,  19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29,
     30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 35, 1,  1,  1,  1,
-    44, 1,  45, 46, 47, 48,
+    44, 1,  19, 20, 21, 22,
 
-    49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 35, 61, 62, 63, 64, 65, 66,
-    67, 68, 35, 1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+    23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41,
+    42, 43, 35, 1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
@@ -412,100 +415,113 @@ static const YY_CHAR yy_ec[256] = {
     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1};
 
-static const YY_CHAR yy_meta[69] = {
-    0, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 1, 1, 1, 1, 3, 3, 3, 3,
-    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3};
-
-static const flex_int16_t yy_base[158] = {
-    0,   0,   0,   281, 280, 287, 306, 284, 306, 279, 274, 306, 261, 58,  265,
-    59,  57,  238, 50,  54,  50,  55,  38,  54,  0,   58,  56,  59,  58,  62,
-    75,  80,  66,  87,  87,  306, 176, 139, 306, 88,  306, 116, 0,   306, 75,
-    306, 306, 306, 0,   84,  98,  102, 104, 0,   112, 102, 111, 105, 103, 110,
-    105, 107, 114, 131, 118, 125, 118, 120, 118, 132, 132, 126, 142, 306, 0,
-    71,  136, 0,   0,   148, 145, 153, 166, 163, 166, 154, 152, 173, 164, 162,
-    175, 176, 167, 170, 180, 174, 182, 0,   166, 178, 190,
-
-    177, 181, 181, 188, 0,   196, 189, 195, 0,   0,   0,   198, 0,   0,   195,
-    202, 0,   0,   203, 220, 222, 0,   222, 209, 225, 227, 0,   0,   215, 228,
-    231, 0,   0,   218, 0,   238, 221, 223, 242, 230, 0,   0,   0,   0,   0,
-    247, 0,   0,   0,   0,   241, 0,   306, 296, 299, 76,  302};
-
-static const flex_int16_t yy_def[158] = {
-    0,   153, 1,   154, 154, 153, 153, 153, 153, 153, 155, 153, 153, 153, 153,
-    153, 153, 153, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156,
-    156, 156, 156, 156, 156, 153, 153, 153, 153, 155, 153, 153, 157, 153, 153,
-    153, 153, 153, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156,
-    156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 153, 157,
-    153, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156,
-    156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156,
-
-    156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156,
-    156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156,
-    156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156,
-    156, 156, 156, 156, 156, 156, 156, 0,   153, 153, 153, 153};
-
-static const flex_int16_t yy_nxt[375] = {
-    0,   6,   7,   8,   9,   10,  11,  11,  11,  12,  11,  13,  11,  14,  15,
-    11,  16,  11,  17,  18,  19,  20,  21,  22,  23,  24,  25,  26,  27,  24,
-    24,  24,  24,  28,  24,  24,  29,  30,  31,  32,  33,  34,  24,  24,  6,
-    18,  19,  20,  21,  22,  23,  24,  25,  26,  27,  24,  24,  24,  24,  28,
-    24,  29,  30,  31,  32,  33,  34,  24,  24,  42,  49,  44,  41,  41,  45,
-    46,  54,  52,  57,  48,  59,  62,  50,  55,  60,  75,  56,  51,  63,  75,
-    61,  58,  64,  40,  65,  66,  49,  53,  67,  69,  70,
-
-    68,  54,  52,  57,  59,  71,  62,  50,  55,  60,  56,  51,  72,  63,  61,
-    58,  76,  64,  65,  77,  66,  53,  78,  67,  69,  70,  68,  44,  79,  41,
-    80,  71,  81,  82,  83,  85,  86,  87,  72,  88,  37,  84,  76,  89,  93,
-    77,  94,  95,  78,  96,  98,  99,  90,  100, 79,  101, 80,  97,  81,  82,
-    83,  85,  86,  87,  102, 88,  84,  91,  92,  89,  93,  103, 94,  95,  104,
-    96,  98,  99,  90,  100, 105, 101, 97,  106, 107, 108, 109, 110, 73,  111,
-    102, 112, 91,  92,  113, 114, 103, 115, 116, 117,
-
-    104, 118, 119, 120, 121, 105, 122, 123, 124, 106, 107, 108, 109, 110, 111,
-    125, 126, 112, 127, 128, 113, 114, 129, 115, 116, 117, 130, 118, 119, 120,
-    121, 122, 131, 123, 124, 132, 133, 134, 135, 136, 125, 126, 137, 127, 138,
-    128, 139, 140, 129, 141, 143, 130, 142, 144, 47,  145, 146, 131, 147, 148,
-    132, 133, 134, 135, 149, 136, 150, 151, 137, 152, 138, 139, 43,  140, 41,
-    141, 143, 142, 40,  144, 145, 38,  146, 147, 148, 37,  153, 36,  36,  153,
-    149, 150, 153, 151, 153, 152, 35,  35,  35,  39,
-
-    39,  39,  74,  153, 74,  5,   153, 153, 153, 153, 153, 153, 153, 153, 153,
-    153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153,
-    153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153,
-    153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153,
-    153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153};
-
-static const flex_int16_t yy_chk[375] = {
-    0,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+static const YY_CHAR yy_meta[45] = {
+    0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+
+static const flex_int16_t yy_base[200] = {
+    0,   0,   0,   44,  0,   0,   362, 87,  362, 87,  90,  362, 362, 362, 121,
+    362, 125, 362, 129, 126, 362, 122, 362, 124, 128, 153, 162, 177, 151, 180,
+    101, 156, 112, 112, 119, 141, 145, 158, 164, 152, 182, 176, 362, 191, 0,
+    362, 0,   362, 0,   216, 362, 191, 362, 362, 362, 0,   0,   173, 185, 187,
+    0,   186, 174, 179, 0,   200, 222, 231, 240, 234, 232, 239, 234, 235, 232,
+    240, 251, 247, 244, 254, 247, 248, 246, 260, 259, 255, 262, 261, 362, 0,
+    0,   249, 0,   0,   260, 259, 268, 257, 257, 264, 277,
+
+    274, 277, 265, 262, 282, 271, 277, 270, 275, 283, 284, 275, 277, 283, 288,
+    282, 290, 0,   273, 285, 297, 285, 279, 280, 284, 283, 290, 304, 301, 0,
+    287, 299, 289, 290, 0,   0,   0,   291, 0,   0,   0,   291, 289, 296, 0,
+    0,   295, 298, 315, 315, 0,   314, 300, 314, 301, 318, 319, 0,   0,   309,
+    0,   321, 307, 323, 324, 0,   326, 0,   311, 0,   0,   331, 313, 315, 330,
+    0,   323, 318, 0,   0,   320, 0,   0,   0,   334, 0,   337, 0,   0,   0,
+    0,   0,   336, 0,   331, 339, 0,   0,   362};
+
+static const flex_int16_t yy_def[200] = {
+    0,   199, 1,   199, 3,   199, 199, 199, 199, 199, 199, 199, 199, 199, 199,
+    199, 14,  199, 199, 14,  199, 199, 199, 199, 199, 24,  24,  24,  27,  27,
+    28,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  199, 199, 7,
+    199, 10,  199, 19,  199, 199, 199, 199, 199, 199, 30,  30,  30,  30,  30,
+    30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,
+    30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  199, 49,
+    51,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,
+
+    30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,
+    30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,
+    30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  28,  30,  30,
+    30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,
+    30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,
+    30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,
+    30,  30,  30,  30,  30,  30,  30,  30,  0};
+
+static const flex_int16_t yy_nxt[407] = {
+    199, 6,   7,   8,   9,   10,  11,  12,  13,  14,  15,  16,  17,  18,  19,
+    20,  21,  22,  23,  24,  25,  26,  27,  28,  29,  30,  31,  32,  33,  30,
+    34,  30,  30,  35,  30,  30,  36,  37,  38,  39,  40,  41,  30,  30,  6,
+    42,  42,  42,  42,  42,  42,  42,  43,  42,  42,  42,  42,  42,  42,  42,
+    42,  42,  42,  42,  42,  42,  42,  42,  42,  42,  42,  42,  42,  42,  42,
+    42,  42,  42,  42,  42,  42,  42,  42,  42,  42,  42,  42,  42,  42,  44,
+    45,  46,  46,  46,  46,  47,  46,  46,  46,  46,  46,
+
+    46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,
+    46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,
+    46,  46,  46,  46,  48,  49,  50,  51,  52,  53,  54,  55,  56,  76,  77,
+    78,  56,  57,  56,  56,  56,  56,  56,  56,  56,  56,  56,  56,  56,  58,
+    56,  56,  56,  56,  59,  56,  56,  56,  56,  56,  56,  60,  56,  56,  74,
+    61,  79,  80,  75,  62,  81,  56,  83,  82,  56,  84,  56,  65,  85,  56,
+    63,  66,  71,  56,  67,  64,  56,  68,  56,  69,
+
+    86,  87,  56,  88,  90,  91,  92,  93,  56,  72,  94,  95,  70,  56,  96,
+    73,  89,  89,  97,  89,  89,  89,  89,  89,  89,  89,  89,  89,  89,  89,
+    89,  89,  89,  89,  89,  89,  89,  89,  89,  89,  89,  89,  89,  89,  89,
+    89,  89,  89,  89,  89,  89,  89,  89,  89,  89,  89,  89,  89,  89,  89,
+    98,  99,  100, 101, 103, 104, 105, 106, 107, 108, 102, 109, 110, 113, 114,
+    115, 116, 117, 119, 120, 121, 122, 123, 125, 126, 118, 127, 111, 112, 128,
+    129, 124, 130, 131, 132, 133, 134, 135, 136, 137,
+
+    138, 139, 140, 141, 142, 143, 144, 145, 146, 147, 148, 149, 150, 151, 152,
+    153, 154, 155, 156, 157, 158, 159, 160, 161, 162, 163, 164, 165, 166, 167,
+    168, 169, 170, 171, 172, 173, 174, 175, 176, 177, 178, 179, 180, 181, 182,
+    183, 184, 185, 186, 187, 188, 189, 190, 191, 192, 193, 194, 195, 196, 197,
+    198, 5,   199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199,
+    199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199,
+    199, 199, 199, 199, 199, 199, 199, 199, 199, 199,
+
+    199, 199, 199, 199, 199, 199};
+
+static const flex_int16_t yy_chk[407] = {
+    5,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
     1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
     1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   13,  18,  15,  13,  15,  16,
-    16,  20,  19,  21,  156, 22,  25,  18,  20,  23,  75,  20,  18,  26,  44,
-    23,  21,  27,  39,  28,  29,  18,  19,  30,  31,  32,
-
-    30,  20,  19,  21,  22,  33,  25,  18,  20,  23,  20,  18,  34,  26,  23,
-    21,  49,  27,  28,  50,  29,  19,  51,  30,  31,  32,  30,  41,  52,  41,
-    54,  33,  55,  56,  57,  58,  59,  60,  34,  61,  37,  57,  49,  62,  64,
-    50,  65,  66,  51,  67,  68,  69,  63,  70,  52,  71,  54,  67,  55,  56,
-    57,  58,  59,  60,  72,  61,  57,  63,  63,  62,  64,  76,  65,  66,  79,
-    67,  68,  69,  63,  70,  80,  71,  67,  81,  82,  83,  84,  85,  36,  86,
-    72,  87,  63,  63,  88,  89,  76,  90,  91,  92,
-
-    79,  93,  94,  95,  96,  80,  98,  99,  100, 81,  82,  83,  84,  85,  86,
-    101, 102, 87,  103, 104, 88,  89,  106, 90,  91,  92,  107, 93,  94,  95,
-    96,  98,  108, 99,  100, 112, 115, 116, 119, 120, 101, 102, 121, 103, 123,
-    104, 124, 125, 106, 126, 130, 107, 129, 131, 17,  134, 136, 108, 137, 138,
-    112, 115, 116, 119, 139, 120, 140, 146, 121, 151, 123, 124, 14,  125, 12,
-    126, 130, 129, 10,  131, 134, 9,   136, 137, 138, 7,   5,   4,   3,   0,
-    139, 140, 0,   146, 0,   151, 154, 154, 154, 155,
-
-    155, 155, 157, 0,   157, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153,
-    153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153,
-    153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153,
-    153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153,
-    153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153};
+    3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
+    3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
+    3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   7,
+    9,   10,  10,  10,  10,  10,  10,  10,  10,  10,  10,
+
+    10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,
+    10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,
+    10,  10,  10,  10,  14,  16,  18,  19,  21,  21,  23,  24,  30,  32,  33,
+    34,  24,  24,  24,  24,  24,  24,  24,  24,  24,  24,  24,  24,  24,  24,
+    24,  24,  24,  24,  24,  24,  24,  24,  24,  24,  24,  24,  25,  28,  31,
+    25,  35,  36,  31,  25,  37,  26,  38,  37,  25,  39,  28,  26,  39,  25,
+    25,  26,  28,  26,  26,  25,  27,  26,  26,  27,
+
+    40,  41,  29,  43,  51,  57,  58,  59,  27,  29,  61,  62,  27,  27,  63,
+    29,  49,  49,  65,  49,  49,  49,  49,  49,  49,  49,  49,  49,  49,  49,
+    49,  49,  49,  49,  49,  49,  49,  49,  49,  49,  49,  49,  49,  49,  49,
+    49,  49,  49,  49,  49,  49,  49,  49,  49,  49,  49,  49,  49,  49,  49,
+    66,  67,  68,  69,  70,  71,  72,  73,  74,  75,  69,  76,  76,  77,  78,
+    79,  80,  81,  82,  83,  84,  85,  86,  87,  91,  81,  94,  76,  76,  95,
+    96,  86,  97,  98,  99,  100, 101, 102, 103, 104,
+
+    105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 119, 120,
+    121, 122, 123, 124, 125, 126, 127, 128, 129, 131, 132, 133, 134, 138, 142,
+    143, 144, 147, 148, 149, 150, 152, 153, 154, 155, 156, 157, 160, 162, 163,
+    164, 165, 167, 169, 172, 173, 174, 175, 177, 178, 181, 185, 187, 193, 195,
+    196, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199,
+    199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199,
+    199, 199, 199, 199, 199, 199, 199, 199, 199, 199,
+
+    199, 199, 199, 199, 199, 199};
 
 static yy_state_type yy_last_accepting_state;
 static char *yy_last_accepting_cpos;
@@ -547,9 +563,9 @@ char *yytext;
         }                                       \
     }
 
-#line 626 "/Users/sxy/Documents/projects/rucbase/src/parser/lex.yy.cpp"
+#line 644 "/Users/sxy/Documents/projects/rucbase/src/parser/lex.yy.cpp"
 
-#line 628 "/Users/sxy/Documents/projects/rucbase/src/parser/lex.yy.cpp"
+#line 646 "/Users/sxy/Documents/projects/rucbase/src/parser/lex.yy.cpp"
 
 #define INITIAL 0
 #define STATE_COMMENT 1
@@ -776,7 +792,7 @@ YY_DECL {
 
 #line 48 "lex.l"
         /* block comment */
-#line 866 "/Users/sxy/Documents/projects/rucbase/src/parser/lex.yy.cpp"
+#line 884 "/Users/sxy/Documents/projects/rucbase/src/parser/lex.yy.cpp"
 
         while (/*CONSTCOND*/ 1) /* loops until end-of-file is reached */
         {
@@ -801,11 +817,11 @@ YY_DECL {
                 while (yy_chk[yy_base[yy_current_state] + yy_c] !=
                        yy_current_state) {
                     yy_current_state = (int)yy_def[yy_current_state];
-                    if (yy_current_state >= 154) yy_c = yy_meta[yy_c];
+                    if (yy_current_state >= 200) yy_c = yy_meta[yy_c];
                 }
                 yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
                 ++yy_cp;
-            } while (yy_base[yy_current_state] != 306);
+            } while (yy_base[yy_current_state] != 362);
 
         yy_find_action:
             yy_act = yy_accept[yy_current_state];
@@ -1086,65 +1102,121 @@ YY_DECL {
                         return ASC;
                     }
                     YY_BREAK
-                /* operators */
                 case 38:
                     YY_RULE_SETUP
-#line 90 "lex.l"
+#line 89 "lex.l"
                     {
-                        return GEQ;
+                        return VACUUM;
                     }
                     YY_BREAK
                 case 39:
                     YY_RULE_SETUP
-#line 91 "lex.l"
+#line 90 "lex.l"
                     {
-                        return LEQ;
+                        return USING;
                     }
                     YY_BREAK
                 case 40:
                     YY_RULE_SETUP
-#line 92 "lex.l"
+#line 91 "lex.l"
                     {
-                        return NEQ;
+                        return HASH;
                     }
                     YY_BREAK
                 case 41:
                     YY_RULE_SETUP
+#line 92 "lex.l"
+                    {
+                        return BTREE;
+                    }
+                    YY_BREAK
+                case 42:
+                    YY_RULE_SETUP
 #line 93 "lex.l"
+                    {
+                        return BITMAP;
+                    }
+                    YY_BREAK
+                case 43:
+                    YY_RULE_SETUP
+#line 94 "lex.l"
+                    {
+                        return INCLUDE;
+                    }
+                    YY_BREAK
+                case 44:
+                    YY_RULE_SETUP
+#line 95 "lex.l"
+                    {
+                        return LIMIT;
+                    }
+                    YY_BREAK
+                case 45:
+                    YY_RULE_SETUP
+#line 96 "lex.l"
+                    {
+                        return CLUSTERED;
+                    }
+                    YY_BREAK
+                /* operators */
+                case 46:
+                    YY_RULE_SETUP
+#line 98 "lex.l"
+                    {
+                        return GEQ;
+                    }
+                    YY_BREAK
+                case 47:
+                    YY_RULE_SETUP
+#line 99 "lex.l"
+                    {
+                        return LEQ;
+                    }
+                    YY_BREAK
+                case 48:
+                    YY_RULE_SETUP
+#line 100 "lex.l"
+                    {
+                        return NEQ;
+                    }
+                    YY_BREAK
+                case 49:
+                    YY_RULE_SETUP
+#line 101 "lex.l"
                     {
                         return yytext[0];
                     }
                     YY_BREAK
                 /* id */
-                case 42:
+                case 50:
                     YY_RULE_SETUP
-#line 95 "lex.l"
+#line 103 "lex.l"
                     {
                         yylval->sv_str = yytext;
                         return IDENTIFIER;
                     }
                     YY_BREAK
                 /* literals */
-                case 43:
+                case 51:
                     YY_RULE_SETUP
-#line 100 "lex.l"
+#line 108 "lex.l"
                     {
                         yylval->sv_int = atoi(yytext);
                         return VALUE_INT;
                     }
                     YY_BREAK
-                case 44:
+                case 52:
                     YY_RULE_SETUP
-#line 104 "lex.l"
+#line 112 "lex.l"
                     {
                         yylval->sv_float = atof(yytext);
                         return VALUE_FLOAT;
                     }
                     YY_BREAK
-                case 45:
+                case 53:
                     /* rule 45 can match eol */
                     YY_RULE_SETUP
-#line 108 "lex.l"
+#line 116 "lex.l"
                     {
                         yylval->sv_str =
                             std::string(yytext + 1, strlen(yytext) - 2);
@@ -1154,26 +1226,26 @@ YY_DECL {
                 /* EOF */
                 case YY_STATE_EOF(INITIAL):
                 case YY_STATE_EOF(STATE_COMMENT):
-#line 113 "lex.l"
+#line 121 "lex.l"
                 {
                     return T_EOF;
                 }
                     YY_BREAK
                 /* unexpected char */
-                case 46:
+                case 54:
                     YY_RULE_SETUP
-#line 115 "lex.l"
+#line 123 "lex.l"
                     {
                         std::cerr << "Lexer Error: unexpected character "
                                   << yytext[0] << std::endl;
                     }
                     YY_BREAK
-                case 47:
+                case 55:
                     YY_RULE_SETUP
-#line 116 "lex.l"
+#line 124 "lex.l"
                     ECHO;
                     YY_BREAK
-#line 1186 "/Users/sxy/Documents/projects/rucbase/src/parser/lex.yy.cpp"
+#line 1244 "/Users/sxy/Documents/projects/rucbase/src/parser/lex.yy.cpp"
 
                 case YY_END_OF_BUFFER: {
                     /* Amount of text matched not including the EOB char. */
@@ -1448,7 +1520,7 @@ static yy_state_type yy_get_previous_state(void) {
         }
         while (yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state) {
             yy_current_state = (int)yy_def[yy_current_state];
-            if (yy_current_state >= 154) yy_c = yy_meta[yy_c];
+            if (yy_current_state >= 200) yy_c = yy_meta[yy_c];
         }
         yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
     }
@@ -1472,10 +1544,10 @@ static yy_state_type yy_try_NUL_trans(yy_state_type yy_current_state) {
     }
     while (yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state) {
         yy_current_state = (int)yy_def[yy_current_state];
-        if (yy_current_state >= 154) yy_c = yy_meta[yy_c];
+        if (yy_current_state >= 200) yy_c = yy_meta[yy_c];
     }
     yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
-    yy_is_jam = (yy_current_state == 153);
+    yy_is_jam = (yy_current_state == 199);
 
     return yy_is_jam ? 0 : yy_current_state;
 }
@@ -2025,4 +2097,4 @@ void yyfree(void *ptr) {
 
 #define YYTABLES_NAME "yytables"
 
-#line 116 "lex.l"
+#line 124 "lex.l"
@@ -144,52 +144,66 @@ enum yysymbol_kind_t
   YYSYMBOL_TXN_ABORT = 31,                 /* TXN_ABORT  */
   YYSYMBOL_TXN_ROLLBACK = 32,              /* TXN_ROLLBACK  */
   YYSYMBOL_ORDER_BY = 33,                  /* ORDER_BY  */
-  YYSYMBOL_LEQ = 34,                       /* LEQ  */
-  YYSYMBOL_NEQ = 35,                       /* NEQ  */
-  YYSYMBOL_GEQ = 36,                       /* GEQ  */
-  YYSYMBOL_T_EOF = 37,                     /* T_EOF  */
-  YYSYMBOL_IDENTIFIER = 38,                /* IDENTIFIER  */
-  YYSYMBOL_VALUE_STRING = 39,              /* VALUE_STRING  */
-  YYSYMBOL_VALUE_INT = 40,                 /* VALUE_INT  */
-  YYSYMBOL_VALUE_FLOAT = 41,               /* VALUE_FLOAT  */
-  YYSYMBOL_42_ = 42,                       /* ';'  */
-  YYSYMBOL_43_ = 43,                       /* '('  */
-  YYSYMBOL_44_ = 44,                       /* ')'  */
-  YYSYMBOL_45_ = 45,                       /* ','  */
-  YYSYMBOL_46_ = 46,                       /* '.'  */
-  YYSYMBOL_47_ = 47,                       /* '='  */
-  YYSYMBOL_48_ = 48,                       /* '<'  */
-  YYSYMBOL_49_ = 49,                       /* '>'  */
-  YYSYMBOL_50_ = 50,                       /* '*'  */
-  YYSYMBOL_YYACCEPT = 51,                  /* $accept  */
-  YYSYMBOL_start = 52,                     /* start  */
-  YYSYMBOL_stmt = 53,                      /* stmt  */
-  YYSYMBOL_txnStmt = 54,                   /* txnStmt  */
-  YYSYMBOL_dbStmt = 55,                    /* dbStmt  */
-  YYSYMBOL_ddl = 56,                       /* ddl  */
-  YYSYMBOL_dml = 57,                       /* dml  */
-  YYSYMBOL_fieldList = 58,                 /* fieldList  */
-  YYSYMBOL_colNameList = 59,               /* colNameList  */
-  YYSYMBOL_field = 60,                     /* field  */
-  YYSYMBOL_type = 61,                      /* type  */
-  YYSYMBOL_valueList = 62,                 /* valueList  */
-  YYSYMBOL_value = 63,                     /* value  */
-  YYSYMBOL_condition = 64,                 /* condition  */
-  YYSYMBOL_optWhereClause = 65,            /* optWhereClause  */
-  YYSYMBOL_whereClause = 66,               /* whereClause  */
-  YYSYMBOL_col = 67,                       /* col  */
-  YYSYMBOL_colList = 68,                   /* colList  */
-  YYSYMBOL_op = 69,                        /* op  */
-  YYSYMBOL_expr = 70,                      /* expr  */
-  YYSYMBOL_setClauses = 71,                /* setClauses  */
-  YYSYMBOL_setClause = 72,                 /* setClause  */
-  YYSYMBOL_selector = 73,                  /* selector  */
-  YYSYMBOL_tableList = 74,                 /* tableList  */
-  YYSYMBOL_opt_order_clause = 75,          /* opt_order_clause  */
-  YYSYMBOL_order_clause = 76,              /* order_clause  */
-  YYSYMBOL_opt_asc_desc = 77,              /* opt_asc_desc  */
-  YYSYMBOL_tbName = 78,                    /* tbName  */
-  YYSYMBOL_colName = 79                    /* colName  */
+  YYSYMBOL_VACUUM = 34,                    /* VACUUM  */
+  YYSYMBOL_USING = 35,                     /* USING  */
+  YYSYMBOL_HASH = 36,                      /* HASH  */
+  YYSYMBOL_BTREE = 37,                     /* BTREE  */
+  YYSYMBOL_BITMAP = 38,                    /* BITMAP  */
+  YYSYMBOL_INCLUDE = 39,                   /* INCLUDE  */
+  YYSYMBOL_LIMIT = 40,                     /* LIMIT  */
+  YYSYMBOL_CLUSTERED = 41,                 /* CLUSTERED  */
+  YYSYMBOL_LEQ = 42,                       /* LEQ  */
+  YYSYMBOL_NEQ = 43,                       /* NEQ  */
+  YYSYMBOL_GEQ = 44,                       /* GEQ  */
+  YYSYMBOL_T_EOF = 45,                     /* T_EOF  */
+  YYSYMBOL_IDENTIFIER = 46,                /* IDENTIFIER  */
+  YYSYMBOL_VALUE_STRING = 47,              /* VALUE_STRING  */
+  YYSYMBOL_VALUE_INT = 48,                 /* VALUE_INT  */
+  YYSYMBOL_VALUE_FLOAT = 49,               /* VALUE_FLOAT  */
+  YYSYMBOL_50_ = 50,                       /* ';'  */
+  YYSYMBOL_51_ = 51,                       /* '='  */
+  YYSYMBOL_52_ = 52,                       /* '('  */
+  YYSYMBOL_53_ = 53,                       /* ')'  */
+  YYSYMBOL_54_ = 54,                       /* ','  */
+  YYSYMBOL_55_ = 55,                       /* '.'  */
+  YYSYMBOL_56_ = 56,                       /* '<'  */
+  YYSYMBOL_57_ = 57,                       /* '>'  */
+  YYSYMBOL_58_ = 58,                       /* '*'  */
+  YYSYMBOL_YYACCEPT = 59,                  /* $accept  */
+  YYSYMBOL_start = 60,                     /* start  */
+  YYSYMBOL_stmt = 61,                      /* stmt  */
+  YYSYMBOL_txnStmt = 62,                   /* txnStmt  */
+  YYSYMBOL_dbStmt = 63,                    /* dbStmt  */
+  YYSYMBOL_ddl = 64,                       /* ddl  */
+  YYSYMBOL_dml = 65,                       /* dml  */
+  YYSYMBOL_fieldList = 66,                 /* fieldList  */
+  YYSYMBOL_optTableOptions = 67,           /* optTableOptions  */
+  YYSYMBOL_tableOptionList = 68,           /* tableOptionList  */
+  YYSYMBOL_tableOption = 69,               /* tableOption  */
+  YYSYMBOL_colNameList = 70,               /* colNameList  */
+  YYSYMBOL_field = 71,                     /* field  */
+  YYSYMBOL_type = 72,                      /* type  */
+  YYSYMBOL_valueList = 73,                 /* valueList  */
+  YYSYMBOL_value = 74,                     /* value  */
+  YYSYMBOL_condition = 75,                 /* condition  */
+  YYSYMBOL_optWhereClause = 76,            /* optWhereClause  */
+  YYSYMBOL_whereClause = 77,               /* whereClause  */
+  YYSYMBOL_col = 78,                       /* col  */
+  YYSYMBOL_colList = 79,                   /* colList  */
+  YYSYMBOL_op = 80,                        /* op  */
+  YYSYMBOL_expr = 81,                      /* expr  */
+  YYSYMBOL_setClauses = 82,                /* setClauses  */
+  YYSYMBOL_setClause = 83,                 /* setClause  */
+  YYSYMBOL_selector = 84,                  /* selector  */
+  YYSYMBOL_tableList = 85,                 /* tableList  */
+  YYSYMBOL_opt_order_clause = 86,          /* opt_order_clause  */
+  YYSYMBOL_order_clause = 87,              /* order_clause  */
+  YYSYMBOL_opt_limit_clause = 88,          /* opt_limit_clause  */
+  YYSYMBOL_opt_asc_desc = 89,              /* opt_asc_desc  */
+  YYSYMBOL_optIncludeCols = 90,            /* optIncludeCols  */
+  YYSYMBOL_optIndexMethod = 91,            /* optIndexMethod  */
+  YYSYMBOL_tbName = 92,                    /* tbName  */
+  YYSYMBOL_colName = 93                    /* colName  */
 };
 typedef enum yysymbol_kind_t yysymbol_kind_t;
 
@@ -306,7 +320,7 @@ typedef int yytype_uint16;
 
 
 /* Stored state numbers (used for stacks). */
-typedef yytype_int8 yy_state_t;
+typedef yytype_uint8 yy_state_t;
 
 /* State numbers in computations.  */
 typedef int yy_state_fast_t;
@@ -518,21 +532,21 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  39
+#define YYFINAL  43
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   112
+#define YYLAST   138
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  51
+#define YYNTOKENS  59
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  29
+#define YYNNTS  35
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  69
+#define YYNRULES  85
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  127
+#define YYNSTATES  158
 
 /* YYMAXUTOK -- Last valid token kind.  */
-#define YYMAXUTOK   296
+#define YYMAXUTOK   304
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
@@ -550,9 +564,9 @@ static const yytype_int8 yytranslate[] =
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-      43,    44,    50,     2,    45,     2,    46,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,    42,
-      48,    47,    49,     2,     2,     2,     2,     2,     2,     2,
+      52,    53,    58,     2,    54,     2,    55,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,    50,
+      56,    51,    57,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -575,20 +589,23 @@ static const yytype_int8 yytranslate[] =
        5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
       15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
       25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
-      35,    36,    37,    38,    39,    40,    41
+      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
+      45,    46,    47,    48,    49
 };
 
 #if YYDEBUG
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,    56,    56,    61,    66,    71,    79,    80,    81,    82,
-      86,    90,    94,    98,   105,   112,   116,   120,   124,   128,
-     135,   139,   143,   147,   154,   158,   165,   169,   176,   183,
-     187,   191,   198,   202,   209,   213,   217,   224,   231,   232,
-     239,   243,   250,   254,   261,   265,   272,   276,   280,   284,
-     288,   292,   299,   303,   310,   314,   321,   328,   332,   336,
-     340,   344,   351,   355,   359,   366,   367,   368,   371,   373
+       0,    61,    61,    66,    71,    76,    84,    85,    86,    87,
+      91,    95,    99,   103,   110,   114,   121,   125,   129,   133,
+     137,   141,   148,   152,   156,   160,   167,   171,   178,   179,
+     183,   187,   194,   198,   205,   209,   216,   223,   227,   231,
+     238,   242,   249,   253,   257,   264,   271,   272,   279,   283,
+     290,   294,   301,   305,   312,   316,   320,   324,   328,   332,
+     339,   343,   350,   354,   361,   368,   372,   376,   380,   384,
+     391,   395,   399,   406,   407,   411,   412,   413,   417,   418,
+     422,   423,   424,   425,   428,   430
 };
 #endif
 
@@ -608,14 +625,17 @@ static const char *const yytname[] =
   "CREATE", "TABLE", "DROP", "DESC", "INSERT", "INTO", "VALUES", "DELETE",
   "FROM", "ASC", "ORDER", "BY", "WHERE", "UPDATE", "SET", "SELECT", "INT",
   "CHAR", "FLOAT", "INDEX", "AND", "JOIN", "EXIT", "HELP", "TXN_BEGIN",
-  "TXN_COMMIT", "TXN_ABORT", "TXN_ROLLBACK", "ORDER_BY", "LEQ", "NEQ",
+  "TXN_COMMIT", "TXN_ABORT", "TXN_ROLLBACK", "ORDER_BY", "VACUUM", "USING",
+  "HASH", "BTREE", "BITMAP", "INCLUDE", "LIMIT", "CLUSTERED", "LEQ", "NEQ",
   "GEQ", "T_EOF", "IDENTIFIER", "VALUE_STRING", "VALUE_INT", "VALUE_FLOAT",
-  "';'", "'('", "')'", "','", "'.'", "'='", "'<'", "'>'", "'*'", "$accept",
+  "';'", "'='", "'('", "')'", "','", "'.'", "'<'", "'>'", "'*'", "$accept",
   "start", "stmt", "txnStmt", "dbStmt", "ddl", "dml", "fieldList",
-  "colNameList", "field", "type", "valueList", "value", "condition",
-  "optWhereClause", "whereClause", "col", "colList", "op", "expr",
-  "setClauses", "setClause", "selector", "tableList", "opt_order_clause",
-  "order_clause", "opt_asc_desc", "tbName", "colName", YY_NULLPTR
+  "optTableOptions", "tableOptionList", "tableOption", "colNameList",
+  "field", "type", "valueList", "value", "condition", "optWhereClause",
+  "whereClause", "col", "colList", "op", "expr", "setClauses", "setClause",
+  "selector", "tableList", "opt_order_clause", "order_clause",
+  "opt_limit_clause", "opt_asc_desc", "optIncludeCols", "optIndexMethod",
+  "tbName", "colName", YY_NULLPTR
 };
 
 static const char *
@@ -625,12 +645,12 @@ yysymbol_name (yysymbol_kind_t yysymbol)
 }
 #endif
 
-#define YYPACT_NINF (-75)
+#define YYPACT_NINF (-81)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF (-69)
+#define YYTABLE_NINF (-85)
 
 #define yytable_value_is_error(Yyn) \
   0
@@ -639,19 +659,22 @@ yysymbol_name (yysymbol_kind_t yysymbol)
    STATE-NUM.  */
 static const yytype_int8 yypact[] =
 {
-      42,    21,     5,     8,    -2,    32,    31,    -2,   -26,   -75,
-     -75,   -75,   -75,   -75,   -75,   -75,    52,     6,   -75,   -75,
-     -75,   -75,   -75,    -2,    -2,    -2,    -2,   -75,   -75,    -2,
-      -2,    34,    13,   -75,   -75,    16,    55,    39,   -75,   -75,
-     -75,    43,    44,   -75,    45,    78,    73,    53,    54,    -2,
-      53,    53,    53,    53,    50,    54,   -75,   -75,    -4,   -75,
-      51,   -75,    -7,   -75,   -75,   -11,   -75,    -5,    22,   -75,
-      33,    24,   -75,    74,    48,    53,   -75,    24,    -2,    -2,
-      85,   -75,    53,   -75,    58,   -75,   -75,   -75,    53,   -75,
-     -75,   -75,   -75,    36,   -75,    54,   -75,   -75,   -75,   -75,
-     -75,   -75,    17,   -75,   -75,   -75,   -75,    86,   -75,   -75,
-      63,   -75,   -75,    24,   -75,   -75,   -75,   -75,    54,    60,
-     -75,     1,   -75,   -75,   -75,   -75,   -75
+      46,    15,    -2,     5,   -29,    10,    14,   -29,   -16,   -34,
+     -81,   -81,   -81,   -81,   -81,   -81,   -29,   -81,    38,   -17,
+     -81,   -81,   -81,   -81,   -81,   -29,   -29,   -29,   -29,   -81,
+     -81,   -29,   -29,    24,    -3,    -5,   -81,   -81,    36,    39,
+      37,   -81,   -81,   -81,   -81,    43,    58,   -81,    59,   101,
+      96,    68,    69,    70,   -29,    68,    68,    68,    68,    63,
+      70,   -81,   -81,    -7,   -81,    72,   -81,   -81,   -12,   -81,
+     -81,     3,   -81,    79,    29,   -81,    33,    20,   -81,    93,
+      28,    68,   -81,    20,   -29,   -29,   104,   -23,    68,   -81,
+      73,   -81,   -81,    81,    68,   -81,   -81,   -81,   -81,    44,
+     -81,    70,   -81,   -81,   -81,   -81,   -81,   -81,    13,   -81,
+     -81,   -81,   -81,   105,    84,   110,    76,   -81,   -23,   -81,
+     -81,    80,    77,    95,   -81,   -81,    20,   -81,   -81,   -81,
+     -81,    70,    83,   -81,    82,    86,   -81,    85,    68,    67,
+     -81,   -81,     7,   -81,   -81,    68,   -81,   -81,    53,   -81,
+     -81,   -81,   -81,   -81,   -81,    55,   -81,   -81
 };
 
 /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
@@ -659,113 +682,129 @@ static const yytype_int8 yypact[] =
    means the default is an error.  */
 static const yytype_int8 yydefact[] =
 {
-       0,     0,     0,     0,     0,     0,     0,     0,     0,     4,
-       3,    10,    11,    12,    13,     5,     0,     0,     9,     6,
-       7,     8,    14,     0,     0,     0,     0,    68,    17,     0,
-       0,     0,    69,    57,    44,    58,     0,     0,    43,     1,
-       2,     0,     0,    16,     0,     0,    38,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,    21,    69,    38,    54,
-       0,    45,    38,    59,    42,     0,    24,     0,     0,    26,
-       0,     0,    40,    39,     0,     0,    22,     0,     0,     0,
-      63,    15,     0,    29,     0,    31,    28,    18,     0,    19,
-      36,    34,    35,     0,    32,     0,    50,    49,    51,    46,
-      47,    48,     0,    55,    56,    61,    60,     0,    23,    25,
-       0,    27,    20,     0,    41,    52,    53,    37,     0,     0,
-      33,    67,    62,    30,    66,    65,    64
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       4,     3,    10,    11,    12,    13,     0,     5,     0,     0,
+       9,     6,     7,     8,    14,     0,     0,     0,     0,    84,
+      18,     0,     0,     0,     0,    85,    65,    52,    66,     0,
+       0,    51,    21,     1,     2,     0,     0,    17,     0,     0,
+      46,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,    23,    85,    46,    62,     0,    15,    53,    46,    67,
+      50,     0,    26,     0,     0,    34,     0,     0,    48,    47,
+       0,     0,    24,     0,     0,     0,    71,    28,     0,    37,
+       0,    39,    36,    79,     0,    20,    44,    42,    43,     0,
+      40,     0,    58,    57,    59,    54,    55,    56,     0,    63,
+      64,    69,    68,     0,    74,     0,     0,    16,    29,    30,
+      27,     0,     0,    83,    35,    22,     0,    49,    60,    61,
+      45,     0,     0,    25,     0,     0,    31,     0,     0,     0,
+      19,    41,    77,    70,    73,     0,    32,    38,     0,    81,
+      80,    82,    76,    75,    72,     0,    78,    33
 };
 
 /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int8 yypgoto[] =
 {
-     -75,   -75,   -75,   -75,   -75,   -75,   -75,   -75,    56,    23,
-     -75,   -75,   -74,    11,   -27,   -75,    -8,   -75,   -75,   -75,
-     -75,    37,   -75,   -75,   -75,   -75,   -75,    -3,   -45
+     -81,   -81,   -81,   -81,   -81,   -81,   -81,   -81,   -81,   -81,
+      17,   -57,    45,   -81,   -81,   -80,    35,   -37,   -81,    -9,
+     -81,   -81,   -81,   -81,    56,   -81,   -81,   -81,   -81,   -81,
+     -81,   -81,   -81,     9,   -49
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int8 yydefgoto[] =
+static const yytype_uint8 yydefgoto[] =
 {
-       0,    16,    17,    18,    19,    20,    21,    65,    68,    66,
-      86,    93,    94,    72,    56,    73,    74,    35,   102,   117,
-      58,    59,    36,    62,   108,   122,   126,    37,    38
+       0,    18,    19,    20,    21,    22,    23,    71,   117,   118,
+     119,    74,    72,    92,    99,   100,    78,    61,    79,    80,
+      38,   108,   130,    63,    64,    39,    68,   114,   143,   133,
+     154,   123,   140,    40,    41
 };
 
 /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
    positive, shift that token.  If negative, reduce the rule whose
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
-static const yytype_int8 yytable[] =
+static const yytype_int16 yytable[] =
 {
-      34,    28,    60,   104,    31,    64,    67,    69,    69,   124,
-      55,    23,    32,    55,    25,   125,    83,    84,    85,    78,
-      41,    42,    43,    44,    33,    22,    45,    46,   115,    24,
-      60,    76,    26,    81,    82,    80,    27,    67,    79,   120,
-      61,    75,    29,   111,    30,     1,    63,     2,    40,     3,
-       4,     5,    39,    47,     6,    32,    90,    91,    92,   -68,
-       7,    48,     8,    90,    91,    92,    87,    88,    49,     9,
-      10,    11,    12,    13,    14,   105,   106,    89,    88,    15,
-     112,   113,    96,    97,    98,    50,    51,    52,    53,    54,
-      55,    57,    32,    71,   116,    99,   100,   101,    77,    95,
-     107,   110,   118,   119,   123,   109,   114,     0,     0,    70,
-     121,     0,   103
+      37,    76,    65,   110,    25,    60,    70,    73,    75,    75,
+      60,    27,    35,    30,    84,   152,    33,    29,   115,    24,
+      31,   153,    26,   116,    36,    42,    82,    32,   128,    28,
+      34,    86,    65,    44,    45,    46,    47,    48,    43,    73,
+      49,    50,    85,    51,    67,   124,   141,    81,    52,     1,
+     -84,     2,    54,     3,     4,     5,    87,    88,     6,    35,
+      96,    97,    98,    69,     7,     8,     9,    96,    97,    98,
+     102,   103,   104,    10,    11,    12,    13,    14,    15,   105,
+      16,   148,    93,    94,   106,   107,    95,    94,   155,    75,
+      53,    17,    55,   111,   112,    56,    75,   125,   126,   129,
+      89,    90,    91,   149,   150,   151,   156,    94,   157,    94,
+      57,    58,    59,    60,    62,    77,    35,    66,   101,   113,
+     122,   131,   142,    83,   132,   121,   134,   135,   137,   138,
+     139,   144,   146,   120,   145,   136,   127,   109,   147
 };
 
-static const yytype_int8 yycheck[] =
+static const yytype_uint8 yycheck[] =
 {
-       8,     4,    47,    77,     7,    50,    51,    52,    53,     8,
-      17,     6,    38,    17,     6,    14,    21,    22,    23,    26,
-      23,    24,    25,    26,    50,     4,    29,    30,   102,    24,
-      75,    58,    24,    44,    45,    62,    38,    82,    45,   113,
-      48,    45,    10,    88,    13,     3,    49,     5,    42,     7,
-       8,     9,     0,    19,    12,    38,    39,    40,    41,    46,
-      18,    45,    20,    39,    40,    41,    44,    45,    13,    27,
-      28,    29,    30,    31,    32,    78,    79,    44,    45,    37,
-      44,    45,    34,    35,    36,    46,    43,    43,    43,    11,
-      17,    38,    38,    43,   102,    47,    48,    49,    47,    25,
-      15,    43,    16,    40,    44,    82,    95,    -1,    -1,    53,
-     118,    -1,    75
+       9,    58,    51,    83,     6,    17,    55,    56,    57,    58,
+      17,     6,    46,     4,    26,     8,     7,    46,    41,     4,
+      10,    14,    24,    46,    58,    16,    63,    13,   108,    24,
+      46,    68,    81,    50,    25,    26,    27,    28,     0,    88,
+      31,    32,    54,    19,    53,    94,   126,    54,    51,     3,
+      55,     5,    13,     7,     8,     9,    53,    54,    12,    46,
+      47,    48,    49,    54,    18,    19,    20,    47,    48,    49,
+      42,    43,    44,    27,    28,    29,    30,    31,    32,    51,
+      34,   138,    53,    54,    56,    57,    53,    54,   145,   138,
+      54,    45,    55,    84,    85,    52,   145,    53,    54,   108,
+      21,    22,    23,    36,    37,    38,    53,    54,    53,    54,
+      52,    52,    11,    17,    46,    52,    46,    48,    25,    15,
+      39,    16,   131,    51,    40,    52,    16,    51,    48,    52,
+      35,    48,    46,    88,    52,   118,   101,    81,    53
 };
 
 /* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
    state STATE-NUM.  */
 static const yytype_int8 yystos[] =
 {
-       0,     3,     5,     7,     8,     9,    12,    18,    20,    27,
-      28,    29,    30,    31,    32,    37,    52,    53,    54,    55,
-      56,    57,     4,     6,    24,     6,    24,    38,    78,    10,
-      13,    78,    38,    50,    67,    68,    73,    78,    79,     0,
-      42,    78,    78,    78,    78,    78,    78,    19,    45,    13,
-      46,    43,    43,    43,    11,    17,    65,    38,    71,    72,
-      79,    67,    74,    78,    79,    58,    60,    79,    59,    79,
-      59,    43,    64,    66,    67,    45,    65,    47,    26,    45,
-      65,    44,    45,    21,    22,    23,    61,    44,    45,    44,
-      39,    40,    41,    62,    63,    25,    34,    35,    36,    47,
-      48,    49,    69,    72,    63,    78,    78,    15,    75,    60,
-      43,    79,    44,    45,    64,    63,    67,    70,    16,    40,
-      63,    67,    76,    44,     8,    14,    77
+       0,     3,     5,     7,     8,     9,    12,    18,    19,    20,
+      27,    28,    29,    30,    31,    32,    34,    45,    60,    61,
+      62,    63,    64,    65,     4,     6,    24,     6,    24,    46,
+      92,    10,    13,    92,    46,    46,    58,    78,    79,    84,
+      92,    93,    92,     0,    50,    92,    92,    92,    92,    92,
+      92,    19,    51,    54,    13,    55,    52,    52,    52,    11,
+      17,    76,    46,    82,    83,    93,    48,    78,    85,    92,
+      93,    66,    71,    93,    70,    93,    70,    52,    75,    77,
+      78,    54,    76,    51,    26,    54,    76,    53,    54,    21,
+      22,    23,    72,    53,    54,    53,    47,    48,    49,    73,
+      74,    25,    42,    43,    44,    51,    56,    57,    80,    83,
+      74,    92,    92,    15,    86,    41,    46,    67,    68,    69,
+      71,    52,    39,    90,    93,    53,    54,    75,    74,    78,
+      81,    16,    40,    88,    16,    51,    69,    48,    52,    35,
+      91,    74,    78,    87,    48,    52,    46,    53,    70,    36,
+      37,    38,     8,    14,    89,    70,    53,    53
 };
 
 /* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr1[] =
 {
-       0,    51,    52,    52,    52,    52,    53,    53,    53,    53,
-      54,    54,    54,    54,    55,    56,    56,    56,    56,    56,
-      57,    57,    57,    57,    58,    58,    59,    59,    60,    61,
-      61,    61,    62,    62,    63,    63,    63,    64,    65,    65,
-      66,    66,    67,    67,    68,    68,    69,    69,    69,    69,
-      69,    69,    70,    70,    71,    71,    72,    73,    73,    74,
-      74,    74,    75,    75,    76,    77,    77,    77,    78,    79
+       0,    59,    60,    60,    60,    60,    61,    61,    61,    61,
+      62,    62,    62,    62,    63,    63,    64,    64,    64,    64,
+      64,    64,    65,    65,    65,    65,    66,    66,    67,    67,
+      68,    68,    69,    69,    70,    70,    71,    72,    72,    72,
+      73,    73,    74,    74,    74,    75,    76,    76,    77,    77,
+      78,    78,    79,    79,    80,    80,    80,    80,    80,    80,
+      81,    81,    82,    82,    83,    84,    84,    85,    85,    85,
+      86,    86,    87,    88,    88,    89,    89,    89,    90,    90,
+      91,    91,    91,    91,    92,    93
 };
 
 /* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr2[] =
 {
        0,     2,     2,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     1,     1,     2,     6,     3,     2,     6,     6,
-       7,     4,     5,     6,     1,     3,     1,     3,     2,     1,
-       4,     1,     1,     3,     1,     1,     1,     3,     0,     2,
-       1,     3,     3,     1,     1,     3,     1,     1,     1,     1,
-       1,     1,     1,     1,     1,     3,     3,     1,     1,     1,
-       3,     3,     3,     0,     2,     1,     1,     0,     1,     1
+       1,     1,     1,     1,     2,     4,     7,     3,     2,     8,
+       6,     2,     7,     4,     5,     7,     1,     3,     0,     1,
+       1,     2,     3,     5,     1,     3,     2,     1,     4,     1,
+       1,     3,     1,     1,     1,     3,     0,     2,     1,     3,
+       3,     1,     1,     3,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     3,     3,     1,     1,     1,     3,     3,
+       3,     0,     2,     2,     0,     1,     1,     0,     4,     0,
+       2,     2,     2,     0,     1,     1
 };
 
 
@@ -1621,489 +1660,591 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* start: stmt ';'  */
-#line 57 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+#line 62 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         parse_tree = (yyvsp[-1].sv_node);
         YYACCEPT;
     }
-#line 1630 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1669 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
   case 3: /* start: HELP  */
-#line 62 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+#line 67 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         parse_tree = std::make_shared<Help>();
         YYACCEPT;
     }
-#line 1639 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1678 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
   case 4: /* start: EXIT  */
-#line 67 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+#line 72 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         parse_tree = nullptr;
         YYACCEPT;
     }
-#line 1648 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1687 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
   case 5: /* start: T_EOF  */
-#line 72 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+#line 77 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         parse_tree = nullptr;
         YYACCEPT;
     }
-#line 1657 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1696 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
   case 10: /* txnStmt: TXN_BEGIN  */
-#line 87 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+#line 92 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnBegin>();
     }
-#line 1665 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1704 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
   case 11: /* txnStmt: TXN_COMMIT  */
-#line 91 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+#line 96 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnCommit>();
     }
-#line 1673 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1712 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
   case 12: /* txnStmt: TXN_ABORT  */
-#line 95 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+#line 100 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnAbort>();
     }
-#line 1681 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1720 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
   case 13: /* txnStmt: TXN_ROLLBACK  */
-#line 99 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+#line 104 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnRollback>();
     }
-#line 1689 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1728 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
   case 14: /* dbStmt: SHOW TABLES  */
-#line 106 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+#line 111 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<ShowTables>();
     }
-#line 1697 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1736 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 15: /* dbStmt: SET IDENTIFIER '=' VALUE_INT  */
+#line 115 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<SetKnob>((yyvsp[-2].sv_str), (yyvsp[0].sv_int));
+    }
+#line 1744 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 15: /* ddl: CREATE TABLE tbName '(' fieldList ')'  */
-#line 113 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 16: /* ddl: CREATE TABLE tbName '(' fieldList ')' optTableOptions  */
+#line 122 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
-        (yyval.sv_node) = std::make_shared<CreateTable>((yyvsp[-3].sv_str), (yyvsp[-1].sv_fields));
+        (yyval.sv_node) = std::make_shared<CreateTable>((yyvsp[-4].sv_str), (yyvsp[-2].sv_fields), (yyvsp[0].sv_table_options));
     }
-#line 1705 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1752 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 16: /* ddl: DROP TABLE tbName  */
-#line 117 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 17: /* ddl: DROP TABLE tbName  */
+#line 126 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DropTable>((yyvsp[0].sv_str));
     }
-#line 1713 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1760 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 17: /* ddl: DESC tbName  */
-#line 121 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 18: /* ddl: DESC tbName  */
+#line 130 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DescTable>((yyvsp[0].sv_str));
     }
-#line 1721 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1768 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 18: /* ddl: CREATE INDEX tbName '(' colNameList ')'  */
-#line 125 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 19: /* ddl: CREATE INDEX tbName '(' colNameList ')' optIncludeCols optIndexMethod  */
+#line 134 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
-        (yyval.sv_node) = std::make_shared<CreateIndex>((yyvsp[-3].sv_str), (yyvsp[-1].sv_strs));
+        (yyval.sv_node) = std::make_shared<CreateIndex>((yyvsp[-5].sv_str), (yyvsp[-3].sv_strs), (yyvsp[-1].sv_strs), (yyvsp[0].sv_index_method));
     }
-#line 1729 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1776 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 19: /* ddl: DROP INDEX tbName '(' colNameList ')'  */
-#line 129 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 20: /* ddl: DROP INDEX tbName '(' colNameList ')'  */
+#line 138 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DropIndex>((yyvsp[-3].sv_str), (yyvsp[-1].sv_strs));
     }
-#line 1737 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1784 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 21: /* ddl: VACUUM tbName  */
+#line 142 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<VacuumTable>((yyvsp[0].sv_str));
+    }
+#line 1792 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 20: /* dml: INSERT INTO tbName VALUES '(' valueList ')'  */
-#line 136 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 22: /* dml: INSERT INTO tbName VALUES '(' valueList ')'  */
+#line 149 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<InsertStmt>((yyvsp[-4].sv_str), (yyvsp[-1].sv_vals));
     }
-#line 1745 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1800 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 21: /* dml: DELETE FROM tbName optWhereClause  */
-#line 140 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 23: /* dml: DELETE FROM tbName optWhereClause  */
+#line 153 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DeleteStmt>((yyvsp[-1].sv_str), (yyvsp[0].sv_conds));
     }
-#line 1753 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1808 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 22: /* dml: UPDATE tbName SET setClauses optWhereClause  */
-#line 144 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 24: /* dml: UPDATE tbName SET setClauses optWhereClause  */
+#line 157 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<UpdateStmt>((yyvsp[-3].sv_str), (yyvsp[-1].sv_set_clauses), (yyvsp[0].sv_conds));
     }
-#line 1761 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1816 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 23: /* dml: SELECT selector FROM tableList optWhereClause opt_order_clause  */
-#line 148 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 25: /* dml: SELECT selector FROM tableList optWhereClause opt_order_clause opt_limit_clause  */
+#line 161 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
-        (yyval.sv_node) = std::make_shared<SelectStmt>((yyvsp[-4].sv_cols), (yyvsp[-2].sv_strs), (yyvsp[-1].sv_conds), (yyvsp[0].sv_orderby));
+        (yyval.sv_node) = std::make_shared<SelectStmt>((yyvsp[-5].sv_cols), (yyvsp[-3].sv_strs), (yyvsp[-2].sv_conds), (yyvsp[-1].sv_orderby), (yyvsp[0].sv_int));
     }
-#line 1769 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1824 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 24: /* fieldList: field  */
-#line 155 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 26: /* fieldList: field  */
+#line 168 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_fields) = std::vector<std::shared_ptr<Field>>{(yyvsp[0].sv_field)};
     }
-#line 1777 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1832 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 25: /* fieldList: fieldList ',' field  */
-#line 159 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 27: /* fieldList: fieldList ',' field  */
+#line 172 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_fields).push_back((yyvsp[0].sv_field));
     }
-#line 1785 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1840 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 28: /* optTableOptions: %empty  */
+#line 178 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+                      { /* ignore*/ }
+#line 1846 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 30: /* tableOptionList: tableOption  */
+#line 184 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_table_options) = std::vector<std::shared_ptr<TableOption>>{(yyvsp[0].sv_table_option)};
+    }
+#line 1854 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 31: /* tableOptionList: tableOptionList tableOption  */
+#line 188 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_table_options).push_back((yyvsp[0].sv_table_option));
+    }
+#line 1862 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 32: /* tableOption: IDENTIFIER '=' IDENTIFIER  */
+#line 195 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_table_option) = std::make_shared<TableOption>((yyvsp[-2].sv_str), (yyvsp[0].sv_str));
+    }
+#line 1870 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 26: /* colNameList: colName  */
-#line 166 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 33: /* tableOption: CLUSTERED BY '(' colNameList ')'  */
+#line 199 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_table_option) = std::make_shared<TableOption>("clustered", "", (yyvsp[-1].sv_strs));
+    }
+#line 1878 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 34: /* colNameList: colName  */
+#line 206 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_strs) = std::vector<std::string>{(yyvsp[0].sv_str)};
     }
-#line 1793 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1886 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 27: /* colNameList: colNameList ',' colName  */
-#line 170 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 35: /* colNameList: colNameList ',' colName  */
+#line 210 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_strs).push_back((yyvsp[0].sv_str));
     }
-#line 1801 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1894 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 28: /* field: colName type  */
-#line 177 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 36: /* field: colName type  */
+#line 217 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_field) = std::make_shared<ColDef>((yyvsp[-1].sv_str), (yyvsp[0].sv_type_len));
     }
-#line 1809 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1902 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 29: /* type: INT  */
-#line 184 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 37: /* type: INT  */
+#line 224 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_INT, sizeof(int));
     }
-#line 1817 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1910 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 30: /* type: CHAR '(' VALUE_INT ')'  */
-#line 188 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 38: /* type: CHAR '(' VALUE_INT ')'  */
+#line 228 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_STRING, (yyvsp[-1].sv_int));
     }
-#line 1825 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1918 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 31: /* type: FLOAT  */
-#line 192 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 39: /* type: FLOAT  */
+#line 232 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_FLOAT, sizeof(float));
     }
-#line 1833 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1926 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 32: /* valueList: value  */
-#line 199 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 40: /* valueList: value  */
+#line 239 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_vals) = std::vector<std::shared_ptr<Value>>{(yyvsp[0].sv_val)};
     }
-#line 1841 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1934 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 33: /* valueList: valueList ',' value  */
-#line 203 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 41: /* valueList: valueList ',' value  */
+#line 243 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_vals).push_back((yyvsp[0].sv_val));
     }
-#line 1849 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1942 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 34: /* value: VALUE_INT  */
-#line 210 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 42: /* value: VALUE_INT  */
+#line 250 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_val) = std::make_shared<IntLit>((yyvsp[0].sv_int));
     }
-#line 1857 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1950 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 35: /* value: VALUE_FLOAT  */
-#line 214 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 43: /* value: VALUE_FLOAT  */
+#line 254 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_val) = std::make_shared<FloatLit>((yyvsp[0].sv_float));
     }
-#line 1865 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1958 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 36: /* value: VALUE_STRING  */
-#line 218 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 44: /* value: VALUE_STRING  */
+#line 258 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_val) = std::make_shared<StringLit>((yyvsp[0].sv_str));
     }
-#line 1873 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1966 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 37: /* condition: col op expr  */
-#line 225 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 45: /* condition: col op expr  */
+#line 265 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_cond) = std::make_shared<BinaryExpr>((yyvsp[-2].sv_col), (yyvsp[-1].sv_comp_op), (yyvsp[0].sv_expr));
     }
-#line 1881 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1974 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 38: /* optWhereClause: %empty  */
-#line 231 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 46: /* optWhereClause: %empty  */
+#line 271 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
                       { /* ignore*/ }
-#line 1887 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1980 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 39: /* optWhereClause: WHERE whereClause  */
-#line 233 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 47: /* optWhereClause: WHERE whereClause  */
+#line 273 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_conds) = (yyvsp[0].sv_conds);
     }
-#line 1895 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1988 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 40: /* whereClause: condition  */
-#line 240 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 48: /* whereClause: condition  */
+#line 280 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_conds) = std::vector<std::shared_ptr<BinaryExpr>>{(yyvsp[0].sv_cond)};
     }
-#line 1903 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1996 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 41: /* whereClause: whereClause AND condition  */
-#line 244 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 49: /* whereClause: whereClause AND condition  */
+#line 284 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_conds).push_back((yyvsp[0].sv_cond));
     }
-#line 1911 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2004 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 42: /* col: tbName '.' colName  */
-#line 251 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 50: /* col: tbName '.' colName  */
+#line 291 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>((yyvsp[-2].sv_str), (yyvsp[0].sv_str));
     }
-#line 1919 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2012 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 43: /* col: colName  */
-#line 255 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 51: /* col: colName  */
+#line 295 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>("", (yyvsp[0].sv_str));
     }
-#line 1927 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2020 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 44: /* colList: col  */
-#line 262 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 52: /* colList: col  */
+#line 302 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_cols) = std::vector<std::shared_ptr<Col>>{(yyvsp[0].sv_col)};
     }
-#line 1935 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2028 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 45: /* colList: colList ',' col  */
-#line 266 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 53: /* colList: colList ',' col  */
+#line 306 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_cols).push_back((yyvsp[0].sv_col));
     }
-#line 1943 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2036 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 46: /* op: '='  */
-#line 273 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 54: /* op: '='  */
+#line 313 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_EQ;
     }
-#line 1951 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2044 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 47: /* op: '<'  */
-#line 277 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 55: /* op: '<'  */
+#line 317 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_LT;
     }
-#line 1959 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2052 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 48: /* op: '>'  */
-#line 281 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 56: /* op: '>'  */
+#line 321 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_GT;
     }
-#line 1967 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2060 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 49: /* op: NEQ  */
-#line 285 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 57: /* op: NEQ  */
+#line 325 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_NE;
     }
-#line 1975 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2068 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 50: /* op: LEQ  */
-#line 289 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 58: /* op: LEQ  */
+#line 329 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_LE;
     }
-#line 1983 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2076 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 51: /* op: GEQ  */
-#line 293 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 59: /* op: GEQ  */
+#line 333 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_GE;
     }
-#line 1991 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2084 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 52: /* expr: value  */
-#line 300 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 60: /* expr: value  */
+#line 340 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_expr) = std::static_pointer_cast<Expr>((yyvsp[0].sv_val));
     }
-#line 1999 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2092 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 53: /* expr: col  */
-#line 304 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 61: /* expr: col  */
+#line 344 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_expr) = std::static_pointer_cast<Expr>((yyvsp[0].sv_col));
     }
-#line 2007 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2100 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 54: /* setClauses: setClause  */
-#line 311 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 62: /* setClauses: setClause  */
+#line 351 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_set_clauses) = std::vector<std::shared_ptr<SetClause>>{(yyvsp[0].sv_set_clause)};
     }
-#line 2015 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2108 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 55: /* setClauses: setClauses ',' setClause  */
-#line 315 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 63: /* setClauses: setClauses ',' setClause  */
+#line 355 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_set_clauses).push_back((yyvsp[0].sv_set_clause));
     }
-#line 2023 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2116 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 56: /* setClause: colName '=' value  */
-#line 322 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 64: /* setClause: colName '=' value  */
+#line 362 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_set_clause) = std::make_shared<SetClause>((yyvsp[-2].sv_str), (yyvsp[0].sv_val));
     }
-#line 2031 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2124 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 57: /* selector: '*'  */
-#line 329 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 65: /* selector: '*'  */
+#line 369 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_cols) = {};
     }
-#line 2039 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2132 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 59: /* tableList: tbName  */
-#line 337 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 67: /* tableList: tbName  */
+#line 377 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_strs) = std::vector<std::string>{(yyvsp[0].sv_str)};
     }
-#line 2047 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2140 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 60: /* tableList: tableList ',' tbName  */
-#line 341 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 68: /* tableList: tableList ',' tbName  */
+#line 381 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_strs).push_back((yyvsp[0].sv_str));
     }
-#line 2055 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2148 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 61: /* tableList: tableList JOIN tbName  */
-#line 345 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 69: /* tableList: tableList JOIN tbName  */
+#line 385 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_strs).push_back((yyvsp[0].sv_str));
     }
-#line 2063 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2156 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 62: /* opt_order_clause: ORDER BY order_clause  */
-#line 352 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 70: /* opt_order_clause: ORDER BY order_clause  */
+#line 392 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     { 
         (yyval.sv_orderby) = (yyvsp[0].sv_orderby); 
     }
-#line 2071 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2164 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 63: /* opt_order_clause: %empty  */
-#line 355 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 71: /* opt_order_clause: %empty  */
+#line 395 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
                       { /* ignore*/ }
-#line 2077 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2170 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 64: /* order_clause: col opt_asc_desc  */
-#line 360 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 72: /* order_clause: col opt_asc_desc  */
+#line 400 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
     { 
         (yyval.sv_orderby) = std::make_shared<OrderBy>((yyvsp[-1].sv_col), (yyvsp[0].sv_orderby_dir));
     }
-#line 2085 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2178 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 65: /* opt_asc_desc: ASC  */
-#line 366 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 73: /* opt_limit_clause: LIMIT VALUE_INT  */
+#line 406 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+                            { (yyval.sv_int) = (yyvsp[0].sv_int); }
+#line 2184 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 74: /* opt_limit_clause: %empty  */
+#line 407 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+                            { (yyval.sv_int) = -1; }
+#line 2190 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 75: /* opt_asc_desc: ASC  */
+#line 411 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
                  { (yyval.sv_orderby_dir) = OrderBy_ASC;     }
-#line 2091 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2196 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 66: /* opt_asc_desc: DESC  */
-#line 367 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 76: /* opt_asc_desc: DESC  */
+#line 412 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
                  { (yyval.sv_orderby_dir) = OrderBy_DESC;    }
-#line 2097 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2202 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 67: /* opt_asc_desc: %empty  */
-#line 368 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+  case 77: /* opt_asc_desc: %empty  */
+#line 413 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
             { (yyval.sv_orderby_dir) = OrderBy_DEFAULT; }
-#line 2103 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2208 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 78: /* optIncludeCols: INCLUDE '(' colNameList ')'  */
+#line 417 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+                                        { (yyval.sv_strs) = (yyvsp[-1].sv_strs); }
+#line 2214 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 79: /* optIncludeCols: %empty  */
+#line 418 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+                                        { /* ignore */ }
+#line 2220 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 80: /* optIndexMethod: USING BTREE  */
+#line 422 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+                        { (yyval.sv_index_method) = IX_METHOD_BTREE; }
+#line 2226 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 81: /* optIndexMethod: USING HASH  */
+#line 423 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+                        { (yyval.sv_index_method) = IX_METHOD_HASH; }
+#line 2232 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 82: /* optIndexMethod: USING BITMAP  */
+#line 424 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+                        { (yyval.sv_index_method) = IX_METHOD_BITMAP; }
+#line 2238 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 83: /* optIndexMethod: %empty  */
+#line 425 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+                        { (yyval.sv_index_method) = IX_METHOD_BTREE; }
+#line 2244 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
 
-#line 2107 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2248 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.tab.cpp"
 
       default: break;
     }
@@ -2332,5 +2473,5 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 374 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
+#line 431 "/home/lkyu/CS/database/rucbase-lab/src/parser/yacc.y"
 
@@ -23,6 +23,7 @@ using namespace ast;
 // keywords
 %token SHOW TABLES CREATE TABLE DROP DESC INSERT INTO VALUES DELETE FROM ASC ORDER BY
 WHERE UPDATE SET SELECT INT CHAR FLOAT INDEX AND JOIN EXIT HELP TXN_BEGIN TXN_COMMIT TXN_ABORT TXN_ROLLBACK ORDER_BY
+VACUUM USING HASH BTREE BITMAP INCLUDE LIMIT CLUSTERED
 // non-keywords
 %token LEQ NEQ GEQ T_EOF
 
@@ -35,13 +36,15 @@ WHERE UPDATE SET SELECT INT CHAR FLOAT INDEX AND JOIN EXIT HELP TXN_BEGIN TXN_CO
 %type <sv_node> stmt dbStmt ddl dml txnStmt
 %type <sv_field> field
 %type <sv_fields> fieldList
+%type <sv_table_option> tableOption
+%type <sv_table_options> tableOptionList optTableOptions
 %type <sv_type_len> type
 %type <sv_comp_op> op
 %type <sv_expr> expr
 %type <sv_val> value
 %type <sv_vals> valueList
 %type <sv_str> tbName colName
-%type <sv_strs> tableList colNameList
+%type <sv_strs> tableList colNameList optIncludeCols
 %type <sv_col> col
 %type <sv_cols> colList selector
 %type <sv_set_clause> setClause
@@ -49,7 +52,9 @@ WHERE UPDATE SET SELECT INT CHAR FLOAT INDEX AND JOIN EXIT HELP TXN_BEGIN TXN_CO
 %type <sv_cond> condition
 %type <sv_conds> whereClause optWhereClause
 %type <sv_orderby>  order_clause opt_order_clause
+%type <sv_int> opt_limit_clause
 %type <sv_orderby_dir> opt_asc_desc
+%type <sv_index_method> optIndexMethod
 
 %%
 start:
@@ -106,12 +111,16 @@ dbStmt:
     {
         $$ = std::make_shared<ShowTables>();
     }
+    |   SET IDENTIFIER '=' VALUE_INT
+    {
+        $$ = std::make_shared<SetKnob>($2, $4);
+    }
     ;
 
 ddl:
-        CREATE TABLE tbName '(' fieldList ')'
+        CREATE TABLE tbName '(' fieldList ')' optTableOptions
     {
-        $$ = std::make_shared<CreateTable>($3, $5);
+        $$ = std::make_shared<CreateTable>($3, $5, $7);
     }
     |   DROP TABLE tbName
     {
@@ -121,14 +130,18 @@ ddl:
     {
         $$ = std::make_shared<DescTable>($2);
     }
-    |   CREATE INDEX tbName '(' colNameList ')'
+    |   CREATE INDEX tbName '(' colNameList ')' optIncludeCols optIndexMethod
     {
-        $$ = std::make_shared<CreateIndex>($3, $5);
+        $$ = std::make_shared<CreateIndex>($3, $5, $7, $8);
     }
     |   DROP INDEX tbName '(' colNameList ')'
     {
         $$ = std::make_shared<DropIndex>($3, $5);
     }
+    |   VACUUM tbName
+    {
+        $$ = std::make_shared<VacuumTable>($2);
+    }
     ;
 
 dml:
@@ -144,9 +157,9 @@ dml:
     {
         $$ = std::make_shared<UpdateStmt>($2, $4, $5);
     }
-    |   SELECT selector FROM tableList optWhereClause opt_order_clause
+    |   SELECT selector FROM tableList optWhereClause opt_order_clause opt_limit_clause
     {
-        $$ = std::make_shared<SelectStmt>($2, $4, $5, $6);
+        $$ = std::make_shared<SelectStmt>($2, $4, $5, $6, $7);
     }
     ;
 
@@ -161,6 +174,33 @@ fieldList:
     }
     ;
 
+optTableOptions:
+        /* epsilon */ { /* ignore*/ }
+    |   tableOptionList
+    ;
+
+tableOptionList:
+        tableOption
+    {
+        $$ = std::vector<std::shared_ptr<TableOption>>{$1};
+    }
+    |   tableOptionList tableOption
+    {
+        $$.push_back($2);
+    }
+    ;
+
+tableOption:
+        IDENTIFIER '=' IDENTIFIER
+    {
+        $$ = std::make_shared<TableOption>($1, $3);
+    }
+    |   CLUSTERED BY '(' colNameList ')'
+    {
+        $$ = std::make_shared<TableOption>("clustered", "", $4);
+    }
+    ;
+
 colNameList:
         colName
     {
@@ -362,12 +402,29 @@ order_clause:
     }
     ;   
 
+opt_limit_clause:
+        LIMIT VALUE_INT     { $$ = $2; }
+    |   /* epsilon */       { $$ = -1; }
+    ;
+
 opt_asc_desc:
     ASC          { $$ = OrderBy_ASC;     }
     |  DESC      { $$ = OrderBy_DESC;    }
     |       { $$ = OrderBy_DEFAULT; }
     ;    
 
+optIncludeCols:
+        INCLUDE '(' colNameList ')'     { $$ = $3; }
+    |   /* epsilon */                   { /* ignore */ }
+    ;
+
+optIndexMethod:
+        USING BTREE     { $$ = IX_METHOD_BTREE; }
+    |   USING HASH      { $$ = IX_METHOD_HASH; }
+    |   USING BITMAP    { $$ = IX_METHOD_BITMAP; }
+    |   /* epsilon */   { $$ = IX_METHOD_BTREE; }
+    ;
+
 tbName: IDENTIFIER;
 
 colName: IDENTIFIER;
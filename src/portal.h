@@ -16,9 +16,12 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/common.h"
 #include "execution/execution_sort.h"
+#include "execution/executor_limit.h"
 #include "execution/executor_abstract.h"
+#include "execution/executor_bitmap_scan.h"
 #include "execution/executor_delete.h"
 #include "execution/executor_index_scan.h"
+#include "execution/executor_index_nestedloop_join.h"
 #include "execution/executor_insert.h"
 #include "execution/executor_nestedloop_join.h"
 #include "execution/executor_projection.h"
@@ -172,29 +175,46 @@ class Portal {
         std::shared_ptr<Plan> plan, Context *context) {
         if (auto x = std::dynamic_pointer_cast<ProjectionPlan>(plan)) {
             return std::make_unique<ProjectionExecutor>(
-                convert_plan_executor(x->subplan_, context), x->sel_cols_);
+                convert_plan_executor(x->subplan_, context), x->sel_cols_,
+                context->arena_);
         } else if (auto x = std::dynamic_pointer_cast<ScanPlan>(plan)) {
             if (x->tag == T_SeqScan) {
                 return std::make_unique<SeqScanExecutor>(
                     sm_manager_, x->tab_name_, x->conds_, context);
+            } else if (x->tag == T_BitmapScan) {
+                return std::make_unique<BitmapScanExecutor>(
+                    sm_manager_, x->tab_name_, x->conds_, context);
             } else {
                 return std::make_unique<IndexScanExecutor>(
                     sm_manager_, x->tab_name_, x->conds_, x->index_col_names_,
-                    context);
+                    context, x->index_only_, x->reverse_, x->bitmap_heap_);
             }
         } else if (auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
             std::unique_ptr<AbstractExecutor> left =
                 convert_plan_executor(x->left_, context);
+            if (x->tag == T_IndexNestLoop) {
+                auto inner = std::dynamic_pointer_cast<ScanPlan>(x->right_);
+                auto right = std::make_unique<IndexScanExecutor>(
+                    sm_manager_, inner->tab_name_, inner->conds_,
+                    inner->index_col_names_, context, inner->index_only_);
+                return std::make_unique<IndexNestedLoopJoinExecutor>(
+                    std::move(left), std::move(right), std::move(x->conds_),
+                    context->arena_);
+            }
             std::unique_ptr<AbstractExecutor> right =
                 convert_plan_executor(x->right_, context);
             std::unique_ptr<AbstractExecutor> join =
                 std::make_unique<NestedLoopJoinExecutor>(
-                    std::move(left), std::move(right), std::move(x->conds_));
+                    std::move(left), std::move(right), std::move(x->conds_),
+                    context->arena_);
             return join;
         } else if (auto x = std::dynamic_pointer_cast<SortPlan>(plan)) {
             return std::make_unique<SortExecutor>(
                 convert_plan_executor(x->subplan_, context), x->sel_col_,
-                x->is_desc_);
+                x->is_desc_, context->arena_);
+        } else if (auto x = std::dynamic_pointer_cast<LimitPlan>(plan)) {
+            return std::make_unique<LimitExecutor>(
+                convert_plan_executor(x->subplan_, context), x->limit_);
         }
         return nullptr;
     }
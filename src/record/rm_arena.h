@@ -0,0 +1,78 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @description: 查询内存区，按顺序从大块内存中切出空间，单独的空间不释放，整个查询结束后一起回收
+ * 投影、连接和排序执行器逐元组产生的输出记录(对象和数据缓冲区)都从这里分配，省去逐元组的malloc/free。
+ * 每个客户端连接持有一个，每条语句开始时reset()；此时上一条语句的执行器和它们产生的记录都已销毁。
+ * 一个查询从这里分配的空间超过MAX_SIZE后allocate()返回nullptr，记录改为单独分配，避免大查询占用过多内存
+ */
+class RmArena {
+   public:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;         // 每次向系统申请的块大小
+    static constexpr size_t MAX_SIZE = 64 * 1024 * 1024;    // 一个查询最多从内存区分配的字节数
+    static constexpr size_t ALIGN = alignof(std::max_align_t);
+
+    RmArena() = default;
+    RmArena(const RmArena &) = delete;
+    RmArena &operator=(const RmArena &) = delete;
+
+    /**
+     * @description: 分配size字节，按ALIGN对齐；超过MAX_SIZE时返回nullptr
+     */
+    void *allocate(size_t size) {
+        size = (size + ALIGN - 1) / ALIGN * ALIGN;
+        if (used_ + size > MAX_SIZE) {
+            return nullptr;
+        }
+        if (blocks_.empty() || pos_ + size > blocks_.back().size) {
+            size_t block_size = std::max(BLOCK_SIZE, size);
+            blocks_.push_back({std::make_unique<char[]>(block_size), block_size});
+            pos_ = 0;
+        }
+        void *ptr = blocks_.back().data.get() + pos_;
+        pos_ += size;
+        used_ += size;
+        return ptr;
+    }
+
+    /**
+     * @description: 回收全部空间；保留第一块给下一个查询，小查询不再向系统申请内存
+     */
+    void reset() {
+        if (blocks_.size() > 1) {
+            blocks_.resize(1);
+        }
+        pos_ = 0;
+        used_ = 0;
+    }
+
+    // 当前查询已经分配的字节数(按ALIGN对齐后)
+    size_t used() const { return used_; }
+
+    size_t num_blocks() const { return blocks_.size(); }
+
+   private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks_;
+    size_t pos_ = 0;   // 最后一块中已分配的字节数
+    size_t used_ = 0;
+};
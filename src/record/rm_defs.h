@@ -11,76 +11,157 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "defs.h"
+#include "rm_arena.h"
 #include "storage/buffer_pool_manager.h"
 
 constexpr int RM_NO_PAGE = -1;
 constexpr int RM_FILE_HDR_PAGE = 0;
 constexpr int RM_FIRST_RECORD_PAGE = 1;
 constexpr int RM_MAX_RECORD_SIZE = 512;
+constexpr int RM_MAX_INSERT_PROBES = 4;  // 插入时最多尝试的候选页面数，超过后直接分配新页面
+constexpr int RM_MAX_COLS = 64;          // PAX布局的表最多包含的字段数
+constexpr int RM_HEAP_PREFETCH_PAGES = 8;  // 按页面顺序读取一批rid时，在当前页面之后预读的页面数
+
+/* 表数据文件的页面布局 */
+constexpr int RM_LAYOUT_ROW = 0;  // 行存：每个slot连续存放一整条记录
+constexpr int RM_LAYOUT_PAX = 1;  // PAX：页面内按字段划分minipage，同一字段的值连续存放
 
 /* 文件头，记录表数据文件的元信息，写入磁盘中文件的第0号页面 */
 struct RmFileHdr {
     int record_size;  // 表中每条记录的大小，由于不包含变长字段，因此当前字段初始化后保持不变
     int num_pages;             // 文件中分配的页面个数（初始化为1）
     int num_records_per_page;  // 每个页面最多能存储的元组个数
-    int first_free_page_no;  // 文件中当前第一个包含空闲空间的页面号（初始化为-1）
+    int first_free_page_no;  // 已不再使用(空闲页面由FSM维护)，保留以兼容文件格式，始终为-1
     int bitmap_size;         // 每个页面bitmap大小
+    int layout;              // 页面布局，RM_LAYOUT_ROW或RM_LAYOUT_PAX
+    int num_cols;            // PAX布局下记录的字段个数，行存时为0
+    int col_offsets[RM_MAX_COLS];  // PAX布局下每个字段在记录中的偏移量
+    int col_lens[RM_MAX_COLS];     // PAX布局下每个字段的长度
 };
 
 /* 表数据文件中每个页面的页头，记录每个页面的元信息 */
 struct RmPageHdr {
-    int next_free_page_no;  // 当前页面满了之后，下一个包含空闲空间的页面号（初始化为-1）
+    int next_free_page_no;  // 已不再使用(空闲页面由FSM维护)，保留以兼容页面格式，始终为-1
     int num_records;  // 当前页面中当前已经存储的记录个数（初始化为0）
 };
 
-/* 表中的记录 */
+/* 表中的记录
+ * 执行器的输出元组由make()从查询内存区RmArena中分配：对象前面的头部记录它是否在内存区中，
+ * delete时内存区中的对象和缓冲区都不释放，随内存区一起回收，所以这些记录必须在内存区reset()之前销毁 */
 struct RmRecord {
-    char* data;               // 记录的数据
-    int size;                 // 记录的大小
+    char* data = nullptr;     // 记录的数据
+    int size = 0;             // 记录的大小
     bool allocated_ = false;  // 是否已经为数据分配空间
 
     RmRecord() = default;
 
     RmRecord(const RmRecord& other) {
-        size = other.size;
-        data = new char[size];
+        allocate(other.size);
         memcpy(data, other.data, size);
-        allocated_ = true;
     };
 
+    RmRecord(RmRecord&& other) noexcept
+        : data(other.data), size(other.size), allocated_(other.allocated_) {
+        other.data = nullptr;
+        other.size = 0;
+        other.allocated_ = false;
+    }
+
     RmRecord& operator=(const RmRecord& other) {
-        size = other.size;
-        data = new char[size];
-        memcpy(data, other.data, size);
-        allocated_ = true;
+        if (this != &other) {
+            if (!allocated_ || size != other.size) {
+                release();
+                allocate(other.size);
+            }
+            memcpy(data, other.data, size);
+        }
         return *this;
     };
 
-    RmRecord(int size_) {
-        size = size_;
-        data = new char[size_];
-        allocated_ = true;
+    RmRecord& operator=(RmRecord&& other) noexcept {
+        if (this != &other) {
+            release();
+            data = other.data;
+            size = other.size;
+            allocated_ = other.allocated_;
+            other.data = nullptr;
+            other.size = 0;
+            other.allocated_ = false;
+        }
+        return *this;
     }
 
+    RmRecord(int size_) { allocate(size_); }
+
     RmRecord(int size_, char* data_) {
-        size = size_;
-        data = new char[size_];
+        allocate(size_);
         memcpy(data, data_, size_);
-        allocated_ = true;
+    }
+
+    // 数据缓冲区从arena中分配，arena为nullptr或已满时单独分配
+    RmRecord(int size_, RmArena* arena) {
+        void* buf = arena == nullptr ? nullptr : arena->allocate(size_);
+        if (buf == nullptr) {
+            allocate(size_);
+            return;
+        }
+        size = size_;
+        data = static_cast<char*>(buf);
+    }
+
+    // 大小为size_的输出元组，对象和数据缓冲区都尽量从arena中分配
+    static std::unique_ptr<RmRecord> make(int size_, RmArena* arena) {
+        return std::unique_ptr<RmRecord>(new (arena) RmRecord(size_, arena));
     }
 
     void SetData(char* data_) { memcpy(data, data_, size); }
 
     void Deserialize(const char* data_) {
-        size = *reinterpret_cast<const int*>(data_);
-        if (allocated_) {
-            delete[] data;
-        }
-        data = new char[size];
+        release();
+        allocate(*reinterpret_cast<const int*>(data_));
         memcpy(data, data_ + sizeof(int), size);
     }
 
-    ~RmRecord() {
+    ~RmRecord() { release(); }
+
+    static void* operator new(size_t sz) { return with_header(::operator new(sz + HEADER_SIZE), false); }
+
+    static void* operator new(size_t sz, RmArena* arena) {
+        void* buf = arena == nullptr ? nullptr : arena->allocate(sz + HEADER_SIZE);
+        if (buf == nullptr) {
+            return operator new(sz);
+        }
+        return with_header(buf, true);
+    }
+
+    static void operator delete(void* ptr) {
+        if (ptr == nullptr) {
+            return;
+        }
+        char* header = static_cast<char*>(ptr) - HEADER_SIZE;
+        if (!*reinterpret_cast<bool*>(header)) {
+            ::operator delete(header);
+        }
+    }
+
+    // 构造函数抛出异常时由new (arena)调用
+    static void operator delete(void* ptr, RmArena*) { operator delete(ptr); }
+
+   private:
+    static constexpr size_t HEADER_SIZE = RmArena::ALIGN;  // 对象前的头部，保持对象的对齐
+
+    static void* with_header(void* buf, bool in_arena) {
+        *static_cast<bool*>(buf) = in_arena;
+        return static_cast<char*>(buf) + HEADER_SIZE;
+    }
+
+    void allocate(int size_) {
+        size = size_;
+        data = new char[size_];
+        allocated_ = true;
+    }
+
+    void release() {
         if (allocated_) {
             delete[] data;
         }
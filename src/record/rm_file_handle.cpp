@@ -11,27 +11,92 @@ See the Mulan PSL v2 for more details. */
 #include "rm_file_handle.h"
 
 #include "common/context.h"
+#include "rm_scan.h"
 #include "storage/buffer_pool_manager.h"
 #include "storage/disk_manager.h"
 
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+
+// 每个线程最近一次插入成功的页面号(按文件句柄区分)，同一线程的连续插入优先落在同一页面，
+// 不同线程则自然分散到不同页面，减少对同一页面写锁的竞争
+static thread_local std::unordered_map<int, int> insert_page_hint;
+
+// 截断文件时尾部页面仍被其他线程固定的最大重试次数，每次间隔1ms
+static constexpr int TRUNCATE_MAX_RETRIES = 1000;
+
 std::unique_ptr<RmRecord> RmFileHandle::get_record(const Rid& rid,
                                                    Context* context) const {
     RmPageHandle page_handle = fetch_page_handle(rid.page_no);
     /*调用 fetch_page_handle 从缓冲池中获取指定页面，并封装为 RmPageHandle 对象
     （包含页面头、位图、槽位数组等元信息）。*/
-    char* slot = page_handle.get_slot(rid.slot_no);
-    /*通过 get_slot 计算目标槽位的物理地址：
-      槽位地址 = slots起始地址 + slot_no * record_size */
+    page_handle.page->rlatch();
     auto record = std::make_unique<RmRecord>(file_hdr_.record_size);
-    memcpy(record->data, slot, file_hdr_.record_size);
+    page_handle.read_record(rid.slot_no, record->data);
     // 根据文件头中定义的 record_size 分配内存，并将槽位数据复制到新创建的
-    // RmRecord 中。
+    // RmRecord 中（PAX布局下从各字段的minipage中拼接出整条记录）。
+    page_handle.page->runlatch();
     buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
     // 操作完成后解除页面锁定（pin_count--），false
     // 表示不强制刷盘（因未修改页面）。
     return record;
 }
 
+/**
+ * @description: 只读取记录中的部分字段
+ * @param {Rid&} rid 记录的ID
+ * @param {vector<int>&} fields 需要读取的字段下标
+ * @param {Context*} context
+ * @return {unique_ptr<RmRecord>} 与完整记录等长的记录，只有fields中的字段有效
+ * PAX布局下只会访问这些字段所在的minipage；行存布局下等价于读取整条记录
+ */
+std::unique_ptr<RmRecord> RmFileHandle::get_record(
+    const Rid& rid, const std::vector<int>& fields, Context* context) const {
+    RmPageHandle page_handle = fetch_page_handle(rid.page_no);
+    page_handle.page->rlatch();
+    auto record = std::make_unique<RmRecord>(file_hdr_.record_size);
+    page_handle.read_fields(rid.slot_no, record->data, fields);
+    page_handle.page->runlatch();
+    buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+    return record;
+}
+
+/**
+ * @description: 读取同一个页面中的多条记录，页面只固定和加锁一次
+ * @param {Rid*} rids 页面号都相同的num_rids个记录
+ * @param {vector<int>*} fields 需要读取的字段下标，nullptr表示读取整条记录
+ * @param {vector<unique_ptr<RmRecord>>*} records 与rids一一对应，槽位上已经没有记录时为nullptr
+ */
+void RmFileHandle::get_records(const Rid* rids, size_t num_rids,
+                               const std::vector<int>* fields,
+                               std::vector<std::unique_ptr<RmRecord>>* records,
+                               Context* context) const {
+    records->clear();
+    if (num_rids == 0) {
+        return;
+    }
+    RmPageHandle page_handle = fetch_page_handle(rids[0].page_no);
+    page_handle.page->rlatch();
+    for (size_t i = 0; i < num_rids; i++) {
+        assert(rids[i].page_no == rids[0].page_no);
+        if (!Bitmap::is_set(page_handle.bitmap, rids[i].slot_no)) {
+            records->push_back(nullptr);
+            continue;
+        }
+        auto record = std::make_unique<RmRecord>(file_hdr_.record_size);
+        if (fields == nullptr) {
+            page_handle.read_record(rids[i].slot_no, record->data);
+        } else {
+            page_handle.read_fields(rids[i].slot_no, record->data, *fields);
+        }
+        records->push_back(std::move(record));
+    }
+    page_handle.page->runlatch();
+    buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+}
+
 /**
  * @description: 插入一条新记录到文件中
  * @param {char*} buf 要插入的记录数据缓冲区
@@ -39,15 +104,16 @@ std::unique_ptr<RmRecord> RmFileHandle::get_record(const Rid& rid,
  * @return {Rid} 返回新插入记录的ID（页面号+槽位号）
  *
  * 实现步骤：
- * 1. 获取一个有空闲槽位的页面（优先复用空闲页，无则创建新页）
+ * 1. 根据FSM获取一个有空闲槽位的页面（返回时已持有页面写锁），无则创建新页
  * 2. 在页面中查找第一个空闲槽位
  * 3. 更新位图标记槽位已使用
  * 4. 将记录数据复制到槽位中
  * 5. 更新页面记录计数
- * 6. 如果页面变满，更新空闲页链表
+ * 6. 更新FSM中该页面的空闲槽位数
  * 7. 返回新记录的RID
  */
 Rid RmFileHandle::insert_record(char* buf, Context* context) {
+    std::shared_lock<std::shared_mutex> table_lock(table_latch_);
     // 步骤1：获取可用页面（自动处理空闲页或创建新页）
     RmPageHandle page_handle = create_page_handle();
 
@@ -59,61 +125,89 @@ Rid RmFileHandle::insert_record(char* buf, Context* context) {
     Bitmap::set(page_handle.bitmap, slot_no);
 
     // 步骤4：将记录数据复制到槽位
-    memcpy(page_handle.get_slot(slot_no), buf, file_hdr_.record_size);
+    page_handle.write_record(slot_no, buf);
 
     // 步骤5：增加页面记录计数
     page_handle.page_hdr->num_records++;
 
-    // 步骤6：检查页面是否变满
-    if (page_handle.page_hdr->num_records == file_hdr_.num_records_per_page) {
-        // 从空闲链表移除该页：原next指针成为新的链表头
-        file_hdr_.first_free_page_no = page_handle.page_hdr->next_free_page_no;
-        // 当前页标记为无后续空闲页
-        page_handle.page_hdr->next_free_page_no = RM_NO_PAGE;
+    // 步骤6：更新FSM（持有页面写锁，保证同一页面的FSM更新有序）
+    int page_no = page_handle.page->get_page_id().page_no;
+    fsm_->update(page_no, file_hdr_.num_records_per_page -
+                              page_handle.page_hdr->num_records);
+    if (zone_map_ != nullptr) {
+        zone_map_->extend(page_no, buf);
     }
 
     // 构造新记录的RID（页面号+槽位号）
-    Rid rid{page_handle.page->get_page_id().page_no, slot_no};
+    Rid rid{page_no, slot_no};
 
-    // 解除页面锁定（dirty=true因为修改了页面内容）
+    // 释放页面写锁并解除页面锁定（dirty=true因为修改了页面内容）
+    page_handle.page->wunlatch();
     buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
 
     return rid;
 }
 
+/**
+ * @description: 在指定位置插入一条记录
+ * @param {Rid&} rid 要插入记录的位置，该位置必须空闲
+ * @param {char*} buf 要插入的记录数据缓冲区
+ */
+void RmFileHandle::insert_record(const Rid& rid, char* buf) {
+    RmPageHandle page_handle = fetch_page_handle(rid.page_no);
+    page_handle.page->wlatch();
+    if (Bitmap::is_set(page_handle.bitmap, rid.slot_no)) {
+        page_handle.page->wunlatch();
+        buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+        throw InternalError("Slot (" + std::to_string(rid.page_no) + "," +
+                            std::to_string(rid.slot_no) + ") is occupied");
+    }
+    Bitmap::set(page_handle.bitmap, rid.slot_no);
+    page_handle.write_record(rid.slot_no, buf);
+    page_handle.page_hdr->num_records++;
+    fsm_->update(rid.page_no, file_hdr_.num_records_per_page -
+                                  page_handle.page_hdr->num_records);
+    if (zone_map_ != nullptr) {
+        zone_map_->extend(rid.page_no, buf);
+    }
+    page_handle.page->wunlatch();
+    buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
+}
+
 /**
  * @description: 删除指定记录
  * @param {Rid&} rid 要删除记录的ID
  * @param {Context*} context 事务上下文（本实验未使用）
  *
  * 实现步骤：
- * 1. 获取记录所在页面
- * 2. 检查删除前页面是否已满（用于判断是否需要加入空闲链表）
- * 3. 重置位图中对应位
- * 4. 减少页面记录计数
- * 5. 如果页面从满变为不满，将其加入空闲链表
- * 6. 解除页面锁定
+ * 1. 获取记录所在页面并加写锁
+ * 2. 重置位图中对应位
+ * 3. 减少页面记录计数
+ * 4. 更新FSM中该页面的空闲槽位数
+ * 5. 释放写锁并解除页面锁定
  */
 void RmFileHandle::delete_record(const Rid& rid, Context* context) {
+    std::shared_lock<std::shared_mutex> table_lock(table_latch_);
     // 步骤1：获取记录所在页面
     RmPageHandle page_handle = fetch_page_handle(rid.page_no);
+    page_handle.page->wlatch();
 
-    // 步骤2：记录删除前页面是否已满
-    bool was_full =
-        (page_handle.page_hdr->num_records == file_hdr_.num_records_per_page);
-
-    // 步骤3：重置位图标记槽位为空闲
+    // 步骤2：重置位图标记槽位为空闲
     Bitmap::reset(page_handle.bitmap, rid.slot_no);
 
-    // 步骤4：减少页面记录计数
+    // 步骤3：减少页面记录计数
     page_handle.page_hdr->num_records--;
 
-    // 步骤5：如果页面从满变为不满，加入空闲链表
-    if (was_full) {
-        release_page_handle(page_handle);
+    // 步骤4：页面有了空闲槽位，更新FSM
+    fsm_->update(rid.page_no, file_hdr_.num_records_per_page -
+                                  page_handle.page_hdr->num_records);
+    // zone map的范围删除时不收缩，页面变空时才清空
+    if (zone_map_ != nullptr && page_handle.page_hdr->num_records == 0) {
+        zone_map_->reset(rid.page_no);
     }
 
-    // 步骤6：解除页面锁定（dirty=true因为修改了页面内容）
+    // 步骤5：解除页面锁定（dirty=true因为修改了页面内容）
+    page_handle.page->wunlatch();
     buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
 }
 
@@ -128,15 +222,30 @@ void RmFileHandle::delete_record(const Rid& rid, Context* context) {
  * 2. 直接将新数据覆盖到原槽位
  * 3. 解除页面锁定
  */
-void RmFileHandle::update_record(const Rid& rid, char* buf, Context* context) {
+Rid RmFileHandle::update_record(const Rid& rid, char* buf, Context* context) {
+    std::shared_lock<std::shared_mutex> table_lock(table_latch_);
     // 步骤1：获取记录所在页面
     RmPageHandle page_handle = fetch_page_handle(rid.page_no);
 
     // 步骤2：覆盖槽位数据（不需要修改位图或记录计数）
-    memcpy(page_handle.get_slot(rid.slot_no), buf, file_hdr_.record_size);
+    page_handle.page->wlatch();
+    page_handle.write_record(rid.slot_no, buf);
+    if (zone_map_ != nullptr) {
+        zone_map_->extend(rid.page_no, buf);
+    }
+    page_handle.page->wunlatch();
 
     // 步骤3：解除页面锁定（dirty=true因为修改了页面内容）
     buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
+    return rid;
+}
+
+/**
+ * @description: 按页面顺序扫描[begin_page_no, end_page_no)中的记录
+ */
+std::unique_ptr<RecScan> RmFileHandle::scan(std::function<bool(int)> page_filter,
+                                            int begin_page_no, int end_page_no) const {
+    return std::make_unique<RmScan>(this, std::move(page_filter), begin_page_no, end_page_no);
 }
 
 /**
@@ -169,85 +278,233 @@ RmPageHandle RmFileHandle::fetch_page_handle(int page_no) const {
     return RmPageHandle(&file_hdr_, page);
 }
 
+/**
+ * @description: 为文件分配一个新页面并初始化页头和位图
+ * @return {RmPageHandle} 新页面的句柄，返回时已持有页面写锁
+ * 新页面在加锁之后才登记到FSM，避免其他插入线程抢先拿到未初始化的页面
+ */
 RmPageHandle RmFileHandle::create_new_page_handle() {
+    std::lock_guard<std::mutex> lock(extend_latch_);
     PageId new_page_id = {.fd = fd_, .page_no = INVALID_PAGE_ID};
     Page* new_page = buffer_pool_manager_->new_page(&new_page_id);
     if (!new_page) {
         throw InternalError("No free pages available");
     }
+    new_page->wlatch();
 
-    // 初始化页面头
-    RmPageHdr page_hdr{};
-    page_hdr.next_free_page_no = -1;
-    page_hdr.num_records = 0;
-    memcpy(new_page->get_data(), &page_hdr, sizeof(RmPageHdr));
-
-    // 初始化位图为全0
-    char* bitmap = new_page->get_data() + sizeof(RmPageHdr);
-    Bitmap::init(bitmap, file_hdr_.bitmap_size);
+    // 初始化页面头和位图
+    RmPageHandle page_handle(&file_hdr_, new_page);
+    page_handle.page_hdr->next_free_page_no = RM_NO_PAGE;
+    page_handle.page_hdr->num_records = 0;
+    Bitmap::init(page_handle.bitmap, file_hdr_.bitmap_size);
 
     // 更新文件头信息
     file_hdr_.num_pages++;
     disk_manager_->write_page(fd_, RM_FILE_HDR_PAGE, (char*)&file_hdr_,
                               sizeof(file_hdr_));
+    fsm_->update(new_page_id.page_no, file_hdr_.num_records_per_page);
 
-    return RmPageHandle(&file_hdr_, new_page);
+    return page_handle;
 }
 
 /**
- * @description: 创建或获取一个空闲页面句柄
+ * @description: 获取一个有空闲槽位的页面句柄，返回时已持有页面写锁
  * @return {RmPageHandle} 返回可用的页面句柄
  *
  * 实现逻辑：
- * 1. 如果没有空闲页(first_free_page_no == RM_NO_PAGE)，则创建新页
- * 2. 否则获取第一个空闲页，并更新空闲页链表头指针
+ * 1. 以本线程上次插入的页面为起点(没有则按线程id分散起点)在FSM中查找候选页
+ * 2. 对候选页尝试加写锁，加锁失败(其他线程正在写)则跳过，继续查找下一个候选页
+ * 3. 加锁成功后确认页面确实未满(FSM只是近似值)，否则修正FSM并继续查找
+ * 4. 尝试RM_MAX_INSERT_PROBES次仍未成功，或FSM中没有空闲页时，创建新页
  */
 RmPageHandle RmFileHandle::create_page_handle() {
-    // 情况1：当前没有空闲页可用
-    if (file_hdr_.first_free_page_no == RM_NO_PAGE) {
-        // 创建全新的页面（会初始化页面头、位图，并更新文件头）
-        return create_new_page_handle();
+    int num_pages;
+    {
+        std::lock_guard<std::mutex> lock(extend_latch_);
+        num_pages = file_hdr_.num_pages;
     }
 
-    // 情况2：有空闲页可用
-    // 获取当前第一个空闲页的句柄（从缓冲池中取出）
-    RmPageHandle page_handle = fetch_page_handle(file_hdr_.first_free_page_no);
-
-    // 更新文件头中的第一个空闲页指针：
-    // 将原空闲页的next_free_page_no作为新的链表头
-    // （相当于从空闲链表中取出第一个节点）
-    file_hdr_.first_free_page_no = page_handle.page_hdr->next_free_page_no;
+    int start_page_no;
+    auto hint = insert_page_hint.find(fd_);
+    if (hint != insert_page_hint.end()) {
+        start_page_no = hint->second;
+    } else {
+        size_t thread_hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        start_page_no = RM_FIRST_RECORD_PAGE +
+                        thread_hash % std::max(1, num_pages - RM_FIRST_RECORD_PAGE);
+    }
 
-    // 将更新后的文件头立即持久化到磁盘（确保数据一致性）
-    disk_manager_->write_page(fd_, RM_FILE_HDR_PAGE, (char*)&file_hdr_,
-                              sizeof(file_hdr_));
+    for (int probe = 0; probe < RM_MAX_INSERT_PROBES; probe++) {
+        int page_no = fsm_->search(start_page_no, num_pages);
+        if (page_no == RM_NO_PAGE) {
+            break;
+        }
+        RmPageHandle page_handle = fetch_page_handle(page_no);
+        if (page_handle.page->try_wlatch()) {
+            if (page_handle.page_hdr->num_records <
+                file_hdr_.num_records_per_page) {
+                insert_page_hint[fd_] = page_no;
+                return page_handle;
+            }
+            // FSM中的信息已过期，顺便修正
+            fsm_->update(page_no, 0);
+            page_handle.page->wunlatch();
+        }
+        buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+        start_page_no = page_no + 1;
+    }
 
+    RmPageHandle page_handle = create_new_page_handle();
+    insert_page_hint[fd_] = page_handle.page->get_page_id().page_no;
     return page_handle;
 }
 
+void RmFileHandle::rebuild_free_space_map() {
+    for (int page_no = RM_FIRST_RECORD_PAGE; page_no < file_hdr_.num_pages;
+         page_no++) {
+        RmPageHandle page_handle = fetch_page_handle(page_no);
+        fsm_->update(page_no, file_hdr_.num_records_per_page -
+                                  page_handle.page_hdr->num_records);
+        buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+    }
+}
+
+void RmFileHandle::rebuild_zone_map() {
+    zone_map_->truncate(0);
+    RmRecord record(file_hdr_.record_size);
+    int per_page = file_hdr_.num_records_per_page;
+    for (int page_no = RM_FIRST_RECORD_PAGE; page_no < file_hdr_.num_pages;
+         page_no++) {
+        if (fsm_->is_empty(page_no)) {
+            continue;
+        }
+        RmPageHandle page_handle = fetch_page_handle(page_no);
+        for (int slot_no = Bitmap::first_bit(true, page_handle.bitmap, per_page);
+             slot_no < per_page; slot_no = Bitmap::next_bit(true, page_handle.bitmap,
+                                                            per_page, slot_no)) {
+            page_handle.read_record(slot_no, record.data);
+            zone_map_->extend(page_no, record.data);
+        }
+        buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+    }
+}
+
 /**
- * @description: 释放页面句柄（当页面从满变为不满时调用）
- * @param {RmPageHandle} &page_handle 要释放的页面句柄
+ * @description: 压缩数据文件，把尾部页面上的记录搬到前部页面的空闲槽位中，再截断尾部的空页面
+ * @param on_move 每搬迁一条记录后调用，参数为旧rid、新rid和记录内容，供上层修正索引
+ * @return {int} 回收的页面数
  *
- * 实现逻辑：
- * 1. 将页面重新链接到空闲页链表头部
- * 2. 更新文件头中的第一个空闲页指针
+ * 实现步骤：
+ * 1. 统计存活记录数，计算紧凑存放所需的页面数，之后的页面都是待清空的尾部页面
+ * 2. 在FSM中把尾部页面标记为已满，新的插入不会再落到尾部页面
+ * 3. 从最后一页开始，把尾部页面上的每条记录插入到前部页面的空闲槽位(空洞)中，
+ *    再从原位置删除
+ * 4. 截断文件，释放尾部页面
+ * 整个过程持有表的排他锁table_latch_，并发的插入、删除和更新等待VACUUM结束，
+ * 前部的空洞不会被新插入占用；同时持有extend_latch_，期间文件不会扩展
  */
-void RmFileHandle::release_page_handle(RmPageHandle& page_handle) {
-    // 只有当页面不在空闲链表中时才需要处理
-    // （通过检查next_free_page_no是否为RM_NO_PAGE判断）
-    if (page_handle.page_hdr->next_free_page_no == RM_NO_PAGE) {
-        // 将当前页面插入空闲链表头部：
-        // 1. 当前页面的next指向原空闲链表头
-        page_handle.page_hdr->next_free_page_no = file_hdr_.first_free_page_no;
+int RmFileHandle::vacuum(
+    const std::function<void(const Rid&, const Rid&, const RmRecord&)>&
+        on_move) {
+    std::unique_lock<std::shared_mutex> table_lock(table_latch_);
+    std::lock_guard<std::mutex> lock(extend_latch_);
+    int num_pages = file_hdr_.num_pages;
+    int per_page = file_hdr_.num_records_per_page;
+
+    // 步骤1：统计存活记录数
+    long long num_records = 0;
+    for (int page_no = RM_FIRST_RECORD_PAGE; page_no < num_pages; page_no++) {
+        if (fsm_->is_empty(page_no)) {
+            continue;
+        }
+        RmPageHandle page_handle = fetch_page_handle(page_no);
+        page_handle.page->rlatch();
+        num_records += page_handle.page_hdr->num_records;
+        page_handle.page->runlatch();
+        buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+    }
+    int keep_pages =
+        RM_FIRST_RECORD_PAGE + (int)((num_records + per_page - 1) / per_page);
+    if (keep_pages >= num_pages) {
+        return 0;
+    }
 
-        // 2. 文件头的first_free_page_no指向当前页面
-        file_hdr_.first_free_page_no = page_handle.page->get_page_id().page_no;
+    // 步骤2：尾部页面不再接受插入
+    for (int page_no = keep_pages; page_no < num_pages; page_no++) {
+        fsm_->update(page_no, 0);
+    }
 
-        // 将更新后的文件头持久化到磁盘
-        disk_manager_->write_page(fd_, RM_FILE_HDR_PAGE, (char*)&file_hdr_,
-                                  sizeof(file_hdr_));
+    // 步骤3：搬迁尾部页面上的记录
+    Rid hole = {.page_no = RM_FIRST_RECORD_PAGE, .slot_no = -1};
+    RmRecord record(file_hdr_.record_size);
+    for (int page_no = num_pages - 1; page_no >= keep_pages; page_no--) {
+        RmPageHandle src = fetch_page_handle(page_no);
+        src.page->wlatch();
+        for (int slot_no = Bitmap::first_bit(true, src.bitmap, per_page);
+             slot_no < per_page;
+             slot_no = Bitmap::next_bit(true, src.bitmap, per_page, slot_no)) {
+            src.read_record(slot_no, record.data);
+            // 在前部页面中找下一个空洞，存活记录一定能在keep_pages之内放下
+            while (true) {
+                if (hole.page_no >= keep_pages) {
+                    src.page->wunlatch();
+                    buffer_pool_manager_->unpin_page(src.page->get_page_id(),
+                                                     true);
+                    throw InternalError("No free slot left while vacuuming");
+                }
+                RmPageHandle dst = fetch_page_handle(hole.page_no);
+                dst.page->rlatch();
+                hole.slot_no = Bitmap::next_bit(false, dst.bitmap, per_page,
+                                                hole.slot_no);
+                dst.page->runlatch();
+                buffer_pool_manager_->unpin_page(dst.page->get_page_id(),
+                                                 false);
+                if (hole.slot_no < per_page) {
+                    break;
+                }
+                hole = {.page_no = hole.page_no + 1, .slot_no = -1};
+            }
+            insert_record(hole, record.data);
+            Bitmap::reset(src.bitmap, slot_no);
+            src.page_hdr->num_records--;
+            on_move(Rid{page_no, slot_no}, hole, record);
+        }
+        src.page->wunlatch();
+        buffer_pool_manager_->unpin_page(src.page->get_page_id(), true);
     }
 
-    // 注意：这里没有unpin_page操作，由调用者负责
+    // 步骤4：截断文件
+    truncate(keep_pages);
+    return num_pages - keep_pages;
+}
+
+/**
+ * @description: 把数据文件截断为num_pages个页面，调用者需持有extend_latch_，且尾部页面上已经没有记录
+ * 先从缓冲池中驱逐全部尾部页面，再截断文件。页面被其他线程(如扫描)固定时稍后重试，
+ * 重试次数用完仍无法驱逐时不截断，把尾部的空页面重新登记到FSM后抛出InternalError
+ */
+void RmFileHandle::truncate(int num_pages) {
+    for (int page_no = num_pages; page_no < file_hdr_.num_pages; page_no++) {
+        int retries = 0;
+        while (!buffer_pool_manager_->delete_page(PageId{fd_, page_no})) {
+            if (++retries > TRUNCATE_MAX_RETRIES) {
+                for (int empty_page = num_pages; empty_page < file_hdr_.num_pages;
+                     empty_page++) {
+                    fsm_->update(empty_page, file_hdr_.num_records_per_page);
+                }
+                throw InternalError("Page " + std::to_string(page_no) +
+                                    " is pinned, cannot truncate");
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    file_hdr_.num_pages = num_pages;
+    disk_manager_->write_page(fd_, RM_FILE_HDR_PAGE, (char*)&file_hdr_,
+                              sizeof(file_hdr_));
+    disk_manager_->truncate_file(fd_, num_pages);
+    fsm_->truncate(num_pages);
+    if (zone_map_ != nullptr) {
+        zone_map_->truncate(num_pages);
+    }
+    insert_page_hint.erase(fd_);
 }
\ No newline at end of file
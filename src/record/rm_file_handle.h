@@ -12,11 +12,18 @@ See the Mulan PSL v2 for more details. */
 
 #include <assert.h>
 
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
 
 #include "bitmap.h"
 #include "common/context.h"
 #include "rm_defs.h"
+#include "rm_free_space_map.h"
+#include "rm_table_handle.h"
+#include "rm_zone_map.h"
 
 class RmManager;
 
@@ -39,18 +46,64 @@ struct RmPageHandle {
         slots = bitmap + file_hdr->bitmap_size;
     }
 
-    // 返回指定slot_no的slot存储收地址
+    // 返回指定slot_no的slot存储收地址（仅适用于行存布局）
     char *get_slot(int slot_no) const {
+        assert(file_hdr->layout == RM_LAYOUT_ROW);
         return slots +
                slot_no *
                    file_hdr->record_size;  // slots的首地址 + slot个数 *
                                            // 每个slot的大小(每个record的大小)
     }
+
+    // 返回PAX布局下指定slot_no的第col_idx个字段的存储地址
+    // 字段col_idx的minipage起始于 slots + 每页记录数 * 字段偏移量
+    char *get_field(int slot_no, int col_idx) const {
+        return slots +
+               file_hdr->num_records_per_page * file_hdr->col_offsets[col_idx] +
+               slot_no * file_hdr->col_lens[col_idx];
+    }
+
+    // 将slot_no上的整条记录拷贝到dst
+    void read_record(int slot_no, char *dst) const {
+        if (file_hdr->layout == RM_LAYOUT_ROW) {
+            memcpy(dst, get_slot(slot_no), file_hdr->record_size);
+            return;
+        }
+        for (int i = 0; i < file_hdr->num_cols; i++) {
+            memcpy(dst + file_hdr->col_offsets[i], get_field(slot_no, i),
+                   file_hdr->col_lens[i]);
+        }
+    }
+
+    // 只拷贝fields中指定的字段，dst中其余字段的内容未定义
+    void read_fields(int slot_no, char *dst,
+                     const std::vector<int> &fields) const {
+        if (file_hdr->layout == RM_LAYOUT_ROW) {
+            memcpy(dst, get_slot(slot_no), file_hdr->record_size);
+            return;
+        }
+        for (int i : fields) {
+            memcpy(dst + file_hdr->col_offsets[i], get_field(slot_no, i),
+                   file_hdr->col_lens[i]);
+        }
+    }
+
+    // 将src中的整条记录写入slot_no
+    void write_record(int slot_no, const char *src) const {
+        if (file_hdr->layout == RM_LAYOUT_ROW) {
+            memcpy(get_slot(slot_no), src, file_hdr->record_size);
+            return;
+        }
+        for (int i = 0; i < file_hdr->num_cols; i++) {
+            memcpy(get_field(slot_no, i), src + file_hdr->col_offsets[i],
+                   file_hdr->col_lens[i]);
+        }
+    }
 };
 
 /* 每个RmFileHandle对应一个表的数据文件，里面有多个page，每个page的数据封装在RmPageHandle中
  */
-class RmFileHandle {
+class RmFileHandle : public RmTableHandle {
     friend class RmScan;
     friend class RmManager;
 
@@ -59,6 +112,10 @@ class RmFileHandle {
     BufferPoolManager *buffer_pool_manager_;
     int fd_;              // 打开文件后产生的文件句柄
     RmFileHdr file_hdr_;  // 文件头，维护当前表文件的元数据
+    std::unique_ptr<RmFreeSpaceMap> fsm_;  // 空闲空间映射，插入时据此选择目标页面
+    std::mutex extend_latch_;              // 保护文件扩展(分配新页面、修改num_pages)
+    std::shared_mutex table_latch_;  // 表级读写锁：插入、删除、更新持有共享锁，VACUUM持有排他锁
+    std::unique_ptr<RmZoneMap> zone_map_;  // 每页数值列的[min, max]，未启用时为空
 
    public:
     RmFileHandle(DiskManager *disk_manager,
@@ -73,35 +130,70 @@ class RmFileHandle {
                                  sizeof(file_hdr_));
         // disk_manager管理的fd对应的文件中，设置从file_hdr_.num_pages开始分配page_no
         disk_manager_->set_fd2pageno(fd, file_hdr_.num_pages);
+        fsm_ = std::make_unique<RmFreeSpaceMap>(file_hdr_.num_records_per_page);
     }
 
     RmFileHdr get_file_hdr() { return file_hdr_; }
     int GetFd() { return fd_; }
 
+    int record_size() const override { return file_hdr_.record_size; }
+
+    int num_pages() const override { return file_hdr_.num_pages; }
+
     /* 判断指定位置上是否已经存在一条记录，通过Bitmap来判断 */
     bool is_record(const Rid &rid) const {
         RmPageHandle page_handle = fetch_page_handle(rid.page_no);
-        return Bitmap::is_set(page_handle.bitmap,
-                              rid.slot_no);  // page的slot_no位置上是否有record
+        page_handle.page->rlatch();
+        bool exists = Bitmap::is_set(page_handle.bitmap,
+                                     rid.slot_no);  // page的slot_no位置上是否有record
+        page_handle.page->runlatch();
+        buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+        return exists;
     }
 
     std::unique_ptr<RmRecord> get_record(const Rid &rid,
-                                         Context *context) const;
+                                         Context *context) const override;
+
+    std::unique_ptr<RmRecord> get_record(const Rid &rid,
+                                         const std::vector<int> &fields,
+                                         Context *context) const override;
 
-    Rid insert_record(char *buf, Context *context);
+    void get_records(const Rid *rids, size_t num_rids,
+                     const std::vector<int> *fields,
+                     std::vector<std::unique_ptr<RmRecord>> *records,
+                     Context *context) const;
 
+    Rid insert_record(char *buf, Context *context) override;
+
+    // 在指定位置插入记录，供VACUUM搬迁记录使用，调用者需持有table_latch_
     void insert_record(const Rid &rid, char *buf);
 
-    void delete_record(const Rid &rid, Context *context);
+    void delete_record(const Rid &rid, Context *context) override;
+
+    Rid update_record(const Rid &rid, char *buf, Context *context) override;
 
-    void update_record(const Rid &rid, char *buf, Context *context);
+    std::unique_ptr<RecScan> scan(std::function<bool(int)> page_filter = nullptr,
+                                  int begin_page_no = RM_FIRST_RECORD_PAGE,
+                                  int end_page_no = INT32_MAX) const override;
 
     RmPageHandle create_new_page_handle();
 
     RmPageHandle fetch_page_handle(int page_no) const;
 
+    /* 扫描所有数据页，重新建立空闲空间映射（FSM文件缺失时使用） */
+    void rebuild_free_space_map();
+
+    /* 扫描所有数据页，重新建立zone map（zone map文件缺失或与表结构不符时使用） */
+    void rebuild_zone_map();
+
+    /* 返回zone map，未启用时为nullptr */
+    RmZoneMap *get_zone_map() const override { return zone_map_.get(); }
+
+    int vacuum(const std::function<void(const Rid &, const Rid &,
+                                        const RmRecord &)> &on_move);
+
    private:
     RmPageHandle create_page_handle();
 
-    void release_page_handle(RmPageHandle &page_handle);
+    void truncate(int num_pages);
 };
\ No newline at end of file
@@ -0,0 +1,138 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "rm_free_space_map.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "rm_defs.h"
+#include "rm_side_file.h"
+
+/**
+ * @description: 将空闲槽位数量化为一个字节的等级，只要有空闲槽位等级就至少为1
+ */
+uint8_t RmFreeSpaceMap::to_level(int num_free_slots) const {
+    if (num_free_slots <= 0) {
+        return FSM_FULL;
+    }
+    int level = num_free_slots * FSM_MAX_LEVEL / num_records_per_page_;
+    return static_cast<uint8_t>(std::clamp(level, 1, (int)FSM_MAX_LEVEL));
+}
+
+void RmFreeSpaceMap::ensure_capacity(int num_pages) {
+    if ((int)levels_.size() < num_pages) {
+        levels_.resize(num_pages, FSM_FULL);
+        block_max_.resize((num_pages + FSM_BLOCK_SIZE - 1) / FSM_BLOCK_SIZE, FSM_FULL);
+    }
+}
+
+void RmFreeSpaceMap::update(int page_no, int num_free_slots) {
+    std::lock_guard<std::mutex> lock(latch_);
+    ensure_capacity(page_no + 1);
+    uint8_t level = to_level(num_free_slots);
+    levels_[page_no] = level;
+    // 汇总块只维护上界，变小时不必重新计算，由search在扫描整块失败后收紧
+    uint8_t &block = block_max_[page_no / FSM_BLOCK_SIZE];
+    block = std::max(block, level);
+}
+
+bool RmFreeSpaceMap::has_free_space(int page_no) {
+    std::lock_guard<std::mutex> lock(latch_);
+    return page_no >= 0 && page_no < (int)levels_.size() && levels_[page_no] != FSM_FULL;
+}
+
+bool RmFreeSpaceMap::is_empty(int page_no) {
+    std::lock_guard<std::mutex> lock(latch_);
+    // 只有空闲槽位数等于每页记录数时等级才会是FSM_MAX_LEVEL
+    return page_no >= 0 && page_no < (int)levels_.size() && levels_[page_no] == FSM_MAX_LEVEL;
+}
+
+/**
+ * @description: 在[lo, hi)范围内查找第一个空闲等级非0的页面
+ */
+int RmFreeSpaceMap::search_range(int lo, int hi) {
+    hi = std::min(hi, (int)levels_.size());
+    int page_no = lo;
+    while (page_no < hi) {
+        int block_no = page_no / FSM_BLOCK_SIZE;
+        int block_begin = block_no * FSM_BLOCK_SIZE;
+        int block_end = std::min(block_begin + FSM_BLOCK_SIZE, (int)levels_.size());
+        if (block_max_[block_no] != FSM_FULL) {
+            int end = std::min(block_end, hi);
+            for (; page_no < end; page_no++) {
+                if (levels_[page_no] != FSM_FULL) {
+                    return page_no;
+                }
+            }
+            // 整块扫描都没有找到时，说明该块已满，收紧上界
+            if (lo <= block_begin && end == block_end) {
+                block_max_[block_no] = FSM_FULL;
+            }
+        }
+        page_no = block_end;
+    }
+    return RM_NO_PAGE;
+}
+
+int RmFreeSpaceMap::search(int start_page_no, int num_pages) {
+    std::lock_guard<std::mutex> lock(latch_);
+    if (start_page_no < RM_FIRST_RECORD_PAGE || start_page_no >= num_pages) {
+        start_page_no = RM_FIRST_RECORD_PAGE;
+    }
+    int page_no = search_range(start_page_no, num_pages);
+    if (page_no == RM_NO_PAGE) {
+        page_no = search_range(RM_FIRST_RECORD_PAGE, start_page_no);
+    }
+    return page_no;
+}
+
+void RmFreeSpaceMap::truncate(int num_pages) {
+    std::lock_guard<std::mutex> lock(latch_);
+    if ((int)levels_.size() > num_pages) {
+        levels_.resize(num_pages);
+        block_max_.resize((num_pages + FSM_BLOCK_SIZE - 1) / FSM_BLOCK_SIZE);
+    }
+}
+
+/**
+ * @description: 从FSM文件中加载空闲空间映射
+ * 文件格式：第0页开头为页面数量n(int)，紧随其后是n个字节的空闲等级
+ */
+void RmFreeSpaceMap::load(DiskManager *disk_manager, const std::string &fsm_name) {
+    std::lock_guard<std::mutex> lock(latch_);
+    levels_.clear();
+    block_max_.clear();
+    std::vector<char> buf = rm_read_side_file(disk_manager, fsm_name);
+    int file_size = buf.size();
+    if (file_size < (int)sizeof(int)) {
+        return;
+    }
+
+    int num_pages;
+    memcpy(&num_pages, buf.data(), sizeof(int));
+    num_pages = std::clamp(num_pages, 0, file_size - (int)sizeof(int));
+    ensure_capacity(num_pages);
+    memcpy(levels_.data(), buf.data() + sizeof(int), num_pages);
+    for (int page_no = 0; page_no < num_pages; page_no++) {
+        uint8_t &block = block_max_[page_no / FSM_BLOCK_SIZE];
+        block = std::max(block, levels_[page_no]);
+    }
+}
+
+void RmFreeSpaceMap::store(DiskManager *disk_manager, const std::string &fsm_name) {
+    std::lock_guard<std::mutex> lock(latch_);
+    int num_pages = levels_.size();
+    std::vector<char> buf(sizeof(int) + num_pages);
+    memcpy(buf.data(), &num_pages, sizeof(int));
+    memcpy(buf.data() + sizeof(int), levels_.data(), num_pages);
+
+    rm_write_side_file(disk_manager, fsm_name, buf);
+}
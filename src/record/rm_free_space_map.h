@@ -0,0 +1,82 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "storage/disk_manager.h"
+
+/**
+ * @description: 表数据文件的空闲空间映射(Free Space Map)
+ * 每个数据页对应一个字节的空闲等级，0表示页面已满(或未知)，等级越高空闲槽位越多；
+ * 每FSM_BLOCK_SIZE个页面再维护一个最大等级，查找时可以整块跳过已满的区域。
+ * FSM只是近似信息，调用者拿到候选页后必须在页面上再次确认是否真的有空闲槽位。
+ * 映射常驻内存，打开表时从"<表名>.fsm"文件加载，关闭表时写回。
+ */
+class RmFreeSpaceMap {
+   public:
+    static constexpr uint8_t FSM_FULL = 0;
+    static constexpr uint8_t FSM_MAX_LEVEL = UINT8_MAX;
+    static constexpr int FSM_BLOCK_SIZE = PAGE_SIZE;  // 一个汇总块覆盖的数据页数
+
+    explicit RmFreeSpaceMap(int num_records_per_page) : num_records_per_page_(num_records_per_page) {}
+
+    static std::string get_fsm_name(const std::string &filename) { return filename + ".fsm"; }
+
+    /**
+     * @description: 更新指定页面的空闲槽位数
+     * @param {int} page_no 数据页面号
+     * @param {int} num_free_slots 页面当前的空闲槽位数
+     */
+    void update(int page_no, int num_free_slots);
+
+    /**
+     * @description: 从start_page_no开始(到末尾后回绕)查找一个可能有空闲槽位的页面
+     * @return {int} 候选页面号，找不到返回RM_NO_PAGE
+     * @param {int} start_page_no 查找起点
+     * @param {int} num_pages 数据文件当前的页面总数
+     */
+    int search(int start_page_no, int num_pages);
+
+    /**
+     * @description: 判断指定页面是否可能有空闲槽位
+     */
+    bool has_free_space(int page_no);
+
+    /**
+     * @description: 判断指定页面是否一条记录都没有，扫描时可以跳过这样的页面
+     */
+    bool is_empty(int page_no);
+
+    /**
+     * @description: 截断映射，丢弃页面号大于等于num_pages的项
+     */
+    void truncate(int num_pages);
+
+    void load(DiskManager *disk_manager, const std::string &fsm_name);
+
+    void store(DiskManager *disk_manager, const std::string &fsm_name);
+
+   private:
+    uint8_t to_level(int num_free_slots) const;
+
+    void ensure_capacity(int num_pages);
+
+    int search_range(int lo, int hi);
+
+    int num_records_per_page_;
+    std::vector<uint8_t> levels_;     // 每个数据页的空闲等级
+    std::vector<uint8_t> block_max_;  // 每个汇总块中空闲等级的上界
+    std::mutex latch_;
+};
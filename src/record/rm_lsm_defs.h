@@ -0,0 +1,68 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "rm_defs.h"
+
+constexpr int RM_LSM_ROWS_PER_PAGE = 4096;  // 行号映射为Rid时每个虚拟页面的行数，槽位号不超过16位
+constexpr size_t RM_LSM_MEMTABLE_SIZE = 4 << 20;  // 内存表超过这个字节数后冻结，写成0层的有序段
+constexpr int RM_LSM_L0_COMPACTION_TRIGGER = 4;   // 0层的段数达到这个数时合并到1层
+constexpr size_t RM_LSM_L1_SIZE = 16 << 20;  // 1层的目标大小，往下每层是上一层的RM_LSM_LEVEL_RATIO倍
+constexpr int RM_LSM_LEVEL_RATIO = 10;
+constexpr int RM_LSM_MAX_LEVELS = 7;
+constexpr size_t RM_LSM_RUN_SIZE = 4 << 20;  // 合并时输出段的目标大小
+constexpr int RM_LSM_BLOOM_BITS = 10;        // 段的布隆过滤器中每个行号的位数
+
+/**
+ * @description: LSM表中的记录按64位行号组织，行号递增分配、不重用。
+ * 对执行器和索引，行号映射为Rid：页面号 = RM_FIRST_RECORD_PAGE + 行号 / RM_LSM_ROWS_PER_PAGE，
+ * 槽位号 = 行号 % RM_LSM_ROWS_PER_PAGE，Rid的(页面号, 槽位号)顺序与行号顺序一致
+ */
+inline Rid rm_lsm_row_to_rid(uint64_t row) {
+    return Rid{static_cast<int>(RM_FIRST_RECORD_PAGE + row / RM_LSM_ROWS_PER_PAGE),
+               static_cast<int>(row % RM_LSM_ROWS_PER_PAGE)};
+}
+
+inline uint64_t rm_lsm_rid_to_row(const Rid &rid) {
+    return static_cast<uint64_t>(rid.page_no - RM_FIRST_RECORD_PAGE) * RM_LSM_ROWS_PER_PAGE +
+           rid.slot_no;
+}
+
+// 虚拟页面page_no上的第一个行号
+inline uint64_t rm_lsm_page_first_row(int page_no) {
+    return static_cast<uint64_t>(page_no - RM_FIRST_RECORD_PAGE) * RM_LSM_ROWS_PER_PAGE;
+}
+
+/**
+ * @description: 按行号升序遍历LSM表的一个组成部分(内存表、段、一层中的段)，每个行号只出现一次，
+ * 删除的行以删除标记(tombstone)出现，由合并各部分的调用者决定是否跳过
+ */
+class RmLsmIterator {
+   public:
+    virtual ~RmLsmIterator() = default;
+
+    // 定位到第一个行号不小于row的项
+    virtual void seek(uint64_t row) = 0;
+
+    virtual bool valid() const = 0;
+
+    virtual void next() = 0;
+
+    virtual uint64_t row() const = 0;
+
+    virtual bool deleted() const = 0;
+
+    // 记录的内容，删除标记没有内容；指针在next()或seek()之前有效
+    virtual const char *value() const = 0;
+};
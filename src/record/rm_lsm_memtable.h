@@ -0,0 +1,222 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "rm_lsm_defs.h"
+
+/**
+ * @description: LSM表的内存表，按(行号升序, 序号降序)排列的跳表
+ * 同一个行号的每次修改都插入一个新结点，序号越大越新，查找时先遇到最新的版本；结点不删除不修改，
+ * 随内存表整体释放。只有一个写者(调用者串行化add)，读者不加锁：结点的内容在用release语义
+ * 链入各层之前写好，读者用acquire语义读指针，只会看到完整的结点。结点和记录从内存池中顺序分配
+ */
+class RmLsmMemTable {
+   private:
+    static constexpr int MAX_HEIGHT = 12;
+    static constexpr int BRANCHING = 4;              // 每升高一层的概率为1/BRANCHING
+    static constexpr size_t ARENA_BLOCK_SIZE = 64 << 10;
+
+    struct Node {
+        uint64_t row;
+        uint64_t seq;
+        bool deleted;
+        char *value;
+        std::atomic<Node *> next_[1];  // 实际长度为结点的高度
+
+        Node *next(int level) const { return next_[level].load(std::memory_order_acquire); }
+
+        void set_next(int level, Node *node) { next_[level].store(node, std::memory_order_release); }
+    };
+
+    int record_size_;
+    Node *head_;
+    std::atomic<int> max_height_{1};
+    uint32_t rand_state_ = 0xdeadbeef;
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char *alloc_ptr_ = nullptr;
+    size_t alloc_remaining_ = 0;
+    std::atomic<size_t> memory_usage_{0};
+    std::atomic<size_t> num_entries_{0};
+
+   public:
+    explicit RmLsmMemTable(int record_size) : record_size_(record_size) {
+        head_ = new_node(0, UINT64_MAX, MAX_HEIGHT);
+        for (int i = 0; i < MAX_HEIGHT; i++) {
+            head_->set_next(i, nullptr);
+        }
+    }
+
+    RmLsmMemTable(const RmLsmMemTable &) = delete;
+    RmLsmMemTable &operator=(const RmLsmMemTable &) = delete;
+
+    int record_size() const { return record_size_; }
+
+    size_t memory_usage() const { return memory_usage_; }
+
+    size_t num_entries() const { return num_entries_; }
+
+    bool empty() const { return num_entries_ == 0; }
+
+    /**
+     * @description: 插入行号row的一个新版本，调用者保证同一时刻只有一个线程调用add，且seq递增
+     * @param value 记录内容，删除标记时为nullptr
+     */
+    void add(uint64_t seq, uint64_t row, bool deleted, const char *value) {
+        Node *prev[MAX_HEIGHT];
+        find_greater_or_equal(row, seq, prev);
+        int height = random_height();
+        if (height > max_height_.load(std::memory_order_relaxed)) {
+            for (int i = max_height_.load(std::memory_order_relaxed); i < height; i++) {
+                prev[i] = head_;
+            }
+            // 读者看到新高度而还没看到新结点时，从head_在高层直接走到nullptr，不影响正确性
+            max_height_.store(height, std::memory_order_relaxed);
+        }
+        Node *node = new_node(row, seq, height);
+        node->deleted = deleted;
+        node->value = nullptr;
+        if (!deleted) {
+            node->value = allocate(record_size_);
+            memcpy(node->value, value, record_size_);
+        }
+        for (int i = 0; i < height; i++) {
+            node->next_[i].store(prev[i]->next(i), std::memory_order_relaxed);
+            prev[i]->set_next(i, node);
+        }
+        num_entries_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @description: 查找行号row的最新版本
+     * @return {bool} 内存表中是否有这个行号；有时deleted表示最新版本是否为删除标记，value指向记录内容
+     */
+    bool get(uint64_t row, bool *deleted, const char **value) const {
+        Node *node = find_greater_or_equal(row, UINT64_MAX, nullptr);
+        if (node == nullptr || node->row != row) {
+            return false;
+        }
+        *deleted = node->deleted;
+        *value = node->value;
+        return true;
+    }
+
+    /**
+     * @description: 按行号升序遍历每个行号的最新版本；遍历的同时可以有写者插入，新插入的行可能看不到
+     */
+    class Iterator : public RmLsmIterator {
+        const RmLsmMemTable *table_;
+        Node *node_ = nullptr;
+
+       public:
+        explicit Iterator(const RmLsmMemTable *table) : table_(table) {}
+
+        void seek(uint64_t row) override { node_ = table_->find_greater_or_equal(row, UINT64_MAX, nullptr); }
+
+        bool valid() const override { return node_ != nullptr; }
+
+        // 跳过同一行号的旧版本
+        void next() override {
+            uint64_t row = node_->row;
+            do {
+                node_ = node_->next(0);
+            } while (node_ != nullptr && node_->row == row);
+        }
+
+        uint64_t row() const override { return node_->row; }
+
+        bool deleted() const override { return node_->deleted; }
+
+        const char *value() const override { return node_->value; }
+    };
+
+    std::unique_ptr<RmLsmIterator> iterator() const { return std::make_unique<Iterator>(this); }
+
+   private:
+    // 结点a是否排在键(row, seq)之前
+    static bool before(const Node *a, uint64_t row, uint64_t seq) {
+        return a->row < row || (a->row == row && a->seq > seq);
+    }
+
+    /**
+     * @description: 找到第一个不排在(row, seq)之前的结点，prev不为空时记下每一层上它的前驱
+     */
+    Node *find_greater_or_equal(uint64_t row, uint64_t seq, Node **prev) const {
+        Node *x = head_;
+        int level = max_height_.load(std::memory_order_relaxed) - 1;
+        while (true) {
+            Node *next = x->next(level);
+            if (next != nullptr && before(next, row, seq)) {
+                x = next;
+                continue;
+            }
+            if (prev != nullptr) {
+                prev[level] = x;
+            }
+            if (level == 0) {
+                return next;
+            }
+            level--;
+        }
+    }
+
+    int random_height() {
+        int height = 1;
+        while (height < MAX_HEIGHT) {
+            // xorshift32
+            rand_state_ ^= rand_state_ << 13;
+            rand_state_ ^= rand_state_ >> 17;
+            rand_state_ ^= rand_state_ << 5;
+            if (rand_state_ % BRANCHING != 0) {
+                break;
+            }
+            height++;
+        }
+        return height;
+    }
+
+    Node *new_node(uint64_t row, uint64_t seq, int height) {
+        char *mem = allocate(sizeof(Node) + sizeof(std::atomic<Node *>) * (height - 1));
+        Node *node = reinterpret_cast<Node *>(mem);
+        node->row = row;
+        node->seq = seq;
+        node->deleted = false;
+        node->value = nullptr;
+        for (int i = 0; i < height; i++) {
+            new (&node->next_[i]) std::atomic<Node *>(nullptr);
+        }
+        return node;
+    }
+
+    // 从内存池中按8字节对齐分配，超过块大小四分之一的请求单独占一块
+    char *allocate(size_t bytes) {
+        bytes = (bytes + 7) & ~static_cast<size_t>(7);
+        memory_usage_.fetch_add(bytes, std::memory_order_relaxed);
+        if (bytes > ARENA_BLOCK_SIZE / 4) {
+            blocks_.push_back(std::make_unique<char[]>(bytes));
+            return blocks_.back().get();
+        }
+        if (bytes > alloc_remaining_) {
+            blocks_.push_back(std::make_unique<char[]>(ARENA_BLOCK_SIZE));
+            alloc_ptr_ = blocks_.back().get();
+            alloc_remaining_ = ARENA_BLOCK_SIZE;
+        }
+        char *result = alloc_ptr_;
+        alloc_ptr_ += bytes;
+        alloc_remaining_ -= bytes;
+        return result;
+    }
+};
@@ -0,0 +1,224 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "rm_lsm_run.h"
+
+#include <algorithm>
+#include <cstring>
+
+RmLsmRunBuilder::RmLsmRunBuilder(DiskManager *disk_manager, std::string path, int record_size)
+    : disk_manager_(disk_manager), path_(std::move(path)), page_(PAGE_SIZE) {
+    // 上次写到一半的同名文件没有记入清单，直接覆盖
+    if (disk_manager_->is_file(path_)) {
+        disk_manager_->destroy_file(path_);
+    }
+    disk_manager_->create_file(path_);
+    fd_ = disk_manager_->open_file(path_);
+    hdr_.record_size = record_size;
+    hdr_.entries_per_page = RmLsmRunPage::entries_per_page(record_size);
+    hdr_.min_row = UINT64_MAX;
+    hdr_.max_row = 0;
+}
+
+void RmLsmRunBuilder::add(uint64_t row, bool deleted, const char *value) {
+    RmLsmRunPage page(&hdr_, page_.data());
+    if (page.count() == hdr_.entries_per_page) {
+        flush_page();
+    }
+    int64_t &count = page.count();
+    if (count == 0) {
+        first_rows_.push_back(row);
+    }
+    page.rows()[count] = row;
+    page.deleted()[count] = deleted;
+    if (!deleted) {
+        memcpy(page.record(count), value, hdr_.record_size);
+    }
+    count++;
+    hdr_.num_entries++;
+    hdr_.min_row = std::min(hdr_.min_row, row);
+    hdr_.max_row = std::max(hdr_.max_row, row);
+    hashes_.push_back(IxBloomFilter::hash(reinterpret_cast<const char *>(&row), sizeof(row)));
+}
+
+void RmLsmRunBuilder::flush_page() {
+    RmLsmRunPage page(&hdr_, page_.data());
+    if (page.count() == 0) {
+        return;
+    }
+    hdr_.num_data_pages++;
+    disk_manager_->write_page(fd_, hdr_.num_data_pages, page_.data(), PAGE_SIZE);
+    std::fill(page_.begin(), page_.end(), 0);
+}
+
+RmLsmRunHdr RmLsmRunBuilder::finish() {
+    flush_page();
+    // 布隆过滤器只为段中实际的行号分配空间，段写好后不再插入
+    size_t bits = std::max<size_t>(hashes_.size(), 1) * RM_LSM_BLOOM_BITS;
+    IxBloomFilter bloom(static_cast<int>((bits + IX_BLOOM_BLOCK_SIZE * 8 - 1) / (IX_BLOOM_BLOCK_SIZE * 8)));
+    for (uint64_t hash : hashes_) {
+        bloom.insert(hash);
+    }
+    hdr_.bloom_blocks = bloom.num_blocks();
+
+    auto write_pages = [&](const char *data, size_t size, int first_page) {
+        int page_no = first_page;
+        for (size_t offset = 0; offset < size; offset += PAGE_SIZE, page_no++) {
+            disk_manager_->write_page(fd_, page_no, data + offset,
+                                      static_cast<int>(std::min<size_t>(PAGE_SIZE, size - offset)));
+        }
+        return page_no;
+    };
+    hdr_.index_page = hdr_.num_data_pages + 1;
+    hdr_.bloom_page = write_pages(reinterpret_cast<const char *>(first_rows_.data()),
+                                  first_rows_.size() * sizeof(uint64_t), hdr_.index_page);
+    hdr_.bloom_page = std::max(hdr_.bloom_page, hdr_.index_page);
+    hdr_.num_pages = write_pages(bloom.data(), bloom.size_bytes(), hdr_.bloom_page);
+    disk_manager_->write_page(fd_, 0, reinterpret_cast<const char *>(&hdr_), sizeof(hdr_));
+    disk_manager_->close_file(fd_);
+    return hdr_;
+}
+
+RmLsmRun::RmLsmRun(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager,
+                   std::string path, uint64_t file_no)
+    : disk_manager_(disk_manager),
+      buffer_pool_manager_(buffer_pool_manager),
+      path_(std::move(path)),
+      file_no_(file_no) {
+    fd_ = disk_manager_->open_file(path_);
+    disk_manager_->read_page(fd_, 0, reinterpret_cast<char *>(&hdr_), sizeof(hdr_));
+    disk_manager_->set_fd2pageno(fd_, hdr_.num_pages);
+
+    auto read_pages = [&](char *data, size_t size, int first_page) {
+        int page_no = first_page;
+        for (size_t offset = 0; offset < size; offset += PAGE_SIZE, page_no++) {
+            disk_manager_->read_page(fd_, page_no, data + offset,
+                                     static_cast<int>(std::min<size_t>(PAGE_SIZE, size - offset)));
+        }
+    };
+    first_rows_.resize(hdr_.num_data_pages);
+    read_pages(reinterpret_cast<char *>(first_rows_.data()), first_rows_.size() * sizeof(uint64_t),
+               hdr_.index_page);
+    bloom_ = std::make_unique<IxBloomFilter>(hdr_.bloom_blocks);
+    read_pages(bloom_->data(), bloom_->size_bytes(), hdr_.bloom_page);
+}
+
+/**
+ * @description: 段不再被引用时丢弃它在缓冲池中的页面再关闭文件，文件描述符被重用后不会读到旧页面
+ */
+RmLsmRun::~RmLsmRun() {
+    for (int page_no = 1; page_no <= hdr_.num_data_pages; page_no++) {
+        buffer_pool_manager_->delete_page(PageId{fd_, page_no});
+    }
+    disk_manager_->close_file(fd_);
+    if (obsolete_) {
+        disk_manager_->destroy_file(path_);
+    }
+}
+
+bool RmLsmRun::may_contain(uint64_t row) const {
+    return hdr_.num_entries > 0 && hdr_.min_row <= row && row <= hdr_.max_row &&
+           bloom_->may_contain(IxBloomFilter::hash(reinterpret_cast<const char *>(&row), sizeof(row)));
+}
+
+Page *RmLsmRun::fetch_data_page(int idx) const {
+    Page *page = buffer_pool_manager_->fetch_page(PageId{fd_, idx + 1});
+    if (page == nullptr) {
+        throw PageNotExistError("Failed to fetch page", idx + 1);
+    }
+    return page;
+}
+
+void RmLsmRun::unpin_data_page(int idx) const { buffer_pool_manager_->unpin_page(PageId{fd_, idx + 1}, false); }
+
+bool RmLsmRun::get(uint64_t row, bool *deleted, char *value) const {
+    if (!may_contain(row)) {
+        return false;
+    }
+    int idx = std::upper_bound(first_rows_.begin(), first_rows_.end(), row) - first_rows_.begin() - 1;
+    if (idx < 0) {
+        return false;
+    }
+    // 段的页面不再修改，读取时不需要加页面锁
+    Page *page = fetch_data_page(idx);
+    RmLsmRunPage run_page(&hdr_, page->get_data());
+    const uint64_t *rows = run_page.rows();
+    const uint64_t *pos = std::lower_bound(rows, rows + run_page.count(), row);
+    bool found = pos != rows + run_page.count() && *pos == row;
+    if (found) {
+        int slot = pos - rows;
+        *deleted = run_page.deleted()[slot];
+        if (!*deleted) {
+            memcpy(value, run_page.record(slot), hdr_.record_size);
+        }
+    }
+    unpin_data_page(idx);
+    return found;
+}
+
+/**
+ * @description: 逐页遍历有序段，当前数据页拷贝到迭代器自己的缓冲区中，不长时间固定缓冲池的页面
+ */
+class RmLsmRunIterator : public RmLsmIterator {
+    const RmLsmRun *run_;
+    std::vector<char> page_;
+    int page_idx_ = -1;
+    int slot_ = 0;
+    int count_ = 0;
+
+   public:
+    explicit RmLsmRunIterator(const RmLsmRun *run) : run_(run), page_(PAGE_SIZE) {}
+
+    void seek(uint64_t row) override {
+        auto &first_rows = run_->first_rows_;
+        int idx = std::upper_bound(first_rows.begin(), first_rows.end(), row) - first_rows.begin() - 1;
+        load_page(std::max(idx, 0));
+        RmLsmRunPage page(&run_->hdr_, page_.data());
+        slot_ = std::lower_bound(page.rows(), page.rows() + count_, row) - page.rows();
+        skip_page_end();
+    }
+
+    bool valid() const override { return page_idx_ < run_->hdr_.num_data_pages; }
+
+    void next() override {
+        slot_++;
+        skip_page_end();
+    }
+
+    uint64_t row() const override { return page().rows()[slot_]; }
+
+    bool deleted() const override { return page().deleted()[slot_]; }
+
+    const char *value() const override { return page().record(slot_); }
+
+   private:
+    RmLsmRunPage page() const { return RmLsmRunPage(&run_->hdr_, const_cast<char *>(page_.data())); }
+
+    void load_page(int idx) {
+        page_idx_ = idx;
+        slot_ = 0;
+        count_ = 0;
+        if (idx >= run_->hdr_.num_data_pages) {
+            return;
+        }
+        Page *buf_page = run_->fetch_data_page(idx);
+        memcpy(page_.data(), buf_page->get_data(), PAGE_SIZE);
+        run_->unpin_data_page(idx);
+        count_ = static_cast<int>(page().count());
+    }
+
+    void skip_page_end() {
+        while (valid() && slot_ >= count_) {
+            load_page(page_idx_ + 1);
+        }
+    }
+};
+
+std::unique_ptr<RmLsmIterator> RmLsmRun::iterator() const { return std::make_unique<RmLsmRunIterator>(this); }
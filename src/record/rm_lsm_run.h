@@ -0,0 +1,150 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "index/ix_bloom_filter.h"
+#include "rm_lsm_defs.h"
+#include "storage/buffer_pool_manager.h"
+
+/* 有序段文件的文件头，存放在第0页 */
+struct RmLsmRunHdr {
+    int record_size;
+    int entries_per_page;  // 每个数据页最多存放的项数
+    int num_data_pages;    // 数据页为[1, num_data_pages]
+    int index_page;        // 稀疏索引的第一个页面
+    int bloom_page;        // 布隆过滤器的第一个页面
+    int bloom_blocks;
+    int num_pages;
+    int64_t num_entries;
+    uint64_t min_row;
+    uint64_t max_row;
+};
+
+/**
+ * @description: 有序段的数据页，项按行号升序存放，行号、删除标记和记录各自连续：
+ * | 项数(8字节) | 行号[entries_per_page] | 删除标记[entries_per_page] | 记录[entries_per_page] |
+ */
+struct RmLsmRunPage {
+    const RmLsmRunHdr *hdr;
+    char *data;
+
+    RmLsmRunPage(const RmLsmRunHdr *hdr_, char *data_) : hdr(hdr_), data(data_) {}
+
+    static int entries_per_page(int record_size) {
+        return (PAGE_SIZE - (int)sizeof(int64_t)) / ((int)sizeof(uint64_t) + 1 + record_size);
+    }
+
+    int64_t &count() const { return *reinterpret_cast<int64_t *>(data); }
+
+    uint64_t *rows() const { return reinterpret_cast<uint64_t *>(data + sizeof(int64_t)); }
+
+    char *deleted() const { return reinterpret_cast<char *>(rows() + hdr->entries_per_page); }
+
+    char *record(int i) const {
+        return deleted() + hdr->entries_per_page + (size_t)i * hdr->record_size;
+    }
+};
+
+/**
+ * @description: 按行号升序写出一个有序段：数据页顺序写盘，最后写稀疏索引(每个数据页的第一个行号)、
+ * 布隆过滤器和文件头。写出时不经过缓冲池
+ */
+class RmLsmRunBuilder {
+    DiskManager *disk_manager_;
+    std::string path_;
+    int fd_;
+    RmLsmRunHdr hdr_{};
+    std::vector<char> page_;
+    std::vector<uint64_t> first_rows_;
+    std::vector<uint64_t> hashes_;
+
+   public:
+    RmLsmRunBuilder(DiskManager *disk_manager, std::string path, int record_size);
+
+    // 追加一项，行号必须严格递增；value为删除标记时为nullptr
+    void add(uint64_t row, bool deleted, const char *value);
+
+    int64_t num_entries() const { return hdr_.num_entries; }
+
+    // 已经写出的字节数
+    size_t size_bytes() const { return (size_t)(hdr_.num_data_pages + 1) * PAGE_SIZE; }
+
+    // 写出剩余的内容并关闭文件，返回文件头
+    RmLsmRunHdr finish();
+
+   private:
+    void flush_page();
+};
+
+/**
+ * @description: 打开的有序段，内容不再改变。稀疏索引和布隆过滤器常驻内存，数据页通过缓冲池读取：
+ * 点查找先用行号区间和布隆过滤器排除，再二分稀疏索引定位唯一可能的数据页，在页内二分查找。
+ * 段被合并后标记为废弃，最后一个引用它的版本释放时从缓冲池中丢弃它的页面并删除文件
+ */
+class RmLsmRun {
+    DiskManager *disk_manager_;
+    BufferPoolManager *buffer_pool_manager_;
+    std::string path_;
+    uint64_t file_no_;
+    int fd_;
+    RmLsmRunHdr hdr_{};
+    std::vector<uint64_t> first_rows_;  // 稀疏索引：每个数据页的第一个行号
+    std::unique_ptr<IxBloomFilter> bloom_;
+    std::atomic<bool> obsolete_{false};
+
+   public:
+    RmLsmRun(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, std::string path,
+             uint64_t file_no);
+
+    ~RmLsmRun();
+
+    RmLsmRun(const RmLsmRun &) = delete;
+    RmLsmRun &operator=(const RmLsmRun &) = delete;
+
+    uint64_t file_no() const { return file_no_; }
+
+    uint64_t min_row() const { return hdr_.min_row; }
+
+    uint64_t max_row() const { return hdr_.max_row; }
+
+    int64_t num_entries() const { return hdr_.num_entries; }
+
+    size_t size_bytes() const { return (size_t)hdr_.num_pages * PAGE_SIZE; }
+
+    int num_data_pages() const { return hdr_.num_data_pages; }
+
+    bool overlaps(uint64_t lo, uint64_t hi) const { return hdr_.min_row <= hi && lo <= hdr_.max_row; }
+
+    // 布隆过滤器判定行号是否可能在段中
+    bool may_contain(uint64_t row) const;
+
+    /**
+     * @description: 查找行号row
+     * @return {bool} 段中是否有这个行号；有且不是删除标记时把记录拷贝到value
+     */
+    bool get(uint64_t row, bool *deleted, char *value) const;
+
+    std::unique_ptr<RmLsmIterator> iterator() const;
+
+    void mark_obsolete() { obsolete_ = true; }
+
+   private:
+    friend class RmLsmRunIterator;
+
+    Page *fetch_data_page(int idx) const;
+
+    void unpin_data_page(int idx) const;
+};
@@ -0,0 +1,770 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "rm_lsm_table.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "rm_side_file.h"
+
+constexpr char RM_LSM_WAL_PUT = 0;
+constexpr char RM_LSM_WAL_DELETE = 1;
+
+namespace {
+
+/**
+ * @description: 归并多个迭代器，children按由新到旧排列；同一个行号取最新的那个，其余的跳过
+ */
+class RmLsmMergingIterator : public RmLsmIterator {
+    std::vector<std::unique_ptr<RmLsmIterator>> children_;
+    int current_ = -1;
+
+   public:
+    explicit RmLsmMergingIterator(std::vector<std::unique_ptr<RmLsmIterator>> children)
+        : children_(std::move(children)) {}
+
+    void seek(uint64_t row) override {
+        for (auto &child : children_) {
+            child->seek(row);
+        }
+        find_smallest();
+    }
+
+    bool valid() const override { return current_ >= 0; }
+
+    void next() override {
+        uint64_t row = children_[current_]->row();
+        for (auto &child : children_) {
+            if (child->valid() && child->row() == row) {
+                child->next();
+            }
+        }
+        find_smallest();
+    }
+
+    uint64_t row() const override { return children_[current_]->row(); }
+
+    bool deleted() const override { return children_[current_]->deleted(); }
+
+    const char *value() const override { return children_[current_]->value(); }
+
+   private:
+    // 行号相同时取下标小的(较新的)
+    void find_smallest() {
+        current_ = -1;
+        for (int i = 0; i < (int)children_.size(); i++) {
+            if (children_[i]->valid() &&
+                (current_ < 0 || children_[i]->row() < children_[current_]->row())) {
+                current_ = i;
+            }
+        }
+    }
+};
+
+/**
+ * @description: 依次遍历一层中按行号有序且互不重叠的段
+ */
+class RmLsmLevelIterator : public RmLsmIterator {
+    std::vector<std::shared_ptr<RmLsmRun>> runs_;
+    size_t idx_ = 0;
+    std::unique_ptr<RmLsmIterator> iter_;
+
+   public:
+    explicit RmLsmLevelIterator(std::vector<std::shared_ptr<RmLsmRun>> runs) : runs_(std::move(runs)) {}
+
+    void seek(uint64_t row) override {
+        idx_ = std::lower_bound(runs_.begin(), runs_.end(), row,
+                                [](const std::shared_ptr<RmLsmRun> &run, uint64_t r) {
+                                    return run->max_row() < r;
+                                }) -
+               runs_.begin();
+        iter_ = nullptr;
+        if (idx_ < runs_.size()) {
+            iter_ = runs_[idx_]->iterator();
+            iter_->seek(row);
+        }
+        skip_empty();
+    }
+
+    bool valid() const override { return iter_ != nullptr; }
+
+    void next() override {
+        iter_->next();
+        skip_empty();
+    }
+
+    uint64_t row() const override { return iter_->row(); }
+
+    bool deleted() const override { return iter_->deleted(); }
+
+    const char *value() const override { return iter_->value(); }
+
+   private:
+    void skip_empty() {
+        while (iter_ != nullptr && !iter_->valid()) {
+            iter_ = nullptr;
+            if (++idx_ < runs_.size()) {
+                iter_ = runs_[idx_]->iterator();
+                iter_->seek(0);
+            }
+        }
+    }
+};
+
+// 遍历整个版本：内存表、冻结的内存表、0层的每个段、其余每层
+std::unique_ptr<RmLsmIterator> make_version_iterator(const RmLsmVersion &version) {
+    std::vector<std::unique_ptr<RmLsmIterator>> children;
+    children.push_back(version.mem->iterator());
+    if (version.imm != nullptr) {
+        children.push_back(version.imm->iterator());
+    }
+    for (auto &run : version.levels[0]) {
+        children.push_back(run->iterator());
+    }
+    for (size_t level = 1; level < version.levels.size(); level++) {
+        if (!version.levels[level].empty()) {
+            children.push_back(std::make_unique<RmLsmLevelIterator>(version.levels[level]));
+        }
+    }
+    return std::make_unique<RmLsmMergingIterator>(std::move(children));
+}
+
+// 第level层(level >= 1)的大小上限
+size_t level_limit(int level) {
+    size_t limit = RM_LSM_L1_SIZE;
+    for (int i = 1; i < level; i++) {
+        limit *= RM_LSM_LEVEL_RATIO;
+    }
+    return limit;
+}
+
+/**
+ * @description: 按行号顺序扫描LSM表，跳过删除标记；持有扫描开始时的版本，扫描期间合并不影响结果
+ */
+class RmLsmScan : public RecScan {
+    std::shared_ptr<const RmLsmVersion> version_;
+    std::unique_ptr<RmLsmIterator> iter_;
+    uint64_t end_row_;
+
+   public:
+    RmLsmScan(std::shared_ptr<const RmLsmVersion> version, uint64_t begin_row, uint64_t end_row)
+        : version_(std::move(version)), end_row_(end_row) {
+        iter_ = make_version_iterator(*version_);
+        iter_->seek(begin_row);
+        skip_deleted();
+    }
+
+    void next() override {
+        iter_->next();
+        skip_deleted();
+    }
+
+    bool is_end() const override { return !iter_->valid() || iter_->row() >= end_row_; }
+
+    Rid rid() const override { return rm_lsm_row_to_rid(iter_->row()); }
+
+    const char *record() const override { return iter_->value(); }
+
+   private:
+    void skip_deleted() {
+        while (iter_->valid() && iter_->deleted() && iter_->row() < end_row_) {
+            iter_->next();
+        }
+    }
+};
+
+}  // namespace
+
+size_t RmLsmVersion::level_bytes(int level) const {
+    size_t bytes = 0;
+    for (auto &run : levels[level]) {
+        bytes += run->size_bytes();
+    }
+    return bytes;
+}
+
+/**
+ * @description: 创建空的LSM表，只写出清单
+ */
+void RmLsmTableHandle::create(DiskManager *disk_manager, const std::string &name, int record_size) {
+    if (record_size < 1 || record_size > RM_MAX_RECORD_SIZE) {
+        throw InvalidRecordSizeError(record_size);
+    }
+    disk_manager->create_file(name);
+    RmLsmManifestHdr hdr{};
+    hdr.record_size = record_size;
+    hdr.next_file_no = 1;
+    hdr.wal_no = 1;
+    std::vector<char> buf(sizeof(hdr));
+    memcpy(buf.data(), &hdr, sizeof(hdr));
+    rm_write_side_file(disk_manager, name, buf);
+}
+
+/**
+ * @description: 删除LSM表的清单、段文件和预写日志
+ */
+void RmLsmTableHandle::destroy(DiskManager *disk_manager, const std::string &name) {
+    std::vector<char> buf = rm_read_side_file(disk_manager, name);
+    if (buf.size() >= sizeof(RmLsmManifestHdr)) {
+        RmLsmManifestHdr hdr;
+        memcpy(&hdr, buf.data(), sizeof(hdr));
+        auto remove = [&](const std::string &path) {
+            if (disk_manager->is_file(path)) {
+                disk_manager->destroy_file(path);
+            }
+        };
+        // 段文件编号小于next_file_no，写到一半的段也在其中
+        for (uint64_t no = 1; no <= hdr.next_file_no; no++) {
+            remove(name + ".run" + std::to_string(no));
+        }
+        for (uint64_t no = hdr.wal_no; disk_manager->is_file(name + ".wal" + std::to_string(no)); no++) {
+            remove(name + ".wal" + std::to_string(no));
+        }
+        remove(manifest_tmp_name(name));
+    }
+    disk_manager->destroy_file(name);
+}
+
+/**
+ * @description: 打开LSM表：读清单打开各层的段，重放预写日志中还没写成段的修改并立即写成0层的段，
+ * 然后开始新的预写日志，启动后台线程
+ */
+RmLsmTableHandle::RmLsmTableHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager,
+                                   std::string name)
+    : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), name_(std::move(name)) {
+    std::vector<char> buf = rm_read_side_file(disk_manager_, name_);
+    if (buf.size() < sizeof(RmLsmManifestHdr)) {
+        throw InternalError("Invalid LSM manifest: " + name_);
+    }
+    RmLsmManifestHdr hdr;
+    memcpy(&hdr, buf.data(), sizeof(hdr));
+    record_size_ = hdr.record_size;
+    next_file_no_ = hdr.next_file_no;
+    next_row_ = hdr.next_row;
+    min_wal_no_ = hdr.wal_no;
+    wal_entry_.resize(1 + sizeof(uint64_t) + record_size_);
+    compact_cursor_.assign(RM_LSM_MAX_LEVELS, 0);
+
+    auto version = std::make_shared<RmLsmVersion>();
+    version->mem = std::make_shared<RmLsmMemTable>(record_size_);
+    version->levels.resize(RM_LSM_MAX_LEVELS);
+    for (int i = 0; i < hdr.num_runs; i++) {
+        RmLsmManifestRun run;
+        memcpy(&run, buf.data() + sizeof(hdr) + i * sizeof(run), sizeof(run));
+        version->levels[run.level].push_back(
+            std::make_shared<RmLsmRun>(disk_manager_, buffer_pool_manager_, run_name(run.file_no), run.file_no));
+        if (version->levels[run.level].back()->num_entries() > 0) {
+            next_row_ = std::max<uint64_t>(next_row_, version->levels[run.level].back()->max_row() + 1);
+        }
+    }
+    for (size_t level = 1; level < version->levels.size(); level++) {
+        std::sort(version->levels[level].begin(), version->levels[level].end(),
+                  [](const std::shared_ptr<RmLsmRun> &a, const std::shared_ptr<RmLsmRun> &b) {
+                      return a->min_row() < b->min_row();
+                  });
+    }
+    mem_ = version->mem.get();
+    version_ = std::move(version);
+
+    std::lock_guard<std::mutex> bg_guard(bg_latch_);
+    replay_wal();
+    if (!mem_->empty()) {
+        // 重放的修改立即写成段，旧的预写日志随后删除
+        std::unique_lock<std::mutex> lock(write_latch_);
+        freeze(lock);
+        lock.unlock();
+        flush_imm();
+    } else {
+        open_wal();
+        write_manifest();
+    }
+    worker_ = std::thread(&RmLsmTableHandle::worker_loop, this);
+}
+
+RmLsmTableHandle::~RmLsmTableHandle() {
+    if (worker_.joinable()) {
+        close();
+    }
+}
+
+/**
+ * @description: 停止后台线程，把内存表写成段并写出清单；之后不再需要预写日志
+ */
+void RmLsmTableHandle::close() {
+    {
+        std::lock_guard<std::mutex> guard(worker_mutex_);
+        stop_worker_ = true;
+    }
+    worker_cv_.notify_one();
+    worker_.join();
+    std::lock_guard<std::mutex> bg_guard(bg_latch_);
+    if (current()->imm != nullptr) {
+        flush_imm();
+    }
+    if (!mem_->empty()) {
+        std::unique_lock<std::mutex> lock(write_latch_);
+        freeze(lock);
+        lock.unlock();
+        flush_imm();
+    }
+    if (wal_fd_ >= 0) {
+        disk_manager_->close_file(wal_fd_);
+        wal_fd_ = -1;
+    }
+}
+
+std::shared_ptr<const RmLsmVersion> RmLsmTableHandle::current() const {
+    std::lock_guard<std::mutex> guard(version_latch_);
+    return version_;
+}
+
+int RmLsmTableHandle::num_pages() const { return rm_lsm_row_to_rid(next_row_).page_no + 1; }
+
+/**
+ * @description: 查找行号row的最新版本，由新到旧查各个组成部分，遇到的第一个版本就是结果
+ * @return {bool} 行是否存在(最新版本不是删除标记)，存在时把记录拷贝到value
+ */
+bool RmLsmTableHandle::lookup(uint64_t row, char *value) const {
+    auto version = current();
+    bool deleted;
+    for (auto *mem : {version->mem.get(), version->imm.get()}) {
+        const char *data;
+        if (mem != nullptr && mem->get(row, &deleted, &data)) {
+            if (!deleted) {
+                memcpy(value, data, record_size_);
+            }
+            return !deleted;
+        }
+    }
+    for (auto &run : version->levels[0]) {
+        if (run->get(row, &deleted, value)) {
+            return !deleted;
+        }
+    }
+    for (size_t level = 1; level < version->levels.size(); level++) {
+        auto &runs = version->levels[level];
+        auto it = std::lower_bound(runs.begin(), runs.end(), row,
+                                   [](const std::shared_ptr<RmLsmRun> &run, uint64_t r) {
+                                       return run->max_row() < r;
+                                   });
+        if (it != runs.end() && (*it)->get(row, &deleted, value)) {
+            return !deleted;
+        }
+    }
+    return false;
+}
+
+std::unique_ptr<RmRecord> RmLsmTableHandle::get_record(const Rid &rid, Context *context) const {
+    auto record = std::make_unique<RmRecord>(record_size_);
+    if (rid.page_no < RM_FIRST_RECORD_PAGE || !lookup(rm_lsm_rid_to_row(rid), record->data)) {
+        throw RecordNotFoundError(rid.page_no, rid.slot_no);
+    }
+    return record;
+}
+
+// 记录整条存放，读取部分字段等价于读取整条记录
+std::unique_ptr<RmRecord> RmLsmTableHandle::get_record(const Rid &rid, const std::vector<int> &fields,
+                                                       Context *context) const {
+    return get_record(rid, context);
+}
+
+Rid RmLsmTableHandle::insert_record(char *buf, Context *context) {
+    std::unique_lock<std::mutex> lock(write_latch_);
+    uint64_t row = next_row_++;
+    write_entry(row, false, buf, lock);
+    return rm_lsm_row_to_rid(row);
+}
+
+void RmLsmTableHandle::delete_record(const Rid &rid, Context *context) {
+    std::unique_lock<std::mutex> lock(write_latch_);
+    std::vector<char> value(record_size_);
+    if (rid.page_no < RM_FIRST_RECORD_PAGE || !lookup(rm_lsm_rid_to_row(rid), value.data())) {
+        throw RecordNotFoundError(rid.page_no, rid.slot_no);
+    }
+    write_entry(rm_lsm_rid_to_row(rid), true, nullptr, lock);
+}
+
+Rid RmLsmTableHandle::update_record(const Rid &rid, char *buf, Context *context) {
+    std::unique_lock<std::mutex> lock(write_latch_);
+    std::vector<char> value(record_size_);
+    if (rid.page_no < RM_FIRST_RECORD_PAGE || !lookup(rm_lsm_rid_to_row(rid), value.data())) {
+        throw RecordNotFoundError(rid.page_no, rid.slot_no);
+    }
+    write_entry(rm_lsm_rid_to_row(rid), false, buf, lock);
+    return rid;
+}
+
+std::unique_ptr<RecScan> RmLsmTableHandle::scan(std::function<bool(int)> page_filter, int begin_page_no,
+                                                int end_page_no) const {
+    uint64_t begin_row = rm_lsm_page_first_row(std::max(begin_page_no, RM_FIRST_RECORD_PAGE));
+    uint64_t end_row = end_page_no == INT32_MAX ? UINT64_MAX : rm_lsm_page_first_row(end_page_no);
+    return std::make_unique<RmLsmScan>(current(), begin_row, end_row);
+}
+
+/**
+ * @description: 写入一个新版本：先追加预写日志再插入内存表，调用者持有write_latch_
+ * 预写日志的每一项等长：| 类型(1字节) | 行号(8字节) | 记录 |，删除标记的记录部分补0
+ */
+void RmLsmTableHandle::write_entry(uint64_t row, bool deleted, const char *value,
+                                   std::unique_lock<std::mutex> &lock) {
+    make_room(lock);
+    wal_entry_[0] = deleted ? RM_LSM_WAL_DELETE : RM_LSM_WAL_PUT;
+    memcpy(wal_entry_.data() + 1, &row, sizeof(row));
+    if (deleted) {
+        memset(wal_entry_.data() + 1 + sizeof(row), 0, record_size_);
+    } else {
+        memcpy(wal_entry_.data() + 1 + sizeof(row), value, record_size_);
+    }
+    disk_manager_->append_file(wal_fd_, wal_entry_.data(), wal_entry_.size());
+    mem_->add(next_seq_++, row, deleted, value);
+}
+
+/**
+ * @description: 内存表写满时冻结它并换上新的内存表
+ */
+void RmLsmTableHandle::make_room(std::unique_lock<std::mutex> &lock) {
+    if (mem_->memory_usage() < RM_LSM_MEMTABLE_SIZE) {
+        return;
+    }
+    freeze(lock);
+    worker_cv_.notify_one();
+}
+
+/**
+ * @description: 冻结当前的内存表，换上新的内存表和新的预写日志，调用者持有write_latch_
+ * 上一个冻结的内存表还没写完时等待，写入速度受限于内存表写盘的速度
+ */
+void RmLsmTableHandle::freeze(std::unique_lock<std::mutex> &lock) {
+    flushed_cv_.wait(lock, [&] { return current()->imm == nullptr; });
+    auto mem = std::make_shared<RmLsmMemTable>(record_size_);
+    {
+        std::lock_guard<std::mutex> guard(version_latch_);
+        auto version = std::make_shared<RmLsmVersion>(*version_);
+        version->imm = version->mem;
+        version->mem = mem;
+        version_ = std::move(version);
+        imm_wal_no_ = wal_no_;
+    }
+    mem_ = mem.get();
+    open_wal();
+}
+
+/**
+ * @description: 关闭当前的预写日志，新建下一个
+ */
+void RmLsmTableHandle::open_wal() {
+    if (wal_fd_ >= 0) {
+        disk_manager_->close_file(wal_fd_);
+        wal_no_++;
+    } else {
+        wal_no_ = std::max(wal_no_ + 1, min_wal_no_);
+    }
+    std::string path = wal_name(wal_no_);
+    if (disk_manager_->is_file(path)) {
+        disk_manager_->destroy_file(path);
+    }
+    disk_manager_->create_file(path);
+    wal_fd_ = disk_manager_->open_file(path);
+}
+
+/**
+ * @description: 从min_wal_no_起按编号依次重放预写日志，末尾不完整的项(写到一半时进程退出)丢弃
+ */
+void RmLsmTableHandle::replay_wal() {
+    size_t entry_size = wal_entry_.size();
+    for (uint64_t no = min_wal_no_; disk_manager_->is_file(wal_name(no)); no++) {
+        std::vector<char> buf = rm_read_side_file(disk_manager_, wal_name(no));
+        for (size_t offset = 0; offset + entry_size <= buf.size(); offset += entry_size) {
+            uint64_t row;
+            memcpy(&row, buf.data() + offset + 1, sizeof(row));
+            bool deleted = buf[offset] == RM_LSM_WAL_DELETE;
+            mem_->add(next_seq_++, row, deleted, deleted ? nullptr : buf.data() + offset + 1 + sizeof(row));
+            next_row_ = std::max<uint64_t>(next_row_, row + 1);
+        }
+        wal_no_ = no;
+    }
+}
+
+/**
+ * @description: 基于最新的版本做修改，生成并发布新版本
+ */
+void RmLsmTableHandle::install(const std::function<void(RmLsmVersion &)> &edit) {
+    std::lock_guard<std::mutex> guard(version_latch_);
+    auto version = std::make_shared<RmLsmVersion>(*version_);
+    edit(*version);
+    version_ = std::move(version);
+}
+
+/**
+ * @description: 写出清单：先写临时文件再改名，进程在任何时刻退出，清单都是旧的或新的完整内容
+ */
+void RmLsmTableHandle::write_manifest() {
+    auto version = current();
+    RmLsmManifestHdr hdr{};
+    hdr.record_size = record_size_;
+    hdr.next_file_no = next_file_no_;
+    hdr.next_row = next_row_;
+    hdr.wal_no = min_wal_no_;
+    std::vector<RmLsmManifestRun> runs;
+    for (size_t level = 0; level < version->levels.size(); level++) {
+        for (auto &run : version->levels[level]) {
+            runs.push_back(RmLsmManifestRun{(int)level, run->file_no()});
+        }
+    }
+    hdr.num_runs = runs.size();
+    std::vector<char> buf(sizeof(hdr) + runs.size() * sizeof(RmLsmManifestRun));
+    memcpy(buf.data(), &hdr, sizeof(hdr));
+    memcpy(buf.data() + sizeof(hdr), runs.data(), runs.size() * sizeof(RmLsmManifestRun));
+    std::string tmp = manifest_tmp_name(name_);
+    if (disk_manager_->is_file(tmp)) {
+        disk_manager_->destroy_file(tmp);
+    }
+    rm_write_side_file(disk_manager_, tmp, buf);
+    if (std::rename(tmp.c_str(), name_.c_str()) != 0) {
+        throw UnixError();
+    }
+}
+
+/**
+ * @description: 把冻结的内存表写成0层的段，写出清单后删除它用过的预写日志，调用者持有bg_latch_
+ */
+void RmLsmTableHandle::flush_imm() {
+    std::shared_ptr<RmLsmMemTable> imm;
+    uint64_t imm_wal_no;
+    {
+        std::lock_guard<std::mutex> guard(version_latch_);
+        imm = version_->imm;
+        imm_wal_no = imm_wal_no_;
+    }
+    std::vector<std::shared_ptr<RmLsmRun>> runs;
+    if (!imm->empty()) {
+        auto iter = imm->iterator();
+        iter->seek(0);
+        runs = write_runs(iter.get(), false, SIZE_MAX);
+    }
+    install([&](RmLsmVersion &version) {
+        version.imm = nullptr;
+        version.levels[0].insert(version.levels[0].begin(), runs.begin(), runs.end());
+    });
+    uint64_t old_min_wal_no = min_wal_no_;
+    min_wal_no_ = imm_wal_no + 1;
+    write_manifest();
+    for (uint64_t no = old_min_wal_no; no <= imm_wal_no; no++) {
+        if (disk_manager_->is_file(wal_name(no))) {
+            disk_manager_->destroy_file(wal_name(no));
+        }
+    }
+    num_flushes_++;
+    // 先取得write_latch_再唤醒：等待的写者要么还没检查imm，要么已经在等待，不会错过通知
+    { std::lock_guard<std::mutex> guard(write_latch_); }
+    flushed_cv_.notify_all();
+}
+
+/**
+ * @description: 把input中的项按行号顺序写成一个或多个段，每个段不超过max_run_size字节
+ * @param drop_deleted 输出是否丢弃删除标记：更下面的层中没有这些行的旧版本时才能丢弃
+ */
+std::vector<std::shared_ptr<RmLsmRun>> RmLsmTableHandle::write_runs(RmLsmIterator *input, bool drop_deleted,
+                                                                    size_t max_run_size) {
+    std::vector<std::shared_ptr<RmLsmRun>> runs;
+    std::unique_ptr<RmLsmRunBuilder> builder;
+    uint64_t file_no = 0;
+    auto finish = [&] {
+        builder->finish();
+        runs.push_back(std::make_shared<RmLsmRun>(disk_manager_, buffer_pool_manager_, run_name(file_no), file_no));
+        builder = nullptr;
+    };
+    for (; input->valid(); input->next()) {
+        if (drop_deleted && input->deleted()) {
+            continue;
+        }
+        if (builder == nullptr) {
+            file_no = next_file_no_++;
+            builder = std::make_unique<RmLsmRunBuilder>(disk_manager_, run_name(file_no), record_size_);
+        }
+        builder->add(input->row(), input->deleted(), input->value());
+        if (builder->size_bytes() >= max_run_size) {
+            finish();
+        }
+    }
+    if (builder != nullptr) {
+        finish();
+    }
+    return runs;
+}
+
+/**
+ * @description: 选出需要合并的层：0层的段数达到触发值，或某一层超过大小上限，没有时返回-1
+ */
+int RmLsmTableHandle::pick_compaction(const RmLsmVersion &version) const {
+    if ((int)version.levels[0].size() >= RM_LSM_L0_COMPACTION_TRIGGER) {
+        return 0;
+    }
+    for (int level = 1; level < RM_LSM_MAX_LEVELS - 1; level++) {
+        if (version.level_bytes(level) > level_limit(level)) {
+            return level;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @description: 把第level层的段与level+1层中行号区间重叠的段归并，结果放入level+1层，调用者持有bg_latch_
+ * 0层的段相互重叠，一次全部合并；其余层每次从上次合并到的位置之后选一个段，轮流覆盖整个行号空间
+ */
+void RmLsmTableHandle::compact(int level) {
+    auto version = current();
+    std::vector<std::shared_ptr<RmLsmRun>> upper;
+    if (level == 0) {
+        upper = version->levels[0];
+    } else {
+        auto &runs = version->levels[level];
+        auto it = std::find_if(runs.begin(), runs.end(), [&](const std::shared_ptr<RmLsmRun> &run) {
+            return run->min_row() > compact_cursor_[level];
+        });
+        upper.push_back(it == runs.end() ? runs.front() : *it);
+    }
+    uint64_t lo = UINT64_MAX;
+    uint64_t hi = 0;
+    for (auto &run : upper) {
+        lo = std::min(lo, run->min_row());
+        hi = std::max(hi, run->max_row());
+    }
+    std::vector<std::shared_ptr<RmLsmRun>> lower;
+    for (auto &run : version->levels[level + 1]) {
+        if (run->overlaps(lo, hi)) {
+            lower.push_back(run);
+        }
+    }
+    // 更下面的层都为空时，删除标记没有需要遮住的旧版本
+    bool bottom = true;
+    for (int i = level + 2; i < RM_LSM_MAX_LEVELS; i++) {
+        bottom = bottom && version->levels[i].empty();
+    }
+
+    std::vector<std::unique_ptr<RmLsmIterator>> children;
+    for (auto &run : upper) {
+        children.push_back(run->iterator());
+    }
+    children.push_back(std::make_unique<RmLsmLevelIterator>(lower));
+    RmLsmMergingIterator input(std::move(children));
+    input.seek(0);
+    auto outputs = write_runs(&input, bottom, RM_LSM_RUN_SIZE);
+
+    std::vector<std::shared_ptr<RmLsmRun>> inputs = upper;
+    inputs.insert(inputs.end(), lower.begin(), lower.end());
+    finish_compaction(inputs, std::move(outputs), level + 1);
+    compact_cursor_[level] = hi;
+}
+
+/**
+ * @description: 把所有层归并到最下面一层(至少是1层)并丢弃删除标记，调用者持有bg_latch_
+ */
+void RmLsmTableHandle::major_compact() {
+    auto version = current();
+    int output_level = 1;
+    std::vector<std::shared_ptr<RmLsmRun>> inputs;
+    std::vector<std::unique_ptr<RmLsmIterator>> children;
+    for (int level = 0; level < RM_LSM_MAX_LEVELS; level++) {
+        auto &runs = version->levels[level];
+        if (runs.empty()) {
+            continue;
+        }
+        output_level = std::max(output_level, level);
+        inputs.insert(inputs.end(), runs.begin(), runs.end());
+        if (level == 0) {
+            for (auto &run : runs) {
+                children.push_back(run->iterator());
+            }
+        } else {
+            children.push_back(std::make_unique<RmLsmLevelIterator>(runs));
+        }
+    }
+    if (inputs.empty()) {
+        return;
+    }
+    RmLsmMergingIterator input(std::move(children));
+    input.seek(0);
+    finish_compaction(inputs, write_runs(&input, true, RM_LSM_RUN_SIZE), output_level);
+}
+
+/**
+ * @description: 发布合并的结果：从版本中去掉输入段，把输出段按行号顺序放入output_level层；
+ * 写出清单后输入段才标记为废弃，最后一个引用它们的读者放手时删除文件
+ */
+void RmLsmTableHandle::finish_compaction(const std::vector<std::shared_ptr<RmLsmRun>> &inputs,
+                                         std::vector<std::shared_ptr<RmLsmRun>> outputs, int output_level) {
+    install([&](RmLsmVersion &version) {
+        for (auto &runs : version.levels) {
+            runs.erase(std::remove_if(runs.begin(), runs.end(),
+                                      [&](const std::shared_ptr<RmLsmRun> &run) {
+                                          return std::find(inputs.begin(), inputs.end(), run) != inputs.end();
+                                      }),
+                       runs.end());
+        }
+        auto &runs = version.levels[output_level];
+        runs.insert(runs.end(), outputs.begin(), outputs.end());
+        std::sort(runs.begin(), runs.end(), [](const std::shared_ptr<RmLsmRun> &a, const std::shared_ptr<RmLsmRun> &b) {
+            return a->min_row() < b->min_row();
+        });
+    });
+    write_manifest();
+    for (auto &run : inputs) {
+        run->mark_obsolete();
+    }
+    num_compactions_++;
+}
+
+void RmLsmTableHandle::compact_all() {
+    {
+        std::unique_lock<std::mutex> lock(write_latch_);
+        if (!mem_->empty()) {
+            freeze(lock);
+        }
+    }
+    std::lock_guard<std::mutex> bg_guard(bg_latch_);
+    if (current()->imm != nullptr) {
+        flush_imm();
+    }
+    major_compact();
+}
+
+/**
+ * @description: 后台线程：优先把冻结的内存表写成段(写者可能在等待)，然后逐个完成需要的合并；
+ * 没有工作时等待写者唤醒或者超时后再检查
+ */
+void RmLsmTableHandle::worker_loop() {
+    std::unique_lock<std::mutex> lock(worker_mutex_);
+    while (!stop_worker_) {
+        lock.unlock();
+        bool worked = false;
+        {
+            std::lock_guard<std::mutex> bg_guard(bg_latch_);
+            auto version = current();
+            if (version->imm != nullptr) {
+                flush_imm();
+                worked = true;
+            } else {
+                int level = pick_compaction(*version);
+                if (level >= 0) {
+                    compact(level);
+                    worked = true;
+                }
+            }
+        }
+        lock.lock();
+        if (!worked && !stop_worker_) {
+            worker_cv_.wait_for(lock, std::chrono::milliseconds(100));
+        }
+    }
+}
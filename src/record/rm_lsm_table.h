@@ -0,0 +1,172 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rm_lsm_memtable.h"
+#include "rm_lsm_run.h"
+#include "rm_table_handle.h"
+
+/**
+ * @description: LSM表在某一时刻的组成，创建后不再修改；读者持有它的shared_ptr，
+ * 期间被合并掉的段和写完的内存表要等所有读者放手才释放
+ */
+struct RmLsmVersion {
+    std::shared_ptr<RmLsmMemTable> mem;  // 接收写入的内存表
+    std::shared_ptr<RmLsmMemTable> imm;  // 已冻结、正在写成0层段的内存表，没有时为nullptr
+    // levels[0]中的段新的在前，行号区间可以重叠；其余各层的段按行号有序且互不重叠
+    std::vector<std::vector<std::shared_ptr<RmLsmRun>>> levels;
+
+    size_t level_bytes(int level) const;
+};
+
+/* LSM表清单文件的文件头，后面依次是num_runs个RmLsmManifestRun */
+struct RmLsmManifestHdr {
+    int record_size;
+    int num_runs;
+    uint64_t next_file_no;  // 下一个段文件的编号
+    uint64_t next_row;      // 下一个行号
+    uint64_t wal_no;        // 可能含有未写成段的修改的最早的预写日志编号
+};
+
+struct RmLsmManifestRun {
+    int level;
+    uint64_t file_no;
+};
+
+/**
+ * @description: LSM树存储引擎的表，适合写入远多于读取、按插入顺序追加的表(如事件流水)
+ * 写入先追加到表自己的预写日志，再插入内存表(跳表)；内存表写满后冻结，后台线程把它顺序写成0层的有序段。
+ * 0层的段数达到RM_LSM_L0_COMPACTION_TRIGGER，或某一层的总大小超过上限(1层RM_LSM_L1_SIZE，
+ * 往下每层RM_LSM_LEVEL_RATIO倍)时，后台线程把它和下一层中行号区间重叠的段归并成新的段(分层合并)。
+ * 读取依次查内存表、冻结的内存表、0层由新到旧的段、其余每层至多一个段，遇到的第一个版本即最新的版本。
+ * 插入、更新和删除都不读盘，更新和删除写入新版本或删除标记，旧版本在合并时丢弃。
+ * 表文件本身(与表同名)是清单，记录每个段所在的层；段文件名为"表名.run编号"，预写日志为"表名.wal编号"
+ */
+class RmLsmTableHandle : public RmTableHandle {
+    DiskManager *disk_manager_;
+    BufferPoolManager *buffer_pool_manager_;
+    std::string name_;
+    int record_size_;
+
+    mutable std::mutex version_latch_;  // 保护version_和imm_wal_no_
+    std::shared_ptr<const RmLsmVersion> version_;
+    uint64_t imm_wal_no_ = 0;  // 冻结的内存表的修改最晚写在这个预写日志中
+
+    std::mutex write_latch_;              // 串行化写入：分配行号、追加预写日志、插入内存表、切换内存表
+    std::condition_variable flushed_cv_;  // 冻结的内存表写完后唤醒等待切换的写者
+    RmLsmMemTable *mem_ = nullptr;        // 当前的内存表，持有write_latch_时有效
+    uint64_t next_seq_ = 1;
+    std::atomic<uint64_t> next_row_{0};
+    int wal_fd_ = -1;
+    uint64_t wal_no_ = 0;  // 当前预写日志的编号
+    std::vector<char> wal_entry_;
+
+    // 以下只在持有bg_latch_时访问：内存表写盘和合并由后台线程进行，VACUUM和关闭时由调用者进行
+    std::mutex bg_latch_;
+    uint64_t min_wal_no_ = 0;
+    std::atomic<uint64_t> next_file_no_{1};
+    std::vector<uint64_t> compact_cursor_;  // 每层下一次从哪个行号之后选段合并
+
+    std::thread worker_;
+    std::mutex worker_mutex_;
+    std::condition_variable worker_cv_;
+    bool stop_worker_ = false;
+
+    std::atomic<uint64_t> num_flushes_{0};
+    std::atomic<uint64_t> num_compactions_{0};
+
+   public:
+    RmLsmTableHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, std::string name);
+
+    ~RmLsmTableHandle();
+
+    static void create(DiskManager *disk_manager, const std::string &name, int record_size);
+
+    static void destroy(DiskManager *disk_manager, const std::string &name);
+
+    // 写完所有内存表、停止后台线程并写出清单
+    void close();
+
+    int record_size() const override { return record_size_; }
+
+    int num_pages() const override;
+
+    std::unique_ptr<RmRecord> get_record(const Rid &rid, Context *context) const override;
+
+    std::unique_ptr<RmRecord> get_record(const Rid &rid, const std::vector<int> &fields,
+                                         Context *context) const override;
+
+    Rid insert_record(char *buf, Context *context) override;
+
+    void delete_record(const Rid &rid, Context *context) override;
+
+    Rid update_record(const Rid &rid, char *buf, Context *context) override;
+
+    std::unique_ptr<RecScan> scan(std::function<bool(int)> page_filter = nullptr,
+                                  int begin_page_no = RM_FIRST_RECORD_PAGE,
+                                  int end_page_no = INT32_MAX) const override;
+
+    // 把当前的内存表写成段，再把所有层合并到最下面一层并丢弃删除标记，完成后返回
+    void compact_all();
+
+    std::shared_ptr<const RmLsmVersion> current() const;
+
+    uint64_t num_flushes() const { return num_flushes_; }
+
+    uint64_t num_compactions() const { return num_compactions_; }
+
+   private:
+    static std::string manifest_tmp_name(const std::string &name) { return name + ".manifest"; }
+
+    std::string run_name(uint64_t file_no) const { return name_ + ".run" + std::to_string(file_no); }
+
+    std::string wal_name(uint64_t wal_no) const { return name_ + ".wal" + std::to_string(wal_no); }
+
+    bool lookup(uint64_t row, char *value) const;
+
+    void write_entry(uint64_t row, bool deleted, const char *value, std::unique_lock<std::mutex> &lock);
+
+    void make_room(std::unique_lock<std::mutex> &lock);
+
+    void freeze(std::unique_lock<std::mutex> &lock);
+
+    void open_wal();
+
+    void replay_wal();
+
+    void install(const std::function<void(RmLsmVersion &)> &edit);
+
+    void write_manifest();
+
+    void flush_imm();
+
+    int pick_compaction(const RmLsmVersion &version) const;
+
+    void compact(int level);
+
+    void major_compact();
+
+    void finish_compaction(const std::vector<std::shared_ptr<RmLsmRun>> &inputs,
+                           std::vector<std::shared_ptr<RmLsmRun>> outputs, int output_level);
+
+    std::vector<std::shared_ptr<RmLsmRun>> write_runs(RmLsmIterator *input, bool drop_deleted,
+                                                      size_t max_run_size);
+
+    void worker_loop();
+};
@@ -12,9 +12,14 @@ See the Mulan PSL v2 for more details. */
 
 #include <assert.h>
 
+#include <numeric>
+#include <vector>
+
 #include "bitmap.h"
 #include "rm_defs.h"
 #include "rm_file_handle.h"
+#include "rm_lsm_table.h"
+#include "rm_mem_table.h"
 
 /* 记录管理器，用于管理表的数据文件，进行文件的创建、打开、删除、关闭 */
 class RmManager {
@@ -31,25 +36,53 @@ class RmManager {
      * @description: 创建表的数据文件并初始化相关信息
      * @param {string&} filename 要创建的文件名称
      * @param {int} record_size 表中记录的大小
+     * @param {int} layout 页面布局，RM_LAYOUT_ROW或RM_LAYOUT_PAX
+     * @param {vector<int>&} col_lens PAX布局下每个字段的长度，按字段在记录中的顺序排列
      */
-    void create_file(const std::string &filename, int record_size) {
+    void create_file(const std::string &filename, int record_size,
+                     int layout = RM_LAYOUT_ROW,
+                     const std::vector<int> &col_lens = {}) {
         if (record_size < 1 || record_size > RM_MAX_RECORD_SIZE) {
             throw InvalidRecordSizeError(record_size);
         }
+        if (layout == RM_LAYOUT_PAX) {
+            if (col_lens.empty() || col_lens.size() > RM_MAX_COLS) {
+                throw InternalError("PAX layout supports 1 to " +
+                                    std::to_string(RM_MAX_COLS) + " columns");
+            }
+            if (std::accumulate(col_lens.begin(), col_lens.end(), 0) !=
+                record_size) {
+                throw InvalidRecordSizeError(record_size);
+            }
+        }
         disk_manager_->create_file(filename);
         int fd = disk_manager_->open_file(filename);
+        // 清理同名表残留的FSM文件，新表的FSM在第一次关闭时写出
+        destroy_side_files(filename);
 
         // 初始化file header
         RmFileHdr file_hdr{};
         file_hdr.record_size = record_size;
         file_hdr.num_pages = 1;
         file_hdr.first_free_page_no = RM_NO_PAGE;
-        // We have: sizeof(hdr) + (n + 7) / 8 + n * record_size <= PAGE_SIZE
+        // We have: lsn + sizeof(page hdr) + (n + 7) / 8 + n * record_size <= PAGE_SIZE
+        int page_hdr_size = Page::OFFSET_PAGE_HDR + (int)sizeof(RmPageHdr);
         file_hdr.num_records_per_page =
-            (BITMAP_WIDTH * (PAGE_SIZE - 1 - (int)sizeof(RmFileHdr)) + 1) /
+            (BITMAP_WIDTH * (PAGE_SIZE - 1 - page_hdr_size) + 1) /
             (1 + record_size * BITMAP_WIDTH);
         file_hdr.bitmap_size =
             (file_hdr.num_records_per_page + BITMAP_WIDTH - 1) / BITMAP_WIDTH;
+        file_hdr.layout = layout;
+        if (layout == RM_LAYOUT_PAX) {
+            // PAX布局下slots区域按字段划分为minipage，总大小与行存相同
+            file_hdr.num_cols = col_lens.size();
+            int offset = 0;
+            for (int i = 0; i < file_hdr.num_cols; i++) {
+                file_hdr.col_offsets[i] = offset;
+                file_hdr.col_lens[i] = col_lens[i];
+                offset += col_lens[i];
+            }
+        }
 
         // 将file header写入磁盘文件（名为file name，文件描述符为fd）中的第0页
         // head
@@ -65,18 +98,46 @@ class RmManager {
      */
     void destroy_file(const std::string &filename) {
         disk_manager_->destroy_file(filename);
+        destroy_side_files(filename);
     }
 
     // 注意这里打开文件，创建并返回了record file handle的指针
     /**
      * @description: 打开表的数据文件，并返回文件句柄
      * @param {string&} filename 要打开的文件名称
+     * @param {vector<RmZoneCol>&} zone_cols 需要维护zone map的数值列，为空时不启用zone map
      * @return {unique_ptr<RmFileHandle>} 文件句柄的指针
      */
-    std::unique_ptr<RmFileHandle> open_file(const std::string &filename) {
+    std::unique_ptr<RmFileHandle> open_file(
+        const std::string &filename,
+        const std::vector<RmZoneCol> &zone_cols = {}) {
         int fd = disk_manager_->open_file(filename);
-        return std::make_unique<RmFileHandle>(disk_manager_,
-                                              buffer_pool_manager_, fd);
+        auto file_handle = std::make_unique<RmFileHandle>(
+            disk_manager_, buffer_pool_manager_, fd);
+        // 加载空闲空间映射，FSM文件不存在时(旧版本的表)扫描数据页重建
+        std::string fsm_name = RmFreeSpaceMap::get_fsm_name(filename);
+        if (disk_manager_->is_file(fsm_name)) {
+            file_handle->fsm_->load(disk_manager_, fsm_name);
+            // FSM只在关闭表时写回，加载后删除文件；若进程异常退出，下次打开时FSM文件不存在，
+            // 会从数据页重建，避免使用过期的FSM(扫描会据此跳过空页面)
+            disk_manager_->destroy_file(fsm_name);
+        } else {
+            file_handle->rebuild_free_space_map();
+        }
+        // zone map与FSM采用同样的策略：加载后删除文件，缺失或列数不符时重建
+        std::string zm_name = RmZoneMap::get_zone_map_name(filename);
+        if (!zone_cols.empty()) {
+            file_handle->zone_map_ = std::make_unique<RmZoneMap>(zone_cols);
+            bool loaded = disk_manager_->is_file(zm_name) &&
+                          file_handle->zone_map_->load(disk_manager_, zm_name);
+            if (!loaded) {
+                file_handle->rebuild_zone_map();
+            }
+        }
+        if (disk_manager_->is_file(zm_name)) {
+            disk_manager_->destroy_file(zm_name);
+        }
+        return file_handle;
     }
     /**
      * @description: 关闭表的数据文件
@@ -87,7 +148,65 @@ class RmManager {
                                   (char *)&file_handle->file_hdr_,
                                   sizeof(file_handle->file_hdr_));
         // 缓冲区的所有页刷到磁盘，注意这句话必须写在close_file前面
-        buffer_pool_manager_->flush_all_pages(file_handle->fd_);
+        buffer_pool_manager_->discard_all_pages(file_handle->fd_);
+        std::string fsm_name = RmFreeSpaceMap::get_fsm_name(
+            disk_manager_->get_file_name(file_handle->fd_));
+        file_handle->fsm_->store(disk_manager_, fsm_name);
+        if (file_handle->zone_map_ != nullptr) {
+            file_handle->zone_map_->store(
+                disk_manager_, RmZoneMap::get_zone_map_name(
+                                   disk_manager_->get_file_name(file_handle->fd_)));
+        }
         disk_manager_->close_file(file_handle->fd_);
     }
+
+    /**
+     * @description: 创建LSM表，见RmLsmTableHandle
+     * @param {string&} filename 表的清单文件名称，与表同名
+     * @param {int} record_size 表中记录的大小
+     */
+    void create_lsm_file(const std::string &filename, int record_size) {
+        RmLsmTableHandle::create(disk_manager_, filename, record_size);
+    }
+
+    void destroy_lsm_file(const std::string &filename) {
+        RmLsmTableHandle::destroy(disk_manager_, filename);
+    }
+
+    std::unique_ptr<RmLsmTableHandle> open_lsm_file(const std::string &filename) {
+        return std::make_unique<RmLsmTableHandle>(disk_manager_, buffer_pool_manager_, filename);
+    }
+
+    // 把内存表写成段，之后表的全部内容都在段文件中
+    void close_lsm_file(RmLsmTableHandle *table_handle) { table_handle->close(); }
+
+    /**
+     * @description: 创建内存表，见RmMemTableHandle
+     * @param {string&} filename 表的快照文件名称，与表同名
+     * @param {int} record_size 表中记录的大小
+     * @param {bool} durable 是否用预写日志和快照保存表的内容
+     */
+    void create_mem_file(const std::string &filename, int record_size, bool durable) {
+        RmMemTableHandle::create(disk_manager_, filename, record_size, durable);
+    }
+
+    void destroy_mem_file(const std::string &filename) { RmMemTableHandle::destroy(disk_manager_, filename); }
+
+    std::unique_ptr<RmMemTableHandle> open_mem_file(const std::string &filename) {
+        return std::make_unique<RmMemTableHandle>(disk_manager_, filename);
+    }
+
+    // durable的表写出快照，之后不再需要预写日志
+    void close_mem_file(RmMemTableHandle *table_handle) { table_handle->close(); }
+
+   private:
+    // 删除数据文件的附属文件(FSM、zone map)
+    void destroy_side_files(const std::string &filename) {
+        for (const std::string &name : {RmFreeSpaceMap::get_fsm_name(filename),
+                                        RmZoneMap::get_zone_map_name(filename)}) {
+            if (disk_manager_->is_file(name)) {
+                disk_manager_->destroy_file(name);
+            }
+        }
+    }
 };
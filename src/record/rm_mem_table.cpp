@@ -0,0 +1,411 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "rm_mem_table.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+#include "rm_side_file.h"
+
+constexpr char RM_MEM_WAL_PUT = 0;
+constexpr char RM_MEM_WAL_DELETE = 1;
+
+namespace {
+
+/**
+ * @description: 按行号顺序扫描内存表，每次拷贝一个块中的全部记录，
+ * 跳过页面号不在[begin_page_no, end_page_no)中或被page_filter排除的块；开始扫描之后新分配的块不扫描
+ */
+class RmMemScan : public RecScan {
+    const RmMemTableHandle *table_;
+    std::function<bool(int)> page_filter_;
+    int page_no_;
+    int end_page_no_;
+    std::vector<Rid> rids_;
+    std::vector<char> records_;
+    size_t pos_ = 0;
+
+   public:
+    RmMemScan(const RmMemTableHandle *table, std::function<bool(int)> page_filter, int begin_page_no,
+              int end_page_no)
+        : table_(table),
+          page_filter_(std::move(page_filter)),
+          page_no_(begin_page_no),
+          end_page_no_(std::min(end_page_no, table->num_pages())) {
+        next_chunk();
+    }
+
+    void next() override {
+        pos_++;
+        if (pos_ >= rids_.size()) {
+            next_chunk();
+        }
+    }
+
+    bool is_end() const override { return pos_ >= rids_.size(); }
+
+    Rid rid() const override { return rids_[pos_]; }
+
+    const char *record() const override { return records_.data() + pos_ * table_->record_size(); }
+
+   private:
+    void next_chunk() {
+        rids_.clear();
+        records_.clear();
+        pos_ = 0;
+        while (rids_.empty() && page_no_ < end_page_no_) {
+            int page_no = page_no_++;
+            if (page_filter_ != nullptr && !page_filter_(page_no)) {
+                continue;
+            }
+            if (!table_->read_chunk(page_no, &rids_, &records_)) {
+                break;  // 扫描期间VACUUM释放了尾部的块
+            }
+        }
+    }
+};
+
+}  // namespace
+
+void RmMemTableHandle::create(DiskManager *disk_manager, const std::string &name, int record_size, bool durable) {
+    if (record_size < 1 || record_size > RM_MAX_RECORD_SIZE) {
+        throw InvalidRecordSizeError(record_size);
+    }
+    disk_manager->create_file(name);
+    RmMemFileHdr hdr{};
+    hdr.record_size = record_size;
+    hdr.durable = durable;
+    std::vector<char> buf(sizeof(hdr));
+    memcpy(buf.data(), &hdr, sizeof(hdr));
+    rm_write_side_file(disk_manager, name, buf);
+}
+
+/**
+ * @description: 删除内存表的快照文件和预写日志
+ */
+void RmMemTableHandle::destroy(DiskManager *disk_manager, const std::string &name) {
+    for (const std::string &path : {wal_name(name), snapshot_tmp_name(name)}) {
+        if (disk_manager->is_file(path)) {
+            disk_manager->destroy_file(path);
+        }
+    }
+    disk_manager->destroy_file(name);
+}
+
+/**
+ * @description: 打开内存表：durable时读快照、重放预写日志，然后立即写出新的快照并开始新的预写日志
+ */
+RmMemTableHandle::RmMemTableHandle(DiskManager *disk_manager, std::string name)
+    : disk_manager_(disk_manager), name_(std::move(name)) {
+    std::vector<char> buf = rm_read_side_file(disk_manager_, name_);
+    if (buf.size() < sizeof(RmMemFileHdr)) {
+        throw InternalError("RmMemTableHandle: corrupted table file " + name_);
+    }
+    RmMemFileHdr hdr;
+    memcpy(&hdr, buf.data(), sizeof(hdr));
+    record_size_ = hdr.record_size;
+    durable_ = hdr.durable != 0;
+    wal_entry_.resize(1 + sizeof(int) + record_size_);
+    if (durable_) {
+        load_snapshot(buf);
+        replay_wal();
+        rebuild_free_rows();
+        checkpoint();
+    }
+}
+
+RmMemTableHandle::~RmMemTableHandle() { close(); }
+
+void RmMemTableHandle::close() {
+    std::unique_lock<std::shared_mutex> lock(latch_);
+    if (closed_) {
+        return;
+    }
+    closed_ = true;
+    if (durable_) {
+        checkpoint();
+    }
+    if (wal_fd_ >= 0) {
+        disk_manager_->close_file(wal_fd_);
+        wal_fd_ = -1;
+    }
+}
+
+int RmMemTableHandle::num_records() const {
+    std::shared_lock<std::shared_mutex> lock(latch_);
+    return num_records_;
+}
+
+int RmMemTableHandle::num_pages() const {
+    std::shared_lock<std::shared_mutex> lock(latch_);
+    return RM_FIRST_RECORD_PAGE + static_cast<int>(chunks_.size());
+}
+
+int RmMemTableHandle::live_row(const Rid &rid) const {
+    int chunk_no = rid.page_no - RM_FIRST_RECORD_PAGE;
+    if (chunk_no < 0 || chunk_no >= static_cast<int>(chunks_.size()) || rid.slot_no < 0 ||
+        rid.slot_no >= RM_MEM_ROWS_PER_CHUNK || !Bitmap::is_set(chunks_[chunk_no]->bitmap, rid.slot_no)) {
+        throw RecordNotFoundError(rid.page_no, rid.slot_no);
+    }
+    return chunk_no * RM_MEM_ROWS_PER_CHUNK + rid.slot_no;
+}
+
+std::unique_ptr<RmRecord> RmMemTableHandle::get_record(const Rid &rid, Context *context) const {
+    std::shared_lock<std::shared_mutex> lock(latch_);
+    return std::make_unique<RmRecord>(record_size_, row_data(live_row(rid)));
+}
+
+/**
+ * @description: 优先重用空槽位，没有时分配一个新块，新块的其余槽位加入空槽位列表
+ */
+Rid RmMemTableHandle::insert_record(char *buf, Context *context) {
+    std::unique_lock<std::shared_mutex> lock(latch_);
+    if (free_rows_.empty()) {
+        int first = static_cast<int>(chunks_.size()) * RM_MEM_ROWS_PER_CHUNK;
+        for (int row = first + RM_MEM_ROWS_PER_CHUNK - 1; row >= first; row--) {
+            free_rows_.push_back(row);
+        }
+    }
+    int row = free_rows_.back();
+    free_rows_.pop_back();
+    put_row(row, buf);
+    log_row(row);
+    return row_to_rid(row);
+}
+
+void RmMemTableHandle::delete_record(const Rid &rid, Context *context) {
+    std::unique_lock<std::shared_mutex> lock(latch_);
+    int row = live_row(rid);
+    erase_row(row);
+    free_rows_.push_back(row);
+    log_row(row);
+}
+
+Rid RmMemTableHandle::update_record(const Rid &rid, char *buf, Context *context) {
+    std::unique_lock<std::shared_mutex> lock(latch_);
+    int row = live_row(rid);
+    put_row(row, buf);
+    log_row(row);
+    return rid;
+}
+
+std::unique_ptr<RecScan> RmMemTableHandle::scan(std::function<bool(int)> page_filter, int begin_page_no,
+                                                int end_page_no) const {
+    return std::make_unique<RmMemScan>(this, std::move(page_filter), begin_page_no, end_page_no);
+}
+
+bool RmMemTableHandle::read_chunk(int page_no, std::vector<Rid> *rids, std::vector<char> *records) const {
+    std::shared_lock<std::shared_mutex> lock(latch_);
+    int chunk_no = page_no - RM_FIRST_RECORD_PAGE;
+    if (chunk_no < 0 || chunk_no >= static_cast<int>(chunks_.size())) {
+        return false;
+    }
+    const RmMemChunk &chunk = *chunks_[chunk_no];
+    const char *data = chunk.data.get();
+    if (chunk.num_records == RM_MEM_ROWS_PER_CHUNK) {
+        for (int slot_no = 0; slot_no < RM_MEM_ROWS_PER_CHUNK; slot_no++) {
+            rids->push_back(Rid{page_no, slot_no});
+        }
+        records->insert(records->end(), data, data + static_cast<size_t>(record_size_) * RM_MEM_ROWS_PER_CHUNK);
+        return true;
+    }
+    for (int slot_no = Bitmap::first_bit(true, chunk.bitmap, RM_MEM_ROWS_PER_CHUNK);
+         slot_no < RM_MEM_ROWS_PER_CHUNK;
+         slot_no = Bitmap::next_bit(true, chunk.bitmap, RM_MEM_ROWS_PER_CHUNK, slot_no)) {
+        rids->push_back(Rid{page_no, slot_no});
+        const char *record = data + static_cast<size_t>(slot_no) * record_size_;
+        records->insert(records->end(), record, record + record_size_);
+    }
+    return true;
+}
+
+/**
+ * @description: 存活记录恰好能放进前keep_chunks个块，从尾部往前逐条搬到前部的空槽位；
+ * 搬迁在写锁下一次完成，durable时完成后写快照，不逐条记日志
+ */
+int RmMemTableHandle::vacuum(const std::function<void(const Rid &, const Rid &, const RmRecord &)> &on_move) {
+    std::unique_lock<std::shared_mutex> lock(latch_);
+    int num_chunks = static_cast<int>(chunks_.size());
+    int keep_chunks = (num_records_ + RM_MEM_ROWS_PER_CHUNK - 1) / RM_MEM_ROWS_PER_CHUNK;
+    if (keep_chunks >= num_chunks) {
+        return 0;
+    }
+    int keep_rows = keep_chunks * RM_MEM_ROWS_PER_CHUNK;
+    int hole = -1;
+    RmRecord record(record_size_);
+    for (int row = num_chunks * RM_MEM_ROWS_PER_CHUNK - 1; row >= keep_rows; row--) {
+        const RmMemChunk &chunk = *chunks_[row / RM_MEM_ROWS_PER_CHUNK];
+        if (!Bitmap::is_set(chunk.bitmap, row % RM_MEM_ROWS_PER_CHUNK)) {
+            continue;
+        }
+        do {
+            hole++;
+        } while (Bitmap::is_set(chunks_[hole / RM_MEM_ROWS_PER_CHUNK]->bitmap, hole % RM_MEM_ROWS_PER_CHUNK));
+        if (hole >= keep_rows) {
+            throw InternalError("No free slot left while vacuuming");
+        }
+        memcpy(record.data, row_data(row), record_size_);
+        put_row(hole, record.data);
+        erase_row(row);
+        on_move(row_to_rid(row), row_to_rid(hole), record);
+    }
+    chunks_.resize(keep_chunks);
+    rebuild_free_rows();
+    if (durable_) {
+        checkpoint();
+    }
+    return num_chunks - keep_chunks;
+}
+
+void RmMemTableHandle::put_row(int row, const char *buf) {
+    int chunk_no = row / RM_MEM_ROWS_PER_CHUNK;
+    while (static_cast<int>(chunks_.size()) <= chunk_no) {
+        chunks_.push_back(std::make_unique<RmMemChunk>(record_size_));
+    }
+    RmMemChunk &chunk = *chunks_[chunk_no];
+    if (!Bitmap::is_set(chunk.bitmap, row % RM_MEM_ROWS_PER_CHUNK)) {
+        Bitmap::set(chunk.bitmap, row % RM_MEM_ROWS_PER_CHUNK);
+        chunk.num_records++;
+        num_records_++;
+    }
+    memcpy(row_data(row), buf, record_size_);
+}
+
+void RmMemTableHandle::erase_row(int row) {
+    RmMemChunk &chunk = *chunks_[row / RM_MEM_ROWS_PER_CHUNK];
+    Bitmap::reset(chunk.bitmap, row % RM_MEM_ROWS_PER_CHUNK);
+    chunk.num_records--;
+    num_records_--;
+}
+
+// 空槽位按行号从大到小放入，插入时先用行号小的，记录尽量集中在前部的块
+void RmMemTableHandle::rebuild_free_rows() {
+    free_rows_.clear();
+    for (int row = static_cast<int>(chunks_.size()) * RM_MEM_ROWS_PER_CHUNK - 1; row >= 0; row--) {
+        if (!Bitmap::is_set(chunks_[row / RM_MEM_ROWS_PER_CHUNK]->bitmap, row % RM_MEM_ROWS_PER_CHUNK)) {
+            free_rows_.push_back(row);
+        }
+    }
+}
+
+void RmMemTableHandle::load_snapshot(const std::vector<char> &buf) {
+    RmMemFileHdr hdr;
+    memcpy(&hdr, buf.data(), sizeof(hdr));
+    size_t entry_size = sizeof(int) + record_size_;
+    if (buf.size() < sizeof(hdr) + hdr.num_records * entry_size) {
+        throw InternalError("RmMemTableHandle: corrupted table file " + name_);
+    }
+    for (int i = 0; i < hdr.num_chunks; i++) {
+        chunks_.push_back(std::make_unique<RmMemChunk>(record_size_));
+    }
+    const char *entry = buf.data() + sizeof(hdr);
+    for (int i = 0; i < hdr.num_records; i++, entry += entry_size) {
+        int row;
+        memcpy(&row, entry, sizeof(row));
+        put_row(row, entry + sizeof(row));
+    }
+}
+
+/**
+ * @description: 按顺序重放预写日志，每项都是行的完整新内容或删除标记，重放到已经包含这些修改的快照上
+ * 结果不变(写完快照、清空日志之前进程退出的情形)；末尾不完整的项(写到一半时进程退出)丢弃
+ */
+void RmMemTableHandle::replay_wal() {
+    std::vector<char> buf = rm_read_side_file(disk_manager_, wal_name(name_));
+    size_t entry_size = wal_entry_.size();
+    for (size_t offset = 0; offset + entry_size <= buf.size(); offset += entry_size) {
+        int row;
+        memcpy(&row, buf.data() + offset + 1, sizeof(row));
+        if (buf[offset] == RM_MEM_WAL_PUT) {
+            put_row(row, buf.data() + offset + 1 + sizeof(row));
+        } else if (row / RM_MEM_ROWS_PER_CHUNK < static_cast<int>(chunks_.size()) &&
+                   Bitmap::is_set(chunks_[row / RM_MEM_ROWS_PER_CHUNK]->bitmap, row % RM_MEM_ROWS_PER_CHUNK)) {
+            erase_row(row);
+        }
+    }
+}
+
+/**
+ * @description: 把行的当前状态追加到预写日志，调用者持有写锁；日志过长时写快照
+ */
+void RmMemTableHandle::log_row(int row) {
+    if (!durable_) {
+        return;
+    }
+    bool live = Bitmap::is_set(chunks_[row / RM_MEM_ROWS_PER_CHUNK]->bitmap, row % RM_MEM_ROWS_PER_CHUNK);
+    wal_entry_[0] = live ? RM_MEM_WAL_PUT : RM_MEM_WAL_DELETE;
+    memcpy(wal_entry_.data() + 1, &row, sizeof(row));
+    if (live) {
+        memcpy(wal_entry_.data() + 1 + sizeof(row), row_data(row), record_size_);
+    } else {
+        memset(wal_entry_.data() + 1 + sizeof(row), 0, record_size_);
+    }
+    disk_manager_->append_file(wal_fd_, wal_entry_.data(), wal_entry_.size());
+    wal_size_ += wal_entry_.size();
+    if (wal_size_ > RM_MEM_CHECKPOINT_SIZE && wal_size_ > static_cast<size_t>(num_records_) * record_size_) {
+        checkpoint();
+    }
+}
+
+/**
+ * @description: 写出快照并清空预写日志。快照先写临时文件再改名，进程在任何时刻退出，
+ * 表文件都是旧的或新的完整快照，再加上还没清空的日志即可恢复
+ */
+void RmMemTableHandle::checkpoint() {
+    RmMemFileHdr hdr{};
+    hdr.record_size = record_size_;
+    hdr.durable = durable_;
+    hdr.num_chunks = chunks_.size();
+    hdr.num_records = num_records_;
+    size_t entry_size = sizeof(int) + record_size_;
+    std::vector<char> buf(sizeof(hdr) + num_records_ * entry_size);
+    memcpy(buf.data(), &hdr, sizeof(hdr));
+    char *entry = buf.data() + sizeof(hdr);
+    for (int chunk_no = 0; chunk_no < static_cast<int>(chunks_.size()); chunk_no++) {
+        const RmMemChunk &chunk = *chunks_[chunk_no];
+        for (int slot_no = Bitmap::first_bit(true, chunk.bitmap, RM_MEM_ROWS_PER_CHUNK);
+             slot_no < RM_MEM_ROWS_PER_CHUNK;
+             slot_no = Bitmap::next_bit(true, chunk.bitmap, RM_MEM_ROWS_PER_CHUNK, slot_no)) {
+            int row = chunk_no * RM_MEM_ROWS_PER_CHUNK + slot_no;
+            memcpy(entry, &row, sizeof(row));
+            memcpy(entry + sizeof(row), row_data(row), record_size_);
+            entry += entry_size;
+        }
+    }
+    std::string tmp = snapshot_tmp_name(name_);
+    if (disk_manager_->is_file(tmp)) {
+        disk_manager_->destroy_file(tmp);
+    }
+    rm_write_side_file(disk_manager_, tmp, buf);
+    if (std::rename(tmp.c_str(), name_.c_str()) != 0) {
+        throw UnixError();
+    }
+    open_wal();
+}
+
+/**
+ * @description: 删除旧的预写日志，新建一个空的
+ */
+void RmMemTableHandle::open_wal() {
+    if (wal_fd_ >= 0) {
+        disk_manager_->close_file(wal_fd_);
+        wal_fd_ = -1;
+    }
+    std::string path = wal_name(name_);
+    if (disk_manager_->is_file(path)) {
+        disk_manager_->destroy_file(path);
+    }
+    disk_manager_->create_file(path);
+    wal_fd_ = disk_manager_->open_file(path);
+    wal_size_ = 0;
+}
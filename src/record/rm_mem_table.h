@@ -0,0 +1,149 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "bitmap.h"
+#include "rm_table_handle.h"
+#include "storage/disk_manager.h"
+
+constexpr int RM_MEM_ROWS_PER_CHUNK = 256;  // 每个块的行数，块号映射为页面号、块内下标映射为槽位号
+constexpr size_t RM_MEM_CHECKPOINT_SIZE = 4 << 20;  // 预写日志超过这个字节数且超过表的大小时写快照
+
+/* 内存表快照文件(与表同名)的文件头，后面是num_records个(行号, 记录) */
+struct RmMemFileHdr {
+    int record_size;
+    int durable;  // 为0时表的内容不落盘，重新打开后为空表
+    int num_chunks;
+    int num_records;
+};
+
+/* 内存表的一个块：RM_MEM_ROWS_PER_CHUNK条记录连续存放，位图标记哪些槽位有记录 */
+struct RmMemChunk {
+    std::unique_ptr<char[]> data;
+    char bitmap[RM_MEM_ROWS_PER_CHUNK / BITMAP_WIDTH];
+    int num_records;
+
+    explicit RmMemChunk(int record_size)
+        : data(new char[static_cast<size_t>(record_size) * RM_MEM_ROWS_PER_CHUNK]), num_records(0) {
+        Bitmap::init(bitmap, sizeof(bitmap));
+    }
+};
+
+/**
+ * @description: 内存存储引擎的表，适合经常访问的小表(如字典表、配置表)。
+ * 记录不经过缓冲池，存放在按块分配的连续数组中，块一经分配地址不变；删除留下的槽位由后续插入重用。
+ * 读者共享、写者独占表的读写锁，扫描每次在读锁下拷贝一个块中的全部记录，不在两次next()之间持有锁。
+ * durable时每次修改都把行的新内容(或删除标记)追加到表自己的预写日志("表名.wal")；日志过长和关闭表时
+ * 把全部记录写成快照(表文件本身)并清空日志，打开时读快照再重放日志。不durable的表只保留表结构
+ */
+class RmMemTableHandle : public RmTableHandle {
+    DiskManager *disk_manager_;
+    std::string name_;
+    int record_size_;
+    bool durable_;
+
+    mutable std::shared_mutex latch_;  // 保护以下所有成员
+    std::vector<std::unique_ptr<RmMemChunk>> chunks_;
+    std::vector<int> free_rows_;  // 空槽位的行号，插入时从尾部取出
+    int num_records_ = 0;
+    int wal_fd_ = -1;
+    size_t wal_size_ = 0;
+    std::vector<char> wal_entry_;
+    bool closed_ = false;
+
+   public:
+    RmMemTableHandle(DiskManager *disk_manager, std::string name);
+
+    ~RmMemTableHandle();
+
+    static void create(DiskManager *disk_manager, const std::string &name, int record_size, bool durable);
+
+    static void destroy(DiskManager *disk_manager, const std::string &name);
+
+    // durable时写快照并清空预写日志
+    void close();
+
+    bool durable() const { return durable_; }
+
+    int num_records() const;
+
+    int record_size() const override { return record_size_; }
+
+    int num_pages() const override;
+
+    std::unique_ptr<RmRecord> get_record(const Rid &rid, Context *context) const override;
+
+    // 记录在内存中，整条拷贝的代价很小，fields不减少读取的数据量
+    std::unique_ptr<RmRecord> get_record(const Rid &rid, const std::vector<int> &fields,
+                                         Context *context) const override {
+        return get_record(rid, context);
+    }
+
+    Rid insert_record(char *buf, Context *context) override;
+
+    void delete_record(const Rid &rid, Context *context) override;
+
+    Rid update_record(const Rid &rid, char *buf, Context *context) override;
+
+    std::unique_ptr<RecScan> scan(std::function<bool(int)> page_filter = nullptr,
+                                  int begin_page_no = RM_FIRST_RECORD_PAGE,
+                                  int end_page_no = INT32_MAX) const override;
+
+    /**
+     * @description: 拷贝页面号为page_no的块中的全部记录，追加到rids和records
+     * @return {bool} 块存在；page_no不小于num_pages()时返回false
+     */
+    bool read_chunk(int page_no, std::vector<Rid> *rids, std::vector<char> *records) const;
+
+    /**
+     * @description: 把尾部块中的记录搬到前部的空槽位，释放尾部的空块，每搬迁一条记录调用一次on_move
+     * @return {int} 释放的块数
+     */
+    int vacuum(const std::function<void(const Rid &, const Rid &, const RmRecord &)> &on_move);
+
+   private:
+    static std::string wal_name(const std::string &name) { return name + ".wal"; }
+
+    static std::string snapshot_tmp_name(const std::string &name) { return name + ".snapshot"; }
+
+    static Rid row_to_rid(int row) {
+        return Rid{RM_FIRST_RECORD_PAGE + row / RM_MEM_ROWS_PER_CHUNK, row % RM_MEM_ROWS_PER_CHUNK};
+    }
+
+    // rid对应的行号，rid不指向存在的记录时抛出RecordNotFoundError
+    int live_row(const Rid &rid) const;
+
+    char *row_data(int row) const {
+        return chunks_[row / RM_MEM_ROWS_PER_CHUNK]->data.get() +
+               static_cast<size_t>(row % RM_MEM_ROWS_PER_CHUNK) * record_size_;
+    }
+
+    void put_row(int row, const char *buf);
+
+    void erase_row(int row);
+
+    void rebuild_free_rows();
+
+    void load_snapshot(const std::vector<char> &buf);
+
+    void replay_wal();
+
+    void log_row(int row);
+
+    void checkpoint();
+
+    void open_wal();
+};
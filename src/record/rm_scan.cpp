@@ -10,49 +10,59 @@ See the Mulan PSL v2 for more details. */
 
 #include "rm_scan.h"
 
+#include <algorithm>
+
 #include "rm_file_handle.h"
 
 /**
  * @brief 初始化file_handle和rid
  * @param file_handle
+ * @param page_filter 页面过滤器(如根据zone map判断)，为空时扫描所有页面
+ * @param begin_page_no, end_page_no 只扫描[begin_page_no, end_page_no)范围内的页面，用于多个线程分段扫描
  */
-RmScan::RmScan(const RmFileHandle *file_handle) : file_handle_(file_handle) {
+RmScan::RmScan(const RmFileHandle *file_handle,
+               std::function<bool(int)> page_filter, int begin_page_no,
+               int end_page_no)
+    : file_handle_(file_handle),
+      page_filter_(std::move(page_filter)),
+      end_page_no_(end_page_no) {
     // 初始化file_handle和rid（指向第一个存放了记录的位置）
-    rid_ = {.page_no = RM_FIRST_RECORD_PAGE, .slot_no = -1};
+    rid_ = {.page_no = std::max(begin_page_no, RM_FIRST_RECORD_PAGE),
+            .slot_no = -1};
     next();
 }
 
 /**
  * @brief 找到文件中下一个存放了记录的位置
+ * FSM中标记为完全空闲的页面以及被page_filter_排除的页面直接跳过，不必读入缓冲池
  */
 void RmScan::next() {
     // 找到文件中下一个存放了记录的非空闲位置，用rid_来指向这个位置
-    auto page_handle = file_handle_->fetch_page_handle(rid_.page_no);
-    int next_slot = Bitmap::next_bit(
-        true, page_handle.bitmap, file_handle_->file_hdr_.num_records_per_page,
-        rid_.slot_no);
+    const RmFileHdr &file_hdr = file_handle_->file_hdr_;
+    int end_page_no = std::min(file_hdr.num_pages, end_page_no_);
+    while (rid_.page_no < end_page_no) {
+        if (file_handle_->fsm_->is_empty(rid_.page_no) ||
+            (rid_.slot_no == -1 && page_filter_ != nullptr &&
+             !page_filter_(rid_.page_no))) {
+            rid_ = {.page_no = rid_.page_no + 1, .slot_no = -1};
+            continue;
+        }
+        auto page_handle = file_handle_->fetch_page_handle(rid_.page_no);
+        page_handle.page->rlatch();
+        int next_slot =
+            Bitmap::next_bit(true, page_handle.bitmap,
+                             file_hdr.num_records_per_page, rid_.slot_no);
+        page_handle.page->runlatch();
+        file_handle_->buffer_pool_manager_->unpin_page(
+            page_handle.page->get_page_id(), false);
 
-    if (next_slot < file_handle_->file_hdr_.num_records_per_page) {
-        rid_.slot_no = next_slot;  // 在当前页查找下一个有效记录
-    } else {
-        // 查找后续页面
-        rid_.page_no++;  // 1. 切换到下一页
-        while (rid_.page_no <
-               file_handle_->file_hdr_.num_pages) {  // 2. 遍历所有页
-            page_handle = file_handle_->fetch_page_handle(
-                rid_.page_no);  // 3. 获取页面句柄
-            int first_slot = Bitmap::first_bit(
-                true, page_handle.bitmap,  // 4. 查找第一个有效槽位
-                file_handle_->file_hdr_.num_records_per_page);
-            if (first_slot < file_handle_->file_hdr_
-                                 .num_records_per_page) {  // 5. 判断是否找到
-                rid_.slot_no = first_slot;                 // 6. 更新记录位置
-                return;                                    // 7. 找到后立即返回
-            }
-            rid_.page_no++;  // 8. 继续检查下一页
+        if (next_slot < file_hdr.num_records_per_page) {
+            rid_.slot_no = next_slot;  // 在当前页找到下一个有效记录
+            return;
         }
-        rid_ = Rid{RM_NO_PAGE, -1};  // 扫描结束
+        rid_ = {.page_no = rid_.page_no + 1, .slot_no = -1};  // 继续检查下一页
     }
+    rid_ = Rid{RM_NO_PAGE, -1};  // 扫描结束
 }
 
 /**
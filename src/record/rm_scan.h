@@ -10,6 +10,9 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
+
 #include "rm_defs.h"
 
 class RmFileHandle;
@@ -17,9 +20,14 @@ class RmFileHandle;
 class RmScan : public RecScan {
     const RmFileHandle *file_handle_;
     Rid rid_;
+    std::function<bool(int)> page_filter_;  // 返回false的页面不可能有满足条件的记录，直接跳过
+    int end_page_no_;                       // 只扫描页面号小于end_page_no_的页面
 
    public:
-    RmScan(const RmFileHandle *file_handle);
+    RmScan(const RmFileHandle *file_handle,
+           std::function<bool(int)> page_filter = nullptr,
+           int begin_page_no = RM_FIRST_RECORD_PAGE,
+           int end_page_no = INT32_MAX);
 
     void next() override;
 
@@ -0,0 +1,51 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "storage/disk_manager.h"
+
+/* 表数据文件的附属文件(FSM、zone map等)整体读写，内容常驻内存，只在打开/关闭表时读写磁盘 */
+
+/**
+ * @description: 读出整个附属文件，文件不存在时返回空
+ */
+inline std::vector<char> rm_read_side_file(DiskManager *disk_manager, const std::string &path) {
+    int file_size = disk_manager->get_file_size(path);
+    if (file_size <= 0) {
+        return {};
+    }
+    std::vector<char> buf(file_size);
+    int fd = disk_manager->open_file(path);
+    for (int offset = 0; offset < file_size; offset += PAGE_SIZE) {
+        disk_manager->read_page(fd, offset / PAGE_SIZE, buf.data() + offset, std::min(PAGE_SIZE, file_size - offset));
+    }
+    disk_manager->close_file(fd);
+    return buf;
+}
+
+/**
+ * @description: 用buf覆盖写整个附属文件，文件格式中自带长度信息，旧文件多出的尾部不必截断
+ */
+inline void rm_write_side_file(DiskManager *disk_manager, const std::string &path, const std::vector<char> &buf) {
+    if (!disk_manager->is_file(path)) {
+        disk_manager->create_file(path);
+    }
+    int fd = disk_manager->open_file(path);
+    for (int offset = 0; offset < (int)buf.size(); offset += PAGE_SIZE) {
+        disk_manager->write_page(fd, offset / PAGE_SIZE, buf.data() + offset,
+                                 std::min(PAGE_SIZE, (int)buf.size() - offset));
+    }
+    disk_manager->close_file(fd);
+}
@@ -0,0 +1,61 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "common/context.h"
+#include "rm_defs.h"
+
+class RmZoneMap;
+
+/**
+ * @description: 表的记录存取接口，执行器只通过它读写表中的记录，不关心表用哪种存储引擎
+ * 记录由Rid标识：堆表中是(页面号, 槽位号)；LSM表把自己的行号映射成Rid，聚簇表用主键编码成Rid，
+ * 内存表中是(块号, 块内下标)。
+ * 页面号区间可以用来划分并行扫描的范围
+ */
+class RmTableHandle {
+   public:
+    virtual ~RmTableHandle() = default;
+
+    virtual int record_size() const = 0;
+
+    // 页面号的上界(不含)，扫描[RM_FIRST_RECORD_PAGE, num_pages())覆盖整张表
+    virtual int num_pages() const = 0;
+
+    virtual std::unique_ptr<RmRecord> get_record(const Rid &rid, Context *context) const = 0;
+
+    // 只读取fields中的字段，返回与完整记录等长的记录，其余字段的内容未定义
+    virtual std::unique_ptr<RmRecord> get_record(const Rid &rid, const std::vector<int> &fields,
+                                                 Context *context) const = 0;
+
+    virtual Rid insert_record(char *buf, Context *context) = 0;
+
+    virtual void delete_record(const Rid &rid, Context *context) = 0;
+
+    // 返回记录更新后的Rid；只有聚簇表在主键改变时返回与rid不同的Rid
+    virtual Rid update_record(const Rid &rid, char *buf, Context *context) = 0;
+
+    /**
+     * @description: 扫描页面号在[begin_page_no, end_page_no)中的记录
+     * @param page_filter 返回false的页面不可能有满足条件的记录，不支持按页面剪枝的引擎忽略它
+     */
+    virtual std::unique_ptr<RecScan> scan(std::function<bool(int)> page_filter = nullptr,
+                                          int begin_page_no = RM_FIRST_RECORD_PAGE,
+                                          int end_page_no = INT32_MAX) const = 0;
+
+    // 每页数值列的[min, max]，引擎不维护zone map时为nullptr
+    virtual RmZoneMap *get_zone_map() const { return nullptr; }
+};
@@ -0,0 +1,137 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "rm_zone_map.h"
+
+#include <cstring>
+
+#include "rm_side_file.h"
+
+static double read_value(const RmZoneCol &col, const char *record) {
+    if (col.type == TYPE_INT) {
+        int value;
+        memcpy(&value, record + col.offset, sizeof(int));
+        return value;
+    }
+    float value;
+    memcpy(&value, record + col.offset, sizeof(float));
+    return value;
+}
+
+int RmZoneMap::find_col(int offset) const {
+    for (size_t i = 0; i < cols_.size(); i++) {
+        if (cols_[i].offset == offset) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void RmZoneMap::ensure_capacity(int num_pages) {
+    if ((int)has_values_.size() < num_pages) {
+        has_values_.resize(num_pages, 0);
+        mins_.resize(num_pages * cols_.size());
+        maxs_.resize(num_pages * cols_.size());
+    }
+}
+
+void RmZoneMap::extend(int page_no, const char *record) {
+    std::lock_guard<std::mutex> lock(latch_);
+    ensure_capacity(page_no + 1);
+    size_t base = page_no * cols_.size();
+    for (size_t i = 0; i < cols_.size(); i++) {
+        double value = read_value(cols_[i], record);
+        if (!has_values_[page_no]) {
+            mins_[base + i] = maxs_[base + i] = value;
+        } else {
+            mins_[base + i] = std::min(mins_[base + i], value);
+            maxs_[base + i] = std::max(maxs_[base + i], value);
+        }
+    }
+    has_values_[page_no] = 1;
+}
+
+void RmZoneMap::reset(int page_no) {
+    std::lock_guard<std::mutex> lock(latch_);
+    if (page_no < (int)has_values_.size()) {
+        has_values_[page_no] = 0;
+    }
+}
+
+bool RmZoneMap::may_contain(int page_no, int zone_col, double lo, double hi) {
+    std::lock_guard<std::mutex> lock(latch_);
+    if (page_no < 0 || page_no >= (int)has_values_.size()) {
+        return true;
+    }
+    if (!has_values_[page_no]) {
+        return false;
+    }
+    size_t idx = page_no * cols_.size() + zone_col;
+    return mins_[idx] <= hi && maxs_[idx] >= lo;
+}
+
+void RmZoneMap::truncate(int num_pages) {
+    std::lock_guard<std::mutex> lock(latch_);
+    if ((int)has_values_.size() > num_pages) {
+        has_values_.resize(num_pages);
+        mins_.resize(num_pages * cols_.size());
+        maxs_.resize(num_pages * cols_.size());
+    }
+}
+
+/**
+ * @description: 文件格式：页面数量n(int)、列数m(int)，随后是n个字节的has_values，
+ * 最后是n*m个最小值和n*m个最大值(double)
+ */
+bool RmZoneMap::load(DiskManager *disk_manager, const std::string &zm_name) {
+    std::lock_guard<std::mutex> lock(latch_);
+    has_values_.clear();
+    mins_.clear();
+    maxs_.clear();
+    std::vector<char> buf = rm_read_side_file(disk_manager, zm_name);
+    if (buf.size() < 2 * sizeof(int)) {
+        return false;
+    }
+    int num_pages, num_cols;
+    memcpy(&num_pages, buf.data(), sizeof(int));
+    memcpy(&num_cols, buf.data() + sizeof(int), sizeof(int));
+    size_t num_values = (size_t)num_pages * num_cols;
+    if (num_pages < 0 || num_cols != (int)cols_.size() ||
+        buf.size() < 2 * sizeof(int) + num_pages + 2 * num_values * sizeof(double)) {
+        return false;
+    }
+    ensure_capacity(num_pages);
+    const char *src = buf.data() + 2 * sizeof(int);
+    memcpy(has_values_.data(), src, num_pages);
+    src += num_pages;
+    memcpy(mins_.data(), src, num_values * sizeof(double));
+    src += num_values * sizeof(double);
+    memcpy(maxs_.data(), src, num_values * sizeof(double));
+    return true;
+}
+
+void RmZoneMap::store(DiskManager *disk_manager, const std::string &zm_name) {
+    std::lock_guard<std::mutex> lock(latch_);
+    int num_pages = has_values_.size();
+    int num_cols = cols_.size();
+    size_t num_values = mins_.size();
+    std::vector<char> buf(2 * sizeof(int) + num_pages + 2 * num_values * sizeof(double));
+    char *dst = buf.data();
+    memcpy(dst, &num_pages, sizeof(int));
+    memcpy(dst + sizeof(int), &num_cols, sizeof(int));
+    dst += 2 * sizeof(int);
+    memcpy(dst, has_values_.data(), num_pages);
+    dst += num_pages;
+    memcpy(dst, mins_.data(), num_values * sizeof(double));
+    dst += num_values * sizeof(double);
+    memcpy(dst, maxs_.data(), num_values * sizeof(double));
+
+    rm_write_side_file(disk_manager, zm_name, buf);
+}
@@ -0,0 +1,84 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "defs.h"
+#include "storage/disk_manager.h"
+
+/* zone map中记录的一个列：只支持定长数值列(TYPE_INT、TYPE_FLOAT) */
+struct RmZoneCol {
+    ColType type;
+    int offset;  // 列在记录中的偏移
+};
+
+/**
+ * @description: 表数据文件的zone map，记录每个数据页上各数值列的[min, max]
+ * 插入和更新时扩大所在页面的范围；删除只在页面变空时清空该页的范围，
+ * 因此范围可能比实际取值更宽，但一定包含页面上的所有取值，可以安全地用来跳过页面。
+ * 映射常驻内存，打开表时从"<表名>.zm"文件加载，关闭表时写回。
+ */
+class RmZoneMap {
+   public:
+    explicit RmZoneMap(std::vector<RmZoneCol> cols) : cols_(std::move(cols)) {}
+
+    static std::string get_zone_map_name(const std::string &filename) { return filename + ".zm"; }
+
+    const std::vector<RmZoneCol> &get_cols() const { return cols_; }
+
+    /**
+     * @description: 根据列在记录中的偏移查找其在zone map中的序号，没有记录该列时返回-1
+     */
+    int find_col(int offset) const;
+
+    /**
+     * @description: 将一条记录的取值并入所在页面的范围
+     * @param {int} page_no 记录所在的数据页面号
+     * @param {char*} record 记录数据
+     */
+    void extend(int page_no, const char *record);
+
+    /**
+     * @description: 页面上已经没有记录，清空该页的范围
+     */
+    void reset(int page_no);
+
+    /**
+     * @description: 判断页面上第zone_col列是否可能有落在[lo, hi]内的取值
+     * 没有记录的页面返回false，超出映射范围的页面保守地返回true
+     */
+    bool may_contain(int page_no, int zone_col, double lo, double hi);
+
+    /**
+     * @description: 截断映射，丢弃页面号大于等于num_pages的项
+     */
+    void truncate(int num_pages);
+
+    /**
+     * @description: 从zone map文件中加载，文件中的列数与当前不一致时返回false
+     */
+    bool load(DiskManager *disk_manager, const std::string &zm_name);
+
+    void store(DiskManager *disk_manager, const std::string &zm_name);
+
+   private:
+    void ensure_capacity(int num_pages);
+
+    std::vector<RmZoneCol> cols_;
+    std::vector<uint8_t> has_values_;  // 每个数据页上是否有记录
+    std::vector<double> mins_;         // 第page_no页第i列的最小值位于mins_[page_no * cols_.size() + i]
+    std::vector<double> maxs_;
+    std::mutex latch_;
+};
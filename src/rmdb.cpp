@@ -89,6 +89,10 @@ void *client_handler(void *sock_fd) {
     int offset = 0;
     // 记录客户端当前正在执行的事务ID
     txn_id_t txn_id = INVALID_TXN_ID;
+    // 当前连接的会话设置
+    SessionSettings session;
+    // 当前连接的查询内存区，每条语句开始时回收上一条语句的输出元组
+    RmArena arena;
 
     std::string output =
         "establish client connection, sockfd: " + std::to_string(fd) + "\n";
@@ -127,8 +131,9 @@ void *client_handler(void *sock_fd) {
         offset = 0;
 
         // 开启事务，初始化系统所需的上下文信息（包括事务对象指针、锁管理器指针、日志管理器指针、存放结果的buffer、记录结果长度的变量）
+        arena.reset();
         Context *context = new Context(lock_manager.get(), log_manager.get(),
-                                       nullptr, data_send, &offset);
+                                       nullptr, data_send, &offset, &session, &arena);
         // Lab 3 need to remove transaction part
         // Lab 4 need to restart transaction
         // SetTransaction(&txn_id, context);
@@ -123,6 +123,29 @@ Page* BufferPoolManager::fetch_page(PageId page_id) {
     return victim_page;
 }
 
+/**
+ * @description: 预读目标页面：页面不在缓冲池中时让磁盘异步读入操作系统的页缓存，不分配帧、不阻塞
+ * 用于顺序访问时提前发起下一个页面的I/O，使之与当前页面的处理重叠
+ * @param {PageId} page_id 目标page的page_id
+ */
+void BufferPoolManager::prefetch_page(PageId page_id) {
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        if (page_table_.count(page_id) > 0) {
+            return;
+        }
+    }
+    disk_manager_->prefetch_page(page_id.fd, page_id.page_no);
+}
+
+/**
+ * @description: 页面当前是否在缓冲池中，只查页表，不读盘也不影响替换顺序
+ */
+bool BufferPoolManager::is_resident(PageId page_id) {
+    std::lock_guard<std::mutex> guard(latch_);
+    return page_table_.count(page_id) > 0;
+}
+
 /**
  * @description: 取消固定pin_count>0的在缓冲池中的page
  * @return {bool} 如果目标页的pin_count<=0则返回false，否则返回true
@@ -280,11 +303,9 @@ bool BufferPoolManager::delete_page(PageId page_id) {
     page->is_dirty_ = false;                             // 重置is_dirty_
     page->pin_count_ = 0;                                // 重置pin_count_
 
-    // 将帧添加到空闲列表
+    // 将帧添加到空闲列表，并从替换器中移除，避免同一帧既在空闲列表又可被淘汰
     free_list_.push_back(frame_id);
-
-    // 通知替换器，该帧现在可以被替换
-    replacer_->unpin(frame_id);
+    replacer_->pin(frame_id);
 
     return true;
 }
@@ -310,3 +331,29 @@ void BufferPoolManager::flush_all_pages(int fd) {
         }
     }
 }
+
+/**
+ * @description: 关闭文件前把它的所有页写回磁盘并移出buffer_pool
+ * 文件关闭后fd会被新打开的文件重用，留在页表中的旧页会被误当作新文件的页
+ * @param {int} fd 文件句柄
+ */
+void BufferPoolManager::discard_all_pages(int fd) {
+    std::scoped_lock lock(latch_);
+
+    for (auto it = page_table_.begin(); it != page_table_.end();) {
+        Page* page = &pages_[it->second];
+        if (it->first.fd != fd || page->pin_count_ > 0) {
+            ++it;
+            continue;
+        }
+        if (page->is_dirty_) {
+            disk_manager_->write_page(fd, page->id_.page_no, page->get_data(), PAGE_SIZE);
+        }
+        page->reset_memory();
+        page->id_ = {.fd = -1, .page_no = INVALID_PAGE_ID};
+        page->is_dirty_ = false;
+        free_list_.push_back(it->second);
+        replacer_->pin(it->second);
+        it = page_table_.erase(it);
+    }
+}
@@ -12,6 +12,7 @@ See the Mulan PSL v2 for more details. */
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <atomic>
 #include <cassert>
 #include <list>
 #include <unordered_map>
@@ -34,6 +35,7 @@ class BufferPoolManager {
     DiskManager* disk_manager_;
     Replacer* replacer_;  // buffer_pool的置换策略，当前赛题中为LRU置换策略
     std::mutex latch_;    // 用于共享数据结构的并发控制
+    std::atomic<size_t> resident_frames_{0};  // 索引常驻页面占用的帧数，见reserve_resident()
 
    public:
     BufferPoolManager(size_t pool_size, DiskManager* disk_manager)
@@ -66,9 +68,33 @@ class BufferPoolManager {
      */
     static void mark_dirty(Page* page) { page->is_dirty_ = true; }
 
+    /**
+     * @description: 为长期pin住的常驻页面预留帧数，总数不超过缓冲池的1/BUFFER_POOL_RESIDENT_RATIO，
+     * 保证常驻页面不会挤占普通页面的帧。预留成功后调用者自行fetch_page并保持pin
+     * @return {bool} 是否预留成功
+     */
+    bool reserve_resident(size_t num_frames) {
+        size_t limit = pool_size_ / BUFFER_POOL_RESIDENT_RATIO;
+        size_t used = resident_frames_.load();
+        do {
+            if (used + num_frames > limit) {
+                return false;
+            }
+        } while (!resident_frames_.compare_exchange_weak(used, used + num_frames));
+        return true;
+    }
+
+    void release_resident(size_t num_frames) { resident_frames_ -= num_frames; }
+
+    size_t resident_frames() const { return resident_frames_; }
+
    public:
     Page* fetch_page(PageId page_id);
 
+    void prefetch_page(PageId page_id);
+
+    bool is_resident(PageId page_id);
+
     bool unpin_page(PageId page_id, bool is_dirty);
 
     bool flush_page(PageId page_id);
@@ -79,6 +105,8 @@ class BufferPoolManager {
 
     void flush_all_pages(int fd);
 
+    void discard_all_pages(int fd);
+
    private:
     bool find_victim_page(frame_id_t* frame_id);
 
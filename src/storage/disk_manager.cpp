@@ -47,6 +47,22 @@ void DiskManager::write_page(int fd, page_id_t page_no, const char *offset,
     }
 }
 
+/**
+ * @description: 把数据追加到文件末尾，同一个文件的追加由调用者串行化
+ * @param {int} fd 磁盘文件的文件句柄
+ * @param {char} *data 要追加的数据
+ * @param {int} size 要追加的数据大小
+ */
+void DiskManager::append_file(int fd, const char *data, int size) {
+    if (lseek(fd, 0, SEEK_END) == -1) {
+        throw InternalError("DiskManager::append_file Error: lseek failed");
+    }
+    ssize_t bytes_written = write(fd, data, size);
+    if (bytes_written != size) {
+        throw InternalError("DiskManager::append_file Error: write failed");
+    }
+}
+
 /**
  * @description: 读取文件中指定编号的页面中的部分数据到内存中
  * @param {int} fd 磁盘文件的文件句柄
@@ -75,6 +91,17 @@ void DiskManager::read_page(int fd, page_id_t page_no, char *offset,
     }
 }
 
+/**
+ * @description: 通知操作系统异步预读指定页面，调用立即返回，之后的read_page()可以直接命中页缓存
+ * 只是提示，失败时忽略
+ * @param {int} fd 磁盘文件的文件句柄
+ * @param {page_id_t} page_no 要预读的页面号
+ */
+void DiskManager::prefetch_page(int fd, page_id_t page_no) {
+    posix_fadvise(fd, static_cast<off_t>(page_no) * PAGE_SIZE, PAGE_SIZE,
+                  POSIX_FADV_WILLNEED);
+}
+
 /**
  * @description: 分配一个新的页号
  * @return {page_id_t} 分配的新页号
@@ -230,6 +257,21 @@ void DiskManager::close_file(int fd) {
     fd2path_.erase(fd);
 }
 
+/**
+ * @description: 将文件截断为num_pages个页面，并从num_pages开始重新分配页面号
+ * @param {int} fd 打开的文件的文件句柄
+ * @param {page_id_t} num_pages 截断后保留的页面个数
+ */
+void DiskManager::truncate_file(int fd, page_id_t num_pages) {
+    if (fd2path_.find(fd) == fd2path_.end()) {
+        throw FileNotOpenError(fd);
+    }
+    if (ftruncate(fd, (off_t)num_pages * PAGE_SIZE) < 0) {
+        throw UnixError();
+    }
+    fd2pageno_[fd] = num_pages;
+}
+
 /**
  * @description: 获得文件的大小
  * @return {int} 文件的大小
@@ -37,6 +37,10 @@ class DiskManager {
 
     void read_page(int fd, page_id_t page_no, char *offset, int num_bytes);
 
+    void append_file(int fd, const char *data, int size);
+
+    void prefetch_page(int fd, page_id_t page_no);
+
     page_id_t allocate_page(int fd);
 
     void deallocate_page(page_id_t page_id);
@@ -59,6 +63,8 @@ class DiskManager {
 
     void close_file(int fd);
 
+    void truncate_file(int fd, page_id_t num_pages);
+
     int get_file_size(const std::string &file_name);
 
     std::string get_file_name(int fd);
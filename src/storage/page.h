@@ -10,6 +10,8 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <shared_mutex>
+
 #include "common/config.h"
 
 /**
@@ -84,6 +86,17 @@ class Page {
         memcpy(get_data() + OFFSET_LSN, &page_lsn, sizeof(lsn_t));
     }
 
+    /** 页面读写锁，保护页面内容的并发访问（pin只保证页面不被换出） */
+    inline void wlatch() { rwlatch_.lock(); }
+
+    inline bool try_wlatch() { return rwlatch_.try_lock(); }
+
+    inline void wunlatch() { rwlatch_.unlock(); }
+
+    inline void rlatch() { rwlatch_.lock_shared(); }
+
+    inline void runlatch() { rwlatch_.unlock_shared(); }
+
    private:
     void reset_memory() {
         memset(data_, OFFSET_PAGE_START, PAGE_SIZE);
@@ -102,4 +115,7 @@ class Page {
 
     /** The pin count of this page. */
     int pin_count_ = 0;
+
+    /** 页面内容的读写锁 */
+    std::shared_mutex rwlatch_;
 };
\ No newline at end of file
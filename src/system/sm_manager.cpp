@@ -13,12 +13,61 @@ See the Mulan PSL v2 for more details. */
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <chrono>
 #include <fstream>
+#include <iostream>
+#include <thread>
 
 #include "index/ix.h"
 #include "record/rm.h"
 #include "record_printer.h"
 
+/**
+ * @description: 表中需要维护zone map的字段，目前只有定长数值字段
+ */
+static std::vector<RmZoneCol> get_zone_cols(const TabMeta& tab) {
+    std::vector<RmZoneCol> zone_cols;
+    for (auto& col : tab.cols) {
+        if (col.type == TYPE_INT || col.type == TYPE_FLOAT) {
+            zone_cols.push_back({.type = col.type, .offset = col.offset});
+        }
+    }
+    return zone_cols;
+}
+
+/**
+ * @description: 聚簇表的聚簇索引：索引字段为主键，其余字段按表中的顺序作为INCLUDE字段
+ * 主键不能重复列出同一个字段；主键和整条记录的长度由IxManager::create_index()检查
+ */
+static IndexMeta make_clustered_index(const TabMeta& tab, const std::vector<std::string>& key_names) {
+    IndexMeta index;
+    index.tab_name = tab.name;
+    index.col_num = key_names.size();
+    index.type = INDEX_BTREE;
+    index.clustered = true;
+    for (auto& name : key_names) {
+        auto col = std::find_if(tab.cols.begin(), tab.cols.end(),
+                                [&](const ColMeta& c) { return c.name == name; });
+        if (col == tab.cols.end()) {
+            throw ColumnNotFoundError(name);
+        }
+        if (index.covers(name)) {
+            throw InvalidTableOptionError("clustered by", name + " listed twice");
+        }
+        index.cols.push_back(*col);
+    }
+    for (auto& col : tab.cols) {
+        if (!index.covers(col.name)) {
+            index.include_cols.push_back(col);
+        }
+    }
+    index.col_tot_len = 0;
+    for (auto& col : index.entry_cols()) {
+        index.col_tot_len += col.len;
+    }
+    return index;
+}
+
 /**
  * @description: 判断是否为一个文件夹
  * @return {bool} 返回是否为一个文件夹
@@ -111,14 +160,47 @@ void SmManager::open_db(const std::string& db_name) {
     // 打开所有表文件
     for (auto& entry : db_.tabs_) {
         auto& tab = entry.second;
-        fhs_[tab.name] = rm_manager_->open_file(tab.name);
+        if (tab.engine == ENGINE_LSM) {
+            lhs_[tab.name] = rm_manager_->open_lsm_file(tab.name);
+        } else if (tab.engine == ENGINE_HEAP) {
+            fhs_[tab.name] = rm_manager_->open_file(tab.name, get_zone_cols(tab));
+        } else if (tab.engine == ENGINE_MEMORY) {
+            mhs_[tab.name] = rm_manager_->open_mem_file(tab.name);
+        }
+        // 不保存内容的内存表重新打开后是空表，它的索引也重建为空索引
+        bool reset_indexes = tab.engine == ENGINE_MEMORY && !mhs_.at(tab.name)->durable();
 
         // 打开该表的所有索引
         for (auto& index : tab.indexes) {
             // 使用正确的方式获取索引名称并打开索引
             std::string index_name =
                 ix_manager_->get_index_name(tab.name, index.cols);
-            ihs_[index_name] = ix_manager_->open_index(tab.name, index.cols);
+            if (reset_indexes) {
+                ix_manager_->destroy_index(tab.name, index.cols);
+                if (index.type == INDEX_HASH) {
+                    ix_manager_->create_hash_index(tab.name, index.cols);
+                } else if (index.type == INDEX_BITMAP) {
+                    ix_manager_->create_bitmap_index(tab.name, index.cols);
+                } else {
+                    ix_manager_->create_index(tab.name, index.cols, index.include_cols);
+                }
+            }
+            if (index.type == INDEX_HASH) {
+                hhs_[index_name] =
+                    ix_manager_->open_hash_index(tab.name, index.cols);
+            } else if (index.type == INDEX_BITMAP) {
+                bhs_[index_name] =
+                    ix_manager_->open_bitmap_index(tab.name, index.cols);
+            } else {
+                ihs_[index_name] = ix_manager_->open_index(tab.name, index.cols);
+                if (index.buffers_changes()) {
+                    ihs_[index_name]->enable_change_buffer();
+                }
+            }
+        }
+        // 聚簇表没有数据文件，记录存放在聚簇索引中
+        if (tab.engine == ENGINE_CLUSTERED) {
+            open_clustered_table(tab);
         }
     }
 
@@ -151,14 +233,31 @@ void SmManager::close_db() {
     for (auto& [_, file_handle] : fhs_) {
         rm_manager_->close_file(file_handle.get());
     }
+    for (auto& [_, table_handle] : lhs_) {
+        rm_manager_->close_lsm_file(table_handle.get());
+    }
+    for (auto& [_, table_handle] : mhs_) {
+        rm_manager_->close_mem_file(table_handle.get());
+    }
+    chs_.clear();  // 聚簇表的记录随聚簇索引一起落盘
 
     // 索引文件落盘
     for (auto& [_, index_handle] : ihs_) {
         ix_manager_->close_index(index_handle.get());
     }
+    for (auto& [_, index_handle] : hhs_) {
+        ix_manager_->close_index(index_handle.get());
+    }
+    for (auto& [_, index_handle] : bhs_) {
+        ix_manager_->close_index(index_handle.get());
+    }
 
     fhs_.clear();
+    lhs_.clear();
+    mhs_.clear();
     ihs_.clear();
+    hhs_.clear();
+    bhs_.clear();
 
     if (chdir("..") < 0) {  // 返回上一级目录
         throw UnixError();
@@ -216,10 +315,11 @@ void SmManager::desc_table(const std::string& tab_name, Context* context) {
  * @param {string&} tab_name 表的名称
  * @param {vector<ColDef>&} col_defs 表的字段
  * @param {Context*} context
+ * @param {TabOptions&} options 表的存储选项
  */
 void SmManager::create_table(const std::string& tab_name,
                              const std::vector<ColDef>& col_defs,
-                             Context* context) {
+                             Context* context, const TabOptions& options) {
     if (db_.is_table(tab_name)) {
         throw TableExistsError(tab_name);
     }
@@ -241,10 +341,33 @@ void SmManager::create_table(const std::string& tab_name,
     int record_size =
         curr_offset;  // record_size就是col
                       // meta所占的大小（表的元数据也是以记录的形式进行存储的）
-    rm_manager_->create_file(tab_name, record_size);
+    std::vector<int> col_lens;
+    for (auto& col : tab.cols) {
+        col_lens.push_back(col.len);
+    }
+    tab.engine = options.engine;
+    if (tab.engine == ENGINE_CLUSTERED) {
+        tab.indexes.push_back(make_clustered_index(tab, options.cluster_cols));
+        IndexMeta& index = tab.indexes.back();
+        ix_manager_->create_index(tab_name, index.cols, index.include_cols);
+        ix_manager_->create_index(tab_name, ix_clustered_row_cols(tab_name), index.cols);
+        ihs_[ix_manager_->get_index_name(tab_name, index.cols)] =
+            ix_manager_->open_index(tab_name, index.cols);
+        open_clustered_table(tab);
+    } else if (tab.engine == ENGINE_LSM) {
+        // LSM表的记录整条存放，不区分页面布局
+        rm_manager_->create_lsm_file(tab_name, record_size);
+        lhs_.emplace(tab_name, rm_manager_->open_lsm_file(tab_name));
+    } else if (tab.engine == ENGINE_MEMORY) {
+        // 内存表的记录整条存放在内存数组中，不区分页面布局
+        rm_manager_->create_mem_file(tab_name, record_size, options.durable);
+        mhs_.emplace(tab_name, rm_manager_->open_mem_file(tab_name));
+    } else {
+        rm_manager_->create_file(tab_name, record_size, options.layout, col_lens);
+        // fhs_[tab_name] = rm_manager_->open_file(tab_name);
+        fhs_.emplace(tab_name, rm_manager_->open_file(tab_name, get_zone_cols(tab)));
+    }
     db_.tabs_[tab_name] = tab;
-    // fhs_[tab_name] = rm_manager_->open_file(tab_name);
-    fhs_.emplace(tab_name, rm_manager_->open_file(tab_name));
 
     flush_meta();
 }
@@ -263,6 +386,9 @@ void SmManager::drop_table(const std::string& tab_name, Context* context) {
     // 获取表的元数据
     TabMeta& tab = db_.get_table(tab_name);
 
+    // 聚簇表的记录随聚簇索引一起删除，先释放表句柄
+    chs_.erase(tab_name);
+
     // 删除表的所有索引
     for (auto& index : tab.indexes) {
         // 获取索引名
@@ -270,23 +396,37 @@ void SmManager::drop_table(const std::string& tab_name, Context* context) {
             ix_manager_->get_index_name(tab_name, index.cols);
 
         // 关闭并移除索引句柄
-        if (ihs_.count(index_name) > 0) {
-            ix_manager_->close_index(ihs_[index_name].get());
-            ihs_.erase(index_name);
-        }
+        close_index_handle(index_name);
 
         // 删除索引文件
         ix_manager_->destroy_index(tab_name, index.cols);
     }
-
-    // 关闭表文件
-    if (fhs_.count(tab_name) > 0) {
-        rm_manager_->close_file(fhs_[tab_name].get());
-        fhs_.erase(tab_name);
+    if (tab.engine == ENGINE_CLUSTERED) {
+        auto row_cols = ix_clustered_row_cols(tab_name);
+        close_index_handle(ix_manager_->get_index_name(tab_name, row_cols));
+        ix_manager_->destroy_index(tab_name, row_cols);
     }
 
-    // 删除表文件
-    rm_manager_->destroy_file(tab_name);
+    // 关闭并删除表文件
+    if (tab.engine == ENGINE_LSM) {
+        if (lhs_.count(tab_name) > 0) {
+            rm_manager_->close_lsm_file(lhs_[tab_name].get());
+            lhs_.erase(tab_name);
+        }
+        rm_manager_->destroy_lsm_file(tab_name);
+    } else if (tab.engine == ENGINE_MEMORY) {
+        if (mhs_.count(tab_name) > 0) {
+            rm_manager_->close_mem_file(mhs_[tab_name].get());
+            mhs_.erase(tab_name);
+        }
+        rm_manager_->destroy_mem_file(tab_name);
+    } else if (tab.engine == ENGINE_HEAP) {
+        if (fhs_.count(tab_name) > 0) {
+            rm_manager_->close_file(fhs_[tab_name].get());
+            fhs_.erase(tab_name);
+        }
+        rm_manager_->destroy_file(tab_name);
+    }
 
     // 从数据库元数据中删除表
     db_.tabs_.erase(tab_name);
@@ -295,15 +435,73 @@ void SmManager::drop_table(const std::string& tab_name, Context* context) {
     flush_meta();
 }
 
+/**
+ * @description: 压缩表的数据文件，回收删除记录后留下的空间
+ * @param {string&} tab_name 表的名称
+ * @param {Context*} context
+ * 记录搬迁到新位置后，依次修正表上每个索引中指向该记录的索引项
+ */
+void SmManager::vacuum_table(const std::string& tab_name, Context* context) {
+    if (!db_.is_table(tab_name)) {
+        throw TableNotFoundError(tab_name);
+    }
+    TabMeta& tab = db_.get_table(tab_name);
+    Transaction* txn = context == nullptr ? nullptr : context->txn_;
+
+    // LSM表的行号不变，回收空间就是把所有层合并成一层并丢弃删除标记和旧版本，索引不受影响
+    if (tab.engine == ENGINE_LSM) {
+        lhs_.at(tab_name)->compact_all();
+        return;
+    }
+    // 聚簇表按主键顺序重建聚簇索引、按行号顺序重建行号索引，回收删除留下的空闲页面和半空的结点；
+    // 记录的Rid存放在索引项中不变，二级索引不受影响
+    if (tab.engine == ENGINE_CLUSTERED) {
+        const IndexMeta* index = tab.clustered_index();
+        chs_.erase(tab_name);
+        rebuild_btree_index(tab_name, index->cols, index->include_cols);
+        rebuild_btree_index(tab_name, ix_clustered_row_cols(tab_name), index->cols);
+        open_clustered_table(tab);
+        return;
+    }
+
+    std::vector<char> key;
+    auto on_move = [&](const Rid& old_rid, const Rid& new_rid, const RmRecord& record) {
+        for (auto& index : tab.indexes) {
+            key.resize(index.col_tot_len);
+            index.extract_key(record.data, key.data());
+            delete_index_entry(index, key.data(), old_rid, txn);
+            insert_index_entry(index, key.data(), new_rid, txn);
+        }
+    };
+    // 内存表把尾部块中的记录搬到前部的空槽位，与堆表一样修正索引
+    if (tab.engine == ENGINE_MEMORY) {
+        mhs_.at(tab_name)->vacuum(on_move);
+    } else {
+        fhs_.at(tab_name)->vacuum(on_move);
+    }
+    // 搬迁的记录在B+树索引中重新插入，布隆过滤器的键数超过容量时按现有的键重建
+    for (auto& index : tab.indexes) {
+        if (index.type == INDEX_BTREE) {
+            auto& ih = ihs_.at(ix_manager_->get_index_name(tab_name, index.cols));
+            if (ih->bloom_filter_full()) {
+                ih->rebuild_bloom_filter();
+            }
+        }
+    }
+}
+
 /**
  * @description: 创建索引
  * @param {string&} tab_name 表的名称
  * @param {vector<string>&} col_names 索引包含的字段名称
  * @param {Context*} context
+ * @param {IndexType} type 索引的组织方式
+ * @param {vector<string>&} include_col_names INCLUDE字段，只存放在索引项中，不参与索引的匹配
  */
 void SmManager::create_index(const std::string& tab_name,
                              const std::vector<std::string>& col_names,
-                             Context* context) {
+                             Context* context, IndexType type,
+                             const std::vector<std::string>& include_col_names) {
     // 检查表是否存在
     if (!db_.is_table(tab_name)) {
         throw TableNotFoundError(tab_name);
@@ -318,66 +516,235 @@ void SmManager::create_index(const std::string& tab_name,
     }
 
     // 收集索引列的元数据
-    std::vector<ColMeta> idx_cols;
-    for (const auto& col_name : col_names) {
-        auto it = std::find_if(
-            tab.cols.begin(), tab.cols.end(),
-            [&](const ColMeta& col) { return col.name == col_name; });
-        if (it == tab.cols.end()) {
-            throw ColumnNotFoundError(
-                col_name);  // 修正这里，只传递col_name参数
+    auto find_cols = [&](const std::vector<std::string>& names) {
+        std::vector<ColMeta> cols;
+        for (const auto& col_name : names) {
+            auto it = std::find_if(
+                tab.cols.begin(), tab.cols.end(),
+                [&](const ColMeta& col) { return col.name == col_name; });
+            if (it == tab.cols.end()) {
+                throw ColumnNotFoundError(
+                    col_name);  // 修正这里，只传递col_name参数
+            }
+            cols.push_back(*it);
+        }
+        return cols;
+    };
+    std::vector<ColMeta> idx_cols = find_cols(col_names);
+    std::vector<ColMeta> include_cols = find_cols(include_col_names);
+    if (!include_cols.empty() && type == INDEX_HASH) {
+        throw InvalidIndexOptionError("hash index does not support INCLUDE");
+    }
+    if (!include_cols.empty() && type == INDEX_BITMAP) {
+        throw InvalidIndexOptionError("bitmap index does not support INCLUDE");
+    }
+    // 聚簇表的二级B+树索引把主键中不在索引字段里的字段追加到键的末尾：索引字段相同的记录按主键区分，
+    // 每条记录都有自己的索引项，按二级索引找到的记录直接按主键回表
+    int pk_col_num = 0;
+    if (type == INDEX_BTREE && tab.engine == ENGINE_CLUSTERED) {
+        for (auto& col : tab.clustered_index()->cols) {
+            auto same = [&](const ColMeta& c) { return c.name == col.name; };
+            if (std::none_of(idx_cols.begin(), idx_cols.end(), same)) {
+                include_cols.erase(std::remove_if(include_cols.begin(), include_cols.end(), same),
+                                   include_cols.end());
+                idx_cols.push_back(col);
+                pk_col_num++;
+            }
+        }
+        // 追加主键后与已有的索引字段相同，两者是同一个索引
+        std::vector<std::string> key_names;
+        for (auto& col : idx_cols) {
+            key_names.push_back(col.name);
+        }
+        if (tab.is_index(key_names)) {
+            throw IndexExistsError(tab_name, col_names);
         }
-        idx_cols.push_back(*it);
-    }
-
-    // 计算索引列总长度
-    int col_tot_len = 0;
-    for (auto& col : idx_cols) {
-        col_tot_len += col.len;
     }
 
     // 创建索引元数据
     IndexMeta idx_meta;
     idx_meta.tab_name = tab_name;
-    idx_meta.col_tot_len = col_tot_len;
     idx_meta.col_num = idx_cols.size();
+    idx_meta.type = type;
     idx_meta.cols = idx_cols;
+    idx_meta.include_cols = include_cols;
+    idx_meta.pk_col_num = pk_col_num;
+
+    // 计算索引项的键的总长度
+    idx_meta.col_tot_len = 0;
+    for (auto& col : idx_meta.entry_cols()) {
+        idx_meta.col_tot_len += col.len;
+    }
+    int col_tot_len = idx_meta.col_tot_len;
 
     // 将索引元数据添加到表元数据中
     tab.indexes.push_back(idx_meta);
 
-    // 创建索引文件
-    ix_manager_->create_index(tab_name, idx_cols);
-
-    // 打开索引文件
+    // 创建并打开索引文件，将索引文件句柄添加到映射中
     std::string index_name = ix_manager_->get_index_name(tab_name, idx_cols);
-    auto ih = ix_manager_->open_index(tab_name, idx_cols);
-
-    // 将索引文件句柄添加到映射中
-    ihs_[index_name] = std::move(ih);
-
-    // 获取表文件句柄
-    auto file_handle = fhs_[tab_name].get();
-
-    // 为表中的每条记录建立索引
-    for (RmScan scan(file_handle); !scan.is_end(); scan.next()) {
-        auto record = file_handle->get_record(scan.rid(), context);
-
-        // 构建索引键
-        char* key = new char[col_tot_len];
-        int offset = 0;
+    IxHashIndexHandle* hash_handle = nullptr;
+    IxBitmapIndexHandle* bitmap_handle = nullptr;
+    if (type == INDEX_HASH) {
+        ix_manager_->create_hash_index(tab_name, idx_cols);
+        hhs_[index_name] = ix_manager_->open_hash_index(tab_name, idx_cols);
+        hash_handle = hhs_[index_name].get();
+    } else if (type == INDEX_BITMAP) {
+        ix_manager_->create_bitmap_index(tab_name, idx_cols);
+        bhs_[index_name] = ix_manager_->open_bitmap_index(tab_name, idx_cols);
+        bitmap_handle = bhs_[index_name].get();
+    } else {
+        ix_manager_->create_index(tab_name, idx_cols, include_cols);
+        ihs_[index_name] = ix_manager_->open_index(tab_name, idx_cols);
+    }
+
+    // 扫描表抽取(key, rid)，外部排序后自底向上批量构建索引
+    // 各工作线程扫描表中互不相交的页面区间并各自排序，最后归并后交给建树过程；
+    // 哈希索引和位图索引支持并发插入，各工作线程直接把抽取的项插入索引，不需要排序
+    RmTableHandle* file_handle = get_table_handle(tab_name);
+    std::vector<ColType> col_types;
+    std::vector<int> col_lens;
+    std::vector<int> fields;  // 索引列在表中的下标，只读取这些字段
+    for (auto& col : idx_meta.entry_cols()) {
+        col_types.push_back(col.type);
+        col_lens.push_back(col.len);
+        fields.push_back(tab.get_col(col.name) - tab.cols.begin());
+    }
+    int num_data_pages =
+        std::max(file_handle->num_pages() - RM_FIRST_RECORD_PAGE, 0);
+    int workers = context != nullptr && context->session_ != nullptr
+                      ? context->session_->index_build_workers
+                      : 1;
+    workers = std::max(1, std::min(workers, num_data_pages));
+
+    auto start = std::chrono::steady_clock::now();
+    auto sorted = start;
+    std::vector<std::unique_ptr<IxExternalSorter>> sorters;
+    bool build_by_insert = hash_handle != nullptr || bitmap_handle != nullptr;
+    std::vector<size_t> inserted_entries(workers, 0);
+    Transaction* txn = context == nullptr ? nullptr : context->txn_;
+    // 唯一索引遇到重复的键时建索引失败，删除已经建了一半的索引
+    try {
+        for (int i = 0; !build_by_insert && i < workers; i++) {
+            sorters.push_back(std::make_unique<IxExternalSorter>(
+                disk_manager_, index_name + ".sort" + std::to_string(i), col_types,
+                col_lens, IX_SORT_MEMORY_SIZE / workers));
+        }
+        auto scan_range = [&](int worker) {
+            int begin = RM_FIRST_RECORD_PAGE +
+                        (long long)num_data_pages * worker / workers;
+            int end = RM_FIRST_RECORD_PAGE +
+                      (long long)num_data_pages * (worker + 1) / workers;
+            IxExternalSorter* sorter =
+                build_by_insert ? nullptr : sorters[worker].get();
+            std::vector<char> key(col_tot_len);
+            for (auto scan = file_handle->scan(nullptr, begin, end); !scan->is_end();
+                 scan->next()) {
+                std::unique_ptr<RmRecord> record;
+                const char* data = scan->record();
+                if (data == nullptr) {
+                    record = file_handle->get_record(scan->rid(), fields, context);
+                    data = record->data;
+                }
+                idx_meta.extract_key(data, key.data());
+                if (hash_handle != nullptr) {
+                    if (!hash_handle->insert_entry(key.data(), scan->rid(), txn)) {
+                        throw DuplicateKeyError(tab_name);
+                    }
+                    inserted_entries[worker]++;
+                } else if (bitmap_handle != nullptr) {
+                    inserted_entries[worker] += bitmap_handle->insert_entry(
+                        key.data(), scan->rid(), txn);
+                } else {
+                    sorter->add(key.data(), scan->rid());
+                }
+            }
+            if (sorter != nullptr) {
+                sorter->finish();
+            }
+        };
+        if (workers == 1) {
+            scan_range(0);
+        } else {
+            std::vector<std::thread> threads;
+            std::vector<std::exception_ptr> errors(workers);
+            for (int i = 0; i < workers; i++) {
+                threads.emplace_back([&, i] {
+                    try {
+                        scan_range(i);
+                    } catch (...) {
+                        errors[i] = std::current_exception();
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            for (auto& error : errors) {
+                if (error != nullptr) {
+                    std::rethrow_exception(error);
+                }
+            }
+        }
+        sorted = std::chrono::steady_clock::now();
+
+        if (build_by_insert) {
+            // 哈希索引和位图索引在扫描时已经建好
+        } else if (workers == 1) {
+            if (!ihs_[index_name]->bulk_load([&](char* key, Rid* rid) {
+                    return sorters[0]->next(key, rid);
+                })) {
+                throw DuplicateKeyError(tab_name);
+            }
+        } else {
+            std::vector<IxExternalSorter*> inputs;
+            for (auto& sorter : sorters) {
+                inputs.push_back(sorter.get());
+            }
+            IxParallelMerger merger(inputs);
+            if (!ihs_[index_name]->bulk_load(
+                    [&](char* key, Rid* rid) { return merger.next(key, rid); })) {
+                throw DuplicateKeyError(tab_name);
+            }
+        }
+    } catch (...) {
+        sorters.clear();
+        drop_index(tab_name, idx_cols, context);
+        throw;
+    }
+
+    // B+树索引建好后按索引字段生成布隆过滤器，点查找和删除不存在的键时不必访问页面
+    int bloom_bits = context != nullptr && context->session_ != nullptr
+                         ? context->session_->index_bloom_bits
+                         : SessionSettings().index_bloom_bits;
+    if (type == INDEX_BTREE && bloom_bits > 0) {
+        int key_len = 0;
         for (auto& col : idx_cols) {
-            memcpy(key + offset, record->data + col.offset, col.len);
-            offset += col.len;
+            key_len += col.len;
         }
+        ihs_[index_name]->build_bloom_filter(key_len, bloom_bits);
+    }
+    // 建好之后的插入和删除目标叶结点不在缓冲池中时先缓存，见IxIndexHandle::enable_change_buffer()
+    if (idx_meta.buffers_changes()) {
+        ihs_[index_name]->enable_change_buffer();
+    }
+    auto loaded = std::chrono::steady_clock::now();
 
-        // 插入索引
-        ihs_[index_name]->insert_entry(key, scan.rid(), context->txn_);
-
-        delete[] key;
+    // 记录各阶段的耗时，通过last_index_build_查看
+    last_index_build_ = IndexBuildStats();
+    last_index_build_.workers = workers;
+    for (auto& sorter : sorters) {
+        last_index_build_.num_entries += sorter->size();
+        last_index_build_.num_runs += sorter->num_runs();
+    }
+    for (size_t n : inserted_entries) {
+        last_index_build_.num_entries += n;
     }
+    last_index_build_.scan_sort_ms =
+        std::chrono::duration<double, std::milli>(sorted - start).count();
+    last_index_build_.merge_load_ms =
+        std::chrono::duration<double, std::milli>(loaded - sorted).count();
 
-    // 更新列的索引标志
+    // 更新列的索引标志，追加的主键字段不算
     for (auto& col_name : col_names) {
         auto it =
             std::find_if(tab.cols.begin(), tab.cols.end(),
@@ -389,6 +756,145 @@ void SmManager::create_index(const std::string& tab_name,
     flush_meta();
 }
 
+/**
+ * @description: 关闭索引文件并移除其句柄，B+树索引、哈希索引和位图索引都可以
+ */
+void SmManager::close_index_handle(const std::string& index_name) {
+    if (ihs_.count(index_name) > 0) {
+        ix_manager_->close_index(ihs_[index_name].get());
+        ihs_.erase(index_name);
+    }
+    if (hhs_.count(index_name) > 0) {
+        ix_manager_->close_index(hhs_[index_name].get());
+        hhs_.erase(index_name);
+    }
+    if (bhs_.count(index_name) > 0) {
+        ix_manager_->close_index(bhs_[index_name].get());
+        bhs_.erase(index_name);
+    }
+}
+
+/**
+ * @description: 打开聚簇表的行号索引并建立表句柄，聚簇索引已经打开
+ */
+void SmManager::open_clustered_table(const TabMeta& tab) {
+    const IndexMeta* index = tab.clustered_index();
+    auto row_cols = ix_clustered_row_cols(tab.name);
+    std::string row_name = ix_manager_->get_index_name(tab.name, row_cols);
+    if (ihs_.count(row_name) == 0) {
+        ihs_[row_name] = ix_manager_->open_index(tab.name, row_cols);
+    }
+    chs_[tab.name] = std::make_unique<IxClusteredTableHandle>(
+        ihs_.at(ix_manager_->get_index_name(tab.name, index->cols)).get(),
+        ihs_.at(row_name).get(), buffer_pool_manager_, *index);
+}
+
+/**
+ * @description: 把B+树索引的全部索引项按键的顺序批量装入一个新文件，再替换原来的索引文件，
+ * 新文件中没有空闲页面，结点按IX_BULK_LOAD_FILL_FACTOR装满；索引项的rid不变
+ */
+void SmManager::rebuild_btree_index(const std::string& tab_name, const std::vector<ColMeta>& cols,
+                                    const std::vector<ColMeta>& include_cols) {
+    std::string index_name = ix_manager_->get_index_name(tab_name, cols);
+    std::string tmp_tab_name = tab_name + ".vacuum";
+    ix_manager_->create_index(tmp_tab_name, cols, include_cols);
+    auto rebuilt = ix_manager_->open_index(tmp_tab_name, cols);
+    {
+        IxIndexHandle* ih = ihs_.at(index_name).get();
+        int entry_len = 0;
+        for (auto* group : {&cols, &include_cols}) {
+            for (auto& col : *group) {
+                entry_len += col.len;
+            }
+        }
+        IxScan scan(ih, nullptr, nullptr, buffer_pool_manager_, true);
+        std::vector<Rid> rids;
+        std::vector<char> entries;
+        size_t pos = 0;
+        rebuilt->bulk_load([&](char* key, Rid* rid) {
+            if (pos == rids.size()) {
+                rids.clear();
+                entries.clear();
+                pos = 0;
+                while (rids.empty() && !scan.is_end()) {
+                    scan.next_batch(&rids, &entries);
+                }
+                if (rids.empty()) {
+                    return false;
+                }
+            }
+            memcpy(key, entries.data() + pos * entry_len, entry_len);
+            *rid = rids[pos++];
+            return true;
+        });
+    }
+    ix_manager_->close_index(rebuilt.get());
+    close_index_handle(index_name);
+    ix_manager_->destroy_index(tab_name, cols);
+    if (std::rename(ix_manager_->get_index_name(tmp_tab_name, cols).c_str(), index_name.c_str()) != 0) {
+        throw UnixError();
+    }
+    ihs_[index_name] = ix_manager_->open_index(tab_name, cols);
+}
+
+/**
+ * @description: 向索引中插入一项，根据索引的组织方式选择索引句柄
+ */
+void SmManager::insert_index_entry(const IndexMeta& index, const char* key,
+                                   const Rid& rid, Transaction* txn) {
+    if (index.clustered) {
+        return;  // 聚簇索引由表句柄随记录一起维护
+    }
+    std::string index_name =
+        ix_manager_->get_index_name(index.tab_name, index.cols);
+    if (index.type == INDEX_HASH) {
+        hhs_.at(index_name)->insert_entry(key, rid, txn);
+    } else if (index.type == INDEX_BITMAP) {
+        bhs_.at(index_name)->insert_entry(key, rid, txn);
+    } else {
+        ihs_.at(index_name)->insert_entry(key, rid, txn);
+    }
+}
+
+/**
+ * @description: 检查唯一索引中是否已经有键key，有时抛出DuplicateKeyError
+ */
+void SmManager::check_unique(const IndexMeta& index, const char* key,
+                             Transaction* txn) {
+    if (!index.unique()) {
+        return;
+    }
+    std::string index_name =
+        ix_manager_->get_index_name(index.tab_name, index.cols);
+    std::vector<Rid> rids;
+    bool found = index.type == INDEX_HASH
+                     ? hhs_.at(index_name)->get_value(key, &rids, txn)
+                     : ihs_.at(index_name)->get_value(key, &rids, txn);
+    if (found) {
+        throw DuplicateKeyError(index.tab_name);
+    }
+}
+
+/**
+ * @description: 从索引中删除一项，根据索引的组织方式选择索引句柄
+ * B+树索引和哈希索引的键不重复(见IndexMeta::unique())，只按key删除；位图索引只从key的位图中去掉rid
+ */
+void SmManager::delete_index_entry(const IndexMeta& index, const char* key,
+                                   const Rid& rid, Transaction* txn) {
+    if (index.clustered) {
+        return;
+    }
+    std::string index_name =
+        ix_manager_->get_index_name(index.tab_name, index.cols);
+    if (index.type == INDEX_HASH) {
+        hhs_.at(index_name)->delete_entry(key, txn);
+    } else if (index.type == INDEX_BITMAP) {
+        bhs_.at(index_name)->delete_entry(key, rid, txn);
+    } else {
+        ihs_.at(index_name)->delete_entry(key, txn);
+    }
+}
+
 /**
  * @description: 删除索引
  * @param {string&} tab_name 表名称
@@ -434,19 +940,25 @@ void SmManager::drop_index(const std::string& tab_name,
     // 获取表元数据
     TabMeta& tab = db_.get_table(tab_name);
 
+    // 聚簇索引就是表本身，只能随表删除
+    const IndexMeta* clustered = tab.clustered_index();
+    if (clustered != nullptr &&
+        ix_manager_->get_index_name(tab_name, clustered->cols) ==
+            ix_manager_->get_index_name(tab_name, cols)) {
+        throw InvalidIndexOptionError("cannot drop the clustering index of " + tab_name);
+    }
+
     // 获取索引名称
     std::string index_name = ix_manager_->get_index_name(tab_name, cols);
 
     // 关闭索引文件
-    if (ihs_.count(index_name) > 0) {
-        ix_manager_->close_index(ihs_[index_name].get());
-        ihs_.erase(index_name);
-    }
+    close_index_handle(index_name);
 
     // 删除索引文件
     ix_manager_->destroy_index(tab_name, cols);
 
-    // 查找并删除索引元数据
+    // 查找并删除索引元数据，cols是包括追加的主键在内的全部键字段
+    size_t declared_num = cols.size();
     for (auto it = tab.indexes.begin(); it != tab.indexes.end(); ++it) {
         if (it->col_num == cols.size()) {
             bool match = true;
@@ -457,16 +969,17 @@ void SmManager::drop_index(const std::string& tab_name,
                 }
             }
             if (match) {
+                declared_num -= it->pk_col_num;
                 tab.indexes.erase(it);
                 break;
             }
         }
     }
 
-    // 更新列的索引标志
-    for (const auto& col : cols) {
+    // 更新列的索引标志，追加的主键字段不算
+    for (size_t i = 0; i < declared_num; i++) {
         auto it = std::find_if(tab.cols.begin(), tab.cols.end(),
-                               [&](ColMeta& c) { return c.name == col.name; });
+                               [&](ColMeta& c) { return c.name == cols[i].name; });
         if (it != tab.cols.end()) {
             it->index = false;
         }
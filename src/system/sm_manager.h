@@ -13,6 +13,8 @@ See the Mulan PSL v2 for more details. */
 #include "common/context.h"
 #include "index/ix.h"
 #include "record/rm_file_handle.h"
+#include "record/rm_lsm_table.h"
+#include "record/rm_mem_table.h"
 #include "sm_defs.h"
 #include "sm_meta.h"
 
@@ -24,14 +26,42 @@ struct ColDef {
     int len;           // Length of column
 };
 
+/* 建表时通过 name = value 指定的表选项 */
+struct TabOptions {
+    int layout = RM_LAYOUT_ROW;         // 数据文件的页面布局，storage = row | pax
+    TableEngine engine = ENGINE_HEAP;  // 存储引擎，engine = heap | lsm | memory，CLUSTERED BY时为聚簇表
+    bool durable = true;  // 内存表是否保存表的内容，durability = wal | none
+    std::vector<std::string> cluster_cols;  // 聚簇表的主键字段，CLUSTERED BY (cols)
+};
+
+/* 最近一次CREATE INDEX各阶段的统计信息 */
+struct IndexBuildStats {
+    int workers = 0;           // 扫描和排序的工作线程数
+    size_t num_entries = 0;    // 抽取的(key, rid)项数
+    int num_runs = 0;          // 各线程写出的有序段文件总数
+    double scan_sort_ms = 0;   // 并行扫描表并排序的耗时
+    double merge_load_ms = 0;  // 归并并自底向上建树的耗时
+};
+
 /* 系统管理器，负责元数据管理和DDL语句的执行 */
 class SmManager {
    public:
     DbMeta db_;  // 当前打开的数据库的元数据
     std::unordered_map<std::string, std::unique_ptr<RmFileHandle>>
-        fhs_;  // file name -> record file handle, 当前数据库中每张表的数据文件
+        fhs_;  // file name -> record file handle, 当前数据库中每张堆表的数据文件
+    std::unordered_map<std::string, std::unique_ptr<RmLsmTableHandle>>
+        lhs_;  // file name -> lsm table handle, 当前数据库中每张LSM表
+    std::unordered_map<std::string, std::unique_ptr<RmMemTableHandle>>
+        mhs_;  // file name -> memory table handle, 当前数据库中每张内存表
+    std::unordered_map<std::string, std::unique_ptr<IxClusteredTableHandle>>
+        chs_;  // table name -> clustered table handle, 当前数据库中每张聚簇表，记录存放在聚簇索引中
     std::unordered_map<std::string, std::unique_ptr<IxIndexHandle>>
         ihs_;  // file name -> index file handle, 当前数据库中每个索引的文件
+    std::unordered_map<std::string, std::unique_ptr<IxHashIndexHandle>>
+        hhs_;  // file name -> hash index handle, 当前数据库中每个哈希索引的文件
+    std::unordered_map<std::string, std::unique_ptr<IxBitmapIndexHandle>>
+        bhs_;  // file name -> bitmap index handle, 当前数据库中每个位图索引的文件
+    IndexBuildStats last_index_build_;  // 最近一次建索引的统计信息
    private:
     DiskManager* disk_manager_;
     BufferPoolManager* buffer_pool_manager_;
@@ -54,6 +84,23 @@ class SmManager {
 
     IxManager* get_ix_manager() { return ix_manager_; }
 
+    // 表的记录存取接口，不区分存储引擎
+    RmTableHandle* get_table_handle(const std::string& tab_name) {
+        auto it = fhs_.find(tab_name);
+        if (it != fhs_.end()) {
+            return it->second.get();
+        }
+        auto ct = chs_.find(tab_name);
+        if (ct != chs_.end()) {
+            return ct->second.get();
+        }
+        auto mt = mhs_.find(tab_name);
+        if (mt != mhs_.end()) {
+            return mt->second.get();
+        }
+        return lhs_.at(tab_name).get();
+    }
+
     bool is_dir(const std::string& db_name);
 
     void create_db(const std::string& db_name);
@@ -71,13 +118,17 @@ class SmManager {
     void desc_table(const std::string& tab_name, Context* context);
 
     void create_table(const std::string& tab_name,
-                      const std::vector<ColDef>& col_defs, Context* context);
+                      const std::vector<ColDef>& col_defs, Context* context,
+                      const TabOptions& options = TabOptions());
 
     void drop_table(const std::string& tab_name, Context* context);
 
+    void vacuum_table(const std::string& tab_name, Context* context);
+
     void create_index(const std::string& tab_name,
                       const std::vector<std::string>& col_names,
-                      Context* context);
+                      Context* context, IndexType type = INDEX_BTREE,
+                      const std::vector<std::string>& include_col_names = {});
 
     void drop_index(const std::string& tab_name,
                     const std::vector<std::string>& col_names,
@@ -85,4 +136,24 @@ class SmManager {
 
     void drop_index(const std::string& tab_name,
                     const std::vector<ColMeta>& col_names, Context* context);
+
+    // 按索引的组织方式插入/删除索引项，key是按索引字段顺序拼接的原始键；
+    // 位图索引的键可以重复，删除时还要用rid确定是哪一项；
+    // 唯一索引(IndexMeta::unique())的插入由调用者先用check_unique()检查
+    void insert_index_entry(const IndexMeta& index, const char* key,
+                            const Rid& rid, Transaction* txn);
+
+    void delete_index_entry(const IndexMeta& index, const char* key,
+                            const Rid& rid, Transaction* txn);
+
+    // 唯一索引中已经有键key时抛出DuplicateKeyError，其余索引不检查
+    void check_unique(const IndexMeta& index, const char* key, Transaction* txn);
+
+   private:
+    void close_index_handle(const std::string& index_name);
+
+    void open_clustered_table(const TabMeta& tab);
+
+    void rebuild_btree_index(const std::string& tab_name, const std::vector<ColMeta>& cols,
+                             const std::vector<ColMeta>& include_cols);
 };
\ No newline at end of file
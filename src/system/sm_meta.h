@@ -40,36 +40,124 @@ struct ColMeta {
     }
 };
 
-/* 索引元数据 */
+/* 索引的组织方式 */
+// B+树；可扩展哈希，只支持等值查找；位图，键可以重复，适合取值种类很少的字段
+enum IndexType { INDEX_BTREE, INDEX_HASH, INDEX_BITMAP };
+
+/* 索引元数据
+ * 索引项的键依次存放索引字段和INCLUDE字段，INCLUDE字段不参与索引的匹配，只用于仅索引扫描 */
 struct IndexMeta {
-    std::string tab_name;       // 索引所属表名称
-    int col_tot_len;            // 索引字段长度总和
-    int col_num;                // 索引字段数量
-    std::vector<ColMeta> cols;  // 索引包含的字段
+    std::string tab_name;               // 索引所属表名称
+    int col_tot_len;                    // 索引项的总长度：键和之后的INCLUDE字段
+    int col_num;                        // 索引字段数量
+    IndexType type = INDEX_BTREE;       // 索引的组织方式
+    std::vector<ColMeta> cols;          // 索引包含的字段
+    std::vector<ColMeta> include_cols;  // INCLUDE字段
+    bool clustered = false;  // 聚簇表的聚簇索引：索引字段是主键，INCLUDE其余全部字段，记录就存放在索引中
+    int pk_col_num = 0;  // 聚簇表的二级B+树索引在cols末尾追加的主键字段数，这些字段不是建索引时给出的
+
+    // 索引项中依次存放的字段，INCLUDE字段不属于键，只随索引项存放在叶结点中
+    std::vector<ColMeta> entry_cols() const {
+        std::vector<ColMeta> entry = cols;
+        entry.insert(entry.end(), include_cols.begin(), include_cols.end());
+        return entry;
+    }
+
+    // 键的长度，不含INCLUDE字段
+    int key_len() const {
+        int len = 0;
+        for (auto &col : cols) {
+            len += col.len;
+        }
+        return len;
+    }
+
+    // 从表的记录中抽取索引项，key的长度为col_tot_len；查找和删除只用前key_len()个字节
+    void extract_key(const char *record, char *key) const {
+        int offset = 0;
+        for (auto *group : {&cols, &include_cols}) {
+            for (auto &col : *group) {
+                memcpy(key + offset, record + col.offset, col.len);
+                offset += col.len;
+            }
+        }
+    }
+
+    // B+树索引和哈希索引的键不重复：插入、更新和建索引时遇到已有的键都失败，每条记录恰好有一个索引项；
+    // 位图索引的一个键对应多条记录；聚簇索引的主键和追加了主键的二级索引由表句柄检查主键
+    bool unique() const { return type != INDEX_BITMAP && !clustered && pk_col_num == 0; }
+
+    // 每条记录在索引中恰好有一个索引项：唯一索引、聚簇索引和追加了主键的二级索引；
+    // 按索引顺序输出、仅索引扫描和索引嵌套循环连接都依赖这一点，否则会漏掉记录
+    bool entry_per_row() const { return type != INDEX_BITMAP && (unique() || clustered || pk_col_num > 0); }
+
+    // 是否启用修改缓冲(见IxIndexHandle::enable_change_buffer())：唯一索引插入前要按键查找已有的项，
+    // 目标叶结点总要读入缓冲池，缓冲省不了读页面；只有追加了主键的二级索引插入时不查找
+    bool buffers_changes() const { return type == INDEX_BTREE && !clustered && !unique(); }
+
+    // 索引是否由字段col_names标识：建索引时给出的字段，或者包括追加的主键在内的全部键字段
+    bool named(const std::vector<std::string> &col_names) const {
+        if (col_names.size() != cols.size() && col_names.size() != cols.size() - pk_col_num) {
+            return false;
+        }
+        for (size_t i = 0; i < col_names.size(); ++i) {
+            if (cols[i].name != col_names[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 索引项是否包含表的字段col_name
+    bool covers(const std::string &col_name) const {
+        auto has = [&](const ColMeta &col) { return col.name == col_name; };
+        return std::any_of(cols.begin(), cols.end(), has) ||
+               std::any_of(include_cols.begin(), include_cols.end(), has);
+    }
 
     friend std::ostream &operator<<(std::ostream &os, const IndexMeta &index) {
         os << index.tab_name << " " << index.col_tot_len << " "
-           << index.col_num;
+           << index.col_num << " " << static_cast<int>(index.type) << " "
+           << index.include_cols.size() << " " << index.clustered << " " << index.pk_col_num;
         for (auto &col : index.cols) {
             os << "\n" << col;
         }
+        for (auto &col : index.include_cols) {
+            os << "\n" << col;
+        }
         return os;
     }
 
     friend std::istream &operator>>(std::istream &is, IndexMeta &index) {
-        is >> index.tab_name >> index.col_tot_len >> index.col_num;
+        int type;
+        size_t include_num;
+        is >> index.tab_name >> index.col_tot_len >> index.col_num >> type >>
+            include_num >> index.clustered >> index.pk_col_num;
+        index.type = static_cast<IndexType>(type);
         for (int i = 0; i < index.col_num; ++i) {
             ColMeta col;
             is >> col;
             index.cols.push_back(col);
         }
+        for (size_t i = 0; i < include_num; ++i) {
+            ColMeta col;
+            is >> col;
+            index.include_cols.push_back(col);
+        }
         return is;
     }
 };
 
+/* 表的存储引擎 */
+// 堆文件，记录按(页面号, 槽位号)原地存放；LSM树，适合写多读少、按插入顺序追加的表；
+// 聚簇表，记录按主键存放在聚簇索引(B+树)的叶结点中，适合主要按主键范围访问的表；
+// 内存表，记录存放在内存数组中、不经过缓冲池，适合经常访问的小表
+enum TableEngine { ENGINE_HEAP, ENGINE_LSM, ENGINE_CLUSTERED, ENGINE_MEMORY };
+
 /* 表元数据 */
 struct TabMeta {
     std::string name;                // 表名称
+    TableEngine engine = ENGINE_HEAP;  // 表的存储引擎
     std::vector<ColMeta> cols;       // 表包含的字段
     std::vector<IndexMeta> indexes;  // 表上建立的索引
 
@@ -77,6 +165,7 @@ struct TabMeta {
 
     TabMeta(const TabMeta &other) {
         name = other.name;
+        engine = other.engine;
         for (auto col : other.cols) cols.push_back(col);
     }
 
@@ -90,34 +179,29 @@ struct TabMeta {
 
     /* 判断当前表上是否建有指定索引，索引包含的字段为col_names */
     bool is_index(const std::vector<std::string> &col_names) const {
-        for (auto &index : indexes) {
-            if (index.col_num == col_names.size()) {
-                size_t i = 0;
-                for (; i < index.col_num; ++i) {
-                    if (index.cols[i].name.compare(col_names[i]) != 0) break;
-                }
-                if (i == index.col_num) return true;
-            }
-        }
-
-        return false;
+        return std::any_of(indexes.begin(), indexes.end(),
+                           [&](const IndexMeta &index) { return index.named(col_names); });
     }
 
     /* 根据字段名称集合获取索引元数据 */
     std::vector<IndexMeta>::iterator get_index_meta(
         const std::vector<std::string> &col_names) {
         for (auto index = indexes.begin(); index != indexes.end(); ++index) {
-            if ((*index).col_num != col_names.size()) continue;
-            auto &index_cols = (*index).cols;
-            size_t i = 0;
-            for (; i < col_names.size(); ++i) {
-                if (index_cols[i].name.compare(col_names[i]) != 0) break;
-            }
-            if (i == col_names.size()) return index;
+            if (index->named(col_names)) return index;
         }
         throw IndexNotFoundError(name, col_names);
     }
 
+    /* 聚簇表的聚簇索引，其他表返回nullptr */
+    const IndexMeta *clustered_index() const {
+        for (auto &index : indexes) {
+            if (index.clustered) {
+                return &index;
+            }
+        }
+        return nullptr;
+    }
+
     /* 根据字段名称获取字段元数据 */
     std::vector<ColMeta>::iterator get_col(const std::string &col_name) {
         auto pos = std::find_if(
@@ -130,7 +214,8 @@ struct TabMeta {
     }
 
     friend std::ostream &operator<<(std::ostream &os, const TabMeta &tab) {
-        os << tab.name << '\n' << tab.cols.size() << '\n';
+        os << tab.name << ' ' << static_cast<int>(tab.engine) << '\n'
+           << tab.cols.size() << '\n';
         for (auto &col : tab.cols) {
             os << col
                << '\n';  // col是ColMeta类型，然后调用重载的ColMeta的操作符<<
@@ -144,7 +229,9 @@ struct TabMeta {
 
     friend std::istream &operator>>(std::istream &is, TabMeta &tab) {
         size_t n;
-        is >> tab.name >> n;
+        int engine;
+        is >> tab.name >> engine >> n;
+        tab.engine = static_cast<TableEngine>(engine);
         for (size_t i = 0; i < n; i++) {
             ColMeta col;
             is >> col;
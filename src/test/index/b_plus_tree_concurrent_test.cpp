@@ -1,3 +1,4 @@
+#include <atomic>
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
@@ -75,8 +76,11 @@ class BPlusTreeConcurrentTest : public ::testing::Test {
         sm_->create_table(TEST_FILE_NAME, coldef, nullptr);
         sm_->create_index(TEST_FILE_NAME, TEST_COL, nullptr);
         assert(ix_manager_->exists(TEST_FILE_NAME, TEST_COL));
-        // 打开测试文件
-        ih_ = ix_manager_->open_index(TEST_FILE_NAME, TEST_COL);
+        // 索引文件已由create_index打开，直接接管SmManager中的句柄
+        std::string ix_name =
+            ix_manager_->get_index_name(TEST_FILE_NAME, TEST_COL);
+        ih_ = std::move(sm_->ihs_.at(ix_name));
+        sm_->ihs_.erase(ix_name);
         assert(ih_ != nullptr);
     }
 
@@ -496,4 +500,356 @@ TEST_F(BPlusTreeConcurrentTest, MixScaleTest) {
         scan.next();
     }
     EXPECT_EQ(size, keys.size() - delete_keys.size());
-}
\ No newline at end of file
+}
+/**
+ * @brief 小阶数下并发插入与删除交错执行，频繁触发分裂、合并和重分配，最后检查树的结构
+ */
+TEST_F(BPlusTreeConcurrentTest, MixSmallOrderTest) {
+    const int64_t scale = 2000;
+    const int thread_num = 8;
+    const int order = 5;
+
+    assert(order > 2 && order <= ih_->file_hdr_->btree_order_);
+    ih_->file_hdr_->btree_order_ = order;
+
+    std::vector<int64_t> keys;
+    for (int64_t key = 1; key <= scale; key++) {
+        keys.push_back(key);
+    }
+    auto rng = std::default_random_engine{};
+    std::shuffle(keys.begin(), keys.end(), rng);
+    LaunchParallelTest(thread_num, InsertHelper, ih_.get(), keys);
+
+    // 一半线程删除奇数键，另一半线程同时插入(scale, 2 * scale]
+    std::vector<int64_t> delete_keys;
+    std::vector<int64_t> insert_keys;
+    for (int64_t key = 1; key <= scale; key += 2) {
+        delete_keys.push_back(key);
+    }
+    for (int64_t key = scale + 1; key <= scale * 2; key++) {
+        insert_keys.push_back(key);
+    }
+    std::shuffle(delete_keys.begin(), delete_keys.end(), rng);
+    std::shuffle(insert_keys.begin(), insert_keys.end(), rng);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thread_num / 2; i++) {
+        threads.emplace_back(DeleteHelper, ih_.get(), delete_keys, i);
+        threads.emplace_back(InsertHelper, ih_.get(), insert_keys, i);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::multimap<int, Rid> mock;
+    for (int64_t key = 2; key <= scale * 2; key += key < scale ? 2 : 1) {
+        mock.insert({key, Rid{.page_no = 0, .slot_no = static_cast<int>(key)}});
+    }
+    check_all(ih_.get(), mock);
+}
+
+/**
+ * @brief 不同线程数下并发插入、查找、删除的吞吐量
+ * 每个线程操作互不相交的键，每一轮结束时树应为空
+ */
+TEST_F(BPlusTreeConcurrentTest, ThroughputBenchmark) {
+    const int64_t scale = 20000;
+    const std::vector<int> thread_nums = {1, 2, 4, 8, 16};
+
+    auto run = [](const std::vector<std::vector<int64_t>> &keys,
+                  const std::function<void(const std::vector<int64_t> &)> &op) {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (auto &thread_keys : keys) {
+            threads.emplace_back(op, std::cref(thread_keys));
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        return scale / elapsed.count();
+    };
+
+    printf("%8s %16s %16s %16s\n", "threads", "insert ops/s", "lookup ops/s",
+           "delete ops/s");
+    for (int thread_num : thread_nums) {
+        std::vector<std::vector<int64_t>> keys(thread_num);
+        for (int64_t key = 1; key <= scale; key++) {
+            keys[key % thread_num].push_back(key);
+        }
+        auto rng = std::default_random_engine{};
+        for (auto &thread_keys : keys) {
+            std::shuffle(thread_keys.begin(), thread_keys.end(), rng);
+        }
+
+        double insert_ops = run(keys, [&](const std::vector<int64_t> &thread_keys) {
+            Transaction txn(0);
+            for (auto key : thread_keys) {
+                Rid rid = {.page_no = 0, .slot_no = static_cast<int>(key)};
+                ih_->insert_entry((const char *)&key, rid, &txn);
+            }
+        });
+        double lookup_ops = run(keys, [&](const std::vector<int64_t> &thread_keys) {
+            Transaction txn(0);
+            std::vector<Rid> rids;
+            for (auto key : thread_keys) {
+                rids.clear();
+                EXPECT_TRUE(ih_->get_value((const char *)&key, &rids, &txn));
+            }
+        });
+        double delete_ops = run(keys, [&](const std::vector<int64_t> &thread_keys) {
+            Transaction txn(0);
+            for (auto key : thread_keys) {
+                EXPECT_TRUE(ih_->delete_entry((const char *)&key, &txn));
+            }
+        });
+        printf("%8d %16.0f %16.0f %16.0f\n", thread_num, insert_ops,
+               lookup_ops, delete_ops);
+
+        IxScan scan(ih_.get(), ih_->leaf_begin(), ih_->leaf_end(),
+                    buffer_pool_manager_.get());
+        EXPECT_TRUE(scan.is_end());
+    }
+}
+
+/**
+ * @brief 一个线程反复做范围扫描，同时其他线程插入和删除：扫描得到的key严格递增，
+ * 且扫描期间没有被删除的key都能扫到；逐个输出与批量输出的结果一致
+ */
+TEST_F(BPlusTreeConcurrentTest, ScanWhileModifyTest) {
+    const int64_t scale = 20000;
+    for (int64_t key = 0; key < scale; key += 2) {
+        Rid rid = {.page_no = 0, .slot_no = static_cast<int>(key)};
+        ih_->insert_entry((const char *)&key, rid, txn_.get());
+    }
+    int lower_key = 1000;
+    int upper_key = scale - 1000;
+    auto check_scan = [&](bool batched) {
+        IxScan scan(ih_.get(), (const char *)&lower_key, (const char *)&upper_key,
+                    buffer_pool_manager_.get());
+        std::vector<Rid> rids;
+        while (!scan.is_end()) {
+            if (batched) {
+                scan.next_batch(&rids);
+            } else {
+                rids.push_back(scan.rid());
+                scan.next();
+            }
+        }
+        int last = lower_key - 1;
+        int evens = 0;
+        for (auto &rid : rids) {
+            EXPECT_GT(rid.slot_no, last);
+            EXPECT_LE(rid.slot_no, upper_key);
+            evens += rid.slot_no % 2 == 0;
+            last = rid.slot_no;
+        }
+        // 偶数key只在扫描全部结束后才删除
+        return evens;
+    };
+
+    std::atomic<bool> done = false;
+    std::thread scanner([&]() {
+        int rounds = 0;
+        while (!done || rounds < 2) {
+            EXPECT_EQ(check_scan(rounds % 2 == 0), (upper_key - lower_key) / 2 + 1);
+            rounds++;
+        }
+    });
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 2; t++) {
+        writers.emplace_back([&, t]() {
+            Transaction txn(0);
+            for (int64_t key = 1 + 2 * t; key < scale; key += 4) {
+                Rid rid = {.page_no = 0, .slot_no = static_cast<int>(key)};
+                ih_->insert_entry((const char *)&key, rid, &txn);
+            }
+            for (int64_t key = 1 + 2 * t; key < scale; key += 8) {
+                EXPECT_TRUE(ih_->delete_entry((const char *)&key, &txn));
+            }
+        });
+    }
+    for (auto &writer : writers) {
+        writer.join();
+    }
+    done = true;
+    scanner.join();
+    EXPECT_EQ(check_scan(true), check_scan(false));
+}
+
+/**
+ * @brief 上层结点常驻缓冲池：根结点和上几层内部结点一直被pin住，查找时不经过缓冲池；
+ * 并发插入删除引起内部结点分裂合并、根结点改变后常驻集合被重建，结果仍然正确，释放后不再占用帧
+ */
+TEST_F(BPlusTreeConcurrentTest, ResidentUpperLevelsTest) {
+    const int64_t scale = 4000;
+    const int thread_num = 8;
+    const int order = 5;
+
+    assert(order > 2 && order <= ih_->file_hdr_->btree_order_);
+    ih_->file_hdr_->btree_order_ = order;
+
+    std::vector<int64_t> keys;
+    for (int64_t key = 1; key <= scale; key++) {
+        keys.push_back(key);
+    }
+    auto rng = std::default_random_engine{};
+    std::shuffle(keys.begin(), keys.end(), rng);
+    LaunchParallelTest(thread_num, InsertHelper, ih_.get(), keys);
+
+    // 之后的查找发现根结点改变后重建常驻集合
+    std::vector<Rid> rids;
+    int64_t first = 1;
+    ASSERT_TRUE(ih_->get_value((const char *)&first, &rids, nullptr));
+    ASSERT_FALSE(ih_->resident_stale());
+    ASSERT_GT(ih_->num_resident_pages(), 0u);
+    ASSERT_LE(ih_->num_resident_pages(), IX_PIN_MAX_PAGES);
+    EXPECT_EQ(buffer_pool_manager_->resident_frames(), ih_->num_resident_pages());
+    auto root = ih_->resident_pages_.find(ih_->file_hdr_->root_page_);
+    ASSERT_NE(root, ih_->resident_pages_.end());
+    EXPECT_EQ(root->second->pin_count_, 1);  // 没有其他线程访问时只有常驻的pin
+    for (auto &[page_no, page] : ih_->resident_pages_) {
+        IxNodeHandle node(ih_->file_hdr_, page);
+        EXPECT_FALSE(node.is_leaf_page());
+    }
+
+    // 一半线程删除奇数键，另一半线程插入(scale, 2 * scale]，同时不断查找不会被删除的偶数键
+    std::vector<int64_t> delete_keys;
+    std::vector<int64_t> insert_keys;
+    for (int64_t key = 1; key <= scale; key += 2) {
+        delete_keys.push_back(key);
+    }
+    for (int64_t key = scale + 1; key <= scale * 2; key++) {
+        insert_keys.push_back(key);
+    }
+    std::shuffle(delete_keys.begin(), delete_keys.end(), rng);
+    std::shuffle(insert_keys.begin(), insert_keys.end(), rng);
+    std::atomic<bool> done = false;
+    std::atomic<int> errors = 0;
+    std::thread reader([&]() {
+        std::vector<Rid> rids;
+        for (int64_t key = 2; !done; key = key + 2 > scale ? 2 : key + 2) {
+            rids.clear();
+            if (!ih_->get_value((const char *)&key, &rids, nullptr) ||
+                rids[0].slot_no != key) {
+                errors++;
+            }
+        }
+    });
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thread_num / 2; i++) {
+        threads.emplace_back(DeleteHelper, ih_.get(), delete_keys, i);
+        threads.emplace_back(InsertHelper, ih_.get(), insert_keys, i);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    done = true;
+    reader.join();
+    EXPECT_EQ(errors.load(), 0);
+
+    std::multimap<int, Rid> mock;
+    for (int64_t key = 2; key <= scale * 2; key += key < scale ? 2 : 1) {
+        mock.insert({key, Rid{.page_no = 0, .slot_no = static_cast<int>(key)}});
+    }
+    check_all(ih_.get(), mock);
+
+    ih_->unpin_upper_levels();
+    EXPECT_EQ(ih_->num_resident_pages(), 0u);
+    EXPECT_EQ(buffer_pool_manager_->resident_frames(), 0u);
+}
+
+/**
+ * @brief 反向扫描：各种上下界下与正向扫描的结果互为逆序；并发插入删除引起分裂合并时，
+ * 扫描得到的key严格递减，且扫描期间没有被删除的key都能扫到
+ */
+TEST_F(BPlusTreeConcurrentTest, ReverseScanTest) {
+    const int64_t scale = 20000;
+    const int order = 7;
+
+    assert(order > 2 && order <= ih_->file_hdr_->btree_order_);
+    ih_->file_hdr_->btree_order_ = order;
+    for (int64_t key = 0; key < scale; key += 2) {
+        Rid rid = {.page_no = 0, .slot_no = static_cast<int>(key)};
+        ih_->insert_entry((const char *)&key, rid, txn_.get());
+    }
+    auto scan_keys = [&](const int *lower, const int *upper, bool reverse) {
+        IxScan scan(ih_.get(), (const char *)lower, (const char *)upper,
+                    buffer_pool_manager_.get(), true, reverse);
+        std::vector<Rid> rids;
+        std::vector<char> keys;
+        while (!scan.is_end()) {
+            scan.next_batch(&rids, &keys);
+        }
+        std::vector<int> result;
+        for (size_t i = 0; i < rids.size(); i++) {
+            EXPECT_EQ(rids[i].slot_no, *(int *)(keys.data() + i * sizeof(int)));
+            result.push_back(rids[i].slot_no);
+        }
+        return result;
+    };
+    std::vector<std::pair<int, int>> ranges = {
+        {-5, -1}, {-5, 0}, {0, 0}, {1, 1}, {999, 1001}, {1000, 9001}, {scale - 2, scale + 5}};
+    for (auto [lower, upper] : ranges) {
+        auto forward = scan_keys(&lower, &upper, false);
+        auto backward = scan_keys(&lower, &upper, true);
+        std::reverse(backward.begin(), backward.end());
+        EXPECT_EQ(forward, backward);
+    }
+    int mid = scale / 2;
+    auto all = scan_keys(nullptr, nullptr, true);
+    ASSERT_EQ(all.size(), static_cast<size_t>(scale / 2));
+    EXPECT_EQ(all.front(), scale - 2);
+    EXPECT_EQ(all.back(), 0);
+    auto head = scan_keys(nullptr, &mid, true);
+    ASSERT_FALSE(head.empty());
+    EXPECT_EQ(head.front(), mid);
+    auto tail = scan_keys(&mid, nullptr, true);
+    ASSERT_FALSE(tail.empty());
+    EXPECT_EQ(tail.back(), mid);
+
+    // 逐个输出，同时两个线程插入删除奇数键
+    int lower_key = 1000;
+    int upper_key = scale - 1000;
+    auto check_scan = [&]() {
+        IxScan scan(ih_.get(), (const char *)&lower_key, (const char *)&upper_key,
+                    buffer_pool_manager_.get(), false, true);
+        int last = upper_key + 1;
+        int evens = 0;
+        while (!scan.is_end()) {
+            int key = scan.rid().slot_no;
+            EXPECT_LT(key, last);
+            EXPECT_GE(key, lower_key);
+            evens += key % 2 == 0;
+            last = key;
+            scan.next();
+        }
+        return evens;
+    };
+    std::atomic<bool> done = false;
+    std::thread scanner([&]() {
+        int rounds = 0;
+        while (!done || rounds < 2) {
+            EXPECT_EQ(check_scan(), (upper_key - lower_key) / 2 + 1);
+            rounds++;
+        }
+    });
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 2; t++) {
+        writers.emplace_back([&, t]() {
+            Transaction txn(0);
+            for (int64_t key = 1 + 2 * t; key < scale; key += 4) {
+                Rid rid = {.page_no = 0, .slot_no = static_cast<int>(key)};
+                ih_->insert_entry((const char *)&key, rid, &txn);
+            }
+            for (int64_t key = 1 + 2 * t; key < scale; key += 8) {
+                EXPECT_TRUE(ih_->delete_entry((const char *)&key, &txn));
+            }
+        });
+    }
+    for (auto &writer : writers) {
+        writer.join();
+    }
+    done = true;
+    scanner.join();
+}
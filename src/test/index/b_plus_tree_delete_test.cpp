@@ -73,8 +73,11 @@ class BPlusTreeTests : public ::testing::Test {
         sm_->create_table(TEST_FILE_NAME, coldef, nullptr);
         sm_->create_index(TEST_FILE_NAME, TEST_COL, nullptr);
         assert(ix_manager_->exists(TEST_FILE_NAME, TEST_COL));
-        // 打开测试文件
-        ih_ = ix_manager_->open_index(TEST_FILE_NAME, TEST_COL);
+        // 索引文件已由create_index打开，直接接管SmManager中的句柄
+        std::string ix_name =
+            ix_manager_->get_index_name(TEST_FILE_NAME, TEST_COL);
+        ih_ = std::move(sm_->ihs_.at(ix_name));
+        sm_->ihs_.erase(ix_name);
         assert(ih_ != nullptr);
     }
 
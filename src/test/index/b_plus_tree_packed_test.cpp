@@ -0,0 +1,363 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>  // for std::default_random_engine
+#include <set>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#define private public
+#include "index/ix.h"
+#undef private  // for use private variables in "ix.h"
+
+#include "storage/buffer_pool_manager.h"
+
+const std::string TEST_DB_NAME = "BPlusTreePackedTest_db";  // 以数据库名作为根目录
+const int KEY_LEN = 64;                                       // char(64)的索引键
+
+/** 对于每个测试点，先创建和进入目录TEST_DB_NAME */
+class BPlusTreePackedTest : public ::testing::Test {
+   public:
+    std::unique_ptr<DiskManager> disk_manager_;
+    std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+    std::unique_ptr<IxManager> ix_manager_;
+
+   public:
+    // This function is called before every test.
+    void SetUp() override {
+        ::testing::Test::SetUp();
+        disk_manager_ = std::make_unique<DiskManager>();
+        buffer_pool_manager_ = std::make_unique<BufferPoolManager>(200, disk_manager_.get());
+        ix_manager_ = std::make_unique<IxManager>(disk_manager_.get(), buffer_pool_manager_.get());
+
+        if (disk_manager_->is_dir(TEST_DB_NAME)) {
+            std::string cmd = "rm -rf " + TEST_DB_NAME;
+            if (system(cmd.c_str()) < 0) {
+                throw UnixError();
+            }
+        }
+        disk_manager_->create_dir(TEST_DB_NAME);
+        if (chdir(TEST_DB_NAME.c_str()) < 0) {
+            throw UnixError();
+        }
+    }
+
+    // This function is called after every test.
+    void TearDown() override {
+        if (chdir("..") < 0) {
+            throw UnixError();
+        }
+    }
+
+    std::unique_ptr<IxIndexHandle> open_index(const std::string &name) {
+        std::vector<ColMeta> cols = {{name, "k", TYPE_STRING, KEY_LEN, 0, false}};
+        ix_manager_->create_index(name, cols);
+        return ix_manager_->open_index(name, cols);
+    }
+
+    /** 有公共前缀的字符串键，末尾补0 */
+    static std::string make_key(int i) {
+        char buf[KEY_LEN] = {};
+        snprintf(buf, sizeof(buf), "tenant-0042/warehouse/region-%02d/item-%07d", i % 7, i);
+        return std::string(buf, KEY_LEN);
+    }
+
+    static std::string fence(IxNodeHandle *node, bool low) {
+        std::string key(KEY_LEN, '\0');
+        bool finite = low ? node->get_low_key(key.data()) : node->get_high_key(key.data());
+        return finite ? key : std::string();
+    }
+
+    /**
+     * @brief 检查以page_no为根的子树：结点不满，key有序且在结点范围[low, high)内，
+     * 孩子的范围与父结点中的key一致，父指针正确
+     * @return 子树的高度
+     */
+    int check_subtree(IxIndexHandle *ih, int page_no, const std::string &low, const std::string &high,
+                      int *num_keys) {
+        IxNodeHandle *node = ih->fetch_node(page_no);
+        EXPECT_FALSE(node->is_full());
+        EXPECT_EQ(fence(node, true), low);
+        EXPECT_EQ(fence(node, false), high);
+        std::vector<char> keys;
+        std::vector<Rid> rids;
+        node->get_pairs(&keys, &rids);
+        int n = rids.size();
+        // 下界为负无穷的内部结点的第0个key不参与查找，不做检查
+        int first = !node->is_leaf_page() && low.empty() ? 1 : 0;
+        if (!node->is_leaf_page() && !low.empty()) {
+            EXPECT_EQ(std::string(keys.data(), KEY_LEN), low);
+        }
+        for (int i = first; i < n; i++) {
+            std::string key(keys.data() + i * KEY_LEN, KEY_LEN);
+            if (i > first) {
+                EXPECT_LT(std::string(keys.data() + (i - 1) * KEY_LEN, KEY_LEN), key);
+            }
+            EXPECT_TRUE(low.empty() || low <= key);
+            EXPECT_TRUE(high.empty() || key < high);
+        }
+        int height = 1;
+        if (node->is_leaf_page()) {
+            *num_keys += n;
+        } else {
+            for (int i = 0; i < n; i++) {
+                IxNodeHandle *child = ih->fetch_node(rids[i].page_no);
+                EXPECT_EQ(child->get_parent_page_no(), page_no);
+                ih->unpin_node(child, false);
+                std::string child_low = i == 0 ? low : std::string(keys.data() + i * KEY_LEN, KEY_LEN);
+                std::string child_high = i + 1 == n ? high : std::string(keys.data() + (i + 1) * KEY_LEN, KEY_LEN);
+                height = check_subtree(ih, rids[i].page_no, child_low, child_high, num_keys) + 1;
+            }
+        }
+        ih->unpin_node(node, false);
+        return height;
+    }
+
+    /**
+     * @brief 删除key后检查key所在的叶结点没有遗留为偏空：它仍偏空时不是父结点唯一的孩子，
+     * 并且已与删除时选取的兄弟结点(前驱，第0个孩子选后继)合并或重分配均衡。
+     * 重分配后结点的范围变窄、前缀变长，按字节数可能仍然偏空，因此按键值对个数检查均衡
+     */
+    void check_resolved(IxIndexHandle *ih, const std::string &key) {
+        IxNodeHandle *leaf = ih->find_leaf_page(key.data(), Operation::FIND, nullptr).first;
+        leaf->page->runlatch();
+        if (!leaf->is_root_page() && leaf->is_underflow()) {
+            IxNodeHandle *parent = ih->fetch_node(leaf->get_parent_page_no());
+            ASSERT_GE(parent->get_size(), 2);
+            int index = parent->find_child(leaf);
+            IxNodeHandle *sibling = ih->fetch_node(parent->value_at(index == 0 ? 1 : index - 1));
+            EXPECT_GE(leaf->get_size() * 2, sibling->get_size());
+            ih->unpin_node(sibling, false);
+            ih->unpin_node(parent, false);
+        }
+        ih->unpin_node(leaf, false);
+    }
+
+    /**
+     * @brief 检查树的结构，并沿叶结点链表和IxScan检查key与expected一致
+     * @return 树的高度
+     */
+    int check_index(IxIndexHandle *ih, const std::set<std::string> &expected) {
+        int num_keys = 0;
+        int height = check_subtree(ih, ih->file_hdr_->root_page_, "", "", &num_keys);
+        EXPECT_EQ(num_keys, (int)expected.size());
+
+        std::vector<std::string> keys;
+        IxScan scan(ih, ih->leaf_begin(), ih->leaf_end(), buffer_pool_manager_.get());
+        for (; !scan.is_end(); scan.next()) {
+            IxNodeHandle *leaf = ih->fetch_node(scan.iid().page_no);
+            std::string key(KEY_LEN, '\0');
+            leaf->copy_key(scan.iid().slot_no, key.data());
+            keys.push_back(key);
+            ih->unpin_node(leaf, false);
+        }
+        EXPECT_EQ(keys, std::vector<std::string>(expected.begin(), expected.end()));
+
+        for (auto &key : expected) {
+            std::vector<Rid> rids;
+            EXPECT_TRUE(ih->get_value(key.data(), &rids, nullptr));
+        }
+        return height;
+    }
+};
+
+/**
+ * @brief 乱序插入有公共前缀的字符串键，变长格式的树比定长格式的页面更少、高度更低
+ */
+TEST_F(BPlusTreePackedTest, InsertTest) {
+    const int scale = 20000;
+    std::vector<int> order(scale);
+    for (int i = 0; i < scale; i++) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::default_random_engine{});
+
+    auto packed_ih = open_index("packed");
+    auto fixed_ih = open_index("fixed");
+    ASSERT_TRUE(packed_ih->file_hdr_->packed_);
+    fixed_ih->file_hdr_->packed_ = false;
+
+    std::set<std::string> expected;
+    for (int i : order) {
+        std::string key = make_key(i);
+        packed_ih->insert_entry(key.data(), Rid{.page_no = 0, .slot_no = i}, nullptr);
+        fixed_ih->insert_entry(key.data(), Rid{.page_no = 0, .slot_no = i}, nullptr);
+        expected.insert(key);
+    }
+    // 重复的key不会插入
+    packed_ih->insert_entry(make_key(0).data(), Rid{.page_no = 1, .slot_no = 0}, nullptr);
+
+    int height = check_index(packed_ih.get(), expected);
+    int fixed_height = 0;
+    for (page_id_t page_no = fixed_ih->file_hdr_->root_page_;;) {
+        IxNodeHandle *node = fixed_ih->fetch_node(page_no);
+        fixed_height++;
+        bool is_leaf = node->is_leaf_page();
+        page_no = node->value_at(0);
+        fixed_ih->unpin_node(node, false);
+        if (is_leaf) {
+            break;
+        }
+    }
+    printf("packed: %d pages, height %d; fixed: %d pages, height %d\n", packed_ih->file_hdr_->num_pages_, height,
+           fixed_ih->file_hdr_->num_pages_, fixed_height);
+    EXPECT_LT(packed_ih->file_hdr_->num_pages_ * 2, fixed_ih->file_hdr_->num_pages_);
+    EXPECT_LE(height, fixed_height);
+
+    for (int i : {0, scale / 2, scale - 1}) {
+        std::vector<Rid> rids;
+        ASSERT_TRUE(packed_ih->get_value(make_key(i).data(), &rids, nullptr));
+        EXPECT_EQ(rids[0], (Rid{.page_no = 0, .slot_no = i}));
+    }
+    std::string missing = make_key(scale);
+    std::vector<Rid> rids;
+    EXPECT_FALSE(packed_ih->get_value(missing.data(), &rids, nullptr));
+}
+
+/**
+ * @brief 乱序删除大部分key，合并和重分配后结构仍然正确，删空后可以重新插入
+ */
+TEST_F(BPlusTreePackedTest, DeleteTest) {
+    const int scale = 10000;
+    std::vector<int> order(scale);
+    for (int i = 0; i < scale; i++) {
+        order[i] = i;
+    }
+    auto rng = std::default_random_engine{};
+    std::shuffle(order.begin(), order.end(), rng);
+
+    auto ih = open_index("delete");
+    std::set<std::string> expected;
+    for (int i : order) {
+        ih->insert_entry(make_key(i).data(), Rid{.page_no = 0, .slot_no = i}, nullptr);
+        expected.insert(make_key(i));
+    }
+    std::shuffle(order.begin(), order.end(), rng);
+    for (int j = 0; j < scale; j++) {
+        EXPECT_TRUE(ih->delete_entry(make_key(order[j]).data(), nullptr));
+        expected.erase(make_key(order[j]));
+        if (j == scale / 2 || j == scale * 9 / 10) {
+            check_index(ih.get(), expected);
+        }
+    }
+    EXPECT_FALSE(ih->delete_entry(make_key(0).data(), nullptr));
+    check_index(ih.get(), expected);
+
+    for (int i = 0; i < 1000; i++) {
+        ih->insert_entry(make_key(i).data(), Rid{.page_no = 0, .slot_no = i}, nullptr);
+        expected.insert(make_key(i));
+    }
+    check_index(ih.get(), expected);
+}
+
+/**
+ * @brief 同组的key只在末尾不同，叶结点之间的分隔键很长，父结点经常放不下重分配产生的更长的分隔键；
+ * 乱序删除大部分key后，偏空的结点都被合并或重分配，必要时分裂父结点
+ */
+TEST_F(BPlusTreePackedTest, DeleteLongSeparatorTest) {
+    const int scale = 20000;
+    auto make_long_key = [](int i) {
+        char buf[KEY_LEN] = {};
+        snprintf(buf, sizeof(buf), "g%03d/%s/%05d", i / 100, std::string(48, 'x').c_str(), i % 100);
+        return std::string(buf, KEY_LEN);
+    };
+    std::vector<int> order(scale);
+    for (int i = 0; i < scale; i++) {
+        order[i] = i;
+    }
+    auto rng = std::default_random_engine{};
+    std::shuffle(order.begin(), order.end(), rng);
+
+    auto ih = open_index("long");
+    std::set<std::string> expected;
+    for (int i : order) {
+        ih->insert_entry(make_long_key(i).data(), Rid{.page_no = 0, .slot_no = i}, nullptr);
+        expected.insert(make_long_key(i));
+    }
+    // 成块地删除，被删空的结点旁边的兄弟仍然较满，不能合并只能重分配
+    std::vector<int> victims;
+    for (int i = 0; i < scale; i++) {
+        if (i / 60 % 2 == 0) {
+            victims.push_back(i);
+        }
+    }
+    std::shuffle(victims.begin(), victims.end(), rng);
+    for (int j = 0; j < (int)victims.size(); j++) {
+        EXPECT_TRUE(ih->delete_entry(make_long_key(victims[j]).data(), nullptr));
+        expected.erase(make_long_key(victims[j]));
+        check_resolved(ih.get(), make_long_key(victims[j]));
+    }
+    check_index(ih.get(), expected);
+}
+
+/**
+ * @brief 多个线程并发插入和删除不同的key
+ */
+TEST_F(BPlusTreePackedTest, ConcurrentTest) {
+    const int num_threads = 4;
+    const int per_thread = 3000;
+    auto ih = open_index("concurrent");
+    for (int i = 0; i < num_threads * per_thread; i += 2) {
+        ih->insert_entry(make_key(i).data(), Rid{.page_no = 0, .slot_no = i}, nullptr);
+    }
+
+    // 每个线程插入自己范围内的奇数key，删除偶数key
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t]() {
+            Transaction txn(0);
+            for (int i = t * per_thread; i < (t + 1) * per_thread; i++) {
+                std::string key = make_key(i);
+                if (i % 2 == 1) {
+                    ih->insert_entry(key.data(), Rid{.page_no = 0, .slot_no = i}, &txn);
+                } else {
+                    EXPECT_TRUE(ih->delete_entry(key.data(), &txn));
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::set<std::string> expected;
+    for (int i = 1; i < num_threads * per_thread; i += 2) {
+        expected.insert(make_key(i));
+    }
+    check_index(ih.get(), expected);
+}
+
+/**
+ * @brief 变长格式的批量构建，建好后还可以正常插入和删除
+ */
+TEST_F(BPlusTreePackedTest, BulkLoadTest) {
+    for (int scale : {0, 1, 100, 20000}) {
+        SCOPED_TRACE("scale=" + std::to_string(scale));
+        auto ih = open_index("bulk" + std::to_string(scale));
+        std::set<std::string> expected;
+        for (int i = 0; i < scale; i++) {
+            expected.insert(make_key(i));
+        }
+        auto it = expected.begin();
+        ih->bulk_load([&](char *key, Rid *rid) {
+            if (it == expected.end()) {
+                return false;
+            }
+            memcpy(key, it->data(), KEY_LEN);
+            *rid = Rid{.page_no = 0, .slot_no = 0};
+            ++it;
+            return true;
+        });
+        check_index(ih.get(), expected);
+
+        for (int i = scale; i < scale + 2000; i++) {
+            ih->insert_entry(make_key(i).data(), Rid{.page_no = 0, .slot_no = i}, nullptr);
+            expected.insert(make_key(i));
+        }
+        for (int i = 0; i < scale; i += 2) {
+            EXPECT_TRUE(ih->delete_entry(make_key(i).data(), nullptr));
+            expected.erase(make_key(i));
+        }
+        check_index(ih.get(), expected);
+    }
+}
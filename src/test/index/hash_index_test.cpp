@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <random>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#define private public
+#include "index/ix.h"
+#undef private  // for use private variables in "ix.h"
+
+#include "storage/buffer_pool_manager.h"
+
+const std::string TEST_DB_NAME = "HashIndexTest_db";  // 以数据库名作为根目录
+
+/** 对于每个测试点，先创建和进入目录TEST_DB_NAME */
+class HashIndexTest : public ::testing::Test {
+   public:
+    std::unique_ptr<DiskManager> disk_manager_;
+    std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+    std::unique_ptr<IxManager> ix_manager_;
+
+   public:
+    // This function is called before every test.
+    void SetUp() override {
+        ::testing::Test::SetUp();
+        disk_manager_ = std::make_unique<DiskManager>();
+        buffer_pool_manager_ = std::make_unique<BufferPoolManager>(200, disk_manager_.get());
+        ix_manager_ = std::make_unique<IxManager>(disk_manager_.get(), buffer_pool_manager_.get());
+
+        if (disk_manager_->is_dir(TEST_DB_NAME)) {
+            std::string cmd = "rm -rf " + TEST_DB_NAME;
+            if (system(cmd.c_str()) < 0) {
+                throw UnixError();
+            }
+        }
+        disk_manager_->create_dir(TEST_DB_NAME);
+        if (chdir(TEST_DB_NAME.c_str()) < 0) {
+            throw UnixError();
+        }
+    }
+
+    // This function is called after every test.
+    void TearDown() override {
+        if (chdir("..") < 0) {
+            throw UnixError();
+        }
+    }
+
+    static Rid make_rid(int key) { return Rid{key / 100 + 1, key % 100}; }
+
+    static bool lookup(IxHashIndexHandle *hh, int key, Rid *rid) {
+        std::vector<Rid> result;
+        bool found = hh->get_value(reinterpret_cast<const char *>(&key), &result, nullptr);
+        EXPECT_EQ(result.size(), found ? 1u : 0u);
+        if (found) {
+            *rid = result[0];
+        }
+        return found;
+    }
+
+    /** 检查桶的结构：每个桶中的键都属于该桶，指向同一个桶的目录项个数等于2^(global-local) */
+    static void check_buckets(IxHashIndexHandle *hh, int *num_keys) {
+        *num_keys = 0;
+        uint32_t dir_size = 1u << hh->get_global_depth();
+        std::map<page_id_t, int> refs;
+        for (uint32_t i = 0; i < dir_size; i++) {
+            refs[hh->dir_lookup(i)]++;
+        }
+        for (auto &[page_no, count] : refs) {
+            Page *page = hh->buffer_pool_manager_->fetch_page({hh->fd_, page_no});
+            auto hdr = hh->bucket_hdr(page);
+            EXPECT_EQ(count, 1 << (hh->get_global_depth() - hdr->local_depth));
+            EXPECT_LE(hdr->num_key, hh->file_hdr_->bucket_capacity_);
+            for (int i = 0; i < hdr->num_key; i++) {
+                uint32_t hash = hh->hash_normalized(hh->bucket_key(page, i));
+                EXPECT_EQ(hash & ((1u << hdr->local_depth) - 1), hdr->pattern);
+            }
+            *num_keys += hdr->num_key;
+            hh->buffer_pool_manager_->unpin_page(page->get_page_id(), false);
+        }
+    }
+};
+
+/**
+ * @brief 插入、查找、删除，目录加倍超过一个目录页后关闭再打开索引
+ */
+TEST_F(HashIndexTest, InsertLookupDelete) {
+    const int n = 100000;
+    std::vector<ColMeta> cols = {{"hash", "k", TYPE_INT, sizeof(int), 0, false}};
+    ix_manager_->create_hash_index("hash", cols);
+    auto hh = ix_manager_->open_hash_index("hash", cols);
+
+    std::vector<int> keys(n);
+    for (int i = 0; i < n; i++) {
+        keys[i] = i * 7 - n;
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+    for (int key : keys) {
+        ASSERT_TRUE(hh->insert_entry(reinterpret_cast<const char *>(&key), make_rid(key), nullptr));
+    }
+    // 重复的键不再插入
+    ASSERT_FALSE(hh->insert_entry(reinterpret_cast<const char *>(&keys[0]), Rid{0, 0}, nullptr));
+    // 目录已经超过一个目录页
+    ASSERT_GT(1 << hh->get_global_depth(), IX_HASH_DIR_ENTRIES_PER_PAGE);
+    int num_keys;
+    check_buckets(hh.get(), &num_keys);
+    ASSERT_EQ(num_keys, n);
+
+    for (int i = 0; i < n; i += 2) {
+        ASSERT_TRUE(hh->delete_entry(reinterpret_cast<const char *>(&keys[i]), nullptr));
+    }
+    ASSERT_FALSE(hh->delete_entry(reinterpret_cast<const char *>(&keys[0]), nullptr));
+
+    int depth = hh->get_global_depth();
+    ix_manager_->close_index(hh.get());
+    hh = ix_manager_->open_hash_index("hash", cols);
+    ASSERT_EQ(hh->get_global_depth(), depth);
+    for (int i = 0; i < n; i++) {
+        Rid rid;
+        bool found = lookup(hh.get(), keys[i], &rid);
+        ASSERT_EQ(found, i % 2 == 1);
+        if (found) {
+            ASSERT_EQ(rid, make_rid(keys[i]));
+        }
+    }
+    int missing = 1;  // 不是7的倍数减n
+    Rid rid;
+    ASSERT_FALSE(lookup(hh.get(), missing, &rid));
+    check_buckets(hh.get(), &num_keys);
+    ASSERT_EQ(num_keys, n / 2);
+    ix_manager_->close_index(hh.get());
+}
+
+/**
+ * @brief 键规范化后再哈希：-0.0和0.0是同一个键；联合键逐字段规范化
+ */
+TEST_F(HashIndexTest, NormalizedKeys) {
+    std::vector<ColMeta> cols = {{"hash", "f", TYPE_FLOAT, sizeof(float), 0, false},
+                                 {"hash", "s", TYPE_STRING, 8, 4, false}};
+    ix_manager_->create_hash_index("hash", cols);
+    auto hh = ix_manager_->open_hash_index("hash", cols);
+
+    char key[12] = {};
+    float zero = 0.0f, neg_zero = -0.0f;
+    memcpy(key, &neg_zero, sizeof(float));
+    memcpy(key + 4, "abc", 3);
+    ASSERT_TRUE(hh->insert_entry(key, Rid{1, 1}, nullptr));
+    memcpy(key, &zero, sizeof(float));
+    ASSERT_FALSE(hh->insert_entry(key, Rid{1, 2}, nullptr));
+    std::vector<Rid> result;
+    ASSERT_TRUE(hh->get_value(key, &result, nullptr));
+    ASSERT_EQ(result, std::vector<Rid>({Rid{1, 1}}));
+    memcpy(key + 4, "abd", 3);
+    ASSERT_FALSE(hh->get_value(key, &result, nullptr));
+    ix_manager_->close_index(hh.get());
+}
+
+/**
+ * @brief 多个线程同时插入、查找和删除，期间桶不断分裂、目录不断加倍
+ */
+TEST_F(HashIndexTest, Concurrent) {
+    const int num_threads = 8;
+    const int per_thread = 10000;
+    std::vector<ColMeta> cols = {{"hash", "k", TYPE_INT, sizeof(int), 0, false}};
+    ix_manager_->create_hash_index("hash", cols);
+    auto hh = ix_manager_->open_hash_index("hash", cols);
+
+    std::vector<std::thread> threads;
+    std::atomic<int> errors{0};
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < per_thread; i++) {
+                int key = i * num_threads + t;
+                if (!hh->insert_entry(reinterpret_cast<const char *>(&key), make_rid(key), nullptr)) {
+                    errors++;
+                }
+                // 查找本线程刚插入的键，并删除其中的一部分
+                Rid rid;
+                if (!lookup(hh.get(), key, &rid) || !(rid == make_rid(key))) {
+                    errors++;
+                }
+                if (i % 3 == 0 && !hh->delete_entry(reinterpret_cast<const char *>(&key), nullptr)) {
+                    errors++;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(errors.load(), 0);
+
+    int expected = 0;
+    for (int t = 0; t < num_threads; t++) {
+        for (int i = 0; i < per_thread; i++) {
+            int key = i * num_threads + t;
+            Rid rid;
+            ASSERT_EQ(lookup(hh.get(), key, &rid), i % 3 != 0);
+            expected += i % 3 != 0;
+        }
+    }
+    int num_keys;
+    check_buckets(hh.get(), &num_keys);
+    ASSERT_EQ(num_keys, expected);
+    ix_manager_->close_index(hh.get());
+}
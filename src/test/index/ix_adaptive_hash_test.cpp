@@ -0,0 +1,179 @@
+#include <atomic>
+#include <random>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#define private public
+#include "index/ix.h"
+#undef private  // for use private variables in "ix.h"
+
+#include "test/test_fixture.h"
+
+/** 对于每个测试点，先创建和进入目录IxAdaptiveHashTest_db，然后在此目录下创建并打开一个INT索引 */
+class IxAdaptiveHashTest : public StorageTest {
+   public:
+    std::unique_ptr<IxIndexHandle> ih_;
+    std::vector<ColMeta> cols_ = {{"ahi", "k", TYPE_INT, sizeof(int), 0, false}};
+
+   public:
+    IxAdaptiveHashTest() : StorageTest("IxAdaptiveHashTest_db", 200) {}
+
+    // This function is called before every test.
+    void SetUp() override {
+        StorageTest::SetUp();
+        ix_manager_->create_index("ahi", cols_);
+        ih_ = ix_manager_->open_index("ahi", cols_);
+    }
+
+    // This function is called after every test.
+    void TearDown() override {
+        ix_manager_->close_index(ih_.get());
+        StorageTest::TearDown();
+    }
+
+    bool lookup(int key, Rid *rid) {
+        std::vector<Rid> result;
+        bool found = ih_->get_value(reinterpret_cast<const char *>(&key), &result, nullptr);
+        if (found) {
+            *rid = result[0];
+        }
+        return found;
+    }
+
+    void insert(int key) {
+        ih_->insert_entry(reinterpret_cast<const char *>(&key), make_rid(key), nullptr);
+    }
+
+    bool erase(int key) { return ih_->delete_entry(reinterpret_cast<const char *>(&key), nullptr); }
+};
+
+/**
+ * @brief 热点键多次查找后跳过下降；分裂移动槽位、删除键、合并删除叶结点后哈希项失效，结果仍然正确
+ */
+TEST_F(IxAdaptiveHashTest, HotKeysAndInvalidation) {
+    const int n = 5000;
+    for (int i = 0; i < n; i++) {
+        insert(i * 2);
+    }
+    const std::vector<int> hot = {0, 1000, 4000, 9998};
+    Rid rid;
+    for (int round = 0; round < 10; round++) {
+        for (int key : hot) {
+            ASSERT_TRUE(lookup(key, &rid));
+            ASSERT_EQ(rid, make_rid(key));
+        }
+    }
+    uint64_t hits = ih_->adaptive_hash_hits();
+    EXPECT_GE(hits, hot.size() * (10 - IX_AHI_HOT_THRESHOLD));
+
+    // 插入奇数键，叶结点分裂，热点键移到别的叶结点或槽位
+    for (int i = 0; i < n; i++) {
+        insert(i * 2 + 1);
+    }
+    for (int round = 0; round < 3; round++) {
+        for (int key : hot) {
+            ASSERT_TRUE(lookup(key, &rid));
+            ASSERT_EQ(rid, make_rid(key));
+        }
+    }
+    EXPECT_GT(ih_->adaptive_hash_hits(), hits);
+
+    // 删除一个热点键，以及除了热点键之外的大部分键，叶结点合并
+    ASSERT_TRUE(erase(1000));
+    ASSERT_FALSE(lookup(1000, &rid));
+    for (int key = 0; key < n * 2; key++) {
+        if (key != 0 && key != 4000 && key != 9998 && key != 1000 && key % 50 != 0) {
+            ASSERT_TRUE(erase(key));
+        }
+    }
+    for (int round = 0; round < 5; round++) {
+        for (int key : {0, 4000, 9998}) {
+            ASSERT_TRUE(lookup(key, &rid));
+            ASSERT_EQ(rid, make_rid(key));
+        }
+        ASSERT_FALSE(lookup(1000, &rid));
+        ASSERT_TRUE(lookup(50, &rid));
+    }
+    // 删除后重新插入，新的位置
+    insert(1000);
+    for (int round = 0; round < 5; round++) {
+        ASSERT_TRUE(lookup(1000, &rid));
+        ASSERT_EQ(rid, make_rid(1000));
+    }
+}
+
+/**
+ * @brief 大量只查找一次的冷键映射到热点键的槽位，热点键的位置仍然保留，下一次查找直接命中
+ */
+TEST_F(IxAdaptiveHashTest, ColdLookupsKeepHotKeys) {
+    const int n = IX_AHI_NUM_SLOTS * 32;
+    for (int i = 0; i < n; i++) {
+        insert(i);
+    }
+    std::vector<int> hot;
+    for (int i = 0; i < 16; i++) {
+        hot.push_back(i * (n / 16));
+    }
+    Rid rid;
+    for (int round = 0; round < 10; round++) {
+        for (int key : hot) {
+            ASSERT_TRUE(lookup(key, &rid));
+        }
+    }
+    // 每个键查找一次，平均每个槽位被32个冷键映射到
+    for (int key = 0; key < n; key++) {
+        ASSERT_TRUE(lookup(key, &rid));
+        ASSERT_EQ(rid, make_rid(key));
+    }
+    uint64_t hits = ih_->adaptive_hash_hits();
+    for (int key : hot) {
+        ASSERT_TRUE(lookup(key, &rid));
+        ASSERT_EQ(rid, make_rid(key));
+    }
+    EXPECT_EQ(ih_->adaptive_hash_hits(), hits + hot.size());
+}
+
+/**
+ * @brief 多个线程反复查找少量热点键，同时另一些线程插入删除其他键引起分裂和合并
+ */
+TEST_F(IxAdaptiveHashTest, ConcurrentSkewedLookups) {
+    const int n = 20000;
+    for (int i = 0; i < n; i += 2) {
+        insert(i);
+    }
+    std::atomic<bool> stop{false};
+    std::atomic<int> errors{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&, t] {
+            std::mt19937 rng(t);
+            while (!stop) {
+                int key = static_cast<int>(rng() % 16) * 1000;  // 热点键都是偶数，不会被删除
+                Rid rid;
+                if (!lookup(key, &rid) || !(rid == make_rid(key))) {
+                    errors++;
+                }
+            }
+        });
+    }
+    std::thread writer([&] {
+        for (int round = 0; round < 3; round++) {
+            for (int i = 1; i < n; i += 2) {
+                insert(i);
+            }
+            for (int i = 1; i < n; i += 2) {
+                if (!erase(i)) {
+                    errors++;
+                }
+            }
+        }
+        stop = true;
+    });
+    writer.join();
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(errors.load(), 0);
+    EXPECT_GT(ih_->adaptive_hash_hits(), 0u);
+}
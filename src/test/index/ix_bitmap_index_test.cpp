@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+
+#include "gtest/gtest.h"
+
+#define private public
+#include "index/ix.h"
+#undef private  // for use private variables in "ix.h"
+
+#include "test/test_fixture.h"
+
+using RidSet = std::set<Rid, RidLess>;
+
+/** 对于每个测试点，先创建和进入目录IxBitmapIndexTest_db */
+class IxBitmapIndexTest : public StorageTest {
+   public:
+    std::vector<ColMeta> cols_ = {{"bmi", "k", TYPE_INT, sizeof(int), 0, false}};
+
+   public:
+    IxBitmapIndexTest() : StorageTest("IxBitmapIndexTest_db", 200) {}
+
+    static RidSet to_set(const IxBitmap &bitmap) {
+        std::vector<Rid> rids;
+        bitmap.to_rids(&rids);
+        EXPECT_TRUE(std::is_sorted(rids.begin(), rids.end(), RidLess()));
+        EXPECT_EQ(rids.size(), bitmap.cardinality());
+        return RidSet(rids.begin(), rids.end());
+    }
+};
+
+/**
+ * @brief 随机增删rid，与std::set对照；稠密的页面转为位图容器，删空后转回数组容器；
+ * 交集、并集和序列化后的结果都与std::set一致
+ */
+TEST_F(IxBitmapIndexTest, BitmapMatchesSet) {
+    std::mt19937 rng(7);
+    IxBitmap a, b;
+    RidSet sa, sb;
+    for (int i = 0; i < 20000; i++) {
+        // 页面1~3稠密，其余页面稀疏
+        int page_no = rng() % 4 == 0 ? 1 + rng() % 3 : 4 + rng() % 5000;
+        Rid rid{page_no, static_cast<int>(rng() % 300)};
+        bool to_a = rng() % 2 == 0;
+        IxBitmap &bitmap = to_a ? a : b;
+        RidSet &set = to_a ? sa : sb;
+        if (rng() % 4 == 0) {
+            ASSERT_EQ(bitmap.remove(rid), set.erase(rid) > 0);
+        } else {
+            ASSERT_EQ(bitmap.add(rid), set.insert(rid).second);
+        }
+        ASSERT_EQ(bitmap.cardinality(), set.size());
+    }
+    EXPECT_TRUE(a.containers_.at(1).is_bitmap());
+    auto sparse = std::find_if(a.containers_.begin(), a.containers_.end(),
+                               [](auto &entry) { return entry.second.cardinality() == 1; });
+    ASSERT_NE(sparse, a.containers_.end());
+    EXPECT_FALSE(sparse->second.is_bitmap());
+    for (auto &rid : sa) {
+        ASSERT_TRUE(a.contains(rid));
+    }
+    EXPECT_EQ(to_set(a), sa);
+
+    RidSet expect_and, expect_or;
+    std::set_intersection(sa.begin(), sa.end(), sb.begin(), sb.end(),
+                          std::inserter(expect_and, expect_and.end()), RidLess());
+    std::set_union(sa.begin(), sa.end(), sb.begin(), sb.end(),
+                   std::inserter(expect_or, expect_or.end()), RidLess());
+    IxBitmap and_bitmap = a;
+    and_bitmap &= b;
+    EXPECT_EQ(to_set(and_bitmap), expect_and);
+    IxBitmap or_bitmap = a;
+    or_bitmap |= b;
+    EXPECT_EQ(to_set(or_bitmap), expect_or);
+
+    std::vector<char> buf(or_bitmap.serialized_size());
+    ASSERT_EQ(or_bitmap.serialize(buf.data()), buf.data() + buf.size());
+    IxBitmap copy;
+    ASSERT_EQ(copy.deserialize(buf.data()), buf.data() + buf.size());
+    EXPECT_EQ(to_set(copy), expect_or);
+
+    // 把稠密页面上的槽位几乎删光，位图容器转回数组容器
+    for (int slot = 0; slot < 299; slot++) {
+        a.remove(Rid{1, slot});
+    }
+    EXPECT_LE(a.containers_.count(1) == 0 ? 0 : a.containers_.at(1).cardinality(), 1);
+    if (a.containers_.count(1) > 0) {
+        EXPECT_FALSE(a.containers_.at(1).is_bitmap());
+    }
+}
+
+/**
+ * @brief 位图索引的键可以重复：等值和范围查找与逐项维护的结果一致，删除只去掉指定的rid，
+ * 关闭后重新打开内容不变
+ */
+TEST_F(IxBitmapIndexTest, DuplicateKeysRangeAndReopen) {
+    ix_manager_->create_bitmap_index("bmi", cols_);
+    auto bh = ix_manager_->open_bitmap_index("bmi", cols_);
+    std::map<int, RidSet> expect;
+    const int n = 30000;
+    for (int i = 0; i < n; i++) {
+        int key = i % 7 - 3;  // 只有7种取值，含负数
+        Rid rid{i / 150 + 1, i % 150};
+        ASSERT_TRUE(bh->insert_entry(reinterpret_cast<const char *>(&key), rid, nullptr));
+        expect[key].insert(rid);
+    }
+    int dup = 0;
+    ASSERT_FALSE(bh->insert_entry(reinterpret_cast<const char *>(&dup), Rid{1, 3}, nullptr));
+    for (int i = 0; i < n; i += 3) {
+        int key = i % 7 - 3;
+        Rid rid{i / 150 + 1, i % 150};
+        ASSERT_TRUE(bh->delete_entry(reinterpret_cast<const char *>(&key), rid, nullptr));
+        ASSERT_FALSE(bh->delete_entry(reinterpret_cast<const char *>(&key), rid, nullptr));
+        expect[key].erase(rid);
+    }
+
+    auto check = [&](IxBitmapIndexHandle *handle) {
+        EXPECT_EQ(handle->num_keys(), expect.size());
+        for (auto &[key, rids] : expect) {
+            EXPECT_EQ(to_set(handle->get_bitmap(reinterpret_cast<const char *>(&key))), rids);
+        }
+        int missing = 100;
+        EXPECT_TRUE(handle->get_bitmap(reinterpret_cast<const char *>(&missing)).empty());
+        // -1 <= k < 2
+        int lo = -1, hi = 2;
+        RidSet range;
+        for (int key = lo; key < hi; key++) {
+            range.insert(expect[key].begin(), expect[key].end());
+        }
+        EXPECT_EQ(to_set(handle->get_range_bitmap(reinterpret_cast<const char *>(&lo), true,
+                                                  reinterpret_cast<const char *>(&hi), false)),
+                  range);
+        // k > 2，没有上界
+        EXPECT_EQ(to_set(handle->get_range_bitmap(reinterpret_cast<const char *>(&hi), false,
+                                                  nullptr, true)),
+                  expect[3]);
+        // 下界大于上界
+        EXPECT_TRUE(handle->get_range_bitmap(reinterpret_cast<const char *>(&hi), true,
+                                             reinterpret_cast<const char *>(&lo), true)
+                        .empty());
+    };
+    check(bh.get());
+
+    ix_manager_->close_index(bh.get());
+    bh = ix_manager_->open_bitmap_index("bmi", cols_);
+    check(bh.get());
+    ix_manager_->close_index(bh.get());
+}
+
+/**
+ * @brief 位图按堆页面号分段存放在缓冲池的页面中：段数超过缓冲池的页面数时结果仍然正确；
+ * 删空一个键后它的段页面被之后的插入重用，关闭后重新打开内容不变
+ */
+TEST_F(IxBitmapIndexTest, SegmentsPagedThroughBufferPool) {
+    ix_manager_->create_bitmap_index("bmi", cols_);
+    auto bh = ix_manager_->open_bitmap_index("bmi", cols_);
+    std::map<int, RidSet> expect;
+    const int num_pages = 30000;
+    for (int key = 0; key < 3; key++) {
+        for (int page_no = 1; page_no <= num_pages; page_no++) {
+            Rid rid{page_no, (page_no * 7 + key) % 100};
+            ASSERT_TRUE(bh->insert_entry(reinterpret_cast<const char *>(&key), rid, nullptr));
+            expect[key].insert(rid);
+        }
+    }
+    EXPECT_GT(bh->num_segments(), 200u);  // 多于缓冲池的页面数
+    for (auto &[key, rids] : expect) {
+        ASSERT_EQ(to_set(bh->get_bitmap(reinterpret_cast<const char *>(&key))), rids);
+    }
+
+    int num_file_pages = bh->get_file_hdr()->num_pages_;
+    int gone = 0;
+    for (auto &rid : expect[gone]) {
+        ASSERT_TRUE(bh->delete_entry(reinterpret_cast<const char *>(&gone), rid, nullptr));
+    }
+    expect.erase(gone);
+    EXPECT_EQ(bh->num_keys(), 2u);
+    int key = 3;
+    for (int page_no = 1; page_no <= num_pages; page_no++) {
+        Rid rid{page_no, page_no % 100};
+        ASSERT_TRUE(bh->insert_entry(reinterpret_cast<const char *>(&key), rid, nullptr));
+        expect[key].insert(rid);
+    }
+    EXPECT_LE(bh->get_file_hdr()->num_pages_, num_file_pages + 2);
+
+    ix_manager_->close_index(bh.get());
+    bh = ix_manager_->open_bitmap_index("bmi", cols_);
+    EXPECT_EQ(bh->num_keys(), expect.size());
+    for (auto &[k, rids] : expect) {
+        ASSERT_EQ(to_set(bh->get_bitmap(reinterpret_cast<const char *>(&k))), rids);
+    }
+    int lo = 2;
+    RidSet all = expect[2];
+    all.insert(expect[3].begin(), expect[3].end());
+    EXPECT_EQ(to_set(bh->get_range_bitmap(reinterpret_cast<const char *>(&lo), true, nullptr, true)), all);
+    ix_manager_->close_index(bh.get());
+}
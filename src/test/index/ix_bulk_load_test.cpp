@@ -0,0 +1,710 @@
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <climits>
+#include <cstdio>
+#include <random>  // for std::default_random_engine
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#define private public
+#include "index/ix.h"
+#undef private  // for use private variables in "ix.h"
+
+#include "record/rm.h"
+#include "storage/buffer_pool_manager.h"
+#include "system/sm.h"
+
+const std::string TEST_DB_NAME = "IxBulkLoadTest_db";  // 以数据库名作为根目录
+const std::string TEST_FILE_NAME = "table1";          // 测试表名
+const std::vector<std::string> TEST_COL = {"col1"};
+
+/** 对于每个测试点，先创建和进入目录TEST_DB_NAME，然后在此目录下创建表TEST_FILE_NAME */
+class IxBulkLoadTest : public ::testing::Test {
+   public:
+    std::unique_ptr<DiskManager> disk_manager_;
+    std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+    std::unique_ptr<IxManager> ix_manager_;
+    std::unique_ptr<RmManager> rm_;
+    std::unique_ptr<SmManager> sm_;
+
+   public:
+    // This function is called before every test.
+    void SetUp() override {
+        ::testing::Test::SetUp();
+        disk_manager_ = std::make_unique<DiskManager>();
+        buffer_pool_manager_ = std::make_unique<BufferPoolManager>(200, disk_manager_.get());
+        ix_manager_ = std::make_unique<IxManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        rm_ = std::make_unique<RmManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        sm_ = std::make_unique<SmManager>(disk_manager_.get(), buffer_pool_manager_.get(), rm_.get(),
+                                          ix_manager_.get());
+
+        if (disk_manager_->is_dir(TEST_DB_NAME)) {
+            std::string cmd = "rm -rf " + TEST_DB_NAME;
+            if (system(cmd.c_str()) < 0) {
+                throw UnixError();
+            }
+        }
+        sm_->create_db(TEST_DB_NAME);
+        if (chdir(TEST_DB_NAME.c_str()) < 0) {
+            throw UnixError();
+        }
+        std::vector<ColDef> coldef;
+        coldef.push_back({"col1", TYPE_INT, 4});
+        coldef.push_back({"col2", TYPE_INT, 4});
+        sm_->create_table(TEST_FILE_NAME, coldef, nullptr);
+    }
+
+    // This function is called after every test.
+    void TearDown() override {
+        if (chdir("..") < 0) {
+            throw UnixError();
+        }
+    }
+
+    /**
+     * @brief 检查以page_no为根的子树：结点大小、父指针以及父结点中的key是否等于孩子的第一个key
+     * @return 子树中键值对的数量
+     */
+    int check_subtree(IxIndexHandle *ih, int page_no) {
+        IxNodeHandle *node = ih->fetch_node(page_no);
+        int max_keys = ih->file_hdr_->btree_order_;
+        EXPECT_LE(node->get_size(), max_keys);
+        if (!node->is_root_page()) {
+            EXPECT_GE(node->get_size(), node->get_min_size());
+        }
+        int num_keys = node->get_size();
+        if (!node->is_leaf_page()) {
+            num_keys = 0;
+            for (int i = 0; i < node->get_size(); i++) {
+                IxNodeHandle *child = ih->fetch_node(node->value_at(i));
+                EXPECT_EQ(child->get_parent_page_no(), page_no);
+                EXPECT_EQ(node->key_at(i), child->key_at(0));
+                ih->unpin_node(child, false);
+                num_keys += check_subtree(ih, node->value_at(i));
+            }
+        }
+        ih->unpin_node(node, false);
+        return num_keys;
+    }
+
+    /**
+     * @brief 检查树的结构，并沿叶结点链表检查key严格递增且与expected一致
+     */
+    void check_index(IxIndexHandle *ih, const std::vector<int> &expected) {
+        EXPECT_EQ(check_subtree(ih, ih->file_hdr_->root_page_), (int)expected.size());
+
+        std::vector<int> keys;
+        page_id_t prev_no = IX_LEAF_HEADER_PAGE;
+        page_id_t leaf_no = ih->file_hdr_->first_leaf_;
+        while (leaf_no != IX_LEAF_HEADER_PAGE) {
+            IxNodeHandle *leaf = ih->fetch_node(leaf_no);
+            EXPECT_EQ(leaf->get_prev_leaf(), prev_no);
+            for (int i = 0; i < leaf->get_size(); i++) {
+                keys.push_back(leaf->key_at(i));
+            }
+            prev_no = leaf_no;
+            leaf_no = leaf->get_next_leaf();
+            ih->unpin_node(leaf, false);
+        }
+        EXPECT_EQ(ih->file_hdr_->last_leaf_, prev_no);
+        EXPECT_EQ(keys, expected);
+
+        for (int key : expected) {
+            std::vector<Rid> rids;
+            EXPECT_TRUE(ih->get_value((const char *)&key, &rids, nullptr));
+        }
+    }
+};
+
+/**
+ * @brief 内存预算很小时外部排序会写出多个段文件，归并后的结果有序，且析构时删除段文件
+ */
+TEST_F(IxBulkLoadTest, ExternalSortTest) {
+    const int scale = 20000;
+    std::vector<int> keys;
+    for (int i = 0; i < scale; i++) {
+        keys.push_back(i % 5000);
+    }
+    auto rng = std::default_random_engine{};
+    std::shuffle(keys.begin(), keys.end(), rng);
+
+    {
+        IxExternalSorter sorter(disk_manager_.get(), "sort_test", {TYPE_INT}, {4}, 4 * PAGE_SIZE);
+        for (int i = 0; i < scale; i++) {
+            sorter.add((const char *)&keys[i], Rid{.page_no = 0, .slot_no = i});
+        }
+        sorter.finish();
+        EXPECT_GT(sorter.num_runs(), 1);
+        EXPECT_EQ(sorter.size(), (size_t)scale);
+
+        int key;
+        Rid rid;
+        int count = 0;
+        int last_key = -1;
+        int last_slot = -1;
+        while (sorter.next((char *)&key, &rid)) {
+            EXPECT_EQ(key, keys[rid.slot_no]);
+            // key相同时按rid升序
+            EXPECT_TRUE(key > last_key || (key == last_key && rid.slot_no > last_slot));
+            last_key = key;
+            last_slot = rid.slot_no;
+            count++;
+        }
+        EXPECT_EQ(count, scale);
+    }
+    EXPECT_FALSE(disk_manager_->is_file("sort_test.0"));
+}
+
+/**
+ * @brief 对已有数据的表建索引，每条记录有一个索引项，建好后还可以正常插入和删除
+ */
+TEST_F(IxBulkLoadTest, CreateIndexTest) {
+    const int scale = 15000;
+    auto fh = sm_->fhs_.at(TEST_FILE_NAME).get();
+    std::vector<int> keys;
+    for (int i = 0; i < scale; i++) {
+        keys.push_back(i);
+    }
+    auto rng = std::default_random_engine{};
+    std::shuffle(keys.begin(), keys.end(), rng);
+    std::map<int, Rid> key_rid;
+    for (int i = 0; i < scale; i++) {
+        int buf[2] = {keys[i], i};
+        key_rid[keys[i]] = fh->insert_record((char *)buf, nullptr);
+    }
+
+    sm_->create_index(TEST_FILE_NAME, TEST_COL, nullptr);
+    std::string ix_name = ix_manager_->get_index_name(TEST_FILE_NAME, TEST_COL);
+    IxIndexHandle *ih = sm_->ihs_.at(ix_name).get();
+
+    std::vector<int> expected;
+    for (auto &[key, rid] : key_rid) {
+        expected.push_back(key);
+        std::vector<Rid> rids;
+        ASSERT_TRUE(ih->get_value((const char *)&key, &rids, nullptr));
+        EXPECT_EQ(rids[0], rid);
+    }
+    check_index(ih, expected);
+
+    // 批量构建后树的结构与逐条插入的树一致，可以继续修改
+    for (int key = scale; key < scale * 2; key++) {
+        ih->insert_entry((const char *)&key, Rid{.page_no = 0, .slot_no = key}, nullptr);
+        expected.push_back(key);
+    }
+    for (int key = 0; key < scale; key += 3) {
+        EXPECT_TRUE(ih->delete_entry((const char *)&key, nullptr));
+    }
+    expected.erase(std::remove_if(expected.begin(), expected.end(),
+                                  [&](int key) { return key < scale && key % 3 == 0; }),
+                   expected.end());
+    check_index(ih, expected);
+}
+
+/**
+ * @brief 多个工作线程并行扫描和排序后建索引，结果与单线程建索引一致
+ */
+TEST_F(IxBulkLoadTest, ParallelCreateIndexTest) {
+    const int scale = 30000;
+    auto fh = sm_->fhs_.at(TEST_FILE_NAME).get();
+    std::vector<int> keys;
+    for (int i = 0; i < scale; i++) {
+        keys.push_back(i);
+    }
+    auto rng = std::default_random_engine{};
+    std::shuffle(keys.begin(), keys.end(), rng);
+    std::map<int, Rid> key_rid;
+    for (int i = 0; i < scale; i++) {
+        int buf[2] = {keys[i], i};
+        key_rid[keys[i]] = fh->insert_record((char *)buf, nullptr);
+    }
+
+    SessionSettings session;
+    EXPECT_THROW(session.set("index_build_workers", 0), InvalidSessionSettingError);
+    EXPECT_THROW(session.set("no_such_setting", 4), InvalidSessionSettingError);
+    session.set("index_build_workers", 4);
+    Context context(nullptr, nullptr, nullptr, nullptr, nullptr, &session);
+    sm_->create_index(TEST_FILE_NAME, TEST_COL, &context);
+    EXPECT_EQ(sm_->last_index_build_.workers, 4);
+    EXPECT_EQ(sm_->last_index_build_.num_entries, (size_t)scale);
+    EXPECT_FALSE(disk_manager_->is_file(ix_manager_->get_index_name(TEST_FILE_NAME, TEST_COL) + ".sort0"));
+
+    IxIndexHandle *ih = sm_->ihs_.at(ix_manager_->get_index_name(TEST_FILE_NAME, TEST_COL)).get();
+    std::vector<int> expected;
+    for (auto &[key, rid] : key_rid) {
+        expected.push_back(key);
+        std::vector<Rid> rids;
+        ASSERT_TRUE(ih->get_value((const char *)&key, &rids, nullptr));
+        EXPECT_EQ(rids[0], rid);
+    }
+    check_index(ih, expected);
+}
+
+/**
+ * @brief 表中有重复的key时建B+树索引失败(单线程和并行都是)，建了一半的索引文件和元数据被删除，排序的段文件也被删除
+ */
+TEST_F(IxBulkLoadTest, DuplicateKeysTest) {
+    const int scale = 20000;
+    auto fh = sm_->fhs_.at(TEST_FILE_NAME).get();
+    for (int i = 0; i < scale; i++) {
+        int buf[2] = {i == scale - 1 ? 7 : i, i};  // 只有一对重复的key，在中间的叶结点中
+        fh->insert_record((char *)buf, nullptr);
+    }
+    std::string ix_name = ix_manager_->get_index_name(TEST_FILE_NAME, TEST_COL);
+    SessionSettings session;
+    for (int workers : {1, 4}) {
+        session.set("index_build_workers", workers);
+        Context context(nullptr, nullptr, nullptr, nullptr, nullptr, &session);
+        EXPECT_THROW(sm_->create_index(TEST_FILE_NAME, TEST_COL, &context), DuplicateKeyError);
+        EXPECT_FALSE(sm_->db_.get_table(TEST_FILE_NAME).is_index(TEST_COL));
+        EXPECT_EQ(sm_->ihs_.count(ix_name), 0u);
+        EXPECT_FALSE(disk_manager_->is_file(ix_name));
+        EXPECT_FALSE(disk_manager_->is_file(ix_name + ".sort0"));
+    }
+    // 另一个字段的key不重复，可以正常建索引
+    const std::vector<std::string> cols = {"col2"};
+    sm_->create_index(TEST_FILE_NAME, cols, nullptr);
+    IxIndexHandle *ih = sm_->ihs_.at(ix_manager_->get_index_name(TEST_FILE_NAME, cols)).get();
+    std::vector<int> expected(scale);
+    for (int i = 0; i < scale; i++) {
+        expected[i] = i;
+    }
+    check_index(ih, expected);
+}
+
+/**
+ * @brief 联合索引的键规范化存储：批量构建、逐条插入删除和IxScan的范围都按原始键的顺序
+ */
+TEST_F(IxBulkLoadTest, CompositeIndexTest) {
+    const int scale = 20000;
+    auto fh = sm_->fhs_.at(TEST_FILE_NAME).get();
+    std::vector<std::pair<int, int>> rows;
+    for (int i = 0; i < scale; i++) {
+        rows.emplace_back(i % 100 - 50, scale / 2 - i);
+    }
+    auto rng = std::default_random_engine{};
+    std::shuffle(rows.begin(), rows.end(), rng);
+    for (auto &[a, b] : rows) {
+        int buf[2] = {a, b};
+        fh->insert_record((char *)buf, nullptr);
+    }
+
+    const std::vector<std::string> cols = {"col1", "col2"};
+    sm_->create_index(TEST_FILE_NAME, cols, nullptr);
+    IxIndexHandle *ih = sm_->ihs_.at(ix_manager_->get_index_name(TEST_FILE_NAME, cols)).get();
+    ASSERT_TRUE(ih->file_hdr_->normalized());
+
+    for (int i = 0; i < scale; i += 3) {
+        int key[2] = {rows[i].first, rows[i].second};
+        EXPECT_TRUE(ih->delete_entry((const char *)key, nullptr));
+    }
+    for (int i = 0; i < scale; i += 3) {
+        int key[2] = {rows[i].first, -rows[i].second};
+        ih->insert_entry((const char *)key, Rid{.page_no = 0, .slot_no = i}, nullptr);
+        rows[i].second = -rows[i].second;
+    }
+    std::sort(rows.begin(), rows.end());
+
+    // 扫描col1 = -3的所有行，col2从小到大
+    int lower[2] = {-3, INT_MIN};
+    int upper[2] = {-3, INT_MAX};
+    IxScan scan(ih, ih->lower_bound((const char *)lower), ih->upper_bound((const char *)upper),
+                buffer_pool_manager_.get());
+    std::vector<int> scanned;
+    for (; !scan.is_end(); scan.next()) {
+        char key[8];
+        IxNodeHandle *leaf = ih->fetch_node(scan.iid().page_no);
+        leaf->copy_key(scan.iid().slot_no, key);
+        ih->unpin_node(leaf, false);
+        int raw[2];
+        ix_decode_key(key, (char *)raw, ih->file_hdr_->col_types_, ih->file_hdr_->col_lens_);
+        EXPECT_EQ(raw[0], -3);
+        scanned.push_back(raw[1]);
+    }
+    std::vector<int> expected;
+    for (auto &[a, b] : rows) {
+        if (a == -3) {
+            expected.push_back(b);
+        }
+    }
+    EXPECT_EQ(scanned, expected);
+
+    for (auto &[a, b] : rows) {
+        int key[2] = {a, b};
+        std::vector<Rid> rids;
+        EXPECT_TRUE(ih->get_value((const char *)key, &rids, nullptr));
+    }
+}
+
+/**
+ * @brief 小阶数下各种键数量和填充因子的组合，检查最后一个结点的调整以及多层内部结点
+ */
+TEST_F(IxBulkLoadTest, SmallOrderTest) {
+    const std::vector<int> scales = {0, 1, 2, 3, 4, 5, 7, 8, 9, 13, 17, 25, 64, 100, 1000};
+    const std::vector<int> orders = {3, 4, 5, 8};
+    const std::vector<double> fill_factors = {0.5, 0.7, 1.0};
+
+    // 索引句柄保持打开直到测试结束，避免关闭后文件描述符被复用时命中缓冲池中的旧页面
+    std::vector<std::unique_ptr<IxIndexHandle>> ihs;
+    for (int scale : scales) {
+        for (int order : orders) {
+            for (double fill_factor : fill_factors) {
+                std::string file_name = "bulk" + std::to_string(ihs.size());
+                std::vector<ColMeta> cols = {{file_name, "k", TYPE_INT, 4, 0, false}};
+                ix_manager_->create_index(file_name, cols);
+                ihs.push_back(ix_manager_->open_index(file_name, cols));
+                IxIndexHandle *ih = ihs.back().get();
+                ih->file_hdr_->btree_order_ = order;
+
+                int key = 0;
+                ih->bulk_load(
+                    [&](char *out_key, Rid *rid) {
+                        if (key == scale) {
+                            return false;
+                        }
+                        memcpy(out_key, &key, sizeof(int));
+                        *rid = Rid{.page_no = 0, .slot_no = key};
+                        key++;
+                        return true;
+                    },
+                    fill_factor);
+
+                std::vector<int> expected(scale);
+                for (int i = 0; i < scale; i++) {
+                    expected[i] = i;
+                }
+                SCOPED_TRACE("scale=" + std::to_string(scale) + " order=" + std::to_string(order) +
+                             " fill_factor=" + std::to_string(fill_factor));
+                check_index(ih, expected);
+            }
+        }
+    }
+    for (auto &ih : ihs) {
+        ix_manager_->close_index(ih.get());
+    }
+}
+
+/**
+ * @brief 逐条插入的叶结点分裂后约半满，批量构建的叶结点按填充因子装满，页面数更少；
+ * 只比较页面数和叶结点的平均键数，不比较耗时
+ */
+TEST_F(IxBulkLoadTest, BuildFillTest) {
+    const int scale = 200000;
+    std::vector<int> keys(scale);
+    for (int i = 0; i < scale; i++) {
+        keys[i] = i;
+    }
+    auto rng = std::default_random_engine{};
+    std::shuffle(keys.begin(), keys.end(), rng);
+
+    std::vector<ColMeta> insert_cols = {{"by_insert", "k", TYPE_INT, 4, 0, false}};
+    ix_manager_->create_index("by_insert", insert_cols);
+    auto insert_ih = ix_manager_->open_index("by_insert", insert_cols);
+    for (int i = 0; i < scale; i++) {
+        insert_ih->insert_entry((const char *)&keys[i], Rid{.page_no = 0, .slot_no = i}, nullptr);
+    }
+
+    std::vector<ColMeta> bulk_cols = {{"by_bulk", "k", TYPE_INT, 4, 0, false}};
+    ix_manager_->create_index("by_bulk", bulk_cols);
+    auto bulk_ih = ix_manager_->open_index("by_bulk", bulk_cols);
+    IxExternalSorter sorter(disk_manager_.get(), "by_bulk.sort", {TYPE_INT}, {4});
+    for (int i = 0; i < scale; i++) {
+        sorter.add((const char *)&keys[i], Rid{.page_no = 0, .slot_no = i});
+    }
+    sorter.finish();
+    ASSERT_TRUE(bulk_ih->bulk_load([&](char *key, Rid *rid) { return sorter.next(key, rid); }));
+
+    // 叶结点的平均键数占btree_order_的比例
+    auto leaf_fill = [](IxIndexHandle *ih) {
+        int num_leaves = 0;
+        int num_keys = 0;
+        for (page_id_t leaf_no = ih->file_hdr_->first_leaf_; leaf_no != IX_LEAF_HEADER_PAGE;) {
+            IxNodeHandle *leaf = ih->fetch_node(leaf_no);
+            num_leaves++;
+            num_keys += leaf->get_size();
+            leaf_no = leaf->get_next_leaf();
+            ih->unpin_node(leaf, false);
+        }
+        return static_cast<double>(num_keys) / num_leaves / ih->file_hdr_->btree_order_;
+    };
+    int order = bulk_ih->file_hdr_->btree_order_;
+    EXPECT_GE(leaf_fill(bulk_ih.get()), (static_cast<int>(IX_BULK_LOAD_FILL_FACTOR * order) - 1.0) / order);
+    EXPECT_LT(leaf_fill(insert_ih.get()), IX_BULK_LOAD_FILL_FACTOR - 0.1);
+    EXPECT_LT(bulk_ih->file_hdr_->num_pages_, insert_ih->file_hdr_->num_pages_);
+
+    ix_manager_->close_index(insert_ih.get());
+    ix_manager_->close_index(bulk_ih.get());
+}
+
+/**
+ * @brief estimate_range()只沿两条根到叶的路径估计范围内索引项的比例，
+ * 批量构建和逐个插入得到的树上误差都不超过几个百分点；空树和下界大于上界时为0
+ */
+TEST_F(IxBulkLoadTest, EstimateRangeTest) {
+    const int scale = 50000;
+    std::vector<int> keys(scale);
+    for (int i = 0; i < scale; i++) {
+        keys[i] = i * 2;
+    }
+    auto rng = std::default_random_engine{};
+    std::shuffle(keys.begin(), keys.end(), rng);
+
+    std::vector<ColMeta> insert_cols = {{"est_insert", "k", TYPE_INT, 4, 0, false}};
+    ix_manager_->create_index("est_insert", insert_cols);
+    auto insert_ih = ix_manager_->open_index("est_insert", insert_cols);
+    int lo = 0, hi = scale * 2;
+    EXPECT_EQ(insert_ih->estimate_range((const char *)&lo, (const char *)&hi), 0);
+    for (int i = 0; i < scale; i++) {
+        insert_ih->insert_entry((const char *)&keys[i], Rid{.page_no = 0, .slot_no = i}, nullptr);
+    }
+
+    std::vector<ColMeta> bulk_cols = {{"est_bulk", "k", TYPE_INT, 4, 0, false}};
+    ix_manager_->create_index("est_bulk", bulk_cols);
+    auto bulk_ih = ix_manager_->open_index("est_bulk", bulk_cols);
+    IxExternalSorter sorter(disk_manager_.get(), "est_bulk.sort", {TYPE_INT}, {4});
+    for (int i = 0; i < scale; i++) {
+        sorter.add((const char *)&keys[i], Rid{.page_no = 0, .slot_no = i});
+    }
+    sorter.finish();
+    bulk_ih->bulk_load([&](char *key, Rid *rid) { return sorter.next(key, rid); });
+
+    std::vector<std::pair<int, int>> ranges = {
+        {INT_MIN, INT_MAX}, {0, scale}, {scale / 2, scale / 2 + 1000}, {scale, scale * 3}, {-100, -1}};
+    for (auto *ih : {insert_ih.get(), bulk_ih.get()}) {
+        for (auto &[lower, upper] : ranges) {
+            int actual = std::count_if(keys.begin(), keys.end(),
+                                       [&](int key) { return key >= lower && key < upper; });
+            double estimate = ih->estimate_range((const char *)&lower, (const char *)&upper);
+            EXPECT_NEAR(estimate, (double)actual / scale, 0.03) << lower << " " << upper;
+        }
+        EXPECT_EQ(ih->estimate_range((const char *)&hi, (const char *)&lo), 0);
+    }
+
+    ix_manager_->close_index(insert_ih.get());
+    ix_manager_->close_index(bulk_ih.get());
+}
+
+/**
+ * @brief 带INCLUDE字段的索引：INCLUDE字段存放在叶结点的payload中，IxScan可以同时取出原始格式的键和payload
+ */
+TEST_F(IxBulkLoadTest, IncludeColumnsTest) {
+    const int scale = 5000;
+    auto fh = sm_->fhs_.at(TEST_FILE_NAME).get();
+    for (int i = 0; i < scale; i++) {
+        int buf[2] = {scale - i, i * 3};
+        fh->insert_record((char *)buf, nullptr);
+    }
+
+    sm_->create_index(TEST_FILE_NAME, TEST_COL, nullptr, INDEX_BTREE, {"col2"});
+    auto index = sm_->db_.get_table(TEST_FILE_NAME).get_index_meta(TEST_COL);
+    ASSERT_EQ(index->col_tot_len, 8);
+    ASSERT_TRUE(index->covers("col2"));
+    IxIndexHandle *ih = sm_->ihs_.at(ix_manager_->get_index_name(TEST_FILE_NAME, TEST_COL)).get();
+
+    int lower[2] = {100, INT_MIN};
+    int upper[2] = {199, INT_MAX};
+    IxScan scan(ih, (const char *)lower, (const char *)upper, buffer_pool_manager_.get(), true);
+    std::vector<Rid> rids;
+    std::vector<char> keys;
+    while (!scan.is_end()) {
+        scan.next_batch(&rids, &keys);
+    }
+    ASSERT_EQ(rids.size(), 100u);
+    ASSERT_EQ(keys.size(), rids.size() * 8);
+    for (size_t i = 0; i < rids.size(); i++) {
+        int raw[2];
+        memcpy(raw, keys.data() + i * 8, sizeof(raw));
+        EXPECT_EQ(raw[0], 100 + (int)i);
+        EXPECT_EQ(raw[1], (scale - raw[0]) * 3);
+        auto rec = fh->get_record(rids[i], nullptr);
+        EXPECT_EQ(memcmp(rec->data, raw, sizeof(raw)), 0);
+    }
+}
+
+/**
+ * @brief INCLUDE字段不属于键：单个INT字段的键仍按INT查找，重复的键即使INCLUDE字段不同也不会插入，
+ * 删除只按键；叶结点分裂、合并时payload随键值对移动
+ */
+TEST_F(IxBulkLoadTest, IncludeColumnsNotInKeyTest) {
+    const int scale = 20000;
+    std::vector<ColMeta> cols = {{"incl", "k", TYPE_INT, 4, 0, false}};
+    std::vector<ColMeta> include = {{"incl", "v", TYPE_STRING, 60, 4, false}};
+    ix_manager_->create_index("incl", cols, include);
+    auto ih = ix_manager_->open_index("incl", cols);
+    ASSERT_EQ(ih->file_hdr_->key_kind_, IX_KEY_INT);
+    ASSERT_EQ(ih->file_hdr_->col_tot_len_, 4);
+    ASSERT_EQ(ih->file_hdr_->payload_len_, 60);
+    ASSERT_LT(ih->file_hdr_->leaf_order_, ih->file_hdr_->btree_order_);
+
+    auto make_entry = [](int k, int version) {
+        std::string entry(64, '\0');
+        memcpy(&entry[0], &k, sizeof(int));
+        snprintf(&entry[4], 60, "value-%d-%d", k, version);
+        return entry;
+    };
+    std::vector<int> keys(scale);
+    for (int i = 0; i < scale; i++) {
+        keys[i] = i;
+    }
+    std::shuffle(keys.begin(), keys.end(), std::default_random_engine(39));
+    for (int k : keys) {
+        ASSERT_NE(ih->insert_entry(make_entry(k, 0).data(), Rid{k, 0}, nullptr), IX_NO_PAGE);
+    }
+    // 键相同、INCLUDE字段不同的项是重复的键
+    for (int k = 0; k < scale; k += 7) {
+        ASSERT_EQ(ih->insert_entry(make_entry(k, 1).data(), Rid{k, 1}, nullptr), IX_NO_PAGE);
+    }
+    // 删除一半的键，触发合并和重分配，删除只需要键
+    for (int k : keys) {
+        if (k % 2 == 1) {
+            ASSERT_TRUE(ih->delete_entry((const char *)&k, nullptr));
+        }
+    }
+    for (int k = 0; k < scale; k++) {
+        std::vector<Rid> rids;
+        ASSERT_EQ(ih->get_value((const char *)&k, &rids, nullptr), k % 2 == 0);
+        if (k % 2 == 0) {
+            ASSERT_EQ(rids[0], (Rid{k, 0}));
+        }
+    }
+
+    IxScan scan(ih.get(), nullptr, nullptr, buffer_pool_manager_.get(), true);
+    std::vector<Rid> rids;
+    std::vector<char> entries;
+    while (!scan.is_end()) {
+        scan.next_batch(&rids, &entries);
+    }
+    ASSERT_EQ(rids.size(), static_cast<size_t>(scale / 2));
+    ASSERT_EQ(entries.size(), rids.size() * 64);
+    for (size_t i = 0; i < rids.size(); i++) {
+        int k = i * 2;
+        ASSERT_EQ(rids[i], (Rid{k, 0}));
+        ASSERT_EQ(std::string(entries.data() + i * 64, 64), make_entry(k, 0));
+    }
+    ix_manager_->close_index(ih.get());
+}
+
+/**
+ * @brief 布隆过滤器：建索引时生成，之后插入的键也加入过滤器；不存在漏判，误判率接近预期；关闭后重新打开仍然有效
+ */
+TEST_F(IxBulkLoadTest, BloomFilterTest) {
+    const int scale = 20000;
+    std::vector<ColMeta> cols = {{"bloom", "k", TYPE_INT, 4, 0, false}};
+    ix_manager_->create_index("bloom", cols);
+    auto ih = ix_manager_->open_index("bloom", cols);
+    int next = 0;
+    ih->bulk_load([&](char *key, Rid *rid) {
+        if (next == scale) {
+            return false;
+        }
+        int k = next * 2;  // 偶数在索引中
+        memcpy(key, &k, sizeof(int));
+        *rid = Rid{next / 100 + 1, next % 100};
+        next++;
+        return true;
+    });
+    ih->build_bloom_filter(sizeof(int), 10);
+    ASSERT_NE(ih->get_bloom_filter(), nullptr);
+    for (int i = 0; i < 1000; i++) {
+        int k = scale * 2 + i * 2;
+        ASSERT_NE(ih->insert_entry((const char *)&k, Rid{0, i}, nullptr), IX_NO_PAGE);
+    }
+
+    auto check = [&](IxIndexHandle *handle) {
+        int false_positives = 0;
+        for (int i = 0; i < scale + 1000; i++) {
+            int even = i * 2, odd = i * 2 + 1;
+            ASSERT_TRUE(handle->may_contain((const char *)&even));
+            std::vector<Rid> rids;
+            ASSERT_TRUE(handle->get_value((const char *)&even, &rids, nullptr));
+            false_positives += handle->may_contain((const char *)&odd);
+            ASSERT_FALSE(handle->get_value((const char *)&odd, &rids, nullptr));
+        }
+        // 按2倍键数、每键10位分配，实际约每键20位
+        EXPECT_LT(false_positives, (scale + 1000) / 100);
+    };
+    check(ih.get());
+
+    int num_blocks = ih->get_bloom_filter()->num_blocks();
+    ix_manager_->close_index(ih.get());
+    auto reopened = ix_manager_->open_index("bloom", cols);
+    ASSERT_NE(reopened->get_bloom_filter(), nullptr);
+    EXPECT_EQ(reopened->get_bloom_filter()->num_blocks(), num_blocks);
+    check(reopened.get());
+
+    // 删除不存在的键不访问页面，删除存在的键后它仍可能被过滤器判为存在，但查不到
+    int odd = 1, even = 0;
+    EXPECT_FALSE(reopened->delete_entry((const char *)&odd, nullptr));
+    EXPECT_TRUE(reopened->delete_entry((const char *)&even, nullptr));
+    std::vector<Rid> rids;
+    EXPECT_FALSE(reopened->get_value((const char *)&even, &rids, nullptr));
+    ix_manager_->close_index(reopened.get());
+}
+
+/**
+ * @brief 建索引之后插入的键超过过滤器的容量：VACUUM式的直接重建和后台合并线程的自动重建都把过滤器扩大，
+ * 重建后没有漏判、误判率回到预期；键数写入文件头，重新打开后仍能判断过滤器是否已满
+ */
+TEST_F(IxBulkLoadTest, BloomFilterRebuildTest) {
+    const int scale = 2000;
+    std::vector<ColMeta> cols = {{"bloom", "k", TYPE_INT, 4, 0, false}};
+    ix_manager_->create_index("bloom", cols);
+    auto ih = ix_manager_->open_index("bloom", cols);
+    int next = 0;
+    ih->bulk_load([&](char *key, Rid *rid) {
+        if (next == scale) {
+            return false;
+        }
+        int k = next * 2;
+        memcpy(key, &k, sizeof(int));
+        *rid = Rid{next / 100 + 1, next % 100};
+        next++;
+        return true;
+    });
+    ih->build_bloom_filter(sizeof(int), 10);
+    int num_blocks = ih->get_bloom_filter()->num_blocks();
+    int total = scale;
+    auto insert_more = [&](IxIndexHandle *handle, int count) {
+        for (int i = 0; i < count; i++, total++) {
+            int k = total * 2;
+            handle->insert_entry((const char *)&k, Rid{total / 100 + 1, total % 100}, nullptr);
+        }
+    };
+    auto check = [&](IxIndexHandle *handle) {
+        int false_positives = 0;
+        for (int i = 0; i < total; i++) {
+            int even = i * 2, odd = i * 2 + 1;
+            ASSERT_TRUE(handle->may_contain((const char *)&even));
+            false_positives += handle->may_contain((const char *)&odd);
+        }
+        EXPECT_LT(false_positives, total / 100);
+    };
+
+    insert_more(ih.get(), scale * 4);
+    EXPECT_TRUE(ih->bloom_filter_full());
+    ih->rebuild_bloom_filter();
+    EXPECT_FALSE(ih->bloom_filter_full());
+    EXPECT_GT(ih->get_bloom_filter()->num_blocks(), num_blocks);
+    check(ih.get());
+
+    // 启用修改缓冲后由后台合并线程在过滤器满了时重建
+    num_blocks = ih->get_bloom_filter()->num_blocks();
+    ih->enable_change_buffer();
+    insert_more(ih.get(), total * 2);
+    for (int i = 0; i < 500 && ih->bloom_filter_full(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_FALSE(ih->bloom_filter_full());
+    EXPECT_GT(ih->get_bloom_filter()->num_blocks(), num_blocks);
+    check(ih.get());
+
+    // 没有修改缓冲时不自动重建，满了的过滤器关闭后仍是满的
+    ih->disable_change_buffer();
+    insert_more(ih.get(), total * 2);
+    ix_manager_->close_index(ih.get());
+    auto reopened = ix_manager_->open_index("bloom", cols);
+    EXPECT_TRUE(reopened->bloom_filter_full());
+    reopened->rebuild_bloom_filter();
+    check(reopened.get());
+    ix_manager_->close_index(reopened.get());
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <map>
+#include <random>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#define private public
+#include "index/ix.h"
+#undef private  // for use private variables in "ix.h"
+
+#include "test/test_fixture.h"
+
+/** 对于每个测试点，先创建和进入目录IxChangeBufferTest_db，然后在此目录下创建并打开一个启用修改缓冲的INT索引 */
+class IxChangeBufferTest : public StorageTest {
+   public:
+    std::unique_ptr<IxIndexHandle> ih_;
+    std::vector<ColMeta> cols_ = {{"cb", "k", TYPE_INT, sizeof(int), 0, false}};
+
+   public:
+    // 缓冲池很小，大部分叶结点不在缓冲池中
+    IxChangeBufferTest() : StorageTest("IxChangeBufferTest_db", 64) {}
+
+    // This function is called before every test.
+    void SetUp() override {
+        StorageTest::SetUp();
+        ix_manager_->create_index("cb", cols_);
+        ih_ = ix_manager_->open_index("cb", cols_);
+        ih_->enable_change_buffer();
+    }
+
+    // This function is called after every test.
+    void TearDown() override {
+        if (ih_ != nullptr) {
+            ix_manager_->close_index(ih_.get());
+        }
+        StorageTest::TearDown();
+    }
+
+    /**
+     * @brief 用IxScan扫描[lower, upper]，返回键到rid的映射
+     */
+    std::map<int, Rid> scan(int lower, int upper) {
+        std::map<int, Rid> result;
+        IxScan scan(ih_.get(), reinterpret_cast<const char *>(&lower),
+                    reinterpret_cast<const char *>(&upper), buffer_pool_manager_.get(), true);
+        std::vector<Rid> rids;
+        std::vector<char> keys;
+        while (!scan.is_end()) {
+            scan.next_batch(&rids, &keys);
+        }
+        for (size_t i = 0; i < rids.size(); i++) {
+            result[*reinterpret_cast<const int *>(keys.data() + i * sizeof(int))] = rids[i];
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief 随机插入和删除(含重复插入和删除不存在的键)，与std::map对照：
+ * 大部分修改被缓存，等值查找、范围扫描前合并的结果与逐个修改B+树一致，关闭后重新打开内容不变
+ */
+TEST_F(IxChangeBufferTest, MatchesDirectModification) {
+    std::mt19937 rng(11);
+    std::map<int, Rid> expect;
+    const int key_space = 60000;
+    for (int i = 0; i < 200000; i++) {
+        int key = rng() % key_space;
+        if (rng() % 4 == 0) {
+            ih_->delete_entry(reinterpret_cast<const char *>(&key), nullptr);
+            expect.erase(key);
+        } else {
+            Rid rid = make_rid(key, rng() % 8);
+            ih_->insert_entry(reinterpret_cast<const char *>(&key), rid, nullptr);
+            expect.emplace(key, rid);  // 键已存在时插入被忽略
+        }
+        if (i % 5000 == 0) {
+            // 等值查找只合并这个键
+            int probe = rng() % key_space;
+            std::vector<Rid> rids;
+            bool found = ih_->get_value(reinterpret_cast<const char *>(&probe), &rids, nullptr);
+            ASSERT_EQ(found, expect.count(probe) > 0);
+            if (found) {
+                ASSERT_EQ(rids[0], expect.at(probe));
+            }
+        }
+    }
+    EXPECT_GT(ih_->get_change_buffer()->buffered(), 50000u);
+
+    auto expect_range = [&](int lower, int upper) {
+        return std::map<int, Rid>(expect.lower_bound(lower), expect.upper_bound(upper));
+    };
+    EXPECT_EQ(scan(1000, 2000), expect_range(1000, 2000));
+    EXPECT_EQ(scan(INT_MIN, INT_MAX), expect);
+    EXPECT_TRUE(ih_->get_change_buffer()->empty());
+
+    ix_manager_->close_index(ih_.get());
+    ih_ = ix_manager_->open_index("cb", cols_);
+    EXPECT_EQ(scan(INT_MIN, INT_MAX), expect);
+}
+
+/**
+ * @brief 多个线程并发插入互不相交的键，同时有线程查找已经插入的键，插入后立即可见；
+ * 后台合并线程和读时合并交替进行，最终所有键都在B+树中
+ */
+TEST_F(IxChangeBufferTest, ConcurrentInsertAndRead) {
+    const int num_writers = 4;
+    const int keys_per_writer = 20000;
+    std::atomic<int> progress[num_writers];
+    for (auto &p : progress) {
+        p = 0;
+    }
+    std::vector<std::thread> threads;
+    for (int w = 0; w < num_writers; w++) {
+        threads.emplace_back([&, w] {
+            std::vector<int> keys(keys_per_writer);
+            for (int i = 0; i < keys_per_writer; i++) {
+                keys[i] = i * num_writers + w;
+            }
+            for (int i = 0; i < keys_per_writer; i++) {
+                ih_->insert_entry(reinterpret_cast<const char *>(&keys[i]), make_rid(keys[i], 0),
+                                  nullptr);
+                progress[w] = i + 1;
+            }
+        });
+    }
+    std::atomic<int> misses{0};
+    std::thread reader([&] {
+        std::mt19937 rng(5);
+        for (int i = 0; i < 20000; i++) {
+            int w = rng() % num_writers;
+            int done = progress[w];
+            if (done == 0) {
+                continue;
+            }
+            int key = (rng() % done) * num_writers + w;
+            std::vector<Rid> rids;
+            if (!ih_->get_value(reinterpret_cast<const char *>(&key), &rids, nullptr) ||
+                !(rids[0] == make_rid(key, 0))) {
+                misses++;
+            }
+        }
+    });
+    for (auto &t : threads) {
+        t.join();
+    }
+    reader.join();
+    EXPECT_EQ(misses, 0);
+
+    auto all = scan(INT_MIN, INT_MAX);
+    ASSERT_EQ(all.size(), static_cast<size_t>(num_writers * keys_per_writer));
+    for (auto &[key, rid] : all) {
+        ASSERT_EQ(rid, make_rid(key, 0));
+    }
+}
+
+/**
+ * @brief 两个索引共用一个后台合并线程：不做任何读取，缓冲过半后也都被合并到一半以下
+ */
+TEST_F(IxChangeBufferTest, SharedMergerDrainsEveryIndex) {
+    ix_manager_->create_index("cb2", cols_);
+    auto ih2 = ix_manager_->open_index("cb2", cols_);
+    ih2->enable_change_buffer();
+    std::mt19937 rng(3);
+    for (int i = 0; i < 100000; i++) {
+        int key = rng() % 1000000;
+        ih_->insert_entry(reinterpret_cast<const char *>(&key), make_rid(i, 0), nullptr);
+        ih2->insert_entry(reinterpret_cast<const char *>(&key), make_rid(i, 1), nullptr);
+    }
+    for (int i = 0; i < 500; i++) {
+        if (ih_->get_change_buffer()->size() < IX_CHANGE_BUFFER_CAPACITY / 2 &&
+            ih2->get_change_buffer()->size() < IX_CHANGE_BUFFER_CAPACITY / 2) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_LT(ih_->get_change_buffer()->size(), IX_CHANGE_BUFFER_CAPACITY / 2);
+    EXPECT_LT(ih2->get_change_buffer()->size(), IX_CHANGE_BUFFER_CAPACITY / 2);
+    EXPECT_GT(ih_->get_change_buffer()->merged(), 0u);
+    EXPECT_GT(ih2->get_change_buffer()->merged(), 0u);
+    ix_manager_->close_index(ih2.get());
+}
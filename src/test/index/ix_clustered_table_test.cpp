@@ -0,0 +1,241 @@
+#include <map>
+#include <random>
+#include <set>
+
+#include "gtest/gtest.h"
+#include "index/ix.h"
+#include "test/test_fixture.h"
+
+/**
+ * 对于每个测试点，先创建和进入目录IxClusteredTableTest_db，然后在此目录下创建聚簇表ct(id int, v int, s char(40))，主键为id，
+ * 以及它的行号索引
+ */
+class IxClusteredTableTest : public StorageTest {
+   public:
+    std::unique_ptr<IxIndexHandle> ih_;
+    std::unique_ptr<IxIndexHandle> row_ih_;
+    std::unique_ptr<IxClusteredTableHandle> th_;
+    IndexMeta index_;
+    std::vector<ColMeta> cols_ = {{"ct", "id", TYPE_INT, sizeof(int), 0, false},
+                                  {"ct", "v", TYPE_INT, sizeof(int), 4, false},
+                                  {"ct", "s", TYPE_STRING, 40, 8, false}};
+    static constexpr int RECORD_SIZE = 48;
+
+   public:
+    IxClusteredTableTest() : StorageTest("IxClusteredTableTest_db", 64) {}
+
+    // This function is called before every test.
+    void SetUp() override {
+        StorageTest::SetUp();
+        index_.tab_name = "ct";
+        index_.col_num = 1;
+        index_.col_tot_len = RECORD_SIZE;
+        index_.cols = {cols_[0]};
+        index_.include_cols = {cols_[1], cols_[2]};
+        index_.clustered = true;
+        ix_manager_->create_index("ct", index_.cols, index_.include_cols);
+        ix_manager_->create_index("ct", ix_clustered_row_cols("ct"), index_.cols);
+        open();
+    }
+
+    // This function is called after every test.
+    void TearDown() override {
+        close();
+        StorageTest::TearDown();
+    }
+
+    void open() {
+        ih_ = ix_manager_->open_index("ct", index_.cols);
+        row_ih_ = ix_manager_->open_index("ct", ix_clustered_row_cols("ct"));
+        th_ = std::make_unique<IxClusteredTableHandle>(ih_.get(), row_ih_.get(), buffer_pool_manager_.get(),
+                                                       index_);
+    }
+
+    void close() {
+        th_.reset();
+        ix_manager_->close_index(ih_.get());
+        ix_manager_->close_index(row_ih_.get());
+    }
+
+    static std::string make_record(int id, int v) {
+        std::string record(RECORD_SIZE, 0);
+        memcpy(&record[0], &id, sizeof(int));
+        memcpy(&record[4], &v, sizeof(int));
+        std::string s = std::to_string(id) + "-" + std::to_string(v);
+        memcpy(&record[8], s.data(), s.size());
+        return record;
+    }
+
+    static int id_of(const char *record) { return *reinterpret_cast<const int *>(record); }
+
+    /**
+     * @brief 按Rid和按主键点查找每条记录，已删除的Rid和主键都找不到；
+     * 再顺序扫描整张表，结果都应与mock(主键 -> (Rid, 记录))一致且按主键有序
+     */
+    void check_equal(const std::map<int, std::pair<Rid, std::string>> &mock, const std::set<int> &deleted,
+                     const std::vector<Rid> &deleted_rids) {
+        for (auto &[id, entry] : mock) {
+            auto rec = th_->get_record(entry.first, nullptr);
+            ASSERT_EQ(std::string(rec->data, rec->size), entry.second);
+            Rid rid;
+            rec = th_->get_record_by_key(reinterpret_cast<const char *>(&id), &rid);
+            ASSERT_NE(rec, nullptr);
+            ASSERT_EQ(rid, entry.first);
+            ASSERT_EQ(std::string(rec->data, rec->size), entry.second);
+        }
+        for (int id : deleted) {
+            if (mock.count(id) == 0) {
+                EXPECT_EQ(th_->get_record_by_key(reinterpret_cast<const char *>(&id)), nullptr);
+            }
+        }
+        for (auto &rid : deleted_rids) {
+            EXPECT_THROW(th_->get_record(rid, nullptr), RecordNotFoundError);
+        }
+        auto it = mock.begin();
+        for (auto scan = th_->scan(); !scan->is_end(); scan->next()) {
+            ASSERT_NE(it, mock.end());
+            ASSERT_EQ(scan->rid(), it->second.first);
+            ASSERT_EQ(std::string(scan->record(), RECORD_SIZE), it->second.second);
+            ++it;
+        }
+        ASSERT_EQ(it, mock.end());
+    }
+};
+
+/**
+ * @brief 随机插入、更新(包括修改主键)和删除，结果与std::map一致；重复的主键被拒绝，
+ * 更新不改变Rid，删除的Rid不再分配；重新打开后行号接着分配
+ */
+TEST_F(IxClusteredTableTest, RandomOperations) {
+    std::mt19937 rng(49);
+    std::map<int, std::pair<Rid, std::string>> mock;
+    std::set<int> deleted;
+    std::vector<Rid> deleted_rids;
+    std::set<Rid, RidLess> used_rids;
+    auto insert = [&](int id, int v) {
+        std::string record = make_record(id, v);
+        Rid rid = th_->insert_record(&record[0], nullptr);
+        ASSERT_TRUE(used_rids.insert(rid).second);
+        mock[id] = {rid, record};
+    };
+    for (int i = 0; i < 20000; i++) {
+        int id = static_cast<int>(rng() % 8000) - 4000;
+        int op = rng() % 10;
+        if (mock.count(id) == 0) {
+            if (op < 7) {
+                insert(id, i);
+            }
+            continue;
+        }
+        Rid rid = mock[id].first;
+        if (op < 2) {
+            std::string record = make_record(id, -i);
+            EXPECT_THROW(th_->insert_record(&record[0], nullptr), DuplicateKeyError);
+        } else if (op < 6) {
+            std::string record = make_record(id, i);
+            ASSERT_EQ(th_->update_record(rid, &record[0], nullptr), rid);
+            mock[id].second = record;
+        } else if (op < 8) {
+            int new_id = static_cast<int>(rng() % 8000) - 4000;
+            std::string record = make_record(new_id, i);
+            if (new_id != id && mock.count(new_id) > 0) {
+                EXPECT_THROW(th_->update_record(rid, &record[0], nullptr), DuplicateKeyError);
+                continue;
+            }
+            ASSERT_EQ(th_->update_record(rid, &record[0], nullptr), rid);
+            mock.erase(id);
+            deleted.insert(id);
+            mock[new_id] = {rid, record};
+        } else {
+            th_->delete_record(rid, nullptr);
+            mock.erase(id);
+            deleted.insert(id);
+            deleted_rids.push_back(rid);
+            EXPECT_THROW(th_->delete_record(rid, nullptr), RecordNotFoundError);
+        }
+    }
+    check_equal(mock, deleted, deleted_rids);
+    close();
+    open();
+    check_equal(mock, deleted, deleted_rids);
+    for (int id = 4000; id < 4100; id++) {
+        insert(id, id);
+    }
+    check_equal(mock, deleted, deleted_rids);
+}
+
+/**
+ * @brief 主键和记录的长度不受Rid大小的限制：CHAR(20)主键、600字节的字段
+ */
+TEST_F(IxClusteredTableTest, LongKeyAndWideRow) {
+    std::vector<ColMeta> cols = {{"wt", "k", TYPE_STRING, 20, 0, false},
+                                 {"wt", "v", TYPE_INT, sizeof(int), 20, false},
+                                 {"wt", "s", TYPE_STRING, 600, 24, false}};
+    IndexMeta index;
+    index.tab_name = "wt";
+    index.col_num = 1;
+    index.col_tot_len = 624;
+    index.cols = {cols[0]};
+    index.include_cols = {cols[1], cols[2]};
+    index.clustered = true;
+    ix_manager_->create_index("wt", index.cols, index.include_cols);
+    ix_manager_->create_index("wt", ix_clustered_row_cols("wt"), index.cols);
+    auto ih = ix_manager_->open_index("wt", index.cols);
+    auto row_ih = ix_manager_->open_index("wt", ix_clustered_row_cols("wt"));
+    IxClusteredTableHandle th(ih.get(), row_ih.get(), buffer_pool_manager_.get(), index);
+
+    auto make_wide = [](int i) {
+        std::string record(624, 0);
+        std::string key = "key-" + std::to_string(i * 7919 % 3000) + "-padding";
+        memcpy(&record[0], key.data(), key.size());
+        memcpy(&record[20], &i, sizeof(int));
+        memset(&record[24], 'a' + i % 26, 600);
+        return record;
+    };
+    std::map<std::string, std::pair<Rid, std::string>> mock;  // 主键 -> (Rid, 记录)
+    for (int i = 0; i < 3000; i++) {
+        std::string record = make_wide(i);
+        mock[record.substr(0, 20)] = {th.insert_record(&record[0], nullptr), record};
+    }
+    for (int i = 0; i < 3000; i += 3) {
+        std::string key = make_wide(i).substr(0, 20);
+        th.delete_record(mock[key].first, nullptr);
+        mock.erase(key);
+    }
+    for (auto &[key, entry] : mock) {
+        auto rec = th.get_record(entry.first, nullptr);
+        ASSERT_EQ(std::string(rec->data, rec->size), entry.second);
+        ASSERT_EQ(std::string(th.get_record_by_key(key.data())->data, 624), entry.second);
+    }
+    auto it = mock.begin();
+    for (auto scan = th.scan(); !scan->is_end(); scan->next(), ++it) {
+        ASSERT_NE(it, mock.end());
+        ASSERT_EQ(std::string(scan->record(), 624), it->second.second);
+    }
+    ASSERT_EQ(it, mock.end());
+    ix_manager_->close_index(ih.get());
+    ix_manager_->close_index(row_ih.get());
+}
+
+/**
+ * @brief 按叶结点的页面号把扫描分成若干段，各段合起来恰好是整张表，每条记录出现一次
+ */
+TEST_F(IxClusteredTableTest, PageRangeScan) {
+    std::map<int, std::string> mock;
+    for (int id = 0; id < 5000; id++) {
+        std::string record = make_record(id * 7 % 5000, id);
+        th_->insert_record(&record[0], nullptr);
+        mock[id * 7 % 5000] = record;
+    }
+    int num_pages = th_->num_pages();
+    ASSERT_GT(num_pages, 8);
+    std::map<int, std::string> scanned;
+    int step = num_pages / 4;
+    for (int begin = RM_FIRST_RECORD_PAGE; begin < num_pages; begin += step) {
+        for (auto scan = th_->scan(nullptr, begin, std::min(begin + step, num_pages)); !scan->is_end();
+             scan->next()) {
+            ASSERT_TRUE(scanned.emplace(id_of(scan->record()), std::string(scan->record(), RECORD_SIZE)).second);
+        }
+    }
+    EXPECT_EQ(scanned, mock);
+}
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "index/ix_key_search.h"
+
+/**
+ * @brief 与std::lower_bound/std::upper_bound对照，检查各种长度(包括SIMD窗口的边界)下的查找结果
+ */
+TEST(IxKeySearchTest, IntSearchTest) {
+    std::mt19937 rng(42);
+    for (int n = 0; n <= 300; n++) {
+        std::vector<int> keys(n);
+        for (auto &key : keys) {
+            key = (int)(rng() % 1000) - 500;
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        const char *data = reinterpret_cast<const char *>(keys.data());
+        for (int target = -510; target <= 510; target += 3) {
+            int lower = std::lower_bound(keys.begin(), keys.end(), target) - keys.begin();
+            int upper = std::upper_bound(keys.begin(), keys.end(), target) - keys.begin();
+            ASSERT_EQ(ix_search_int<false>(data, keys.size(), (const char *)&target), lower);
+            ASSERT_EQ(ix_search_int<true>(data, keys.size(), (const char *)&target), upper);
+        }
+    }
+}
+
+TEST(IxKeySearchTest, FloatSearchTest) {
+    std::mt19937 rng(7);
+    for (int n = 0; n <= 300; n++) {
+        std::vector<float> keys(n);
+        for (auto &key : keys) {
+            key = (float)((int)(rng() % 2000) - 1000) / 4;
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        const char *data = reinterpret_cast<const char *>(keys.data());
+        for (float target = -260; target <= 260; target += 1.25f) {
+            int lower = std::lower_bound(keys.begin(), keys.end(), target) - keys.begin();
+            int upper = std::upper_bound(keys.begin(), keys.end(), target) - keys.begin();
+            ASSERT_EQ(ix_search_float<false>(data, keys.size(), (const char *)&target), lower);
+            ASSERT_EQ(ix_search_float<true>(data, keys.size(), (const char *)&target), upper);
+        }
+    }
+}
+
+TEST(IxKeySearchTest, StringAndMultiSearchTest) {
+    const int key_len = 8;
+    std::mt19937 rng(3);
+    for (int n = 0; n <= 100; n++) {
+        std::vector<std::string> keys(n);
+        for (auto &key : keys) {
+            key = std::to_string(10000000 + rng() % 1000);
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        std::string data;
+        for (auto &key : keys) {
+            data += key;
+        }
+        std::vector<ColType> col_types = {TYPE_STRING, TYPE_STRING};
+        std::vector<int> col_lens = {3, key_len - 3};
+        for (int i = 0; i < 200; i++) {
+            std::string target = std::to_string(10000000 + rng() % 1000);
+            int lower = std::lower_bound(keys.begin(), keys.end(), target) - keys.begin();
+            int upper = std::upper_bound(keys.begin(), keys.end(), target) - keys.begin();
+            ASSERT_EQ(ix_search_string<false>(data.data(), keys.size(), target.data(), key_len), lower);
+            ASSERT_EQ(ix_search_string<true>(data.data(), keys.size(), target.data(), key_len), upper);
+            ASSERT_EQ(ix_search_multi<false>(data.data(), keys.size(), target.data(), key_len, col_types, col_lens),
+                      lower);
+            ASSERT_EQ(ix_search_multi<true>(data.data(), keys.size(), target.data(), key_len, col_types, col_lens),
+                      upper);
+        }
+    }
+}
+
+/**
+ * @brief 规范化键的memcmp顺序与逐字段ix_compare的顺序一致，解码后还原为原始键
+ */
+TEST(IxKeySearchTest, NormalizedKeyTest) {
+    std::vector<ColType> col_types = {TYPE_INT, TYPE_FLOAT, TYPE_STRING};
+    std::vector<int> col_lens = {sizeof(int), sizeof(float), 4};
+    const int key_len = 12;
+    const std::vector<int> ints = {INT32_MIN, -70000, -1, 0, 1, 255, 256, 70000, INT32_MAX};
+    const std::vector<float> floats = {-1e30f, -2.5f, -1.0f, -1e-30f, -0.0f, 0.0f, 1e-30f, 1.0f, 2.5f, 1e30f};
+    const std::vector<std::string> strings = {std::string("\0\0\0\0", 4), std::string("a\0\0\0", 4), "ab\xff\x01",
+                                              "abcd"};
+    std::vector<std::string> keys;
+    for (int i : ints) {
+        for (float f : floats) {
+            for (auto &str : strings) {
+                char key[key_len];
+                memcpy(key, &i, sizeof(int));
+                memcpy(key + 4, &f, sizeof(float));
+                memcpy(key + 8, str.data(), 4);
+                keys.emplace_back(key, key_len);
+            }
+        }
+    }
+    std::vector<std::string> encoded;
+    for (auto &key : keys) {
+        char out[key_len];
+        ix_encode_key(key.data(), out, col_types, col_lens);
+        encoded.emplace_back(out, key_len);
+
+        char decoded[key_len];
+        ix_decode_key(out, decoded, col_types, col_lens);
+        ASSERT_EQ(ix_compare(decoded, key.data(), col_types, col_lens), 0);
+    }
+    auto sign = [](int x) { return (x > 0) - (x < 0); };
+    for (size_t a = 0; a < keys.size(); a++) {
+        for (size_t b = 0; b < keys.size(); b++) {
+            ASSERT_EQ(sign(memcmp(encoded[a].data(), encoded[b].data(), key_len)),
+                      sign(ix_compare(keys[a].data(), keys[b].data(), col_types, col_lens)));
+        }
+    }
+}
+
+/**
+ * @brief 在一个满结点上，专用查找与逐个调用ix_compare的二分查找对每个目标(包括不存在的键和两端之外的键)
+ * 返回相同的位置
+ */
+TEST(IxKeySearchTest, FullNodeSearchTest) {
+    const int n = 500;  // 4字节键、默认页面大小下一个结点的键数量级
+    std::vector<int> keys(n);
+    for (int i = 0; i < n; i++) {
+        keys[i] = i * 2;
+    }
+    const char *data = reinterpret_cast<const char *>(keys.data());
+    std::vector<ColType> col_types = {TYPE_INT};
+    std::vector<int> col_lens = {sizeof(int)};
+
+    auto generic_search = [&](const char *target, bool upper) {
+        int lo = 0, hi = n;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            int cmp = ix_compare(data + mid * sizeof(int), target, col_types, col_lens);
+            if (cmp < 0 || (upper && cmp == 0)) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    };
+    for (int target = -3; target <= 2 * n + 2; target++) {
+        const char *key = reinterpret_cast<const char *>(&target);
+        int lower = generic_search(key, false);
+        int upper = generic_search(key, true);
+        ASSERT_EQ(ix_search_int<false>(data, n, key), lower) << target;
+        ASSERT_EQ(ix_search_int<true>(data, n, key), upper) << target;
+        ASSERT_EQ(ix_search_multi<false>(data, n, key, sizeof(int), col_types, col_lens), lower) << target;
+        ASSERT_EQ(ix_search_multi<true>(data, n, key, sizeof(int), col_types, col_lens), upper) << target;
+    }
+}
@@ -0,0 +1,163 @@
+#include "test/query/query_fixture.h"
+
+/**
+ * 对于每个测试点，先创建和进入目录IndexJoinTest_db，然后建立两张表：
+ * a(id, k, s)400行，b(id, k, g, t)300行，b.k不重复，b.g每个值有10行
+ * 每条查询先在没有索引时执行一次(嵌套循环连接)，建立索引后再执行一次，
+ * 检查计划是否改成了索引嵌套循环连接，以及两次的结果(不计顺序)是否相同
+ */
+class IndexJoinTest : public QueryTest {
+   public:
+    IndexJoinTest() : QueryTest("IndexJoinTest_db") {}
+
+    // This function is called before every test.
+    void SetUp() override {
+        QueryTest::SetUp();
+        execute("create table a (id int, k int, s char(8));");
+        execute("create table b (id int, k int, g int, t char(16));");
+        for (int i = 0; i < 400; i++) {
+            execute("insert into a values (" + std::to_string(i) + ", " + std::to_string(i * 7 % 500) +
+                    ", 's" + std::to_string(i % 40) + "');");
+        }
+        for (int i = 0; i < 300; i++) {
+            execute("insert into b values (" + std::to_string(i) + ", " + std::to_string(i * 2) + ", " +
+                    std::to_string(i % 30) + ", 's" + std::to_string(i % 50) + "');");
+        }
+    }
+
+    // 计划中第一个连接结点的类型
+    static PlanTag join_tag(const std::shared_ptr<Plan> &plan) {
+        if (auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+            return x->tag;
+        }
+        if (auto x = std::dynamic_pointer_cast<DMLPlan>(plan)) {
+            return join_tag(x->subplan_);
+        }
+        if (auto x = std::dynamic_pointer_cast<ProjectionPlan>(plan)) {
+            return join_tag(x->subplan_);
+        }
+        if (auto x = std::dynamic_pointer_cast<SortPlan>(plan)) {
+            return join_tag(x->subplan_);
+        }
+        return T_SeqScan;
+    }
+
+    /**
+     * @brief 没有索引时执行queries作为期望结果，执行create_index后再执行一次，
+     * 检查连接的类型是否为expected_tag、结果是否与期望相同，最后删除索引
+     */
+    void check_same_results(const std::vector<std::string> &queries, const std::string &create_index,
+                            const std::string &drop_index, PlanTag expected_tag) {
+        std::vector<std::vector<std::string>> expected(queries.size());
+        for (size_t i = 0; i < queries.size(); i++) {
+            ASSERT_EQ(join_tag(execute(queries[i], &expected[i])), T_NestLoop) << queries[i];
+        }
+        execute(create_index);
+        for (size_t i = 0; i < queries.size(); i++) {
+            std::vector<std::string> rows;
+            ASSERT_EQ(join_tag(execute(queries[i], &rows)), expected_tag) << queries[i];
+            ASSERT_EQ(sorted(rows), sorted(expected[i])) << queries[i];
+        }
+        execute(drop_index);
+    }
+};
+
+/**
+ * @brief 等值连接：内表在连接字段上有索引，每个外层元组点查找一次
+ */
+TEST_F(IndexJoinTest, EqualityJoin) {
+    check_same_results(
+        {
+            "select a.id, b.id from a, b where a.k = b.k;",
+            "select a.id, b.id, b.g from a, b where a.k = b.k and a.id < 100;",
+            "select * from a, b where a.k = b.k and b.g = 3;",
+        },
+        "create index b(k);", "drop index b(k);", T_IndexNestLoop);
+}
+
+/**
+ * @brief 前缀连接：连接字段是联合索引的第一个字段，内表按前缀扫描，第二个字段上还可以有范围条件
+ */
+TEST_F(IndexJoinTest, PrefixJoin) {
+    check_same_results(
+        {
+            "select a.id, b.id from a, b where a.id = b.g;",
+            "select a.id, b.id from a, b where a.id = b.g and b.id > 150;",
+            "select a.k, b.k from a, b where a.id = b.g and b.id <= 40;",
+        },
+        "create index b(g, id);", "drop index b(g, id);", T_IndexNestLoop);
+}
+
+/**
+ * @brief 范围连接：每个外层元组按外层字段的值在内表索引上扫描一个范围
+ */
+TEST_F(IndexJoinTest, RangeJoin) {
+    check_same_results(
+        {
+            "select a.id, b.id from a, b where a.id < 20 and a.k < b.k;",
+            "select a.id, b.id from a, b where a.id < 20 and a.k <= b.k;",
+            "select a.id, b.id from a, b where a.id > 380 and a.k > b.k;",
+            "select a.id, b.id from a, b where a.id > 380 and a.k >= b.k and b.g = 7;",
+        },
+        "create index b(k);", "drop index b(k);", T_IndexNestLoop);
+}
+
+/**
+ * @brief 只有左表有可用的索引：交换左右两边，连接条件随之交换，结果的字段顺序不变
+ */
+TEST_F(IndexJoinTest, SwappedJoin) {
+    check_same_results(
+        {
+            "select a.id, b.id from a, b where a.k = b.k;",
+            "select a.id, b.id from a, b where b.k = a.k;",
+            "select b.id, a.s from b, a where b.k > a.k and b.id < 10;",
+        },
+        "create index a(k);", "drop index a(k);", T_IndexNestLoop);
+}
+
+/**
+ * @brief 连接字段的类型相同但长度不同：外层的值不能直接作为内表的键，保持嵌套循环连接，结果不变
+ */
+TEST_F(IndexJoinTest, MismatchedTypeJoin) {
+    check_same_results(
+        {
+            "select b.id, a.id from b, a where b.t = a.s;",
+            "select b.id, a.id from b, a where b.t = a.s and b.g = 1;",
+        },
+        "create index a(s, id);", "drop index a(s, id);", T_NestLoop);
+    check_same_results({"select b.id, a.id from b, a where b.t = a.s;"}, "create index b(t, id);",
+                       "drop index b(t, id);", T_NestLoop);
+}
+
+/**
+ * @brief 内表的连接字段有重复的值：每个外层元组都要连接上全部匹配的记录。
+ * 堆表的重复字段上建不了索引，保持嵌套循环连接；聚簇表的二级索引按追加的主键区分记录
+ */
+TEST_F(IndexJoinTest, DuplicateKeyJoin) {
+    std::vector<std::string> queries = {
+        "select a.id, b.id from a, b where a.id = b.g;",
+        "select a.id, b.id from a, b where a.id = b.g and b.id > 150;",
+    };
+    std::vector<std::vector<std::string>> expected(queries.size());
+    for (size_t i = 0; i < queries.size(); i++) {
+        execute(queries[i], &expected[i]);
+    }
+    EXPECT_THROW(execute("create index b(g);"), DuplicateKeyError);
+    for (size_t i = 0; i < queries.size(); i++) {
+        std::vector<std::string> rows;
+        ASSERT_EQ(join_tag(execute(queries[i], &rows)), T_NestLoop) << queries[i];
+        ASSERT_EQ(sorted(rows), sorted(expected[i])) << queries[i];
+    }
+
+    execute("create table c (id int, g int) clustered by (id);");
+    for (int i = 0; i < 300; i++) {
+        execute("insert into c values (" + std::to_string(i) + ", " + std::to_string(i % 30) + ");");
+    }
+    check_same_results(
+        {
+            "select a.id, c.id from a, c where a.id = c.g;",
+            "select a.id, c.id from a, c where a.id = c.g and c.id > 150;",
+            "select a.id, c.id from a, c where a.id < 5 and a.id <= c.g;",
+        },
+        "create index c(g);", "drop index c(g);", T_IndexNestLoop);
+}
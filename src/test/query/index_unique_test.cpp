@@ -0,0 +1,175 @@
+#include "test/query/query_fixture.h"
+
+/**
+ * 对于每个测试点，先创建和进入目录IndexUniqueTest_db，然后建立表t(a, b)
+ * B+树索引和哈希索引的键不重复：插入、更新和建索引时遇到已有的键都失败，表和索引保持一致
+ */
+class IndexUniqueTest : public QueryTest {
+   public:
+    IndexUniqueTest() : QueryTest("IndexUniqueTest_db") {}
+
+    // This function is called before every test.
+    void SetUp() override {
+        QueryTest::SetUp();
+        execute("create table t (a int, b int);");
+    }
+};
+
+/**
+ * @brief 插入和更新成已有的键时失败，记录和索引都不变
+ */
+TEST_F(IndexUniqueTest, InsertAndUpdateRejectDuplicates) {
+    for (auto *type : {"btree", "hash"}) {
+        execute(std::string("create index t(a) using ") + type + ";");
+        if (std::string(type) == "btree") {
+            // 唯一索引插入前要查找已有的键，不缓冲修改
+            EXPECT_EQ(sm_manager_->ihs_.at("t_a.idx")->get_change_buffer(), nullptr);
+        }
+        execute("insert into t values (1, 1);");
+        execute("insert into t values (2, 2);");
+        EXPECT_THROW(execute("insert into t values (1, 3);"), DuplicateKeyError) << type;
+        EXPECT_THROW(execute("update t set a = 1 where b = 2;"), DuplicateKeyError) << type;
+        // 键不变的更新不算重复
+        execute("update t set a = 2, b = 5 where b = 2;");
+        EXPECT_EQ(query("select * from t;").size(), 2) << type;
+        EXPECT_EQ(query("select * from t where a = 1;").size(), 1) << type;
+        EXPECT_EQ(query("select * from t where a = 2 and b = 5;").size(), 1) << type;
+
+        // 删除一条记录后它的键可以再次插入，另一条记录的索引项不受影响
+        execute("delete from t where a = 2;");
+        execute("insert into t values (2, 6);");
+        EXPECT_EQ(query("select * from t where a = 1;").size(), 1) << type;
+        EXPECT_EQ(query("select * from t where a = 2 and b = 6;").size(), 1) << type;
+        execute("drop index t(a);");
+        execute("delete from t;");
+    }
+}
+
+/**
+ * @brief 表中已有重复的键时建哈希索引失败，建了一半的索引被删除，之后可以正常查询和建其他索引
+ */
+TEST_F(IndexUniqueTest, CreateHashIndexRejectsDuplicates) {
+    for (int i = 0; i < 3; i++) {
+        execute("insert into t values (1, " + std::to_string(i) + ");");
+    }
+    EXPECT_THROW(execute("create index t(a) using hash;"), DuplicateKeyError);
+    EXPECT_FALSE(sm_manager_->db_.get_table("t").is_index({"a"}));
+    EXPECT_EQ(query("select * from t where a = 1;").size(), 3);
+    execute("create index t(b) using hash;");
+    EXPECT_EQ(query("select * from t where b = 2;").size(), 1);
+}
+
+/**
+ * @brief 表中已有重复的键时建B+树索引失败(INT键和变长格式的字符串键)；
+ * 删掉重复的记录后可以建索引，每条记录都能通过索引找到
+ */
+TEST_F(IndexUniqueTest, CreateBtreeIndexRejectsDuplicates) {
+    // id >= 200的记录与前面的记录a重复，id >= 250的记录name也重复
+    execute("create table s (id int, a int, name char(32));");
+    for (int i = 0; i < 300; i++) {
+        execute("insert into s values (" + std::to_string(i) + ", " + std::to_string(i % 200) + ", 'n" +
+                std::to_string(i % 250) + "');");
+    }
+    EXPECT_THROW(execute("create index s(a);"), DuplicateKeyError);
+    EXPECT_THROW(execute("create index s(name);"), DuplicateKeyError);
+    EXPECT_FALSE(sm_manager_->db_.get_table("s").is_index({"a"}));
+    EXPECT_FALSE(sm_manager_->db_.get_table("s").is_index({"name"}));
+
+    execute("delete from s where id >= 250;");
+    execute("create index s(name);");
+    EXPECT_THROW(execute("create index s(a);"), DuplicateKeyError);
+    execute("delete from s where id >= 200;");
+    execute("create index s(a);");
+    EXPECT_EQ(query("select * from s where a = 120;").size(), 1u);
+    EXPECT_EQ(query("select * from s where name = 'n120';").size(), 1u);
+    EXPECT_EQ(query("select * from s where a >= 0;").size(), 200u);
+}
+
+/**
+ * @brief 聚簇表的二级索引在键的末尾追加主键：索引字段相同的记录各有一个索引项，
+ * 按二级索引查找、仅索引扫描、修改主键和删除记录后都能找到全部记录；删除索引时按建索引时给出的字段
+ */
+TEST_F(IndexUniqueTest, ClusteredSecondaryIndexKeepsDuplicates) {
+    execute("create table c (id int, w int, v int) clustered by (id);");
+    execute("insert into c values (1, 50, 1);");
+    execute("insert into c values (2, 50, 2);");
+    execute("insert into c values (3, 60, 3);");
+    execute("create index c(w);");
+    // 追加了主键的二级索引插入时不查找已有的键，修改可以缓冲
+    EXPECT_NE(sm_manager_->ihs_.at("c_w_id.idx")->get_change_buffer(), nullptr);
+    EXPECT_THROW(execute("create index c(w, id);"), IndexExistsError);
+    EXPECT_EQ(query("select * from c where w = 50;").size(), 2u);
+    EXPECT_EQ(query("select w, id from c where w = 50;").size(), 2u);
+    EXPECT_EQ(query("select * from c where w = 50 and id = 2;").size(), 1u);
+
+    execute("insert into c values (4, 50, 4);");
+    execute("update c set id = 5 where id = 1;");
+    execute("delete from c where id = 2;");
+    EXPECT_EQ(query("select * from c where w = 50;").size(), 2u);
+    EXPECT_EQ(query("select * from c where w = 50 and id = 5;").size(), 1u);
+    EXPECT_EQ(query("select * from c where w = 50 and id = 4;").size(), 1u);
+    EXPECT_EQ(query("select * from c where w >= 50;").size(), 3u);
+
+    execute("drop index c(w);");
+    EXPECT_FALSE(sm_manager_->db_.get_table("c").is_index({"w"}));
+    EXPECT_EQ(query("select * from c where w = 50;").size(), 2u);
+}
+
+/**
+ * @brief ORDER BY按索引顺序扫描时输出全部记录：键重复的字段上建不了索引，仍然排序；
+ * 聚簇表追加了主键的二级索引为每条记录都存有索引项，可以按它的顺序输出
+ */
+TEST_F(IndexUniqueTest, IndexOrderReturnsEveryRow) {
+    for (int b : {3, 2, 1}) {
+        execute("insert into t values (1, " + std::to_string(b) + ");");
+    }
+    EXPECT_THROW(execute("create index t(a);"), DuplicateKeyError);
+    EXPECT_EQ(query("select * from t order by a;").size(), 3u);
+
+    execute("create table c (id int, w int) clustered by (id);");
+    for (int id : {4, 2, 3, 1}) {
+        execute("insert into c values (" + std::to_string(id) + ", " + std::to_string(id % 2) + ");");
+    }
+    execute("create index c(w);");
+    std::vector<std::string> rows;
+    auto plan = std::dynamic_pointer_cast<DMLPlan>(execute("select w from c order by w;", &rows));
+    auto projection = std::dynamic_pointer_cast<ProjectionPlan>(plan->subplan_);
+    auto scan = std::dynamic_pointer_cast<ScanPlan>(projection->subplan_);
+    ASSERT_NE(scan, nullptr);
+    EXPECT_TRUE(scan->ordered_);
+    ASSERT_EQ(rows.size(), 4u);
+    std::vector<int> ws;
+    for (auto &row : rows) {
+        ws.push_back(*reinterpret_cast<const int *>(row.data()));
+    }
+    EXPECT_EQ(ws, std::vector<int>({0, 0, 1, 1}));
+}
+
+/**
+ * @brief 仅索引扫描由索引项构造记录：INCLUDE字段的值相同的记录各有一个索引项，
+ * 键重复的字段上建不了索引；聚簇表的二级索引按追加的主键区分记录
+ */
+TEST_F(IndexUniqueTest, IndexOnlyScanReturnsEveryRow) {
+    execute("insert into t values (1, 5);");
+    execute("insert into t values (1, 6);");
+    EXPECT_THROW(execute("create index t(a) include (b);"), DuplicateKeyError);
+    EXPECT_EQ(query("select a, b from t where a = 1;").size(), 2u);
+    execute("create index t(b) include (a);");
+    execute("insert into t values (1, 7);");
+    std::vector<std::string> rows;
+    auto plan = std::dynamic_pointer_cast<DMLPlan>(execute("select b, a from t where b >= 5;", &rows));
+    auto projection = std::dynamic_pointer_cast<ProjectionPlan>(plan->subplan_);
+    EXPECT_TRUE(std::dynamic_pointer_cast<ScanPlan>(projection->subplan_)->index_only_);
+    EXPECT_EQ(rows.size(), 3u);
+
+    execute("create table c (id int, w int) clustered by (id);");
+    for (int id = 1; id <= 4; id++) {
+        execute("insert into c values (" + std::to_string(id) + ", 50);");
+    }
+    execute("create index c(w);");
+    rows.clear();
+    plan = std::dynamic_pointer_cast<DMLPlan>(execute("select w, id from c where w = 50;", &rows));
+    projection = std::dynamic_pointer_cast<ProjectionPlan>(plan->subplan_);
+    EXPECT_TRUE(std::dynamic_pointer_cast<ScanPlan>(projection->subplan_)->index_only_);
+    EXPECT_EQ(rows.size(), 4u);
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "analyze/analyze.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/plan.h"
+#include "optimizer/planner.h"
+#include "parser/parser.h"
+#include "portal.h"
+
+/**
+ * 查询测试的公共夹具：对于每个测试点，在目录db_name下创建并打开一个数据库(已存在时先删除)，
+ * 用execute()在进程内解析、优化和执行SQL语句；测试结束后关闭数据库并回到上一级目录
+ */
+class QueryTest : public ::testing::Test {
+   public:
+    std::unique_ptr<DiskManager> disk_manager_;
+    std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+    std::unique_ptr<RmManager> rm_manager_;
+    std::unique_ptr<IxManager> ix_manager_;
+    std::unique_ptr<SmManager> sm_manager_;
+    std::unique_ptr<QlManager> ql_manager_;
+    std::unique_ptr<Planner> planner_;
+    std::unique_ptr<Optimizer> optimizer_;
+    std::unique_ptr<Portal> portal_;
+    std::unique_ptr<Analyze> analyze_;
+    char data_send_[BUFFER_LENGTH];
+    int offset_ = 0;
+    SessionSettings session_;
+    RmArena arena_;
+    std::unique_ptr<Context> context_;
+
+    explicit QueryTest(std::string db_name) : db_name_(std::move(db_name)) {}
+
+    // This function is called before every test.
+    void SetUp() override {
+        ::testing::Test::SetUp();
+        disk_manager_ = std::make_unique<DiskManager>();
+        buffer_pool_manager_ = std::make_unique<BufferPoolManager>(1000, disk_manager_.get());
+        rm_manager_ = std::make_unique<RmManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        ix_manager_ = std::make_unique<IxManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        sm_manager_ = std::make_unique<SmManager>(disk_manager_.get(), buffer_pool_manager_.get(),
+                                                  rm_manager_.get(), ix_manager_.get());
+        ql_manager_ = std::make_unique<QlManager>(sm_manager_.get(), nullptr);
+        planner_ = std::make_unique<Planner>(sm_manager_.get());
+        optimizer_ = std::make_unique<Optimizer>(sm_manager_.get(), planner_.get());
+        portal_ = std::make_unique<Portal>(sm_manager_.get());
+        analyze_ = std::make_unique<Analyze>(sm_manager_.get());
+        context_ = std::make_unique<Context>(nullptr, nullptr, nullptr, data_send_, &offset_, &session_, &arena_);
+
+        if (disk_manager_->is_dir(db_name_)) {
+            std::string cmd = "rm -rf " + db_name_;
+            if (system(cmd.c_str()) < 0) {
+                throw UnixError();
+            }
+        }
+        sm_manager_->create_db(db_name_);
+        sm_manager_->open_db(db_name_);
+    }
+
+    // This function is called after every test.
+    void TearDown() override {
+        sm_manager_->close_db();
+        if (chdir("..") < 0) {
+            throw UnixError();
+        }
+    }
+
+    /**
+     * @brief 执行一条SQL语句，查询语句的结果按行追加到rows；与服务端一样，开始时回收上一条语句的查询内存区
+     * @return 语句的执行计划
+     */
+    std::shared_ptr<Plan> execute(const std::string &sql, std::vector<std::string> *rows = nullptr) {
+        arena_.reset();
+        YY_BUFFER_STATE buf = yy_scan_string(sql.c_str());
+        if (yyparse() != 0 || ast::parse_tree == nullptr) {
+            yy_delete_buffer(buf);
+            throw InternalError("failed to parse: " + sql);
+        }
+        std::shared_ptr<Query> query = analyze_->do_analyze(ast::parse_tree);
+        yy_delete_buffer(buf);
+        std::shared_ptr<Plan> plan = optimizer_->plan_query(query, context_.get());
+        std::shared_ptr<PortalStmt> stmt = portal_->start(plan, context_.get());
+        if (stmt->tag != PORTAL_ONE_SELECT) {
+            txn_id_t txn_id = INVALID_TXN_ID;
+            portal_->run(stmt, ql_manager_.get(), &txn_id, context_.get());
+            return plan;
+        }
+        auto &root = stmt->root;
+        for (root->beginTuple(); !root->is_end(); root->nextTuple()) {
+            auto rec = root->Next();
+            rows->emplace_back(rec->data, rec->size);
+        }
+        return plan;
+    }
+
+    // 执行查询语句，返回结果的全部行
+    std::vector<std::string> query(const std::string &sql) {
+        std::vector<std::string> rows;
+        execute(sql, &rows);
+        return rows;
+    }
+
+    static std::vector<std::string> sorted(std::vector<std::string> rows) {
+        std::sort(rows.begin(), rows.end());
+        return rows;
+    }
+
+   private:
+    std::string db_name_;
+};
@@ -4,11 +4,16 @@
 #include "record/rm.h"
 #undef private  // for use private variables in "rm.h"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstring>
 #include <ctime>
 #include <iostream>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "gtest/gtest.h"
 #define BUFFER_LENGTH 8192
@@ -249,4 +254,482 @@ TEST(RecordManagerTest, MultipleFilesTest) {
         std::string filename = filenames[i];
         rm_manager->destroy_file(filename);
     }
-}
\ No newline at end of file
+}
+/**
+ * @brief 测试RmRecord的移动和拷贝：移动转移缓冲区的所有权，大小相同的拷贝赋值复用原有缓冲区
+ */
+TEST(RecordManagerTest, RecordMoveCopyTest) {
+    char buf[BUFFER_LENGTH];
+    rand_buf(100, buf);
+
+    // 移动构造：新对象接管缓冲区，原对象变为空记录
+    RmRecord src(100, buf);
+    char *src_data = src.data;
+    RmRecord moved(std::move(src));
+    assert(moved.data == src_data && moved.size == 100 && moved.allocated_);
+    assert(src.data == nullptr && src.size == 0 && !src.allocated_);
+    assert(memcmp(moved.data, buf, 100) == 0);
+
+    // 移动赋值：释放目标原有的缓冲区并接管源的缓冲区
+    RmRecord target(50);
+    target = std::move(moved);
+    assert(target.data == src_data && target.size == 100);
+    assert(moved.data == nullptr && !moved.allocated_);
+    target = std::move(target);
+    assert(target.data == src_data && target.size == 100);
+
+    // 拷贝构造：分配独立的缓冲区
+    RmRecord copy(target);
+    assert(copy.data != target.data && copy.size == 100);
+    assert(memcmp(copy.data, buf, 100) == 0);
+
+    // 大小相同的拷贝赋值复用已有缓冲区，大小不同时重新分配
+    char rand_data[100];
+    rand_buf(100, rand_data);
+    RmRecord other(100, rand_data);
+    char *copy_data = copy.data;
+    copy = other;
+    assert(copy.data == copy_data && memcmp(copy.data, rand_data, 100) == 0);
+    RmRecord small(10, rand_data);
+    copy = small;
+    assert(copy.size == 10 && memcmp(copy.data, rand_data, 10) == 0);
+    copy = copy;
+    assert(copy.size == 10 && memcmp(copy.data, rand_data, 10) == 0);
+
+    // 拷贝赋值给空记录、从空记录移动
+    RmRecord empty;
+    empty = other;
+    assert(empty.allocated_ && empty.data != other.data &&
+           memcmp(empty.data, rand_data, 100) == 0);
+    RmRecord none;
+    empty = std::move(none);
+    assert(empty.data == nullptr && empty.size == 0 && !empty.allocated_);
+
+    // Deserialize替换原有缓冲区
+    char serialized[sizeof(int) + 20];
+    *reinterpret_cast<int *>(serialized) = 20;
+    rand_buf(20, serialized + sizeof(int));
+    target.Deserialize(serialized);
+    assert(target.size == 20 &&
+           memcmp(target.data, serialized + sizeof(int), 20) == 0);
+}
+
+/**
+ * @brief 测试查询内存区：输出元组的对象和缓冲区从内存区中连续分配，reset()之后复用同一块内存；
+ * 超过上限或没有内存区时单独分配，两种记录都可以直接delete
+ */
+TEST(RecordManagerTest, RecordArenaTest) {
+    RmArena arena;
+    char buf[100];
+    rand_buf(100, buf);
+
+    std::vector<std::unique_ptr<RmRecord>> records;
+    for (int i = 0; i < 1000; i++) {
+        records.push_back(RmRecord::make(100, &arena));
+        assert(!records.back()->allocated_ && records.back()->size == 100);
+        assert(reinterpret_cast<uintptr_t>(records.back().get()) % RmArena::ALIGN == 0);
+        assert(reinterpret_cast<uintptr_t>(records.back()->data) % RmArena::ALIGN == 0);
+        memcpy(records.back()->data, buf, 100);
+    }
+    for (auto &record : records) {
+        assert(memcmp(record->data, buf, 100) == 0);
+    }
+    assert(arena.num_blocks() > 1 && arena.used() >= 1000 * 100);
+    records.clear();
+
+    // reset()之后只保留第一块，新的元组从第一块的开头分配
+    arena.reset();
+    assert(arena.num_blocks() == 1 && arena.used() == 0);
+    auto first = RmRecord::make(100, &arena);
+    RmRecord *first_ptr = first.get();
+    char *first_data = first->data;
+    first.reset();
+    arena.reset();
+    auto again = RmRecord::make(100, &arena);
+    assert(again.get() == first_ptr && again->data == first_data);
+
+    // 超过上限后单独分配
+    assert(arena.allocate(RmArena::MAX_SIZE) == nullptr);
+    assert(arena.allocate(RmArena::MAX_SIZE - arena.used()) != nullptr);
+    auto overflow = RmRecord::make(100, &arena);
+    assert(overflow->allocated_ && overflow->size == 100);
+    auto no_arena = RmRecord::make(100, nullptr);
+    assert(no_arena->allocated_);
+    overflow.reset();
+    no_arena.reset();
+    again.reset();
+    arena.reset();
+    assert(arena.num_blocks() == 1);
+}
+
+/**
+ * @brief 测试FSM：多线程并发插入后记录完整、页面被充分利用，删除后的空间能被重新利用
+ */
+TEST(RecordManagerTest, ConcurrentInsertTest) {
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(
+        BUFFER_POOL_SIZE, disk_manager.get());
+    auto rm_manager = std::make_unique<RmManager>(disk_manager.get(),
+                                                  buffer_pool_manager.get());
+
+    std::string filename = "concurrent.txt";
+    if (disk_manager->is_file(filename)) {
+        disk_manager->destroy_file(filename);
+    }
+    constexpr int record_size = 64;
+    constexpr int num_threads = 8;
+    constexpr int num_inserts = 2000;
+    rm_manager->create_file(filename, record_size);
+    auto file_handle = rm_manager->open_file(filename);
+    int records_per_page = file_handle->file_hdr_.num_records_per_page;
+
+    std::unordered_map<Rid, std::string, rid_hash_t, rid_equal_t> mock;
+    std::mutex mock_latch;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            char buf[record_size];
+            for (int i = 0; i < num_inserts; i++) {
+                memset(buf, 0, record_size);
+                snprintf(buf, record_size, "%d-%d", t, i);
+                Rid rid = file_handle->insert_record(buf, nullptr);
+                std::lock_guard<std::mutex> lock(mock_latch);
+                assert(mock.count(rid) == 0);
+                mock[rid] = std::string(buf, record_size);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    assert(mock.size() == num_threads * num_inserts);
+    check_equal(file_handle.get(), mock);
+    // 每个线程最多留下少量未填满的页面
+    int min_pages = (num_threads * num_inserts + records_per_page - 1) /
+                    records_per_page;
+    assert(file_handle->file_hdr_.num_pages - 1 <=
+           min_pages + num_threads * RM_MAX_INSERT_PROBES);
+
+    // 删除一半记录后重新插入，不应分配新页面
+    int num_pages = file_handle->file_hdr_.num_pages;
+    std::vector<Rid> rids;
+    for (auto &entry : mock) {
+        rids.push_back(entry.first);
+    }
+    for (size_t i = 0; i < rids.size(); i += 2) {
+        file_handle->delete_record(rids[i], nullptr);
+        mock.erase(rids[i]);
+    }
+    char buf[record_size] = {};
+    for (size_t i = 0; i < rids.size(); i += 2) {
+        Rid rid = file_handle->insert_record(buf, nullptr);
+        assert(mock.count(rid) == 0);
+        mock[rid] = std::string(buf, record_size);
+    }
+    assert(file_handle->file_hdr_.num_pages == num_pages);
+    check_equal(file_handle.get(), mock);
+
+    // FSM随文件关闭持久化，重新打开后仍然可以找到空闲页面
+    rm_manager->close_file(file_handle.get());
+    file_handle = rm_manager->open_file(filename);
+    file_handle->delete_record(rids[1], nullptr);
+    mock.erase(rids[1]);
+    Rid rid = file_handle->insert_record(buf, nullptr);
+    mock[rid] = std::string(buf, record_size);
+    assert(file_handle->file_hdr_.num_pages == num_pages);
+    check_equal(file_handle.get(), mock);
+    rm_manager->close_file(file_handle.get());
+    rm_manager->destroy_file(filename);
+}
+
+/**
+ * @brief 测试PAX布局：记录读写结果与行存一致，按字段读取时只填充指定字段
+ */
+TEST(RecordManagerTest, PaxLayoutTest) {
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(
+        BUFFER_POOL_SIZE, disk_manager.get());
+    auto rm_manager = std::make_unique<RmManager>(disk_manager.get(),
+                                                  buffer_pool_manager.get());
+
+    std::string filename = "pax.txt";
+    if (disk_manager->is_file(filename)) {
+        disk_manager->destroy_file(filename);
+    }
+    std::vector<int> col_lens = {4, 16, 8, 4};
+    int record_size = 32;
+    rm_manager->create_file(filename, record_size, RM_LAYOUT_PAX, col_lens);
+    auto file_handle = rm_manager->open_file(filename);
+    assert(file_handle->file_hdr_.layout == RM_LAYOUT_PAX);
+    assert(file_handle->file_hdr_.num_cols == (int)col_lens.size());
+
+    std::unordered_map<Rid, std::string, rid_hash_t, rid_equal_t> mock;
+    char buf[BUFFER_LENGTH];
+    for (int i = 0; i < 1000; i++) {
+        rand_buf(record_size, buf);
+        Rid rid = file_handle->insert_record(buf, nullptr);
+        mock[rid] = std::string(buf, record_size);
+    }
+    for (auto &entry : mock) {
+        rand_buf(record_size, buf);
+        file_handle->update_record(entry.first, buf, nullptr);
+        entry.second = std::string(buf, record_size);
+    }
+    check_equal(file_handle.get(), mock);
+
+    // 只读取第1、3个字段
+    for (auto &entry : mock) {
+        auto rec = file_handle->get_record(entry.first, {1, 3}, nullptr);
+        assert(memcmp(rec->data + 4, entry.second.c_str() + 4, 16) == 0);
+        assert(memcmp(rec->data + 28, entry.second.c_str() + 28, 4) == 0);
+    }
+
+    rm_manager->close_file(file_handle.get());
+    file_handle = rm_manager->open_file(filename);
+    check_equal(file_handle.get(), mock);
+    rm_manager->close_file(file_handle.get());
+    rm_manager->destroy_file(filename);
+}
+
+/**
+ * @brief 测试VACUUM：大量删除后压缩文件，页面数随存活记录减少，记录内容保持不变
+ */
+TEST(RecordManagerTest, VacuumTest) {
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(
+        BUFFER_POOL_SIZE, disk_manager.get());
+    auto rm_manager = std::make_unique<RmManager>(disk_manager.get(),
+                                                  buffer_pool_manager.get());
+
+    std::string filename = "vacuum.txt";
+    if (disk_manager->is_file(filename)) {
+        disk_manager->destroy_file(filename);
+    }
+    int record_size = 100;
+    rm_manager->create_file(filename, record_size);
+    auto file_handle = rm_manager->open_file(filename);
+    int per_page = file_handle->file_hdr_.num_records_per_page;
+
+    std::unordered_map<Rid, std::string, rid_hash_t, rid_equal_t> mock;
+    char buf[BUFFER_LENGTH];
+    for (int i = 0; i < per_page * 50; i++) {
+        rand_buf(record_size, buf);
+        Rid rid = file_handle->insert_record(buf, nullptr);
+        mock[rid] = std::string(buf, record_size);
+    }
+    // 随机保留约十分之一的记录
+    std::vector<Rid> rids;
+    for (auto &entry : mock) {
+        rids.push_back(entry.first);
+    }
+    for (auto &rid : rids) {
+        if (rand() % 10 != 0) {
+            file_handle->delete_record(rid, nullptr);
+            mock.erase(rid);
+        }
+    }
+    int old_pages = file_handle->file_hdr_.num_pages;
+
+    int num_moved = 0;
+    int reclaimed = file_handle->vacuum(
+        [&](const Rid &old_rid, const Rid &new_rid, const RmRecord &record) {
+            assert(mock.count(old_rid) == 1 && mock.count(new_rid) == 0);
+            assert(memcmp(mock[old_rid].c_str(), record.data, record_size) ==
+                   0);
+            mock[new_rid] = mock[old_rid];
+            mock.erase(old_rid);
+            num_moved++;
+        });
+    int expect_pages = 1 + ((int)mock.size() + per_page - 1) / per_page;
+    assert(file_handle->file_hdr_.num_pages == expect_pages);
+    assert(reclaimed == old_pages - expect_pages);
+    assert(num_moved > 0);
+    assert(disk_manager->get_file_size(filename) == expect_pages * PAGE_SIZE);
+    check_equal(file_handle.get(), mock);
+
+    // 压缩后继续插入，新页面从截断处重新分配
+    for (int i = 0; i < per_page * 2; i++) {
+        rand_buf(record_size, buf);
+        Rid rid = file_handle->insert_record(buf, nullptr);
+        assert(mock.count(rid) == 0);
+        mock[rid] = std::string(buf, record_size);
+    }
+    rm_manager->close_file(file_handle.get());
+    file_handle = rm_manager->open_file(filename);
+    check_equal(file_handle.get(), mock);
+    rm_manager->close_file(file_handle.get());
+    rm_manager->destroy_file(filename);
+}
+
+/**
+ * @brief 测试VACUUM与并发插入：插入等待VACUUM结束，不会占用前部的空洞使搬迁中途失败，结束后所有记录都在
+ */
+TEST(RecordManagerTest, VacuumConcurrentInsertTest) {
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(
+        BUFFER_POOL_SIZE, disk_manager.get());
+    auto rm_manager = std::make_unique<RmManager>(disk_manager.get(),
+                                                  buffer_pool_manager.get());
+
+    std::string filename = "vacuum_concurrent.txt";
+    if (disk_manager->is_file(filename)) {
+        disk_manager->destroy_file(filename);
+    }
+    constexpr int record_size = 64;
+    constexpr int num_threads = 4;
+    constexpr int num_inserts = 2000;
+    rm_manager->create_file(filename, record_size);
+    auto file_handle = rm_manager->open_file(filename);
+    int per_page = file_handle->file_hdr_.num_records_per_page;
+
+    // 记录内容唯一，按内容核对，rid会被VACUUM改变
+    std::unordered_set<std::string> expected;
+    std::vector<Rid> rids;
+    char buf[record_size];
+    for (int i = 0; i < per_page * 50; i++) {
+        memset(buf, 0, record_size);
+        snprintf(buf, record_size, "old-%d", i);
+        rids.push_back(file_handle->insert_record(buf, nullptr));
+        expected.insert(std::string(buf, record_size));
+    }
+    for (int i = 0; i < (int)rids.size(); i++) {
+        if (i % 10 != 0) {
+            auto rec = file_handle->get_record(rids[i], nullptr);
+            expected.erase(std::string(rec->data, record_size));
+            file_handle->delete_record(rids[i], nullptr);
+        }
+    }
+
+    // 搬迁第一条记录时启动插入线程，此时VACUUM正在进行，插入必须等它结束
+    std::mutex latch;
+    std::vector<std::thread> threads;
+    auto start_inserts = [&] {
+        for (int t = 0; t < num_threads; t++) {
+            threads.emplace_back([&, t] {
+                char buf[record_size];
+                for (int i = 0; i < num_inserts; i++) {
+                    memset(buf, 0, record_size);
+                    snprintf(buf, record_size, "new-%d-%d", t, i);
+                    file_handle->insert_record(buf, nullptr);
+                    std::lock_guard<std::mutex> lock(latch);
+                    expected.insert(std::string(buf, record_size));
+                }
+            });
+        }
+    };
+    int num_moved = 0;
+    file_handle->vacuum(
+        [&](const Rid &old_rid, const Rid &new_rid, const RmRecord &record) {
+            if (num_moved++ == 0) {
+                start_inserts();
+            }
+            // 模拟修正索引的耗时，让插入线程有机会在VACUUM进行中运行
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        });
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    assert(num_moved > 0);
+
+    std::unordered_set<std::string> actual;
+    for (RmScan scan(file_handle.get()); !scan.is_end(); scan.next()) {
+        auto rec = file_handle->get_record(scan.rid(), nullptr);
+        assert(actual.insert(std::string(rec->data, record_size)).second);
+    }
+    assert(actual == expected);
+    rm_manager->close_file(file_handle.get());
+    rm_manager->destroy_file(filename);
+}
+
+/**
+ * @brief 测试zone map：按键值顺序插入后，区间查询只需访问少数页面，且更新、删除、重新打开后结果仍然正确
+ */
+TEST(RecordManagerTest, ZoneMapTest) {
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(
+        BUFFER_POOL_SIZE, disk_manager.get());
+    auto rm_manager = std::make_unique<RmManager>(disk_manager.get(),
+                                                  buffer_pool_manager.get());
+
+    std::string filename = "zone_map.txt";
+    if (disk_manager->is_file(filename)) {
+        disk_manager->destroy_file(filename);
+    }
+    // 记录格式：int键(偏移0) + float值(偏移4) + 8字节填充
+    int record_size = 16;
+    std::vector<RmZoneCol> zone_cols = {{.type = TYPE_INT, .offset = 0},
+                                        {.type = TYPE_FLOAT, .offset = 4}};
+    rm_manager->create_file(filename, record_size);
+    auto file_handle = rm_manager->open_file(filename, zone_cols);
+    int per_page = file_handle->file_hdr_.num_records_per_page;
+
+    std::unordered_map<Rid, int, rid_hash_t, rid_equal_t> keys;
+    char buf[BUFFER_LENGTH] = {};
+    int num_records = per_page * 20;
+    for (int key = 0; key < num_records; key++) {
+        float value = key * 0.5f;
+        memcpy(buf, &key, sizeof(int));
+        memcpy(buf + sizeof(int), &value, sizeof(float));
+        keys[file_handle->insert_record(buf, nullptr)] = key;
+    }
+
+    // 用zone map扫描键在[lo, hi]内的记录，检查结果与全表过滤一致，并返回访问过的页面数
+    auto range_scan = [&](const RmFileHandle *fh, int lo, int hi) {
+        RmZoneMap *zone_map = fh->get_zone_map();
+        std::unordered_set<int> pages;
+        size_t num_found = 0;
+        for (RmScan scan(fh, [&](int page_no) { return zone_map->may_contain(page_no, 0, lo, hi); });
+             !scan.is_end(); scan.next()) {
+            pages.insert(scan.rid().page_no);
+            int key = keys.at(scan.rid());
+            num_found += key >= lo && key <= hi;
+        }
+        size_t expect = std::count_if(keys.begin(), keys.end(), [&](auto &entry) {
+            return entry.second >= lo && entry.second <= hi;
+        });
+        assert(num_found == expect);
+        return (int)pages.size();
+    };
+
+    assert(range_scan(file_handle.get(), per_page * 5, per_page * 5 + 10) == 1);
+    assert(range_scan(file_handle.get(), per_page * 3, per_page * 7 - 1) == 4);
+    assert(range_scan(file_handle.get(), -100, -1) == 0);
+    // float列同样维护了范围
+    assert(!file_handle->get_zone_map()->may_contain(RM_FIRST_RECORD_PAGE, 1, per_page, 1e9));
+
+    // 把第一页上的一条记录更新为很大的键，区间扩大后仍能找到它
+    Rid first = {.page_no = RM_FIRST_RECORD_PAGE, .slot_no = 0};
+    int big_key = num_records * 10;
+    memcpy(buf, &big_key, sizeof(int));
+    file_handle->update_record(first, buf, nullptr);
+    keys[first] = big_key;
+    assert(range_scan(file_handle.get(), big_key, big_key) == 1);
+
+    // 删除第二页上的所有记录，该页面不再被访问；第一页的区间因更新而扩大，仍会被访问
+    for (int slot_no = 0; slot_no < per_page; slot_no++) {
+        Rid rid = {.page_no = RM_FIRST_RECORD_PAGE + 1, .slot_no = slot_no};
+        file_handle->delete_record(rid, nullptr);
+        keys.erase(rid);
+    }
+    assert(range_scan(file_handle.get(), per_page, per_page * 2 - 1) == 1);
+
+    // 关闭后重新打开，zone map从文件加载
+    rm_manager->close_file(file_handle.get());
+    assert(disk_manager->is_file(RmZoneMap::get_zone_map_name(filename)));
+    file_handle = rm_manager->open_file(filename, zone_cols);
+    assert(!disk_manager->is_file(RmZoneMap::get_zone_map_name(filename)));
+    assert(range_scan(file_handle.get(), big_key, big_key) == 1);
+    assert(range_scan(file_handle.get(), per_page * 5, per_page * 5 + 10) == 2);
+
+    // zone map文件缺失(如异常退出)时从数据页重建
+    rm_manager->close_file(file_handle.get());
+    disk_manager->destroy_file(RmZoneMap::get_zone_map_name(filename));
+    file_handle = rm_manager->open_file(filename, zone_cols);
+    assert(range_scan(file_handle.get(), big_key, big_key) == 1);
+    assert(range_scan(file_handle.get(), per_page, per_page * 2 - 1) == 1);
+    assert(range_scan(file_handle.get(), per_page * 3, per_page * 7 - 1) == 5);
+
+    rm_manager->close_file(file_handle.get());
+    rm_manager->destroy_file(filename);
+    assert(!disk_manager->is_file(RmZoneMap::get_zone_map_name(filename)));
+}
@@ -0,0 +1,84 @@
+#include <random>
+
+#include "record/rm_lsm_table.h"
+#include "test/test_fixture.h"
+
+constexpr int RECORD_SIZE = RM_MAX_RECORD_SIZE;  // 记录较大，几千次写入就会写满内存表
+
+/** 对于每个测试点，先创建和进入目录RmLsmTableTest_db，然后在此目录下创建并打开一张LSM表 */
+class RmLsmTableTest : public StorageTest {
+   public:
+    std::unique_ptr<RmLsmTableHandle> th_;
+
+    RmLsmTableTest() : StorageTest("RmLsmTableTest_db", 256) {}
+
+    // This function is called before every test.
+    void SetUp() override {
+        StorageTest::SetUp();
+        RmLsmTableHandle::create(disk_manager_.get(), "lsm", RECORD_SIZE);
+        th_ = std::make_unique<RmLsmTableHandle>(disk_manager_.get(), buffer_pool_manager_.get(), "lsm");
+    }
+
+    // This function is called after every test.
+    void TearDown() override {
+        th_.reset();
+        StorageTest::TearDown();
+    }
+
+    void reopen(const std::string &name = "lsm") {
+        th_.reset();
+        th_ = std::make_unique<RmLsmTableHandle>(disk_manager_.get(), buffer_pool_manager_.get(), name);
+    }
+};
+
+/**
+ * @brief 随机插入、更新和删除，期间内存表多次写成段并在后台合并，结果与std::map一致
+ */
+TEST_F(RmLsmTableTest, RandomOperations) {
+    std::mt19937 rng(20231);
+    RecordMap mock;
+    std::vector<Rid> all_rids;
+    random_table_operations(th_.get(), rng, 40000, 6, &mock, &all_rids);
+    EXPECT_GT(th_->num_flushes(), 0);
+    check_table_equal(th_.get(), mock, all_rids);
+
+    // 重新打开后内容不变，新插入的行号不会与已有的行号重复
+    reopen();
+    check_table_equal(th_.get(), mock, all_rids);
+    std::string record = make_record(-1, 0, RECORD_SIZE);
+    Rid rid = th_->insert_record(&record[0], nullptr);
+    EXPECT_GT(rm_lsm_rid_to_row(rid), rm_lsm_rid_to_row(all_rids.back()));
+    mock[rid] = record;
+    all_rids.push_back(rid);
+
+    // 全量合并后只剩最下面一层，删除标记全部丢弃
+    th_->compact_all();
+    auto version = th_->current();
+    int64_t num_entries = 0;
+    int num_levels = 0;
+    for (auto &level : version->levels) {
+        for (auto &run : level) {
+            num_entries += run->num_entries();
+        }
+        num_levels += !level.empty();
+    }
+    EXPECT_EQ(num_levels, 1);
+    EXPECT_EQ(num_entries, static_cast<int64_t>(mock.size()));
+    check_table_equal(th_.get(), mock, all_rids);
+}
+
+/**
+ * @brief 没有正常关闭时，重新打开由预写日志恢复还在内存表中的修改
+ */
+TEST_F(RmLsmTableTest, WalReplay) {
+    RecordMap mock;
+    std::vector<Rid> all_rids;
+    wal_table_operations(th_.get(), 200, &mock, &all_rids);
+    // 修改都还在内存表中，没有后台写盘；此时把表的全部文件复制一份，相当于在这里崩溃
+    ASSERT_EQ(th_->num_flushes(), 0);
+    copy_files("lsm", "copy");
+    reopen("copy");
+    check_table_equal(th_.get(), mock, all_rids);
+    reopen("copy");
+    check_table_equal(th_.get(), mock, all_rids);
+}
@@ -0,0 +1,106 @@
+#include <random>
+
+#include "record/rm_mem_table.h"
+#include "test/test_fixture.h"
+
+constexpr int RECORD_SIZE = 40;
+
+/** 对于每个测试点，先创建和进入目录RmMemTableTest_db，然后在此目录下创建并打开一张durable的内存表 */
+class RmMemTableTest : public StorageTest {
+   public:
+    std::unique_ptr<RmMemTableHandle> th_;
+
+    RmMemTableTest() : StorageTest("RmMemTableTest_db", 16) {}
+
+    // This function is called before every test.
+    void SetUp() override {
+        StorageTest::SetUp();
+        RmMemTableHandle::create(disk_manager_.get(), "mem", RECORD_SIZE, true);
+        th_ = std::make_unique<RmMemTableHandle>(disk_manager_.get(), "mem");
+    }
+
+    // This function is called after every test.
+    void TearDown() override {
+        th_.reset();
+        StorageTest::TearDown();
+    }
+
+    void reopen(const std::string &name = "mem") {
+        th_.reset();
+        th_ = std::make_unique<RmMemTableHandle>(disk_manager_.get(), name);
+    }
+
+    /**
+     * @brief 点查找每个rid，再顺序扫描整张表，结果都应与mock一致，记录数也相同
+     */
+    void check_equal(const RecordMap &mock, const std::vector<Rid> &rids) {
+        check_table_equal(th_.get(), mock, rids);
+        EXPECT_EQ(th_->num_records(), static_cast<int>(mock.size()));
+    }
+};
+
+/**
+ * @brief 随机插入、更新和删除，删除留下的槽位被重用，结果与std::map一致；正常关闭后重新打开内容不变
+ */
+TEST_F(RmMemTableTest, RandomOperations) {
+    std::mt19937 rng(50);
+    RecordMap mock;
+    std::vector<Rid> rids;
+    random_table_operations(th_.get(), rng, 20000, 5, &mock, &rids);
+    // 槽位被重用，块数不超过记录数的峰值所需
+    EXPECT_LE(th_->num_pages() - RM_FIRST_RECORD_PAGE,
+              (20000 + RM_MEM_ROWS_PER_CHUNK - 1) / RM_MEM_ROWS_PER_CHUNK);
+    check_equal(mock, rids);
+    reopen();
+    check_equal(mock, rids);
+}
+
+/**
+ * @brief 没有正常关闭时，重新打开由快照和预写日志恢复全部修改
+ */
+TEST_F(RmMemTableTest, WalReplay) {
+    RecordMap mock;
+    std::vector<Rid> rids;
+    wal_table_operations(th_.get(), 1000, &mock, &rids);
+    // 此时把表的全部文件复制一份，相当于在这里崩溃
+    copy_files("mem", "copy");
+    reopen("copy");
+    check_equal(mock, rids);
+    reopen("copy");
+    check_equal(mock, rids);
+}
+
+/**
+ * @brief VACUUM把尾部块中的记录搬到前部的空槽位，on_move报告的新旧位置与搬迁后的内容一致
+ */
+TEST_F(RmMemTableTest, Vacuum) {
+    RecordMap mock;
+    std::vector<Rid> rids;
+    for (int i = 0; i < 10 * RM_MEM_ROWS_PER_CHUNK; i++) {
+        std::string record = make_record(i, 0, RECORD_SIZE);
+        rids.push_back(th_->insert_record(&record[0], nullptr));
+        mock[rids.back()] = record;
+    }
+    std::vector<Rid> deleted;
+    for (int i = 0; i < static_cast<int>(rids.size()); i++) {
+        if (i % 4 != 0) {
+            th_->delete_record(rids[i], nullptr);
+            mock.erase(rids[i]);
+            deleted.push_back(rids[i]);
+        }
+    }
+    int moved = 0;
+    int freed = th_->vacuum([&](const Rid &old_rid, const Rid &new_rid, const RmRecord &record) {
+        ASSERT_EQ(mock.count(new_rid), 0);
+        ASSERT_EQ(mock.at(old_rid), std::string(record.data, record.size));
+        mock[new_rid] = mock[old_rid];
+        mock.erase(old_rid);
+        moved++;
+    });
+    EXPECT_GT(moved, 0);
+    EXPECT_EQ(freed, 10 - (static_cast<int>(mock.size()) + RM_MEM_ROWS_PER_CHUNK - 1) / RM_MEM_ROWS_PER_CHUNK);
+    EXPECT_EQ(th_->num_pages() - RM_FIRST_RECORD_PAGE, 10 - freed);
+    check_equal(mock, {});
+    reopen();
+    check_equal(mock, {});
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstring>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "index/ix.h"
+#include "record/rm_table_handle.h"
+#include "storage/buffer_pool_manager.h"
+
+/**
+ * 存储层测试的公共夹具：对于每个测试点，先创建和进入目录db_name(已存在时先删除)，测试结束后回到上一级目录；
+ * 子类在构造时给出目录名和缓冲池大小，SetUp/TearDown中先后调用这里的版本
+ */
+class StorageTest : public ::testing::Test {
+   public:
+    std::unique_ptr<DiskManager> disk_manager_;
+    std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+    std::unique_ptr<IxManager> ix_manager_;
+
+    StorageTest(std::string db_name, size_t pool_size) : db_name_(std::move(db_name)), pool_size_(pool_size) {}
+
+    // This function is called before every test.
+    void SetUp() override {
+        ::testing::Test::SetUp();
+        disk_manager_ = std::make_unique<DiskManager>();
+        buffer_pool_manager_ = std::make_unique<BufferPoolManager>(pool_size_, disk_manager_.get());
+        ix_manager_ = std::make_unique<IxManager>(disk_manager_.get(), buffer_pool_manager_.get());
+
+        if (disk_manager_->is_dir(db_name_)) {
+            std::string cmd = "rm -rf " + db_name_;
+            if (system(cmd.c_str()) < 0) {
+                throw UnixError();
+            }
+        }
+        disk_manager_->create_dir(db_name_);
+        if (chdir(db_name_.c_str()) < 0) {
+            throw UnixError();
+        }
+    }
+
+    // This function is called after every test.
+    void TearDown() override {
+        if (chdir("..") < 0) {
+            throw UnixError();
+        }
+    }
+
+    // 由键生成互不相同的Rid，version区分同一个键的不同版本(0~7)
+    static Rid make_rid(int key, int version = 0) { return Rid{key / 100 + 1, (key % 100) * 8 + version}; }
+
+    // 长为size的记录，开头是key和version，其余字节由二者决定
+    static std::string make_record(int key, int version, int size) {
+        std::string record(size, static_cast<char>('a' + (key + version) % 26));
+        memcpy(&record[0], &key, sizeof(key));
+        memcpy(&record[sizeof(key)], &version, sizeof(version));
+        return record;
+    }
+
+    // 把名字以from开头的文件复制一份，开头换成to；在没有正常关闭时复制，相当于在这里崩溃
+    static void copy_files(const std::string &from, const std::string &to) {
+        std::string cmd = "for f in " + from + "*; do cp $f " + to + "${f#" + from + "}; done";
+        if (system(cmd.c_str()) != 0) {
+            throw UnixError();
+        }
+    }
+
+   private:
+    std::string db_name_;
+    size_t pool_size_;
+};
+
+// 按(page_no, slot_no)比较Rid，与表的扫描顺序一致
+struct RidLess {
+    bool operator()(const Rid &a, const Rid &b) const {
+        return a.page_no != b.page_no ? a.page_no < b.page_no : a.slot_no < b.slot_no;
+    }
+};
+
+// 表的预期内容：Rid -> 记录
+using RecordMap = std::map<Rid, std::string, RidLess>;
+
+/**
+ * @brief 点查找每个rid(不在mock中的应找不到)，再顺序扫描整张表，结果都应与mock一致
+ */
+inline void check_table_equal(RmTableHandle *th, const RecordMap &mock, const std::vector<Rid> &rids) {
+    for (auto &rid : rids) {
+        auto it = mock.find(rid);
+        if (it == mock.end()) {
+            EXPECT_THROW(th->get_record(rid, nullptr), RecordNotFoundError);
+        } else {
+            auto record = th->get_record(rid, nullptr);
+            ASSERT_EQ(std::string(record->data, record->size), it->second);
+        }
+    }
+    auto it = mock.begin();
+    for (auto scan = th->scan(); !scan->is_end(); scan->next()) {
+        ASSERT_NE(it, mock.end());
+        ASSERT_EQ(scan->rid(), it->first);
+        ASSERT_NE(scan->record(), nullptr);
+        ASSERT_EQ(std::string(scan->record(), th->record_size()), it->second);
+        ++it;
+    }
+    ASSERT_EQ(it, mock.end());
+}
+
+/**
+ * @brief 随机插入、更新和删除n次：rng() % 10小于insert_ops(或表为空)时插入，小于8时更新，否则删除；
+ * 修改同步到mock，插入得到的rid追加到rids
+ */
+inline void random_table_operations(RmTableHandle *th, std::mt19937 &rng, int n, int insert_ops, RecordMap *mock,
+                                    std::vector<Rid> *rids) {
+    for (int i = 0; i < n; i++) {
+        int op = rng() % 10;
+        if (op < insert_ops || mock->empty()) {
+            std::string record = StorageTest::make_record(i, 0, th->record_size());
+            Rid rid = th->insert_record(&record[0], nullptr);
+            ASSERT_EQ(mock->count(rid), 0);
+            (*mock)[rid] = record;
+            rids->push_back(rid);
+            continue;
+        }
+        auto it = std::next(mock->begin(), rng() % mock->size());
+        if (op < 8) {
+            std::string record = StorageTest::make_record(i, 1, th->record_size());
+            ASSERT_EQ(th->update_record(it->first, &record[0], nullptr), it->first);
+            it->second = record;
+        } else {
+            Rid rid = it->first;
+            th->delete_record(rid, nullptr);
+            mock->erase(it);
+            EXPECT_THROW(th->delete_record(rid, nullptr), RecordNotFoundError);
+        }
+    }
+}
+
+/**
+ * @brief 插入n条记录，再删除其中的第0, 3, 6...条、更新第1, 4, 7...条；用于测试崩溃后由预写日志恢复
+ */
+inline void wal_table_operations(RmTableHandle *th, int n, RecordMap *mock, std::vector<Rid> *rids) {
+    for (int i = 0; i < n; i++) {
+        std::string record = StorageTest::make_record(i, 0, th->record_size());
+        Rid rid = th->insert_record(&record[0], nullptr);
+        (*mock)[rid] = record;
+        rids->push_back(rid);
+    }
+    for (int i = 0; i < n; i += 3) {
+        th->delete_record((*rids)[i], nullptr);
+        mock->erase((*rids)[i]);
+    }
+    for (int i = 1; i < n; i += 3) {
+        std::string record = StorageTest::make_record(i, 1, th->record_size());
+        th->update_record((*rids)[i], &record[0], nullptr);
+        (*mock)[(*rids)[i]] = record;
+    }
+}